@@ -38,6 +38,7 @@ set(SOURCE_FILES
     version.sql
     size_utils.sql
     histogram.sql
+    hyperloglog.sql
     bgw_scheduler.sql
     metadata.sql
     uuidv7.sql
@@ -56,6 +56,17 @@ CREATE OR REPLACE FUNCTION _timescaledb_functions.create_chunk(
 RETURNS TABLE(chunk_id INTEGER, hypertable_id INTEGER, schema_name NAME, table_name NAME, relkind "char", slices JSONB, created BOOLEAN)
 AS '@MODULE_PATHNAME@', 'ts_chunk_create' LANGUAGE C VOLATILE;
 
+-- Pre-create the chunk covering the given time value, unless it
+-- already exists. Can be called from a scheduled job with a time value
+-- slightly in the future so that inserts crossing a chunk boundary
+-- never have to create the chunk themselves. Returns the covering
+-- chunk.
+CREATE OR REPLACE FUNCTION _timescaledb_functions.precreate_chunk(
+       hypertable REGCLASS,
+       at_time "any")
+RETURNS REGCLASS
+AS '@MODULE_PATHNAME@', 'ts_chunk_precreate' LANGUAGE C VOLATILE;
+
 CREATE OR REPLACE FUNCTION _timescaledb_functions.freeze_chunk(
    chunk REGCLASS)
 RETURNS BOOL AS '@MODULE_PATHNAME@', 'ts_chunk_freeze_chunk' LANGUAGE C VOLATILE;
@@ -0,0 +1,42 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.hyperloglog_sfunc (state INTERNAL, value ANYELEMENT)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_hyperloglog_sfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.hyperloglog_combinefunc(state1 INTERNAL, state2 INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_hyperloglog_combinefunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.hyperloglog_serializefunc(INTERNAL)
+RETURNS bytea
+AS '@MODULE_PATHNAME@', 'ts_hyperloglog_serializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.hyperloglog_deserializefunc(bytea, INTERNAL)
+RETURNS INTERNAL
+AS '@MODULE_PATHNAME@', 'ts_hyperloglog_deserializefunc'
+LANGUAGE C IMMUTABLE STRICT PARALLEL SAFE;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.hyperloglog_finalfunc(state INTERNAL)
+RETURNS BIGINT
+AS '@MODULE_PATHNAME@', 'ts_hyperloglog_finalfunc'
+LANGUAGE C IMMUTABLE PARALLEL SAFE;
+
+-- This aggregate computes the approximate number of distinct non-null values
+-- with a HyperLogLog sketch. Unlike count(DISTINCT ...), its state is small
+-- and mergeable, so it is parallelizable and doesn't have to sort the input.
+-- The distinctness is that of the binary representation of the values.
+CREATE OR REPLACE AGGREGATE @extschema@.approximate_count_distinct (ANYELEMENT) (
+    SFUNC = _timescaledb_functions.hyperloglog_sfunc,
+    STYPE = INTERNAL,
+    COMBINEFUNC = _timescaledb_functions.hyperloglog_combinefunc,
+    SERIALFUNC = _timescaledb_functions.hyperloglog_serializefunc,
+    DESERIALFUNC = _timescaledb_functions.hyperloglog_deserializefunc,
+    PARALLEL = SAFE,
+    FINALFUNC = _timescaledb_functions.hyperloglog_finalfunc
+);
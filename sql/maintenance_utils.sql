@@ -32,6 +32,16 @@ CREATE OR REPLACE FUNCTION _timescaledb_functions.create_compressed_chunk(
     numrows_post_compression BIGINT
 ) RETURNS REGCLASS AS '@MODULE_PATHNAME@', 'ts_create_compressed_chunk' LANGUAGE C STRICT VOLATILE;
 
+-- Compress rows from a staging relation directly into an existing columnstore
+-- chunk, bypassing the uncompressed chunk heap. The source relation must have
+-- the same column layout as the chunk. With sorted = true the input is assumed
+-- to already be ordered by the compression (segmentby, orderby) keys.
+CREATE OR REPLACE FUNCTION _timescaledb_functions.backfill_compressed_chunk(
+    chunk REGCLASS,
+    source REGCLASS,
+    sorted BOOLEAN = true
+) RETURNS BIGINT AS '@MODULE_PATHNAME@', 'ts_backfill_compressed_chunk' LANGUAGE C VOLATILE;
+
 CREATE OR REPLACE FUNCTION @extschema@.compress_chunk(
     uncompressed_chunk REGCLASS,
     if_not_compressed BOOLEAN = true,
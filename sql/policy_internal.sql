@@ -58,6 +58,7 @@ DECLARE
   htoid       REGCLASS;
   chunk_rec   RECORD;
   idx_rec     RECORD;
+  chunk_status INTEGER;
   numchunks_compressed   INTEGER := 0;
   _message     text;
   _detail      text;
@@ -101,7 +102,7 @@ BEGIN
 
   FOR chunk_rec IN
     SELECT
-      show.oid, ch.schema_name, ch.table_name, ch.status
+      show.oid, ch.id, ch.schema_name, ch.table_name, ch.status
     FROM
       @extschema@.show_chunks(htoid, older_than => lag, created_before => creation_lag) AS show(oid)
       INNER JOIN pg_class pgc ON pgc.oid = show.oid
@@ -113,7 +114,22 @@ BEGIN
     AND ch.status & bit_frozen = 0
   LOOP
     BEGIN
-      IF chunk_rec.status = bit_compressed OR recompress_enabled IS TRUE THEN
+      -- Claim the chunk by locking its catalog row for the duration of
+      -- this transaction. A chunk whose row is already locked is being
+      -- processed by a concurrent job (another columnstore policy on the
+      -- same hypertable, or a manual conversion), so skip it instead of
+      -- blocking behind it. This lets several scheduled jobs divide the
+      -- chunk backlog between them. The status is re-read under the lock
+      -- since the snapshot taken by the surrounding loop can be stale
+      -- after the per-chunk commits.
+      SELECT ch.status INTO chunk_status
+      FROM _timescaledb_catalog.chunk ch
+      WHERE ch.id = chunk_rec.id
+      FOR NO KEY UPDATE SKIP LOCKED;
+
+      IF chunk_status IS NULL OR chunk_status = status_fully_compressed OR chunk_status & bit_frozen != 0 THEN
+        chunk_status := NULL;
+      ELSIF chunk_status = bit_compressed OR recompress_enabled IS TRUE THEN
         PERFORM @extschema@.compress_chunk(chunk_rec.oid);
         numchunks_compressed := numchunks_compressed + 1;
       END IF;
@@ -130,7 +146,7 @@ BEGIN
     COMMIT;
 
     -- went through recompression successfully now reindex indexes
-    IF (chunk_rec.status & bit_compressed_partial = bit_compressed_partial) AND (reindex_enabled IS TRUE) THEN
+    IF chunk_status IS NOT NULL AND (chunk_status & bit_compressed_partial = bit_compressed_partial) AND (reindex_enabled IS TRUE) THEN
       FOR idx_rec IN
         SELECT idx.schemaname, idx.indexname
         FROM pg_indexes idx
@@ -251,3 +267,79 @@ BEGIN
   COMMIT;
 END;
 $$ LANGUAGE PLPGSQL;
+
+-- Read the hot end of a table or index into the shared buffer cache.
+-- Reads at most max_blocks blocks: the tail of a table, or the head of
+-- an index. Returns the number of blocks read.
+CREATE OR REPLACE FUNCTION _timescaledb_functions.relation_prewarm(relation REGCLASS, max_blocks INTEGER)
+RETURNS BIGINT AS '@MODULE_PATHNAME@', 'ts_relation_prewarm'
+LANGUAGE C VOLATILE;
+
+-- Prewarm job: load the hot end of the most recent chunks of the
+-- configured hypertables, and of their indexes, into the shared buffer
+-- cache. Intended to be registered with add_job() and run shortly after
+-- a restart or failover, before queries hit cold storage.
+--
+-- config:
+--   hypertables             array of hypertable names to prewarm (required)
+--   recent_chunks           number of most recent chunks per hypertable (default 3)
+--   max_blocks_per_relation blocks read per chunk or index (default 1024)
+CREATE OR REPLACE FUNCTION _timescaledb_functions.policy_prewarm(job_id INTEGER, config JSONB)
+RETURNS VOID AS
+$BODY$
+DECLARE
+  ht_name        TEXT;
+  ht_id          INTEGER;
+  chunk_rel      REGCLASS;
+  index_rel      REGCLASS;
+  recent_chunks  INTEGER := coalesce((config->>'recent_chunks')::integer, 3);
+  max_blocks     INTEGER := coalesce((config->>'max_blocks_per_relation')::integer, 1024);
+  blocks_read    BIGINT := 0;
+BEGIN
+  PERFORM _timescaledb_functions.policy_prewarm_check(config);
+
+  FOR ht_name IN SELECT jsonb_array_elements_text(config->'hypertables')
+  LOOP
+    SELECT h.id INTO ht_id
+    FROM _timescaledb_catalog.hypertable h
+    WHERE format('%I.%I', h.schema_name, h.table_name)::regclass = ht_name::regclass;
+
+    IF ht_id IS NULL THEN
+      RAISE WARNING 'prewarm job % skipping "%": not a hypertable', job_id, ht_name;
+      CONTINUE;
+    END IF;
+
+    FOR chunk_rel IN
+      SELECT format('%I.%I', ch.schema_name, ch.table_name)::regclass
+      FROM _timescaledb_catalog.chunk ch
+      WHERE ch.hypertable_id = ht_id AND NOT ch.osm_chunk
+      ORDER BY ch.creation_time DESC
+      LIMIT recent_chunks
+    LOOP
+      blocks_read := blocks_read + _timescaledb_functions.relation_prewarm(chunk_rel, max_blocks);
+
+      FOR index_rel IN
+        SELECT i.indexrelid::regclass FROM pg_catalog.pg_index i WHERE i.indrelid = chunk_rel
+      LOOP
+        blocks_read := blocks_read + _timescaledb_functions.relation_prewarm(index_rel, max_blocks);
+      END LOOP;
+    END LOOP;
+  END LOOP;
+
+  RAISE DEBUG 'prewarm job % read % blocks', job_id, blocks_read;
+END
+$BODY$ LANGUAGE PLPGSQL SET search_path TO pg_catalog, pg_temp;
+
+CREATE OR REPLACE FUNCTION _timescaledb_functions.policy_prewarm_check(config JSONB)
+RETURNS VOID AS
+$BODY$
+BEGIN
+  IF config IS NULL THEN
+    RAISE EXCEPTION 'config must not be NULL';
+  END IF;
+
+  IF NOT (config ? 'hypertables') OR jsonb_typeof(config->'hypertables') <> 'array' THEN
+    RAISE EXCEPTION 'config must contain an array of hypertables to prewarm';
+  END IF;
+END
+$BODY$ LANGUAGE PLPGSQL SET search_path TO pg_catalog, pg_temp;
@@ -7,6 +7,11 @@
 -- description of how this works.
 CREATE TABLE _timescaledb_cache.cache_inval_hypertable();
 
+-- For changes to the chunk table that do not affect cached hypertable
+-- metadata, e.g., chunk creation. Invalidates chunk exclusion and planner
+-- caches without forcing backends to rebuild their hypertable caches.
+CREATE TABLE _timescaledb_cache.cache_inval_chunk();
+
 -- For notifying the scheduler of changes to the bgw_job table.
 CREATE TABLE _timescaledb_cache.cache_inval_bgw_job();
 
@@ -80,3 +80,17 @@ GRANT SELECT ON _timescaledb_catalog.chunk_id_seq TO PUBLIC;
 GRANT SELECT ON _timescaledb_catalog.chunk TO PUBLIC;
 -- end rebuild _timescaledb_catalog.chunk table --
 
+
+-- add a cache invalidation proxy table for chunk-level changes so that chunk
+-- creation does not force a rebuild of the hypertable caches
+CREATE TABLE _timescaledb_cache.cache_inval_chunk();
+GRANT SELECT ON _timescaledb_cache.cache_inval_chunk TO PUBLIC;
+
+INSERT INTO _timescaledb_catalog.compression_algorithm( id, version, name, description) values
+( 8, 1, 'COMPRESSION_ALGORITHM_ALP', 'alp');
+
+INSERT INTO _timescaledb_catalog.compression_algorithm( id, version, name, description) values
+( 9, 1, 'COMPRESSION_ALGORITHM_ARRAY_ZSTD', 'array zstd');
+
+INSERT INTO _timescaledb_catalog.compression_algorithm( id, version, name, description) values
+( 10, 1, 'COMPRESSION_ALGORITHM_RLE', 'rle');
@@ -1,3 +1,5 @@
+DROP FUNCTION IF EXISTS _timescaledb_functions.precreate_chunk(REGCLASS, "any");
+
 --
 -- Rebuild the catalog table `_timescaledb_catalog.chunk` to add column `dropped`
 --
@@ -79,3 +81,33 @@ DROP TABLE _timescaledb_internal.tmp_chunk_seq_value;
 GRANT SELECT ON _timescaledb_catalog.chunk_id_seq TO PUBLIC;
 GRANT SELECT ON _timescaledb_catalog.chunk TO PUBLIC;
 -- end recreate _timescaledb_catalog.chunk table --
+
+-- remove the approximate_count_distinct() aggregate
+DROP AGGREGATE IF EXISTS @extschema@.approximate_count_distinct(ANYELEMENT);
+DROP FUNCTION IF EXISTS _timescaledb_functions.hyperloglog_sfunc(INTERNAL, ANYELEMENT);
+DROP FUNCTION IF EXISTS _timescaledb_functions.hyperloglog_combinefunc(INTERNAL, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.hyperloglog_serializefunc(INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.hyperloglog_deserializefunc(bytea, INTERNAL);
+DROP FUNCTION IF EXISTS _timescaledb_functions.hyperloglog_finalfunc(INTERNAL);
+
+-- remove the prewarm job functions
+DROP FUNCTION IF EXISTS _timescaledb_functions.policy_prewarm_check(JSONB);
+DROP FUNCTION IF EXISTS _timescaledb_functions.policy_prewarm(INTEGER, JSONB);
+DROP FUNCTION IF EXISTS _timescaledb_functions.relation_prewarm(REGCLASS, INTEGER);
+
+-- remove the chunk cache invalidation proxy table
+DROP TABLE IF EXISTS _timescaledb_cache.cache_inval_chunk;
+
+DROP FUNCTION IF EXISTS _timescaledb_functions.backfill_compressed_chunk(REGCLASS, REGCLASS, BOOLEAN);
+
+-- remove the cache statistics view
+DROP VIEW IF EXISTS timescaledb_information.cache_stats;
+DROP FUNCTION IF EXISTS _timescaledb_functions.cache_stats();
+
+DROP VIEW IF EXISTS timescaledb_information.job_latency_stats;
+
+DELETE FROM _timescaledb_catalog.compression_algorithm WHERE id = 8 AND version = 1 AND name = 'COMPRESSION_ALGORITHM_ALP';
+
+DELETE FROM _timescaledb_catalog.compression_algorithm WHERE id = 9 AND version = 1 AND name = 'COMPRESSION_ALGORITHM_ARRAY_ZSTD';
+
+DELETE FROM _timescaledb_catalog.compression_algorithm WHERE id = 10 AND version = 1 AND name = 'COMPRESSION_ALGORITHM_RLE';
@@ -370,6 +370,45 @@ WHERE (pg_catalog.pg_has_role(current_user,
 			   'MEMBER') IS TRUE
     OR pg_catalog.pg_has_role(current_user, owner, 'MEMBER') IS TRUE);
 
+-- Per-job latency statistics derived from the job execution history.
+-- The scheduling delay (time from the planned start to the actual
+-- start of a run) is recorded by the scheduler in the history data, so
+-- runs that start late because the scheduler is backed up show up here
+-- even when the runs themselves succeed. Follows the same ownership
+-- rules as the job_history view above.
+CREATE OR REPLACE VIEW timescaledb_information.job_latency_stats
+WITH (security_barrier = true) AS
+SELECT
+    h.job_id,
+    j.proc_schema,
+    j.proc_name,
+    count(*) AS total_runs,
+    count(*) FILTER (WHERE h.succeeded) AS total_successes,
+    count(*) FILTER (WHERE h.succeeded IS FALSE) AS total_failures,
+    js.consecutive_failures,
+    avg((h.data->>'scheduling_delay')::interval) AS avg_scheduling_delay,
+    max((h.data->>'scheduling_delay')::interval) AS max_scheduling_delay,
+    percentile_cont(0.5) WITHIN GROUP (ORDER BY h.execution_finish - h.execution_start) AS median_run_duration,
+    percentile_cont(0.95) WITHIN GROUP (ORDER BY h.execution_finish - h.execution_start) AS p95_run_duration,
+    max(h.execution_finish - h.execution_start) AS max_run_duration
+FROM
+    _timescaledb_internal.bgw_job_stat_history h
+LEFT JOIN
+    _timescaledb_catalog.bgw_job j ON (j.id = h.job_id)
+LEFT JOIN
+    _timescaledb_internal.bgw_job_stat js ON (js.job_id = h.job_id)
+WHERE (pg_catalog.pg_has_role(current_user,
+			   (SELECT pg_catalog.pg_get_userbyid(datdba)
+			      FROM pg_catalog.pg_database
+			     WHERE datname = current_database()),
+			   'MEMBER') IS TRUE
+    OR pg_catalog.pg_has_role(current_user, owner, 'MEMBER') IS TRUE)
+GROUP BY
+    h.job_id,
+    j.proc_schema,
+    j.proc_name,
+    js.consecutive_failures;
+
 CREATE OR REPLACE VIEW timescaledb_information.hypertable_compression_settings AS
 	SELECT
 		format('%I.%I',ht.schema_name,ht.table_name)::regclass AS hypertable,
@@ -427,6 +466,24 @@ AS SELECT * FROM timescaledb_information.hypertable_compression_settings;
 CREATE OR REPLACE VIEW timescaledb_information.chunk_columnstore_settings AS
 SELECT * FROM timescaledb_information.chunk_compression_settings;
 
+-- Metadata cache statistics of the current backend, see src/cache.c. The
+-- counters accumulate over the backend's lifetime and survive cache rebuilds,
+-- so the frequency and cost of cache invalidations can be quantified.
+CREATE OR REPLACE FUNCTION _timescaledb_functions.cache_stats()
+RETURNS TABLE (
+  cache_name TEXT,
+  hits BIGINT,
+  misses BIGINT,
+  invalidations BIGINT,
+  rebuilds BIGINT,
+  entry_build_time_ms DOUBLE PRECISION,
+  num_entries BIGINT,
+  bytes BIGINT
+) AS '@MODULE_PATHNAME@', 'ts_cache_stats' LANGUAGE C STRICT VOLATILE;
+
+CREATE OR REPLACE VIEW timescaledb_information.cache_stats AS
+SELECT * FROM _timescaledb_functions.cache_stats();
+
 --temporary alias for bgw_job
 CREATE OR REPLACE VIEW _timescaledb_config.bgw_job AS
 SELECT * from _timescaledb_catalog.bgw_job;
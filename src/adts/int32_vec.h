@@ -0,0 +1,13 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#define VEC_PREFIX int32
+#define VEC_ELEMENT_TYPE int32
+#define VEC_DECLARE 1
+#define VEC_DEFINE 1
+#define VEC_SCOPE static inline
+#include <adts/vec.h>
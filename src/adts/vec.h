@@ -49,6 +49,10 @@
 #define VEC_DELETE_RANGE VEC_MAKE_NAME(vec_delete_range)
 #define VEC_RESERVE VEC_MAKE_NAME(vec_reserve)
 #define VEC_FREE VEC_MAKE_NAME(vec_free)
+#define VEC_CONTAINS VEC_MAKE_NAME(vec_contains)
+#define VEC_SORT_UNIQUE VEC_MAKE_NAME(vec_sort_unique)
+#define VEC_INTERSECT VEC_MAKE_NAME(vec_intersect)
+#define VEC_SORT_CMP VEC_MAKE_NAME(vec_sort_cmp)
 
 /* generate forward declarations necessary to use the vector */
 #ifdef VEC_DECLARE
@@ -84,6 +88,9 @@ VEC_SCOPE void VEC_DELETE(VEC_TYPE *vec, uint32 index);
 VEC_SCOPE void VEC_DELETE_RANGE(VEC_TYPE *vec, uint32 start, uint32 len);
 VEC_SCOPE void VEC_RESERVE(VEC_TYPE *vec, uint32 additional);
 VEC_SCOPE void VEC_FREE(VEC_TYPE *vec);
+VEC_SCOPE bool VEC_CONTAINS(const VEC_TYPE *vec, VEC_ELEMENT_TYPE element);
+VEC_SCOPE void VEC_SORT_UNIQUE(VEC_TYPE *vec);
+VEC_SCOPE void VEC_INTERSECT(VEC_TYPE *result, const VEC_TYPE *left, const VEC_TYPE *right);
 
 #endif /* VEC_DECLARE */
 
@@ -118,6 +125,15 @@ VEC_RESERVE(VEC_TYPE *vec, uint32 additional)
 		num_elements = vec->num_elements * 2;
 	}
 
+	/*
+	 * Growing from a tiny size reallocates on almost every append, so start
+	 * with a capacity that fills at least a cache line. Most vectors grow
+	 * past that anyway, and for those that don't, the allocator rounds tiny
+	 * requests up to a similar size in any case.
+	 */
+	if (num_elements < 64 / sizeof(VEC_ELEMENT_TYPE))
+		num_elements = 64 / sizeof(VEC_ELEMENT_TYPE);
+
 	if (num_elements >= max_element_limit)
 	{
 		if (vec->num_elements + num_new_elements >= max_element_limit)
@@ -272,6 +288,83 @@ VEC_DELETE(VEC_TYPE *vec, uint32 index)
 	VEC_DELETE_RANGE(vec, index, 1);
 }
 
+/*
+ * Test whether the vector contains the given element. The loop is written as
+ * a reduction without an early exit so that the compiler can auto-vectorize
+ * the comparisons; for the short arrays this ADT is typically used for,
+ * scanning the tail is cheaper than taking a branch per element.
+ */
+VEC_SCOPE bool
+VEC_CONTAINS(const VEC_TYPE *vec, VEC_ELEMENT_TYPE element)
+{
+	uint32 matches = 0;
+
+	for (uint32 i = 0; i < vec->num_elements; i++)
+		matches += (vec->data[i] == element);
+
+	return matches > 0;
+}
+
+VEC_SCOPE int
+VEC_SORT_CMP(const void *left, const void *right)
+{
+	VEC_ELEMENT_TYPE lhs = *(const VEC_ELEMENT_TYPE *) left;
+	VEC_ELEMENT_TYPE rhs = *(const VEC_ELEMENT_TYPE *) right;
+
+	if (lhs < rhs)
+		return -1;
+	if (lhs > rhs)
+		return 1;
+	return 0;
+}
+
+/* Sort the elements ascending and remove duplicates in place. */
+VEC_SCOPE void
+VEC_SORT_UNIQUE(VEC_TYPE *vec)
+{
+	uint32 num_distinct = 0;
+
+	if (vec->num_elements < 2)
+		return;
+
+	qsort(vec->data, vec->num_elements, sizeof(VEC_ELEMENT_TYPE), VEC_SORT_CMP);
+
+	for (uint32 i = 0; i < vec->num_elements; i++)
+	{
+		if (num_distinct == 0 || vec->data[num_distinct - 1] != vec->data[i])
+			vec->data[num_distinct++] = vec->data[i];
+	}
+	vec->num_elements = num_distinct;
+}
+
+/*
+ * Append the intersection of `left` and `right` to `result`, which must be a
+ * different vector. Both inputs have to be sorted ascending and free of
+ * duplicates, e.g. by VEC_SORT_UNIQUE, so a single merge pass suffices.
+ */
+VEC_SCOPE void
+VEC_INTERSECT(VEC_TYPE *result, const VEC_TYPE *left, const VEC_TYPE *right)
+{
+	uint32 li = 0;
+	uint32 ri = 0;
+
+	Assert(result != left && result != right);
+
+	while (li < left->num_elements && ri < right->num_elements)
+	{
+		if (left->data[li] < right->data[ri])
+			li++;
+		else if (right->data[ri] < left->data[li])
+			ri++;
+		else
+		{
+			VEC_APPEND(result, left->data[li]);
+			li++;
+			ri++;
+		}
+	}
+}
+
 #endif
 
 /* undefine external parameters, so next vector can be defined */
@@ -304,3 +397,7 @@ VEC_DELETE(VEC_TYPE *vec, uint32 index)
 #undef VEC_DELETE_RANGE
 #undef VEC_RESERVE
 #undef VEC_FREE
+#undef VEC_CONTAINS
+#undef VEC_SORT_UNIQUE
+#undef VEC_INTERSECT
+#undef VEC_SORT_CMP
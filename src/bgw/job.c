@@ -89,6 +89,7 @@ ts_bgw_job_start(BgwJob *job, Oid user_oid)
 		.job_id = Int32GetDatum(job->fd.id),
 		.job_history_id = job->job_history.id,
 		.job_history_execution_start = job->job_history.execution_start,
+		.job_history_scheduled_start = job->job_history.scheduled_start,
 		.user_oid = user_oid,
 	};
 
@@ -1220,6 +1221,7 @@ ts_bgw_job_entrypoint(PG_FUNCTION_ARGS)
 	/* get parameters from bgworker */
 	job->job_history.id = params.job_history_id;
 	job->job_history.execution_start = params.job_history_execution_start;
+	job->job_history.scheduled_start = params.job_history_scheduled_start;
 	ts_bgw_job_stat_history_update(JOB_STAT_HISTORY_UPDATE_PID, job, JOB_SUCCESS, NULL);
 
 	PopActiveSnapshot();
@@ -1298,6 +1300,7 @@ ts_bgw_job_entrypoint(PG_FUNCTION_ARGS)
 
 			job->job_history.id = params.job_history_id;
 			job->job_history.execution_start = params.job_history_execution_start;
+			job->job_history.scheduled_start = params.job_history_scheduled_start;
 
 			ts_bgw_job_stat_mark_end(job,
 									 JOB_FAILURE_IN_EXECUTION,
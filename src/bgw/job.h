@@ -44,6 +44,11 @@ typedef struct BgwJobHistory
 {
 	int64 id;
 	TimestampTz execution_start;
+	/* The next_start the scheduler had planned for this run, captured before
+	 * it is cleared in the job stats row. Used to compute the scheduling
+	 * delay (time from scheduled to started) in the history data. DT_NOBEGIN
+	 * when unknown, e.g. for the first run of a job. */
+	TimestampTz scheduled_start;
 } BgwJobHistory;
 
 typedef struct BgwJob
@@ -132,10 +132,16 @@ bgw_job_stat_tuple_mark_start(TupleInfo *ti, void *const data)
 	HeapTuple tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
 	HeapTuple new_tuple = heap_copytuple(tuple);
 	FormData_bgw_job_stat *fd = (FormData_bgw_job_stat *) GETSTRUCT(new_tuple);
+	TimestampTz *scheduled_start = (TimestampTz *) data;
 
 	if (should_free)
 		heap_freetuple(tuple);
 
+	/* Hand the planned start time back to the caller before it is cleared
+	 * below, so the history can record the scheduling delay of this run */
+	if (scheduled_start != NULL)
+		*scheduled_start = fd->next_start;
+
 	fd->last_start = ts_timer_get_current_timestamp();
 	fd->last_finish = DT_NOBEGIN;
 	fd->next_start = DT_NOBEGIN;
@@ -637,18 +643,20 @@ ts_bgw_job_stat_mark_start(BgwJob *job)
 	 * can trigger a failure when inserting a row for the job. We use the
 	 * RowExclusiveLock in the scan since we cannot use NoLock (relation_open
 	 * requires a lock that it not NoLock). */
+	TimestampTz scheduled_start = DT_NOBEGIN;
 	Relation rel =
 		table_open(catalog_get_table_id(ts_catalog_get(), BGW_JOB_STAT), ShareRowExclusiveLock);
 	if (!bgw_job_stat_scan_job_id(job->fd.id,
 								  bgw_job_stat_tuple_mark_start,
 								  NULL,
-								  NULL,
+								  &scheduled_start,
 								  RowExclusiveLock))
 		bgw_job_stat_insert_relation(rel, job->fd.id, true, DT_NOBEGIN);
 	table_close(rel, NoLock);
 
 	/* We need to capture the execution start because failures are always logged */
 	job->job_history.execution_start = ts_timer_get_current_timestamp();
+	job->job_history.scheduled_start = scheduled_start;
 	job->job_history.id = INVALID_BGW_JOB_STAT_HISTORY_ID;
 
 	ts_bgw_job_stat_history_update(JOB_STAT_HISTORY_UPDATE_START, job, JOB_SUCCESS, NULL);
@@ -664,11 +672,17 @@ ts_bgw_job_stat_mark_end(BgwJob *job, JobResult result, Jsonb *edata)
 		.result = result,
 	};
 
+	/* This only updates the job's existing row, so the regular writer lock is
+	 * enough; each job has its own row and the insert-if-absent paths
+	 * (ts_bgw_job_stat_mark_start and ts_bgw_job_stat_upsert_next_start) are
+	 * the only ones that need to lock out concurrent inserters. Jobs finish
+	 * their runs concurrently, so a self-conflicting lock here would make the
+	 * end-of-run writes contend with each other and with the scheduler. */
 	if (!bgw_job_stat_scan_job_id(job->fd.id,
 								  bgw_job_stat_tuple_mark_end,
 								  NULL,
 								  &res,
-								  ShareRowExclusiveLock))
+								  RowExclusiveLock))
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -716,11 +730,13 @@ ts_bgw_job_stat_set_next_start(int32 job_id, TimestampTz next_start)
 				 errmsg("cannot set next start to -infinity")));
 	}
 
+	/* Updates the job's existing row only; see ts_bgw_job_stat_mark_end for
+	 * why the regular writer lock is enough. */
 	if (!bgw_job_stat_scan_job_id(job_id,
 								  bgw_job_stat_tuple_set_next_start,
 								  NULL,
 								  &next_start,
-								  ShareRowExclusiveLock))
+								  RowExclusiveLock))
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -741,11 +757,13 @@ ts_bgw_job_stat_update_next_start(int32 job_id, TimestampTz next_start, bool all
 				 errmsg("cannot set next start to -infinity")));
 	}
 
+	/* Updates the job's existing row only; see ts_bgw_job_stat_mark_end for
+	 * why the regular writer lock is enough. */
 	found = bgw_job_stat_scan_job_id(job_id,
 									 bgw_job_stat_tuple_set_next_start,
 									 NULL,
 									 &next_start,
-									 ShareRowExclusiveLock);
+									 RowExclusiveLock);
 	return found;
 }
 
@@ -7,6 +7,7 @@
 
 #include <access/xact.h>
 #include <utils/jsonb.h>
+#include <utils/timestamp.h>
 
 #include "compat/compat.h"
 #include "guc.h"
@@ -80,6 +81,20 @@ ts_bgw_job_stat_history_build_data_info(BgwJobStatHistoryContext *context)
 	JsonbToJsonbValue(build_job_info(context->job), &value);
 	ts_jsonb_add_value(parse_state, "job", &value);
 
+	/* Scheduling delay: how long the run waited beyond its planned start.
+	 * The planned start is unknown for the first run of a job (DT_NOBEGIN),
+	 * and a run that started early (e.g. run_job) has no delay worth
+	 * recording. */
+	if (!TIMESTAMP_NOT_FINITE(context->job->job_history.scheduled_start) &&
+		context->job->job_history.scheduled_start <= context->job->job_history.execution_start)
+	{
+		Interval *delay = DatumGetIntervalP(
+			DirectFunctionCall2(timestamp_mi,
+								TimestampTzGetDatum(context->job->job_history.execution_start),
+								TimestampTzGetDatum(context->job->job_history.scheduled_start)));
+		ts_jsonb_add_interval(parse_state, "scheduling_delay", delay);
+	}
+
 	if (context->edata != NULL)
 	{
 		/* error information jsonb */
@@ -95,8 +110,12 @@ bgw_job_stat_history_insert(BgwJobStatHistoryContext *context, bool track_only_e
 {
 	Assert(context != NULL);
 
+	/* A plain insert with a sequence-generated id, so the regular writer lock
+	 * is enough. A self-conflicting lock here would serialize all job workers
+	 * finishing at the same time against each other and against the
+	 * scheduler. */
 	Relation rel = table_open(catalog_get_table_id(ts_catalog_get(), BGW_JOB_STAT_HISTORY),
-							  ShareRowExclusiveLock);
+							  RowExclusiveLock);
 	TupleDesc desc = RelationGetDescr(rel);
 	NullableDatum values[Natts_bgw_job_stat_history] = { { 0 } };
 	CatalogSecurityContext sec_ctx;
@@ -24,6 +24,7 @@
 #include <storage/shmem.h>
 #include <tcop/tcopprot.h>
 #include <utils/acl.h>
+#include <utils/builtins.h>
 #include <utils/inval.h>
 #include <utils/jsonb.h>
 #include <utils/memutils.h>
@@ -36,6 +37,7 @@
 #include "job.h"
 #include "job_stat.h"
 #include "launcher_interface.h"
+#include "probes.h"
 #include "scheduler.h"
 #include "timer.h"
 #include "version.h"
@@ -43,6 +45,7 @@
 
 #define START_RETRY_MS (1 * INT64CONST(1000)) /* 1 seconds */
 #define ONE_SECOND_IN_MICROSECONDS 1000000
+#define ONE_MILLISECOND_IN_MICROSECONDS 1000
 
 static TimestampTz
 least_timestamp(TimestampTz left, TimestampTz right)
@@ -355,6 +358,8 @@ scheduled_bgw_job_transition_state_to(ScheduledBgwJob *sjob, JobState new_state)
 				 sjob->job.fd.id,
 				 NameStr(sjob->job.fd.application_name));
 
+			TS_PROBE2(job_dispatch, sjob->job.fd.id, sjob->consecutive_failed_launches);
+
 			sjob->handle = ts_bgw_job_start(&sjob->job, sjob->job.fd.owner);
 			if (sjob->handle == NULL)
 			{
@@ -423,18 +428,19 @@ bgw_scheduler_on_postmaster_death(void)
 }
 
 /*
- * This function starts a job.
+ * This function launches a job by registering its background worker.
  * To correctly count crashes we need to mark the start of a job in a separate
  * txn before we kick off the actual job. Thus this function cannot be run
  * from within a transaction.
+ *
+ * The launch does not wait for the worker to actually start; that is done in
+ * scheduled_ts_bgw_job_confirm_start() so that all due jobs can be handed to
+ * the postmaster before waiting on any of them.
  */
 static void
-scheduled_ts_bgw_job_start(ScheduledBgwJob *sjob,
-						   register_background_worker_callback_type bgw_register)
+scheduled_ts_bgw_job_launch(ScheduledBgwJob *sjob,
+							register_background_worker_callback_type bgw_register)
 {
-	pid_t pid;
-	BgwHandleStatus status;
-
 	scheduled_bgw_job_transition_state_to(sjob, JOB_STATE_STARTED);
 
 	if (sjob->state != JOB_STATE_STARTED)
@@ -443,6 +449,21 @@ scheduled_ts_bgw_job_start(ScheduledBgwJob *sjob,
 	Assert(sjob->handle != NULL);
 	if (bgw_register != NULL)
 		bgw_register(sjob->handle, scheduler_mctx);
+}
+
+/*
+ * Wait for the startup of a worker previously registered by
+ * scheduled_ts_bgw_job_launch() and reschedule the job if the worker could
+ * not be started.
+ */
+static void
+scheduled_ts_bgw_job_confirm_start(ScheduledBgwJob *sjob)
+{
+	pid_t pid;
+	BgwHandleStatus status;
+
+	Assert(sjob->state == JOB_STATE_STARTED);
+	Assert(sjob->handle != NULL);
 
 	status = WaitForBackgroundWorkerStartup(sjob->handle, &pid);
 	switch (status)
@@ -583,11 +604,60 @@ ts_populate_scheduled_job_tuple(ScheduledBgwJob *sjob, Datum *values)
 }
 #endif
 
+/*
+ * Dispatch priority classes for due jobs.
+ *
+ * The launch order only matters when the due jobs compete for the last free
+ * background workers, but in that situation they are not equally urgent: a
+ * retention run that cannot get a worker lets disk usage grow until it gets
+ * one, while a delayed refresh or custom job merely postpones work that is
+ * picked up again on the next run. So launch space-reclaiming policies
+ * first, the remaining maintenance policies after them, and bulk work last.
+ */
+typedef enum JobDispatchPriority
+{
+	JOB_DISPATCH_PRIORITY_CRITICAL = 0,
+	JOB_DISPATCH_PRIORITY_MAINTENANCE,
+	JOB_DISPATCH_PRIORITY_BULK,
+} JobDispatchPriority;
+
+/*
+ * Classify a job by the procedure it runs. The names mirror the policy
+ * procedures defined in the TSL module; jobs running anything else,
+ * including all user-defined jobs, count as bulk work.
+ */
+static JobDispatchPriority
+job_dispatch_priority(const ScheduledBgwJob *sjob)
+{
+	if (namestrcmp((Name) &sjob->job.fd.proc_schema, FUNCTIONS_SCHEMA_NAME) != 0)
+		return JOB_DISPATCH_PRIORITY_BULK;
+
+	if (namestrcmp((Name) &sjob->job.fd.proc_name, "policy_retention") == 0 ||
+		namestrcmp((Name) &sjob->job.fd.proc_name, "policy_job_stat_history_retention") == 0)
+		return JOB_DISPATCH_PRIORITY_CRITICAL;
+
+	if (namestrcmp((Name) &sjob->job.fd.proc_name, "policy_compression") == 0 ||
+		namestrcmp((Name) &sjob->job.fd.proc_name, "policy_reorder") == 0)
+		return JOB_DISPATCH_PRIORITY_MAINTENANCE;
+
+	return JOB_DISPATCH_PRIORITY_BULK;
+}
+
+/*
+ * Order due jobs by dispatch priority class and, within a class, by how far
+ * the job is past its scheduled start, so the most overdue job in each class
+ * is the first to get a worker.
+ */
 static int
-cmp_next_start(const ListCell *left_cell, const ListCell *right_cell)
+cmp_dispatch_order(const ListCell *left_cell, const ListCell *right_cell)
 {
 	ScheduledBgwJob *left_sjob = lfirst(left_cell);
 	ScheduledBgwJob *right_sjob = lfirst(right_cell);
+	JobDispatchPriority left_priority = job_dispatch_priority(left_sjob);
+	JobDispatchPriority right_priority = job_dispatch_priority(right_sjob);
+
+	if (left_priority != right_priority)
+		return left_priority < right_priority ? -1 : 1;
 
 	if (left_sjob->next_start < right_sjob->next_start)
 		return -1;
@@ -601,26 +671,26 @@ cmp_next_start(const ListCell *left_cell, const ListCell *right_cell)
 static void
 start_scheduled_jobs(register_background_worker_callback_type bgw_register)
 {
-	List *ordered_scheduled_jobs;
+	List *due_jobs = NIL;
+	List *launched_jobs = NIL;
 	ListCell *lc;
+	TimestampTz now = ts_timer_get_current_timestamp();
 	Assert(CurrentMemoryContext == scratch_mctx);
 
-	/* Order jobs by increasing next_start */
-	/* list_sort does in-place sort - so make a copy and sort that */
-	ordered_scheduled_jobs = list_copy(scheduled_jobs);
-	list_sort(ordered_scheduled_jobs, cmp_next_start);
-
-	foreach (lc, ordered_scheduled_jobs)
+	/* Collect the jobs that are due and sort only those into dispatch
+	 * order. The due set is usually much smaller than the jobs list, so
+	 * this keeps the sorting work on each wakeup proportional to the number
+	 * of jobs actually started instead of re-sorting all scheduled jobs. */
+	foreach (lc, scheduled_jobs)
 	{
 		ScheduledBgwJob *sjob = lfirst(lc);
 
-		int64 job_start_diff = sjob->next_start - ts_timer_get_current_timestamp();
+		int64 job_start_diff = sjob->next_start - now;
 
 		if (sjob->state == JOB_STATE_SCHEDULED &&
 			(job_start_diff <= 0 || sjob->next_start == DT_NOBEGIN))
 		{
-			elog(DEBUG2, "starting scheduled job %d", sjob->job.fd.id);
-			scheduled_ts_bgw_job_start(sjob, bgw_register);
+			due_jobs = lappend(due_jobs, sjob);
 		}
 		else
 		{
@@ -631,7 +701,37 @@ start_scheduled_jobs(register_background_worker_callback_type bgw_register)
 		}
 	}
 
-	list_free(ordered_scheduled_jobs);
+	list_sort(due_jobs, cmp_dispatch_order);
+
+	/* Launch all due jobs before waiting for any of them to start. Waiting
+	 * for a worker startup can take a while, and doing it per job serializes
+	 * job dispatch on the startup latency. By registering all workers first,
+	 * the postmaster starts them in parallel while we wait. */
+	foreach (lc, due_jobs)
+	{
+		ScheduledBgwJob *sjob = lfirst(lc);
+
+		/* Log how far behind its scheduled start the job is launched, to make
+		 * scheduling drift under load visible. */
+		if (sjob->next_start != DT_NOBEGIN)
+			elog(DEBUG2,
+				 "starting scheduled job %d (" INT64_FORMAT " ms after its scheduled start)",
+				 sjob->job.fd.id,
+				 (now - sjob->next_start) / ONE_MILLISECOND_IN_MICROSECONDS);
+		else
+			elog(DEBUG2, "starting scheduled job %d", sjob->job.fd.id);
+
+		scheduled_ts_bgw_job_launch(sjob, bgw_register);
+
+		if (sjob->state == JOB_STATE_STARTED)
+			launched_jobs = lappend(launched_jobs, sjob);
+	}
+
+	foreach (lc, launched_jobs)
+		scheduled_ts_bgw_job_confirm_start(lfirst(lc));
+
+	list_free(due_jobs);
+	list_free(launched_jobs);
 }
 
 /* Returns the earliest time the scheduler should start a job that is waiting to be started */
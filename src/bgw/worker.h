@@ -37,6 +37,7 @@ typedef struct BgwParams
 	/** Job history information to use for the worker when recording the job execution */
 	int64 job_history_id;
 	TimestampTz job_history_execution_start;
+	TimestampTz job_history_scheduled_start;
 
 	/** Time to live. Only used in tests. */
 	int32 ttl;
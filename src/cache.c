@@ -4,8 +4,12 @@
  * LICENSE-APACHE for a copy of the license.
  */
 #include <postgres.h>
+#include <access/htup_details.h>
 #include <access/xact.h>
+#include <funcapi.h>
+#include <portability/instr_time.h>
 #include <storage/ipc.h>
+#include <utils/builtins.h>
 
 #include "compat/compat.h"
 #include "cache.h"
@@ -21,6 +25,49 @@ typedef struct CachePin
 	SubTransactionId subtxnid;
 } CachePin;
 
+/*
+ * Cumulative per-cache statistics. A Cache object is destroyed and rebuilt on
+ * invalidation, so counters that are meant to quantify the invalidation
+ * traffic itself have to live outside of it. They are accumulated here, keyed
+ * by the cache name, for the lifetime of the backend, and exposed through the
+ * timescaledb_information.cache_stats view. The counters are backend-local
+ * because the caches themselves are backend-local; aggregate the view output
+ * across sessions to get cluster-wide numbers.
+ */
+struct CacheCumulativeStats
+{
+	const char *name;
+	Cache *current; /* The live cache instance, or NULL between rebuilds */
+	uint64 hits;
+	uint64 misses;
+	uint64 invalidations;
+	uint64 rebuilds;		 /* Number of times the cache was built,
+							  * including the initial build */
+	uint64 entry_build_usec; /* Total time spent building cache entries */
+	struct CacheCumulativeStats *next;
+};
+
+static CacheCumulativeStats *cumulative_stats_list = NULL;
+
+static CacheCumulativeStats *
+cache_cumulative_stats_get(const char *name)
+{
+	CacheCumulativeStats *entry;
+
+	for (entry = cumulative_stats_list; entry != NULL; entry = entry->next)
+	{
+		if (strcmp(entry->name, name) == 0)
+			return entry;
+	}
+
+	entry = MemoryContextAllocZero(TopMemoryContext, sizeof(CacheCumulativeStats));
+	entry->name = MemoryContextStrdup(TopMemoryContext, name);
+	entry->next = cumulative_stats_list;
+	cumulative_stats_list = entry;
+
+	return entry;
+}
+
 static void
 cache_reset_pinned_caches(void)
 {
@@ -57,6 +104,10 @@ ts_cache_init(Cache *cache)
 	cache->refcount = 1;
 	cache->handle_txn_callbacks = true;
 	cache->release_on_commit = true;
+
+	cache->cumulative_stats = cache_cumulative_stats_get(cache->name);
+	cache->cumulative_stats->rebuilds++;
+	cache->cumulative_stats->current = cache;
 }
 
 static void
@@ -74,6 +125,9 @@ cache_destroy(Cache **cache_ptr)
 	if (cache->pre_destroy_hook != NULL)
 		cache->pre_destroy_hook(cache);
 
+	if (cache->cumulative_stats != NULL && cache->cumulative_stats->current == cache)
+		cache->cumulative_stats->current = NULL;
+
 	hash_destroy(cache->htab);
 	MemoryContextDelete(cache->hctl.hcxt);
 	*cache_ptr = NULL;
@@ -85,6 +139,7 @@ ts_cache_invalidate(Cache **cache_ptr)
 	Cache *cache = *cache_ptr;
 	if (cache == NULL)
 		return;
+	cache->cumulative_stats->invalidations++;
 	cache->refcount--;
 	cache_destroy(cache_ptr);
 }
@@ -190,6 +245,7 @@ ts_cache_fetch(Cache *cache, CacheQuery *query)
 	if (found)
 	{
 		cache->stats.hits++;
+		cache->cumulative_stats->hits++;
 
 		if (cache->update_entry != NULL)
 			query->result = cache->update_entry(cache, query);
@@ -197,11 +253,20 @@ ts_cache_fetch(Cache *cache, CacheQuery *query)
 	else
 	{
 		cache->stats.misses++;
+		cache->cumulative_stats->misses++;
 
 		if (action == HASH_ENTER)
 		{
+			instr_time start;
+			instr_time duration;
+
 			cache->stats.numelements++;
+
+			INSTR_TIME_SET_CURRENT(start);
 			query->result = cache->create_entry(cache, query);
+			INSTR_TIME_SET_CURRENT(duration);
+			INSTR_TIME_SUBTRACT(duration, start);
+			cache->cumulative_stats->entry_build_usec += INSTR_TIME_GET_MICROSEC(duration);
 		}
 	}
 
@@ -356,6 +421,72 @@ cache_subxact_abort(SubXactEvent event, SubTransactionId subtxn_id, SubTransacti
 	}
 }
 
+TS_FUNCTION_INFO_V1(ts_cache_stats);
+
+/*
+ * Returns one row per known cache with the cumulative counters of this
+ * backend, backing the timescaledb_information.cache_stats view. The entry
+ * count and memory usage refer to the live cache instance and are NULL when
+ * the cache is currently torn down after an invalidation.
+ */
+Datum
+ts_cache_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	CacheCumulativeStats *entry;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc tupdesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			elog(ERROR, "function returning record called in context that cannot accept type record");
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+		funcctx->user_fctx = cumulative_stats_list;
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	entry = funcctx->user_fctx;
+
+	if (entry != NULL)
+	{
+		Datum values[8] = { 0 };
+		bool nulls[8] = { false };
+
+		funcctx->user_fctx = entry->next;
+
+		values[0] = CStringGetTextDatum(entry->name);
+		values[1] = Int64GetDatum(entry->hits);
+		values[2] = Int64GetDatum(entry->misses);
+		values[3] = Int64GetDatum(entry->invalidations);
+		values[4] = Int64GetDatum(entry->rebuilds);
+		values[5] = Float8GetDatum(entry->entry_build_usec / 1000.0);
+
+		if (entry->current != NULL)
+		{
+			values[6] = Int64GetDatum(entry->current->stats.numelements);
+			values[7] =
+				Int64GetDatum(MemoryContextMemAllocated(entry->current->hctl.hcxt, true));
+		}
+		else
+		{
+			nulls[6] = true;
+			nulls[7] = true;
+		}
+
+		SRF_RETURN_NEXT(funcctx,
+						HeapTupleGetDatum(heap_form_tuple(funcctx->tuple_desc, values, nulls)));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
+
 void
 _cache_init(void)
 {
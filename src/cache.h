@@ -35,6 +35,12 @@ typedef struct CacheStats
 	uint64 misses;
 } CacheStats;
 
+/*
+ * Counters that survive the destruction of cache instances on invalidation,
+ * accumulated per cache name for the lifetime of the backend. See cache.c.
+ */
+typedef struct CacheCumulativeStats CacheCumulativeStats;
+
 typedef struct Cache
 {
 	HASHCTL hctl;
@@ -44,6 +50,7 @@ typedef struct Cache
 	long numelements;
 	int flags;
 	CacheStats stats;
+	CacheCumulativeStats *cumulative_stats;
 	void *(*get_key)(struct CacheQuery *);
 	void *(*create_entry)(struct Cache *, CacheQuery *);
 	void *(*update_entry)(struct Cache *, CacheQuery *);
@@ -16,7 +16,12 @@
 #include "annotations.h"
 #include "extension.h"
 #include "hypertable_cache.h"
+#include "hypertable_restrict_info.h"
+#include "planner/planner.h"
 #include "ts_catalog/catalog.h"
+#include "ts_catalog/chunk_column_stats.h"
+#include "ts_catalog/compression_settings.h"
+#include "ts_catalog/continuous_aggs_watermark.h"
 
 #include "bgw/scheduler.h"
 #include "cache_invalidate.h"
@@ -57,16 +62,24 @@ static inline void
 cache_invalidate_relcache_all(void)
 {
 	ts_hypertable_cache_invalidate_callback();
+	ts_chunk_exclusion_cache_invalidate();
+	ts_chunk_column_stats_cache_invalidate();
+	ts_planner_relclass_cache_invalidate();
 	ts_bgw_job_cache_invalidate_callback();
+	ts_cagg_watermark_cache_invalidate();
+	ts_compression_settings_cache_invalidate();
 }
 
 static Oid hypertable_proxy_table_oid = InvalidOid;
+static Oid chunk_proxy_table_oid = InvalidOid;
 static Oid bgw_proxy_table_oid = InvalidOid;
 
 void
-ts_cache_invalidate_set_proxy_tables(Oid hypertable_proxy_oid, Oid bgw_proxy_oid)
+ts_cache_invalidate_set_proxy_tables(Oid hypertable_proxy_oid, Oid chunk_proxy_oid,
+									 Oid bgw_proxy_oid)
 {
 	hypertable_proxy_table_oid = hypertable_proxy_oid;
+	chunk_proxy_table_oid = chunk_proxy_oid;
 	bgw_proxy_table_oid = bgw_proxy_oid;
 }
 
@@ -89,16 +102,42 @@ cache_invalidate_relcache_callback(Datum arg, Oid relid)
 	{
 		ts_extension_invalidate();
 		cache_invalidate_relcache_all();
-		ts_cache_invalidate_set_proxy_tables(InvalidOid, InvalidOid);
+		ts_cache_invalidate_set_proxy_tables(InvalidOid, InvalidOid, InvalidOid);
 	}
 	else if (relid == hypertable_proxy_table_oid)
 	{
 		ts_hypertable_cache_invalidate_callback();
+		ts_chunk_exclusion_cache_invalidate();
+		ts_chunk_column_stats_cache_invalidate();
+		ts_planner_relclass_cache_invalidate();
+	}
+	else if (relid == chunk_proxy_table_oid)
+	{
+		/*
+		 * Chunk-level changes, e.g., chunk creation, invalidate cached chunk
+		 * exclusion and planning results but leave the hypertable cache
+		 * intact since the hypertable metadata did not change.
+		 */
+		ts_chunk_exclusion_cache_invalidate();
+		ts_planner_relclass_cache_invalidate();
 	}
 	else if (relid == bgw_proxy_table_oid)
 	{
 		ts_bgw_job_cache_invalidate_callback();
 	}
+	else
+	{
+		/*
+		 * Hypertable updates, watermark updates, and compression settings
+		 * changes signal other backends by invalidating the relcache entry of
+		 * the affected relation, so forward the relid to those caches. These
+		 * are probes of backend-local hash tables and do not query the
+		 * relcache or syscache.
+		 */
+		ts_hypertable_cache_invalidate_relid(relid);
+		ts_cagg_watermark_cache_invalidate_relid(relid);
+		ts_compression_settings_cache_invalidate_relid(relid);
+	}
 }
 
 TS_FUNCTION_INFO_V1(ts_timescaledb_invalidate_cache);
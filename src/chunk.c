@@ -11,6 +11,7 @@
 #include <access/tableam.h>
 #include <access/tupdesc.h>
 #include <access/xact.h>
+#include <catalog/dependency.h>
 #include <catalog/indexing.h>
 #include <catalog/namespace.h>
 #include <catalog/pg_class.h>
@@ -24,6 +25,7 @@
 #include <catalog/pg_type_d.h>
 #include <catalog/toasting.h>
 #include <commands/defrem.h>
+#include <common/hashfn.h>
 #include <commands/publicationcmds.h>
 #include <commands/tablecmds.h>
 #include <commands/trigger.h>
@@ -38,6 +40,7 @@
 #include <nodes/value.h>
 #include <parser/parse_node.h>
 #include <storage/lmgr.h>
+#include <storage/lock.h>
 #include <storage/lockdefs.h>
 #include <tcop/tcopprot.h>
 #include <utils/acl.h>
@@ -49,6 +52,7 @@
 #include <utils/inval.h>
 #include <utils/lsyscache.h>
 #include <utils/palloc.h>
+#include <utils/snapmgr.h>
 #include <utils/syscache.h>
 #include <utils/timestamp.h>
 #include <utils/typcache.h>
@@ -56,6 +60,7 @@
 #include "chunk.h"
 
 #include "compat/compat.h"
+#include "adts/int32_vec.h"
 #include "bgw_policy/chunk_stats.h"
 #include "cache.h"
 #include "chunk_index.h"
@@ -74,6 +79,7 @@
 #include "hypertable_cache.h"
 #include "osm_callbacks.h"
 #include "partition_chunk.h"
+#include "probes.h"
 #include "process_utility.h"
 #include "scan_iterator.h"
 #include "scanner.h"
@@ -146,6 +152,8 @@ static void chunk_collision_scan(ChunkScanCtx *scanctx, const Hypercube *cube);
 static int chunk_scan_ctx_foreach_chunk_stub(ChunkScanCtx *ctx, on_chunk_stub_func on_chunk,
 											 uint64 limit);
 static Datum show_chunks_return_srf(FunctionCallInfo fcinfo);
+static void chunk_drop_internal(const Chunk *chunk, DropBehavior behavior, int32 log_level,
+								ObjectAddresses *objects);
 static int chunk_cmp(const void *ch1, const void *ch2);
 static void init_scan_by_qualified_table_name(ScanIterator *iterator, const char *schema_name,
 											  const char *table_name);
@@ -775,6 +783,15 @@ ts_chunk_create_table(const Chunk *chunk, const Hypertable *ht, const char *tabl
 	/* Inherit the persistence (LOGGED or UNLOGGED) from the parent hypertable */
 	stmt.relation->relpersistence = rel->rd_rel->relpersistence;
 
+	/*
+	 * In unlogged staging mode chunks skip WAL on ingest. The data is
+	 * WAL-logged in bulk when the chunk is compressed, because the compressed
+	 * chunk is created logged, see compression_chunk_create().
+	 */
+	if (ts_flags_are_set_32(ht->fd.status, HYPERTABLE_STATUS_UNLOGGED_STAGING) &&
+		stmt.relation->relpersistence == RELPERSISTENCE_PERMANENT)
+		stmt.relation->relpersistence = RELPERSISTENCE_UNLOGGED;
+
 	/*
 	 * If the chunk is created in the internal schema, become the catalog
 	 * owner, otherwise become the hypertable owner
@@ -1159,6 +1176,8 @@ chunk_create_from_hypercube_after_lock(const Hypertable *ht, Hypercube *cube,
 	if (ts_guc_enable_chunk_auto_publication)
 		chunk_add_to_publications(chunk);
 
+	TS_PROBE3(chunk_create, ht->fd.id, chunk->fd.id, chunk->table_id);
+
 	return chunk;
 }
 
@@ -1358,12 +1377,45 @@ chunk_create_from_point_after_lock(const Hypertable *ht, const Point *p, const c
 	return chunk_create_from_hypercube_after_lock(ht, cube, schema_name, table_name, prefix);
 }
 
+/*
+ * Set up an advisory lock tag that identifies creation of the chunk covering
+ * the given hypercube. Backends racing to create the same chunk queue up on
+ * this tag instead of on the hypertable lock, so they neither convoy behind
+ * creators of other chunks nor make those creators queue up behind them. The
+ * hash is computed from the dimensional ranges only, which are deterministic
+ * for a given point, and not from the slice ids, which are unassigned for
+ * slices that do not exist yet.
+ */
+static void
+chunk_creation_locktag(LOCKTAG *tag, const Hypertable *ht, const Hypercube *hc)
+{
+	uint32 hash = 0;
+
+	for (int i = 0; i < hc->num_slices; i++)
+	{
+		const DimensionSlice *slice = hc->slices[i];
+		int64 range[2] = { slice->fd.range_start, slice->fd.range_end };
+
+		hash = hash_combine(hash, hash_uint32((uint32) slice->fd.dimension_id));
+		hash = hash_combine(hash, hash_bytes((const unsigned char *) range, sizeof(range)));
+	}
+
+	/* The job locks in bgw/job.c use the same lock space with field 3 set to
+	 * zero, so avoid a zero hash. */
+	if (hash == 0)
+		hash = 1;
+
+	TS_SET_LOCKTAG_ADVISORY(*tag, MyDatabaseId, (uint32) ht->fd.id, hash);
+}
+
 Chunk *
 ts_chunk_find_or_create_without_cuts(const Hypertable *ht, Hypercube *hc, const char *schema_name,
 									 const char *table_name, Oid chunk_table_relid, bool *created)
 {
 	ChunkStub *stub;
 	Chunk *chunk = NULL;
+	LOCKTAG cube_tag;
+	bool cube_locked = false;
 
 	DEBUG_WAITPOINT("find_or_create_chunk_start");
 
@@ -1371,9 +1423,42 @@ ts_chunk_find_or_create_without_cuts(const Hypertable *ht, Hypercube *hc, const
 
 	if (NULL == stub)
 	{
+		/*
+		 * Wait for concurrent creators of this particular chunk on an
+		 * advisory lock keyed by the hypercube. The creator holds the lock
+		 * until commit, so when a waiter gets it, the new chunk's metadata
+		 * is visible and the recheck below finds it without ever touching
+		 * the hypertable lock that serializes all chunk creation.
+		 */
+		chunk_creation_locktag(&cube_tag, ht, hc);
+		(void) LockAcquire(&cube_tag, ExclusiveLock, false, false);
+		cube_locked = true;
+
+		/* Check again after the keyed lock */
+		stub = chunk_collides(ht, hc);
+	}
+
+	if (NULL == stub)
+	{
+		/*
+		 * Release the keyed lock before blocking on the hypertable lock. A
+		 * creator of some other chunk holds the hypertable lock until commit
+		 * and may request our cube tag when it crosses a second chunk
+		 * boundary in the same transaction, so waiting here with the tag held
+		 * would deadlock. Reacquiring below cannot deadlock in turn: once we
+		 * hold the self-conflicting hypertable lock there can be no
+		 * concurrent creator holding the tag until commit, and other waiters
+		 * release it before blocking on the hypertable lock.
+		 */
+		LockRelease(&cube_tag, ExclusiveLock, false);
+		cube_locked = false;
+
 		/* Serialize chunk creation around the root hypertable */
 		LockRelationOid(ht->main_table_relid, ShareUpdateExclusiveLock);
 
+		(void) LockAcquire(&cube_tag, ExclusiveLock, false, false);
+		cube_locked = true;
+
 		/* Check again after lock */
 		stub = chunk_collides(ht, hc);
 
@@ -1413,6 +1498,11 @@ ts_chunk_find_or_create_without_cuts(const Hypertable *ht, Hypercube *hc, const
 		UnlockRelationOid(ht->main_table_relid, ShareUpdateExclusiveLock);
 	}
 
+	/* We created nothing, so release the keyed creation lock right away. The
+	 * creator keeps it until commit. */
+	if (cube_locked)
+		LockRelease(&cube_tag, ExclusiveLock, false);
+
 	Assert(NULL != stub);
 
 	/* We can only use an existing chunk if it has identical dimensional
@@ -1471,6 +1561,44 @@ Chunk *
 ts_chunk_create_for_point(const Hypertable *ht, const Point *p, const char *schema,
 						  const char *prefix, LOCKMODE chunk_lockmode)
 {
+	/*
+	 * First wait for concurrent creators of this particular chunk on an
+	 * advisory lock keyed by the hypercube the point falls into. The creator
+	 * holds the lock until commit, so when a waiter gets it, the new chunk's
+	 * metadata is visible and the recheck below finds it. The many backends
+	 * that race for the same new chunk at a partition boundary thereby
+	 * resolve on the keyed lock and never reach the hypertable lock below,
+	 * which would also make them convoy with creators of other chunks.
+	 *
+	 * The tag only needs deterministic ranges, so compute them from the
+	 * partitioning configuration alone. This avoids the dimension slice
+	 * catalog scans of a full hypercube calculation, which add up during
+	 * backfills that create many chunks.
+	 */
+	Hypercube *cube = ts_hypercube_calculate_default_from_point(ht->space, p);
+	LOCKTAG cube_tag;
+
+	chunk_creation_locktag(&cube_tag, ht, cube);
+	ts_hypercube_free(cube);
+	(void) LockAcquire(&cube_tag, ExclusiveLock, false, false);
+
+	Chunk *existing_chunk = ts_chunk_find_for_point(ht, p, chunk_lockmode);
+	if (existing_chunk != NULL)
+	{
+		/* Chunk was created by someone else, release the keyed lock early */
+		LockRelease(&cube_tag, ExclusiveLock, false);
+		return existing_chunk;
+	}
+
+	/*
+	 * Release the keyed lock before blocking on the hypertable lock. A
+	 * transaction that created some other chunk holds the hypertable lock
+	 * until commit and requests our cube tag when it crosses a second chunk
+	 * boundary, so waiting on the hypertable lock with the tag held would
+	 * deadlock with it.
+	 */
+	LockRelease(&cube_tag, ExclusiveLock, false);
+
 	/*
 	 * Serialize chunk creation around a lock on the "main table" to avoid
 	 * multiple processes trying to create the same chunk. We use a
@@ -1479,6 +1607,15 @@ ts_chunk_create_for_point(const Hypertable *ht, const Point *p, const char *sche
 	 */
 	LockRelationOid(ht->main_table_relid, ShareUpdateExclusiveLock);
 
+	/*
+	 * Retake the keyed lock so that backends racing for this chunk keep
+	 * queueing on it rather than on the hypertable lock. This cannot
+	 * deadlock: the hypertable lock we now hold is self-conflicting, so no
+	 * concurrent creator can be holding the tag until commit, and other
+	 * waiters release it before blocking on the hypertable lock.
+	 */
+	(void) LockAcquire(&cube_tag, ExclusiveLock, false, false);
+
 	DEBUG_WAITPOINT("chunk_create_for_point");
 
 	/*
@@ -1504,9 +1641,10 @@ ts_chunk_create_for_point(const Hypertable *ht, const Point *p, const char *sche
 		{
 			/*
 			 * Chunk was not created by us but by someone else, so we can
-			 * release the lock early.
+			 * release the locks early.
 			 */
 			UnlockRelationOid(ht->main_table_relid, ShareUpdateExclusiveLock);
+			LockRelease(&cube_tag, ExclusiveLock, false);
 			return chunk;
 		}
 	}
@@ -1519,29 +1657,6 @@ ts_chunk_create_for_point(const Hypertable *ht, const Point *p, const char *sche
 	return chunk;
 }
 
-static void
-scan_add_chunk_context(ChunkScanCtx *ctx, int32 chunk_id, List *dimension_vecs, List **l_chunk_ids)
-{
-	bool found = false;
-	ChunkScanEntry *entry = hash_search(ctx->htab, &chunk_id, HASH_ENTER, &found);
-	if (!found)
-	{
-		entry->stub = NULL;
-		entry->num_dimension_constraints = 0;
-	}
-
-	entry->num_dimension_constraints++;
-
-	/*
-	 * A chunk is complete when we've found slices for all required dimensions,
-	 * i.e., a complete subspace.
-	 */
-	if (entry->num_dimension_constraints == list_length(dimension_vecs))
-	{
-		*l_chunk_ids = lappend_int(*l_chunk_ids, entry->chunk_id);
-	}
-}
-
 /*
  * Find the chunks that belong to the subspace identified by the given dimension
  * vectors. We might be restricting only some dimensions, so this subspace is
@@ -1552,9 +1667,14 @@ List *
 ts_chunk_id_find_in_subspace(Hypertable *ht, List *dimension_vecs)
 {
 	List *chunk_ids = NIL;
+	int32_vec result;
+	int32_vec dimension_ids;
+	int32_vec intersection;
+	bool first_dimension = true;
 
-	ChunkScanCtx ctx;
-	chunk_scan_ctx_init(&ctx, ht, /* point = */ NULL);
+	int32_vec_init(&result, CurrentMemoryContext, 0);
+	int32_vec_init(&dimension_ids, CurrentMemoryContext, 0);
+	int32_vec_init(&intersection, CurrentMemoryContext, 0);
 
 	ScanIterator iterator = ts_chunk_constraint_scan_iterator_create(CurrentMemoryContext);
 
@@ -1563,6 +1683,8 @@ ts_chunk_id_find_in_subspace(Hypertable *ht, List *dimension_vecs)
 	{
 		const DimensionVec *vec = lfirst(lc);
 
+		int32_vec_clear(&dimension_ids);
+
 		/*
 		 * If it's an entry of type DIMENSION_TYPE_STATS then we need to get
 		 * the chunks using the _timescaledb_catalog.chunk_column_stats catalog.
@@ -1576,52 +1698,88 @@ ts_chunk_id_find_in_subspace(Hypertable *ht, List *dimension_vecs)
 			Assert(vec->num_slices == 0);
 			range_chunk_ids = ts_chunk_column_stats_get_chunk_ids_by_scan(vec->dri);
 
-			/* add these chunks to the context appropriately. */
 			foreach (lc, range_chunk_ids)
+				int32_vec_append(&dimension_ids, lfirst_int(lc));
+		}
+		else
+		{
+			/*
+			 * We shouldn't see a dimension with zero matching dimension slices.
+			 * That would mean that no chunks match at all, this should have been
+			 * handled earlier by gather_restriction_dimension_vectors().
+			 */
+			Assert(vec->num_slices > 0);
+			for (int i = 0; i < vec->num_slices; i++)
 			{
-				int32 chunk_id = lfirst_int(lc);
+				const DimensionSlice *slice = vec->slices[i];
 
-				scan_add_chunk_context(&ctx, chunk_id, dimension_vecs, &chunk_ids);
+				ts_chunk_constraint_scan_iterator_set_slice_id(&iterator, slice->fd.id);
+				ts_scan_iterator_start_or_restart_scan(&iterator);
+
+				while (ts_scan_iterator_next(&iterator) != NULL)
+				{
+					TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+					bool PG_USED_FOR_ASSERTS_ONLY isnull = true;
+					Datum datum = slot_getattr(ti->slot, Anum_chunk_constraint_chunk_id, &isnull);
+					Assert(!isnull);
+					int32 current_chunk_id = DatumGetInt32(datum);
+					Assert(current_chunk_id != INVALID_CHUNK_ID);
+
+					/*
+					 * We have only the dimension constraints here, because we're searching
+					 * by dimension slice id.
+					 */
+					Assert(!slot_attisnull(ts_scan_iterator_slot(&iterator),
+										   Anum_chunk_constraint_dimension_slice_id));
+					int32_vec_append(&dimension_ids, current_chunk_id);
+				}
 			}
-			continue;
 		}
 
 		/*
-		 * We shouldn't see a dimension with zero matching dimension slices.
-		 * That would mean that no chunks match at all, this should have been
-		 * handled earlier by gather_restriction_dimension_vectors().
+		 * A chunk references one slice per dimension and the slices of a
+		 * dimension are distinct, so the ids collected above are normally
+		 * already unique; sorting them allows the merge intersection below.
+		 * A chunk belongs to the subspace when it matches in every dimension.
 		 */
-		Assert(vec->num_slices > 0);
-		for (int i = 0; i < vec->num_slices; i++)
+		int32_vec_sort_unique(&dimension_ids);
+
+		/* A dimension without any matching chunks excludes every chunk */
+		if (dimension_ids.num_elements == 0)
 		{
-			const DimensionSlice *slice = vec->slices[i];
+			int32_vec_clear(&result);
+			break;
+		}
 
-			ts_chunk_constraint_scan_iterator_set_slice_id(&iterator, slice->fd.id);
-			ts_scan_iterator_start_or_restart_scan(&iterator);
+		if (first_dimension)
+		{
+			int32_vec_append_array(&result, dimension_ids.data, dimension_ids.num_elements);
+			first_dimension = false;
+		}
+		else
+		{
+			int32_vec tmp;
 
-			while (ts_scan_iterator_next(&iterator) != NULL)
-			{
-				TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
-				bool PG_USED_FOR_ASSERTS_ONLY isnull = true;
-				Datum datum = slot_getattr(ti->slot, Anum_chunk_constraint_chunk_id, &isnull);
-				Assert(!isnull);
-				int32 current_chunk_id = DatumGetInt32(datum);
-				Assert(current_chunk_id != INVALID_CHUNK_ID);
-
-				/*
-				 * We have only the dimension constraints here, because we're searching
-				 * by dimension slice id.
-				 */
-				Assert(!slot_attisnull(ts_scan_iterator_slot(&iterator),
-									   Anum_chunk_constraint_dimension_slice_id));
-				scan_add_chunk_context(&ctx, current_chunk_id, dimension_vecs, &chunk_ids);
-			}
+			int32_vec_clear(&intersection);
+			int32_vec_intersect(&intersection, &result, &dimension_ids);
+			tmp = result;
+			result = intersection;
+			intersection = tmp;
 		}
+
+		/* No chunk can match all dimensions anymore */
+		if (result.num_elements == 0)
+			break;
 	}
 
 	ts_scan_iterator_close(&iterator);
 
-	chunk_scan_ctx_destroy(&ctx);
+	for (uint32 i = 0; i < result.num_elements; i++)
+		chunk_ids = lappend_int(chunk_ids, result.data[i]);
+
+	int32_vec_free_data(&result);
+	int32_vec_free_data(&dimension_ids);
+	int32_vec_free_data(&intersection);
 
 	return chunk_ids;
 }
@@ -2979,7 +3137,8 @@ ts_chunk_get_id(const char *schema, const char *table, int32 *chunk_id, bool mis
  *
  */
 static void
-chunk_tuple_delete(TupleInfo *ti, Oid relid, DropBehavior behavior, bool detach)
+chunk_tuple_delete(TupleInfo *ti, Oid relid, DropBehavior behavior, bool detach,
+				   ObjectAddresses *objects)
 {
 	FormData_chunk form;
 	CatalogSecurityContext sec_ctx;
@@ -3099,7 +3258,7 @@ chunk_tuple_delete(TupleInfo *ti, Oid relid, DropBehavior behavior, bool detach)
 		{
 			/* Plain drop without preserving catalog row because this is the compressed
 			 * chunk */
-			ts_chunk_drop(compressed_chunk, behavior, DEBUG1);
+			chunk_drop_internal(compressed_chunk, behavior, DEBUG1, objects);
 		}
 	}
 	else if (OidIsValid(relid))
@@ -3132,13 +3291,14 @@ init_scan_by_qualified_table_name(ScanIterator *iterator, const char *schema_nam
 }
 
 static int
-chunk_delete(ScanIterator *iterator, Oid relid, DropBehavior behavior, bool detach)
+chunk_delete(ScanIterator *iterator, Oid relid, DropBehavior behavior, bool detach,
+			 ObjectAddresses *objects)
 {
 	int count = 0;
 
 	ts_scanner_foreach(iterator)
 	{
-		chunk_tuple_delete(ts_scan_iterator_tuple_info(iterator), relid, behavior, detach);
+		chunk_tuple_delete(ts_scan_iterator_tuple_info(iterator), relid, behavior, detach, objects);
 		count++;
 	}
 
@@ -3147,13 +3307,13 @@ chunk_delete(ScanIterator *iterator, Oid relid, DropBehavior behavior, bool deta
 
 static int
 ts_chunk_delete_by_name_internal(const char *schema, const char *table, Oid relid,
-								 DropBehavior behavior)
+								 DropBehavior behavior, ObjectAddresses *objects)
 {
 	ScanIterator iterator = ts_scan_iterator_create(CHUNK, RowExclusiveLock, CurrentMemoryContext);
 	int count;
 
 	init_scan_by_qualified_table_name(&iterator, schema, table);
-	count = chunk_delete(&iterator, relid, behavior, false);
+	count = chunk_delete(&iterator, relid, behavior, false, objects);
 
 	/* (schema,table) names and (hypertable_id) are unique so should only have
 	 * dropped one chunk or none (if not found) */
@@ -3166,7 +3326,7 @@ int
 ts_chunk_delete_by_name(const char *schema, const char *table, DropBehavior behavior)
 {
 	Oid relid = ts_get_relation_relid(schema, table, false);
-	return ts_chunk_delete_by_name_internal(schema, table, relid, behavior);
+	return ts_chunk_delete_by_name_internal(schema, table, relid, behavior, NULL);
 }
 
 int
@@ -3176,7 +3336,7 @@ ts_chunk_delete_by_relid_and_relname(Oid relid, const char *schemaname, const ch
 	if (!OidIsValid(relid))
 		return 0;
 
-	return ts_chunk_delete_by_name_internal(schemaname, tablename, relid, behavior);
+	return ts_chunk_delete_by_name_internal(schemaname, tablename, relid, behavior, NULL);
 }
 
 static void
@@ -3197,7 +3357,7 @@ ts_chunk_delete_by_hypertable_id(int32 hypertable_id)
 
 	init_scan_by_hypertable_id(&iterator, hypertable_id);
 
-	return chunk_delete(&iterator, InvalidOid, DROP_RESTRICT, false);
+	return chunk_delete(&iterator, InvalidOid, DROP_RESTRICT, false, NULL);
 }
 
 bool
@@ -3498,12 +3658,62 @@ ts_chunk_set_unordered(Chunk *chunk)
 	return ts_chunk_add_status(chunk, CHUNK_STATUS_COMPRESSED_UNORDERED);
 }
 
+/*
+ * Check whether the given status flags are already set in the latest
+ * committed version of the chunk's catalog tuple. Unlike the status cached
+ * in the Chunk struct, which reflects the transaction snapshot, this cannot
+ * miss a concurrent change that committed after the snapshot was taken.
+ */
+static bool
+chunk_status_is_set_latest(int32 chunk_id, int32 status)
+{
+	ScanIterator iterator = ts_scan_iterator_create(CHUNK, AccessShareLock, CurrentMemoryContext);
+	bool is_set = false;
+
+	iterator.ctx.index = catalog_get_index(ts_catalog_get(), CHUNK, CHUNK_ID_INDEX);
+	iterator.ctx.snapshot = RegisterSnapshot(GetLatestSnapshot());
+	ts_scan_iterator_scan_key_init(&iterator,
+								   Anum_chunk_idx_id,
+								   BTEqualStrategyNumber,
+								   F_INT4EQ,
+								   Int32GetDatum(chunk_id));
+
+	ts_scanner_foreach(&iterator)
+	{
+		bool isnull;
+		Datum status_datum =
+			slot_getattr(ts_scan_iterator_slot(&iterator), Anum_chunk_status, &isnull);
+
+		Assert(!isnull);
+		is_set = ts_flags_are_set_32(DatumGetInt32(status_datum), status);
+	}
+	ts_scan_iterator_close(&iterator);
+	UnregisterSnapshot(iterator.ctx.snapshot);
+
+	return is_set;
+}
+
 bool
 ts_chunk_set_partial(Chunk *chunk)
 {
 	bool set_status;
 
 	Assert(ts_chunk_is_compressed(chunk));
+
+	/*
+	 * Marking the chunk partial takes a transaction-long exclusive lock on
+	 * its catalog tuple, so two DML statements that decompress batches from
+	 * the same chunk serialize on that tuple even though they could proceed
+	 * in parallel. Skip the tuple lock when the chunk is already marked
+	 * partial: the flag is only cleared under locks on the chunk relation
+	 * that conflict with the RowExclusiveLock our caller holds for the
+	 * duration of the transaction, so a committed flag cannot go away from
+	 * under us.
+	 */
+	if (ts_chunk_is_partial(chunk) &&
+		chunk_status_is_set_latest(chunk->fd.id, CHUNK_STATUS_COMPRESSED_PARTIAL))
+		return false;
+
 	set_status = ts_chunk_add_status(chunk, CHUNK_STATUS_COMPRESSED_PARTIAL);
 
 	if (set_status)
@@ -3853,8 +4063,9 @@ show_chunks_return_srf(FunctionCallInfo fcinfo)
 		SRF_RETURN_DONE(funcctx);
 }
 
-void
-ts_chunk_drop(const Chunk *chunk, DropBehavior behavior, int32 log_level)
+static void
+chunk_drop_internal(const Chunk *chunk, DropBehavior behavior, int32 log_level,
+					ObjectAddresses *objects)
 {
 	ObjectAddress objaddr = {
 		.classId = RelationRelationId,
@@ -3868,13 +4079,43 @@ ts_chunk_drop(const Chunk *chunk, DropBehavior behavior, int32 log_level)
 			 NameStr(chunk->fd.table_name));
 
 	/* Remove the chunk from the chunk table */
-	ts_chunk_delete_by_relid_and_relname(chunk->table_id,
-										 NameStr(chunk->fd.schema_name),
+	if (OidIsValid(chunk->table_id))
+		ts_chunk_delete_by_name_internal(NameStr(chunk->fd.schema_name),
 										 NameStr(chunk->fd.table_name),
-										 behavior);
+										 chunk->table_id,
+										 behavior,
+										 objects);
 
-	/* Drop the table */
-	performDeletion(&objaddr, behavior, 0);
+	/*
+	 * Drop the table. When the caller is dropping multiple chunks, the
+	 * object address is collected instead so that all chunk tables can be
+	 * dropped with a single performMultipleDeletions() call, which walks the
+	 * dependency graph and locks the involved catalogs once instead of once
+	 * per chunk.
+	 */
+	if (objects != NULL)
+		add_exact_object_address(&objaddr, objects);
+	else
+		performDeletion(&objaddr, behavior, 0);
+}
+
+void
+ts_chunk_drop(const Chunk *chunk, DropBehavior behavior, int32 log_level)
+{
+	chunk_drop_internal(chunk, behavior, log_level, NULL);
+}
+
+/*
+ * Like ts_chunk_drop(), except that the chunk table (and the table of its
+ * compressed chunk, if any) is added to "objects" instead of being dropped
+ * immediately. The caller is responsible for dropping the collected objects
+ * with performMultipleDeletions().
+ */
+void
+ts_chunk_drop_collect(const Chunk *chunk, int32 log_level, ObjectAddresses *objects)
+{
+	Assert(objects != NULL);
+	chunk_drop_internal(chunk, DROP_RESTRICT, log_level, objects);
 }
 
 static void
@@ -3903,7 +4144,7 @@ lock_referenced_tables(Oid table_relid)
 
 List *
 ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int32 log_level,
-						Oid time_type, Oid arg_type, bool older_newer)
+						Oid time_type, Oid arg_type, bool older_newer, int32 max_chunks)
 
 {
 	uint64 num_chunks = 0;
@@ -4002,6 +4243,14 @@ ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int3
 
 	DEBUG_WAITPOINT("drop_chunks_chunks_found");
 
+	/* Cap the number of chunks dropped in this call when requested. The
+	 * surplus chunks are left for a later call, which allows a caller that
+	 * controls transactions, like the retention policy, to drop a large set
+	 * of chunks in small batches without holding the exclusive locks of the
+	 * whole set at once. */
+	if (max_chunks > 0 && num_chunks > (uint64) max_chunks)
+		num_chunks = max_chunks;
+
 	int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
 	if (has_continuous_aggs)
 	{
@@ -4045,6 +4294,8 @@ ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int3
 	}
 
 	List *dropped_chunk_names = NIL;
+	ObjectAddresses *dropped_objects = new_object_addresses();
+
 	for (uint64 i = 0; i < num_chunks; i++)
 	{
 		char *chunk_name;
@@ -4066,8 +4317,17 @@ ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than, int3
 		chunk_name = psprintf("%s.%s", schema_name, table_name);
 		dropped_chunk_names = lappend(dropped_chunk_names, chunk_name);
 
-		ts_chunk_drop(chunks + i, DROP_RESTRICT, log_level);
+		ts_chunk_drop_collect(chunks + i, log_level, dropped_objects);
 	}
+
+	/*
+	 * Drop all chunk tables in one go rather than once per chunk. For the
+	 * large chunk batches a retention policy produces, this performs the
+	 * dependency traversal and catalog deletions for the whole batch at
+	 * once, which is considerably cheaper than repeating it per chunk.
+	 */
+	performMultipleDeletions(dropped_objects, DROP_RESTRICT, 0);
+	free_object_addresses(dropped_objects);
 	// if we have tiered chunks cascade drop to tiering layer as well
 	if (osm_chunk_id != INVALID_CHUNK_ID)
 	{
@@ -4371,7 +4631,8 @@ ts_chunk_drop_chunks(PG_FUNCTION_ARGS)
 										  elevel,
 										  time_type,
 										  arg_type,
-										  older_newer);
+										  older_newer,
+										  0 /* max_chunks */);
 	}
 	PG_CATCH();
 	{
@@ -4610,6 +4871,78 @@ ts_chunk_create(PG_FUNCTION_ARGS)
 	return ts_cm_functions->create_chunk(fcinfo);
 }
 
+TS_FUNCTION_INFO_V1(ts_chunk_precreate);
+
+/*
+ * Pre-create the chunk covering the given time value.
+ *
+ * Chunks are normally created lazily by the first insert that falls outside
+ * the boundaries of the existing chunks, which causes a latency spike for
+ * that insert and lock contention when many backends cross an interval
+ * boundary at the same time. Calling this function ahead of time, e.g., from
+ * a scheduled job with a time value slightly in the future, makes the
+ * boundary crossing a chunk cache hit in the insert path instead.
+ *
+ * The chunk is created with constraints and indexes through the regular
+ * chunk creation path. If a chunk covering the time value already exists,
+ * the function does nothing. Returns the relid of the covering chunk.
+ */
+Datum
+ts_chunk_precreate(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_ARGISNULL(0) ? InvalidOid : PG_GETARG_OID(0);
+	Cache *hcache;
+	Hypertable *ht;
+	const Dimension *dim;
+	Oid time_type;
+	Oid arg_type;
+	int64 time_value;
+	Chunk *chunk;
+	Oid chunk_relid;
+
+	TS_PREVENT_FUNC_IF_READ_ONLY();
+
+	if (PG_ARGISNULL(0) || PG_ARGISNULL(1))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("hypertable and time value arguments are required")));
+
+	ht = ts_hypertable_cache_get_cache_and_entry(relid, CACHE_FLAG_NONE, &hcache);
+	ts_hypertable_permissions_check(relid, GetUserId());
+
+	/*
+	 * A point in a multi-dimensional hypertable needs a coordinate for every
+	 * dimension, but there is no way to know which space partitions will see
+	 * writes, so pre-creation is limited to hypertables with only a time
+	 * dimension.
+	 */
+	if (ht->fd.num_dimensions > 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("cannot pre-create chunks in multi-dimensional hypertable")));
+
+	dim = hyperspace_get_open_dimension(ht->space, 0);
+	Ensure(dim, "no open dimension for hypertable");
+	time_type = ts_dimension_get_partition_type(dim);
+	arg_type = get_fn_expr_argtype(fcinfo->flinfo, 1);
+	time_value = ts_time_value_from_arg(PG_GETARG_DATUM(1), arg_type, time_type, true);
+
+	Point *p = palloc0(POINT_SIZE(1));
+	p->cardinality = 1;
+	p->num_coords = 1;
+	p->coordinates[0] = REMAP_LAST_COORDINATE(time_value);
+
+	chunk = ts_hypertable_find_chunk_for_point(ht, p, NoLock);
+
+	if (NULL == chunk)
+		chunk = ts_hypertable_create_chunk_for_point(ht, p, AccessShareLock);
+
+	chunk_relid = chunk->table_id;
+	ts_cache_release(&hcache);
+
+	PG_RETURN_OID(chunk_relid);
+}
+
 /**
  * Get the chunk status.
  *
@@ -4730,6 +5063,23 @@ ts_chunk_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id)
 								   Int32GetDatum(chunk_id));
 }
 
+/*
+ * Scan for multiple chunk ids with a single index scan. The matching chunk
+ * tuples are returned in ascending chunk id order, not in the order of the
+ * array elements.
+ */
+void
+ts_chunk_scan_iterator_set_chunk_ids(ScanIterator *it, Datum chunk_id_array)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(), CHUNK, CHUNK_ID_INDEX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_array_init(it,
+										 Anum_chunk_idx_id,
+										 BTEqualStrategyNumber,
+										 F_INT4EQ,
+										 chunk_id_array);
+}
+
 /*
  * Create a hypercube for the OSM chunk
  * The initial range for the OSM chunk will be from INT64_MAX - 1 to INT64_MAX.
@@ -5395,7 +5745,7 @@ ts_chunk_detach_by_relid(Oid relid)
 	table = get_rel_name(relid);
 
 	init_scan_by_qualified_table_name(&iterator, schema, table);
-	count = chunk_delete(&iterator, relid, DROP_RESTRICT, true);
+	count = chunk_delete(&iterator, relid, DROP_RESTRICT, true, NULL);
 
 	/*
 	 * (schema,table) names and (hypertable_id) are unique so should only have
@@ -8,6 +8,7 @@
 #include <postgres.h>
 #include <access/htup.h>
 #include <access/tupdesc.h>
+#include <catalog/dependency.h>
 #include <foreign/foreign.h>
 #include <utils/hsearch.h>
 
@@ -213,9 +214,11 @@ extern TSDLLEXPORT bool ts_chunk_is_frozen(const Chunk *chunk);
 extern TSDLLEXPORT bool ts_chunk_set_compressed_chunk(Chunk *chunk, int32 compressed_chunk_id);
 extern TSDLLEXPORT bool ts_chunk_clear_compressed_chunk(Chunk *chunk);
 extern TSDLLEXPORT void ts_chunk_drop(const Chunk *chunk, DropBehavior behavior, int32 log_level);
+extern TSDLLEXPORT void ts_chunk_drop_collect(const Chunk *chunk, int32 log_level,
+											  ObjectAddresses *objects);
 extern TSDLLEXPORT List *ts_chunk_do_drop_chunks(Hypertable *ht, int64 older_than, int64 newer_than,
 												 int32 log_level, Oid time_type, Oid arg_type,
-												 bool older_newer);
+												 bool older_newer, int32 max_chunks);
 extern TSDLLEXPORT Chunk *
 ts_chunk_find_or_create_without_cuts(const Hypertable *ht, Hypercube *hc, const char *schema_name,
 									 const char *table_name, Oid chunk_table_relid, bool *created);
@@ -247,6 +250,7 @@ extern TM_Result ts_chunk_lock_for_creating_compressed_chunk(int32 chunk_id,
 															 int32 *compressed_chunk_id);
 extern ScanIterator ts_chunk_scan_iterator_create(MemoryContext result_mcxt);
 extern void ts_chunk_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id);
+extern void ts_chunk_scan_iterator_set_chunk_ids(ScanIterator *it, Datum chunk_id_array);
 extern bool ts_chunk_lock_if_exists(Oid chunk_oid, LOCKMODE chunk_lockmode);
 int ts_chunk_get_osm_chunk_id(int hypertable_id);
 extern TSDLLEXPORT void ts_chunk_merge_on_dimension(const Hypertable *ht, Chunk *chunk,
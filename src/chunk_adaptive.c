@@ -26,6 +26,7 @@
 #include "errors.h"
 #include "hypercube.h"
 #include "hypertable_cache.h"
+#include "ts_catalog/compression_chunk_size.h"
 #include "utils.h"
 
 #define DEFAULT_CHUNK_SIZING_FN_NAME "calculate_chunk_interval"
@@ -480,6 +481,9 @@ ts_calculate_chunk_interval(PG_FUNCTION_ARGS)
 		int64 chunk_size, slice_interval;
 		Datum minmax[2];
 		AttrNumber attno = ts_map_attno(ht->main_table_relid, chunk->table_id, dim->column_attno);
+		FormData_compression_chunk_size ccs;
+		double interval_fillfactor = 0.0;
+		bool have_fillfactor = false;
 
 		Assert(NULL != slice);
 
@@ -488,22 +492,51 @@ ts_calculate_chunk_interval(PG_FUNCTION_ARGS)
 
 		slice_interval = slice->fd.range_end - slice->fd.range_start;
 
-		if (chunk_get_minmax(chunk->table_id,
-							 dim->fd.column_type,
-							 attno,
-							 "adaptive chunking",
-							 minmax))
+		if (chunk->fd.compressed_chunk_id != INVALID_CHUNK_ID &&
+			ts_compression_chunk_size_get(chunk->fd.id, &ccs))
+		{
+			/*
+			 * For a compressed chunk, the relation size only accounts for
+			 * data that is not compressed, so the chunk would look nearly
+			 * empty. Add the pre-compression size of the compressed part
+			 * from the compression size stats. The pre-compression size is
+			 * the right feedback signal since the target size reflects the
+			 * memory footprint of the data and its indexes when the chunk is
+			 * actively written and queried, which is before compression.
+			 */
+			chunk_size += ccs.uncompressed_heap_size + ccs.uncompressed_toast_size +
+						  ccs.uncompressed_index_size;
+
+			/*
+			 * Chunks are compressed after writes to their time range have
+			 * stopped, so assume the data spans the whole slice interval
+			 * instead of scanning for min/max values, which would only see
+			 * the uncompressed part.
+			 */
+			interval_fillfactor = 1.0;
+			have_fillfactor = true;
+		}
+		else if (chunk_get_minmax(chunk->table_id,
+								  dim->fd.column_type,
+								  attno,
+								  "adaptive chunking",
+								  minmax))
 		{
 			int64 min = ts_time_value_to_internal(minmax[0], dim->fd.column_type);
 			int64 max = ts_time_value_to_internal(minmax[1], dim->fd.column_type);
-			double interval_fillfactor, size_fillfactor;
-			int64 extrapolated_chunk_size;
 
 			/*
 			 * The fillfactor of the slice interval that the data actually
 			 * spans
 			 */
 			interval_fillfactor = ((double) max - min) / slice_interval;
+			have_fillfactor = true;
+		}
+
+		if (have_fillfactor)
+		{
+			double size_fillfactor;
+			int64 extrapolated_chunk_size;
 
 			/*
 			 * Extrapolate the size the chunk would have if it spanned the
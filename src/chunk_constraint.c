@@ -184,6 +184,9 @@ chunk_constraint_insert_relation(const Relation rel, const ChunkConstraint *cc)
 
 /*
  * Insert multiple chunk constraints into the metadata catalog.
+ *
+ * All rows are written with a single multi-insert so that the catalog
+ * indexes are only updated once per chunk rather than once per constraint.
  */
 void
 ts_chunk_constraints_insert_metadata(const ChunkConstraints *ccs)
@@ -191,16 +194,33 @@ ts_chunk_constraints_insert_metadata(const ChunkConstraints *ccs)
 	Catalog *catalog = ts_catalog_get();
 	CatalogSecurityContext sec_ctx;
 	Relation rel;
+	HeapTuple *tuples;
 	int i;
 
+	if (ccs->num_constraints == 0)
+		return;
+
 	rel = table_open(catalog_get_table_id(catalog, CHUNK_CONSTRAINT), RowExclusiveLock);
 
-	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+	tuples = palloc(sizeof(HeapTuple) * ccs->num_constraints);
 
 	for (i = 0; i < ccs->num_constraints; i++)
-		chunk_constraint_insert_relation(rel, &ccs->constraints[i]);
+	{
+		Datum values[Natts_chunk_constraint];
+		bool nulls[Natts_chunk_constraint] = { false };
+
+		chunk_constraint_fill_tuple_values(&ccs->constraints[i], values, nulls);
+		tuples[i] = heap_form_tuple(RelationGetDescr(rel), values, nulls);
+	}
 
+	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+	ts_catalog_multi_insert(rel, ccs->num_constraints, tuples);
 	ts_catalog_restore_user(&sec_ctx);
+
+	for (i = 0; i < ccs->num_constraints; i++)
+		heap_freetuple(tuples[i]);
+
+	pfree(tuples);
 	table_close(rel, RowExclusiveLock);
 }
 
@@ -225,17 +245,15 @@ ts_chunk_constraint_insert(ChunkConstraint *constraint)
 ChunkConstraint *
 ts_chunk_constraints_add_from_tuple(ChunkConstraints *ccs, const TupleInfo *ti)
 {
-	bool nulls[Natts_chunk_constraint];
-	Datum values[Natts_chunk_constraint];
+	Datum *values;
+	bool *nulls;
 	ChunkConstraint *constraints;
 	int32 dimension_slice_id;
 	Name constraint_name;
 	Name hypertable_constraint_name;
-	bool should_free;
-	HeapTuple tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
 	MemoryContext oldcxt;
 
-	heap_deform_tuple(tuple, ts_scanner_get_tupledesc(ti), values, nulls);
+	ts_scanner_deform_tuple(ti, Natts_chunk_constraint, &values, &nulls);
 
 	oldcxt = MemoryContextSwitchTo(ccs->mctx);
 
@@ -264,9 +282,6 @@ ts_chunk_constraints_add_from_tuple(ChunkConstraints *ccs, const TupleInfo *ti)
 
 	MemoryContextSwitchTo(oldcxt);
 
-	if (should_free)
-		heap_freetuple(tuple);
-
 	return constraints;
 }
 
@@ -545,6 +560,26 @@ ts_chunk_constraint_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id)
 								   Int32GetDatum(chunk_id));
 }
 
+/*
+ * Scan the constraints of multiple chunks with a single index scan. The
+ * tuples are returned ordered by (chunk id, constraint name), so the
+ * constraints of one chunk arrive consecutively and in the same order as a
+ * per-chunk scan would return them.
+ */
+void
+ts_chunk_constraint_scan_iterator_set_chunk_ids(ScanIterator *it, Datum chunk_id_array)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(),
+									  CHUNK_CONSTRAINT,
+									  CHUNK_CONSTRAINT_CHUNK_ID_CONSTRAINT_NAME_IDX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_array_init(it,
+										 Anum_chunk_constraint_chunk_id_constraint_name_idx_chunk_id,
+										 BTEqualStrategyNumber,
+										 F_INT4EQ,
+										 chunk_id_array);
+}
+
 static void
 init_scan_by_chunk_id_constraint_name(ScanIterator *iterator, int32 chunk_id,
 									  const char *constraint_name)
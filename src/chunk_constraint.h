@@ -91,6 +91,8 @@ extern ChunkConstraint *ts_chunk_constraints_add_from_tuple(ChunkConstraints *cc
 extern ScanIterator ts_chunk_constraint_scan_iterator_create(MemoryContext result_mcxt);
 extern void ts_chunk_constraint_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id);
 extern void ts_chunk_constraint_scan_iterator_set_chunk_id(ScanIterator *it, int32 chunk_id);
+extern void ts_chunk_constraint_scan_iterator_set_chunk_ids(ScanIterator *it,
+															Datum chunk_id_array);
 extern int ts_chunk_constraint_delete_dimensional_constraints(int32 chunk_id,
 															  ChunkConstraints *ccs);
 extern TSDLLEXPORT void ts_chunk_constraint_drop_from_tuple(HeapTuple constraint_tuple);
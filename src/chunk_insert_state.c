@@ -30,6 +30,7 @@
 #include "chunk_tuple_routing.h"
 #include "debug_point.h"
 #include "errors.h"
+#include "hypercube.h"
 #include "indexing.h"
 #include "nodes/modify_hypertable.h"
 #include "ts_catalog/continuous_agg.h"
@@ -403,16 +404,29 @@ adjust_projections(ResultRelInfo *ht_rri, ModifyTableState *mtstate, ChunkInsert
  * ResultRelInfo should be similar to ExecInitModifyTable().
  */
 extern ChunkInsertState *
-ts_chunk_insert_state_create(Oid chunk_relid, const ChunkTupleRouting *ctr)
+ts_chunk_insert_state_create(Oid chunk_relid, ChunkTupleRouting *ctr)
 {
 	ChunkInsertState *state;
 	Relation rel, parent_rel;
-	MemoryContext cis_context = AllocSetContextCreate(ctr->estate->es_query_cxt,
-													  "chunk insert state memory context",
-													  ALLOCSET_DEFAULT_SIZES);
+	MemoryContext cis_context;
 	ResultRelInfo *relinfo;
 	const Chunk *chunk;
 
+	/*
+	 * Reuse the arena of the last destroyed chunk insert state, if any. This
+	 * avoids memory context churn when inserts keep switching between more
+	 * chunks than the routing cache can hold.
+	 */
+	if (ctr->spare_cis_mctx != NULL)
+	{
+		cis_context = ctr->spare_cis_mctx;
+		ctr->spare_cis_mctx = NULL;
+	}
+	else
+		cis_context = AllocSetContextCreate(ctr->estate->es_query_cxt,
+											"chunk insert state memory context",
+											ALLOCSET_DEFAULT_SIZES);
+
 	MemoryContext old_mcxt =
 		MemoryContextSwitchTo(ctr->estate->es_per_tuple_exprcontext->ecxt_per_tuple_memory);
 	/*
@@ -451,6 +465,7 @@ ts_chunk_insert_state_create(Oid chunk_relid, const ChunkTupleRouting *ctr)
 	if (ctr->mht_state)
 		state->onConflictAction = ctr->mht_state->mt->onConflictAction;
 	state->mctx = cis_context;
+	state->ctr = ctr;
 	state->rel = rel;
 	state->result_relation_info = relinfo;
 	state->estate = ctr->estate;
@@ -509,6 +524,7 @@ ts_chunk_insert_state_create(Oid chunk_relid, const ChunkTupleRouting *ctr)
 
 	state->hypertable_relid = chunk->hypertable_relid;
 	state->chunk_id = chunk->fd.id;
+	state->cube = ts_hypercube_copy(chunk->cube);
 
 	MemoryContextSwitchTo(old_mcxt);
 
@@ -558,9 +574,29 @@ ts_chunk_insert_state_destroy(ChunkInsertState *state, bool single_chunk_insert)
 	if (NULL != state->hyper_to_chunk_map && NULL != state->conflproj_slot)
 		ExecDropSingleTupleTableSlot(state->conflproj_slot);
 
+	/* Make sure the tuple routing fast path no longer hands out this state */
+	if (state->ctr != NULL && state->ctr->last_cis == state)
+		state->ctr->last_cis = NULL;
+
 	if (!single_chunk_insert)
 	{
+		MemoryContext mctx = state->mctx;
+		ChunkTupleRouting *ctr = state->ctr;
+
 		ExecCloseIndices(state->result_relation_info);
-		MemoryContextDelete(state->mctx);
+
+		/*
+		 * Keep the memory context around as the arena for the next chunk
+		 * insert state, so that cache evictions don't pay for context
+		 * creation and malloc'ed blocks over and over. Note that the state
+		 * itself is allocated in this context, so it is gone after the reset.
+		 */
+		if (ctr != NULL && ctr->spare_cis_mctx == NULL)
+		{
+			MemoryContextReset(mctx);
+			ctr->spare_cis_mctx = mctx;
+		}
+		else
+			MemoryContextDelete(mctx);
 	}
 }
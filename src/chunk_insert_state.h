@@ -15,6 +15,7 @@
 typedef struct ChunkTupleRouting ChunkTupleRouting;
 typedef struct CompressionSettings CompressionSettings;
 typedef struct tuple_filtering_constraints tuple_filtering_constraints;
+typedef struct InsertBloomProbes InsertBloomProbes;
 
 /*
  * Bundle the ScanKey and the attribute numbers together
@@ -45,7 +46,24 @@ typedef struct CachedDecompressionState
 	ScanKeyWithAttnos heap_scankeys;
 	ScanKeyWithAttnos index_scankeys;
 	ScanKeyWithAttnos mem_scankeys;
+	/* Bloom filter probes over the unique key columns that have a bloom1
+	 * sparse index on the compressed chunk, used to skip decompression of
+	 * batches that cannot contain a conflicting tuple. */
+	InsertBloomProbes *bloom_probes;
 	Oid index_relid;
+	/* Cache of the unique key values of the last tuple that completed a
+	 * conflict probe. Upsert-heavy workloads often send long runs of tuples
+	 * with identical key values; since the first probe already decompressed
+	 * every batch that could conflict with that key, the scan can be skipped
+	 * for the rest of the run. */
+	int num_key_attnos;
+	AttrNumber *key_attnos;
+	int16 *key_attlens;
+	bool *key_attbyvals;
+	Datum *last_key_values;
+	bool *last_key_isnulls;
+	bool last_key_valid;
+	MemoryContext last_key_mctx;
 } CachedDecompressionState;
 
 typedef struct SharedCounters
@@ -88,8 +106,14 @@ typedef struct ChunkInsertState
 	TupleConversionMap *hyper_to_chunk_map;
 	MemoryContext mctx;
 	EState *estate;
+	/* The tuple routing this state belongs to. Used to recycle the memory
+	 * context when the state is evicted from the routing cache. */
+	ChunkTupleRouting *ctr;
 	Oid hypertable_relid;
 	int32 chunk_id;
+	/* The chunk's hypercube, used for the same-chunk fast path in tuple
+	 * routing. Allocated in the state's memory context. */
+	Hypercube *cube;
 	Oid user_id;
 
 	/* for tracking compressed chunks */
@@ -110,8 +134,7 @@ typedef struct ChunkInsertState
 	bool skip_generated_column_computations;
 } ChunkInsertState;
 
-extern ChunkInsertState *ts_chunk_insert_state_create(Oid chunk_relid,
-													  const ChunkTupleRouting *ctr);
+extern ChunkInsertState *ts_chunk_insert_state_create(Oid chunk_relid, ChunkTupleRouting *ctr);
 extern void ts_chunk_insert_state_destroy(ChunkInsertState *state, bool single_chunk_insert);
 ResultRelInfo *create_chunk_result_relation_info(ResultRelInfo *ht_rri, Relation rel,
 												 EState *estate);
@@ -5,7 +5,9 @@
  */
 #include <postgres.h>
 #include <catalog/namespace.h>
+#include <catalog/pg_type.h>
 #include <storage/lmgr.h>
+#include <utils/array.h>
 #include <utils/builtins.h>
 #include <utils/syscache.h>
 
@@ -20,6 +22,88 @@
 #include "scan_iterator.h"
 #include "utils.h"
 
+/*
+ * An entry for one chunk id the caller asked for, sorted by chunk id so that
+ * tuples streamed by the batched index scans can be matched back to their
+ * chunk with a binary search.
+ */
+typedef struct ChunkScanEntry
+{
+	int32 chunk_id;
+	Oid reloid;
+	Chunk *chunk;
+} ChunkScanEntry;
+
+static int
+chunk_scan_entry_cmp(const void *key, const void *entry)
+{
+	int32 chunk_id = *(const int32 *) key;
+	const ChunkScanEntry *scan_entry = (const ChunkScanEntry *) entry;
+
+	if (chunk_id < scan_entry->chunk_id)
+		return -1;
+	if (chunk_id > scan_entry->chunk_id)
+		return 1;
+	return 0;
+}
+
+static ChunkScanEntry *
+chunk_scan_entry_find(ChunkScanEntry *entries, int num_entries, int32 chunk_id)
+{
+	return bsearch(&chunk_id, entries, num_entries, sizeof(ChunkScanEntry), chunk_scan_entry_cmp);
+}
+
+static int
+slice_id_cmp(const void *left, const void *right)
+{
+	int32 lid = *(const int32 *) left;
+	int32 rid = *(const int32 *) right;
+
+	if (lid < rid)
+		return -1;
+	if (lid > rid)
+		return 1;
+	return 0;
+}
+
+static int
+slice_ptr_cmp(const void *key, const void *element)
+{
+	int32 slice_id = *(const int32 *) key;
+	const DimensionSlice *slice = *(DimensionSlice *const *) element;
+
+	if (slice_id < slice->fd.id)
+		return -1;
+	if (slice_id > slice->fd.id)
+		return 1;
+	return 0;
+}
+
+static DimensionSlice *
+slice_find(DimensionSlice **slices, int num_slices, int32 slice_id)
+{
+	DimensionSlice **found =
+		bsearch(&slice_id, slices, num_slices, sizeof(DimensionSlice *), slice_ptr_cmp);
+
+	return found ? *found : NULL;
+}
+
+/*
+ * Build an int4 array Datum from the chunk ids of the given entries, for use
+ * with the batched scan iterators.
+ */
+static Datum
+chunk_scan_entry_id_array(const ChunkScanEntry *entries, int num_entries)
+{
+	Datum *id_datums = palloc(sizeof(Datum) * num_entries);
+
+	for (int i = 0; i < num_entries; i++)
+		id_datums[i] = Int32GetDatum(entries[i].chunk_id);
+
+	return PointerGetDatum(
+		construct_array(id_datums, num_entries, INT4OID, sizeof(int32), true, TYPALIGN_INT));
+}
+
 /*
  * Scan for chunks matching a query.
  *
@@ -35,7 +119,9 @@
  *
  * For performance, try not to interleave scans of different metadata tables
  * in order to maintain data locality while scanning. Also, keep scanned
- * tables and indexes open until all the metadata is scanned for all chunks.
+ * tables and indexes open until all the metadata is scanned for all chunks,
+ * and batch the lookups for all chunk ids into a single index scan per
+ * metadata table instead of one index descent per chunk.
  */
 Chunk **
 ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned int *num_chunks)
@@ -44,84 +130,152 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 		AllocSetContextCreate(CurrentMemoryContext, "chunk-scan-work", ALLOCSET_DEFAULT_SIZES);
 	Chunk **locked_chunks = NULL;
 	int locked_chunk_count = 0;
+	int num_entries = 0;
 	ListCell *lc;
 
 	Assert(OidIsValid(hs->main_table_relid));
 	MemoryContext orig_mcxt = MemoryContextSwitchTo(work_mcxt);
 
+	if (list_length(chunk_ids) == 0)
+	{
+		MemoryContextSwitchTo(orig_mcxt);
+		MemoryContextDelete(work_mcxt);
+		*num_chunks = 0;
+		return NULL;
+	}
+
 	/*
-	 * For each matching chunk, fill in the metadata from the "chunk" table.
-	 * Make sure to filter out "dropped" chunks.
+	 * Look up the relation names for all requested chunk ids with one batched
+	 * scan over the "chunk" table. The scan streams the tuples in ascending
+	 * chunk id order, so the entries array ends up sorted for binary search.
 	 */
-	ScanIterator chunk_it = ts_chunk_scan_iterator_create(orig_mcxt);
-	locked_chunks =
-		(Chunk **) MemoryContextAlloc(orig_mcxt, sizeof(Chunk *) * list_length(chunk_ids));
-	foreach (lc, chunk_ids)
+	Datum requested_ids;
 	{
-		int chunk_id = lfirst_int(lc);
-
-		Assert(CurrentMemoryContext == work_mcxt);
+		ChunkScanEntry *requested = palloc(sizeof(ChunkScanEntry) * list_length(chunk_ids));
+		int n = 0;
 
-		ts_chunk_scan_iterator_set_chunk_id(&chunk_it, chunk_id);
-		ts_scan_iterator_start_or_restart_scan(&chunk_it);
-		TupleInfo *ti = ts_scan_iterator_next(&chunk_it);
-		if (ti == NULL)
+		foreach (lc, chunk_ids)
 		{
-			continue;
+			requested[n].chunk_id = lfirst_int(lc);
+			n++;
 		}
+		requested_ids = chunk_scan_entry_id_array(requested, n);
+	}
+
+	ChunkScanEntry *entries = palloc(sizeof(ChunkScanEntry) * list_length(chunk_ids));
+	ScanIterator chunk_it = ts_chunk_scan_iterator_create(orig_mcxt);
+	ts_chunk_scan_iterator_set_chunk_ids(&chunk_it, requested_ids);
+	ts_scan_iterator_start_or_restart_scan(&chunk_it);
+	while (ts_scan_iterator_next(&chunk_it) != NULL)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&chunk_it);
 		bool isnull;
 
-		/* We found a chunk. First, try to lock it. */
 		Name schema_name = DatumGetName(slot_getattr(ti->slot, Anum_chunk_schema_name, &isnull));
 		Assert(!isnull);
 		Name table_name = DatumGetName(slot_getattr(ti->slot, Anum_chunk_table_name, &isnull));
 		Assert(!isnull);
 
-		Oid chunk_reloid = ts_get_relation_relid(NameStr(*schema_name),
-												 NameStr(*table_name),
-												 /* return_invalid = */ false);
-		Assert(OidIsValid(chunk_reloid));
+		ChunkScanEntry *entry = &entries[num_entries++];
+		entry->chunk_id = DatumGetInt32(slot_getattr(ti->slot, Anum_chunk_id, &isnull));
+		Assert(!isnull);
+		entry->reloid = ts_get_relation_relid(NameStr(*schema_name),
+											  NameStr(*table_name),
+											  /* return_invalid = */ false);
+		Assert(OidIsValid(entry->reloid));
+		entry->chunk = NULL;
+
+		/* The index scan returns the chunk ids in ascending order */
+		Assert(num_entries < 2 || entries[num_entries - 2].chunk_id < entry->chunk_id);
+	}
+
+	/*
+	 * Lock the chunks in the order the caller requested them, which also
+	 * determines the order of the result. Chunks that have disappeared since
+	 * the lookup above are silently skipped, like a concurrently dropped
+	 * chunk would be.
+	 */
+	locked_chunks =
+		(Chunk **) MemoryContextAlloc(orig_mcxt, sizeof(Chunk *) * list_length(chunk_ids));
+	foreach (lc, chunk_ids)
+	{
+		ChunkScanEntry *entry = chunk_scan_entry_find(entries, num_entries, lfirst_int(lc));
 
-		/* Only one chunk should match */
-		Assert(ts_scan_iterator_next(&chunk_it) == NULL);
+		Assert(CurrentMemoryContext == work_mcxt);
+
+		if (entry == NULL)
+		{
+			continue;
+		}
+
+		/* The caller should not request the same chunk twice */
+		Assert(entry->chunk == NULL);
 
 		DEBUG_WAITPOINT("hypertable_expansion_before_lock_chunk");
-		if (!ts_chunk_lock_if_exists(chunk_reloid, AccessShareLock))
+		if (!ts_chunk_lock_if_exists(entry->reloid, AccessShareLock))
 		{
 			continue;
 		}
 
-		/*
-		 * Now after we have locked the chunk, we have to reread its metadata.
-		 * It might have been modified concurrently by decompression, for
-		 * example.
-		 */
-		ts_chunk_scan_iterator_set_chunk_id(&chunk_it, chunk_id);
-		ts_scan_iterator_start_or_restart_scan(&chunk_it);
-		ti = ts_scan_iterator_next(&chunk_it);
-		Assert(ti != NULL);
 		Chunk *chunk = MemoryContextAllocZero(orig_mcxt, sizeof(Chunk));
 
-		ts_chunk_formdata_fill(&chunk->fd, ti);
-
 		chunk->constraints = NULL;
 		chunk->cube = NULL;
 		chunk->hypertable_relid = hs->main_table_relid;
-		chunk->table_id = chunk_reloid;
+		chunk->table_id = entry->reloid;
 
+		entry->chunk = chunk;
 		locked_chunks[locked_chunk_count] = chunk;
 		locked_chunk_count++;
-
-		/* Only one chunk should match */
-		Assert(ts_scan_iterator_next(&chunk_it) == NULL);
 	}
 
-	ts_scan_iterator_close(&chunk_it);
-
 	Assert(locked_chunk_count == 0 || locked_chunks != NULL);
 	Assert(locked_chunk_count <= list_length(chunk_ids));
 	Assert(CurrentMemoryContext == work_mcxt);
 
+	/*
+	 * Now after we have locked the chunks, we have to read their metadata
+	 * again with another batched scan. It might have been modified
+	 * concurrently by decompression, for example, before we got the locks.
+	 * The metadata rows of locked chunks cannot go away since dropping a
+	 * chunk requires a conflicting relation lock.
+	 */
+	ChunkScanEntry *locked_entries = NULL;
+	Datum locked_ids = (Datum) 0;
+	if (locked_chunk_count > 0)
+	{
+		int num_locked_entries = 0;
+		int num_filled PG_USED_FOR_ASSERTS_ONLY = 0;
+
+		locked_entries = palloc(sizeof(ChunkScanEntry) * locked_chunk_count);
+		for (int i = 0; i < num_entries; i++)
+		{
+			if (entries[i].chunk != NULL)
+				locked_entries[num_locked_entries++] = entries[i];
+		}
+		Assert(num_locked_entries == locked_chunk_count);
+
+		locked_ids = chunk_scan_entry_id_array(locked_entries, num_locked_entries);
+		ts_chunk_scan_iterator_set_chunk_ids(&chunk_it, locked_ids);
+		ts_scan_iterator_start_or_restart_scan(&chunk_it);
+		while (ts_scan_iterator_next(&chunk_it) != NULL)
+		{
+			TupleInfo *ti = ts_scan_iterator_tuple_info(&chunk_it);
+			bool isnull;
+			int32 chunk_id = DatumGetInt32(slot_getattr(ti->slot, Anum_chunk_id, &isnull));
+			Assert(!isnull);
+			ChunkScanEntry *entry =
+				chunk_scan_entry_find(locked_entries, num_locked_entries, chunk_id);
+
+			Assert(entry != NULL && entry->chunk != NULL);
+			ts_chunk_formdata_fill(&entry->chunk->fd, ti);
+			num_filled++;
+		}
+		Assert(num_filled == locked_chunk_count);
+	}
+	ts_scan_iterator_close(&chunk_it);
+	Assert(CurrentMemoryContext == work_mcxt);
+
 	for (int i = 0; i < locked_chunk_count; i++)
 	{
 		Chunk *chunk = locked_chunks[i];
@@ -129,31 +283,114 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 	}
 
 	/*
-	 * Fetch the chunk constraints.
+	 * Fetch the chunk constraints, again with a single batched scan for all
+	 * locked chunks. The (chunk_id, constraint_name) index returns the
+	 * constraints of each chunk consecutively and in the same order as
+	 * per-chunk scans would.
 	 */
-	ScanIterator constr_it = ts_chunk_constraint_scan_iterator_create(orig_mcxt);
-
-	for (int i = 0; i < locked_chunk_count; i++)
+	if (locked_chunk_count > 0)
 	{
-		Chunk *chunk = locked_chunks[i];
-		chunk->constraints = ts_chunk_constraints_alloc(/* size_hint = */ 0, orig_mcxt);
+		for (int i = 0; i < locked_chunk_count; i++)
+		{
+			Chunk *chunk = locked_chunks[i];
+			chunk->constraints = ts_chunk_constraints_alloc(/* size_hint = */ 0, orig_mcxt);
+		}
 
-		ts_chunk_constraint_scan_iterator_set_chunk_id(&constr_it, chunk->fd.id);
+		ScanIterator constr_it = ts_chunk_constraint_scan_iterator_create(orig_mcxt);
+		ts_chunk_constraint_scan_iterator_set_chunk_ids(&constr_it, locked_ids);
 		ts_scan_iterator_start_or_restart_scan(&constr_it);
-
 		while (ts_scan_iterator_next(&constr_it) != NULL)
 		{
 			TupleInfo *constr_ti = ts_scan_iterator_tuple_info(&constr_it);
-			ts_chunk_constraints_add_from_tuple(chunk->constraints, constr_ti);
+			bool isnull;
+			int32 chunk_id =
+				DatumGetInt32(slot_getattr(constr_ti->slot, Anum_chunk_constraint_chunk_id, &isnull));
+			Assert(!isnull);
+			ChunkScanEntry *entry =
+				chunk_scan_entry_find(locked_entries, locked_chunk_count, chunk_id);
+
+			Assert(entry != NULL && entry->chunk != NULL);
+			ts_chunk_constraints_add_from_tuple(entry->chunk->constraints, constr_ti);
+		}
+		ts_scan_iterator_close(&constr_it);
+	}
+
+	/*
+	 * Read the dimension slices referenced by the dimensional chunk
+	 * constraints with a single batched scan instead of one index descent per
+	 * constraint. Chunks commonly share slices (always in space dimensions),
+	 * so the ids are deduplicated first. The scan streams the slices in
+	 * ascending slice id order, so the array ends up sorted for binary
+	 * search. Don't have to lock the slices because the chunks are locked.
+	 */
+	DimensionSlice **slices = NULL;
+	int num_slices = 0;
+	int num_slice_ids = 0;
+
+	for (int i = 0; i < locked_chunk_count; i++)
+		num_slice_ids += locked_chunks[i]->constraints->num_dimension_constraints;
+
+	if (num_slice_ids > 0)
+	{
+		int32 *slice_ids = palloc(sizeof(int32) * num_slice_ids);
+		int num_distinct = 0;
+		int n = 0;
+
+		for (int i = 0; i < locked_chunk_count; i++)
+		{
+			const ChunkConstraints *constraints = locked_chunks[i]->constraints;
+
+			for (int j = 0; j < constraints->num_constraints; j++)
+			{
+				const ChunkConstraint *cc = &constraints->constraints[j];
+
+				if (is_dimension_constraint(cc))
+					slice_ids[n++] = cc->fd.dimension_slice_id;
+			}
+		}
+		Assert(n == num_slice_ids);
+
+		qsort(slice_ids, num_slice_ids, sizeof(int32), slice_id_cmp);
+
+		for (int i = 0; i < num_slice_ids; i++)
+		{
+			if (num_distinct == 0 || slice_ids[num_distinct - 1] != slice_ids[i])
+				slice_ids[num_distinct++] = slice_ids[i];
+		}
+
+		Datum *slice_id_datums = palloc(sizeof(Datum) * num_distinct);
+
+		for (int i = 0; i < num_distinct; i++)
+			slice_id_datums[i] = Int32GetDatum(slice_ids[i]);
+
+		Datum slice_id_array = PointerGetDatum(construct_array(slice_id_datums,
+															   num_distinct,
+															   INT4OID,
+															   sizeof(int32),
+															   true,
+															   TYPALIGN_INT));
+
+		slices = palloc(sizeof(DimensionSlice *) * num_distinct);
+		ScanIterator slice_it = ts_dimension_slice_scan_iterator_create(NULL, work_mcxt);
+		ts_dimension_slice_scan_iterator_set_slice_ids(&slice_it, slice_id_array);
+		ts_scan_iterator_start_or_restart_scan(&slice_it);
+		while (ts_scan_iterator_next(&slice_it) != NULL)
+		{
+			TupleInfo *ti = ts_scan_iterator_tuple_info(&slice_it);
+			DimensionSlice *slice = ts_dimension_slice_from_tuple(ti);
+
+			/* The index scan returns the slices in ascending id order */
+			Assert(num_slices == 0 || slices[num_slices - 1]->fd.id < slice->fd.id);
+			Assert(num_slices < num_distinct);
+			slices[num_slices++] = slice;
 		}
+		ts_scan_iterator_close(&slice_it);
 	}
-	ts_scan_iterator_close(&constr_it);
 
 	/*
 	 * Build hypercubes for the chunks by finding and combining the dimension
 	 * slices that match the chunk constraints.
 	 */
-	ScanIterator slice_iterator = ts_dimension_slice_scan_iterator_create(NULL, orig_mcxt);
 	for (int chunk_index = 0; chunk_index < locked_chunk_count; chunk_index++)
 	{
 		Chunk *chunk = locked_chunks[chunk_index];
@@ -170,13 +407,8 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 				continue;
 			}
 
-			/*
-			 * Find the slice by id. Don't have to lock it because the chunk is
-			 * locked.
-			 */
 			const int slice_id = constraint->fd.dimension_slice_id;
-			DimensionSlice *slice_ptr =
-				ts_dimension_slice_scan_iterator_get_by_id(&slice_iterator, slice_id);
+			DimensionSlice *slice_ptr = slice_find(slices, num_slices, slice_id);
 			if (slice_ptr == NULL)
 			{
 				elog(ERROR, "dimension slice %d is not found", slice_id);
@@ -201,7 +433,6 @@ ts_chunk_scan_by_chunk_ids(const Hyperspace *hs, const List *chunk_ids, unsigned
 		ts_hypercube_slice_sort(cube);
 		chunk->cube = cube;
 	}
-	ts_scan_iterator_close(&slice_iterator);
 
 	Assert(CurrentMemoryContext == work_mcxt);
 	MemoryContextSwitchTo(orig_mcxt);
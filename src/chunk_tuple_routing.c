@@ -14,6 +14,7 @@
 #include "debug_point.h"
 #include "guc.h"
 #include "hypercube.h"
+#include "probes.h"
 #include "subspace_store.h"
 
 ChunkTupleRouting *
@@ -55,6 +56,10 @@ ts_chunk_tuple_routing_destroy(ChunkTupleRouting *ctr)
 {
 	ts_subspace_store_free(ctr->subspace);
 
+	/* Freeing the store above may have stashed a recycled arena. */
+	if (ctr->spare_cis_mctx != NULL)
+		MemoryContextDelete(ctr->spare_cis_mctx);
+
 	pfree(ctr);
 }
 
@@ -75,8 +80,26 @@ ts_chunk_tuple_routing_find_chunk(ChunkTupleRouting *ctr, Point *point)
 {
 	Chunk *chunk = NULL;
 	ChunkInsertState *cis = NULL;
+
+	/*
+	 * Fast path for runs of tuples that fall into the same chunk as the
+	 * previous tuple. Time-ordered ingest produces runs that are thousands of
+	 * tuples long, so this skips the subspace store lookup almost entirely.
+	 * The containment check costs two comparisons per dimension; the store is
+	 * consulted again only when a tuple crosses a chunk boundary.
+	 */
+	if (ctr->last_cis != NULL && ts_hypercube_contains_point(ctr->last_cis->cube, point))
+	{
+		TS_PROBE3(chunk_route, ctr->hypertable->fd.id, RelationGetRelid(ctr->last_cis->rel), 0);
+		return ctr->last_cis;
+	}
+
 	cis = ts_subspace_store_get(ctr->subspace, point);
 
+	/* How the chunk was found, for the chunk_route probe: 1 = subspace store
+	 * hit, 2 = found in the catalog, 3 = created. */
+	int route_path pg_attribute_unused() = 1;
+
 	/*
 	 * The chunk search functions may leak memory, so switch to a temporary
 	 * memory context.
@@ -204,6 +227,8 @@ ts_chunk_tuple_routing_find_chunk(ChunkTupleRouting *ctr, Point *point)
 			}
 		}
 
+		route_path = chunk_created ? 3 : 2;
+
 		cis = ts_chunk_insert_state_create(chunk->table_id, ctr);
 		cis->needs_partial = needs_partial;
 		ts_subspace_store_add(ctr->subspace,
@@ -217,6 +242,15 @@ ts_chunk_tuple_routing_find_chunk(ChunkTupleRouting *ctr, Point *point)
 
 	Assert(cis != NULL);
 
+	/*
+	 * Remember the insert state for the fast path above. This must happen
+	 * after the subspace store add, which may have evicted and destroyed the
+	 * previously remembered state.
+	 */
+	ctr->last_cis = cis;
+
+	TS_PROBE3(chunk_route, ctr->hypertable->fd.id, RelationGetRelid(cis->rel), route_path);
+
 	return cis;
 }
 
@@ -32,6 +32,20 @@ typedef struct ChunkTupleRouting
 	ModifyHypertableState *mht_state; /* state for the ModifyHypertable custom scan node */
 	ChunkInsertState *cis;
 
+	/*
+	 * Memory context recycled from the last evicted chunk insert state, to be
+	 * reused as the arena for the next one created.
+	 */
+	MemoryContext spare_cis_mctx;
+
+	/*
+	 * The insert state returned by the last routing lookup. Time-ordered
+	 * ingest produces long runs of tuples that fall into the same chunk, so
+	 * checking the last chunk's hypercube first skips the subspace store
+	 * lookup for all but the first tuple of a run.
+	 */
+	ChunkInsertState *last_cis;
+
 	SharedCounters *counters; /* shared counters for the current statement */
 } ChunkTupleRouting;
 
@@ -22,10 +22,12 @@
 
 #include <postgres.h>
 
+#include <access/genam.h>
 #include <access/heapam.h>
 #include <access/hio.h>
 #include <access/sysattr.h>
 #include <access/xact.h>
+#include <catalog/index.h>
 #include <catalog/pg_trigger_d.h>
 #include <commands/copy.h>
 #include <commands/copyfrom_internal.h>
@@ -49,6 +51,8 @@
 #include <utils/lsyscache.h>
 #include <utils/rel.h>
 #include <utils/rls.h>
+#include <utils/sortsupport.h>
+#include <utils/typcache.h>
 
 #include "compat/compat.h"
 #include "chunk_insert_state.h"
@@ -57,7 +61,10 @@
 #include "dimension.h"
 #include "hypertable.h"
 #include "indexing.h"
+#include "probes.h"
 #include "subspace_store.h"
+#include "ts_catalog/array_utils.h"
+#include "ts_catalog/compression_settings.h"
 
 /*
  * Represents the insert method to be used during COPY FROM.
@@ -82,13 +89,25 @@ typedef enum TSCopyInsertMethod
 #define MAX_BUFFERED_TUPLES 1000
 
 /*
- * Flush buffers if there are >= this many bytes, as counted by the input
- * size, of tuples stored.
+ * Initial per-buffer flush target. A buffer that fills its target between
+ * flushes has the target doubled up to MAX_BUFFERED_TUPLES, so chunks with a
+ * high arrival rate earn large multi-insert batches, while chunks that
+ * receive only an occasional row are flushed early and keep their memory
+ * footprint small.
  */
-#define MAX_BUFFERED_BYTES 65535
+#define INITIAL_BUFFERED_TUPLES (MAX_BUFFERED_TUPLES / 8)
 
 /* Trim the list of buffers back down to this number after flushing */
-#define MAX_PARTITION_BUFFERS 32
+#define MAX_PARTITION_BUFFERS 128
+
+/*
+ * Shared budget across all buffers. The per-buffer flush targets decide the
+ * batch sizes; the shared budget is the backstop that triggers the partial
+ * flush in TSCopyMultiInsertInfoFlush when many chunks buffer tuples at the
+ * same time. The byte budget counts the materialized tuple sizes.
+ */
+#define MAX_BUFFERED_TOTAL_TUPLES (MAX_BUFFERED_TUPLES * MAX_PARTITION_BUFFERS)
+#define MAX_BUFFERED_TOTAL_BYTES (8 * 1024 * 1024)
 
 /* Stores multi-insert data related to a single relation in CopyFrom. */
 typedef struct TSCopyMultiInsertBuffer
@@ -104,7 +123,11 @@ typedef struct TSCopyMultiInsertBuffer
 	TupleTableSlot *slots[MAX_BUFFERED_TUPLES]; /* Array to store tuples */
 	Point *point;								/* The point in space of this buffer */
 	BulkInsertState bistate;					/* BulkInsertState for this buffer */
+	int32 chunk_id;								/* The chunk this buffer belongs to */
 	int nused;									/* number of 'slots' containing tuples */
+	int nbytes;									/* memory used by the buffered tuples */
+	int flush_target;							/* adaptive number of tuples to
+												 * buffer before flushing */
 	uint64 linenos[MAX_BUFFERED_TUPLES];		/* Line # of tuple in copy
 												 * stream */
 
@@ -114,6 +137,20 @@ typedef struct TSCopyMultiInsertBuffer
 	RowCompressor *compressor; /* compressor for the chunk */
 	BulkWriter *bulk_writer;   /* BulkWriter for the compressed chunk */
 
+	/*
+	 * Segment-aware buffering for rowstore inserts into a compressed chunk.
+	 * Late-arriving rows land in the uncompressed part of the chunk, and
+	 * recompression later has to sort them by the compression settings'
+	 * segmentby+orderby keys. Sorting each flushed batch by those keys up
+	 * front clusters the rows per segment on disk, so the recompression sort
+	 * reads largely presorted runs and the segmentby indexes get the
+	 * consecutive-key insert pattern. Empty when the target chunk is not
+	 * compressed or when triggers require stream order.
+	 */
+	int num_sort_keys;
+	AttrNumber *sort_attnos;
+	SortSupportData *sort_keys;
+
 } TSCopyMultiInsertBuffer;
 
 /*
@@ -128,7 +165,7 @@ typedef struct TSCopyMultiInsertBuffer
  * When ts_chunk_dispatch_get_chunk_insert_state is called again for a closed
  * chunk, a new ChunkInsertState is returned.
  */
-typedef struct TSCopyMultiInsertInfo
+struct TSCopyMultiInsertInfo
 {
 	HTAB *multiInsertBuffers; /* Maps the chunk ids to the buffers (chunkid ->
 								 TSCopyMultiInsertBuffer) */
@@ -140,7 +177,8 @@ typedef struct TSCopyMultiInsertInfo
 	int ti_options;			  /* table insert options */
 	Hypertable *ht;			  /* The hypertable for the inserts */
 	bool has_continuous_aggregate;
-} TSCopyMultiInsertInfo;
+	int64 flushes; /* number of buffer flushes performed, for instrumentation */
+};
 
 /*
  * The entry of the multiInsertBuffers HTAB.
@@ -210,6 +248,77 @@ can_skip_constraint_check(Hypertable *ht, TupleDesc tupledesc)
 	return true;
 }
 
+/*
+ * Build the sort keys for segment-aware buffering from the chunk's
+ * compression settings: segmentby columns ascending first, then the orderby
+ * columns with their configured direction and NULLS FIRST/LAST placement.
+ * This mirrors the sort order used by recompression, so flushed batches form
+ * presorted runs for a later recompress of the chunk.
+ */
+static void
+TSCopyMultiInsertBufferSetupSortKeys(TSCopyMultiInsertBuffer *buffer, ChunkInsertState *cis)
+{
+	CompressionSettings *settings = ts_compression_settings_get(RelationGetRelid(cis->rel));
+
+	if (settings == NULL)
+		return;
+
+	int num_segmentby = ts_array_length(settings->fd.segmentby);
+	int num_orderby = ts_array_length(settings->fd.orderby);
+	int n_keys = num_segmentby + num_orderby;
+
+	if (n_keys == 0)
+		return;
+
+	TupleDesc tupdesc = RelationGetDescr(cis->rel);
+	AttrNumber *attnos = palloc(sizeof(AttrNumber) * n_keys);
+	SortSupportData *keys = palloc0(sizeof(SortSupportData) * n_keys);
+
+	for (int n = 0; n < n_keys; n++)
+	{
+		const char *attname;
+		bool nulls_first;
+		bool descending;
+
+		if (n < num_segmentby)
+		{
+			attname = ts_array_get_element_text(settings->fd.segmentby, n + 1);
+			nulls_first = false;
+			descending = false;
+		}
+		else
+		{
+			int position = n - num_segmentby + 1;
+			attname = ts_array_get_element_text(settings->fd.orderby, position);
+			nulls_first = ts_array_get_element_bool(settings->fd.orderby_nullsfirst, position);
+			descending = ts_array_get_element_bool(settings->fd.orderby_desc, position);
+		}
+
+		AttrNumber attno = get_attnum(RelationGetRelid(cis->rel), attname);
+		if (attno == InvalidAttrNumber)
+			return;
+
+		Form_pg_attribute att = TupleDescAttr(tupdesc, AttrNumberGetAttrOffset(attno));
+		TypeCacheEntry *tentry =
+			lookup_type_cache(att->atttypid, TYPECACHE_LT_OPR | TYPECACHE_GT_OPR);
+		Oid sort_operator = descending ? tentry->gt_opr : tentry->lt_opr;
+
+		if (!OidIsValid(sort_operator))
+			return;
+
+		attnos[n] = attno;
+		keys[n].ssup_cxt = CurrentMemoryContext;
+		keys[n].ssup_collation = att->attcollation;
+		keys[n].ssup_nulls_first = nulls_first;
+		keys[n].ssup_attno = attno;
+		PrepareSortSupportFromOrderingOp(sort_operator, &keys[n]);
+	}
+
+	buffer->num_sort_keys = n_keys;
+	buffer->sort_attnos = attnos;
+	buffer->sort_keys = keys;
+}
+
 /*
  * Allocate memory and initialize a new TSCopyMultiInsertBuffer for this
  * ResultRelInfo.
@@ -222,6 +331,8 @@ TSCopyMultiInsertBufferInit(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cis
 
 	buffer = (TSCopyMultiInsertBuffer *) palloc0(sizeof(TSCopyMultiInsertBuffer));
 	buffer->method = method;
+	buffer->chunk_id = cis->chunk_id;
+	buffer->flush_target = INITIAL_BUFFERED_TUPLES;
 
 	buffer->point = palloc(POINT_SIZE(point->num_coords));
 	memcpy(buffer->point, point, POINT_SIZE(point->num_coords));
@@ -268,15 +379,31 @@ TSCopyMultiInsertBufferInit(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cis
 			 */
 			buffer->tupdesc = CreateTupleDescCopyConstr(cis->rel->rd_att);
 			Assert(buffer->tupdesc->tdrefcount == -1);
+
+			/*
+			 * Rowstore inserts into a compressed chunk benefit from landing
+			 * segment-ordered, see TSCopyMultiInsertBufferSetupSortKeys.
+			 * Sorting reorders the rows within a flushed batch, so it is only
+			 * done when no triggers could observe the stream order.
+			 */
+			if (cis->chunk_compressed && cis->result_relation_info->ri_TrigDesc == NULL)
+				TSCopyMultiInsertBufferSetupSortKeys(buffer, cis);
 			break;
 		case TS_CIM_COMPRESSION:
 		{
-			bool sort = ts_guc_enable_direct_compress_copy_sort_batches &&
-						!ts_guc_enable_direct_compress_copy_client_sorted;
+			CompressorIngestMode ingest_mode;
+
+			if (ts_guc_enable_direct_compress_copy_client_sorted)
+				ingest_mode = COMPRESSOR_INGEST_ORDERED;
+			else if (ts_guc_enable_direct_compress_copy_sort_batches)
+				ingest_mode = COMPRESSOR_INGEST_SORT_BATCHES;
+			else
+				ingest_mode = COMPRESSOR_INGEST_SEGMENT_STAGING;
+
 			buffer->compressor =
 				ts_cm_functions->compressor_init(cis->rel,
 												 &buffer->bulk_writer,
-												 sort,
+												 ingest_mode,
 												 ts_guc_direct_compress_copy_tuple_sort_limit);
 
 			if (miinfo->has_continuous_aggregate)
@@ -366,21 +493,150 @@ TSCopyMultiInsertInfoInit(TSCopyMultiInsertInfo *miinfo, ResultRelInfo *rri,
 	miinfo->ti_options = ti_options;
 	miinfo->ht = ht;
 	miinfo->has_continuous_aggregate = ts_hypertable_has_continuous_aggregates(ht->fd.id);
+	miinfo->flushes = 0;
 }
 
 /*
- * Returns true if the buffers are full.
+ * Returns true if the shared budget across all buffers is exhausted.
  */
 static inline bool
 TSCopyMultiInsertInfoIsFull(TSCopyMultiInsertInfo *miinfo)
 {
-	if (miinfo->bufferedTuples >= MAX_BUFFERED_TUPLES ||
-		miinfo->bufferedBytes >= MAX_BUFFERED_BYTES)
+	if (miinfo->bufferedTuples >= MAX_BUFFERED_TOTAL_TUPLES ||
+		miinfo->bufferedBytes >= MAX_BUFFERED_TOTAL_BYTES)
 		return true;
 
 	return false;
 }
 
+/*
+ * Check whether the indexes on the result relation are plain enough to have
+ * their entries inserted index-by-index instead of row-by-row. Expression and
+ * partial indexes need the executor machinery of ExecInsertIndexTuples, and
+ * exclusion constraints need its recheck handling.
+ */
+static bool
+TSCopyCanUseIndexMajorInsert(ResultRelInfo *rri)
+{
+	for (int i = 0; i < rri->ri_NumIndices; i++)
+	{
+		IndexInfo *ii = rri->ri_IndexRelationInfo[i];
+
+		if (ii->ii_Expressions != NIL || ii->ii_Predicate != NIL || ii->ii_ExclusionOps != NULL)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Insert the index entries for all flushed tuples one index at a time instead
+ * of one row at a time. Time-ordered buffers have sorted keys, so consecutive
+ * inserts into the same btree land on the same rightmost leaf page and are
+ * served by the nbtree fastpath, instead of descending every index anew for
+ * every row. This is only used when the per-row bookkeeping of
+ * ExecInsertIndexTuples is not needed, see TSCopyCanUseIndexMajorInsert.
+ */
+static void
+TSCopyMultiInsertBufferInsertIndexes(TSCopyMultiInsertInfo *miinfo, ResultRelInfo *rri,
+									 TSCopyMultiInsertBuffer *buffer, int nused,
+									 CopyFromState cstate)
+{
+	EState *estate = miinfo->estate;
+	ExprContext *econtext = GetPerTupleExprContext(estate);
+	Datum values[INDEX_MAX_KEYS];
+	bool isnull[INDEX_MAX_KEYS];
+
+	for (int ix = 0; ix < rri->ri_NumIndices; ix++)
+	{
+		Relation indexrel = rri->ri_IndexRelationDescs[ix];
+		IndexInfo *ii = rri->ri_IndexRelationInfo[ix];
+
+		if (!ii->ii_ReadyForInserts)
+			continue;
+
+		for (int i = 0; i < nused; i++)
+		{
+			TupleTableSlot *slot = buffer->slots[i];
+
+			/* Report the right input line on unique violations */
+			if (cstate != NULL)
+				cstate->cur_lineno = buffer->linenos[i];
+
+			econtext->ecxt_scantuple = slot;
+			FormIndexDatum(ii, slot, estate, values, isnull);
+			index_insert(indexrel,
+						 values,
+						 isnull,
+						 &slot->tts_tid,
+						 rri->ri_RelationDesc,
+						 ii->ii_Unique ? UNIQUE_CHECK_YES : UNIQUE_CHECK_NO,
+						 false /*=indexUnchanged*/,
+						 ii);
+		}
+	}
+}
+
+/*
+ * A buffered tuple paired with its COPY input line number, so that the two
+ * stay together when the buffer is sorted and error reports keep pointing at
+ * the right input line.
+ */
+typedef struct TSCopySortableTuple
+{
+	TupleTableSlot *slot;
+	uint64 lineno;
+} TSCopySortableTuple;
+
+static int
+TSCopyBufferedTupleCmp(const void *a, const void *b, void *arg)
+{
+	TSCopyMultiInsertBuffer *buffer = (TSCopyMultiInsertBuffer *) arg;
+	TupleTableSlot *slot_a = ((const TSCopySortableTuple *) a)->slot;
+	TupleTableSlot *slot_b = ((const TSCopySortableTuple *) b)->slot;
+
+	for (int n = 0; n < buffer->num_sort_keys; n++)
+	{
+		bool isnull_a, isnull_b;
+		Datum datum_a = slot_getattr(slot_a, buffer->sort_attnos[n], &isnull_a);
+		Datum datum_b = slot_getattr(slot_b, buffer->sort_attnos[n], &isnull_b);
+		int cmp =
+			ApplySortComparator(datum_a, isnull_a, datum_b, isnull_b, &buffer->sort_keys[n]);
+
+		if (cmp != 0)
+			return cmp;
+	}
+
+	return 0;
+}
+
+/*
+ * Sort the buffered tuples by the segmentby+orderby keys of the target
+ * chunk's compression settings, see TSCopyMultiInsertBufferSetupSortKeys.
+ */
+static void
+TSCopyMultiInsertBufferSort(TSCopyMultiInsertBuffer *buffer)
+{
+	TSCopySortableTuple *tuples = palloc(sizeof(TSCopySortableTuple) * buffer->nused);
+	int i;
+
+	for (i = 0; i < buffer->nused; i++)
+	{
+		tuples[i].slot = buffer->slots[i];
+		tuples[i].lineno = buffer->linenos[i];
+	}
+
+	qsort_arg(tuples, buffer->nused, sizeof(TSCopySortableTuple), TSCopyBufferedTupleCmp, buffer);
+
+	for (i = 0; i < buffer->nused; i++)
+	{
+		buffer->slots[i] = tuples[i].slot;
+		buffer->linenos[i] = tuples[i].lineno;
+	}
+
+	pfree(tuples);
+}
+
 /*
  * Write the tuples stored in 'buffer' out to the table.
  */
@@ -404,6 +660,9 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 		ts_cm_functions->compressor_flush(buffer->compressor, buffer->bulk_writer);
 	}
 
+	if (buffer->num_sort_keys > 0 && nused > 1)
+		TSCopyMultiInsertBufferSort(buffer);
+
 	/*
 	 * table_multi_insert and reinitialization of the chunk insert state may
 	 * leak memory, so switch to short-lived memory context before calling it.
@@ -424,6 +683,9 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 
 	ResultRelInfo *resultRelInfo = cis->result_relation_info;
 
+	TS_PROBE3(copy_flush, RelationGetRelid(resultRelInfo->ri_RelationDesc), nused, buffer->method);
+	miinfo->flushes++;
+
 	/*
 	 * Add context information to the copy state, which is used to display
 	 * error messages with additional details.
@@ -449,6 +711,30 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 					   buffer->bistate);
 	MemoryContextSwitchTo(oldcontext);
 
+	/*
+	 * Transition-table triggers live on the hypertable, not on the chunks, so
+	 * the capture state must be consulted in addition to the chunk's trigger
+	 * descriptor to decide whether AFTER ROW events need to be queued for the
+	 * flushed tuples.
+	 */
+	TransitionCaptureState *transition_capture =
+		cstate != NULL ? cstate->transition_capture : NULL;
+	bool fire_ar_triggers = (resultRelInfo->ri_TrigDesc != NULL &&
+							 resultRelInfo->ri_TrigDesc->trig_insert_after_row) ||
+							(transition_capture != NULL &&
+							 transition_capture->tcs_insert_new_table);
+
+	/*
+	 * Without AFTER ROW triggers there is no per-row bookkeeping and the
+	 * index entries can be inserted index-by-index, which is much cheaper
+	 * for the sorted keys of time-ordered buffers.
+	 */
+	bool index_major = resultRelInfo->ri_NumIndices > 0 && !fire_ar_triggers &&
+					   TSCopyCanUseIndexMajorInsert(resultRelInfo);
+
+	if (index_major)
+		TSCopyMultiInsertBufferInsertIndexes(miinfo, resultRelInfo, buffer, nused, cstate);
+
 	for (i = 0; i < nused; i++)
 	{
 		if (cstate != NULL)
@@ -457,7 +743,7 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 		 * If there are any indexes, update them for all the inserted tuples,
 		 * and run AFTER ROW INSERT triggers.
 		 */
-		if (resultRelInfo->ri_NumIndices > 0)
+		if (!index_major && resultRelInfo->ri_NumIndices > 0)
 		{
 			List *recheckIndexes;
 
@@ -470,11 +756,12 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 														 NIL,
 														 false);
 
-			ExecARInsertTriggers(estate,
-								 resultRelInfo,
-								 slots[i],
-								 recheckIndexes,
-								 NULL /* transition capture */);
+			if (fire_ar_triggers)
+				ExecARInsertTriggers(estate,
+									 resultRelInfo,
+									 slots[i],
+									 recheckIndexes,
+									 transition_capture);
 			list_free(recheckIndexes);
 		}
 
@@ -482,15 +769,13 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 		 * There's no indexes, but see if we need to run AFTER ROW INSERT
 		 * triggers anyway.
 		 */
-		else if (resultRelInfo->ri_TrigDesc != NULL &&
-				 (resultRelInfo->ri_TrigDesc->trig_insert_after_row ||
-				  resultRelInfo->ri_TrigDesc->trig_insert_new_table))
+		else if (fire_ar_triggers)
 		{
 			ExecARInsertTriggers(estate,
 								 resultRelInfo,
 								 slots[i],
 								 NIL,
-								 NULL /* transition capture */);
+								 transition_capture);
 		}
 
 		if (miinfo->has_continuous_aggregate)
@@ -512,6 +797,16 @@ TSCopyMultiInsertBufferFlush(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuf
 	/* Mark that all slots are free */
 	buffer->nused = 0;
 
+	/*
+	 * Adapt the flush target to the observed arrival rate. A buffer that
+	 * filled its target since the last flush gets twice the room, one that a
+	 * budget flush caught mostly empty is shrunk again.
+	 */
+	if (nused >= buffer->flush_target)
+		buffer->flush_target = Min(buffer->flush_target * 2, MAX_BUFFERED_TUPLES);
+	else if (nused < buffer->flush_target / 4)
+		buffer->flush_target = Max(buffer->flush_target / 2, INITIAL_BUFFERED_TUPLES);
+
 	/* Chunk could be closed on a subsequent call of ts_chunk_dispatch_get_chunk_insert_state
 	 * (e.g., due to timescaledb.max_open_chunks_per_insert). So, ensure the bulk insert is
 	 * finished after the flush is complete.
@@ -555,6 +850,12 @@ TSCopyMultiInsertBufferCleanup(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertB
 				ExecDropSingleTupleTableSlot(buffer->slots[i]);
 
 			FreeTupleDesc(buffer->tupdesc);
+
+			if (buffer->num_sort_keys > 0)
+			{
+				pfree(buffer->sort_attnos);
+				pfree(buffer->sort_keys);
+			}
 			break;
 		case TS_CIM_COMPRESSION:
 			ts_cm_functions->compressor_free(buffer->compressor, buffer->bulk_writer);
@@ -565,6 +866,26 @@ TSCopyMultiInsertBufferCleanup(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertB
 	pfree(buffer);
 }
 
+/* list_sort comparator to sort TSCopyMultiInsertBuffer by chunk id */
+static int
+TSCmpBuffersByChunkId(const ListCell *a, const ListCell *b)
+{
+	int32 c1 = ((const TSCopyMultiInsertBuffer *) lfirst(a))->chunk_id;
+	int32 c2 = ((const TSCopyMultiInsertBuffer *) lfirst(b))->chunk_id;
+
+	if (c1 > c2)
+	{
+		return 1;
+	}
+
+	if (c1 == c2)
+	{
+		return 0;
+	}
+
+	return -1;
+}
+
 /* list_sort comparator to sort TSCopyMultiInsertBuffer by usage */
 static int
 TSCmpBuffersByUsage(const ListCell *a, const ListCell *b)
@@ -589,19 +910,37 @@ TSCmpBuffersByUsage(const ListCell *a, const ListCell *b)
 }
 
 /*
- * Flush all buffers by writing the tuples to the chunks. In addition, trim down the
+ * Flush a single buffer that has reached its adaptive flush target. The
+ * other buffers keep accumulating tuples against the shared budget.
+ */
+static inline void
+TSCopyMultiInsertBufferFlushSingle(TSCopyMultiInsertInfo *miinfo, TSCopyMultiInsertBuffer *buffer)
+{
+	miinfo->bufferedTuples -= buffer->nused;
+	miinfo->bufferedBytes -= buffer->nbytes;
+	buffer->nbytes = 0;
+	TSCopyMultiInsertBufferFlush(miinfo, buffer);
+}
+
+/*
+ * Flush buffers by writing the tuples to the chunks. In addition, trim down the
  * amount of multi-insert buffers to MAX_PARTITION_BUFFERS by deleting the least used
  * buffers (the buffers that store least tuples).
+ *
+ * When flush_all is false, only the most filled buffers are flushed, until half
+ * of the buffering budget is freed. A bulk load that interleaves rows from many
+ * chunks would otherwise write every chunk a few tuples at a time whenever the
+ * global budget fills up, while the chunks that receive only an occasional row
+ * are better left to accumulate a full multi-insert batch.
  */
 static inline void
-TSCopyMultiInsertInfoFlush(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cur_cis)
+TSCopyMultiInsertInfoFlush(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cur_cis, bool flush_all)
 {
 	HASH_SEQ_STATUS status;
 	MultiInsertBufferEntry *entry;
 	int current_multi_insert_buffers;
 	int buffers_to_delete;
 	bool found;
-	int32 flushed_chunk_id;
 	List *buffer_list = NIL;
 	ListCell *lc;
 
@@ -617,37 +956,81 @@ TSCopyMultiInsertInfoFlush(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cur_
 
 	buffers_to_delete = Max(current_multi_insert_buffers - MAX_PARTITION_BUFFERS, 0);
 
-	/* Sorting is only needed if we want to remove the least used buffers */
-	if (buffers_to_delete > 0)
+	/* Sorting is needed to remove the least used buffers and for partial flushing */
+	if (buffers_to_delete > 0 || !flush_all)
 		list_sort(buffer_list, TSCmpBuffersByUsage);
 
-	/* Flush buffers and delete them if needed */
+	/* Pick the buffers to flush, the most filled ones first */
+	List *flush_list = NIL;
+	for (int i = list_length(buffer_list) - 1; i >= 0; i--)
+	{
+		TSCopyMultiInsertBuffer *buffer = (TSCopyMultiInsertBuffer *) list_nth(buffer_list, i);
+
+		if (!flush_all && miinfo->bufferedTuples <= MAX_BUFFERED_TOTAL_TUPLES / 2 &&
+			miinfo->bufferedBytes <= MAX_BUFFERED_TOTAL_BYTES / 2)
+			break;
+
+		miinfo->bufferedTuples -= buffer->nused;
+		miinfo->bufferedBytes -= buffer->nbytes;
+		buffer->nbytes = 0;
+		flush_list = lappend(flush_list, buffer);
+	}
+
+	/*
+	 * Flush the picked buffers in chunk order rather than fill order, so that
+	 * consecutive flush rounds visit the chunks in the same order and a
+	 * chunk's heap and index pages are still warm from the previous round.
+	 */
+	list_sort(flush_list, TSCmpBuffersByChunkId);
+
+	foreach (lc, flush_list)
+		TSCopyMultiInsertBufferFlush(miinfo, (TSCopyMultiInsertBuffer *) lfirst(lc));
+
+	list_free(flush_list);
+
+	/*
+	 * Reduce active multi-insert buffers, deleting the least used ones.
+	 * However, the current used buffer should not be deleted because it might
+	 * be reused for the next insert.
+	 */
 	foreach (lc, buffer_list)
 	{
 		TSCopyMultiInsertBuffer *buffer = (TSCopyMultiInsertBuffer *) lfirst(lc);
-		flushed_chunk_id = TSCopyMultiInsertBufferFlush(miinfo, buffer);
 
-		if (buffers_to_delete > 0)
+		if (buffers_to_delete <= 0)
+			break;
+
+		if (current_chunk_id != 0 && buffer->chunk_id == current_chunk_id)
+			continue;
+
+		/*
+		 * The buffer must be flushed before cleanup. A compression buffer was
+		 * already flushed above when flushing all, because the flush loop
+		 * doesn't terminate early then.
+		 */
+		if (buffer->nused > 0 || (buffer->method == TS_CIM_COMPRESSION && !flush_all))
 		{
-			/*
-			 * Reduce active multi-insert buffers. However, the current used buffer
-			 * should not be deleted because it might reused for the next insert.
-			 */
-			if (current_chunk_id == 0 || flushed_chunk_id != current_chunk_id)
-			{
-				TSCopyMultiInsertBufferCleanup(miinfo, buffer);
-				hash_search(miinfo->multiInsertBuffers, &flushed_chunk_id, HASH_REMOVE, &found);
-				Assert(found);
-				buffers_to_delete--;
-			}
+			miinfo->bufferedTuples -= buffer->nused;
+			miinfo->bufferedBytes -= buffer->nbytes;
+			buffer->nbytes = 0;
+			TSCopyMultiInsertBufferFlush(miinfo, buffer);
 		}
+
+		int32 deleted_chunk_id = buffer->chunk_id;
+		TSCopyMultiInsertBufferCleanup(miinfo, buffer);
+		hash_search(miinfo->multiInsertBuffers, &deleted_chunk_id, HASH_REMOVE, &found);
+		Assert(found);
+		buffers_to_delete--;
 	}
 
 	list_free(buffer_list);
 
-	/* All buffers have been flushed */
-	miinfo->bufferedTuples = 0;
-	miinfo->bufferedBytes = 0;
+	if (flush_all)
+	{
+		/* All buffers have been flushed */
+		miinfo->bufferedTuples = 0;
+		miinfo->bufferedBytes = 0;
+	}
 }
 
 /*
@@ -658,7 +1041,7 @@ TSCopyMultiInsertInfoFlush(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cur_
 static inline void
 TSCopyMultiInsertInfoFlushAndCleanup(TSCopyMultiInsertInfo *miinfo)
 {
-	TSCopyMultiInsertInfoFlush(miinfo, NULL);
+	TSCopyMultiInsertInfoFlush(miinfo, NULL, /* flush_all = */ true);
 
 	HASH_SEQ_STATUS status;
 	MultiInsertBufferEntry *entry;
@@ -730,15 +1113,17 @@ TSCopyMultiInsertInfoStore(TSCopyMultiInsertInfo *miinfo, ResultRelInfo *rri,
 	miinfo->bufferedTuples++;
 
 	/*
-	 * Note: There is no reliable way to determine the in-memory size of a virtual
-	 * tuple. So, we perform flushing in PG < 14 only based on the number of buffered
-	 * tuples and not based on the size.
+	 * Account the materialized tuple size against the shared memory budget.
+	 * The caller has materialized the slot, so fetching the heap tuple here
+	 * is a cheap lookup and not a copy.
 	 */
-	if (cstate != NULL)
-	{
-		int tuplen = cstate->line_buf.len;
-		miinfo->bufferedBytes += tuplen;
-	}
+	bool should_free PG_USED_FOR_ASSERTS_ONLY;
+	HeapTuple tuple = ExecFetchSlotHeapTuple(slot, false, &should_free);
+	int tuplen = HEAPTUPLESIZE + tuple->t_len;
+	Assert(!should_free);
+
+	buffer->nbytes += tuplen;
+	miinfo->bufferedBytes += tuplen;
 }
 
 static void
@@ -769,11 +1154,14 @@ static TSCopyInsertMethod
 choose_copy_method(Hypertable *ht, CopyChunkState *ccstate, ResultRelInfo *resultRelInfo)
 {
 	/*
-	 * Multi-insert buffers (TS_CIM_MULTI_CONDITIONAL) can only be used if no triggers are
-	 * defined on the target table. Otherwise, the tuples may be inserted in an out-of-order
-	 * manner, which might violate the semantics of the triggers. So, they are inserted
-	 * tuple-per-tuple (TS_CIM_SINGLE). However, the ts_block trigger on the hypertable can
-	 * be ignored.
+	 * Multi-insert buffers (TS_CIM_MULTI_CONDITIONAL) can only be used if no
+	 * BEFORE or INSTEAD OF row triggers are defined on the target table.
+	 * Those triggers must see the table as it looked when their row arrived,
+	 * so the tuples have to be inserted one-by-one in stream order
+	 * (TS_CIM_SINGLE). AFTER ROW triggers, including the transition-table
+	 * capture for statement-level triggers, only observe the final state and
+	 * are fired per tuple when a buffer is flushed, so they do not prevent
+	 * buffering. The ts_block trigger on the hypertable can be ignored.
 	 */
 
 	/* Before INSERT Triggers */
@@ -784,12 +1172,8 @@ choose_copy_method(Hypertable *ht, CopyChunkState *ccstate, ResultRelInfo *resul
 	bool has_instead_insert_row_trig =
 		(resultRelInfo->ri_TrigDesc && resultRelInfo->ri_TrigDesc->trig_insert_instead_row);
 
-	bool has_after_insert_statement_trig =
-		(resultRelInfo->ri_TrigDesc && resultRelInfo->ri_TrigDesc->trig_insert_new_table);
-
 	/* Depending on the configured trigger, enable or disable the multi-insert buffers */
-	if (has_after_insert_statement_trig || has_before_insert_row_trig ||
-		has_instead_insert_row_trig)
+	if (has_before_insert_row_trig || has_instead_insert_row_trig)
 	{
 		ereport(DEBUG1,
 				(errmsg("Using normal unbuffered copy operation (TS_CIM_SINGLE) "
@@ -1083,7 +1467,7 @@ copyfrom(CopyChunkState *ccstate, ParseState *pstate, Hypertable *ht, MemoryCont
 		 * visible to the triggers.
 		 */
 		if (insertMethod != buffer->method)
-			TSCopyMultiInsertInfoFlush(&multiInsertInfo, cis);
+			TSCopyMultiInsertInfoFlush(&multiInsertInfo, cis, /* flush_all = */ true);
 
 		/* Convert the tuple to match the chunk's rowtype */
 		if (buffer->method == TS_CIM_SINGLE)
@@ -1223,17 +1607,20 @@ copyfrom(CopyChunkState *ccstate, ParseState *pstate, Hypertable *ht, MemoryCont
 										   ccstate->cstate);
 
 				/*
-				 * If enough inserts have queued up, then flush all
-				 * buffers out to their tables.
+				 * Flush this buffer alone when it has reached its adaptive
+				 * target, and flush the most filled buffers when the shared
+				 * budget across all buffers is exhausted.
 				 */
-				if (TSCopyMultiInsertInfoIsFull(&multiInsertInfo))
+				if (buffer->nused >= buffer->flush_target)
+					TSCopyMultiInsertBufferFlushSingle(&multiInsertInfo, buffer);
+				else if (TSCopyMultiInsertInfoIsFull(&multiInsertInfo))
 				{
 					ereport(DEBUG2,
 							(errmsg("flush called with %d bytes and %d buffered tuples",
 									multiInsertInfo.bufferedBytes,
 									multiInsertInfo.bufferedTuples)));
 
-					TSCopyMultiInsertInfoFlush(&multiInsertInfo, cis);
+					TSCopyMultiInsertInfoFlush(&multiInsertInfo, cis, /* flush_all = */ false);
 				}
 			}
 
@@ -1586,3 +1973,108 @@ timescaledb_move_from_table_to_chunks(Hypertable *ht, LOCKMODE lockmode)
 
 	ExecuteTruncate(&stmt);
 }
+
+/*
+ * Entry points for the INSERT path in modify_hypertable_exec.c, which borrows
+ * the multi-insert buffering above for batching set-based INSERTs. The COPY
+ * specific pieces (CopyFromState, line numbers) stay NULL, the flush code
+ * already handles that for the table-to-chunk migration.
+ */
+TSCopyMultiInsertInfo *
+ts_copy_multi_insert_info_create(ChunkTupleRouting *ctr, EState *estate, Hypertable *ht)
+{
+	TSCopyMultiInsertInfo *miinfo = palloc0(sizeof(TSCopyMultiInsertInfo));
+	CopyChunkState *ccstate = palloc0(sizeof(CopyChunkState));
+
+	ccstate->rel = ctr->root_rel;
+	ccstate->estate = estate;
+	ccstate->ctr = ctr;
+
+	TSCopyMultiInsertInfoInit(miinfo,
+							  ctr->root_rri,
+							  ccstate,
+							  estate,
+							  GetCurrentCommandId(true),
+							  0 /* ti_options */,
+							  ht);
+
+	return miinfo;
+}
+
+/*
+ * Buffer one routed tuple for a later multi-insert flush. Returns false
+ * without consuming the tuple when the chunk cannot use multi-inserts (row
+ * triggers downgrade the buffer to TS_CIM_SINGLE), in which case the caller
+ * must fall back to the regular ExecInsert path.
+ */
+bool
+ts_copy_multi_insert_buffer_tuple(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cis,
+								  Point *point, TupleTableSlot *slot)
+{
+	ResultRelInfo *rri = cis->result_relation_info;
+	TSCopyMultiInsertBuffer *buffer;
+	TupleTableSlot *batchslot;
+
+	buffer = TSCopyMultiInsertInfoGetOrSetupBuffer(miinfo, cis, point, TS_CIM_MULTI_CONDITIONAL);
+
+	if (buffer->method != TS_CIM_MULTI_CONDITIONAL)
+		return false;
+
+	batchslot = TSCopyMultiInsertInfoNextFreeSlot(miinfo, rri, buffer);
+
+	/* Convert the tuple to match the chunk's rowtype */
+	if (NULL != cis->hyper_to_chunk_map)
+		batchslot = execute_attr_map_slot(cis->hyper_to_chunk_map->attrMap, slot, batchslot);
+	else
+		ExecCopySlot(batchslot, slot);
+
+	ts_tuptableslot_set_table_oid(batchslot, RelationGetRelid(rri->ri_RelationDesc));
+
+	/* Compute stored generated columns */
+	if (rri->ri_RelationDesc->rd_att->constr &&
+		rri->ri_RelationDesc->rd_att->constr->has_generated_stored)
+		ExecComputeStoredGenerated(rri, miinfo->estate, batchslot, CMD_INSERT);
+
+	/*
+	 * Partitioning constraints were already checked by tuple routing, so only
+	 * check constraints when the chunk has additional ones.
+	 */
+	if (!buffer->can_skip_constraints)
+	{
+		Assert(rri->ri_RangeTableIndex > 0 && miinfo->estate->es_range_table);
+		ExecConstraints(rri, batchslot, miinfo->estate);
+	}
+
+	/*
+	 * The slot previously might point into the per-tuple context. For
+	 * batching it needs to be longer lived.
+	 */
+	ExecMaterializeSlot(batchslot);
+
+	TSCopyMultiInsertInfoStore(miinfo, rri, buffer, batchslot, NULL);
+
+	if (buffer->nused >= buffer->flush_target)
+		TSCopyMultiInsertBufferFlushSingle(miinfo, buffer);
+	else if (TSCopyMultiInsertInfoIsFull(miinfo))
+		TSCopyMultiInsertInfoFlush(miinfo, cis, /* flush_all = */ false);
+
+	return true;
+}
+
+/*
+ * Flush all remaining buffered tuples and free the multi-insert state.
+ * Returns the number of buffer flushes performed over the lifetime of the
+ * multi-insert state, for instrumentation.
+ */
+int64
+ts_copy_multi_insert_info_finish(TSCopyMultiInsertInfo *miinfo)
+{
+	int64 flushes;
+
+	TSCopyMultiInsertInfoFlushAndCleanup(miinfo);
+	flushes = miinfo->flushes;
+	pfree(miinfo->ccstate);
+	pfree(miinfo);
+
+	return flushes;
+}
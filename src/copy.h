@@ -35,3 +35,15 @@ typedef struct CopyChunkState
 extern void timescaledb_DoCopy(const CopyStmt *stmt, const char *queryString, uint64 *processed,
 							   Hypertable *ht);
 extern void timescaledb_move_from_table_to_chunks(Hypertable *ht, LOCKMODE lockmode);
+
+/*
+ * Multi-insert buffering, also borrowed by the INSERT path in
+ * modify_hypertable_exec.c for batching set-based inserts.
+ */
+typedef struct TSCopyMultiInsertInfo TSCopyMultiInsertInfo;
+
+extern TSCopyMultiInsertInfo *ts_copy_multi_insert_info_create(ChunkTupleRouting *ctr,
+															   EState *estate, Hypertable *ht);
+extern bool ts_copy_multi_insert_buffer_tuple(TSCopyMultiInsertInfo *miinfo, ChunkInsertState *cis,
+											  Point *point, TupleTableSlot *slot);
+extern int64 ts_copy_multi_insert_info_finish(TSCopyMultiInsertInfo *miinfo);
@@ -82,7 +82,12 @@ CROSSMODULE_WRAPPER(bool_compressor_append);
 CROSSMODULE_WRAPPER(bool_compressor_finish);
 CROSSMODULE_WRAPPER(uuid_compressor_append);
 CROSSMODULE_WRAPPER(uuid_compressor_finish);
+CROSSMODULE_WRAPPER(alp_compressor_append);
+CROSSMODULE_WRAPPER(alp_compressor_finish);
+CROSSMODULE_WRAPPER(rle_compressor_append);
+CROSSMODULE_WRAPPER(rle_compressor_finish);
 CROSSMODULE_WRAPPER(create_compressed_chunk);
+CROSSMODULE_WRAPPER(backfill_compressed_chunk);
 CROSSMODULE_WRAPPER(compress_chunk);
 CROSSMODULE_WRAPPER(decompress_chunk);
 CROSSMODULE_WRAPPER(rebuild_columnstore);
@@ -352,6 +357,7 @@ TSDLLEXPORT CrossModuleFunctions ts_cm_functions_default = {
 	.compressed_data_out = process_compressed_data_out,
 	.process_compress_table = process_compress_table_default,
 	.create_compressed_chunk = error_no_default_fn_pg_community,
+	.backfill_compressed_chunk = error_no_default_fn_pg_community,
 	.compress_chunk = error_no_default_fn_pg_community,
 	.decompress_chunk = error_no_default_fn_pg_community,
 	.rebuild_columnstore = error_no_default_fn_pg_community,
@@ -371,6 +377,10 @@ TSDLLEXPORT CrossModuleFunctions ts_cm_functions_default = {
 	.bool_compressor_finish = error_no_default_fn_pg_community,
 	.uuid_compressor_append = error_no_default_fn_pg_community,
 	.uuid_compressor_finish = error_no_default_fn_pg_community,
+	.alp_compressor_append = error_no_default_fn_pg_community,
+	.alp_compressor_finish = error_no_default_fn_pg_community,
+	.rle_compressor_append = error_no_default_fn_pg_community,
+	.rle_compressor_finish = error_no_default_fn_pg_community,
 	.bloom1_contains = error_no_default_fn_pg_community,
 	.bloom1_contains_any = error_no_default_fn_pg_community,
 	.bloom1_get_hash_function = bloom1_get_hash_function_default,
@@ -38,6 +38,20 @@ typedef struct ModifyHypertableState ModifyHypertableState;
 typedef struct RowCompressor RowCompressor;
 typedef struct BulkWriter BulkWriter;
 
+/*
+ * How tuples arrive at a RowCompressor during direct compressed ingestion.
+ */
+typedef enum CompressorIngestMode
+{
+	/* The client guarantees the input is ordered, compress as-is */
+	COMPRESSOR_INGEST_ORDERED,
+	/* Buffer and sort each ingested batch before compressing it */
+	COMPRESSOR_INGEST_SORT_BATCHES,
+	/* Stage unordered tuples per segmentby group and compress a group
+	 * once it accumulates a full batch */
+	COMPRESSOR_INGEST_SEGMENT_STAGING,
+} CompressorIngestMode;
+
 typedef struct CrossModuleFunctions
 {
 	PGFunction policy_compression_add;
@@ -126,16 +140,18 @@ typedef struct CrossModuleFunctions
 	void (*process_altertable_cmd)(Hypertable *ht, const AlterTableCmd *cmd);
 	void (*process_rename_cmd)(Oid relid, Cache *hcache, const RenameStmt *stmt);
 	PGFunction create_compressed_chunk;
+	PGFunction backfill_compressed_chunk;
 	PGFunction compress_chunk;
 	PGFunction decompress_chunk;
 	PGFunction rebuild_columnstore;
 	void (*decompress_batches_for_insert)(ChunkInsertState *state, TupleTableSlot *slot);
 	void (*init_decompress_state_for_insert)(ChunkInsertState *state, TupleTableSlot *slot);
 	bool (*decompress_target_segments)(ModifyHypertableState *ht_state);
+	void (*recompress_chunk_for_dml)(Oid chunk_relid);
 
 	void (*columnstore_setup)(Hypertable *ht, WithClauseResult *with_clause_options);
-	RowCompressor *(*compressor_init)(Relation in_rel, BulkWriter **bulk_writer, bool sort,
-									  int tuple_sort_limit);
+	RowCompressor *(*compressor_init)(Relation in_rel, BulkWriter **bulk_writer,
+									  CompressorIngestMode ingest_mode, int tuple_limit);
 	void (*compressor_set_invalidation)(RowCompressor *compressor, Hypertable *ht, Oid chunk_relid);
 	void (*compressor_add_slot)(RowCompressor *compressor, BulkWriter *bulk_writer,
 								TupleTableSlot *slot);
@@ -164,6 +180,10 @@ typedef struct CrossModuleFunctions
 	PGFunction bool_compressor_finish;
 	PGFunction uuid_compressor_append;
 	PGFunction uuid_compressor_finish;
+	PGFunction alp_compressor_append;
+	PGFunction alp_compressor_finish;
+	PGFunction rle_compressor_append;
+	PGFunction rle_compressor_finish;
 	PGFunction bloom1_contains;
 	PGFunction bloom1_contains_any;
 	PGFunction (*bloom1_get_hash_function)(Oid type, FmgrInfo **finfo);
@@ -980,7 +980,16 @@ ts_hyperspace_calculate_point(const Hyperspace *hs, TupleTableSlot *slot)
 									NameStr(d->fd.column_name)),
 							 errhint("Columns used for time partitioning cannot be NULL.")));
 
-				p->coordinates[p->num_coords++] = ts_time_value_to_internal(datum, dimtype);
+				/*
+				 * Tuple routing goes through here once per row, so convert
+				 * the common timestamp types inline instead of taking the
+				 * general path with its per-value special-value lookups.
+				 */
+				if (dimtype == TIMESTAMPOID || dimtype == TIMESTAMPTZOID)
+					p->coordinates[p->num_coords++] =
+						ts_timestamp_value_to_internal(DatumGetTimestampTz(datum));
+				else
+					p->coordinates[p->num_coords++] = ts_time_value_to_internal(datum, dimtype);
 				break;
 			case DIMENSION_TYPE_CLOSED:
 				p->coordinates[p->num_coords++] = (int64) DatumGetInt32(datum);
@@ -5,6 +5,7 @@
  */
 #include <postgres.h>
 #include <access/heapam.h>
+#include <access/htup_details.h>
 #include <access/relscan.h>
 #include <access/xact.h>
 #include <catalog/indexing.h>
@@ -80,13 +81,10 @@ dimension_slice_formdata_make_tuple(const FormData_dimension_slice *fd, TupleDes
 static inline void
 dimension_slice_formdata_fill(FormData_dimension_slice *fd, const TupleInfo *ti)
 {
-	bool nulls[Natts_dimension_slice];
-	Datum values[Natts_dimension_slice];
-	bool should_free;
-	HeapTuple tuple;
+	Datum *values;
+	bool *nulls;
 
-	tuple = ts_scanner_fetch_heap_tuple(ti, false, &should_free);
-	heap_deform_tuple(tuple, ts_scanner_get_tupledesc(ti), values, nulls);
+	ts_scanner_deform_tuple(ti, Natts_dimension_slice, &values, &nulls);
 
 	Assert(!nulls[AttrNumberGetAttrOffset(Anum_dimension_slice_id)]);
 	Assert(!nulls[AttrNumberGetAttrOffset(Anum_dimension_slice_dimension_id)]);
@@ -99,9 +97,6 @@ dimension_slice_formdata_fill(FormData_dimension_slice *fd, const TupleInfo *ti)
 	fd->range_start =
 		DatumGetInt64(values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_start)]);
 	fd->range_end = DatumGetInt64(values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_end)]);
-
-	if (should_free)
-		heap_freetuple(tuple);
 }
 
 static bool
@@ -976,6 +971,22 @@ ts_dimension_slice_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id)
 								   Int32GetDatum(slice_id));
 }
 
+/*
+ * Set an array of slice ids to scan for, given as an int4 array Datum. The
+ * scan streams the matching slices in ascending slice id order.
+ */
+void
+ts_dimension_slice_scan_iterator_set_slice_ids(ScanIterator *it, Datum slice_id_array)
+{
+	it->ctx.index = catalog_get_index(ts_catalog_get(), DIMENSION_SLICE, DIMENSION_SLICE_ID_IDX);
+	ts_scan_iterator_scan_key_reset(it);
+	ts_scan_iterator_scan_key_array_init(it,
+										 Anum_dimension_slice_id_idx_id,
+										 BTEqualStrategyNumber,
+										 F_INT4EQ,
+										 slice_id_array);
+}
+
 DimensionSlice *
 ts_dimension_slice_scan_iterator_get_by_id(ScanIterator *it, int32 slice_id)
 {
@@ -1088,6 +1099,21 @@ ts_dimension_slice_free(DimensionSlice *slice)
 	pfree(slice);
 }
 
+static void
+dimension_slice_fill_tuple_values(const DimensionSlice *slice,
+								  Datum values[Natts_dimension_slice],
+								  bool nulls[Natts_dimension_slice])
+{
+	memset(values, 0, sizeof(Datum) * Natts_dimension_slice);
+	values[AttrNumberGetAttrOffset(Anum_dimension_slice_id)] = Int32GetDatum(slice->fd.id);
+	values[AttrNumberGetAttrOffset(Anum_dimension_slice_dimension_id)] =
+		Int32GetDatum(slice->fd.dimension_id);
+	values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_start)] =
+		Int64GetDatum(slice->fd.range_start);
+	values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_end)] =
+		Int64GetDatum(slice->fd.range_end);
+}
+
 static bool
 dimension_slice_insert_relation(const Relation rel, DimensionSlice *slice)
 {
@@ -1101,16 +1127,8 @@ dimension_slice_insert_relation(const Relation rel, DimensionSlice *slice)
 		return false;
 
 	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
-	memset(values, 0, sizeof(values));
 	slice->fd.id = ts_catalog_table_next_seq_id(ts_catalog_get(), DIMENSION_SLICE);
-	values[AttrNumberGetAttrOffset(Anum_dimension_slice_id)] = Int32GetDatum(slice->fd.id);
-	values[AttrNumberGetAttrOffset(Anum_dimension_slice_dimension_id)] =
-		Int32GetDatum(slice->fd.dimension_id);
-	values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_start)] =
-		Int64GetDatum(slice->fd.range_start);
-	values[AttrNumberGetAttrOffset(Anum_dimension_slice_range_end)] =
-		Int64GetDatum(slice->fd.range_end);
-
+	dimension_slice_fill_tuple_values(slice, values, nulls);
 	ts_catalog_insert_values(rel, desc, values, nulls);
 	ts_catalog_restore_user(&sec_ctx);
 
@@ -1126,26 +1144,47 @@ dimension_slice_insert_relation(const Relation rel, DimensionSlice *slice)
  * since they won't be created. Otherwise it is not possible to guarantee that
  * all slices still exist once the transaction commits.
  *
+ * All new slices are written with a single multi-insert so that the catalog
+ * indexes are only updated once per hypercube rather than once per slice.
+ *
  * Returns the number of slices inserted.
  */
 int
 ts_dimension_slice_insert_multi(DimensionSlice **slices, Size num_slices)
 {
 	Catalog *catalog = ts_catalog_get();
+	CatalogSecurityContext sec_ctx;
 	Relation rel;
+	HeapTuple *tuples;
 	Size i, n = 0;
 
 	rel = table_open(catalog_get_table_id(catalog, DIMENSION_SLICE), RowExclusiveLock);
 
+	tuples = palloc(sizeof(HeapTuple) * num_slices);
+
+	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+
 	for (i = 0; i < num_slices; i++)
 	{
-		if (slices[i]->fd.id == 0)
-		{
-			dimension_slice_insert_relation(rel, slices[i]);
-			n++;
-		}
+		Datum values[Natts_dimension_slice];
+		bool nulls[Natts_dimension_slice] = { false };
+
+		if (slices[i]->fd.id > 0)
+			/* Slice already exists in table */
+			continue;
+
+		slices[i]->fd.id = ts_catalog_table_next_seq_id(catalog, DIMENSION_SLICE);
+		dimension_slice_fill_tuple_values(slices[i], values, nulls);
+		tuples[n++] = heap_form_tuple(RelationGetDescr(rel), values, nulls);
 	}
 
+	ts_catalog_multi_insert(rel, n, tuples);
+	ts_catalog_restore_user(&sec_ctx);
+
+	for (i = 0; i < n; i++)
+		heap_freetuple(tuples[i]);
+
+	pfree(tuples);
 	table_close(rel, RowExclusiveLock);
 
 	return n;
@@ -101,6 +101,7 @@ extern DimensionSlice *ts_dimension_slice_from_tuple(TupleInfo *ti);
 extern ScanIterator ts_dimension_slice_scan_iterator_create(const ScanTupLock *tuplock,
 															MemoryContext result_mcxt);
 extern void ts_dimension_slice_scan_iterator_set_slice_id(ScanIterator *it, int32 slice_id);
+extern void ts_dimension_slice_scan_iterator_set_slice_ids(ScanIterator *it, Datum slice_id_array);
 extern DimensionSlice *ts_dimension_slice_scan_iterator_get_by_id(ScanIterator *it, int32 slice_id);
 
 extern int ts_dimension_slice_scan_iterator_set_range(ScanIterator *it, int32 dimension_id,
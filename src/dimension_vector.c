@@ -14,15 +14,6 @@ cmp_slices(const void *left, const void *right)
 	return ts_dimension_slice_cmp(left_slice, right_slice);
 }
 
-static int
-cmp_coordinate_and_slice(const void *left, const void *right)
-{
-	int64 coord = *((int64 *) left);
-	const DimensionSlice *slice = *((DimensionSlice **) right);
-
-	return ts_dimension_slice_cmp_coordinate(slice, coord);
-}
-
 static DimensionVec *
 dimension_vec_expand(DimensionVec *vec, int32 new_capacity)
 {
@@ -30,15 +21,41 @@ dimension_vec_expand(DimensionVec *vec, int32 new_capacity)
 		return vec;
 
 	if (NULL == vec)
+	{
 		vec = palloc(DIMENSION_VEC_SIZE(new_capacity));
+		vec->coords = palloc(sizeof(DimensionCoords) * new_capacity);
+	}
 	else
+	{
 		vec = repalloc(vec, DIMENSION_VEC_SIZE(new_capacity));
+		vec->coords = repalloc(vec->coords, sizeof(DimensionCoords) * new_capacity);
+	}
 
 	vec->capacity = new_capacity;
 
 	return vec;
 }
 
+static inline void
+dimension_vec_set_coords(DimensionVec *vec, int32 index, const DimensionSlice *slice)
+{
+	vec->coords[index].range_start = slice->fd.range_start;
+	vec->coords[index].range_end = slice->fd.range_end;
+}
+
+/*
+ * Refresh the packed coordinate array after the slices array has been
+ * reordered or compacted.
+ */
+static void
+dimension_vec_rebuild_coords(DimensionVec *vec)
+{
+	int i;
+
+	for (i = 0; i < vec->num_slices; i++)
+		dimension_vec_set_coords(vec, i, vec->slices[i]);
+}
+
 DimensionVec *
 ts_dimension_vec_create(int32 initial_num_slices)
 {
@@ -56,7 +73,38 @@ ts_dimension_vec_sort(DimensionVec **vecptr)
 	DimensionVec *vec = *vecptr;
 
 	if (vec->num_slices > 1)
+	{
 		qsort((void *) vec->slices, vec->num_slices, sizeof(DimensionSlice *), cmp_slices);
+		dimension_vec_rebuild_coords(vec);
+	}
+
+	return vec;
+}
+
+/*
+ * Sort the slices and remove duplicates.
+ *
+ * Slices with the same range within one dimension always have the same slice
+ * ID, so duplicates end up adjacent after sorting. Sorting and compacting
+ * once is cheaper than checking for duplicates on every insertion when many
+ * slices are collected, e.g., for a long IN-list on a space dimension.
+ */
+DimensionVec *
+ts_dimension_vec_sort_unique(DimensionVec **vecptr)
+{
+	DimensionVec *vec = ts_dimension_vec_sort(vecptr);
+	int num_unique = 0;
+	int i;
+
+	for (i = 0; i < vec->num_slices; i++)
+	{
+		if (num_unique > 0 && vec->slices[num_unique - 1]->fd.id == vec->slices[i]->fd.id)
+			ts_dimension_slice_free(vec->slices[i]);
+		else
+			vec->slices[num_unique++] = vec->slices[i];
+	}
+	vec->num_slices = num_unique;
+	dimension_vec_rebuild_coords(vec);
 
 	return vec;
 }
@@ -72,7 +120,9 @@ ts_dimension_vec_add_slice(DimensionVec **vecptr, DimensionSlice *slice)
 	if (vec->num_slices + 1 > vec->capacity)
 		*vecptr = vec = dimension_vec_expand(vec, vec->capacity + 10);
 
-	vec->slices[vec->num_slices++] = slice;
+	vec->slices[vec->num_slices] = slice;
+	dimension_vec_set_coords(vec, vec->num_slices, slice);
+	vec->num_slices++;
 
 	return vec;
 }
@@ -89,11 +139,47 @@ ts_dimension_vec_add_unique_slice(DimensionVec **vecptr, DimensionSlice *slice)
 	return vec;
 }
 
+/*
+ * Insert a slice into a sorted vector, keeping it sorted.
+ *
+ * The insertion point is found with a binary search and the tail of the
+ * vector is shifted, instead of appending and re-sorting the whole vector.
+ * This is the incremental maintenance path, e.g., one insertion per new
+ * chunk in the subspace store, where a full sort per insertion gets
+ * expensive with many slices.
+ */
 DimensionVec *
 ts_dimension_vec_add_slice_sort(DimensionVec **vecptr, DimensionSlice *slice)
 {
-	*vecptr = ts_dimension_vec_add_slice(vecptr, slice);
-	return ts_dimension_vec_sort(vecptr);
+	DimensionVec *vec;
+	int low = 0;
+	int high = (*vecptr)->num_slices;
+
+	Assert(dimension_vec_is_sorted(*vecptr));
+
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+
+		if (cmp_slices(&slice, &(*vecptr)->slices[mid]) < 0)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	vec = ts_dimension_vec_add_slice(vecptr, slice);
+	memmove((void *) &vec->slices[low + 1],
+			(void *) &vec->slices[low],
+			sizeof(DimensionSlice *) * (vec->num_slices - 1 - low));
+	memmove(&vec->coords[low + 1],
+			&vec->coords[low],
+			sizeof(DimensionCoords) * (vec->num_slices - 1 - low));
+	vec->slices[low] = slice;
+	dimension_vec_set_coords(vec, low, slice);
+
+	Assert(dimension_vec_is_sorted(vec));
+
+	return vec;
 }
 
 void
@@ -105,6 +191,9 @@ ts_dimension_vec_remove_slice(DimensionVec **vecptr, int32 index)
 	memmove((void *) &vec->slices[index],
 			(void *) &vec->slices[index + 1],
 			sizeof(DimensionSlice *) * (vec->num_slices - index - 1));
+	memmove(&vec->coords[index],
+			&vec->coords[index + 1],
+			sizeof(DimensionCoords) * (vec->num_slices - index - 1));
 	vec->num_slices--;
 }
 
@@ -128,23 +217,37 @@ dimension_vec_is_sorted(const DimensionVec *vec)
 DimensionSlice *
 ts_dimension_vec_find_slice(const DimensionVec *vec, int64 coordinate)
 {
-	DimensionSlice **res;
+	int low = 0;
+	int high = vec->num_slices;
 
 	if (vec->num_slices == 0)
 		return NULL;
 
 	Assert(dimension_vec_is_sorted(vec));
 
-	res = (DimensionSlice **) bsearch(&coordinate,
-									  (void *) vec->slices,
-									  vec->num_slices,
-									  sizeof(DimensionSlice *),
-									  cmp_coordinate_and_slice);
-
-	if (res == NULL)
-		return NULL;
-
-	return *res;
+	coordinate = REMAP_LAST_COORDINATE(coordinate);
+
+	/*
+	 * Binary search over the packed coordinate array. Only the matching
+	 * slice, if any, is dereferenced.
+	 */
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		const DimensionCoords *coords = &vec->coords[mid];
+
+		if (coordinate < coords->range_start)
+			high = mid;
+		else if (coordinate >= coords->range_end)
+			low = mid + 1;
+		else
+		{
+			Assert(ts_dimension_slice_cmp_coordinate(vec->slices[mid], coordinate) == 0);
+			return vec->slices[mid];
+		}
+	}
+
+	return NULL;
 }
 
 int
@@ -175,5 +278,6 @@ ts_dimension_vec_free(DimensionVec *vec)
 
 	for (i = 0; i < vec->num_slices; i++)
 		ts_dimension_slice_free(vec->slices[i]);
+	pfree(vec->coords);
 	pfree(vec);
 }
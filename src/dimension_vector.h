@@ -10,6 +10,17 @@
 #include "dimension_slice.h"
 #include "hypertable_restrict_info.h"
 
+/*
+ * Packed copy of a slice's range, kept in an array parallel to the slices so
+ * that binary searches touch contiguous memory instead of chasing one slice
+ * pointer per comparison.
+ */
+typedef struct DimensionCoords
+{
+	int64 range_start;
+	int64 range_end;
+} DimensionCoords;
+
 /*
  *	DimensionVec is a collection of slices (ranges) along one dimension for a
  *	time range.
@@ -20,6 +31,7 @@ typedef struct DimensionVec
 	int32 num_slices;			/* The current number of slices in slices
 								 * array */
 	DimensionRestrictInfo *dri; /* corresponding restrictinfo */
+	DimensionCoords *coords;	/* slice ranges, parallel to slices */
 	DimensionSlice *slices[FLEXIBLE_ARRAY_MEMBER];
 } DimensionVec;
 
@@ -30,6 +42,7 @@ typedef struct DimensionVec
 
 extern DimensionVec *ts_dimension_vec_create(int32 initial_num_slices);
 extern DimensionVec *ts_dimension_vec_sort(DimensionVec **vec);
+extern DimensionVec *ts_dimension_vec_sort_unique(DimensionVec **vec);
 extern DimensionVec *ts_dimension_vec_add_slice_sort(DimensionVec **vec, DimensionSlice *slice);
 extern DimensionVec *ts_dimension_vec_add_slice(DimensionVec **vecptr, DimensionSlice *slice);
 extern DimensionVec *ts_dimension_vec_add_unique_slice(DimensionVec **vecptr,
@@ -157,8 +157,8 @@ resolve_outer_special_vars_mutator(Node *node, void *context)
 	}
 
 	Var *var = castNode(Var, node);
-	CustomScan *custom = castNode(CustomScan, context);
-	if ((Index) var->varno == (Index) custom->scan.scanrelid)
+	Scan *scan = (Scan *) context;
+	if ((Index) var->varno == (Index) scan->scanrelid)
 	{
 		/*
 		 * This is already the uncompressed chunk var. We can see it referenced
@@ -172,10 +172,10 @@ resolve_outer_special_vars_mutator(Node *node, void *context)
 		/*
 		 * Reference into the output targetlist of the child scan node.
 		 */
-		TargetEntry *columnar_scan_tentry =
-			castNode(TargetEntry, list_nth(custom->scan.plan.targetlist, var->varattno - 1));
+		TargetEntry *scan_tentry =
+			castNode(TargetEntry, list_nth(scan->plan.targetlist, var->varattno - 1));
 
-		return resolve_outer_special_vars_mutator((Node *) columnar_scan_tentry->expr, context);
+		return resolve_outer_special_vars_mutator((Node *) scan_tentry->expr, context);
 	}
 
 	if (var->varno == INDEX_VAR)
@@ -184,6 +184,7 @@ resolve_outer_special_vars_mutator(Node *node, void *context)
 		 * This is a reference into the custom scan targetlist, we have to resolve
 		 * it as well.
 		 */
+		CustomScan *custom = castNode(CustomScan, context);
 		var = castNode(Var,
 					   castNode(TargetEntry, list_nth(custom->custom_scan_tlist, var->varattno - 1))
 						   ->expr);
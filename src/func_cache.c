@@ -127,6 +127,22 @@ time_bucket_tz_sort_transform(FuncExpr *func)
 	return do_sort_transform(func);
 }
 
+/*
+ * date_trunc with timezone will always have 3 args. The transform is only
+ * valid when both the truncation unit and the timezone are Consts, for the
+ * same reason as the time_bucket timezone variant above.
+ */
+static Expr *
+date_trunc_tz_sort_transform(FuncExpr *func)
+{
+	Assert(list_length(func->args) == 3);
+
+	if (!IsA(linitial(func->args), Const) || !IsA(lthird(func->args), Const))
+		return (Expr *) func;
+
+	return do_sort_transform(func);
+}
+
 /* For time_bucket this estimate currently works by seeing how many possible
  * buckets there will be if the data spans the entire hypertable. Note that
  * this is an overestimate.
@@ -486,6 +502,26 @@ static FuncInfo funcinfo[] = {
 		.group_estimate = NULL,
 		.sort_transform = NULL,
 	},
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "histogram",
+		.nargs = 4,
+		.arg_types = { FLOAT8OID, FLOAT8OID, FLOAT8OID, INT4OID },
+		.group_estimate = NULL,
+		.sort_transform = NULL,
+	},
+	{
+		.origin = ORIGIN_TIMESCALE,
+		.is_bucketing_func = false,
+		.allowed_in_cagg_definition = false,
+		.funcname = "approximate_count_distinct",
+		.nargs = 1,
+		.arg_types = { ANYELEMENTOID },
+		.group_estimate = NULL,
+		.sort_transform = NULL,
+	},
 
 	{
 		.origin = ORIGIN_POSTGRES,
@@ -507,12 +543,25 @@ static FuncInfo funcinfo[] = {
 		.group_estimate = date_trunc_group_estimate,
 		.sort_transform = date_trunc_sort_transform,
 	},
+	/* date_trunc with timezone */
+	{
+		.origin = ORIGIN_POSTGRES,
+		.is_bucketing_func = true,
+		.allowed_in_cagg_definition = false,
+		.funcname = "date_trunc",
+		.nargs = 3,
+		.arg_types = { TEXTOID, TIMESTAMPTZOID, TEXTOID },
+		.group_estimate = date_trunc_group_estimate,
+		.sort_transform = date_trunc_tz_sort_transform,
+	},
 };
 
 #define _MAX_CACHE_FUNCTIONS (sizeof(funcinfo) / sizeof(funcinfo[0]))
 
 Oid ts_first_func_oid = InvalidOid;
 Oid ts_last_func_oid = InvalidOid;
+Oid ts_histogram_func_oid = InvalidOid;
+Oid ts_approx_count_distinct_func_oid = InvalidOid;
 
 static HTAB *func_hash = NULL;
 
@@ -580,11 +629,15 @@ ts_func_cache_init()
 
 		funcid = proc_get_oid(tuple);
 
-		/* Special handling for first/last to set up named variables for their oids */
+		/* Special handling for some aggregates to set up named variables for their oids */
 		if (strcmp(finfo->funcname, "first") == 0)
 			ts_first_func_oid = funcid;
 		else if (strcmp(finfo->funcname, "last") == 0)
 			ts_last_func_oid = funcid;
+		else if (strcmp(finfo->funcname, "histogram") == 0)
+			ts_histogram_func_oid = funcid;
+		else if (strcmp(finfo->funcname, "approximate_count_distinct") == 0)
+			ts_approx_count_distinct_func_oid = funcid;
 
 		fentry = hash_search(func_hash, &funcid, HASH_ENTER, &hash_found);
 		Assert(!hash_found);
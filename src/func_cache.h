@@ -51,3 +51,5 @@ extern TSDLLEXPORT FuncInfo *ts_func_cache_get_bucketing_func(Oid funcid);
 
 extern TSDLLEXPORT Oid ts_first_func_oid;
 extern TSDLLEXPORT Oid ts_last_func_oid;
+extern TSDLLEXPORT Oid ts_histogram_func_oid;
+extern TSDLLEXPORT Oid ts_approx_count_distinct_func_oid;
@@ -74,6 +74,7 @@ bool ts_guc_enable_direct_compress_insert_sort_batches = true;
 TSDLLEXPORT bool ts_guc_enable_direct_compress_insert_client_sorted = false;
 TSDLLEXPORT bool ts_guc_enable_direct_compress_on_cagg_refresh = false;
 int ts_guc_direct_compress_insert_tuple_sort_limit = 10000;
+TSDLLEXPORT bool ts_guc_enable_insert_batching = false;
 bool ts_guc_enable_deprecation_warnings = true;
 bool ts_guc_enable_optimizations = true;
 bool ts_guc_restoring = false;
@@ -82,7 +83,9 @@ bool ts_guc_enable_ordered_append = true;
 bool ts_guc_enable_chunk_append = true;
 bool ts_guc_enable_parallel_chunk_append = true;
 bool ts_guc_enable_runtime_exclusion = true;
+bool ts_guc_enable_startup_exclusion_costing = false;
 bool ts_guc_enable_constraint_exclusion = true;
+bool ts_guc_enable_chunk_exclusion_cache = true;
 bool ts_guc_enable_qual_propagation = true;
 bool ts_guc_enable_qual_filtering = true;
 bool ts_guc_enable_cagg_reorder_groupby = true;
@@ -98,13 +101,19 @@ bool ts_guc_enable_osm_reads = true;
 TSDLLEXPORT bool ts_guc_enable_compressed_direct_batch_delete = true;
 TSDLLEXPORT bool ts_guc_enable_dml_decompression = true;
 TSDLLEXPORT bool ts_guc_enable_dml_decompression_tuple_filtering = true;
+TSDLLEXPORT bool ts_guc_enable_dml_decompression_key_caching = true;
+TSDLLEXPORT bool ts_guc_enable_dml_recompression = false;
 TSDLLEXPORT int ts_guc_max_tuples_decompressed_per_dml = 100000;
 TSDLLEXPORT bool ts_guc_enable_compression_wal_markers = false;
 TSDLLEXPORT bool ts_guc_enable_decompression_sorted_merge = true;
 bool ts_guc_enable_chunkwise_aggregation = true;
 bool ts_guc_enable_vectorized_aggregation = true;
+TSDLLEXPORT int ts_guc_vectorized_aggregation_memory_limit = 512;
+TSDLLEXPORT bool ts_guc_log_fastpath_decisions = false;
+TSDLLEXPORT int ts_guc_decompression_memory_limit = 0;
 TSDLLEXPORT bool ts_guc_enable_compression_indexscan = false;
 TSDLLEXPORT bool ts_guc_enable_bulk_decompression = true;
+TSDLLEXPORT bool ts_guc_enable_toast_prefetch = true;
 TSDLLEXPORT bool ts_guc_auto_sparse_indexes = true;
 TSDLLEXPORT bool ts_guc_enable_sparse_index_bloom = true;
 
@@ -116,6 +125,10 @@ TSDLLEXPORT bool ts_guc_enable_in_memory_recompression = true;
 TSDLLEXPORT bool ts_guc_enable_exclusive_locking_recompression = false;
 TSDLLEXPORT bool ts_guc_enable_bool_compression = true;
 TSDLLEXPORT bool ts_guc_enable_uuid_compression = true;
+TSDLLEXPORT bool ts_guc_enable_alp_compression = false;
+TSDLLEXPORT bool ts_guc_enable_rle_compression = false;
+TSDLLEXPORT bool ts_guc_enable_zstd_array_compression = false;
+TSDLLEXPORT bool ts_guc_enable_adaptive_compression = false;
 TSDLLEXPORT int ts_guc_compression_batch_size_limit = 1000;
 TSDLLEXPORT bool ts_guc_compression_enable_compressor_batch_limit = false;
 TSDLLEXPORT CompressTruncateBehaviour ts_guc_compress_truncate_behaviour = COMPRESS_TRUNCATE_ONLY;
@@ -131,6 +144,7 @@ TSDLLEXPORT bool ts_guc_enable_compression_ratio_warnings = true;
  * disabled, regular sequence scans will be used instead. */
 TSDLLEXPORT bool ts_guc_enable_columnarscan = true;
 TSDLLEXPORT bool ts_guc_enable_columnarindexscan = false;
+TSDLLEXPORT bool ts_guc_enable_columnarscan_tail_scan = true;
 TSDLLEXPORT int ts_guc_bgw_log_level = WARNING;
 TSDLLEXPORT bool ts_guc_enable_skip_scan = true;
 #if PG16_GE
@@ -145,6 +159,7 @@ TSDLLEXPORT bool ts_guc_enable_job_execution_logging = false;
 bool ts_guc_enable_tss_callbacks = true;
 TSDLLEXPORT bool ts_guc_enable_delete_after_compression = false;
 TSDLLEXPORT bool ts_guc_enable_merge_on_cagg_refresh = false;
+TSDLLEXPORT bool ts_guc_enable_cagg_refresh_range_transactions = true;
 
 bool ts_guc_enable_partitioned_hypertables = false;
 
@@ -600,6 +615,18 @@ _guc_init(void)
 							NULL,
 							NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_insert_batching"),
+							 "Enable multi-insert batching during INSERT",
+							 "Enable experimental support for buffering plain INSERT ... SELECT "
+							 "through the COPY multi-insert machinery",
+							 &ts_guc_enable_insert_batching,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_optimizations"),
 							 "Enable TimescaleDB query optimizations",
 							 NULL,
@@ -680,6 +707,19 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_startup_exclusion_costing"),
+							 "Account for startup chunk exclusion when costing generic plans",
+							 "Cost ChunkAppend nodes in generic plans as if startup exclusion "
+							 "had already pruned the chunks that cannot match the parameter "
+							 "values, so cached generic plans can compete with custom plans",
+							 &ts_guc_enable_startup_exclusion_costing,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_constraint_exclusion"),
 							 "Enable constraint exclusion",
 							 "Enable planner constraint exclusion",
@@ -691,6 +731,17 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_chunk_exclusion_cache"),
+							 "Enable caching of chunk exclusion results",
+							 "Enable reusing chunk exclusion results across planning cycles",
+							 &ts_guc_enable_chunk_exclusion_cache,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_foreign_key_propagation"),
 							 "Enable foreign key propagation",
 							 "Adjust foreign key lookup queries to target whole hypertable",
@@ -748,6 +799,18 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_dml_decompression_key_caching"),
+							 "Enable DML decompression key caching",
+							 "Skip repeated conflict probes when consecutive inserted tuples "
+							 "carry the same unique key values",
+							 &ts_guc_enable_dml_decompression_key_caching,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_compressed_direct_batch_delete"),
 							 "Enable direct deletion of compressed batches",
 							 "Enable direct batch deletion in compressed chunks",
@@ -939,6 +1002,35 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_cagg_refresh_range_transactions"),
+							 "Enable per-range transactions on cagg refresh",
+							 "Materialize each invalidated range of a continuous aggregate "
+							 "refresh in its own transaction so that concurrent refreshes can "
+							 "consume the remaining ranges",
+							 &ts_guc_enable_cagg_refresh_range_transactions,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable(MAKE_EXTOPTION("materializations_per_refresh_window"),
+							"Max number of materializations per cagg refresh window",
+							"The maximum number of individual invalidated ranges that are "
+							"materialized separately during a continuous aggregate refresh. "
+							"If more ranges are invalidated, the ones closest together are "
+							"merged until the limit is met. Set to 0 for no limit.",
+							&ts_guc_cagg_max_individual_materializations,
+							10,
+							0,
+							2147483647,
+							PGC_USERSET,
+							0,
+							NULL,
+							NULL,
+							NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_chunk_skipping"),
 							 "Enable chunk skipping functionality",
 							 "Enable using chunk column stats to filter chunks based on column "
@@ -961,6 +1053,17 @@ _guc_init(void)
 							 NULL,
 							 NULL,
 							 NULL);
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_dml_recompression"),
+							 "Enable recompression after DML on compressed chunks",
+							 "Recompress chunks that were partially decompressed by an "
+							 "UPDATE at the end of the statement",
+							 &ts_guc_enable_dml_recompression,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_in_memory_recompression"),
 							 "Enable in-memory recompression functionality",
 							 "Enable in-memory recompression",
@@ -1005,6 +1108,54 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_alp_compression"),
+							 "Enable alp compression functionality",
+							 "Use the alp algorithm as the default for float columns",
+							 &ts_guc_enable_alp_compression,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_rle_compression"),
+							 "Enable rle compression functionality",
+							 "Use the run-length encoding algorithm as the default for types "
+							 "that fall back to dictionary or array compression",
+							 &ts_guc_enable_rle_compression,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_zstd_array_compression"),
+							 "Enable zstd array compression functionality",
+							 "Use the zstd-backed array algorithm as the default for types "
+							 "that fall back to array compression",
+							 &ts_guc_enable_zstd_array_compression,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_adaptive_compression"),
+							 "Enable adaptive compression algorithm selection",
+							 "Trial-compress the first batch of each column with the "
+							 "alternative algorithm for its type and keep whichever "
+							 "compresses better for the rest of the chunk",
+							 &ts_guc_enable_adaptive_compression,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomIntVariable(MAKE_EXTOPTION("compression_batch_size_limit"),
 							"The max number of tuples that can be batched together during "
 							"compression",
@@ -1117,6 +1268,56 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomIntVariable(MAKE_EXTOPTION("vectorized_aggregation_memory_limit"),
+							"Memory limit for the vectorized hash grouping",
+							"When the grouping keys and the aggregate function states of the "
+							"vectorized hash aggregation exceed this limit, the partial "
+							"aggregation results are emitted and the hash table is reset. "
+							"A larger limit reduces the number of duplicate partial results "
+							"that have to be combined by the upper aggregation node, which "
+							"helps when grouping by a high-cardinality column.",
+							&ts_guc_vectorized_aggregation_memory_limit,
+							512,
+							64,
+							MAX_KILOBYTES,
+							PGC_USERSET,
+							GUC_UNIT_KB,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomIntVariable(MAKE_EXTOPTION("decompression_memory_limit"),
+							"Memory budget for the batches of a columnar scan",
+							"When the memory held by the open decompressed batches of a "
+							"columnar scan exceeds this limit, the scan falls back to "
+							"row-by-row decompression, which is slower but has a much "
+							"smaller memory high-water mark. The limit applies to each "
+							"scan node separately. 0 means no limit.",
+							&ts_guc_decompression_memory_limit,
+							0,
+							0,
+							MAX_KILOBYTES,
+							PGC_USERSET,
+							GUC_UNIT_KB,
+							NULL,
+							NULL,
+							NULL);
+
+	DefineCustomBoolVariable(MAKE_EXTOPTION("log_fastpath_decisions"),
+							 "Log fast-path planning decisions for hypertable queries",
+							 "Emit one log line per planned statement that touches hypertable "
+							 "chunks, reporting how many scans use ColumnarScan versus row-by-row "
+							 "decompression and whether the aggregation was vectorized, keyed by "
+							 "the query identifier. Useful for diffing fast-path coverage across "
+							 "releases.",
+							 &ts_guc_log_fastpath_decisions,
+							 false,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_compression_indexscan"),
 							 "Enable compression to take indexscan path",
 							 "Enable indexscan during compression, if matching index is found",
@@ -1140,6 +1341,19 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_toast_prefetch"),
+							 "Enable prefetching of out-of-line compressed data",
+							 "Issue prefetch requests for the toast blocks of the compressed "
+							 "columns before decompressing a batch, so that the reads overlap "
+							 "with the decompression of the preceding columns",
+							 &ts_guc_enable_toast_prefetch,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomBoolVariable(MAKE_EXTOPTION("auto_sparse_indexes"),
 							 "Create sparse indexes on compressed chunks",
 							 "The hypertable columns that are used as index keys will have "
@@ -1203,6 +1417,18 @@ _guc_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomBoolVariable(MAKE_EXTOPTION("enable_columnarscan_tail_scan"),
+							 "Enable uncompressed tail scan inside ColumnarScan",
+							 "Let ColumnarScan stream the uncompressed part of a partially "
+							 "compressed chunk itself instead of appending a separate scan",
+							 &ts_guc_enable_columnarscan_tail_scan,
+							 true,
+							 PGC_USERSET,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
 	DefineCustomIntVariable(MAKE_EXTOPTION("max_open_chunks_per_insert"),
 							"Maximum open chunks per insert",
 							"Maximum number of open chunk tables per insert",
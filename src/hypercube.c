@@ -335,6 +335,42 @@ ts_hypercube_calculate_from_point(const Hyperspace *hs, const Point *p, const Sc
 	return cube;
 }
 
+/*
+ * Calculate the hypercube that would enclose the given point under the
+ * current partitioning configuration alone, without consulting the dimension
+ * slice catalog.
+ *
+ * The resulting ranges are deterministic for a given point and partitioning
+ * configuration, but the slices carry no ids, and existing slices whose
+ * ranges differ from the default ones (e.g. after a chunk interval change in
+ * an aligned dimension) are not discovered. Use this when only the ranges
+ * matter, such as for computing the chunk-creation advisory lock tag, and
+ * ts_hypercube_calculate_from_point() when the hypercube is used to actually
+ * create a chunk.
+ */
+Hypercube *
+ts_hypercube_calculate_default_from_point(const Hyperspace *hs, const Point *p)
+{
+	Hypercube *cube = ts_hypercube_alloc(hs->num_dimensions);
+	int i;
+
+	for (i = 0; i < hs->num_dimensions; i++)
+	{
+		const Dimension *dim = &hs->dimensions[i];
+
+		/* Assert that dimensions are in ascending order */
+		Assert(i == 0 || dim->fd.id > hs->dimensions[i - 1].fd.id);
+
+		cube->slices[i] = ts_dimension_calculate_default_slice(dim, p->coordinates[i]);
+	}
+
+	cube->num_slices = hs->num_dimensions;
+
+	Assert(hypercube_is_sorted(cube));
+
+	return cube;
+}
+
 /*
  * Check if two hypercubes collide (overlap).
  *
@@ -355,3 +391,21 @@ ts_hypercubes_collide(const Hypercube *cube1, const Hypercube *cube2)
 
 	return true;
 }
+
+/*
+ * Check if a point lies within the hypercube, i.e., if the coordinate in
+ * every dimension falls in the corresponding dimension slice.
+ */
+bool
+ts_hypercube_contains_point(const Hypercube *hc, const Point *p)
+{
+	int i;
+
+	Assert(hc->num_slices == p->cardinality);
+
+	for (i = 0; i < hc->num_slices; i++)
+		if (ts_dimension_slice_cmp_coordinate(hc->slices[i], p->coordinates[i]) != 0)
+			return false;
+
+	return true;
+}
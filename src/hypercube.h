@@ -38,7 +38,9 @@ extern Hypercube *ts_hypercube_from_constraints(const ChunkConstraints *constrai
 extern int ts_hypercube_find_existing_slices(const Hypercube *cube, const ScanTupLock *tuplock);
 extern Hypercube *ts_hypercube_calculate_from_point(const Hyperspace *hs, const Point *p,
 													const ScanTupLock *tuplock);
+extern Hypercube *ts_hypercube_calculate_default_from_point(const Hyperspace *hs, const Point *p);
 extern bool ts_hypercubes_collide(const Hypercube *cube1, const Hypercube *cube2);
+extern TSDLLEXPORT bool ts_hypercube_contains_point(const Hypercube *hc, const Point *p);
 extern TSDLLEXPORT const DimensionSlice *ts_hypercube_get_slice_by_dimension_id(const Hypercube *hc,
 																				int32 dimension_id);
 extern TSDLLEXPORT Hypercube *ts_hypercube_copy(const Hypercube *hc);
@@ -0,0 +1,292 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+#include <common/hashfn.h>
+#include <libpq/pqformat.h>
+#include <math.h>
+#include <utils/lsyscache.h>
+
+#include "compat/compat.h"
+#include "hyperloglog.h"
+#include "utils.h"
+
+/* aggregate approximate_count_distinct:
+ *	 approximate_count_distinct(value) returns the approximate number of
+ *	 distinct non-null values, as a bigint.
+ *
+ * Usage:
+ *	 SELECT grouping_element, approximate_count_distinct(field) FROM table
+ *	 GROUP BY grouping_element.
+ *
+ * Description:
+ * A HyperLogLog sketch over the binary representation of the values. Unlike
+ * count(DISTINCT ...), the state is small and mergeable, so the aggregation
+ * is parallelizable and doesn't have to sort the input. The distinctness is
+ * that of the binary representation of the values, which matches the normal
+ * equality for the usual key types such as integers, timestamps or uuids.
+ */
+
+TS_FUNCTION_INFO_V1(ts_hyperloglog_sfunc);
+TS_FUNCTION_INFO_V1(ts_hyperloglog_combinefunc);
+TS_FUNCTION_INFO_V1(ts_hyperloglog_serializefunc);
+TS_FUNCTION_INFO_V1(ts_hyperloglog_deserializefunc);
+TS_FUNCTION_INFO_V1(ts_hyperloglog_finalfunc);
+
+typedef struct HyperLogLog
+{
+	uint8 registers[TS_HLL_NREGISTERS];
+} HyperLogLog;
+
+/* The argument type information, cached between the transition calls. */
+typedef struct HyperLogLogTypeInfo
+{
+	int16 typlen;
+	bool typbyval;
+} HyperLogLogTypeInfo;
+
+/*
+ * Hash the canonical binary representation of the value. For the by-value
+ * types this is the native representation of the proper width, for the
+ * varlena types the detoasted data bytes without the header. This matches the
+ * bytes of the respective decompressed columnar representation that is hashed
+ * by the vectorized implementation.
+ */
+static uint64
+hyperloglog_hash_datum(Datum value, const HyperLogLogTypeInfo *type_info)
+{
+	if (type_info->typbyval)
+	{
+		switch (type_info->typlen)
+		{
+			case 1:
+			{
+				const char tmp = DatumGetChar(value);
+				return hash_bytes_extended((const unsigned char *) &tmp, 1, /* seed = */ 0);
+			}
+			case 2:
+			{
+				const int16 tmp = DatumGetInt16(value);
+				return hash_bytes_extended((const unsigned char *) &tmp, 2, /* seed = */ 0);
+			}
+			case 4:
+			{
+				const int32 tmp = DatumGetInt32(value);
+				return hash_bytes_extended((const unsigned char *) &tmp, 4, /* seed = */ 0);
+			}
+			case 8:
+			{
+				const int64 tmp = DatumGetInt64(value);
+				return hash_bytes_extended((const unsigned char *) &tmp, 8, /* seed = */ 0);
+			}
+			default:
+				elog(ERROR, "unexpected by-value type length %d", type_info->typlen);
+		}
+	}
+
+	if (type_info->typlen == -1)
+	{
+		struct varlena *detoasted = PG_DETOAST_DATUM_PACKED(value);
+		return hash_bytes_extended((const unsigned char *) VARDATA_ANY(detoasted),
+								   VARSIZE_ANY_EXHDR(detoasted),
+								   /* seed = */ 0);
+	}
+
+	if (type_info->typlen == -2)
+	{
+		const char *str = DatumGetCString(value);
+		return hash_bytes_extended((const unsigned char *) str, strlen(str), /* seed = */ 0);
+	}
+
+	Assert(type_info->typlen > 0);
+	return hash_bytes_extended((const unsigned char *) DatumGetPointer(value),
+							   type_info->typlen,
+							   /* seed = */ 0);
+}
+
+/* approximate_count_distinct(state, value) */
+Datum
+ts_hyperloglog_sfunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	HyperLogLog *state = (HyperLogLog *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		ereport(ERROR, (errmsg("ts_hyperloglog_sfunc called in non-aggregate context")));
+	}
+
+	if (PG_ARGISNULL(1))
+	{
+		/* The null values are not counted, same as in count(DISTINCT ...). */
+		if (state == NULL)
+		{
+			PG_RETURN_NULL();
+		}
+		PG_RETURN_POINTER(state);
+	}
+
+	HyperLogLogTypeInfo *type_info = (HyperLogLogTypeInfo *) fcinfo->flinfo->fn_extra;
+	if (type_info == NULL)
+	{
+		const Oid value_type = get_fn_expr_argtype(fcinfo->flinfo, 1);
+		if (!OidIsValid(value_type))
+		{
+			elog(ERROR, "could not determine the argument type of ts_hyperloglog_sfunc");
+		}
+
+		type_info =
+			MemoryContextAlloc(fcinfo->flinfo->fn_mcxt, sizeof(HyperLogLogTypeInfo));
+		get_typlenbyval(value_type, &type_info->typlen, &type_info->typbyval);
+		fcinfo->flinfo->fn_extra = type_info;
+	}
+
+	if (state == NULL)
+	{
+		state = MemoryContextAllocZero(aggcontext, sizeof(HyperLogLog));
+	}
+
+	ts_hyperloglog_insert(state->registers,
+						  hyperloglog_hash_datum(PG_GETARG_DATUM(1), type_info));
+
+	PG_RETURN_POINTER(state);
+}
+
+/* ts_hyperloglog_combinefunc(internal, internal) => internal */
+Datum
+ts_hyperloglog_combinefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	HyperLogLog *state1 = (HyperLogLog *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+	HyperLogLog *state2 = (HyperLogLog *) (PG_ARGISNULL(1) ? NULL : PG_GETARG_POINTER(1));
+	HyperLogLog *result;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_hyperloglog_combinefunc called in non-aggregate context");
+	}
+
+	if (state1 == NULL && state2 == NULL)
+	{
+		PG_RETURN_NULL();
+	}
+
+	result = MemoryContextAlloc(aggcontext, sizeof(HyperLogLog));
+
+	if (state2 == NULL)
+	{
+		memcpy(result->registers, state1->registers, TS_HLL_NREGISTERS);
+	}
+	else if (state1 == NULL)
+	{
+		memcpy(result->registers, state2->registers, TS_HLL_NREGISTERS);
+	}
+	else
+	{
+		/* The union of two sketches keeps the maximum of each register. */
+		for (int i = 0; i < TS_HLL_NREGISTERS; i++)
+		{
+			result->registers[i] = Max(state1->registers[i], state2->registers[i]);
+		}
+	}
+
+	PG_RETURN_POINTER(result);
+}
+
+/* ts_hyperloglog_serializefunc(internal) => bytea */
+Datum
+ts_hyperloglog_serializefunc(PG_FUNCTION_ARGS)
+{
+	HyperLogLog *state;
+	StringInfoData buf;
+
+	Assert(!PG_ARGISNULL(0));
+	state = (HyperLogLog *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, TS_HLL_NREGISTERS);
+	pq_sendbytes(&buf, (const char *) state->registers, TS_HLL_NREGISTERS);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/* ts_hyperloglog_deserializefunc(bytea, internal) => internal */
+Datum
+ts_hyperloglog_deserializefunc(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	bytea *serialized;
+	int32 nregisters;
+	StringInfoData buf;
+	HyperLogLog *state;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+	{
+		elog(ERROR, "ts_hyperloglog_deserializefunc called in non-aggregate context");
+	}
+
+	Assert(!PG_ARGISNULL(0));
+	serialized = PG_GETARG_BYTEA_P(0);
+
+	buf.data = VARDATA(serialized);
+	buf.len = VARSIZE(serialized) - VARHDRSZ;
+	buf.maxlen = VARSIZE(serialized) - VARHDRSZ;
+	buf.cursor = 0; /* used by pq_getmsgint */
+
+	nregisters = pq_getmsgint(&buf, 4);
+	if (nregisters != TS_HLL_NREGISTERS)
+	{
+		elog(ERROR, "number of registers must not change between calls");
+	}
+
+	state = MemoryContextAlloc(aggcontext, sizeof(HyperLogLog));
+	memcpy(state->registers, pq_getmsgbytes(&buf, TS_HLL_NREGISTERS), TS_HLL_NREGISTERS);
+
+	PG_RETURN_POINTER(state);
+}
+
+/* ts_hyperloglog_finalfunc(internal) => bigint */
+Datum
+ts_hyperloglog_finalfunc(PG_FUNCTION_ARGS)
+{
+	HyperLogLog *state;
+	double sum = 0;
+	int zeros = 0;
+	const double m = TS_HLL_NREGISTERS;
+	double estimate;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "ts_hyperloglog_finalfunc called in non-aggregate context");
+	}
+
+	state = (HyperLogLog *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (state == NULL)
+	{
+		/* No non-null values were aggregated. */
+		PG_RETURN_INT64(0);
+	}
+
+	for (int i = 0; i < TS_HLL_NREGISTERS; i++)
+	{
+		sum += ldexp(1.0, -((int) state->registers[i]));
+		zeros += state->registers[i] == 0;
+	}
+
+	/* The raw HyperLogLog estimate with the usual bias correction factor. */
+	estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+
+	if (estimate <= 2.5 * m && zeros > 0)
+	{
+		/* Linear counting gives a better estimate for small cardinalities. */
+		estimate = m * log(m / zeros);
+	}
+
+	PG_RETURN_INT64((int64) rint(estimate));
+}
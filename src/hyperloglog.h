@@ -0,0 +1,40 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+#include <port/pg_bitutils.h>
+
+/*
+ * Shared definitions for the HyperLogLog sketch used by the
+ * approximate_count_distinct() aggregate. The row-by-row implementation lives
+ * in src/hyperloglog.c, and the vectorized one in
+ * tsl/src/nodes/vector_agg/function/hyperloglog_functions.c. Both have to
+ * hash the values in the same way, and to update the registers in the same
+ * way, so that their partial aggregation results can be merged.
+ *
+ * With 2^14 registers the standard error of the estimate is about 0.8%, and
+ * the dense register array takes 16 KiB per aggregate state.
+ */
+#define TS_HLL_PRECISION 14
+#define TS_HLL_NREGISTERS (1 << TS_HLL_PRECISION)
+
+/*
+ * Add one hashed value to the sketch. The topmost bits of the hash select the
+ * register, and the register keeps the maximum rank, which is the position of
+ * the leftmost one-bit in the rest of the hash, counted from one.
+ */
+static inline void
+ts_hyperloglog_insert(uint8 *registers, uint64 hash)
+{
+	const uint32 index = hash >> (64 - TS_HLL_PRECISION);
+	const uint64 rest = hash << TS_HLL_PRECISION;
+	const uint8 rank = rest == 0 ? (64 - TS_HLL_PRECISION + 1) : (64 - pg_leftmost_one_pos64(rest));
+	if (registers[index] < rank)
+	{
+		registers[index] = rank;
+	}
+}
@@ -35,6 +35,7 @@
 #include <storage/lmgr.h>
 #include <utils/acl.h>
 #include <utils/builtins.h>
+#include <utils/inval.h>
 #include <utils/lsyscache.h>
 #include <utils/memutils.h>
 #include <utils/snapmgr.h>
@@ -425,6 +426,26 @@ hypertable_scan_limit_internal(ScanKeyData *scankey, int num_scankeys, int index
  * This ensures correct tuple locking and tuple updates in the presence of
  * concurrent transactions. Failure to follow this results in catalog corruption
  */
+/*
+ * Signal backends to evict their cached entry for an updated hypertable.
+ *
+ * An update of an existing hypertable row does not flush the whole hypertable
+ * cache (see ts_catalog_invalidate_cache()). Instead the relcache entry of
+ * the hypertable's root table is invalidated, and the relcache invalidation
+ * callback routes the relid to ts_hypertable_cache_invalidate_relid() so
+ * that only the affected entry is evicted. When the root table cannot be
+ * resolved, e.g., during a rename where the pg_class update has not happened
+ * yet, the rename itself invalidates the relation's relcache entry.
+ */
+static void
+hypertable_invalidate_entry(const FormData_hypertable *fd)
+{
+	Oid relid = ts_get_relation_relid(NameStr(fd->schema_name), NameStr(fd->table_name), true);
+
+	if (OidIsValid(relid))
+		CacheInvalidateRelcacheByRelid(relid);
+}
+
 static void
 hypertable_update_catalog_tuple(ItemPointer tid, FormData_hypertable *update)
 {
@@ -436,6 +457,7 @@ hypertable_update_catalog_tuple(ItemPointer tid, FormData_hypertable *update)
 
 	new_tuple = hypertable_formdata_make_tuple(update, hypertable_rel->rd_att);
 
+	hypertable_invalidate_entry(update);
 	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
 	ts_catalog_update_tid(hypertable_rel, tid, new_tuple);
 	ts_catalog_restore_user(&sec_ctx);
@@ -782,6 +804,7 @@ reset_associated_tuple_found(TupleInfo *ti, void *data)
 	ts_hypertable_formdata_fill(&fd, ti);
 	namestrcpy(&fd.associated_schema_name, INTERNAL_SCHEMA_NAME);
 	new_tuple = hypertable_formdata_make_tuple(&fd, ts_scanner_get_tupledesc(ti));
+	hypertable_invalidate_entry(&fd);
 	ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
 	ts_catalog_update_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti), new_tuple);
 	ts_catalog_restore_user(&sec_ctx);
@@ -2003,6 +2026,7 @@ hypertable_rename_schema_name(TupleInfo *ti, void *data)
 	if (updated)
 	{
 		HeapTuple new_tuple = hypertable_formdata_make_tuple(&fd, ts_scanner_get_tupledesc(ti));
+		hypertable_invalidate_entry(&fd);
 		ts_catalog_update_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti), new_tuple);
 		heap_freetuple(new_tuple);
 	}
@@ -39,8 +39,22 @@ typedef struct
 {
 	Oid relid;
 	Hypertable *hypertable;
+	/*
+	 * Private memory context the hypertable is built on, a child of the
+	 * cache's context. It allows a per-relid eviction to reclaim the entry's
+	 * memory without tearing down the whole cache. NULL for negative entries.
+	 */
+	MemoryContext mcxt;
 } HypertableCacheEntry;
 
+/*
+ * Memory contexts of entries that were evicted while the cache was pinned.
+ * Pins may still hold pointers into such entries, so freeing is deferred
+ * until no pins remain. The list cells live in the cache's memory context
+ * and die with it on a full invalidation, together with the entry contexts.
+ */
+static List *dead_entry_mcxts = NIL;
+
 static bool
 hypertable_cache_valid_result(const void *result)
 {
@@ -104,18 +118,24 @@ hypertable_cache_create_entry(Cache *cache, CacheQuery *query)
 	if (NULL == hq->table)
 		hq->table = get_rel_name(hq->relid);
 
+	cache_entry->mcxt = AllocSetContextCreate(ts_cache_memory_ctx(cache),
+											  "hypertable cache entry",
+											  ALLOCSET_SMALL_SIZES);
+
 	number_found = ts_hypertable_scan_with_memory_context(hq->schema,
 														  hq->table,
 														  hypertable_tuple_found,
 														  query->result,
 														  AccessShareLock,
-														  ts_cache_memory_ctx(cache));
+														  cache_entry->mcxt);
 
 	switch (number_found)
 	{
 		case 0:
 			/* Negative cache entry: table is not a hypertable */
 			cache_entry->hypertable = NULL;
+			MemoryContextDelete(cache_entry->mcxt);
+			cache_entry->mcxt = NULL;
 			break;
 		case 1:
 			Assert(strncmp(NameStr(cache_entry->hypertable->fd.schema_name),
@@ -152,10 +172,50 @@ hypertable_cache_missing_error(const Cache *cache, const CacheQuery *query)
 void
 ts_hypertable_cache_invalidate_callback(void)
 {
+	/*
+	 * The deferred entry contexts are children of the cache's context and die
+	 * with it, so just drop the references.
+	 */
+	dead_entry_mcxts = NIL;
 	ts_cache_invalidate(&hypertable_cache_current);
 	hypertable_cache_current = hypertable_cache_create();
 }
 
+/*
+ * Evict the cache entry for a single relation, if present.
+ *
+ * Used for updates of existing hypertable catalog rows, which concern exactly
+ * one hypertable and do not warrant flushing every backend's entire cache.
+ * Removing the hash entry makes the next lookup rebuild this hypertable's
+ * metadata. The entry's memory context is freed right away when the cache is
+ * not pinned; otherwise pins may still hold pointers into the entry, so
+ * freeing is deferred until the last pin is gone. This is called from the
+ * relcache invalidation callback and must not query the relcache or syscache.
+ */
+void
+ts_hypertable_cache_invalidate_relid(Oid relid)
+{
+	Cache *cache = hypertable_cache_current;
+	HypertableCacheEntry *entry;
+
+	if (cache == NULL || cache->htab == NULL)
+		return;
+
+	entry = hash_search(cache->htab, &relid, HASH_REMOVE, NULL);
+
+	if (entry == NULL || entry->mcxt == NULL)
+		return;
+
+	if (cache->refcount > 1)
+	{
+		MemoryContext old = MemoryContextSwitchTo(ts_cache_memory_ctx(cache));
+		dead_entry_mcxts = lappend(dead_entry_mcxts, entry->mcxt);
+		MemoryContextSwitchTo(old);
+	}
+	else
+		MemoryContextDelete(entry->mcxt);
+}
+
 #ifdef TS_DEBUG
 TS_FUNCTION_INFO_V1(ts_hypertable_cache_clear);
 
@@ -231,6 +291,21 @@ ts_hypertable_cache_get_entry_with_table(Cache *cache, const Oid relid, const ch
 extern TSDLLEXPORT Cache *
 ts_hypertable_cache_pin()
 {
+	/*
+	 * With no pins outstanding, nobody can hold pointers into entries that
+	 * were evicted while the cache was pinned, so reclaim their memory now.
+	 */
+	if (dead_entry_mcxts != NIL && hypertable_cache_current->refcount == 1)
+	{
+		ListCell *lc;
+
+		foreach (lc, dead_entry_mcxts)
+			MemoryContextDelete(lfirst(lc));
+
+		list_free(dead_entry_mcxts);
+		dead_entry_mcxts = NIL;
+	}
+
 	return ts_cache_pin(hypertable_cache_current);
 }
 
@@ -244,5 +319,6 @@ _hypertable_cache_init(void)
 void
 _hypertable_cache_fini(void)
 {
+	dead_entry_mcxts = NIL;
 	ts_cache_invalidate(&hypertable_cache_current);
 }
@@ -6,12 +6,16 @@
 #include <postgres.h>
 
 #include <catalog/pg_inherits.h>
+#include <common/hashfn.h>
+#include <lib/stringinfo.h>
 #include <optimizer/optimizer.h>
 #include <parser/parsetree.h>
 #include <tcop/tcopprot.h>
 #include <utils/array.h>
 #include <utils/builtins.h>
+#include <utils/hsearch.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/typcache.h>
 
 #include "hypertable_restrict_info.h"
@@ -193,6 +197,13 @@ dimension_restrict_info_get_partitions(DimensionRestrictInfoClosed *dri, Oid col
 		partitions = list_append_unique_int(partitions, DatumGetInt32(value));
 	}
 
+	/*
+	 * Sort the partition values so that the dimension slice scans proceed in
+	 * index order and IN-lists that only differ in element order produce the
+	 * same exclusion cache key.
+	 */
+	list_sort(partitions, list_int_cmp);
+
 	return partitions;
 }
 
@@ -485,7 +496,7 @@ ts_hypertable_restrict_info_add(HypertableRestrictInfo *hri, PlannerInfo *root,
  * scan and start again.
  */
 static DimensionVec *
-scan_and_append_slices(ScanIterator *it, int old_nkeys, DimensionVec **dv, bool unique)
+scan_and_append_slices(ScanIterator *it, int old_nkeys, DimensionVec **dv)
 {
 	if (old_nkeys != -1 && old_nkeys != it->ctx.nkeys)
 		ts_scan_iterator_end(it);
@@ -498,12 +509,7 @@ scan_and_append_slices(ScanIterator *it, int old_nkeys, DimensionVec **dv, bool
 		DimensionSlice *slice = ts_dimension_slice_from_tuple(ti);
 
 		if (NULL != slice)
-		{
-			if (unique)
-				*dv = ts_dimension_vec_add_unique_slice(dv, slice);
-			else
-				*dv = ts_dimension_vec_add_slice(dv, slice);
-		}
+			*dv = ts_dimension_vec_add_slice(dv, slice);
 	}
 
 	return *dv;
@@ -564,7 +570,7 @@ gather_restriction_dimension_vectors(const HypertableRestrictInfo *hri)
 										   BackwardScanDirection :
 										   ForwardScanDirection;
 
-				dv = scan_and_append_slices(&it, old_nkeys, &dv, false);
+				dv = scan_and_append_slices(&it, old_nkeys, &dv);
 				break;
 			}
 			case DIMENSION_TYPE_CLOSED:
@@ -592,7 +598,7 @@ gather_restriction_dimension_vectors(const HypertableRestrictInfo *hri)
 															   BTGreaterEqualStrategyNumber,
 															   partition);
 
-					dv = scan_and_append_slices(&it, old_nkeys, &dv, true);
+					dv = scan_and_append_slices(&it, old_nkeys, &dv);
 				}
 				break;
 			}
@@ -623,7 +629,16 @@ gather_restriction_dimension_vectors(const HypertableRestrictInfo *hri)
 			return NIL;
 		}
 
-		dv = ts_dimension_vec_sort(&dv);
+		/*
+		 * The scans for the individual partition values of a closed dimension
+		 * can return the same slice multiple times, so sort and deduplicate
+		 * in one pass instead of checking for duplicates on every insertion,
+		 * which is quadratic for long IN-lists.
+		 */
+		if (dri->dimension->type == DIMENSION_TYPE_CLOSED)
+			dv = ts_dimension_vec_sort_unique(&dv);
+		else
+			dv = ts_dimension_vec_sort(&dv);
 		dimension_vecs = lappend(dimension_vecs, dv);
 		old_nkeys = it.ctx.nkeys;
 	}
@@ -635,6 +650,189 @@ gather_restriction_dimension_vectors(const HypertableRestrictInfo *hri)
 	return dimension_vecs;
 }
 
+/*
+ * Per-backend cache of chunk exclusion results.
+ *
+ * On hypertables with many chunks, most of the planning time for a simple
+ * query goes into rescanning the dimension slice catalog and searching the
+ * subspace to recompute the same set of surviving chunk ids. Cache the
+ * resulting chunk id list, keyed on the hypertable and the normalized
+ * dimension restrictions, so that repeated planning cycles can skip the
+ * catalog scans entirely.
+ *
+ * The cache is tied into the regular cache invalidation machinery: any
+ * signal on the hypertable cache proxy table (chunk creation and deletion,
+ * dimension slice changes, transaction aborts) bumps the generation counter,
+ * and the whole cache is rebuilt lazily on the next lookup.
+ */
+#define CHUNK_EXCLUSION_CACHE_MAX_ENTRIES 128
+
+typedef struct ChunkExclusionCacheEntry
+{
+	uint32 hash;   /* lookup key: hash of the normalized restriction key */
+	int key_len;   /* the full key is kept for exact comparison to guard */
+	char *key_data; /* against hash collisions */
+	List *chunk_ids;
+} ChunkExclusionCacheEntry;
+
+static HTAB *chunk_exclusion_cache = NULL;
+static MemoryContext chunk_exclusion_cache_mcxt = NULL;
+
+/*
+ * Bumped on every invalidation. Discarding the stale entries is deferred to
+ * the next lookup, so that the invalidation callback itself does no work.
+ */
+static uint64 chunk_exclusion_cache_generation = 0;
+static uint64 chunk_exclusion_cache_built_generation = 0;
+
+void
+ts_chunk_exclusion_cache_invalidate(void)
+{
+	chunk_exclusion_cache_generation++;
+}
+
+static HTAB *
+chunk_exclusion_cache_get_htab(void)
+{
+	if (chunk_exclusion_cache != NULL &&
+		chunk_exclusion_cache_built_generation == chunk_exclusion_cache_generation)
+		return chunk_exclusion_cache;
+
+	if (chunk_exclusion_cache_mcxt == NULL)
+		chunk_exclusion_cache_mcxt = AllocSetContextCreate(CacheMemoryContext,
+														   "chunk exclusion cache",
+														   ALLOCSET_DEFAULT_SIZES);
+	else
+	{
+		chunk_exclusion_cache = NULL;
+		MemoryContextReset(chunk_exclusion_cache_mcxt);
+	}
+
+	HASHCTL ctl = {
+		.keysize = sizeof(uint32),
+		.entrysize = sizeof(ChunkExclusionCacheEntry),
+		.hcxt = chunk_exclusion_cache_mcxt,
+	};
+
+	chunk_exclusion_cache = hash_create("chunk exclusion cache",
+										16,
+										&ctl,
+										HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	chunk_exclusion_cache_built_generation = chunk_exclusion_cache_generation;
+
+	return chunk_exclusion_cache;
+}
+
+/*
+ * Serialize the hypertable and its non-trivial dimension restrictions into a
+ * byte string identifying this exclusion problem. The restrictions arrive in
+ * dimension order and open restrictions are already normalized to internal
+ * time values, so syntactically different but equivalent clause lists map to
+ * the same key.
+ */
+static void
+chunk_exclusion_cache_key(StringInfo key, const HypertableRestrictInfo *hri, const Hypertable *ht)
+{
+	appendBinaryStringInfo(key, (const char *) &ht->fd.id, sizeof(ht->fd.id));
+
+	for (int i = 0; i < hri->num_dimensions; i++)
+	{
+		const DimensionRestrictInfo *dri = hri->dimension_restriction[i];
+		const char type = dri->dimension->type;
+
+		appendBinaryStringInfo(key, (const char *) &dri->dimension->fd.id, sizeof(dri->dimension->fd.id));
+		appendBinaryStringInfo(key, (const char *) &type, sizeof(type));
+
+		switch (dri->dimension->type)
+		{
+			case DIMENSION_TYPE_OPEN:
+			case DIMENSION_TYPE_STATS:
+			{
+				const DimensionRestrictInfoOpen *open =
+					(const DimensionRestrictInfoOpen *) dri;
+
+				appendBinaryStringInfo(key,
+									   (const char *) &open->lower_strategy,
+									   sizeof(open->lower_strategy));
+				appendBinaryStringInfo(key, (const char *) &open->lower_bound, sizeof(open->lower_bound));
+				appendBinaryStringInfo(key,
+									   (const char *) &open->upper_strategy,
+									   sizeof(open->upper_strategy));
+				appendBinaryStringInfo(key, (const char *) &open->upper_bound, sizeof(open->upper_bound));
+				break;
+			}
+			case DIMENSION_TYPE_CLOSED:
+			{
+				const DimensionRestrictInfoClosed *closed =
+					(const DimensionRestrictInfoClosed *) dri;
+				ListCell *lc;
+
+				appendBinaryStringInfo(key, (const char *) &closed->strategy, sizeof(closed->strategy));
+				foreach (lc, closed->partitions)
+				{
+					int partition = lfirst_int(lc);
+
+					appendBinaryStringInfo(key, (const char *) &partition, sizeof(partition));
+				}
+				break;
+			}
+			default:
+				elog(ERROR, "unknown dimension type");
+		}
+	}
+}
+
+static List *
+chunk_exclusion_cache_lookup(StringInfo key, bool *found)
+{
+	HTAB *htab = chunk_exclusion_cache_get_htab();
+	uint32 hash = hash_bytes((const unsigned char *) key->data, key->len);
+	ChunkExclusionCacheEntry *entry = hash_search(htab, &hash, HASH_FIND, NULL);
+
+	*found = entry != NULL && entry->key_len == key->len &&
+			 memcmp(entry->key_data, key->data, key->len) == 0;
+
+	return *found ? list_copy(entry->chunk_ids) : NIL;
+}
+
+static void
+chunk_exclusion_cache_store(StringInfo key, List *chunk_ids)
+{
+	HTAB *htab = chunk_exclusion_cache_get_htab();
+	uint32 hash = hash_bytes((const unsigned char *) key->data, key->len);
+	ChunkExclusionCacheEntry *entry;
+	MemoryContext oldcxt;
+	bool found;
+
+	/*
+	 * Queries with ever-changing constant bounds (e.g. "> now() - ...")
+	 * produce a new key on every execution. Cap the cache size by simply
+	 * starting over when it fills up; the hot entries are rebuilt on the
+	 * next planning cycle.
+	 */
+	if (hash_get_num_entries(htab) >= CHUNK_EXCLUSION_CACHE_MAX_ENTRIES)
+	{
+		chunk_exclusion_cache_generation++;
+		htab = chunk_exclusion_cache_get_htab();
+	}
+
+	entry = hash_search(htab, &hash, HASH_ENTER, &found);
+
+	if (found)
+	{
+		/* Hash collision with an existing entry; replace its payload. */
+		pfree(entry->key_data);
+		list_free(entry->chunk_ids);
+	}
+
+	oldcxt = MemoryContextSwitchTo(chunk_exclusion_cache_mcxt);
+	entry->key_len = key->len;
+	entry->key_data = palloc(key->len);
+	memcpy(entry->key_data, key->data, key->len);
+	entry->chunk_ids = list_copy(chunk_ids);
+	MemoryContextSwitchTo(oldcxt);
+}
+
 Chunk **
 ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *ht,
 									   bool include_osm, unsigned int *num_chunks)
@@ -658,7 +856,30 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 	}
 
 	List *chunk_ids = NIL;
-	if (hri->num_dimensions == 0)
+	int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
+
+	/*
+	 * The cached result is only valid for hypertables without an OSM chunk.
+	 * The OSM path below takes tuple locks on the OSM dimension slice that
+	 * we must not skip.
+	 */
+	bool use_cache =
+		ts_guc_enable_chunk_exclusion_cache && osm_chunk_id == INVALID_CHUNK_ID;
+	StringInfoData key = { 0 };
+	bool cache_hit = false;
+
+	if (use_cache)
+	{
+		initStringInfo(&key);
+		chunk_exclusion_cache_key(&key, hri, ht);
+		chunk_ids = chunk_exclusion_cache_lookup(&key, &cache_hit);
+	}
+
+	if (cache_hit)
+	{
+		/* Reuse the chunk id list from a previous planning cycle. */
+	}
+	else if (hri->num_dimensions == 0)
 	{
 		/*
 		 * No restrictions on hyperspace. Just enumerate all the chunks.
@@ -672,8 +893,6 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 		 */
 		if (!include_osm || !ts_guc_enable_osm_reads)
 		{
-			int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
-
 			chunk_ids = list_delete_int(chunk_ids, osm_chunk_id);
 		}
 	}
@@ -697,8 +916,6 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 			chunk_ids = ts_chunk_id_find_in_subspace(ht, dimension_vectors);
 		}
 
-		int32 osm_chunk_id = ts_chunk_get_osm_chunk_id(ht->fd.id);
-
 		if (osm_chunk_id != INVALID_CHUNK_ID)
 		{
 			if (!ts_guc_enable_osm_reads)
@@ -742,6 +959,9 @@ ts_hypertable_restrict_info_get_chunks(HypertableRestrictInfo *hri, Hypertable *
 	 */
 	list_sort(chunk_ids, list_int_cmp);
 
+	if (use_cache && !cache_hit)
+		chunk_exclusion_cache_store(&key, chunk_ids);
+
 	return ts_chunk_scan_by_chunk_ids(ht->space, chunk_ids, num_chunks);
 }
 
@@ -41,6 +41,9 @@ typedef struct HypertableRestrictInfo
 
 extern HypertableRestrictInfo *ts_hypertable_restrict_info_create(RelOptInfo *rel, Hypertable *ht);
 
+/* Invalidate the per-backend cache of chunk exclusion results */
+extern void ts_chunk_exclusion_cache_invalidate(void);
+
 /* Add restrictions based on a List of RestrictInfo */
 extern void ts_hypertable_restrict_info_add(HypertableRestrictInfo *hri, PlannerInfo *root,
 											List *base_restrict_infos);
@@ -143,6 +143,21 @@ ts_set_append_rel_pathlist(PlannerInfo *root, RelOptInfo *parent_rel, Index pare
 	List *live_childrels = NIL;
 	ListCell *l;
 
+	/*
+	 * Classify the parent once instead of re-classifying every child: the
+	 * children reached through our hypertable expansion are all chunks of the
+	 * same hypertable, so whether the per-child compression check below is
+	 * needed only depends on the parent. The check can be skipped entirely
+	 * for hypertables that have no internal compression table, since none of
+	 * their chunks can be compressed. This matters at high chunk counts,
+	 * where any per-chunk lookup shows up in planning time.
+	 */
+	Hypertable *ht;
+	TsRelType parent_reltype = ts_classify_relation(root, parent_rel, &ht);
+	bool check_compressed =
+		(parent_reltype == TS_REL_HYPERTABLE && !TS_HYPERTABLE_IS_INTERNAL_COMPRESSION_TABLE(ht) &&
+		 TS_HYPERTABLE_HAS_COMPRESSION_TABLE(ht));
+
 	/*
 	 * Generate access paths for each member relation, and remember the
 	 * non-dummy children.
@@ -158,6 +173,7 @@ ts_set_append_rel_pathlist(PlannerInfo *root, RelOptInfo *parent_rel, Index pare
 		/* Re-locate the child RTE and RelOptInfo */
 		const int child_rt_index = appinfo->child_relid;
 		RelOptInfo *child_rel = root->simple_rel_array[child_rt_index];
+		RangeTblEntry *child_rte = root->simple_rte_array[child_rt_index];
 
 		/*
 		 * If set_append_rel_size() decided the parent appendrel was
@@ -173,19 +189,14 @@ ts_set_append_rel_pathlist(PlannerInfo *root, RelOptInfo *parent_rel, Index pare
 		 * tables of fully compressed chunks. It would be expensive and useless
 		 * because the uncompressed chunk tables are empty in this case.
 		 *
-		 * Note about the 'if' condition: compressed chunk tables expanded from
-		 * normal hypertables always have the type TS_REL_CHUNK_STANDALONE. The
-		 * direct select from a compressed chunk table would also produce this
-		 * type. Another possibility is a direct select from an internal
-		 * compression hypertable, where the compressed chunks would have the
-		 * type TS_REL_CHUNK_CHILD. We have to filter out all these cases here.
+		 * Foreign children (e.g. OSM chunks) are managed by a different
+		 * extension and are left alone.
 		 *
 		 * For standalone chunks or UPDATE/DELETE, we do the same thing in
 		 * timescaledb_get_relation_info_hook().
 		 */
-		Hypertable *ht;
-		TsRelType reltype = ts_classify_relation(root, child_rel, &ht);
-		if (reltype == TS_REL_CHUNK_CHILD && !TS_HYPERTABLE_IS_INTERNAL_COMPRESSION_TABLE(ht))
+		if (check_compressed && child_rte->relkind != RELKIND_FOREIGN_TABLE &&
+			OidIsValid(child_rte->relid))
 		{
 			const Chunk *chunk = ts_planner_chunk_fetch(root, child_rel);
 
@@ -204,7 +215,6 @@ ts_set_append_rel_pathlist(PlannerInfo *root, RelOptInfo *parent_rel, Index pare
 		/*
 		 * Compute the child's access paths.
 		 */
-		RangeTblEntry *child_rte = root->simple_rte_array[child_rt_index];
 		set_rel_pathlist(root, child_rel, child_rt_index, child_rte);
 
 		/*
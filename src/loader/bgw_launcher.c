@@ -37,6 +37,9 @@
 /* for looking up sending proc information for message handling */
 #include <storage/procarray.h>
 
+/* for timing the periodic database list polls */
+#include <utils/timestamp.h>
+
 /* for allocating the htab storage */
 #include <utils/memutils.h>
 
@@ -877,22 +880,45 @@ ts_bgw_cluster_launcher_main(PG_FUNCTION_ARGS)
 	 */
 	terminate_backends_by_backend_type(TS_BGW_TYPE_SCHEDULER);
 	populate_database_htab(db_htab);
+	TimestampTz last_db_scan = GetCurrentTimestamp();
 
 	while (true)
 	{
 		int wl_rc;
 		bool handled_msgs = false;
+		TimestampTz now;
 
 		CHECK_FOR_INTERRUPTS();
-		populate_database_htab(db_htab);
+
+		/*
+		 * All database and extension lifecycle events that we know how to
+		 * intercept arrive through the message queue, so rescan the database
+		 * list only when the poll interval has elapsed. The scan remains
+		 * necessary as a catch-up mechanism for databases we get no message
+		 * for, e.g. ones created from a template that already has the
+		 * extension installed. Messages can arrive in bursts, and rescanning
+		 * pg_database for each one just burns cycles.
+		 */
+		now = GetCurrentTimestamp();
+		if (TimestampDifferenceExceeds(last_db_scan, now, ts_guc_bgw_launcher_poll_time))
+		{
+			populate_database_htab(db_htab);
+			last_db_scan = now;
+		}
+
 		handled_msgs = launcher_handle_message(db_htab);
 		scheduler_state_trans_automatic_all(db_htab);
 		if (handled_msgs)
 			continue;
 
+		/* Sleep until the next database list poll is due, or until a message
+		 * sender sets our latch. */
 		wl_rc = WaitLatch(MyLatch,
 						  WL_LATCH_SET | WL_POSTMASTER_DEATH | WL_TIMEOUT,
-						  (long) ts_guc_bgw_launcher_poll_time,
+						  TimestampDifferenceMilliseconds(
+							  GetCurrentTimestamp(),
+							  TimestampTzPlusMilliseconds(last_db_scan,
+														  ts_guc_bgw_launcher_poll_time)),
 						  PG_WAIT_EXTENSION);
 		ResetLatch(MyLatch);
 		if (wl_rc & WL_POSTMASTER_DEATH)
@@ -0,0 +1,101 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+
+#include <postgres.h>
+#include <fmgr.h>
+
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+
+#include "loader/invalidation_threshold_cache.h"
+
+/*
+ * Shared-memory cache of continuous aggregate invalidation thresholds.
+ *
+ * Since shared memory can only be set up in a library loaded via
+ * shared_preload_libraries, the loader allocates the hash table and hands it
+ * to the versioned extension through a rendezvous variable. All cache
+ * semantics (what may be written when) live with the accessors in the
+ * versioned extension, see src/ts_catalog/invalidation_threshold_cache.c.
+ */
+
+static InvalThresholdCacheRendezvous rendezvous;
+
+void
+ts_invalidation_threshold_cache_shmem_startup()
+{
+	InvalThresholdCacheRendezvous **rendezvous_ptr;
+	HASHCTL hash_info;
+	HTAB *threshold_hash;
+	LWLock **lock;
+	bool found;
+
+	hash_info.keysize = sizeof(InvalThresholdCacheKey);
+	hash_info.entrysize = sizeof(InvalThresholdCacheEntry);
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+
+	/*
+	 * GetNamedLWLockTranche must only be run once on windows, otherwise it
+	 * segfaults. Since the shmem_startup_hook is run on every backend, we use
+	 * a ShmemInitStruct to detect if this function has been called before.
+	 */
+	lock = (LWLock **) ShmemInitStruct("inval_threshold_cache_detect_first_run",
+									   sizeof(LWLock *),
+									   &found);
+	if (!found)
+		*lock = &(GetNamedLWLockTranche(INVAL_THRESHOLD_CACHE_LWLOCK_TRANCHE_NAME))->lock;
+
+	threshold_hash = ShmemInitHash("timescaledb invalidation threshold cache",
+								   INVAL_THRESHOLD_CACHE_SIZE,
+								   INVAL_THRESHOLD_CACHE_SIZE,
+								   &hash_info,
+								   HASH_ELEM | HASH_BLOBS);
+	LWLockRelease(AddinShmemInitLock);
+
+	rendezvous.lock = *lock;
+	rendezvous.hash = threshold_hash;
+
+	rendezvous_ptr = (InvalThresholdCacheRendezvous **) find_rendezvous_variable(
+		RENDEZVOUS_INVAL_THRESHOLD_CACHE);
+	*rendezvous_ptr = &rendezvous;
+}
+
+/*
+ * Drop all cache entries belonging to a database.
+ *
+ * Called by the loader when the database or the extension in it is dropped,
+ * so that entries do not outlive the catalog rows they cache (a database
+ * recreated from a dump must not see thresholds from before the drop) and so
+ * that the fixed-size table is not clogged by dead databases.
+ */
+void
+ts_invalidation_threshold_cache_clear_db(Oid dboid)
+{
+	HASH_SEQ_STATUS status;
+	InvalThresholdCacheEntry *entry;
+
+	if (rendezvous.hash == NULL)
+		return;
+
+	LWLockAcquire(rendezvous.lock, LW_EXCLUSIVE);
+	hash_seq_init(&status, rendezvous.hash);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (entry->key.dboid == dboid)
+			hash_search(rendezvous.hash, &entry->key, HASH_REMOVE, NULL);
+	}
+	LWLockRelease(rendezvous.lock);
+}
+
+void
+ts_invalidation_threshold_cache_shmem_alloc()
+{
+	Size size =
+		hash_estimate_size(INVAL_THRESHOLD_CACHE_SIZE, sizeof(InvalThresholdCacheEntry));
+	RequestAddinShmemSpace(add_size(size, sizeof(LWLock *)));
+	RequestNamedLWLockTranche(INVAL_THRESHOLD_CACHE_LWLOCK_TRANCHE_NAME, 1);
+}
@@ -0,0 +1,47 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+
+#include <port/atomics.h>
+#include <storage/lwlock.h>
+#include <utils/hsearch.h>
+
+#define RENDEZVOUS_INVAL_THRESHOLD_CACHE "ts_invalidation_threshold_cache"
+#define INVAL_THRESHOLD_CACHE_LWLOCK_TRANCHE_NAME "ts_invalidation_threshold_cache_lwlock_tranche"
+
+/*
+ * Size of the shared invalidation threshold cache. One entry is used per
+ * hypertable with continuous aggregates that receives writes, across all
+ * databases of the cluster. When the cache is full, additional hypertables
+ * simply fall back to reading the threshold from the catalog.
+ */
+#define INVAL_THRESHOLD_CACHE_SIZE 1024
+
+typedef struct InvalThresholdCacheKey
+{
+	Oid dboid;
+	int32 hypertable_id;
+} InvalThresholdCacheKey;
+
+typedef struct InvalThresholdCacheEntry
+{
+	InvalThresholdCacheKey key;
+	/* Stores an int64 threshold; a uint64 atomic is used since there is no
+	 * signed variant. */
+	pg_atomic_uint64 threshold;
+} InvalThresholdCacheEntry;
+
+typedef struct InvalThresholdCacheRendezvous
+{
+	LWLock *lock;
+	HTAB *hash;
+} InvalThresholdCacheRendezvous;
+
+void ts_invalidation_threshold_cache_shmem_alloc(void);
+void ts_invalidation_threshold_cache_shmem_startup(void);
+void ts_invalidation_threshold_cache_clear_db(Oid dboid);
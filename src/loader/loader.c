@@ -39,6 +39,7 @@
 #include "loader/bgw_launcher.h"
 #include "loader/bgw_message_queue.h"
 #include "loader/function_telemetry.h"
+#include "loader/invalidation_threshold_cache.h"
 #include "loader/loader.h"
 #include "loader/lwlocks.h"
 
@@ -397,6 +398,7 @@ stop_workers_on_db_drop(DropdbStmt *drop_db_statement)
 				(errmsg("TimescaleDB background worker scheduler for database %u will be stopped",
 						dropped_db_oid)));
 		ts_bgw_message_send_and_wait(STOP, dropped_db_oid);
+		ts_invalidation_threshold_cache_clear_db(dropped_db_oid);
 	}
 }
 
@@ -511,6 +513,14 @@ post_analyze_hook(ParseState *pstate, Query *query, JumbleState *jstate)
 						 * a rollback) the scheduler
 						 */
 						ts_bgw_message_send_and_wait(RESTART, MyDatabaseId);
+
+						/*
+						 * Also drop the cached invalidation thresholds for this
+						 * database, since the catalog rows they cache go away
+						 * with the extension. Dropping them on a rollback is
+						 * harmless; they repopulate on the next read.
+						 */
+						ts_invalidation_threshold_cache_clear_db(MyDatabaseId);
 						break;
 					}
 				}
@@ -588,6 +598,7 @@ timescaledb_shmem_startup_hook(void)
 	ts_bgw_message_queue_shmem_startup();
 	ts_lwlocks_shmem_startup();
 	ts_function_telemetry_shmem_startup();
+	ts_invalidation_threshold_cache_shmem_startup();
 }
 
 /*
@@ -605,6 +616,7 @@ timescaledb_shmem_request_hook(void)
 	ts_bgw_message_queue_alloc();
 	ts_lwlocks_shmem_alloc();
 	ts_function_telemetry_shmem_alloc();
+	ts_invalidation_threshold_cache_shmem_alloc();
 }
 
 static void
@@ -27,6 +27,8 @@ typedef struct Connection
 #endif
 	ConnOps *ops;
 	int err;
+	/* I/O timeout in milliseconds, used for the latch-based socket waits */
+	unsigned long timeout_millis;
 } Connection;
 
 extern Connection *ts_connection_create(ConnectionType type);
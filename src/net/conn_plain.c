@@ -9,6 +9,10 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 
+#include <miscadmin.h>
+#include <storage/latch.h>
+#include <utils/wait_event.h>
+
 #include "compat/compat.h"
 #include "conn_internal.h"
 #include "conn_plain.h"
@@ -37,6 +41,49 @@ get_error(void)
 #endif
 }
 
+/*
+ * Wait for the connection's socket to become ready for the given events
+ * (WL_SOCKET_READABLE and/or WL_SOCKET_WRITEABLE), or until the connection's
+ * I/O timeout expires.
+ *
+ * The wait includes the process latch, so a background worker blocked on
+ * network I/O still reacts promptly to interrupts and postmaster death
+ * instead of sitting in a blocking send()/recv() for the full socket
+ * timeout and occupying its worker slot while idle-waiting.
+ *
+ * Returns 0 when the socket is ready, or -1 with the error set on timeout.
+ */
+int
+ts_plain_wait(Connection *conn, uint32 events)
+{
+	long timeout_millis =
+		conn->timeout_millis > 0 ? (long) conn->timeout_millis : DEFAULT_TIMEOUT_MSEC;
+
+	for (;;)
+	{
+		int rc = WaitLatchOrSocket(MyLatch,
+								   WL_LATCH_SET | WL_EXIT_ON_PM_DEATH | WL_TIMEOUT | events,
+								   conn->sock,
+								   timeout_millis,
+								   PG_WAIT_EXTENSION);
+
+		if (rc & WL_LATCH_SET)
+		{
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+			continue;
+		}
+
+		if (rc & WL_TIMEOUT)
+		{
+			set_error(ETIMEDOUT);
+			return -1;
+		}
+
+		return 0;
+	}
+}
+
 /*  Create socket and connect */
 int
 ts_plain_connect(Connection *conn, const char *host, const char *servname, int port)
@@ -119,8 +166,38 @@ ts_plain_connect(Connection *conn, const char *host, const char *servname, int p
 #ifdef WIN32
 	ret = WSAConnect(conn->sock, ainfo->ai_addr, ainfo->ai_addrlen, NULL, NULL, NULL, NULL);
 #else
-	/* connect the socket */
+	/*
+	 * Connect without blocking. A slow or unresponsive endpoint, such as a
+	 * stalled egress proxy, would otherwise hold the calling process in
+	 * connect() until the TCP connection timeout. With a non-blocking socket
+	 * we instead wait with the latch and check the outcome afterwards. The
+	 * socket stays non-blocking, so all subsequent reads and writes go
+	 * through the latch-based waits as well.
+	 */
+	if (!pg_set_noblock(conn->sock))
+	{
+		ret = SOCKET_ERROR;
+		goto out_addrinfo;
+	}
+
 	ret = connect(conn->sock, ainfo->ai_addr, ainfo->ai_addrlen);
+
+	if (ret < 0 && errno == EINPROGRESS)
+	{
+		int so_error = 0;
+		socklen_t so_len = sizeof(so_error);
+
+		ret = ts_plain_wait(conn, WL_SOCKET_WRITEABLE);
+
+		if (ret == 0)
+			ret = getsockopt(conn->sock, SOL_SOCKET, SO_ERROR, &so_error, &so_len);
+
+		if (ret == 0 && so_error != 0)
+		{
+			set_error(so_error);
+			ret = SOCKET_ERROR;
+		}
+	}
 #endif
 
 out_addrinfo:
@@ -154,7 +231,26 @@ plain_write(Connection *conn, const char *buf, size_t writelen)
 	else
 		ret = b;
 #else
-	ret = send(conn->sock, buf, writelen, 0);
+	for (;;)
+	{
+		ret = send(conn->sock, buf, writelen, 0);
+
+		if (ret >= 0)
+			break;
+
+		if (errno == EINTR)
+			continue;
+
+		if (errno != EWOULDBLOCK && errno != EAGAIN)
+			break;
+
+		/* No buffer space, wait for the socket without blocking in send() */
+		if (ts_plain_wait(conn, WL_SOCKET_WRITEABLE) < 0)
+		{
+			ret = -1;
+			break;
+		}
+	}
 
 	if (ret < 0)
 		conn->err = ret;
@@ -181,7 +277,26 @@ plain_read(Connection *conn, char *buf, size_t buflen)
 	else
 		ret = b;
 #else
-	ret = recv(conn->sock, buf, buflen, 0);
+	for (;;)
+	{
+		ret = recv(conn->sock, buf, buflen, 0);
+
+		if (ret >= 0)
+			break;
+
+		if (errno == EINTR)
+			continue;
+
+		if (errno != EWOULDBLOCK && errno != EAGAIN)
+			break;
+
+		/* No data yet, wait for the socket without blocking in recv() */
+		if (ts_plain_wait(conn, WL_SOCKET_READABLE) < 0)
+		{
+			ret = -1;
+			break;
+		}
+	}
 
 	if (ret < 0)
 		conn->err = ret;
@@ -217,9 +332,14 @@ ts_plain_set_timeout(Connection *conn, unsigned long millis)
 	int optlen = sizeof(struct timeval);
 #endif
 
+	/* Used as the timeout for the latch-based socket waits */
+	conn->timeout_millis = millis;
+
 	/*
-	 * Set send / recv timeout so that write and read don't block forever. Set
-	 * separately so that one of the actions failing doesn't block the other.
+	 * Also set the socket-level send / recv timeouts. They only apply where
+	 * the socket operates in blocking mode (Windows), but are harmless on a
+	 * non-blocking socket. Set separately so that one of the actions failing
+	 * doesn't block the other.
 	 */
 	conn->err = setsockopt(conn->sock, SOL_SOCKET, SO_RCVTIMEO, (const char *) &timeout, optlen);
 
@@ -17,4 +17,5 @@ typedef struct Connection Connection;
 extern int ts_plain_connect(Connection *conn, const char *host, const char *servname, int port);
 extern void ts_plain_close(Connection *conn);
 extern int ts_plain_set_timeout(Connection *conn, unsigned long millis);
+extern int ts_plain_wait(Connection *conn, uint32 events);
 extern const char *ts_plain_errmsg(Connection *conn);
@@ -8,6 +8,8 @@
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 
+#include <storage/latch.h>
+
 #include "conn_internal.h"
 #include "conn_plain.h"
 
@@ -47,8 +49,9 @@ ssl_ctx_create(void)
 #endif
 
 	/*
-	 * Because we have a blocking socket, we don't want to be bothered with
-	 * retries.
+	 * SSL_MODE_AUTO_RETRY hides renegotiation retries on a blocking socket
+	 * (Windows). On the non-blocking socket the WANT_READ/WANT_WRITE retries
+	 * are handled with latch-based waits in ssl_wait_for_retry().
 	 */
 	if (NULL != ctx)
 	{
@@ -59,6 +62,28 @@ ssl_ctx_create(void)
 	return ctx;
 }
 
+/*
+ * Handle an SSL operation that did not complete because the underlying
+ * non-blocking socket had no data or no buffer space, by waiting for the
+ * socket with the latch.
+ *
+ * Returns true if the operation should be retried, false if it failed for a
+ * different reason or the wait timed out.
+ */
+static bool
+ssl_wait_for_retry(SSLConnection *conn, int ret)
+{
+	switch (SSL_get_error(conn->ssl, ret))
+	{
+		case SSL_ERROR_WANT_READ:
+			return ts_plain_wait(&conn->conn, WL_SOCKET_READABLE) == 0;
+		case SSL_ERROR_WANT_WRITE:
+			return ts_plain_wait(&conn->conn, WL_SOCKET_WRITEABLE) == 0;
+		default:
+			return false;
+	}
+}
+
 static int
 ssl_setup(SSLConnection *conn, const char *host)
 {
@@ -101,12 +126,19 @@ ssl_setup(SSLConnection *conn, const char *host)
 		return -1;
 	}
 
-	ret = SSL_connect(conn->ssl);
-
-	if (ret <= 0)
+	for (;;)
 	{
-		ssl_set_error(conn, ret);
-		ret = -1;
+		ERR_clear_error();
+		ret = SSL_connect(conn->ssl);
+
+		if (ret > 0)
+			break;
+
+		if (!ssl_wait_for_retry(conn, ret))
+		{
+			ssl_set_error(conn, ret);
+			return -1;
+		}
 	}
 
 	return ret;
@@ -130,11 +162,23 @@ static ssize_t
 ssl_write(Connection *conn, const char *buf, size_t writelen)
 {
 	SSLConnection *sslconn = (SSLConnection *) conn;
+	int ret;
 
-	int ret = SSL_write(sslconn->ssl, buf, writelen);
+	for (;;)
+	{
+		ERR_clear_error();
+		ret = SSL_write(sslconn->ssl, buf, writelen);
 
-	if (ret < 0)
-		ssl_set_error(sslconn, ret);
+		if (ret > 0)
+			break;
+
+		if (!ssl_wait_for_retry(sslconn, ret))
+		{
+			if (ret < 0)
+				ssl_set_error(sslconn, ret);
+			break;
+		}
+	}
 
 	return ret;
 }
@@ -143,11 +187,23 @@ static ssize_t
 ssl_read(Connection *conn, char *buf, size_t buflen)
 {
 	SSLConnection *sslconn = (SSLConnection *) conn;
+	int ret;
 
-	int ret = SSL_read(sslconn->ssl, buf, buflen);
+	for (;;)
+	{
+		ERR_clear_error();
+		ret = SSL_read(sslconn->ssl, buf, buflen);
 
-	if (ret < 0)
-		ssl_set_error(sslconn, ret);
+		if (ret > 0)
+			break;
+
+		if (!ssl_wait_for_retry(sslconn, ret))
+		{
+			if (ret < 0)
+				ssl_set_error(sslconn, ret);
+			break;
+		}
+	}
 
 	return ret;
 }
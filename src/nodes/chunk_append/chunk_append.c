@@ -5,6 +5,7 @@
  */
 #include <postgres.h>
 #include <nodes/nodeFuncs.h>
+#include <optimizer/cost.h>
 #include <optimizer/optimizer.h>
 #include <optimizer/pathnode.h>
 #include <optimizer/paths.h>
@@ -37,6 +38,33 @@ has_joins(FromExpr *jointree)
 	return list_length(jointree->fromlist) != 1 || !IsA(linitial(jointree->fromlist), RangeTblRef);
 }
 
+/*
+ * Check whether a clause references a partitioning column of the hypertable.
+ * Only such clauses can lead to chunk exclusion.
+ */
+static bool
+clause_refs_partitioning_column(const RelOptInfo *rel, const Hypertable *ht, Node *clause)
+{
+	ListCell *lc;
+
+	foreach (lc, pull_var_clause(clause, 0))
+	{
+		Var *var = lfirst(lc);
+
+		/*
+		 * varattno 0 is whole row and varattno less than zero are
+		 * system columns so we skip those even though
+		 * ts_is_partitioning_column would return the correct
+		 * answer for those as well
+		 */
+		if ((Index) var->varno == rel->relid && var->varattno > 0 &&
+			ts_is_partitioning_column(ht, var->varattno))
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * Create the appropriate subpath for the outer MergeAppend
  * node depending on the number of paths in the current group:
@@ -150,6 +178,7 @@ ts_chunk_append_path_create(PlannerInfo *root, RelOptInfo *rel, Hypertable *ht,
 	/*
 	 * check if we should do startup and runtime exclusion
 	 */
+	List *param_exclusion_clauses = NIL;
 	foreach (lc, rel->baserestrictinfo)
 	{
 		RestrictInfo *rinfo = (RestrictInfo *) lfirst(lc);
@@ -165,12 +194,18 @@ ts_chunk_append_path_create(PlannerInfo *root, RelOptInfo *rel, Hypertable *ht,
 			ts_contains_external_param((Node *) rinfo->clause))
 		{
 			path->startup_exclusion = true;
+
+			/*
+			 * Remember the parameterized clauses that can actually exclude
+			 * chunks; they are used below to cost generic plans.
+			 */
+			if (ts_contains_external_param((Node *) rinfo->clause) &&
+				clause_refs_partitioning_column(rel, ht, (Node *) rinfo->clause))
+				param_exclusion_clauses = lappend(param_exclusion_clauses, rinfo);
 		}
 
 		if (ts_guc_enable_runtime_exclusion && ts_contains_join_param((Node *) rinfo->clause))
 		{
-			ListCell *lc_var;
-
 			/* We have two types of exclusion:
 			 *
 			 * Parent exclusion fires if the entire hypertable can be excluded.
@@ -190,22 +225,8 @@ ts_chunk_append_path_create(PlannerInfo *root, RelOptInfo *rel, Hypertable *ht,
 			 *
 			 */
 			path->runtime_exclusion_parent = true;
-			foreach (lc_var, pull_var_clause((Node *) rinfo->clause, 0))
-			{
-				Var *var = lfirst(lc_var);
-				/*
-				 * varattno 0 is whole row and varattno less than zero are
-				 * system columns so we skip those even though
-				 * ts_is_partitioning_column would return the correct
-				 * answer for those as well
-				 */
-				if ((Index) var->varno == rel->relid && var->varattno > 0 &&
-					ts_is_partitioning_column(ht, var->varattno))
-				{
-					path->runtime_exclusion_children = true;
-					break;
-				}
-			}
+			if (clause_refs_partitioning_column(rel, ht, (Node *) rinfo->clause))
+				path->runtime_exclusion_children = true;
 		}
 	}
 	/*
@@ -436,6 +457,33 @@ ts_chunk_append_path_create(PlannerInfo *root, RelOptInfo *rel, Hypertable *ht,
 	path->cpath.path.rows = rows;
 	path->cpath.path.total_cost = total_cost;
 
+	/*
+	 * When a generic plan is created for a prepared statement, no parameter
+	 * values are known and the append contains all chunks, so the cost sum
+	 * above vastly overestimates the actual execution cost: startup exclusion
+	 * prunes the chunks that cannot match the bound parameter values before
+	 * any of them is scanned. With the full cost the plan cache always
+	 * prefers custom plans and replans on every execution. When enabled,
+	 * cost the node as if only the expected fraction of chunks survives
+	 * startup exclusion, so that cached generic plans become competitive.
+	 */
+	if (ts_guc_enable_startup_exclusion_costing && path->startup_exclusion &&
+		param_exclusion_clauses != NIL && root->glob->boundParams == NULL)
+	{
+		int nchunks = list_length(path->cpath.custom_paths);
+
+		if (nchunks > 1)
+		{
+			Selectivity selectivity =
+				clauselist_selectivity(root, param_exclusion_clauses, 0, JOIN_INNER, NULL);
+			double surviving_chunks = clamp_row_est(selectivity * nchunks);
+
+			if (surviving_chunks < nchunks)
+				path->cpath.path.total_cost = total_cost * (surviving_chunks / nchunks) +
+											  cpu_operator_cost * nchunks;
+		}
+	}
+
 	if (path->cpath.custom_paths != NIL)
 		path->cpath.path.startup_cost = ((Path *) linitial(path->cpath.custom_paths))->startup_cost;
 
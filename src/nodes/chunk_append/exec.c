@@ -20,6 +20,7 @@
 #include <parser/parsetree.h>
 #include <rewrite/rewriteManip.h>
 #include <utils/builtins.h>
+#include <utils/hsearch.h>
 #include <utils/memutils.h>
 #include <utils/ruleutils.h>
 #include <utils/typcache.h>
@@ -40,6 +41,32 @@
 #define INVALID_SUBPLAN_INDEX (-1)
 #define NO_MATCHING_SUBPLANS (-2)
 
+/*
+ * Runtime exclusion results are memoized per distinct parameter values, so a
+ * parameterized rescan (e.g. the inner side of a nested loop) does not re-prove
+ * the same exclusions for every outer row. The cache only covers plans whose
+ * exclusion-relevant parameters are few and of by-value types, which holds for
+ * the typical case of time and space partitioning columns.
+ */
+#define EXCLUSION_CACHE_MAX_PARAMS 8
+#define EXCLUSION_CACHE_MAX_ENTRIES 1024
+
+typedef struct ExclusionCacheKey
+{
+	Datum values[EXCLUSION_CACHE_MAX_PARAMS];
+	bool isnull[EXCLUSION_CACHE_MAX_PARAMS];
+} ExclusionCacheKey;
+
+typedef struct ExclusionCacheEntry
+{
+	ExclusionCacheKey key;
+	/* surviving subplans, indexed like subplanstates; allocated in the cache
+	 * memory context */
+	Bitmapset *valid_subplans;
+	bool excluded_parent;
+	int excluded_children;
+} ExclusionCacheEntry;
+
 typedef enum SubplanState
 {
 	SUBPLAN_STATE_INCLUDED = 1 << 0, /* Used and not removed by startup exclusion */
@@ -60,6 +87,7 @@ typedef enum SubplanState
  */
 typedef struct ParallelChunkAppendState
 {
+	/* next position in the local dispatch_order array to hand out */
 	int next_plan;
 	int filtered_first_partial_plan;
 	uint32 subplan_state[FLEXIBLE_ARRAY_MEMBER]; /* See SubplanState */
@@ -110,6 +138,13 @@ typedef struct ChunkAppendState
 	Bitmapset *valid_subplans;
 	Bitmapset *params;
 
+	/* memoized runtime exclusion results per parameter values */
+	MemoryContext exclusion_cache_ctx;
+	HTAB *exclusion_cache;
+	int *cache_param_ids; /* exclusion-relevant exec param ids, ascending */
+	int cache_num_params;
+	bool exclusion_cache_checked;
+
 	/* sort options if this append is ordered, only used for EXPLAIN */
 	List *sort_options;
 
@@ -118,6 +153,14 @@ typedef struct ChunkAppendState
 	int runtime_number_exclusions_parent;
 	int runtime_number_exclusions_children;
 
+	/*
+	 * Order in which subplans are handed out to parallel workers: non-partial
+	 * subplans in descending cost order, then the partial ones. Starting the
+	 * most expensive chunks first avoids one straggler worker finishing a
+	 * large chunk long after the others have run out of work.
+	 */
+	int *dispatch_order;
+
 	LWLock *lock;
 	ParallelContext *pcxt;
 	ParallelChunkAppendState *pstate;
@@ -152,10 +195,24 @@ static CustomExecMethods chunk_append_state_methods = {
 
 static void choose_next_subplan_non_parallel(ChunkAppendState *state);
 static void choose_next_subplan_for_worker(ChunkAppendState *state);
+static int dispatch_order_cmp(const void *a, const void *b, void *arg);
+
+/*
+ * Memoizes the evaluation of mutable expressions during startup exclusion.
+ * See constify_mutable_expr_mutator for details.
+ */
+typedef struct ConstifiedExprCache
+{
+	PlannerInfo *root;
+	List *exprs;   /* evaluated subexpressions, compared with equal() */
+	List *results; /* their one-time evaluation results */
+} ConstifiedExprCache;
 
 static bool can_exclude_chunk(List *constraints, List *baserestrictinfo);
 static void do_startup_exclusion(ChunkAppendState *state);
 static Node *constify_param_mutator(Node *node, void *context);
+static List *constify_restrictinfos_memoized(PlannerInfo *root, ConstifiedExprCache *cache,
+											 List *restrictinfos);
 
 static void initialize_constraints(ChunkAppendState *state, List *initial_rt_indexes);
 static LWLock *chunk_append_get_lock_pointer(void);
@@ -222,6 +279,9 @@ do_startup_exclusion(ChunkAppendState *state)
 	PlannerInfo root = {
 		.glob = &glob,
 	};
+	ConstifiedExprCache expr_cache = {
+		.root = &root,
+	};
 
 	/* Reset included subplans */
 	state->included_subplans_by_se = NULL;
@@ -258,7 +318,7 @@ do_startup_exclusion(ChunkAppendState *state)
 				ri->clause = lfirst(lc);
 				restrictinfos = lappend(restrictinfos, ri);
 			}
-			restrictinfos = ts_constify_restrictinfos(&root, restrictinfos);
+			restrictinfos = constify_restrictinfos_memoized(&root, &expr_cache, restrictinfos);
 
 			if (can_exclude_chunk(lfirst(lc_constraints), restrictinfos))
 			{
@@ -423,6 +483,20 @@ perform_plan_init(ChunkAppendState *state, EState *estate, int eflags)
 		 */
 		state->csstate.ss.ps.chgParam = bms_copy(state->subplanstates[0]->plan->allParam);
 	}
+
+	/*
+	 * Compute the order in which parallel workers pick up subplans. Every
+	 * backend computes the same order from the shared plan tree, so no
+	 * coordination is needed beyond the existing subplan state flags.
+	 */
+	state->dispatch_order = (int *) palloc(state->num_subplans * sizeof(int));
+	for (i = 0; i < state->num_subplans; i++)
+		state->dispatch_order[i] = i;
+	qsort_arg(state->dispatch_order,
+			  state->num_subplans,
+			  sizeof(int),
+			  dispatch_order_cmp,
+			  state);
 }
 
 static bool
@@ -449,6 +523,196 @@ can_exclude_constraints_using_clauses(ChunkAppendState *state, List *constraints
 	return can_exclude;
 }
 
+typedef struct ExclusionParamsContext
+{
+	Bitmapset *paramids;
+	bool usable;
+} ExclusionParamsContext;
+
+/*
+ * Collect the exec params referenced by the exclusion clauses. Params of
+ * by-reference types make the clauses uncacheable because their datums point
+ * into memory owned by whoever set the param.
+ */
+static bool
+collect_exclusion_params_walker(Node *node, ExclusionParamsContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	/*
+	 * SubPlans are not constified during exclusion, so their parameters do not
+	 * influence the exclusion result. This mirrors constify_param_mutator.
+	 */
+	if (IsA(node, SubPlan))
+		return false;
+
+	if (IsA(node, Param))
+	{
+		Param *param = castNode(Param, node);
+
+		/* extern params are constant for the duration of the execution */
+		if (param->paramkind != PARAM_EXEC)
+			return false;
+
+		if (!lookup_type_cache(param->paramtype, 0)->typbyval)
+		{
+			context->usable = false;
+			return true;
+		}
+
+		context->paramids = bms_add_member(context->paramids, param->paramid);
+		return false;
+	}
+
+	return expression_tree_walker(node, collect_exclusion_params_walker, context);
+}
+
+/*
+ * Set up the exclusion cache on first use. Returns true if the cache is
+ * usable for this node.
+ */
+static bool
+exclusion_cache_init(ChunkAppendState *state)
+{
+	ExclusionParamsContext context = { .usable = true };
+	MemoryContext old;
+	HASHCTL ctl;
+	int paramid;
+	int i;
+
+	if (state->exclusion_cache_checked)
+		return state->exclusion_cache != NULL;
+
+	state->exclusion_cache_checked = true;
+
+	collect_exclusion_params_walker((Node *) state->initial_parent_clauses, &context);
+	collect_exclusion_params_walker((Node *) state->filtered_ri_clauses, &context);
+
+	if (!context.usable || bms_num_members(context.paramids) > EXCLUSION_CACHE_MAX_PARAMS)
+		return false;
+
+	state->exclusion_cache_ctx = AllocSetContextCreate(state->csstate.ss.ps.state->es_query_cxt,
+													   "ChunkAppend exclusion cache",
+													   ALLOCSET_SMALL_SIZES);
+
+	old = MemoryContextSwitchTo(state->exclusion_cache_ctx);
+	state->cache_num_params = bms_num_members(context.paramids);
+	state->cache_param_ids = palloc(state->cache_num_params * sizeof(int));
+	i = 0;
+	paramid = -1;
+	while ((paramid = bms_next_member(context.paramids, paramid)) >= 0)
+		state->cache_param_ids[i++] = paramid;
+	MemoryContextSwitchTo(old);
+
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(ExclusionCacheKey);
+	ctl.entrysize = sizeof(ExclusionCacheEntry);
+	ctl.hcxt = state->exclusion_cache_ctx;
+	state->exclusion_cache = hash_create("ChunkAppend exclusion cache",
+										 16,
+										 &ctl,
+										 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	return true;
+}
+
+/*
+ * Build the cache key from the current values of the exclusion-relevant
+ * params. Returns false if a param has not been evaluated yet; it will be
+ * evaluated during the exclusion pass itself, so the key can be built
+ * afterwards.
+ */
+static bool
+exclusion_cache_build_key(ChunkAppendState *state, ExclusionCacheKey *key)
+{
+	EState *estate = state->csstate.ss.ps.state;
+
+	/* zero out padding and unused slots so the key can be hashed as a blob */
+	memset(key, 0, sizeof(ExclusionCacheKey));
+
+	for (int i = 0; i < state->cache_num_params; i++)
+	{
+		ParamExecData *prm = &estate->es_param_exec_vals[state->cache_param_ids[i]];
+
+		if (prm->execPlan != NULL)
+			return false;
+
+		key->isnull[i] = prm->isnull;
+		if (!prm->isnull)
+			key->values[i] = prm->value;
+	}
+
+	return true;
+}
+
+/*
+ * Look up the exclusion result for the current param values. On a hit the
+ * node state and the EXPLAIN counters are updated as if the exclusion pass
+ * had run.
+ */
+static bool
+exclusion_cache_lookup(ChunkAppendState *state)
+{
+	ExclusionCacheKey key;
+	ExclusionCacheEntry *entry;
+
+	if (!exclusion_cache_init(state))
+		return false;
+
+	if (!exclusion_cache_build_key(state, &key))
+		return false;
+
+	entry = hash_search(state->exclusion_cache, &key, HASH_FIND, NULL);
+
+	if (entry == NULL)
+		return false;
+
+	Assert(state->valid_subplans == NULL);
+	state->valid_subplans = bms_copy(entry->valid_subplans);
+
+	if (entry->excluded_parent)
+		state->runtime_number_exclusions_parent++;
+
+	state->runtime_number_exclusions_children += entry->excluded_children;
+
+	return true;
+}
+
+/*
+ * Remember the result of an exclusion pass for the current param values.
+ */
+static void
+exclusion_cache_store(ChunkAppendState *state, bool excluded_parent, int excluded_children)
+{
+	ExclusionCacheKey key;
+	ExclusionCacheEntry *entry;
+	MemoryContext old;
+	bool found;
+
+	if (state->exclusion_cache == NULL || !exclusion_cache_build_key(state, &key))
+		return;
+
+	/* cap the cache size for queries with ever-changing param values */
+	if (hash_get_num_entries(state->exclusion_cache) >= EXCLUSION_CACHE_MAX_ENTRIES)
+		return;
+
+	entry = hash_search(state->exclusion_cache, &key, HASH_ENTER, &found);
+
+	/*
+	 * The key may not have been buildable at lookup time because of an
+	 * unevaluated subplan param, in which case an entry can already exist.
+	 */
+	if (found)
+		return;
+
+	old = MemoryContextSwitchTo(state->exclusion_cache_ctx);
+	entry->valid_subplans = bms_copy(state->valid_subplans);
+	MemoryContextSwitchTo(old);
+	entry->excluded_parent = excluded_parent;
+	entry->excluded_children = excluded_children;
+}
+
 /*
  * build bitmap of valid subplans for runtime exclusion
  */
@@ -457,6 +721,7 @@ initialize_runtime_exclusion(ChunkAppendState *state)
 {
 	ListCell *lc_clauses, *lc_constraints;
 	int i = 0;
+	int excluded_children = 0;
 
 	PlannerGlobal glob = {
 		.boundParams = state->csstate.ss.ps.state->es_param_list_info,
@@ -474,6 +739,14 @@ initialize_runtime_exclusion(ChunkAppendState *state)
 
 	state->runtime_number_loops++;
 
+	/*
+	 * Under a parameterized rescan (e.g. the inner side of a nested loop) the
+	 * same parameter values typically come back many times, so reuse a
+	 * previously computed exclusion result when possible.
+	 */
+	if (exclusion_cache_lookup(state))
+		return;
+
 	if (state->runtime_exclusion_parent)
 	{
 		/* try to exclude all the chunks using the parents clauses.
@@ -488,6 +761,7 @@ initialize_runtime_exclusion(ChunkAppendState *state)
 												  &state->csstate.ss.ps))
 		{
 			state->runtime_number_exclusions_parent++;
+			exclusion_cache_store(state, true, 0);
 			return;
 		}
 	}
@@ -498,6 +772,7 @@ initialize_runtime_exclusion(ChunkAppendState *state)
 		{
 			state->valid_subplans = bms_add_member(state->valid_subplans, i);
 		}
+		exclusion_cache_store(state, false, 0);
 		return;
 	}
 
@@ -529,12 +804,17 @@ initialize_runtime_exclusion(ChunkAppendState *state)
 			if (!can_exclude)
 				state->valid_subplans = bms_add_member(state->valid_subplans, i);
 			else
+			{
 				state->runtime_number_exclusions_children++;
+				excluded_children++;
+			}
 		}
 
 		lc_clauses = lnext(state->filtered_ri_clauses, lc_clauses);
 		lc_constraints = lnext(state->filtered_constraints, lc_constraints);
 	}
+
+	exclusion_cache_store(state, false, excluded_children);
 }
 
 /*
@@ -629,11 +909,41 @@ choose_next_subplan_non_parallel(ChunkAppendState *state)
 	state->current = get_next_subplan(state, state->current);
 }
 
+/*
+ * Sort non-partial subplans before partial ones (mirroring the layout of the
+ * subplan list) and by descending total cost within each group, so that the
+ * largest chunks are started first. Ties are broken on the subplan index to
+ * keep the order identical in all parallel workers.
+ */
+static int
+dispatch_order_cmp(const void *a, const void *b, void *arg)
+{
+	ChunkAppendState *state = arg;
+	int plan_a = *((const int *) a);
+	int plan_b = *((const int *) b);
+	bool partial_a = plan_a >= state->filtered_first_partial_plan;
+	bool partial_b = plan_b >= state->filtered_first_partial_plan;
+
+	if (partial_a != partial_b)
+		return partial_a ? 1 : -1;
+
+	Cost cost_a = state->subplanstates[plan_a]->plan->total_cost;
+	Cost cost_b = state->subplanstates[plan_b]->plan->total_cost;
+
+	if (cost_a != cost_b)
+		return cost_a > cost_b ? -1 : 1;
+
+	return plan_a - plan_b;
+}
+
 static void
 choose_next_subplan_for_worker(ChunkAppendState *state)
 {
 	ParallelChunkAppendState *pstate = state->pstate;
-	int next_plan;
+	bool runtime_exclusion =
+		state->runtime_exclusion_parent || state->runtime_exclusion_children;
+	int chosen = -1;
+	int rank = 0;
 	int start;
 
 	LWLockAcquire(state->lock, LW_EXCLUSIVE);
@@ -643,12 +953,7 @@ choose_next_subplan_for_worker(ChunkAppendState *state)
 		pstate->subplan_state[state->current] =
 			ts_set_flags_32(pstate->subplan_state[state->current], SUBPLAN_STATE_FINISHED);
 
-	if (pstate->next_plan == INVALID_SUBPLAN_INDEX)
-		next_plan = get_next_subplan(state, INVALID_SUBPLAN_INDEX);
-	else
-		next_plan = pstate->next_plan;
-
-	if (next_plan == NO_MATCHING_SUBPLANS)
+	if (pstate->next_plan == NO_MATCHING_SUBPLANS || state->num_subplans == 0)
 	{
 		/* all subplans are finished */
 		pstate->next_plan = NO_MATCHING_SUBPLANS;
@@ -657,56 +962,63 @@ choose_next_subplan_for_worker(ChunkAppendState *state)
 		return;
 	}
 
-	start = next_plan;
+	/*
+	 * Initialize runtime exclusion lazily like get_next_subplan does; this
+	 * happens while we hold the lock, same as before.
+	 */
+	if (runtime_exclusion && !state->runtime_initialized)
+		initialize_runtime_exclusion(state);
+
+	start = (pstate->next_plan == INVALID_SUBPLAN_INDEX) ? 0 : pstate->next_plan;
 
-	/* skip finished subplans */
-	while (ts_flags_are_set_32(pstate->subplan_state[next_plan], SUBPLAN_STATE_FINISHED))
+	/*
+	 * Hand out subplans in dispatch order (most expensive non-partial
+	 * subplans first), skipping finished subplans and the ones removed by
+	 * runtime exclusion. Partial subplans are not marked finished when
+	 * handed out, so wrapping around lets additional workers join them.
+	 */
+	for (int examined = 0; examined < state->num_subplans; examined++)
 	{
-		next_plan = get_next_subplan(state, next_plan);
+		int plan;
 
-		/* wrap around if we reach end of subplan list */
-		if (next_plan < 0)
-			next_plan = get_next_subplan(state, INVALID_SUBPLAN_INDEX);
+		rank = (start + examined) % state->num_subplans;
+		plan = state->dispatch_order[rank];
 
-		if (next_plan == start || next_plan < 0)
-		{
-			/*
-			 * back at start of search so all subplans are finished
-			 *
-			 * next_plan should not be < 0 because this means there
-			 * are no valid subplans and then the function would
-			 * have returned at the check before the while loop but
-			 * static analysis marked this so might as well include
-			 * that in the check
-			 */
-			Assert(next_plan >= 0);
-			pstate->next_plan = NO_MATCHING_SUBPLANS;
-			state->current = NO_MATCHING_SUBPLANS;
-			LWLockRelease(state->lock);
-			return;
-		}
+		if (ts_flags_are_set_32(pstate->subplan_state[plan], SUBPLAN_STATE_FINISHED))
+			continue;
+
+		if (runtime_exclusion && !bms_is_member(plan, state->valid_subplans))
+			continue;
+
+		chosen = plan;
+		break;
+	}
+
+	if (chosen < 0)
+	{
+		/* all subplans are finished */
+		pstate->next_plan = NO_MATCHING_SUBPLANS;
+		state->current = NO_MATCHING_SUBPLANS;
+		LWLockRelease(state->lock);
+		return;
 	}
 
-	Assert(next_plan >= 0 && next_plan < state->num_subplans);
-	state->current = next_plan;
+	Assert(chosen >= 0 && chosen < state->num_subplans);
+	state->current = chosen;
 
 	/*
 	 * if this is not a partial plan we mark it as finished
 	 * immediately so it does not get assigned another worker
 	 */
-	if (next_plan < state->filtered_first_partial_plan)
-		pstate->subplan_state[next_plan] =
-			ts_set_flags_32(pstate->subplan_state[next_plan], SUBPLAN_STATE_FINISHED);
+	if (chosen < state->filtered_first_partial_plan)
+		pstate->subplan_state[chosen] =
+			ts_set_flags_32(pstate->subplan_state[chosen], SUBPLAN_STATE_FINISHED);
 
-	/* advance next_plan for next worker */
-	pstate->next_plan = get_next_subplan(state, state->current);
 	/*
-	 * if we reach the end of the list of subplans we set next_plan
-	 * to INVALID_SUBPLAN_INDEX to allow rechecking unfinished subplans
-	 * on next call
+	 * Advance the dispatch position for the next worker; wrapping around
+	 * allows rechecking unfinished partial subplans on the next call.
 	 */
-	if (pstate->next_plan < 0)
-		pstate->next_plan = INVALID_SUBPLAN_INDEX;
+	pstate->next_plan = (rank + 1) % state->num_subplans;
 
 	LWLockRelease(state->lock);
 }
@@ -917,6 +1229,53 @@ chunk_append_get_lock_pointer()
 	return *lock;
 }
 
+/*
+ * Memoize the evaluation of mutable expressions during startup exclusion.
+ *
+ * The restriction clauses are per-chunk copies of the same parent clauses, so
+ * a stable function call like "time > lookup_threshold()" appears once per
+ * chunk. Evaluating it through estimate_expression_value for every chunk
+ * makes executor startup O(chunks) in function calls, which hurts when the
+ * function does real work (e.g. a configuration lookup). Instead, evaluate
+ * each distinct Var-free mutable subexpression once and substitute the result
+ * into all the sibling clauses.
+ */
+static Node *
+constify_mutable_expr_mutator(Node *node, void *context)
+{
+	ConstifiedExprCache *cache = context;
+
+	if (node == NULL)
+		return NULL;
+
+	/*
+	 * Evaluate a maximal subtree that contains stable functions but no Vars;
+	 * such a subtree has the same value for every chunk. Volatile functions
+	 * must not be evaluated here, exactly as in estimate_expression_value.
+	 */
+	if (!IsA(node, Const) && contain_mutable_functions(node) &&
+		!contain_volatile_functions(node) && !contain_var_clause(node))
+	{
+		ListCell *lc_expr;
+		ListCell *lc_result;
+
+		forboth (lc_expr, cache->exprs, lc_result, cache->results)
+		{
+			if (equal(lfirst(lc_expr), node))
+				return copyObject(lfirst(lc_result));
+		}
+
+		Node *result = estimate_expression_value(cache->root, node);
+
+		cache->exprs = lappend(cache->exprs, copyObject(node));
+		cache->results = lappend(cache->results, result);
+
+		return copyObject(result);
+	}
+
+	return expression_tree_mutator(node, constify_mutable_expr_mutator, context);
+}
+
 /*
  * Convert restriction clauses to constants expressions (i.e., if there are
  * mutable functions, they need to be evaluated to constants).  For instance,
@@ -927,9 +1286,12 @@ chunk_append_get_lock_pointer()
  * becomes
  *
  * ...WHERE time > '2017-06-02 11:26:43.935712+02'
+ *
+ * With a cache, the mutable subexpressions are evaluated once through the
+ * cache instead of once per chunk.
  */
-List *
-ts_constify_restrictinfos(PlannerInfo *root, List *restrictinfos)
+static List *
+constify_restrictinfos_memoized(PlannerInfo *root, ConstifiedExprCache *cache, List *restrictinfos)
 {
 	List *additional_list = NIL;
 
@@ -938,7 +1300,12 @@ ts_constify_restrictinfos(PlannerInfo *root, List *restrictinfos)
 	foreach (lc, restrictinfos)
 	{
 		RestrictInfo *rinfo = lfirst(lc);
-		Expr *constified = (Expr *) estimate_expression_value(root, (Node *) rinfo->clause);
+		Expr *clause = rinfo->clause;
+
+		if (cache != NULL)
+			clause = (Expr *) constify_mutable_expr_mutator((Node *) clause, cache);
+
+		Expr *constified = (Expr *) estimate_expression_value(root, (Node *) clause);
 
 		/*
 		 * Note that we have to use equal() here, because the expression mutators
@@ -974,6 +1341,12 @@ ts_constify_restrictinfos(PlannerInfo *root, List *restrictinfos)
 	return list_concat(restrictinfos, additional_list);
 }
 
+List *
+ts_constify_restrictinfos(PlannerInfo *root, List *restrictinfos)
+{
+	return constify_restrictinfos_memoized(root, NULL, restrictinfos);
+}
+
 List *
 ts_constify_restrictinfo_params(PlannerInfo *root, EState *state, List *restrictinfos)
 {
@@ -5,12 +5,15 @@
  */
 
 #include <postgres.h>
+#include <access/xact.h>
 #include <nodes/execnodes.h>
 #include <nodes/makefuncs.h>
+#include <optimizer/optimizer.h>
 #include <utils/syscache.h>
 
 #include "compat/compat.h"
 #include "chunk_tuple_routing.h"
+#include "copy.h"
 #include "cross_module_fn.h"
 #include "guc.h"
 #include "indexing.h"
@@ -89,6 +92,52 @@ should_use_direct_compress(ModifyHypertableState *state)
 	return true;
 }
 
+/*
+ * Check whether this INSERT can buffer tuples through the COPY multi-insert
+ * machinery instead of inserting them one at a time with ExecInsert.
+ * Buffering reorders the actual heap inserts relative to the tuple stream, so
+ * anything that observes per-row insert order or per-row results disables it.
+ */
+static bool
+should_use_multi_insert(ModifyHypertableState *state)
+{
+	if (!ts_guc_enable_insert_batching)
+		return false;
+
+	/* Direct compress ingest has its own batching */
+	if (state->columnstore_insert)
+		return false;
+
+	ModifyTableState *mtstate = linitial_node(ModifyTableState, state->cscan_state.custom_ps);
+	ModifyTable *mt = castNode(ModifyTable, mtstate->ps.plan);
+	ResultRelInfo *resultRelInfo = mtstate->resultRelInfo;
+
+	if (mt->returningLists != NIL || mt->onConflictAction != ONCONFLICT_NONE ||
+		mt->withCheckOptionLists != NIL)
+		return false;
+
+	/*
+	 * Row triggers on the hypertable must fire per tuple in stream order.
+	 * Chunk-level triggers are handled by the buffer setup, which downgrades
+	 * the affected chunk to single inserts.
+	 */
+	if (resultRelInfo->ri_TrigDesc &&
+		(resultRelInfo->ri_TrigDesc->trig_insert_before_row ||
+		 resultRelInfo->ri_TrigDesc->trig_insert_instead_row ||
+		 resultRelInfo->ri_TrigDesc->trig_insert_after_row ||
+		 resultRelInfo->ri_TrigDesc->trig_insert_new_table))
+		return false;
+
+	/*
+	 * Volatile functions in the source targetlist may observe the table
+	 * contents, which would expose the deferred inserts.
+	 */
+	if (contain_volatile_functions((Node *) mtstate->ps.plan->lefttree->targetlist))
+		return false;
+
+	return true;
+}
+
 /*
  * ModifyHypertable is a plan node that implements DML for hypertables.
  * It is a wrapper around the ModifyTable plan node that calls the wrapped ModifyTable
@@ -156,6 +205,10 @@ modify_hypertable_begin(CustomScanState *node, EState *estate, int eflags)
 			state->ctr->create_compressed_chunk = true;
 		}
 
+		if (mtstate->operation == CMD_INSERT && should_use_multi_insert(state))
+			state->multi_insert_info =
+				ts_copy_multi_insert_info_create(state->ctr, estate, state->ht);
+
 		if (mtstate->operation == CMD_MERGE)
 			state->ctr->has_dropped_attrs =
 				rel_has_dropped_attrs(state->ctr->hypertable->main_table_relid);
@@ -177,6 +230,12 @@ static void
 modify_hypertable_end(CustomScanState *node)
 {
 	ModifyHypertableState *state = (ModifyHypertableState *) node;
+	/* Normally flushed in ExecModifyTable, but be defensive on early shutdown */
+	if (state->multi_insert_info)
+	{
+		ts_copy_multi_insert_info_finish(state->multi_insert_info);
+		state->multi_insert_info = NULL;
+	}
 	if (state->compressor)
 	{
 		ts_cm_functions->compressor_flush(state->compressor, state->bulk_writer);
@@ -188,6 +247,25 @@ modify_hypertable_end(CustomScanState *node)
 	if (state->ctr)
 		ts_chunk_tuple_routing_destroy(state->ctr);
 
+	/*
+	 * Recompress the chunks that this statement partially decompressed, so
+	 * that steady-state UPDATEs do not degrade the chunks into row format.
+	 * The list is only populated when timescaledb.enable_dml_recompression
+	 * is set.
+	 */
+	if (state->chunks_for_recompression != NIL && ts_cm_functions->recompress_chunk_for_dml)
+	{
+		ListCell *lc;
+
+		/* Make the rows modified by this statement visible to the scans below. */
+		CommandCounterIncrement();
+
+		foreach (lc, state->chunks_for_recompression)
+		{
+			ts_cm_functions->recompress_chunk_for_dml(lfirst_oid(lc));
+		}
+	}
+
 	ts_cache_release(&state->ht_cache);
 }
 
@@ -490,6 +568,19 @@ static CustomPathMethods modify_hypertable_path_methods = {
 	.PlanCustomPath = modify_hypertable_plan_create,
 };
 
+/*
+ * Wrap a ModifyTable path for a hypertable in our custom path.
+ *
+ * The resulting plan is always serial, including the scans feeding an
+ * UPDATE/DELETE over many chunks. This is a PostgreSQL limitation, not
+ * ours: the planner disables parallelism for the whole plan tree of any
+ * data-modifying statement, and the heap AM rejects writes while in
+ * parallel mode because command ids and the combo-CID mapping cannot be
+ * synchronized with workers. Distributing chunks over background workers
+ * with their own transactions instead would give up the single-statement
+ * atomicity and snapshot of DML, so we don't do that either. Bulk
+ * time-based deletion is better served by dropping whole chunks.
+ */
 Path *
 ts_modify_hypertable_path_create(PlannerInfo *root, ModifyTablePath *mtpath, RelOptInfo *rel)
 {
@@ -50,6 +50,16 @@ typedef struct ModifyHypertableState
 	int64 batches_deleted;
 	int64 tuples_deleted;
 
+	/* Multi-insert buffering for batched INSERTs, NULL when not used */
+	struct TSCopyMultiInsertInfo *multi_insert_info;
+
+	/*
+	 * Chunks that were partially decompressed by an UPDATE and should be
+	 * recompressed at the end of the statement, see
+	 * timescaledb.enable_dml_recompression.
+	 */
+	List *chunks_for_recompression;
+
 } ModifyHypertableState;
 
 extern TSDLLEXPORT bool ts_is_modify_hypertable_plan(Plan *plan);
@@ -73,6 +73,7 @@
 #include <utils/rel.h>
 #include <utils/snapmgr.h>
 
+#include "copy.h"
 #include "cross_module_fn.h"
 #include "guc.h"
 #include "hypertable_cache.h"
@@ -1385,13 +1386,19 @@ ldelete:
 	if (context->ht_state->has_continuous_aggregate)
 	{
 		bool should_free;
-		TupleTableSlot *cagg_slot = table_slot_create(resultRelationDesc, NULL);
+
+		/*
+		 * Fetch the deleted row into the lazily created trigger old-tuple
+		 * slot instead of creating and dropping a fresh slot for every row.
+		 * The trigger code refetches into that slot itself, so reusing it
+		 * here is safe.
+		 */
+		TupleTableSlot *cagg_slot = ExecGetTriggerOldSlot(estate, resultRelInfo);
 		table_tuple_fetch_row_version(resultRelationDesc, tupleid, SnapshotAny, cagg_slot);
 		HeapTuple tuple = ExecFetchSlotHeapTuple(cagg_slot, false, &should_free);
 		ts_cm_functions->continuous_agg_dml_invalidate(context->ht_state->ht->fd.id, resultRelationDesc, tuple, NULL, false);
 		if (should_free)
 			heap_freetuple(tuple);
-		ExecDropSingleTupleTableSlot(cagg_slot);
 	}
 
 	if (canSetTag)
@@ -1924,11 +1931,16 @@ redo_act:
 
 	if (context->ht_state->has_continuous_aggregate)
 	{
-		TupleTableSlot *invalidation_slot = NULL;
 		bool should_free_old = false, should_free_new = false;
 		if (!oldtuple)
 		{
-			invalidation_slot = table_slot_create(resultRelationDesc, NULL);
+			/*
+			 * Fetch the old row into the lazily created trigger old-tuple
+			 * slot instead of creating and dropping a fresh slot for every
+			 * row. The AFTER ROW triggers have already captured what they
+			 * need at this point, so reusing the slot is safe.
+			 */
+			TupleTableSlot *invalidation_slot = ExecGetTriggerOldSlot(estate, resultRelInfo);
 			table_tuple_fetch_row_version(resultRelationDesc, tupleid, SnapshotAny, invalidation_slot);
 			oldtuple = ExecFetchSlotHeapTuple(invalidation_slot, false, &should_free_old);
 		}
@@ -1938,8 +1950,6 @@ redo_act:
 			heap_freetuple(oldtuple);
 		if (should_free_new)
 			heap_freetuple(newtuple);
-		if (invalidation_slot)
-			ExecDropSingleTupleTableSlot(invalidation_slot);
 	}
 
 	/* Process RETURNING if present */
@@ -2423,8 +2433,16 @@ ExecModifyTable(CustomScanState *cs_node, PlanState *pstate)
 
 				if (!ht_state->compressor)
 				{
-					bool sort = ts_guc_enable_direct_compress_insert_sort_batches && !ts_guc_enable_direct_compress_insert_client_sorted;
-					ht_state->compressor = ts_cm_functions->compressor_init(ctr->cis->rel, &ht_state->bulk_writer, sort, ts_guc_direct_compress_insert_tuple_sort_limit);
+					CompressorIngestMode ingest_mode;
+
+					if (ts_guc_enable_direct_compress_insert_client_sorted)
+						ingest_mode = COMPRESSOR_INGEST_ORDERED;
+					else if (ts_guc_enable_direct_compress_insert_sort_batches)
+						ingest_mode = COMPRESSOR_INGEST_SORT_BATCHES;
+					else
+						ingest_mode = COMPRESSOR_INGEST_SEGMENT_STAGING;
+
+					ht_state->compressor = ts_cm_functions->compressor_init(ctr->cis->rel, &ht_state->bulk_writer, ingest_mode, ts_guc_direct_compress_insert_tuple_sort_limit);
 					ht_state->compressor_relid = RelationGetRelid(ctr->cis->rel);
 
 					if (ht_state->has_continuous_aggregate)
@@ -2446,6 +2464,22 @@ ExecModifyTable(CustomScanState *cs_node, PlanState *pstate)
 				continue;
 			}
 
+			/*
+			 * Buffer plain INSERTs through the COPY multi-insert machinery.
+			 * Falls through to the regular ExecInsert path for chunks with
+			 * row triggers.
+			 */
+			if (operation == CMD_INSERT && ht_state->multi_insert_info &&
+				ts_copy_multi_insert_buffer_tuple(ht_state->multi_insert_info,
+												  ctr->cis,
+												  point,
+												  slot))
+			{
+				if (node->canSetTag)
+					estate->es_processed++;
+				continue;
+			}
+
 			/*
 			 * copy INSERT merge action list to result relation info of corresponding chunk
 			 *
@@ -2698,6 +2732,13 @@ ExecModifyTable(CustomScanState *cs_node, PlanState *pstate)
 			return slot;
 	}
 
+	/* Flush any tuples still buffered for multi-insert */
+	if (ht_state->multi_insert_info)
+	{
+		ts_copy_multi_insert_info_finish(ht_state->multi_insert_info);
+		ht_state->multi_insert_info = NULL;
+	}
+
 	/*
 	 * Insert remaining tuples for batch insert.
 	 */
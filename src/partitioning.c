@@ -8,6 +8,7 @@
 #include <access/htup_details.h>
 #include <catalog/namespace.h>
 #include <catalog/pg_type.h>
+#include <common/hashfn.h>
 #include <miscadmin.h>
 #include <nodes/makefuncs.h>
 #include <nodes/pg_list.h>
@@ -200,8 +201,22 @@ ts_partitioning_info_create(const char *schema, const char *partfunc, const char
 	{
 		TypeCacheEntry *tce = lookup_type_cache(columntype, TYPECACHE_HASH_FLAGS);
 
-		if (!OidIsValid(tce->hash_proc) && ts_partitioning_func_is_closed_default(schema, partfunc))
-			elog(ERROR, "could not find hash function for type %s", format_type_be(columntype));
+		if (ts_partitioning_func_is_closed_default(schema, partfunc))
+		{
+			if (!OidIsValid(tce->hash_proc))
+				elog(ERROR,
+					 "could not find hash function for type %s",
+					 format_type_be(columntype));
+
+			/*
+			 * The default partitioning function just hashes the value with
+			 * the column type's hash function, so the per-tuple apply can
+			 * call the hash function directly instead of resolving it through
+			 * the generic anyelement function. Type cache entries live for
+			 * the lifetime of the backend, so caching the pointer is safe.
+			 */
+			pinfo->partfunc.hash_tce = tce;
+		}
 	}
 
 	partitioning_func_set_func_fmgr(&pinfo->partfunc, columntype, dimtype);
@@ -239,6 +254,48 @@ ts_partitioning_func_apply(PartitioningInfo *pinfo, Oid collation, Datum value)
 	LOCAL_FCINFO(fcinfo, 1);
 	Datum result;
 
+	/*
+	 * Fast path for the default hash partitioning function. The type cache
+	 * entry was resolved when the partitioning info was created, so hash
+	 * directly here instead of dispatching through fmgr twice per tuple (once
+	 * for ts_get_partition_hash and once for the type's hash function). The
+	 * built-in integer hash functions are replicated inline; the results are
+	 * on-disk stable and must match hashint2/hashint4/hashint8 exactly.
+	 */
+	if (pinfo->partfunc.hash_tce != NULL)
+	{
+		TypeCacheEntry *tce = pinfo->partfunc.hash_tce;
+		Datum hash;
+
+		switch (tce->type_id)
+		{
+			case INT2OID:
+				hash = hash_uint32((int32) DatumGetInt16(value));
+				break;
+			case INT4OID:
+				hash = hash_uint32(DatumGetInt32(value));
+				break;
+			case INT8OID:
+			{
+				int64 val = DatumGetInt64(value);
+				uint32 lohalf = (uint32) val;
+				uint32 hihalf = (uint32) (val >> 32);
+
+				lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+				hash = hash_uint32(lohalf);
+				break;
+			}
+			default:
+				if (!OidIsValid(collation))
+					collation = tce->typcollation;
+				hash = FunctionCall1Coll(&tce->hash_proc_finfo, collation, value);
+				break;
+		}
+
+		/* Only positive numbers */
+		return Int32GetDatum((int32) (DatumGetUInt32(hash) & 0x7fffffff));
+	}
+
 	InitFunctionCallInfoData(*fcinfo, &pinfo->partfunc.func_fmgr, 1, collation, NULL, NULL);
 
 	FC_SET_ARG(fcinfo, 0, value);
@@ -33,6 +33,14 @@ typedef struct PartitioningFunc
 	 * partitioning column's text representation.
 	 */
 	FmgrInfo func_fmgr;
+
+	/*
+	 * Set when the partitioning function is the default hash function, in
+	 * which case the hash can be computed directly from the column type's
+	 * hash function instead of dispatching through fmgr for every tuple.
+	 * NULL for custom partitioning functions, which go through func_fmgr.
+	 */
+	TypeCacheEntry *hash_tce;
 } PartitioningFunc;
 
 typedef struct PartitioningInfo
@@ -29,6 +29,7 @@
 #include <utils/elog.h>
 #include <utils/fmgroids.h>
 #include <utils/guc.h>
+#include <utils/hsearch.h>
 #include <utils/lsyscache.h>
 #include <utils/memutils.h>
 #include <utils/selfuncs.h>
@@ -157,6 +158,112 @@ ts_add_baserel_cache_entry_for_chunk(Oid chunk_reloid, Hypertable *hypertable)
 	entry->ht = hypertable;
 }
 
+/*
+ * Backend-lifetime cache of relation classifications (hypertable, chunk or
+ * plain table), keyed by relation OID.
+ *
+ * The per-query baserel info hash above avoids repeated chunk metadata scans
+ * within one query, but the scans are still repeated for every planned query.
+ * Since many statements in mixed workloads touch no hypertables at all, we
+ * remember here that a relation is a plain table so subsequent planning of
+ * such statements can skip the hypertable and chunk lookups with a single
+ * hash probe per range table entry.
+ *
+ * The cache is invalidated through relcache invalidations on the hypertable
+ * proxy table, which fire for all changes to the TimescaleDB catalog,
+ * including hypertable creation and chunk creation or removal. Invalidation
+ * only bumps a generation counter; the hash table is rebuilt lazily on the
+ * next use.
+ */
+typedef enum RelclassCacheClass
+{
+	REL_CLASS_PLAIN = 0,
+	REL_CLASS_HYPERTABLE,
+	REL_CLASS_CHUNK,
+} RelclassCacheClass;
+
+typedef struct RelclassCacheEntry
+{
+	Oid relid;
+	RelclassCacheClass relclass;
+} RelclassCacheEntry;
+
+#define RELCLASS_CACHE_MAX_ENTRIES 1024
+
+static HTAB *relclass_cache = NULL;
+static uint64 relclass_cache_generation = 0;
+static uint64 relclass_cache_built_generation = 0;
+
+/*
+ * Invalidate the relation classification cache.
+ *
+ * Called from the relcache invalidation callback, so it must only do cheap
+ * work; the cache is rebuilt lazily.
+ */
+void
+ts_planner_relclass_cache_invalidate(void)
+{
+	relclass_cache_generation++;
+}
+
+static HTAB *
+relclass_cache_get_htab(void)
+{
+	if (relclass_cache != NULL && relclass_cache_built_generation == relclass_cache_generation)
+		return relclass_cache;
+
+	if (relclass_cache != NULL)
+	{
+		hash_destroy(relclass_cache);
+		relclass_cache = NULL;
+	}
+
+	HASHCTL ctl = {
+		.keysize = sizeof(Oid),
+		.entrysize = sizeof(RelclassCacheEntry),
+		.hcxt = CacheMemoryContext,
+	};
+	relclass_cache = hash_create("TimescaleDB relation classification cache",
+								 32,
+								 &ctl,
+								 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	relclass_cache_built_generation = relclass_cache_generation;
+
+	return relclass_cache;
+}
+
+static bool
+relclass_cache_lookup(Oid relid, RelclassCacheClass *relclass)
+{
+	RelclassCacheEntry *entry = hash_search(relclass_cache_get_htab(), &relid, HASH_FIND, NULL);
+
+	if (entry == NULL)
+		return false;
+
+	*relclass = entry->relclass;
+	return true;
+}
+
+static void
+relclass_cache_store(Oid relid, RelclassCacheClass relclass)
+{
+	HTAB *htab = relclass_cache_get_htab();
+	bool found;
+
+	/*
+	 * Guard against unbounded growth in backends touching many short-lived
+	 * relations. Resetting is cheap and hot entries are quickly rebuilt.
+	 */
+	if (hash_get_num_entries(htab) >= RELCLASS_CACHE_MAX_ENTRIES)
+	{
+		ts_planner_relclass_cache_invalidate();
+		htab = relclass_cache_get_htab();
+	}
+
+	RelclassCacheEntry *entry = hash_search(htab, &relid, HASH_ENTER, &found);
+	entry->relclass = relclass;
+}
+
 static void
 rte_mark_for_expansion(RangeTblEntry *rte)
 {
@@ -428,6 +535,26 @@ preprocess_query(Node *node, PreprocessQueryContext *context)
 					}
 					break;
 				case RTE_RELATION:
+				{
+					RelclassCacheClass relclass;
+					bool have_relclass = relclass_cache_lookup(rte->relid, &relclass);
+
+					/*
+					 * A relation known to be a plain table can skip the
+					 * hypertable and chunk lookups entirely, so queries that
+					 * touch no hypertables only pay one hash probe per
+					 * relation here.
+					 */
+					if (have_relclass && relclass == REL_CLASS_PLAIN)
+						break;
+
+					if (have_relclass && relclass == REL_CLASS_CHUNK)
+					{
+						if (rte->inh)
+							rte_mark_for_expansion(rte);
+						break;
+					}
+
 					/* This lookup will warm the cache with all hypertables in the query */
 					ht = ts_hypertable_cache_get_entry(hcache, rte->relid, CACHE_FLAG_MISSING_OK);
 
@@ -447,6 +574,8 @@ preprocess_query(Node *node, PreprocessQueryContext *context)
 							 * companion hypertable */
 							ts_hypertable_cache_get_entry_by_id(hcache, compr_htid);
 						}
+
+						relclass_cache_store(rte->relid, REL_CLASS_HYPERTABLE);
 					}
 					else
 					{
@@ -464,8 +593,12 @@ preprocess_query(Node *node, PreprocessQueryContext *context)
 							ts_chunk_get_by_relid_locked(rte->relid, NoLock, NULL, false);
 						if (chunk && rte->inh)
 							rte_mark_for_expansion(rte);
+
+						relclass_cache_store(rte->relid,
+											 chunk ? REL_CLASS_CHUNK : REL_CLASS_PLAIN);
 					}
 					break;
+				}
 				default:
 					break;
 			}
@@ -794,6 +927,19 @@ get_or_add_baserel_from_cache(Oid chunk_reloid, Oid parent_reloid)
 	}
 	else
 	{
+		RelclassCacheClass relclass;
+
+		/*
+		 * A relation known to be a plain table cannot be a chunk, so we can
+		 * skip the metadata scan. Plain classifications are only recorded
+		 * after both the hypertable and the chunk lookups came up empty.
+		 */
+		if (relclass_cache_lookup(chunk_reloid, &relclass) && relclass == REL_CLASS_PLAIN)
+		{
+			entry->ht = NULL;
+			return entry;
+		}
+
 		/* Hypertable reloid not specified by the caller, look it up by
 		 * an expensive metadata scan.
 		 */
@@ -807,6 +953,8 @@ get_or_add_baserel_from_cache(Oid chunk_reloid, Oid parent_reloid)
 			ht = ts_planner_get_hypertable(parent_reloid, CACHE_FLAG_NONE);
 			Assert(ht != NULL);
 			Assert(ht->fd.id == hypertable_id);
+
+			relclass_cache_store(chunk_reloid, REL_CLASS_CHUNK);
 		}
 	}
 
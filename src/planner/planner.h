@@ -87,6 +87,7 @@ typedef enum TsRelType
 } TsRelType;
 
 extern TSDLLEXPORT Hypertable *ts_planner_get_hypertable(const Oid relid, const unsigned int flags);
+extern void ts_planner_relclass_cache_invalidate(void);
 extern void ts_preprocess_first_last_aggregates(PlannerInfo *root, List *tlist);
 extern void ts_plan_expand_hypertable_chunks(Hypertable *ht, PlannerInfo *root, RelOptInfo *rel,
 											 bool include_osm);
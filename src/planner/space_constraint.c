@@ -8,10 +8,13 @@
 #include <access/xact.h>
 #include <datatype/timestamp.h>
 #include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
 #include <nodes/pg_list.h>
 #include <optimizer/optimizer.h>
 #include <parser/parse_func.h>
+#include <utils/array.h>
 #include <utils/fmgroids.h>
+#include <utils/lsyscache.h>
 #include <utils/typcache.h>
 
 #include "cache.h"
@@ -81,22 +84,49 @@ ts_is_equality_operator(Oid opno, Oid left, Oid right)
 }
 
 /*
- * Valid constraints are: Var = Const
- * Var has to refer to a space partitioning column
+ * Valid constraints are: Var = Const, Var = Param and Var = Var
+ * The left Var has to refer to a space partitioning column
+ *
+ * A Param or a Var of another relation is allowed because the added partition
+ * hash constraint can be constified during startup or runtime exclusion once
+ * the parameter value is bound, e.g. for prepared statements or parameterized
+ * nested loop joins on the partitioning column.
  */
 static bool
 is_valid_space_constraint(OpExpr *op, List *rtable)
 {
 	Assert(IsA(op, OpExpr));
-	if (!IsA(linitial(op->args), Var) || !IsA(lsecond(op->args), Const))
+	if (!IsA(linitial(op->args), Var))
 		return false;
 
 	Var *var = linitial_node(Var, op->args);
 	if (var->varlevelsup != 0)
 		return false;
 
-	Const *value = lsecond_node(Const, op->args);
-	if (!ts_is_equality_operator(op->opno, var->vartype, value->consttype))
+	Node *value = lsecond(op->args);
+	switch (nodeTag(value))
+	{
+		case T_Const:
+		case T_Param:
+			break;
+		case T_Var:
+		{
+			/*
+			 * Comparing against a column of another relation only helps
+			 * exclusion when the join is parameterized, but the extra hash
+			 * clause is cheap to evaluate either way. Columns of the same
+			 * relation cannot be constified and are not useful.
+			 */
+			Var *other = castNode(Var, value);
+			if (other->varlevelsup != 0 || other->varno == var->varno)
+				return false;
+			break;
+		}
+		default:
+			return false;
+	}
+
+	if (!ts_is_equality_operator(op->opno, var->vartype, exprType(value)))
 		return false;
 
 	/*
@@ -116,21 +146,63 @@ is_valid_space_constraint(OpExpr *op, List *rtable)
  * Valid constraints are:
  *   Var = ANY(ARRAY[Const,Const])
  *   Var IN (Const,Const)
+ *   Var = ANY(Const) for array-typed constants like '{1,2}'::int[]
  * Var has to refer to a space partitioning column
  */
 static bool
 is_valid_scalar_space_constraint(ScalarArrayOpExpr *op, List *rtable)
 {
 	Assert(IsA(op, ScalarArrayOpExpr));
-	if (!IsA(linitial(op->args), Var) || !IsA(lsecond(op->args), ArrayExpr))
+	if (!IsA(linitial(op->args), Var))
 		return false;
 
 	Var *var = linitial_node(Var, op->args);
-	ArrayExpr *arr = castNode(ArrayExpr, lsecond(op->args));
-	if (arr->multidims || !op->useOr || var->varlevelsup != 0)
+	if (!op->useOr || var->varlevelsup != 0)
 		return false;
 
-	if (!ts_is_equality_operator(op->opno, var->vartype, arr->element_typeid))
+	if (IsA(lsecond(op->args), ArrayExpr))
+	{
+		ArrayExpr *arr = castNode(ArrayExpr, lsecond(op->args));
+		if (arr->multidims)
+			return false;
+
+		if (!ts_is_equality_operator(op->opno, var->vartype, arr->element_typeid))
+			return false;
+
+		ListCell *lc;
+		foreach (lc, arr->elements)
+		{
+			switch (nodeTag(lfirst(lc)))
+			{
+				case T_Const:
+					break;
+				case T_FuncExpr:
+				{
+					FuncExpr *element = lfirst_node(FuncExpr, lc);
+					if (element->funcformat != COERCE_IMPLICIT_CAST ||
+						!IsA(linitial(element->args), Const))
+						return false;
+
+					break;
+				}
+				default:
+					return false;
+					break;
+			}
+		}
+	}
+	else if (IsA(lsecond(op->args), Const))
+	{
+		Const *arr = castNode(Const, lsecond(op->args));
+		Oid element_type = get_element_type(arr->consttype);
+
+		if (arr->constisnull || !OidIsValid(element_type))
+			return false;
+
+		if (!ts_is_equality_operator(op->opno, var->vartype, element_type))
+			return false;
+	}
+	else
 		return false;
 
 	/*
@@ -143,27 +215,6 @@ is_valid_scalar_space_constraint(ScalarArrayOpExpr *op, List *rtable)
 	if (!dim)
 		return false;
 
-	ListCell *lc;
-	foreach (lc, arr->elements)
-	{
-		switch (nodeTag(lfirst(lc)))
-		{
-			case T_Const:
-				break;
-			case T_FuncExpr:
-			{
-				FuncExpr *element = lfirst_node(FuncExpr, lc);
-				if (element->funcformat != COERCE_IMPLICIT_CAST ||
-					!IsA(linitial(element->args), Const))
-					return false;
-
-				break;
-			}
-			default:
-				return false;
-				break;
-		}
-	}
 	return true;
 }
 
@@ -183,13 +234,19 @@ make_partfunc_call(Oid funcid, Oid rettype, List *args, Oid inputcollid)
  * Transform a constraint like: device_id = 1
  * into
  * ((device_id = 1) AND (_timescaledb_functions.get_partition_hash(device_id) = 242423622))
+ *
+ * For a constraint like: device_id = $1 or device_id = d.id
+ * the hash of the value is not known at plan time, so we add
+ * (_timescaledb_functions.get_partition_hash(device_id) =
+ * _timescaledb_functions.get_partition_hash($1)) instead, which startup and
+ * runtime exclusion constify once the parameter value is bound.
  */
 static OpExpr *
 transform_space_constraint(PlannerInfo *root, List *rtable, OpExpr *op)
 {
 	Var *var = linitial_node(Var, op->args);
-	Const *value = lsecond_node(Const, op->args);
-	Const *part_value;
+	Node *value = lsecond(op->args);
+	Expr *part_value;
 	RangeTblEntry *rte = list_nth(rtable, var->varno - 1);
 	Dimension *dim = get_space_dimension(rte->relid, var->varattno);
 	Oid rettype = dim->partitioning->partfunc.rettype;
@@ -201,13 +258,32 @@ transform_space_constraint(PlannerInfo *root, List *rtable, OpExpr *op)
 											list_make1(value),
 											var->varcollid);
 
-	/*
-	 * We should always be able to constify here
-	 */
-	part_value = castNode(Const, eval_const_expressions(root, (Node *) partcall));
+	if (IsA(value, Const))
+	{
+		/*
+		 * We should always be able to constify here
+		 */
+		part_value = (Expr *) castNode(Const, eval_const_expressions(root, (Node *) partcall));
 
-	/* build FuncExpr with column reference to use in constraint */
-	partcall->args = list_make1(copyObject(var));
+		/* build FuncExpr with column reference to use in constraint */
+		partcall->args = list_make1(copyObject(var));
+	}
+	else
+	{
+		/*
+		 * Keep the partition hash call around the parameter so exclusion can
+		 * constify it at execution time.
+		 */
+		Assert(IsA(value, Param) || IsA(value, Var));
+		partcall->args = list_make1(copyObject(value));
+		part_value = (Expr *) partcall;
+
+		/* build a separate FuncExpr with column reference to use in constraint */
+		partcall = make_partfunc_call(dim->partitioning->partfunc.func_fmgr.fn_oid,
+									  rettype,
+									  list_make1(copyObject(var)),
+									  var->varcollid);
+	}
 
 	OpExpr *ret = (OpExpr *) make_opclause(tce->eq_opr /* opno */,
 										   BOOLOID /*opresulttype */,
@@ -235,6 +311,7 @@ transform_scalar_space_constraint(PlannerInfo *root, List *rtable, ScalarArrayOp
 	Oid rettype = dim->partitioning->partfunc.rettype;
 	TypeCacheEntry *tce = lookup_type_cache(rettype, TYPECACHE_EQ_OPR);
 	List *part_values = NIL;
+	List *elements;
 	ListCell *lc;
 
 	/* build FuncExpr to use in eval_const_expressions */
@@ -243,7 +320,46 @@ transform_scalar_space_constraint(PlannerInfo *root, List *rtable, ScalarArrayOp
 											NIL,
 											var->varcollid);
 
-	foreach (lc, lsecond_node(ArrayExpr, op->args)->elements)
+	if (IsA(lsecond(op->args), ArrayExpr))
+		elements = lsecond_node(ArrayExpr, op->args)->elements;
+	else
+	{
+		/*
+		 * For an array-typed Const deconstruct the array into per-element
+		 * Const nodes so the elements can be hashed individually.
+		 */
+		Const *arr = lsecond_node(Const, op->args);
+		Oid element_type = get_element_type(arr->consttype);
+		int16 elmlen;
+		bool elmbyval;
+		char elmalign;
+		Datum *elems;
+		bool *nulls;
+		int nelems;
+
+		get_typlenbyvalalign(element_type, &elmlen, &elmbyval, &elmalign);
+		deconstruct_array(DatumGetArrayTypeP(arr->constvalue),
+						  element_type,
+						  elmlen,
+						  elmbyval,
+						  elmalign,
+						  &elems,
+						  &nulls,
+						  &nelems);
+
+		elements = NIL;
+		for (int i = 0; i < nelems; i++)
+			elements = lappend(elements,
+							   makeConst(element_type,
+										 -1,
+										 arr->constcollid,
+										 elmlen,
+										 elems[i],
+										 nulls[i],
+										 elmbyval));
+	}
+
+	foreach (lc, elements)
 	{
 		Assert(IsA(lfirst(lc), Const) ||
 			   (IsA(lfirst(lc), FuncExpr) &&
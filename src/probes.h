@@ -0,0 +1,59 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include "config.h"
+
+/*
+ * Static tracepoints (USDT) for profiling with perf, bpftrace, or systemtap
+ * without relying on uprobe offsets that change between releases. They are
+ * compiled out by default and enabled with -DUSE_USDT=ON, which requires the
+ * systemtap-sdt development headers. When enabled, each probe compiles to a
+ * single nop until a tracer attaches.
+ *
+ * All probes use the "timescaledb" provider. The probe names and argument
+ * lists below are a stable contract; add new probes or new trailing arguments
+ * instead of changing the existing ones.
+ *
+ *   chunk_route(int32 hypertable_id, Oid chunk_relid, int path)
+ *     A tuple was routed to a chunk. The path says how the chunk was found:
+ *     0 = same chunk as the previous tuple (fast path), 1 = subspace store
+ *     hit, 2 = chunk found in the catalog, 3 = chunk created.
+ *
+ *   copy_flush(Oid chunk_relid, int ntuples, int method)
+ *     A COPY multi-insert buffer was flushed to a chunk. The method is the
+ *     TSCopyInsertMethod of the buffer (see src/copy.c).
+ *
+ *   batch_decompress_start(int num_data_columns)
+ *   batch_decompress_end(int total_rows)
+ *     A compressed batch was set up for decompression in the columnar scan,
+ *     and its setup (including the eagerly decompressed columns) finished.
+ *
+ *   chunk_create(int32 hypertable_id, int32 chunk_id, Oid chunk_relid)
+ *     A new chunk was created, after its table and metadata exist.
+ *
+ *   job_dispatch(int32 job_id, int32 consecutive_failed_launches)
+ *     The scheduler is launching a background worker for a job.
+ */
+#ifdef TS_USE_USDT
+
+#include <sys/sdt.h>
+
+#define TS_PROBE(name) DTRACE_PROBE(timescaledb, name)
+#define TS_PROBE1(name, a1) DTRACE_PROBE1(timescaledb, name, a1)
+#define TS_PROBE2(name, a1, a2) DTRACE_PROBE2(timescaledb, name, a1, a2)
+#define TS_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(timescaledb, name, a1, a2, a3)
+#define TS_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(timescaledb, name, a1, a2, a3, a4)
+
+#else
+
+#define TS_PROBE(name) ((void) 0)
+#define TS_PROBE1(name, a1) ((void) 0)
+#define TS_PROBE2(name, a1, a2) ((void) 0)
+#define TS_PROBE3(name, a1, a2, a3) ((void) 0)
+#define TS_PROBE4(name, a1, a2, a3, a4) ((void) 0)
+
+#endif
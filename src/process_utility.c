@@ -3960,6 +3960,15 @@ process_create_table_end(Node *parsetree)
 				Hypertable *ht = ts_hypertable_get_by_id(ht_id);
 				ts_cm_functions->columnstore_setup(ht, create_table_info.with_clauses);
 			}
+
+			if (!create_table_info.with_clauses[CreateTableFlagUnloggedStaging].is_default &&
+				DatumGetBool(
+					create_table_info.with_clauses[CreateTableFlagUnloggedStaging].parsed))
+			{
+				Hypertable *ht = ts_hypertable_get_by_id(ht_id);
+				ht->fd.status = ts_set_flags_32(ht->fd.status, HYPERTABLE_STATUS_UNLOGGED_STAGING);
+				ts_hypertable_update_status_osm(ht);
+			}
 		}
 	}
 }
@@ -4115,7 +4124,12 @@ process_altertable_chunk_replica_identity(Hypertable *ht, Oid chunk_relid, void
 
 		Assert(OidIsValid(hyper_index_oid));
 
-		Relation chunk_rel = table_open(chunk_relid, AccessExclusiveLock);
+		/*
+		 * Only a catalog lookup happens here, so AccessShareLock is enough.
+		 * The AlterTableInternal() call below acquires its own lock on the
+		 * chunk for the actual replica identity change.
+		 */
+		Relation chunk_rel = table_open(chunk_relid, AccessShareLock);
 		Oid chunk_index_relid =
 			ts_chunk_index_get_by_hypertable_indexrelid(chunk_rel, hyper_index_oid);
 		table_close(chunk_rel, NoLock);
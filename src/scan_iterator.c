@@ -53,6 +53,22 @@ ts_scan_iterator_scan_key_init(ScanIterator *iterator, AttrNumber attributeNumbe
 	MemoryContextSwitchTo(oldmcxt);
 }
 
+TSDLLEXPORT void
+ts_scan_iterator_scan_key_array_init(ScanIterator *iterator, AttrNumber attributeNumber,
+									 StrategyNumber strategy, RegProcedure procedure,
+									 Datum array_argument)
+{
+	/*
+	 * SK_SEARCHARRAY keys are interpreted by the index AM, so they only work
+	 * for index scans. The btree code sorts and deduplicates the array
+	 * internally and streams the matches for all elements in index order from
+	 * a single scan, saving one index descent per key compared to rescanning.
+	 */
+	Assert(OidIsValid(iterator->ctx.index));
+	ts_scan_iterator_scan_key_init(iterator, attributeNumber, strategy, procedure, array_argument);
+	iterator->scankey[iterator->ctx.nkeys - 1].sk_flags |= SK_SEARCHARRAY;
+}
+
 TSDLLEXPORT void
 ts_scan_iterator_rescan(ScanIterator *iterator)
 {
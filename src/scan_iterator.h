@@ -124,6 +124,16 @@ void TSDLLEXPORT ts_scan_iterator_scan_key_init(ScanIterator *iterator, AttrNumb
 												StrategyNumber strategy, RegProcedure procedure,
 												Datum argument);
 
+/*
+ * Initialize a scan key that matches any element of the given array (the
+ * argument must be an array Datum of the attribute's type). Requires an index
+ * scan; all matches are streamed in index order from a single scan.
+ */
+void TSDLLEXPORT ts_scan_iterator_scan_key_array_init(ScanIterator *iterator,
+													  AttrNumber attributeNumber,
+													  StrategyNumber strategy,
+													  RegProcedure procedure, Datum array_argument);
+
 /*
  * Reset the scan to use a new scan key.
  *
@@ -547,6 +547,26 @@ ts_scanner_fetch_heap_tuple(const TupleInfo *ti, bool materialize, bool *should_
 	return ExecFetchSlotHeapTuple(ti->slot, materialize, should_free);
 }
 
+/*
+ * Deform the first natts attributes of the current tuple in a single pass and
+ * return read-only views of the slot's value and null arrays.
+ *
+ * This avoids both repeated slot_getattr() call chains and fetching a heap
+ * tuple just to heap_deform_tuple() it. The returned arrays point into the
+ * slot and are only valid until the scanner advances to the next tuple;
+ * by-reference datums must be copied if they are kept beyond that.
+ */
+void
+ts_scanner_deform_tuple(const TupleInfo *ti, int natts, Datum **values, bool **isnull)
+{
+	TupleTableSlot *slot = ti->slot;
+
+	Assert(natts >= 1 && natts <= slot->tts_tupleDescriptor->natts);
+	slot_getsomeattrs(slot, natts);
+	*values = slot->tts_values;
+	*isnull = slot->tts_isnull;
+}
+
 TupleDesc
 ts_scanner_get_tupledesc(const TupleInfo *ti)
 {
@@ -161,4 +161,6 @@ extern TSDLLEXPORT TupleInfo *ts_scanner_next(ScannerCtx *ctx);
 extern TSDLLEXPORT ItemPointer ts_scanner_get_tuple_tid(TupleInfo *ti);
 extern TSDLLEXPORT HeapTuple ts_scanner_fetch_heap_tuple(const TupleInfo *ti, bool materialize,
 														 bool *should_free);
+extern TSDLLEXPORT void ts_scanner_deform_tuple(const TupleInfo *ti, int natts, Datum **values,
+												bool **isnull);
 extern TSDLLEXPORT TupleDesc ts_scanner_get_tupledesc(const TupleInfo *ti);
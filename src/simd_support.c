@@ -0,0 +1,46 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#include <postgres.h>
+
+#include "simd_support.h"
+
+static TsSimdLevel
+detect_simd_level(void)
+{
+#if defined(TS_USE_X86_SIMD_KERNELS)
+	/*
+	 * Checking for avx512f covers the foundation instructions only, which is
+	 * all the current kernels use. Kernels that need further AVX-512 subsets
+	 * (e.g. VBMI) have to perform their own checks on top of this.
+	 */
+	if (__builtin_cpu_supports("avx512f"))
+		return TS_SIMD_LEVEL_AVX512;
+
+	if (__builtin_cpu_supports("avx2"))
+		return TS_SIMD_LEVEL_AVX2;
+
+	return TS_SIMD_LEVEL_SCALAR;
+#elif defined(TS_USE_NEON_SIMD_KERNELS)
+	return TS_SIMD_LEVEL_NEON;
+#else
+	return TS_SIMD_LEVEL_SCALAR;
+#endif
+}
+
+/*
+ * Returns the highest SIMD level supported by the current CPU. The result is
+ * cached after the first call, so this is cheap enough for per-batch checks.
+ */
+TsSimdLevel
+ts_simd_level(void)
+{
+	static TsSimdLevel level = -1;
+
+	if (level == (TsSimdLevel) -1)
+		level = detect_simd_level();
+
+	return level;
+}
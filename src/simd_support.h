@@ -0,0 +1,42 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+
+/*
+ * Runtime detection of SIMD instruction sets, used to dispatch to vectorized
+ * kernels in the compression codecs and the vectorized executor nodes.
+ *
+ * On x86-64 we detect the supported extensions at runtime with the compiler
+ * builtins, because the baseline target we build for is plain SSE2. The
+ * kernels themselves are compiled with the "target" function attribute, so no
+ * special compiler flags are required. On aarch64, NEON is part of the
+ * baseline ABI, so no runtime detection is needed there and the corresponding
+ * level is reported unconditionally.
+ *
+ * The levels are ordered so that a higher level implies support for all lower
+ * ones on the same architecture.
+ */
+typedef enum TsSimdLevel
+{
+	TS_SIMD_LEVEL_SCALAR = 0,
+	TS_SIMD_LEVEL_NEON,
+	TS_SIMD_LEVEL_AVX2,
+	TS_SIMD_LEVEL_AVX512,
+} TsSimdLevel;
+
+/*
+ * Whether we can compile the x86 SIMD kernels at all. MSVC doesn't support the
+ * target attribute, and 32-bit targets are not worth the trouble.
+ */
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TS_USE_X86_SIMD_KERNELS 1
+#elif defined(__aarch64__)
+#define TS_USE_NEON_SIMD_KERNELS 1
+#endif
+
+extern TSDLLEXPORT TsSimdLevel ts_simd_level(void);
@@ -118,6 +118,31 @@ transform_time_op_const_interval(OpExpr *op)
 	return (Expr *) op;
 }
 
+/*
+ * Check that an integer constant is strictly positive. Multiplying or
+ * dividing by a negative constant reverses the sort order (which we don't
+ * handle yet) and multiplying by zero collapses it, so those transforms only
+ * preserve the ordering for positive constants.
+ */
+static bool
+int_const_is_positive(Const *c)
+{
+	if (c->constisnull)
+		return false;
+
+	switch (c->consttype)
+	{
+		case INT2OID:
+			return DatumGetInt16(c->constvalue) > 0;
+		case INT4OID:
+			return DatumGetInt32(c->constvalue) > 0;
+		case INT8OID:
+			return DatumGetInt64(c->constvalue) > 0;
+		default:
+			return false;
+	}
+}
+
 static inline Expr *
 transform_int_op_const(OpExpr *op)
 {
@@ -126,8 +151,10 @@ transform_int_op_const(OpExpr *op)
 	 * of  some_int + const fulfilled by sort of some_int same for the
 	 * following operator: + - / *
 	 *
-	 * Note that / is not commutative and const / var does NOT work (namely it
-	 * reverses sort order, which we don't handle yet)
+	 * The division case covers bucketing integer time columns by dividing
+	 * with the bucket width: division is monotone (though not injective) in
+	 * the numerator for positive divisors. Note that const / var and
+	 * const - var reverse the sort order, which we don't handle yet.
 	 */
 	if (list_length(op->args) == 2 &&
 		(IsA(lsecond(op->args), Const) || IsA(linitial(op->args), Const)))
@@ -142,36 +169,36 @@ transform_int_op_const(OpExpr *op)
 
 			if (name[1] == '\0')
 			{
+				Expr *nonconst = NULL;
+
 				switch (name[0])
 				{
-					case '-':
 					case '+':
-					case '*':
-						/* commutative cases */
+						/* commutative, monotone for any constant */
 						if (IsA(linitial(op->args), Const))
-						{
-							Expr *nonconst = ts_sort_transform_expr((Expr *) lsecond(op->args));
-
-							if (IsA(nonconst, Var))
-								return copyObject(nonconst);
-						}
+							nonconst = ts_sort_transform_expr((Expr *) lsecond(op->args));
 						else
-						{
-							Expr *nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
-
-							if (IsA(nonconst, Var))
-								return copyObject(nonconst);
-						}
+							nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
 						break;
-					case '/':
-						/* only if second arg is const */
+					case '-':
+						/* only var - const preserves the sort order */
 						if (IsA(lsecond(op->args), Const))
-						{
-							Expr *nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
-
-							if (IsA(nonconst, Var))
-								return copyObject(nonconst);
-						}
+							nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
+						break;
+					case '*':
+						/* commutative, but only for positive constants */
+						if (IsA(linitial(op->args), Const) &&
+							int_const_is_positive(linitial_node(Const, op->args)))
+							nonconst = ts_sort_transform_expr((Expr *) lsecond(op->args));
+						else if (IsA(lsecond(op->args), Const) &&
+								 int_const_is_positive(lsecond_node(Const, op->args)))
+							nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
+						break;
+					case '/':
+						/* only var / positive const preserves the sort order */
+						if (IsA(lsecond(op->args), Const) &&
+							int_const_is_positive(lsecond_node(Const, op->args)))
+							nonconst = ts_sort_transform_expr((Expr *) linitial(op->args));
 						break;
 					default:
 						/*
@@ -180,6 +207,9 @@ transform_int_op_const(OpExpr *op)
 						 */
 						break;
 				}
+
+				if (nonconst != NULL && IsA(nonconst, Var))
+					return copyObject(nonconst);
 			}
 		}
 	}
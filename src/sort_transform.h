@@ -10,7 +10,7 @@
 #include "hypertable.h"
 #include "import/planner.h"
 
-extern Expr *ts_sort_transform_expr(Expr *expr);
+extern TSDLLEXPORT Expr *ts_sort_transform_expr(Expr *expr);
 
 extern List *ts_sort_transform_get_pathkeys(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte,
 											Hypertable *ht);
@@ -4,6 +4,7 @@
  * LICENSE-APACHE for a copy of the license.
  */
 #include <postgres.h>
+#include <utils/hsearch.h>
 #include <utils/memutils.h>
 
 #include "dimension.h"
@@ -35,8 +36,49 @@ typedef struct SubspaceStore
 	/* limit growth of store by  limiting number of slices in first dimension,	0 for no limit */
 	uint16 max_items;
 	SubspaceStoreInternalNode *origin; /* origin of the tree */
+
+	/*
+	 * Usage stamps of the first-dimension slices, keyed by the slice id, for
+	 * the least-recently-used eviction when max_items is exceeded. NULL when
+	 * the store is unlimited.
+	 */
+	HTAB *usage;
+	uint64 usage_counter;
 } SubspaceStore;
 
+typedef struct SubspaceStoreUsageEntry
+{
+	int32 slice_id;
+	uint64 last_used;
+} SubspaceStoreUsageEntry;
+
+/*
+ * Mark a first-dimension slice as just used.
+ */
+static void
+subspace_store_touch_slice(SubspaceStore *subspace_store, const DimensionSlice *slice)
+{
+	if (subspace_store->usage == NULL)
+		return;
+
+	bool found;
+	SubspaceStoreUsageEntry *entry =
+		hash_search(subspace_store->usage, &slice->fd.id, HASH_ENTER, &found);
+	entry->last_used = ++subspace_store->usage_counter;
+}
+
+/*
+ * Get the usage stamp of a first-dimension slice. A slice without an entry
+ * counts as never used.
+ */
+static uint64
+subspace_store_slice_last_used(const SubspaceStore *subspace_store, const DimensionSlice *slice)
+{
+	SubspaceStoreUsageEntry *entry =
+		hash_search(subspace_store->usage, &slice->fd.id, HASH_FIND, NULL);
+	return entry == NULL ? 0 : entry->last_used;
+}
+
 static inline SubspaceStoreInternalNode *
 subspace_store_internal_node_create(bool last_internal_node)
 {
@@ -80,6 +122,22 @@ ts_subspace_store_init(const Hyperspace *space, MemoryContext mcxt, int16 max_it
 	/* max_items = 0 is treated as unlimited */
 	sst->max_items = max_items;
 	sst->mcxt = mcxt;
+	sst->usage = NULL;
+	sst->usage_counter = 0;
+
+	if (max_items > 0)
+	{
+		HASHCTL hctl = {
+			.keysize = sizeof(int32),
+			.entrysize = sizeof(SubspaceStoreUsageEntry),
+			.hcxt = mcxt,
+		};
+		sst->usage = hash_create("subspace store slice usage",
+								 max_items,
+								 &hctl,
+								 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
 	MemoryContextSwitchTo(old);
 	return sst;
 }
@@ -132,15 +190,14 @@ ts_subspace_store_add(SubspaceStore *subspace_store, const Hypercube *hypercube,
 		if (subspace_store->max_items > 0 && node->descendants > subspace_store->max_items)
 		{
 			/*
-			 * Always delete the slice corresponding to the earliest time
-			 * range. In the normal case that inserts are performed in
-			 * time-order this is the one least likely to be reused. (Note
-			 * that we made sure that the first dimension is a time dimension
-			 * when creating the subspace_store). If out-of-order inserts are
-			 * become significant we may wish to change this to something more
-			 * sophisticated like LRU.
+			 * Delete the least recently used slice. Inserts performed in
+			 * time-order keep evicting the earliest time range, as before, but
+			 * an out-of-order backfill that keeps revisiting a handful of
+			 * chunks retains them instead of cycling the whole store.
 			 */
-			size_t items_removed = subspace_store_internal_node_descendants(node, i);
+			int evict_index = 0;
+			uint64 evict_last_used = PG_UINT64_MAX;
+			size_t items_removed;
 
 			/*
 			 * descendants at the root is inclusive of the descendants at the
@@ -150,7 +207,25 @@ ts_subspace_store_add(SubspaceStore *subspace_store, const Hypercube *hypercube,
 
 			Assert(subspace_store->max_items + 1 == node->descendants);
 
-			ts_dimension_vec_remove_slice(&node->vector, i);
+			for (int j = 0; j < node->vector->num_slices; j++)
+			{
+				uint64 last_used =
+					subspace_store_slice_last_used(subspace_store, node->vector->slices[j]);
+
+				if (last_used < evict_last_used)
+				{
+					evict_index = j;
+					evict_last_used = last_used;
+				}
+			}
+
+			items_removed = subspace_store_internal_node_descendants(node, evict_index);
+
+			hash_search(subspace_store->usage,
+						&node->vector->slices[evict_index]->fd.id,
+						HASH_REMOVE,
+						NULL);
+			ts_dimension_vec_remove_slice(&node->vector, evict_index);
 
 			/*
 			 * Note we would have to do this to ancestors if this was not the
@@ -176,6 +251,9 @@ ts_subspace_store_add(SubspaceStore *subspace_store, const Hypercube *hypercube,
 			match = copy;
 		}
 
+		if (i == 0)
+			subspace_store_touch_slice(subspace_store, match);
+
 		Assert(subspace_store->max_items == 0 ||
 			   node->descendants <= (size_t) subspace_store->max_items);
 
@@ -191,7 +269,7 @@ ts_subspace_store_add(SubspaceStore *subspace_store, const Hypercube *hypercube,
 }
 
 void *
-ts_subspace_store_get(const SubspaceStore *subspace_store, const Point *target)
+ts_subspace_store_get(SubspaceStore *subspace_store, const Point *target)
 {
 	int i;
 	DimensionVec *vec = subspace_store->origin->vector;
@@ -212,6 +290,9 @@ ts_subspace_store_get(const SubspaceStore *subspace_store, const Point *target)
 		if (NULL == match)
 			return NULL;
 
+		if (i == 0)
+			subspace_store_touch_slice(subspace_store, match);
+
 		vec = ((SubspaceStoreInternalNode *) match->storage)->vector;
 	}
 	Assert(match != NULL);
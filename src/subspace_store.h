@@ -28,6 +28,6 @@ extern void ts_subspace_store_add(SubspaceStore *subspace_store, const Hypercube
 /* Get the object stored for the subspace that a point is in.
  * Return the object stored or NULL if this subspace is not in the store.
  */
-extern void *ts_subspace_store_get(const SubspaceStore *subspace_store, const Point *target);
+extern void *ts_subspace_store_get(SubspaceStore *subspace_store, const Point *target);
 extern void ts_subspace_store_free(SubspaceStore *subspace_store);
 extern MemoryContext ts_subspace_store_mcxt(const SubspaceStore *subspace_store);
@@ -15,6 +15,7 @@
 #include <fmgr.h>
 #include <storage/lmgr.h>
 #include <utils/builtins.h>
+#include <utils/hsearch.h>
 #include <utils/snapmgr.h>
 #include <utils/syscache.h>
 
@@ -31,8 +32,35 @@ typedef struct StatsContext
 {
 	TelemetryStats *stats;
 	Snapshot snapshot;
+	Cache *htcache;
+
+	/*
+	 * Prefetched catalog state, so that classifying a pg_class row costs a
+	 * hash table lookup instead of several catalog scans per relation. See
+	 * build_chunk_lookup() and build_compression_size_lookup().
+	 */
+	HTAB *chunk_lookup;
+	HTAB *compression_size_lookup;
 } StatsContext;
 
+/*
+ * The fields of a chunk catalog row that are needed to classify a pg_class
+ * entry as a chunk and to attribute its stats, hashed by the chunk's relid.
+ */
+typedef struct ChunkLookupEntry
+{
+	Oid relid;
+	int32 chunk_id;
+	int32 hypertable_id;
+	int32 status;
+} ChunkLookupEntry;
+
+typedef struct CompressionSizeLookupEntry
+{
+	int32 chunk_id;
+	FormData_compression_chunk_size fd;
+} CompressionSizeLookupEntry;
+
 /*
  * Determine the type of a hypertable.
  */
@@ -59,13 +87,13 @@ classify_hypertable(const Hypertable *ht)
 }
 
 static StatsRelType
-classify_chunk(Cache *htcache, const Hypertable **ht, const Chunk *chunk)
+classify_chunk(const StatsContext *statsctx, const Hypertable **ht, const ChunkLookupEntry *chunk)
 {
 	StatsRelType parent_reltype;
 
 	Assert(NULL != chunk);
 	/* Classify the chunk's parent */
-	*ht = ts_hypertable_cache_get_entry(htcache, chunk->hypertable_relid, CACHE_FLAG_MISSING_OK);
+	*ht = ts_hypertable_cache_get_entry_by_id(statsctx->htcache, chunk->hypertable_id);
 	Assert(NULL != *ht);
 	parent_reltype = classify_hypertable(*ht);
 
@@ -85,8 +113,8 @@ classify_chunk(Cache *htcache, const Hypertable **ht, const Chunk *chunk)
 }
 
 static StatsRelType
-classify_table(const Form_pg_class class, Cache *htcache, const Hypertable **ht,
-			   const Chunk **chunk)
+classify_table(const StatsContext *statsctx, const Form_pg_class class, const Hypertable **ht,
+			   const ChunkLookupEntry **chunk)
 {
 	Assert(class->relkind == RELKIND_RELATION);
 
@@ -94,16 +122,16 @@ classify_table(const Form_pg_class class, Cache *htcache, const Hypertable **ht,
 		return RELTYPE_PARTITION;
 
 	/* Check if it is a hypertable */
-	*ht = ts_hypertable_cache_get_entry(htcache, class->oid, CACHE_FLAG_MISSING_OK);
+	*ht = ts_hypertable_cache_get_entry(statsctx->htcache, class->oid, CACHE_FLAG_MISSING_OK);
 
 	if (*ht)
 		return classify_hypertable(*ht);
 
 	/* Check if it is a chunk */
-	*chunk = ts_chunk_get_by_relid(class->oid, false);
+	*chunk = hash_search(statsctx->chunk_lookup, &class->oid, HASH_FIND, NULL);
 
 	if (NULL != *chunk)
-		return classify_chunk(htcache, ht, *chunk);
+		return classify_chunk(statsctx, ht, *chunk);
 
 	return RELTYPE_TABLE;
 }
@@ -125,12 +153,13 @@ classify_partitioned_table(const Form_pg_class class)
 }
 
 static StatsRelType
-classify_foreign_table(Cache *htcache, Oid relid, const Hypertable **ht, const Chunk **chunk)
+classify_foreign_table(const StatsContext *statsctx, Oid relid, const Hypertable **ht,
+					   const ChunkLookupEntry **chunk)
 {
-	*chunk = ts_chunk_get_by_relid(relid, false);
+	*chunk = hash_search(statsctx->chunk_lookup, &relid, HASH_FIND, NULL);
 
 	if (*chunk)
-		return classify_chunk(htcache, ht, *chunk);
+		return classify_chunk(statsctx, ht, *chunk);
 
 	/*
 	 * Currently don't care about non-chunk foreign tables, so classify as
@@ -140,7 +169,7 @@ classify_foreign_table(Cache *htcache, Oid relid, const Hypertable **ht, const C
 }
 
 static StatsRelType
-classify_view(const Form_pg_class class, Cache *htcache, const ContinuousAgg **cagg)
+classify_view(const Form_pg_class class, const ContinuousAgg **cagg)
 {
 	const Catalog *catalog = ts_catalog_get();
 
@@ -156,8 +185,8 @@ classify_view(const Form_pg_class class, Cache *htcache, const ContinuousAgg **c
 }
 
 static StatsRelType
-classify_relation(const Form_pg_class class, Cache *htcache, const Hypertable **ht,
-				  const Chunk **chunk, const ContinuousAgg **cagg)
+classify_relation(const StatsContext *statsctx, const Form_pg_class class, const Hypertable **ht,
+				  const ChunkLookupEntry **chunk, const ContinuousAgg **cagg)
 {
 	*chunk = NULL;
 	*ht = NULL;
@@ -166,15 +195,15 @@ classify_relation(const Form_pg_class class, Cache *htcache, const Hypertable **
 	switch (class->relkind)
 	{
 		case RELKIND_RELATION:
-			return classify_table(class, htcache, ht, chunk);
+			return classify_table(statsctx, class, ht, chunk);
 		case RELKIND_PARTITIONED_TABLE:
 			return classify_partitioned_table(class);
 		case RELKIND_FOREIGN_TABLE:
-			return classify_foreign_table(htcache, class->oid, ht, chunk);
+			return classify_foreign_table(statsctx, class->oid, ht, chunk);
 		case RELKIND_MATVIEW:
 			return RELTYPE_MATVIEW;
 		case RELKIND_VIEW:
-			return classify_view(class, htcache, cagg);
+			return classify_view(class, cagg);
 		default:
 			return RELTYPE_OTHER;
 	}
@@ -264,12 +293,12 @@ process_partition(HyperStats *stats, Form_pg_class class, bool ischunk)
  * Add a chunk's stats to the parent table.
  */
 static void
-add_chunk_stats(HyperStats *stats, Form_pg_class class, const Chunk *chunk,
+add_chunk_stats(HyperStats *stats, Form_pg_class class, const ChunkLookupEntry *chunk,
 				const Form_compression_chunk_size fd_compr)
 {
 	process_partition(stats, class, true);
 
-	if (ts_chunk_is_compressed(chunk))
+	if (ts_flags_are_set_32(chunk->status, CHUNK_STATUS_COMPRESSED))
 		stats->compressed_chunk_count++;
 
 	if (fd_compr)
@@ -292,47 +321,22 @@ add_chunk_stats(HyperStats *stats, Form_pg_class class, const Chunk *chunk,
 }
 
 static bool
-get_chunk_compression_stats(StatsContext *statsctx, const Chunk *chunk,
+get_chunk_compression_stats(StatsContext *statsctx, const ChunkLookupEntry *chunk,
 							Form_compression_chunk_size compr_stats)
 {
-	TupleInfo *ti;
-	ScanIterator it;
-	bool found = false;
+	const CompressionSizeLookupEntry *entry;
 
-	if (!ts_chunk_is_compressed(chunk))
+	if (!ts_flags_are_set_32(chunk->status, CHUNK_STATUS_COMPRESSED))
 		return false;
 
-	it = ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, AccessShareLock, CurrentMemoryContext);
-	ts_scan_iterator_set_index(&it, COMPRESSION_CHUNK_SIZE, COMPRESSION_CHUNK_SIZE_PKEY);
-	it.ctx.snapshot = statsctx->snapshot;
-
-	ts_scan_iterator_scan_key_reset(&it);
-	ts_scan_iterator_scan_key_init(&it,
-								   Anum_compression_chunk_size_pkey_chunk_id,
-								   BTEqualStrategyNumber,
-								   F_INT4EQ,
-								   Int32GetDatum(chunk->fd.id));
-	ts_scan_iterator_start_or_restart_scan(&it);
-	ti = ts_scan_iterator_next(&it);
-
-	if (ti)
-	{
-		Form_compression_chunk_size fd;
-		bool should_free;
-		HeapTuple tuple = ts_scan_iterator_fetch_heap_tuple(&it, false, &should_free);
+	entry = hash_search(statsctx->compression_size_lookup, &chunk->chunk_id, HASH_FIND, NULL);
 
-		fd = (Form_compression_chunk_size) GETSTRUCT(tuple);
-		memcpy(compr_stats, fd, sizeof(*fd));
-
-		if (should_free)
-			heap_freetuple(tuple);
-
-		found = true;
-	}
+	if (NULL == entry)
+		return false;
 
-	ts_scan_iterator_close(&it);
+	memcpy(compr_stats, &entry->fd, sizeof(*compr_stats));
 
-	return found;
+	return true;
 }
 
 /*
@@ -357,7 +361,7 @@ get_chunk_compression_stats(StatsContext *statsctx, const Chunk *chunk,
  */
 static void
 process_chunk(StatsContext *statsctx, StatsRelType chunk_reltype, Form_pg_class class,
-			  const Chunk *chunk)
+			  const ChunkLookupEntry *chunk)
 {
 	TelemetryStats *stats = statsctx->stats;
 	FormData_compression_chunk_size comp_stats_data;
@@ -425,9 +429,100 @@ should_ignore_relation(const Catalog *catalog, Form_pg_class class)
 			is_ts_schema(catalog, class->relnamespace) || ts_is_catalog_table(class->oid));
 }
 
+/*
+ * Prefetch the chunk catalog into a hash table keyed by the chunk's relid.
+ *
+ * Classification previously probed the chunk catalog by relation name for
+ * every pg_class row that was not a hypertable, and built a full Chunk with
+ * its dimension slices and constraints on a hit. On databases with tens of
+ * thousands of relations these per-relation scans were the bulk of the
+ * telemetry collection cost. A single scan of the chunk catalog gathers the
+ * few fields that classification actually needs.
+ */
+static HTAB *
+build_chunk_lookup(const StatsContext *statsctx)
+{
+	HASHCTL info = {
+		.keysize = sizeof(Oid),
+		.entrysize = sizeof(ChunkLookupEntry),
+		.hcxt = CurrentMemoryContext,
+	};
+	HTAB *lookup =
+		hash_create("TelemetryChunkLookup", 256, &info, HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	ScanIterator it = ts_scan_iterator_create(CHUNK, AccessShareLock, CurrentMemoryContext);
+	it.ctx.snapshot = statsctx->snapshot;
+
+	ts_scanner_foreach(&it)
+	{
+		TupleInfo *ti = ts_scan_iterator_tuple_info(&it);
+		FormData_chunk fd;
+		ChunkLookupEntry *entry;
+		Oid relid;
+
+		ts_chunk_formdata_fill(&fd, ti);
+
+		/* The chunk's table can be concurrently dropped. The pg_class row of
+		 * such a chunk cannot be encountered, so just skip it. */
+		relid = ts_get_relation_relid(NameStr(fd.schema_name), NameStr(fd.table_name), true);
+		if (!OidIsValid(relid))
+			continue;
+
+		entry = hash_search(lookup, &relid, HASH_ENTER, NULL);
+		entry->chunk_id = fd.id;
+		entry->hypertable_id = fd.hypertable_id;
+		entry->status = fd.status;
+	}
+	ts_scan_iterator_close(&it);
+
+	return lookup;
+}
+
+/*
+ * Prefetch the compression size metadata into a hash table keyed by chunk id,
+ * replacing one indexed scan per compressed chunk with a single scan of the
+ * metadata table.
+ */
+static HTAB *
+build_compression_size_lookup(const StatsContext *statsctx)
+{
+	HASHCTL info = {
+		.keysize = sizeof(int32),
+		.entrysize = sizeof(CompressionSizeLookupEntry),
+		.hcxt = CurrentMemoryContext,
+	};
+	HTAB *lookup = hash_create("TelemetryCompressionSizeLookup",
+							   256,
+							   &info,
+							   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	ScanIterator it =
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, AccessShareLock, CurrentMemoryContext);
+	it.ctx.snapshot = statsctx->snapshot;
+
+	ts_scanner_foreach(&it)
+	{
+		CompressionSizeLookupEntry *entry;
+		bool should_free;
+		HeapTuple tuple = ts_scan_iterator_fetch_heap_tuple(&it, false, &should_free);
+		Form_compression_chunk_size fd = (Form_compression_chunk_size) GETSTRUCT(tuple);
+
+		entry = hash_search(lookup, &fd->chunk_id, HASH_ENTER, NULL);
+		memcpy(&entry->fd, fd, sizeof(entry->fd));
+
+		if (should_free)
+			heap_freetuple(tuple);
+	}
+	ts_scan_iterator_close(&it);
+
+	return lookup;
+}
+
 /*
  * Scan the entire pg_class catalog table for all relations. For each
  * relation, classify it and gather stats based on the classification.
+ *
+ * The chunk and compression size catalogs are prefetched into hash tables up
+ * front, so the per-relation work is bounded by the pg_class scan itself plus
+ * the relation size lookups.
  */
 void
 ts_telemetry_stats_gather(TelemetryStats *stats)
@@ -440,9 +535,12 @@ ts_telemetry_stats_gather(TelemetryStats *stats)
 	StatsContext statsctx = {
 		.stats = stats,
 		.snapshot = GetActiveSnapshot(),
+		.htcache = htcache,
 	};
 
 	MemSet(stats, 0, sizeof(*stats));
+	statsctx.chunk_lookup = build_chunk_lookup(&statsctx);
+	statsctx.compression_size_lookup = build_compression_size_lookup(&statsctx);
 	rel = table_open(RelationRelationId, AccessShareLock);
 	scan = systable_beginscan(rel, ClassOidIndexId, false, NULL, 0, NULL);
 	relmcxt = AllocSetContextCreate(CurrentMemoryContext, "RelationStats", ALLOCSET_DEFAULT_SIZES);
@@ -452,7 +550,7 @@ ts_telemetry_stats_gather(TelemetryStats *stats)
 		HeapTuple tup;
 		Form_pg_class class;
 		StatsRelType reltype;
-		const Chunk *chunk = NULL;
+		const ChunkLookupEntry *chunk = NULL;
 		const Hypertable *ht = NULL;
 		const ContinuousAgg *cagg = NULL;
 
@@ -486,7 +584,7 @@ ts_telemetry_stats_gather(TelemetryStats *stats)
 		oldmcxt = MemoryContextSwitchTo(relmcxt);
 		MemoryContextReset(relmcxt);
 
-		reltype = classify_relation(class, htcache, &ht, &chunk, &cagg);
+		reltype = classify_relation(&statsctx, class, &ht, &chunk, &cagg);
 
 		DEBUG_WAITPOINT("telemetry_classify_relation");
 
@@ -537,5 +635,7 @@ ts_telemetry_stats_gather(TelemetryStats *stats)
 	systable_endscan(scan);
 	table_close(rel, AccessShareLock);
 	ts_cache_release(&htcache);
+	hash_destroy(statsctx.chunk_lookup);
+	hash_destroy(statsctx.compression_size_lookup);
 	MemoryContextDelete(relmcxt);
 }
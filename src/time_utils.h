@@ -83,6 +83,30 @@
 #define TS_TIME_NOT_FINITE(timeval, type)                                                          \
 	(IS_INTEGER_TYPE(type) || TS_TIME_IS_NOBEGIN(timeval, type) || TS_TIME_IS_NOEND(timeval, type))
 
+/*
+ * Convert a TIMESTAMP or TIMESTAMPTZ value to internal (Unix epoch)
+ * microseconds.
+ *
+ * This is an inline counterpart of ts_pg_timestamp_to_unix_microseconds for
+ * hot per-row paths like tuple routing, where the fmgr call and the Datum
+ * special-value lookups add measurable per-value overhead.
+ */
+static inline int64
+ts_timestamp_value_to_internal(TimestampTz timestamp)
+{
+	if (TIMESTAMP_IS_NOBEGIN(timestamp))
+		return TS_TIME_NOBEGIN;
+
+	if (TIMESTAMP_IS_NOEND(timestamp))
+		return TS_TIME_NOEND;
+
+	if (timestamp < TS_TIMESTAMP_MIN || timestamp >= TS_TIMESTAMP_END)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE), errmsg("timestamp out of range")));
+
+	return timestamp + TS_EPOCH_DIFF_MICROSECONDS;
+}
+
 extern TSDLLEXPORT int64 ts_time_value_from_arg(Datum arg, Oid argtype, Oid timetype,
 												bool need_now_func);
 extern TSDLLEXPORT Datum ts_time_datum_convert_arg(Datum arg, Oid *argtype, Oid timetype);
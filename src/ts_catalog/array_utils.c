@@ -5,6 +5,7 @@
  */
 #include <postgres.h>
 
+#include <access/tupmacs.h>
 #include <catalog/pg_collation.h>
 #include <catalog/pg_type.h>
 #include <fmgr.h>
@@ -62,23 +63,25 @@ ts_array_equal(ArrayType *left, ArrayType *right)
 	return DatumGetBool(result);
 }
 
-extern TSDLLEXPORT bool
-ts_array_is_member(ArrayType *arr, const char *name)
+/*
+ * Return the 1-based position of the first element matching the given name,
+ * or 0 if there is no match.
+ *
+ * This is the hot path behind segmentby/orderby lookups, which run once per
+ * column during compression planning. Walk the packed array data directly
+ * instead of going through an ArrayIterator, so that no per-element
+ * text-to-cstring copies are allocated.
+ */
+static int
+text_array_position(ArrayType *arr, const char *name)
 {
-	bool ret = false;
-	Datum datum;
-	bool null;
-	if (!arr || ARR_NDIM(arr) == 0)
-		return ret;
+	const char *ptr = ARR_DATA_PTR(arr);
+	const bits8 *bitmap = ARR_NULLBITMAP(arr);
+	int nelems = ARR_DIMS(arr)[0];
+	size_t namelen = strlen(name);
 
-	Assert(ARR_NDIM(arr) == 1);
-	Assert(arr->elemtype == TEXTOID);
-	Assert(name);
-
-	ArrayIterator it = array_create_iterator(arr, 0, NULL);
-	while (array_iterate(it, &datum, &null))
+	for (int i = 0; i < nelems; i++)
 	{
-		Assert(!null);
 		/*
 		 * Our internal catalog arrays should either be NULL or
 		 * have non-NULL members. During normal operation it should
@@ -86,16 +89,43 @@ ts_array_is_member(ArrayType *arr, const char *name)
 		 * the catalog is corrupted or some catalog tampering has
 		 * happened.
 		 */
-		Ensure(!null, "array element was NULL");
-		if (strncmp(TextDatumGetCString(datum), name, NAMEDATALEN) == 0)
+		Ensure(bitmap == NULL || (bitmap[i / 8] & (1 << (i % 8))) != 0,
+			   "array element was NULL");
+
+		ptr = (const char *) att_align_pointer(ptr, TYPALIGN_INT, -1, ptr);
+
+		if (unlikely(VARATT_IS_COMPRESSED(ptr) || VARATT_IS_EXTERNAL(ptr)))
 		{
-			ret = true;
-			break;
+			/* Column names are too short to be compressed inline, but don't
+			 * compare raw bytes if that ever happens. */
+			struct varlena *elem = pg_detoast_datum((struct varlena *) ptr);
+			bool match = VARSIZE_ANY_EXHDR(elem) == namelen &&
+						 memcmp(VARDATA_ANY(elem), name, namelen) == 0;
+			if ((const char *) elem != ptr)
+				pfree(elem);
+			if (match)
+				return i + 1;
 		}
+		else if (VARSIZE_ANY_EXHDR(ptr) == namelen && memcmp(VARDATA_ANY(ptr), name, namelen) == 0)
+			return i + 1;
+
+		ptr += VARSIZE_ANY(ptr);
 	}
 
-	array_free_iterator(it);
-	return ret;
+	return 0;
+}
+
+extern TSDLLEXPORT bool
+ts_array_is_member(ArrayType *arr, const char *name)
+{
+	if (!arr || ARR_NDIM(arr) == 0)
+		return false;
+
+	Assert(ARR_NDIM(arr) == 1);
+	Assert(arr->elemtype == TEXTOID);
+	Assert(name);
+
+	return text_array_position(arr, name) != 0;
 }
 
 extern TSDLLEXPORT void
@@ -137,37 +167,13 @@ ts_array_append_stringinfo(ArrayType *arr, StringInfo info)
 extern TSDLLEXPORT int
 ts_array_position(ArrayType *arr, const char *name)
 {
-	int pos = 0;
-	Datum datum;
-	bool found = false;
-	bool null;
 	if (!arr || ARR_NDIM(arr) == 0)
-		return pos;
+		return 0;
 
 	Assert(ARR_NDIM(arr) == 1);
 	Assert(arr->elemtype == TEXTOID);
 
-	ArrayIterator it = array_create_iterator(arr, 0, NULL);
-	while (array_iterate(it, &datum, &null))
-	{
-		pos++;
-		/*
-		 * Our internal catalog arrays should either be NULL or
-		 * have non-NULL members. During normal operation it should
-		 * never have NULL members. If we have NULL members either
-		 * the catalog is corrupted or some catalog tampering has
-		 * happened.
-		 */
-		Ensure(!null, "array element was NULL");
-		if (strncmp(TextDatumGetCString(datum), name, NAMEDATALEN) == 0)
-		{
-			found = true;
-			break;
-		}
-	}
-
-	array_free_iterator(it);
-	return found ? pos : 0;
+	return text_array_position(arr, name);
 }
 
 extern TSDLLEXPORT ArrayType *
@@ -11,6 +11,7 @@
 #include <catalog/pg_namespace.h>
 #include <commands/dbcommands.h>
 #include <commands/sequence.h>
+#include <executor/tuptable.h>
 #include <miscadmin.h>
 #include <utils/builtins.h>
 #include <utils/inval.h>
@@ -19,6 +20,7 @@
 #include <utils/syscache.h>
 
 #include "compat/compat.h"
+#include "annotations.h"
 #include "cache_invalidate.h"
 #include "extension.h"
 #include "ts_catalog/catalog.h"
@@ -314,6 +316,7 @@ static const InternalFunctionDef internal_function_definitions[_MAX_INTERNAL_FUN
  * sql/cache.sql */
 static const char *cache_proxy_table_names[_MAX_CACHE_TYPES] = {
 	[CACHE_TYPE_HYPERTABLE] = "cache_inval_hypertable",
+	[CACHE_TYPE_CHUNK] = "cache_inval_chunk",
 	[CACHE_TYPE_BGW_JOB] = "cache_inval_bgw_job",
 	[CACHE_TYPE_EXTENSION] = "cache_inval_extension",
 };
@@ -393,6 +396,31 @@ ts_catalog_database_info_get()
 	return &database_info;
 }
 
+/*
+ * Look up a schema OID, memoizing resolved schemas in the caller-provided
+ * arrays. The catalog tables are spread over only a few schemas, so resolving
+ * each schema once instead of once per relation saves a syscache probe for
+ * every table and index resolved during catalog initialization.
+ */
+static Oid
+catalog_namespace_oid_memoized(const char *schema_name, const char **schema_names, Oid *schema_oids,
+							   int *num_schemas)
+{
+	int i;
+
+	for (i = 0; i < *num_schemas; i++)
+	{
+		if (strcmp(schema_names[i], schema_name) == 0)
+			return schema_oids[i];
+	}
+
+	Assert(*num_schemas < _TS_MAX_SCHEMA);
+	schema_names[*num_schemas] = schema_name;
+	schema_oids[*num_schemas] = get_namespace_oid(schema_name, false);
+
+	return schema_oids[(*num_schemas)++];
+}
+
 /*
  * The rest of the arguments are used to populate the first arg.
  */
@@ -401,17 +429,23 @@ ts_catalog_table_info_init(CatalogTableInfo *tables_info, int max_tables,
 						   const TableInfoDef *table_ary, const TableIndexDef *index_ary,
 						   const char **serial_id_ary)
 {
+	const char *schema_names[_TS_MAX_SCHEMA];
+	Oid schema_oids[_TS_MAX_SCHEMA];
+	int num_schemas = 0;
 	int i;
 
 	for (i = 0; i < max_tables; i++)
 	{
 		Oid id;
+		Oid schema_oid;
 		const char *sequence_name;
 		Size number_indexes, j;
 
-		id = ts_get_relation_relid((char *) table_ary[i].schema_name,
-								   (char *) table_ary[i].table_name,
-								   false);
+		schema_oid = catalog_namespace_oid_memoized(table_ary[i].schema_name,
+													schema_names,
+													schema_oids,
+													&num_schemas);
+		id = get_relname_relid(table_ary[i].table_name, schema_oid);
 
 		if (!OidIsValid(id))
 			elog(ERROR,
@@ -426,7 +460,7 @@ ts_catalog_table_info_init(CatalogTableInfo *tables_info, int max_tables,
 
 		for (j = 0; j < number_indexes; j++)
 		{
-			id = ts_get_relation_relid(table_ary[i].schema_name, index_ary[i].names[j], true);
+			id = get_relname_relid(index_ary[i].names[j], schema_oid);
 
 			if (!OidIsValid(id))
 				elog(ERROR, "OID lookup failed for table index \"%s\"", index_ary[i].names[j]);
@@ -484,6 +518,7 @@ ts_catalog_get(void)
 							  s_catalog.extension_schema_id[TS_CACHE_SCHEMA]);
 
 	ts_cache_invalidate_set_proxy_tables(s_catalog.caches[CACHE_TYPE_HYPERTABLE].inval_proxy_id,
+										 s_catalog.caches[CACHE_TYPE_CHUNK].inval_proxy_id,
 										 s_catalog.caches[CACHE_TYPE_BGW_JOB].inval_proxy_id);
 
 	for (i = 0; i < _MAX_INTERNAL_FUNCTIONS; i++)
@@ -518,7 +553,7 @@ ts_catalog_reset(void)
 	s_catalog.initialized = false;
 	database_info.database_id = InvalidOid;
 
-	ts_cache_invalidate_set_proxy_tables(InvalidOid, InvalidOid);
+	ts_cache_invalidate_set_proxy_tables(InvalidOid, InvalidOid, InvalidOid);
 }
 
 static CatalogTable
@@ -657,6 +692,44 @@ ts_catalog_insert_values(Relation rel, TupleDesc tupdesc, Datum *values, bool *n
 	heap_freetuple(tuple);
 }
 
+/*
+ * Insert multiple new rows into a catalog table.
+ *
+ * The rows are written with a single multi-insert and the catalog indexes
+ * are opened and updated once for the whole batch, which is cheaper than
+ * repeated ts_catalog_insert() calls when inserting many rows at once.
+ */
+TSDLLEXPORT void
+ts_catalog_multi_insert(Relation rel, int ntuples, HeapTuple *tuples)
+{
+	CatalogIndexState indstate;
+	TupleTableSlot **slots;
+	int i;
+
+	if (ntuples <= 0)
+		return;
+
+	slots = palloc(sizeof(TupleTableSlot *) * ntuples);
+
+	for (i = 0; i < ntuples; i++)
+	{
+		slots[i] = MakeSingleTupleTableSlot(RelationGetDescr(rel), &TTSOpsHeapTuple);
+		ExecStoreHeapTuple(tuples[i], slots[i], false);
+	}
+
+	indstate = CatalogOpenIndexes(rel);
+	CatalogTuplesMultiInsertWithInfo(rel, slots, ntuples, indstate);
+	CatalogCloseIndexes(indstate);
+
+	for (i = 0; i < ntuples; i++)
+		ExecDropSingleTupleTableSlot(slots[i]);
+
+	pfree(slots);
+	ts_catalog_invalidate_cache(RelationGetRelid(rel), CMD_INSERT);
+	/* Make changes visible */
+	CommandCounterIncrement();
+}
+
 TSDLLEXPORT void
 ts_catalog_insert_datums(Relation rel, TupleDesc tupdesc, NullableDatum *datums)
 {
@@ -733,6 +806,27 @@ ts_catalog_invalidate_cache(Oid catalog_relid, CmdType operation)
 	switch (table)
 	{
 		case CHUNK:
+			if (operation == CMD_INSERT)
+			{
+				/*
+				 * Chunk creation must reach backends that cache chunk
+				 * exclusion or planning results, but does not make any cached
+				 * hypertable metadata stale. Signal on the chunk proxy so
+				 * that backends do not rebuild their hypertable caches every
+				 * time a chunk is created.
+				 */
+				relid = ts_catalog_get_cache_proxy_id(catalog, CACHE_TYPE_CHUNK);
+				/* The chunk proxy table may not exist yet when updating from
+				 * an older version */
+				if (OidIsValid(relid))
+					CacheInvalidateRelcacheByRelid(relid);
+			}
+			else
+			{
+				relid = ts_catalog_get_cache_proxy_id(catalog, CACHE_TYPE_HYPERTABLE);
+				CacheInvalidateRelcacheByRelid(relid);
+			}
+			break;
 		case CHUNK_CONSTRAINT:
 		case DIMENSION_SLICE:
 			if (operation == CMD_UPDATE || operation == CMD_DELETE)
@@ -742,6 +836,30 @@ ts_catalog_invalidate_cache(Oid catalog_relid, CmdType operation)
 			}
 			break;
 		case HYPERTABLE:
+			if (operation == CMD_UPDATE)
+			{
+				/*
+				 * An update of an existing hypertable row concerns exactly one
+				 * hypertable. The updating backend invalidates the relcache
+				 * entry of that hypertable's root table, which evicts only the
+				 * affected entry from the per-backend hypertable caches (see
+				 * hypertable_update_catalog_tuple()). Here, only flush the
+				 * chunk-level caches broadly since cached planning results may
+				 * depend on, e.g., the compression state. Inserts and deletes
+				 * keep the full flush since they must also replace negative
+				 * cache entries.
+				 */
+				relid = ts_catalog_get_cache_proxy_id(catalog, CACHE_TYPE_CHUNK);
+
+				/* The chunk proxy table may not exist yet when updating from
+				 * an older version */
+				if (OidIsValid(relid))
+				{
+					CacheInvalidateRelcacheByRelid(relid);
+					break;
+				}
+			}
+			TS_FALLTHROUGH;
 		case DIMENSION:
 		case CONTINUOUS_AGG:
 		case CHUNK_COLUMN_STATS:
@@ -1284,6 +1284,7 @@ typedef enum Anum_chunk_rewrite_pkey
 typedef enum CacheType
 {
 	CACHE_TYPE_HYPERTABLE,
+	CACHE_TYPE_CHUNK,
 	CACHE_TYPE_BGW_JOB,
 	CACHE_TYPE_EXTENSION,
 	_MAX_CACHE_TYPES
@@ -1350,6 +1351,14 @@ typedef struct CatalogSecurityContext
  * append.
  */
 #define HYPERTABLE_STATUS_OSM_CHUNK_NONCONTIGUOUS 2
+/*
+ * Flag set when the hypertable was created with
+ * timescaledb.unlogged_staging. New chunks are then created unlogged and skip
+ * WAL on ingest; the data is WAL-logged in bulk when a chunk is compressed,
+ * since the compressed chunk is created logged. Intended for replayable
+ * ingest streams that trade a bounded redo window for insert throughput.
+ */
+#define HYPERTABLE_STATUS_UNLOGGED_STAGING 4
 
 extern void ts_catalog_table_info_init(CatalogTableInfo *tables, int max_table,
 									   const TableInfoDef *table_ary,
@@ -1387,6 +1396,7 @@ extern TSDLLEXPORT void ts_catalog_insert_values(Relation rel, TupleDesc tupdesc
 												 bool *nulls);
 extern TSDLLEXPORT void ts_catalog_insert_datums(Relation rel, TupleDesc tupdesc,
 												 NullableDatum *datums);
+extern TSDLLEXPORT void ts_catalog_multi_insert(Relation rel, int ntuples, HeapTuple *tuples);
 extern TSDLLEXPORT void ts_catalog_update_tid_only(Relation rel, ItemPointer tid, HeapTuple tuple);
 extern TSDLLEXPORT void ts_catalog_update_tid(Relation rel, ItemPointer tid, HeapTuple tuple);
 extern TSDLLEXPORT void ts_catalog_update(Relation rel, HeapTuple tuple);
@@ -24,6 +24,8 @@
 #include <storage/lmgr.h>
 #include <storage/lockdefs.h>
 #include <utils/datum.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
 #include <utils/syscache.h>
 
 #include "chunk.h"
@@ -1187,6 +1189,146 @@ chunk_column_stats_scan_iterator_set(ScanIterator *it, int32 hypertable_id, cons
 	return it->ctx.nkeys;
 }
 
+/*
+ * Per-backend cache of the ranges in _timescaledb_catalog.chunk_column_stats
+ * for one (hypertable, column) pair.
+ *
+ * Chunk-skipping queries filter all tracked ranges of a column on every
+ * planning cycle, and with many chunks the catalog scan dominates the cost
+ * of secondary-column pruning. Cache the rows of one column as a packed
+ * array that can be filtered without catalog access. Stats updates bump the
+ * generation counter through the regular invalidation machinery and the
+ * cache is rebuilt lazily on the next lookup.
+ */
+typedef struct ChunkColumnStatsCacheKey
+{
+	int32 hypertable_id;
+	NameData column_name;
+} ChunkColumnStatsCacheKey;
+
+typedef struct ChunkColumnStatsRange
+{
+	int32 chunk_id;
+	bool valid;
+	int64 range_start;
+	int64 range_end;
+} ChunkColumnStatsRange;
+
+typedef struct ChunkColumnStatsCacheEntry
+{
+	ChunkColumnStatsCacheKey key;
+	int num_ranges;
+	ChunkColumnStatsRange *ranges;
+} ChunkColumnStatsCacheEntry;
+
+static HTAB *chunk_column_stats_cache = NULL;
+static MemoryContext chunk_column_stats_cache_mcxt = NULL;
+
+/*
+ * Bumped on every invalidation. Discarding the stale entries is deferred to
+ * the next lookup, so that the invalidation callback itself does no work.
+ */
+static uint64 chunk_column_stats_cache_generation = 0;
+static uint64 chunk_column_stats_cache_built_generation = 0;
+
+void
+ts_chunk_column_stats_cache_invalidate(void)
+{
+	chunk_column_stats_cache_generation++;
+}
+
+static HTAB *
+chunk_column_stats_cache_get_htab(void)
+{
+	if (chunk_column_stats_cache != NULL &&
+		chunk_column_stats_cache_built_generation == chunk_column_stats_cache_generation)
+		return chunk_column_stats_cache;
+
+	if (chunk_column_stats_cache_mcxt == NULL)
+		chunk_column_stats_cache_mcxt = AllocSetContextCreate(CacheMemoryContext,
+															  "chunk column stats cache",
+															  ALLOCSET_DEFAULT_SIZES);
+	else
+	{
+		chunk_column_stats_cache = NULL;
+		MemoryContextReset(chunk_column_stats_cache_mcxt);
+	}
+
+	HASHCTL ctl = {
+		.keysize = sizeof(ChunkColumnStatsCacheKey),
+		.entrysize = sizeof(ChunkColumnStatsCacheEntry),
+		.hcxt = chunk_column_stats_cache_mcxt,
+	};
+
+	chunk_column_stats_cache = hash_create("chunk column stats cache",
+										   8,
+										   &ctl,
+										   HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	chunk_column_stats_cache_built_generation = chunk_column_stats_cache_generation;
+
+	return chunk_column_stats_cache;
+}
+
+/*
+ * Look up the cached ranges of one (hypertable, column) pair, scanning the
+ * catalog to build the packed array on the first use after an invalidation.
+ */
+static ChunkColumnStatsCacheEntry *
+chunk_column_stats_cache_get(int32 hypertable_id, const NameData *column_name)
+{
+	HTAB *htab = chunk_column_stats_cache_get_htab();
+	ChunkColumnStatsCacheKey key;
+	bool found;
+
+	memset(&key, 0, sizeof(key));
+	key.hypertable_id = hypertable_id;
+	namestrcpy(&key.column_name, NameStr(*column_name));
+
+	ChunkColumnStatsCacheEntry *entry = hash_search(htab, &key, HASH_ENTER, &found);
+
+	if (found)
+		return entry;
+
+	int capacity = 64;
+	ScanIterator it;
+
+	entry->num_ranges = 0;
+	entry->ranges = MemoryContextAlloc(chunk_column_stats_cache_mcxt,
+									   sizeof(ChunkColumnStatsRange) * capacity);
+
+	it = ts_scan_iterator_create(CHUNK_COLUMN_STATS, AccessShareLock, CurrentMemoryContext);
+	it.ctx.tuplock = NULL;
+	chunk_column_stats_scan_iterator_set(&it, hypertable_id, NameStr(*column_name));
+	ts_scanner_foreach(&it)
+	{
+		FormData_chunk_column_stats fd;
+
+		fill_form_from_slot(it.tinfo->slot, &fd);
+
+		/*
+		 * The INVALID_CHUNK_ID entry only records that the column is being
+		 * tracked; it is not a chunk, so leave it out of the ranges.
+		 */
+		if (fd.chunk_id == INVALID_CHUNK_ID)
+			continue;
+
+		if (entry->num_ranges == capacity)
+		{
+			capacity *= 2;
+			entry->ranges = repalloc(entry->ranges, sizeof(ChunkColumnStatsRange) * capacity);
+		}
+
+		ChunkColumnStatsRange *range = &entry->ranges[entry->num_ranges++];
+
+		range->chunk_id = fd.chunk_id;
+		range->valid = fd.valid;
+		range->range_start = fd.range_start;
+		range->range_end = fd.range_end;
+	}
+
+	return entry;
+}
+
 /*
  * We need to get all chunks matching the hypertable ID and the column name.
  * For each chunk obtained, we need to run a FILTER using the strategies
@@ -1207,51 +1349,28 @@ chunk_column_stats_scan_iterator_set(ScanIterator *it, int32 hypertable_id, cons
  *
  * We need to run the "Filter" above ourselves because there's no other PG mechanism for OR
  * types of checks like these.
+ *
+ * The ranges come from the per-backend cache above instead of a catalog scan,
+ * so repeated planning cycles only pay for the filtering itself.
  */
 List *
 ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri)
 {
-	ScanIterator it;
 	List *chunkids = NIL;
 	DimensionRestrictInfoOpen *open;
+	ChunkColumnStatsCacheEntry *entry;
+	int i;
 
 	Assert(dri && dri->dimension->type == DIMENSION_TYPE_STATS);
 
-	/* setup the scanner */
-	it = ts_scan_iterator_create(CHUNK_COLUMN_STATS, AccessShareLock, CurrentMemoryContext);
-	it.ctx.flags |= SCANNER_F_NOEND_AND_NOCLOSE;
-	it.ctx.tuplock = NULL;
-
 	open = (DimensionRestrictInfoOpen *) dri;
+	entry = chunk_column_stats_cache_get(dri->dimension->fd.hypertable_id,
+										 &dri->dimension->fd.column_name);
 
-	/*
-	 * We need to get all chunks matching the hypertable ID and the column name.
-	 */
-	chunk_column_stats_scan_iterator_set(&it,
-										 dri->dimension->fd.hypertable_id,
-										 NameStr(dri->dimension->fd.column_name));
-	/*
-	 * For each chunk obtained, we need to run a FILTER using the strategies
-	 * and the lower/upper bound values provided.
-	 */
-	ts_scan_iterator_start_or_restart_scan(&it);
-	ts_scanner_foreach(&it)
+	for (i = 0; i < entry->num_ranges; i++)
 	{
-		FormData_chunk_column_stats fd;
+		const ChunkColumnStatsRange *range = &entry->ranges[i];
 		bool matched = false;
-		bool chunk_id_isnull;
-
-		chunk_id_isnull = slot_attisnull(
-			it.tinfo->slot,
-			Anum_chunk_column_stats_ht_id_chunk_id_column_name_range_start_range_end_idx_chunk_id);
-		/*
-		 * We have an entry with INVALID_CHUNK_ID which will match all cases due to
-		 * -INF/+INF range entries for it. Ignore that.
-		 */
-		if (chunk_id_isnull)
-			goto done;
-
-		fill_form_from_slot(it.tinfo->slot, &fd);
 
 		/*
 		 * If an entry is marked "invalid" then it means that the ranges cannot be relied
@@ -1263,7 +1382,8 @@ ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri)
 		 * Also, if we have a valid chunnk with -inf/+inf entries then it matches all
 		 * queries
 		 */
-		if (!fd.valid || (fd.range_start == PG_INT64_MIN && fd.range_end == PG_INT64_MAX))
+		if (!range->valid ||
+			(range->range_start == PG_INT64_MIN && range->range_end == PG_INT64_MAX))
 		{
 			matched = true;
 			goto done;
@@ -1280,12 +1400,12 @@ ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri)
 		{
 			case BTLessEqualStrategyNumber: /* e.g: id <= 90 */
 			{
-				matched = fd.range_start <= open->upper_bound;
+				matched = range->range_start <= open->upper_bound;
 			}
 			break;
 			case BTLessStrategyNumber: /* e.g: id < 90 */
 			{
-				matched = fd.range_start < open->upper_bound;
+				matched = range->range_start < open->upper_bound;
 			}
 			break;
 			default:
@@ -1302,13 +1422,13 @@ ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri)
 			case BTGreaterEqualStrategyNumber:
 			{
 				/* range_end is exclusive */
-				matched = (fd.range_end - 1) >= open->lower_bound;
+				matched = (range->range_end - 1) >= open->lower_bound;
 			}
 			break;
 			case BTGreaterStrategyNumber:
 			{
 				/* range_end is exclusive */
-				matched = (fd.range_end - 1) > open->lower_bound;
+				matched = (range->range_end - 1) > open->lower_bound;
 			}
 			break;
 			default:
@@ -1318,9 +1438,8 @@ ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri)
 
 	done:
 		if (matched)
-			chunkids = lappend_int(chunkids, fd.chunk_id);
+			chunkids = lappend_int(chunkids, range->chunk_id);
 	}
-	ts_scan_iterator_close(&it);
 
 	return chunkids;
 }
@@ -46,6 +46,7 @@ extern int ts_chunk_column_stats_delete_by_hypertable_id(int32 hypertable_id);
 extern Dimension *ts_chunk_column_stats_fill_dummy_dimension(FormData_chunk_column_stats *r,
 															 Oid main_table_relid);
 extern List *ts_chunk_column_stats_get_chunk_ids_by_scan(DimensionRestrictInfo *dri);
+extern void ts_chunk_column_stats_cache_invalidate(void);
 extern void ts_chunk_column_stats_set_invalid(int32 hypertable_id, int32 chunk_id);
 extern int ts_chunk_column_stats_set_name(FormData_chunk_column_stats *in_fd, char *new_colname);
 extern List *ts_chunk_column_stats_construct_check_constraints(Relation relation, Oid reloid,
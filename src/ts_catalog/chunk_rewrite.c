@@ -275,9 +275,10 @@ ts_chunk_rewrite_cleanup(PG_FUNCTION_ARGS)
 				tuple = SearchSysCache1(RELOID, ObjectIdGetDatum(chunk_relid));
 
 				if (HeapTupleIsValid(tuple))
+				{
 					ownerid = ((Form_pg_class) GETSTRUCT(tuple))->relowner;
-
-				ReleaseSysCache(tuple);
+					ReleaseSysCache(tuple);
+				}
 
 				/*
 				 * Only clean an entry if the user has the privileges of the owner of the relation.
@@ -47,11 +47,11 @@ ts_compression_chunk_size_delete(int32 uncompressed_chunk_id)
 	return count;
 }
 
-TSDLLEXPORT bool
-ts_compression_chunk_size_get(int32 chunk_id, Form_compression_chunk_size form)
+static bool
+compression_chunk_size_get(int32 chunk_id, Form_compression_chunk_size form, LOCKMODE lockmode)
 {
 	ScanIterator iterator =
-		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, AccessExclusiveLock, CurrentMemoryContext);
+		ts_scan_iterator_create(COMPRESSION_CHUNK_SIZE, lockmode, CurrentMemoryContext);
 	bool found = false;
 
 	Assert(form != NULL);
@@ -77,6 +77,22 @@ ts_compression_chunk_size_get(int32 chunk_id, Form_compression_chunk_size form)
 	return found;
 }
 
+TSDLLEXPORT bool
+ts_compression_chunk_size_get(int32 chunk_id, Form_compression_chunk_size form)
+{
+	return compression_chunk_size_get(chunk_id, form, AccessExclusiveLock);
+}
+
+/*
+ * Read-only variant for planning and statistics purposes that does not take
+ * a heavy lock on the catalog table.
+ */
+TSDLLEXPORT bool
+ts_compression_chunk_size_get_stats(int32 chunk_id, Form_compression_chunk_size form)
+{
+	return compression_chunk_size_get(chunk_id, form, AccessShareLock);
+}
+
 TSDLLEXPORT bool
 ts_compression_chunk_size_update(int32 chunk_id, Form_compression_chunk_size form)
 {
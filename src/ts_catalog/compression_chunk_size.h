@@ -13,5 +13,7 @@
 extern TSDLLEXPORT int ts_compression_chunk_size_delete(int32 uncompressed_chunk_id);
 extern TSDLLEXPORT bool ts_compression_chunk_size_get(int32 chunk_id,
 													  Form_compression_chunk_size form);
+extern TSDLLEXPORT bool ts_compression_chunk_size_get_stats(int32 chunk_id,
+															Form_compression_chunk_size form);
 extern TSDLLEXPORT bool ts_compression_chunk_size_update(int32 chunk_id,
 														 Form_compression_chunk_size form);
@@ -7,6 +7,10 @@
 #include <catalog/pg_inherits.h>
 #include <parser/parse_func.h>
 #include <utils/builtins.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
+#include <utils/memutils.h>
+#include <utils/syscache.h>
 
 #include "jsonb_utils.h"
 #include "scan_iterator.h"
@@ -112,6 +116,8 @@ ts_compression_settings_create(Oid relid, Oid compress_relid, ArrayType *segment
 
 	table_close(rel, RowExclusiveLock);
 
+	compression_settings_cache_relation_changed(relid);
+
 	return ts_compression_settings_get(relid);
 }
 
@@ -189,14 +195,198 @@ compression_settings_iterator_init(ScanIterator *iterator, Oid relid, bool by_co
 }
 
 /*
- * Get compression settings for a relation.
+ * Per-backend cache of compression settings.
+ *
+ * Settings are looked up on every compression and decompression path, often
+ * repeatedly for the same relation, and each lookup is otherwise a catalog
+ * index scan. Entries are invalidated per relation: local modifications drop
+ * the affected entries directly and signal other backends with a relcache
+ * invalidation on the non-compressed relation, which the relcache callback
+ * forwards to ts_compression_settings_cache_invalidate_relid(). Aborted
+ * transactions invalidate the whole cache since entries added during the
+ * transaction may be tainted.
+ *
+ * Callers modify and free the settings they get back, so lookups return a
+ * copy of the cached entry allocated in the current memory context.
+ */
+typedef struct CompressionSettingsCacheKey
+{
+	Oid relid;
+	bool by_compress_relid;
+} CompressionSettingsCacheKey;
+
+typedef struct CompressionSettingsCacheEntry
+{
+	CompressionSettingsCacheKey key;
+	/* NULL for a negative entry, i.e., the relation has no settings */
+	CompressionSettings *settings;
+} CompressionSettingsCacheEntry;
+
+static HTAB *compression_settings_cache = NULL;
+static MemoryContext compression_settings_cache_mcxt = NULL;
+static uint64 compression_settings_cache_generation = 0;
+static uint64 compression_settings_cache_built_generation = 0;
+
+/*
+ * Invalidate all cached compression settings.
+ *
+ * Called from the cache invalidation machinery, so only bump the generation
+ * here. The cache is reset lazily on the next lookup.
+ */
+void
+ts_compression_settings_cache_invalidate(void)
+{
+	compression_settings_cache_generation++;
+}
+
+static ArrayType *
+compression_settings_array_copy(const ArrayType *array)
+{
+	ArrayType *copy;
+
+	if (array == NULL)
+		return NULL;
+
+	copy = palloc(VARSIZE(array));
+	memcpy(copy, array, VARSIZE(array));
+
+	return copy;
+}
+
+static Jsonb *
+compression_settings_jsonb_copy(const Jsonb *jsonb)
+{
+	Jsonb *copy;
+
+	if (jsonb == NULL)
+		return NULL;
+
+	copy = palloc(VARSIZE(jsonb));
+	memcpy(copy, jsonb, VARSIZE(jsonb));
+
+	return copy;
+}
+
+static CompressionSettings *
+compression_settings_copy(const CompressionSettings *src)
+{
+	CompressionSettings *dst = palloc0(sizeof(CompressionSettings));
+
+	dst->fd.relid = src->fd.relid;
+	dst->fd.compress_relid = src->fd.compress_relid;
+	dst->fd.segmentby = compression_settings_array_copy(src->fd.segmentby);
+	dst->fd.orderby = compression_settings_array_copy(src->fd.orderby);
+	dst->fd.orderby_desc = compression_settings_array_copy(src->fd.orderby_desc);
+	dst->fd.orderby_nullsfirst = compression_settings_array_copy(src->fd.orderby_nullsfirst);
+	dst->fd.index = compression_settings_jsonb_copy(src->fd.index);
+
+	return dst;
+}
+
+static void
+compression_settings_free(CompressionSettings *settings)
+{
+	if (settings->fd.segmentby)
+		pfree(settings->fd.segmentby);
+	if (settings->fd.orderby)
+		pfree(settings->fd.orderby);
+	if (settings->fd.orderby_desc)
+		pfree(settings->fd.orderby_desc);
+	if (settings->fd.orderby_nullsfirst)
+		pfree(settings->fd.orderby_nullsfirst);
+	if (settings->fd.index)
+		pfree(settings->fd.index);
+	pfree(settings);
+}
+
+static HTAB *
+compression_settings_cache_get_htab(void)
+{
+	if (compression_settings_cache == NULL ||
+		compression_settings_cache_built_generation != compression_settings_cache_generation)
+	{
+		HASHCTL ctl = {
+			.keysize = sizeof(CompressionSettingsCacheKey),
+			.entrysize = sizeof(CompressionSettingsCacheEntry),
+		};
+
+		if (compression_settings_cache_mcxt == NULL)
+			compression_settings_cache_mcxt = AllocSetContextCreate(CacheMemoryContext,
+																	"compression settings cache",
+																	ALLOCSET_DEFAULT_SIZES);
+		else
+			MemoryContextReset(compression_settings_cache_mcxt);
+
+		ctl.hcxt = compression_settings_cache_mcxt;
+		compression_settings_cache = hash_create("compression settings cache",
+												 32,
+												 &ctl,
+												 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+		compression_settings_cache_built_generation = compression_settings_cache_generation;
+	}
+
+	return compression_settings_cache;
+}
+
+/*
+ * Drop cached entries that reference the given relation.
+ *
+ * The relation can be referenced either as the non-compressed relation or as
+ * the associated compressed relation. This is called both for local settings
+ * changes and from the relcache invalidation callback, so it must only probe
+ * backend-local state.
+ */
+void
+ts_compression_settings_cache_invalidate_relid(Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	CompressionSettingsCacheEntry *entry;
+
+	if (compression_settings_cache == NULL ||
+		compression_settings_cache_built_generation != compression_settings_cache_generation)
+		return;
+
+	hash_seq_init(&status, compression_settings_cache);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (entry->key.relid != relid &&
+			(entry->settings == NULL || (entry->settings->fd.relid != relid &&
+										 entry->settings->fd.compress_relid != relid)))
+			continue;
+
+		if (entry->settings != NULL)
+			compression_settings_free(entry->settings);
+		hash_search(compression_settings_cache, &entry->key, HASH_REMOVE, NULL);
+	}
+}
+
+/*
+ * Invalidate the settings of a relation after a local settings change.
+ *
+ * Our own entries are dropped immediately since the change must be visible
+ * to the rest of the transaction. Other backends are signaled with a relcache
+ * invalidation on the non-compressed relation, unless it is already gone,
+ * e.g., when settings are deleted as part of dropping the relation. In that
+ * case the drop itself sends the relcache invalidation.
+ */
+static void
+compression_settings_cache_relation_changed(Oid relid)
+{
+	ts_compression_settings_cache_invalidate_relid(relid);
+
+	if (SearchSysCacheExists1(RELOID, ObjectIdGetDatum(relid)))
+		CacheInvalidateRelcacheByRelid(relid);
+}
+
+/*
+ * Read compression settings for a relation from the catalog.
  *
  * When 'by_compress_relid' is false, the 'relid' refers to the "main"
  * relation being compressed. When it is true the 'relid' refers to the
  * relation containing the associated compressed data.
  */
 static CompressionSettings *
-compression_settings_get(Oid relid, bool by_compress_relid)
+compression_settings_get_uncached(Oid relid, bool by_compress_relid)
 {
 	CompressionSettings *settings = NULL;
 	ScanIterator iterator =
@@ -215,6 +405,46 @@ compression_settings_get(Oid relid, bool by_compress_relid)
 	return settings;
 }
 
+/*
+ * Get compression settings for a relation, caching the result.
+ */
+static CompressionSettings *
+compression_settings_get(Oid relid, bool by_compress_relid)
+{
+	HTAB *htab = compression_settings_cache_get_htab();
+	CompressionSettingsCacheKey key;
+	CompressionSettingsCacheEntry *entry;
+	bool found;
+
+	memset(&key, 0, sizeof(key));
+	key.relid = relid;
+	key.by_compress_relid = by_compress_relid;
+
+	entry = hash_search(htab, &key, HASH_ENTER, &found);
+
+	if (!found)
+	{
+		CompressionSettings *settings = compression_settings_get_uncached(relid, by_compress_relid);
+
+		if (settings == NULL)
+			entry->settings = NULL;
+		else
+		{
+			MemoryContext old = MemoryContextSwitchTo(compression_settings_cache_mcxt);
+
+			entry->settings = compression_settings_copy(settings);
+			MemoryContextSwitchTo(old);
+		}
+
+		return settings;
+	}
+
+	if (entry->settings == NULL)
+		return NULL;
+
+	return compression_settings_copy(entry->settings);
+}
+
 /*
  * Get the compression settings for the relation referred to by 'relid'.
  */
@@ -261,7 +491,12 @@ compression_settings_delete(Oid relid, bool by_compress_relid)
 	ts_scanner_foreach(&iterator)
 	{
 		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
+		bool isnull;
+		Datum relid_datum = slot_getattr(ti->slot, Anum_compression_settings_relid, &isnull);
+
+		Assert(!isnull);
 		ts_catalog_delete_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti));
+		compression_settings_cache_relation_changed(DatumGetObjectId(relid_datum));
 		count++;
 	}
 	return count > 0;
@@ -500,6 +735,7 @@ compression_settings_tuple_update(TupleInfo *ti, void *data)
 	ts_catalog_update_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti), new_tuple);
 	ts_catalog_restore_user(&sec_ctx);
 	heap_freetuple(new_tuple);
+	compression_settings_cache_relation_changed(settings->fd.relid);
 	return SCAN_DONE;
 }
 
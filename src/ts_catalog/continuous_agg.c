@@ -44,6 +44,7 @@
 #include "ts_catalog/compression_settings.h"
 #include "ts_catalog/continuous_agg.h"
 #include "ts_catalog/continuous_aggs_watermark.h"
+#include "ts_catalog/invalidation_threshold_cache.h"
 #include "utils.h"
 #include "with_clause/alter_table_with_clause.h"
 
@@ -178,6 +179,11 @@ invalidation_threshold_delete(int32 raw_hypertable_id)
 		TupleInfo *ti = ts_scan_iterator_tuple_info(&iterator);
 		ts_catalog_delete_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti));
 	}
+
+	/* Drop the shared-memory copy of the threshold as well, so that a
+	 * continuous aggregate created on this hypertable later does not see a
+	 * threshold the deleted row once held. */
+	ts_invalidation_threshold_cache_invalidate(raw_hypertable_id);
 }
 
 static void
@@ -13,15 +13,101 @@
 #include <fmgr.h>
 #include <miscadmin.h>
 #include <utils/acl.h>
+#include <utils/hsearch.h>
 #include <utils/inval.h>
+#include <utils/memutils.h>
 #include <utils/snapmgr.h>
 
 #include "debug_point.h"
-#include "guc.h"
 #include "hypertable.h"
 #include "ts_catalog/continuous_agg.h"
 #include "ts_catalog/continuous_aggs_watermark.h"
 
+/*
+ * Backend-local cache of watermark values, keyed by the materialized
+ * hypertable id.
+ *
+ * Real-time continuous aggregate queries read the watermark during query
+ * preprocessing to constify the watermark function, so without a cache every
+ * planned query registers a snapshot and scans the watermark catalog table.
+ * The cache lives in CacheMemoryContext and is kept coherent across backends
+ * through the relcache invalidation mechanism: every watermark change sends a
+ * relcache invalidation message for the materialized hypertable (see
+ * cagg_watermark_update_scan_internal()), and cache_invalidate.c routes those
+ * messages, as well as the invalidate-everything events fired on transaction
+ * abort, back into this cache. Since a query on a continuous aggregate locks
+ * the materialized hypertable before the watermark is read, pending
+ * invalidations are always processed first and a backend never serves a value
+ * older than the one its snapshot would see. Watermark writes in the local
+ * backend additionally drop the cached values directly.
+ */
+typedef struct WatermarkCacheEntry
+{
+	int32 mat_hypertable_id;
+	Oid mat_relid;
+	int64 watermark;
+} WatermarkCacheEntry;
+
+static HTAB *watermark_cache = NULL;
+
+static HTAB *
+watermark_cache_get_htab(void)
+{
+	if (watermark_cache == NULL)
+	{
+		struct HASHCTL hctl = {
+			.keysize = sizeof(int32),
+			.entrysize = sizeof(WatermarkCacheEntry),
+			.hcxt = CacheMemoryContext,
+		};
+		watermark_cache =
+			hash_create("CAgg watermark cache", 4, &hctl, HASH_ELEM | HASH_CONTEXT | HASH_BLOBS);
+	}
+
+	return watermark_cache;
+}
+
+/*
+ * Drop all cached watermarks.
+ *
+ * Called from the cache invalidation machinery on events that invalidate all
+ * TimescaleDB caches, such as transaction aborts that might have tainted the
+ * cache with uncommitted values.
+ */
+void
+ts_cagg_watermark_cache_invalidate(void)
+{
+	if (watermark_cache != NULL)
+	{
+		hash_destroy(watermark_cache);
+		watermark_cache = NULL;
+	}
+}
+
+/*
+ * Drop the cached watermarks for a materialized hypertable in response to a
+ * relcache invalidation message for its relid.
+ *
+ * This runs in the relcache invalidation callback, so it must not query the
+ * relcache or syscache; it only probes the local hash table.
+ */
+void
+ts_cagg_watermark_cache_invalidate_relid(Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	WatermarkCacheEntry *entry;
+
+	if (watermark_cache == NULL)
+		return;
+
+	hash_seq_init(&status, watermark_cache);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (entry->mat_relid == relid)
+			hash_search(watermark_cache, &entry->mat_hypertable_id, HASH_REMOVE, NULL);
+	}
+}
+
 static void
 cagg_watermark_init_scan_by_mat_hypertable_id(ScanIterator *iterator, const int32 mat_hypertable_id)
 {
@@ -42,6 +128,13 @@ ts_cagg_watermark_get(int32 hypertable_id)
 	PG_USED_FOR_ASSERTS_ONLY short count = 0;
 	Datum watermark = UnassignedDatum;
 	bool value_isnull = true;
+	bool found = false;
+
+	WatermarkCacheEntry *entry =
+		hash_search(watermark_cache_get_htab(), &hypertable_id, HASH_FIND, &found);
+	if (found)
+		return entry->watermark;
+
 	ScanIterator iterator =
 		ts_scan_iterator_create(CONTINUOUS_AGGS_WATERMARK, AccessShareLock, CurrentMemoryContext);
 
@@ -81,6 +174,16 @@ ts_cagg_watermark_get(int32 hypertable_id)
 					hypertable_id,
 					DatumGetInt64(watermark))));
 
+	/*
+	 * Resolve the relid before entering the value so that cross-backend
+	 * invalidations, which arrive as relcache messages for the materialized
+	 * hypertable, can be matched against the entry.
+	 */
+	const Oid mat_relid = ts_hypertable_id_to_relid(hypertable_id, false);
+	entry = hash_search(watermark_cache_get_htab(), &hypertable_id, HASH_ENTER, &found);
+	entry->mat_relid = mat_relid;
+	entry->watermark = DatumGetInt64(watermark);
+
 	return DatumGetInt64(watermark);
 }
 
@@ -227,13 +330,14 @@ ts_cagg_watermark_insert(Hypertable *mat_ht, int64 watermark, bool watermark_isn
 	ts_catalog_restore_user(&sec_ctx);
 
 	table_close(rel, NoLock);
+
+	ts_cagg_watermark_cache_invalidate();
 }
 
 typedef struct WatermarkUpdate
 {
 	int64 watermark;
 	bool force_update;
-	bool invalidate_rel_cache;
 	Oid ht_relid;
 } WatermarkUpdate;
 
@@ -267,14 +371,11 @@ cagg_watermark_update_scan_internal(TupleInfo *ti, void *data)
 		 * During query planning, the values of the watermark function are constified using the
 		 * constify_cagg_watermark() function. However, this function's value changes when we update
 		 * the Cagg (the volatility of the function is STABLE not IMMUTABLE). To ensure that caches,
-		 * such as the query plan cache, are properly evicted, we send an invalidation message for
-		 * the hypertable.
+		 * such as the query plan cache and the backend-local watermark cache, are properly
+		 * evicted, we send an invalidation message for the hypertable.
 		 */
-		if (watermark_update->invalidate_rel_cache)
-		{
-			DEBUG_WAITPOINT("cagg_watermark_update_internal_before_refresh");
-			CacheInvalidateRelcacheByRelid(watermark_update->ht_relid);
-		}
+		DEBUG_WAITPOINT("cagg_watermark_update_internal_before_refresh");
+		CacheInvalidateRelcacheByRelid(watermark_update->ht_relid);
 	}
 	else
 	{
@@ -294,11 +395,10 @@ cagg_watermark_update_scan_internal(TupleInfo *ti, void *data)
 
 static void
 cagg_watermark_update_internal(int32 mat_hypertable_id, Oid ht_relid, int64 new_watermark,
-							   bool force_update, bool invalidate_rel_cache)
+							   bool force_update)
 {
 	WatermarkUpdate data = { .watermark = new_watermark,
 							 .force_update = force_update,
-							 .invalidate_rel_cache = invalidate_rel_cache,
 							 .ht_relid = ht_relid };
 	ScanIterator iterator =
 		ts_scan_iterator_create(CONTINUOUS_AGGS_WATERMARK, RowExclusiveLock, CurrentMemoryContext);
@@ -319,6 +419,8 @@ cagg_watermark_update_internal(int32 mat_hypertable_id, Oid ht_relid, int64 new_
 		ts_scanner_scan_one(&iterator.ctx, false, "continuous aggregate watermark");
 	UnregisterSnapshot(iterator.ctx.snapshot);
 
+	ts_cagg_watermark_cache_invalidate();
+
 	if (!watermark_updated)
 	{
 		ereport(ERROR,
@@ -333,19 +435,8 @@ ts_cagg_watermark_update(Hypertable *mat_ht, int64 watermark, bool watermark_isn
 {
 	ContinuousAgg *cagg = ts_continuous_agg_find_by_mat_hypertable_id(mat_ht->fd.id, false);
 
-	/* If we have a real-time CAgg, it uses a watermark function. So, we have to invalidate the rel
-	 * cache to force a replanning of prepared statements. See cagg_watermark_update_internal for
-	 * more information. If the GUC enable_cagg_watermark_constify=false then it's not necessary
-	 * to invalidate relation cache. */
-	bool invalidate_rel_cache =
-		!cagg->data.materialized_only && ts_guc_enable_cagg_watermark_constify;
-
 	watermark = cagg_compute_watermark(cagg, watermark, watermark_isnull);
-	cagg_watermark_update_internal(mat_ht->fd.id,
-								   mat_ht->main_table_relid,
-								   watermark,
-								   force_update,
-								   invalidate_rel_cache);
+	cagg_watermark_update_internal(mat_ht->fd.id, mat_ht->main_table_relid, watermark, force_update);
 }
 
 TSDLLEXPORT void
@@ -362,4 +453,6 @@ ts_cagg_watermark_delete_by_mat_hypertable_id(int32 mat_hypertable_id)
 		ts_catalog_delete_tid(ti->scanrel, ts_scanner_get_tuple_tid(ti));
 	}
 	ts_scan_iterator_close(&iterator);
+
+	ts_cagg_watermark_cache_invalidate();
 }
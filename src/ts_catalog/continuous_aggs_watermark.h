@@ -17,3 +17,5 @@ extern TSDLLEXPORT void ts_cagg_watermark_update(Hypertable *mat_ht, int64 water
 												 bool watermark_isnull, bool force_update);
 
 extern TSDLLEXPORT int64 ts_cagg_watermark_get(int32 hypertable_id);
+extern void ts_cagg_watermark_cache_invalidate(void);
+extern void ts_cagg_watermark_cache_invalidate_relid(Oid relid);
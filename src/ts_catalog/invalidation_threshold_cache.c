@@ -0,0 +1,147 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <miscadmin.h>
+
+#include "loader/invalidation_threshold_cache.h"
+#include "ts_catalog/invalidation_threshold_cache.h"
+
+/*
+ * Shared-memory cache of continuous aggregate invalidation thresholds.
+ *
+ * Transactions that modify a hypertable with continuous aggregates read the
+ * invalidation threshold at commit time to decide whether an invalidation log
+ * entry needs to be written at all. That read was a catalog index scan with
+ * its own snapshot, once per transaction and hypertable, which is noticeable
+ * under heavy parallel ingest. This cache keeps the threshold in shared
+ * memory, keyed by database and hypertable id, so the hot path is reduced to
+ * a hash lookup and an atomic read. The catalog row remains the durable copy.
+ *
+ * The cache relies on the threshold only ever moving forward and on the
+ * following invariant: a cached value is always a committed threshold, so it
+ * can lag behind the catalog but never run ahead of it. A lagging value is
+ * safe since it only makes writers log invalidations that the threshold
+ * already covers, which the materializer handles gracefully. Therefore
+ * values are installed from committed reads of the catalog row and advanced
+ * by refreshes only after the transaction that moved the threshold has
+ * committed, while deletion and re-initialization of the threshold row (which
+ * move it backwards) drop the cache entry up front, before their transaction
+ * commits.
+ *
+ * The shared hash table is allocated by the loader (the only library that can
+ * reserve shared memory) and reached through a rendezvous variable. When the
+ * loader predates this cache, or the fixed-size table is full, all accessors
+ * degrade to no-ops and callers fall back to reading the catalog.
+ */
+
+static InvalThresholdCacheRendezvous *
+invalidation_threshold_cache_rendezvous(void)
+{
+	InvalThresholdCacheRendezvous **rendezvous_ptr =
+		(InvalThresholdCacheRendezvous **) find_rendezvous_variable(
+			RENDEZVOUS_INVAL_THRESHOLD_CACHE);
+
+	return *rendezvous_ptr;
+}
+
+/*
+ * Look up the cached invalidation threshold for a hypertable.
+ *
+ * Returns false on a cache miss, in which case the caller should read the
+ * threshold from the catalog instead.
+ */
+bool
+ts_invalidation_threshold_cache_get(int32 hypertable_id, int64 *threshold)
+{
+	InvalThresholdCacheRendezvous *cache = invalidation_threshold_cache_rendezvous();
+	InvalThresholdCacheKey key = { .dboid = MyDatabaseId, .hypertable_id = hypertable_id };
+	InvalThresholdCacheEntry *entry;
+
+	if (cache == NULL)
+		return false;
+
+	LWLockAcquire(cache->lock, LW_SHARED);
+	entry = hash_search(cache->hash, &key, HASH_FIND, NULL);
+
+	if (entry != NULL)
+		*threshold = (int64) pg_atomic_read_u64(&entry->threshold);
+
+	LWLockRelease(cache->lock);
+
+	return entry != NULL;
+}
+
+/*
+ * Install a committed invalidation threshold in the cache.
+ *
+ * The cached value only ever moves forward, so a concurrent advance with an
+ * older value cannot regress an entry. The caller must only pass values read
+ * from, or known to be committed to, the catalog row.
+ */
+void
+ts_invalidation_threshold_cache_advance(int32 hypertable_id, int64 threshold)
+{
+	InvalThresholdCacheRendezvous *cache = invalidation_threshold_cache_rendezvous();
+	InvalThresholdCacheKey key = { .dboid = MyDatabaseId, .hypertable_id = hypertable_id };
+	InvalThresholdCacheEntry *entry;
+	bool found;
+
+	if (cache == NULL)
+		return;
+
+	LWLockAcquire(cache->lock, LW_SHARED);
+	entry = hash_search(cache->hash, &key, HASH_FIND, NULL);
+
+	if (entry == NULL)
+	{
+		/* Entering a new element modifies the hash table, so trade up to an
+		 * exclusive lock. HASH_ENTER_NULL makes a full table degrade to a
+		 * cache miss instead of an error. */
+		LWLockRelease(cache->lock);
+		LWLockAcquire(cache->lock, LW_EXCLUSIVE);
+		entry = hash_search(cache->hash, &key, HASH_ENTER_NULL, &found);
+
+		if (entry != NULL && !found)
+			pg_atomic_init_u64(&entry->threshold, (uint64) threshold);
+		else if (entry == NULL)
+		{
+			LWLockRelease(cache->lock);
+			return;
+		}
+	}
+
+	uint64 current = pg_atomic_read_u64(&entry->threshold);
+
+	while ((int64) current < threshold &&
+		   !pg_atomic_compare_exchange_u64(&entry->threshold, &current, (uint64) threshold))
+		;
+
+	LWLockRelease(cache->lock);
+}
+
+/*
+ * Drop the cache entry for a hypertable.
+ *
+ * Must be called whenever the threshold catalog row is deleted or
+ * re-initialized, since those are the only operations that can move the
+ * threshold backwards and would otherwise leave the cache running ahead of
+ * the catalog.
+ */
+void
+ts_invalidation_threshold_cache_invalidate(int32 hypertable_id)
+{
+	InvalThresholdCacheRendezvous *cache = invalidation_threshold_cache_rendezvous();
+	InvalThresholdCacheKey key = { .dboid = MyDatabaseId, .hypertable_id = hypertable_id };
+
+	if (cache == NULL)
+		return;
+
+	LWLockAcquire(cache->lock, LW_EXCLUSIVE);
+	hash_search(cache->hash, &key, HASH_REMOVE, NULL);
+	LWLockRelease(cache->lock);
+}
@@ -0,0 +1,16 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+
+#include "export.h"
+
+extern TSDLLEXPORT bool ts_invalidation_threshold_cache_get(int32 hypertable_id,
+															int64 *threshold);
+extern TSDLLEXPORT void ts_invalidation_threshold_cache_advance(int32 hypertable_id,
+																int64 threshold);
+extern TSDLLEXPORT void ts_invalidation_threshold_cache_invalidate(int32 hypertable_id);
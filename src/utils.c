@@ -14,7 +14,9 @@
 #include <catalog/namespace.h>
 #include <catalog/objectaccess.h>
 #include <catalog/pg_am.h>
+#include <catalog/objectaddress.h>
 #include <catalog/pg_cast.h>
+#include <catalog/pg_class.h>
 #include <catalog/pg_inherits.h>
 #include <catalog/pg_operator.h>
 #include <catalog/pg_type.h>
@@ -22,10 +24,12 @@
 #include <commands/tablecmds.h>
 #include <fmgr.h>
 #include <funcapi.h>
+#include <miscadmin.h>
 #include <nodes/makefuncs.h>
 #include <parser/parse_coerce.h>
 #include <parser/parse_func.h>
 #include <parser/scansup.h>
+#include <storage/bufmgr.h>
 #include <storage/lockdefs.h>
 #include <utils/acl.h>
 #include <utils/builtins.h>
@@ -66,23 +70,7 @@ TS_FUNCTION_INFO_V1(ts_makeaclitem);
 Datum
 ts_pg_timestamp_to_unix_microseconds(PG_FUNCTION_ARGS)
 {
-	TimestampTz timestamp = PG_GETARG_TIMESTAMPTZ(0);
-
-	if (TIMESTAMP_IS_NOBEGIN(timestamp))
-		PG_RETURN_INT64(TS_TIME_NOBEGIN);
-
-	if (TIMESTAMP_IS_NOEND(timestamp))
-		PG_RETURN_INT64(TS_TIME_NOEND);
-
-	if (timestamp < TS_TIMESTAMP_MIN)
-		ereport(ERROR,
-				(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE), errmsg("timestamp out of range")));
-
-	if (timestamp >= TS_TIMESTAMP_END)
-		ereport(ERROR,
-				(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE), errmsg("timestamp out of range")));
-
-	PG_RETURN_INT64(timestamp + TS_EPOCH_DIFF_MICROSECONDS);
+	PG_RETURN_INT64(ts_timestamp_value_to_internal(PG_GETARG_TIMESTAMPTZ(0)));
 }
 
 TS_FUNCTION_INFO_V1(ts_pg_unix_microseconds_to_timestamp);
@@ -139,7 +127,7 @@ static int64 ts_integer_to_internal(Datum time_val, Oid type_oid);
 TSDLLEXPORT int64
 ts_time_value_to_internal(Datum time_val, Oid type_oid)
 {
-	Datum res, tz;
+	Datum tz;
 
 	/* Handle custom time types. We currently only support binary coercible
 	 * types */
@@ -180,18 +168,11 @@ ts_time_value_to_internal(Datum time_val, Oid type_oid)
 			 * for timestamps, ignore timezones, make believe the timestamp is
 			 * at UTC
 			 */
-			res = DirectFunctionCall1(ts_pg_timestamp_to_unix_microseconds, time_val);
-
-			return DatumGetInt64(res);
 		case TIMESTAMPTZOID:
-			res = DirectFunctionCall1(ts_pg_timestamp_to_unix_microseconds, time_val);
-
-			return DatumGetInt64(res);
+			return ts_timestamp_value_to_internal(DatumGetTimestampTz(time_val));
 		case DATEOID:
 			tz = DirectFunctionCall1(date_timestamp, time_val);
-			res = DirectFunctionCall1(ts_pg_timestamp_to_unix_microseconds, tz);
-
-			return DatumGetInt64(res);
+			return ts_timestamp_value_to_internal(DatumGetTimestampTz(tz));
 		case UUIDOID:
 		{
 			uint64 unixtime_ms = 0;
@@ -1013,6 +994,72 @@ ts_subtract_integer_from_now(PG_FUNCTION_ARGS)
 	return Int64GetDatum(res);
 }
 
+TS_FUNCTION_INFO_V1(ts_relation_prewarm);
+
+/*
+ * Load the hot end of a relation into the shared buffer cache.
+ *
+ * For a table this is the tail of the main fork, where the most recently
+ * inserted rows of an append-mostly chunk live. For an index it is the head
+ * of the file, which holds the metapage and typically the upper tree levels.
+ * Used by the prewarm job (policy_prewarm) to shorten the cold-cache period
+ * after a restart or failover.
+ *
+ * Returns the number of blocks read.
+ */
+Datum
+ts_relation_prewarm(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_ARGISNULL(0) ? InvalidOid : PG_GETARG_OID(0);
+	int32 max_blocks = PG_ARGISNULL(1) ? 0 : PG_GETARG_INT32(1);
+	Relation rel;
+	AclResult aclresult;
+	BlockNumber nblocks;
+	BlockNumber first_block = 0;
+	int64 blocks_to_read;
+
+	if (!OidIsValid(relid) || max_blocks <= 0)
+		PG_RETURN_INT64(0);
+
+	rel = try_relation_open(relid, AccessShareLock);
+
+	if (!rel)
+		PG_RETURN_INT64(0);
+
+	aclresult = pg_class_aclcheck(relid, GetUserId(), ACL_SELECT);
+	if (aclresult != ACLCHECK_OK)
+		aclcheck_error(aclresult,
+					   get_relkind_objtype(rel->rd_rel->relkind),
+					   get_rel_name(relid));
+
+	if (!RELKIND_HAS_STORAGE(rel->rd_rel->relkind))
+	{
+		relation_close(rel, AccessShareLock);
+		PG_RETURN_INT64(0);
+	}
+
+	nblocks = RelationGetNumberOfBlocks(rel);
+	blocks_to_read = Min((int64) nblocks, (int64) max_blocks);
+
+	/* Tables are read from the tail, indexes from the head */
+	if (rel->rd_rel->relkind != RELKIND_INDEX)
+		first_block = nblocks - (BlockNumber) blocks_to_read;
+
+	for (int64 i = 0; i < blocks_to_read; i++)
+	{
+		Buffer buffer;
+
+		CHECK_FOR_INTERRUPTS();
+		buffer =
+			ReadBufferExtended(rel, MAIN_FORKNUM, first_block + (BlockNumber) i, RBM_NORMAL, NULL);
+		ReleaseBuffer(buffer);
+	}
+
+	relation_close(rel, AccessShareLock);
+
+	PG_RETURN_INT64(blocks_to_read);
+}
+
 TS_FUNCTION_INFO_V1(ts_relation_size);
 Datum
 ts_relation_size(PG_FUNCTION_ARGS)
@@ -22,6 +22,12 @@ sed  -E -e '/<exclude_from_test>/,/<\/exclude_from_test>/d' \
      -e '/Storage: Memory  Maximum Storage: [0-9]+kB/d' \
      -e '/Window: /d' \
      -e '/Batches: [0-9]+/d' \
+     -e '/Batches Decompressed: [0-9]+/d' \
+     -e '/Rows Removed by Vectorized Filter: [0-9]+/d' \
+     -e '/Peak Decompression Memory: [0-9]+ kB/d' \
+     -e '/Bytes Decompressed \([a-z0-9 ]+\): [0-9]+/d' \
+     -e '/Batches Aggregated: [0-9]+/d' \
+     -e '/Rows Aggregated: [0-9]+/d' \
      -e '/found [0-9]+ removable, [0-9]+ nonremovable row versions in [0-9]+ pages/d' | \
 grep -av 'DEBUG:  rehashing catalog cache id' | \
 grep -av 'DEBUG:  compacted fsync request queue from' | \
@@ -180,3 +180,23 @@ ALTER TABLE t_with SET (tsdb.chunk_interval = '1 hour');
 SELECT time_interval FROM timescaledb_information.dimensions WHERE hypertable_name = 't_with';
 
 
+
+-- test pre-creating the chunk covering a future time value
+CREATE TABLE precreate(time timestamptz NOT NULL, device int) WITH (tsdb.hypertable,tsdb.partition_column='time');
+
+SELECT _timescaledb_functions.precreate_chunk('precreate', '2030-01-01 00:00+00'::timestamptz);
+-- a second call covering the same chunk is a no-op and returns the same chunk
+SELECT _timescaledb_functions.precreate_chunk('precreate', '2030-01-01 12:00+00'::timestamptz);
+SELECT show_chunks('precreate');
+
+-- the insert lands in the pre-created chunk instead of creating a new one
+INSERT INTO precreate VALUES ('2030-01-01 06:00+00', 1);
+SELECT show_chunks('precreate');
+
+-- pre-creation is limited to hypertables with a single time dimension
+CREATE TABLE precreate_space(time timestamptz NOT NULL, device int);
+SELECT create_hypertable('precreate_space', 'time', 'device', 2);
+\set ON_ERROR_STOP 0
+SELECT _timescaledb_functions.precreate_chunk('precreate_space', '2030-01-01 00:00+00'::timestamptz);
+SELECT _timescaledb_functions.precreate_chunk('precreate', NULL::timestamptz);
+\set ON_ERROR_STOP 1
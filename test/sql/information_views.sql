@@ -100,3 +100,9 @@ FROM timescaledb_information.chunks WHERE hypertable_name = 'test_table_int' ORD
 \x
 SELECT * FROM timescaledb_information.dimensions ORDER BY hypertable_name, dimension_number;
 \x
+
+-- Smoke test the cache statistics view. The counters are backend-local
+-- and monotonic, so check invariants rather than exact numbers.
+SELECT count(*) >= 0 AS scanned FROM ht1;
+SELECT cache_name, hits + misses > 0 AS used, num_entries > 0 AS has_entries
+FROM timescaledb_information.cache_stats ORDER BY cache_name;
@@ -0,0 +1,77 @@
+-- This file and its contents are licensed under the Apache License 2.0.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-APACHE for a copy of the license.
+
+CREATE TABLE batch_test(time timestamptz NOT NULL, device int, value float);
+SELECT create_hypertable('batch_test', 'time', chunk_time_interval => interval '1 day');
+
+-- multi-insert batching is off by default because buffering reorders
+-- the heap inserts relative to the tuple stream
+SHOW timescaledb.enable_insert_batching;
+SET timescaledb.enable_insert_batching TO true;
+
+-- plain INSERT ... SELECT is buffered through the COPY multi-insert
+-- machinery; the command tag row count still reflects the buffered
+-- tuples
+DO $$
+DECLARE
+    rowcount bigint;
+BEGIN
+    INSERT INTO batch_test
+    SELECT t, 0, 0.1
+    FROM generate_series('2024-01-01 00:00+00'::timestamptz, '2024-01-04 00:00+00'::timestamptz, '1 minute') t;
+    GET DIAGNOSTICS rowcount = ROW_COUNT;
+    RAISE NOTICE 'inserted % rows', rowcount;
+END
+$$;
+SELECT count(*) FROM batch_test;
+SELECT count(*) FROM show_chunks('batch_test');
+
+-- out-of-order input switches between the per-chunk buffers and
+-- crosses the per-buffer flush threshold
+INSERT INTO batch_test
+SELECT '2024-01-05 00:00+00'::timestamptz + format('%s minutes', i)::interval, 2, i
+FROM generate_series(1, 5000) i
+ORDER BY i % 1440;
+SELECT count(*), min(value), max(value) FROM batch_test WHERE device = 2;
+
+-- RETURNING needs per-row results and falls back to per-tuple inserts
+INSERT INTO batch_test VALUES ('2024-01-10 00:00+00', 1, 1.0), ('2024-01-10 00:01+00', 3, 3.0) RETURNING device, value;
+
+-- ON CONFLICT requires visibility of every previously inserted tuple
+CREATE UNIQUE INDEX batch_test_time_device_idx ON batch_test(time, device);
+INSERT INTO batch_test VALUES ('2024-01-10 00:00+00', 1, 99.0) ON CONFLICT (time, device) DO NOTHING;
+SELECT value FROM batch_test WHERE device = 1;
+INSERT INTO batch_test VALUES ('2024-01-10 00:00+00', 1, 99.0) ON CONFLICT (time, device) DO UPDATE SET value = excluded.value;
+SELECT value FROM batch_test WHERE device = 1;
+
+-- WITH CHECK OPTIONS are evaluated per tuple
+CREATE VIEW batch_view AS SELECT * FROM batch_test WHERE device < 100 WITH CHECK OPTION;
+INSERT INTO batch_view VALUES ('2024-01-11 00:00+00', 4, 1.0);
+\set ON_ERROR_STOP 0
+INSERT INTO batch_view VALUES ('2024-01-11 00:01+00', 500, 1.0);
+\set ON_ERROR_STOP 1
+
+-- row triggers must fire per tuple in stream order
+CREATE FUNCTION batch_trigger_fn() RETURNS trigger LANGUAGE plpgsql AS
+$$
+BEGIN
+    RAISE NOTICE 'inserting device %', NEW.device;
+    RETURN NEW;
+END
+$$;
+CREATE TRIGGER batch_row_trigger BEFORE INSERT ON batch_test
+FOR EACH ROW EXECUTE FUNCTION batch_trigger_fn();
+INSERT INTO batch_test SELECT '2024-01-12 00:00+00'::timestamptz + format('%s minutes', i)::interval, 100 + i, i FROM generate_series(1, 3) i;
+DROP TRIGGER batch_row_trigger ON batch_test;
+
+-- volatile functions in the source targetlist keep the per-tuple path
+CREATE SEQUENCE batch_seq;
+INSERT INTO batch_test SELECT '2024-01-13 00:00+00'::timestamptz + format('%s minutes', i)::interval, 300, nextval('batch_seq') FROM generate_series(1, 3) i;
+SELECT value FROM batch_test WHERE device = 300 ORDER BY time;
+
+RESET timescaledb.enable_insert_batching;
+DROP VIEW batch_view;
+DROP TABLE batch_test;
+DROP FUNCTION batch_trigger_fn();
+DROP SEQUENCE batch_seq;
@@ -36,6 +36,22 @@ SELECT time_bucket(10,time),device_id,value FROM order_test ORDER BY 2,1;
 -- should use index scan
 :PREFIX SELECT time_bucket(10,time),device_id,value FROM order_test ORDER BY 2,1;
 
+-- test sort optimization with arithmetic on the time column
+-- multiplication and division by a positive constant preserve the ordering
+-- should use index scan
+:PREFIX SELECT time/10,device_id,value FROM order_test ORDER BY 1;
+:PREFIX SELECT time*10,device_id,value FROM order_test ORDER BY 1;
+SET enable_seqscan TO default;
+-- non-positive constants reverse or collapse the ordering and const - var
+-- reverses it, so the sort must stay
+-- must not use index scan
+:PREFIX SELECT time / -10,device_id,value FROM order_test ORDER BY 1;
+:PREFIX SELECT time * -10,device_id,value FROM order_test ORDER BY 1;
+:PREFIX SELECT time*0,device_id,value FROM order_test ORDER BY 1;
+:PREFIX SELECT 100-time,device_id,value FROM order_test ORDER BY 1;
+SELECT time * -10,device_id,value FROM order_test ORDER BY 1;
+SET enable_seqscan TO off;
+
 -- test sort optimization with interval calculation with non-fixed interval
 -- #7097
 CREATE TABLE i7097_1(time timestamptz NOT NULL, quantity float, "isText" boolean);
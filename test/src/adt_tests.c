@@ -99,6 +99,55 @@ uint64_vec_test(void)
 	TestAssertPtrEq(vec.data, NULL);
 }
 
+static void
+uint64_vec_set_test(void)
+{
+	uint64_vec left;
+	uint64_vec right;
+	uint64_vec intersection;
+	int i;
+
+	uint64_vec_init(&left, CurrentMemoryContext, 0);
+	uint64_vec_init(&right, CurrentMemoryContext, 0);
+	uint64_vec_init(&intersection, CurrentMemoryContext, 0);
+
+	/* contains on an empty vector finds nothing */
+	TestAssertTrue(!uint64_vec_contains(&left, 0));
+
+	/* append descending with duplicates, sort_unique normalizes */
+	for (i = 29; i >= 0; i--)
+	{
+		uint64_vec_append(&left, i % 10);
+		uint64_vec_append(&left, i % 10);
+	}
+	uint64_vec_sort_unique(&left);
+	TestAssertInt64Eq(left.num_elements, 10);
+	for (i = 0; i < 10; i++)
+		TestAssertInt64Eq(*uint64_vec_at(&left, i), i);
+
+	TestAssertTrue(uint64_vec_contains(&left, 0));
+	TestAssertTrue(uint64_vec_contains(&left, 9));
+	TestAssertTrue(!uint64_vec_contains(&left, 10));
+
+	/* even numbers up to 18, intersection keeps the even digits */
+	for (i = 0; i < 10; i++)
+		uint64_vec_append(&right, 2 * i);
+	uint64_vec_intersect(&intersection, &left, &right);
+	TestAssertInt64Eq(intersection.num_elements, 5);
+	for (i = 0; i < 5; i++)
+		TestAssertInt64Eq(*uint64_vec_at(&intersection, i), 2 * i);
+
+	/* intersection with an empty vector is empty */
+	uint64_vec_clear(&right);
+	uint64_vec_clear(&intersection);
+	uint64_vec_intersect(&intersection, &left, &right);
+	TestAssertInt64Eq(intersection.num_elements, 0);
+
+	uint64_vec_free_data(&left);
+	uint64_vec_free_data(&right);
+	uint64_vec_free_data(&intersection);
+}
+
 static void
 bit_array_test(void)
 {
@@ -144,6 +193,7 @@ ts_test_adts(PG_FUNCTION_ARGS)
 {
 	i32_vec_test();
 	uint64_vec_test();
+	uint64_vec_set_test();
 	bit_array_test();
 	PG_RETURN_VOID();
 }
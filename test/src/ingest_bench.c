@@ -0,0 +1,298 @@
+/*
+ * This file and its contents are licensed under the Apache License 2.0.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-APACHE for a copy of the license.
+ */
+
+/*
+ * Microbenchmark driver for the hypertable ingest path. It feeds synthetic
+ * tuples through the same tuple routing and multi-insert buffering that COPY
+ * and batched INSERTs use (ts_chunk_tuple_routing_find_chunk and the
+ * TSCopyMultiInsert machinery in copy.c), so that the routing and buffering
+ * overhead can be measured repeatably across chunk counts and arrival
+ * patterns, without the parsing and network cost of a real COPY.
+ *
+ * The entry point is SQL-callable and returns one JSON object as text:
+ *
+ *   CREATE FUNCTION ts_ingest_bench(hypertable REGCLASS, pattern TEXT,
+ *       num_rows BIGINT, num_tenants INT, step_ms DOUBLE PRECISION)
+ *       RETURNS TEXT AS :MODULE_PATHNAME, 'ts_ingest_bench' LANGUAGE C;
+ *
+ * The target must be a hypertable with the column layout
+ * (ts timestamptz, tenant int4, value float8); the caller controls the chunk
+ * count through the chunk_time_interval and the time span, which is
+ * num_rows * step_ms. The arrival patterns are:
+ *
+ *   'ordered'     - monotonically increasing time, the common ingest case.
+ *                   Exercises the same-chunk fast path in tuple routing.
+ *   'shuffled'    - times drawn uniformly over the whole span, so nearly
+ *                   every tuple crosses a chunk boundary. This is the worst
+ *                   case for routing and buffering.
+ *   'multitenant' - per-tenant ordered streams interleaved round-robin.
+ *                   With a space partition on the tenant column this keeps
+ *                   one open chunk per tenant.
+ *
+ * The rows are actually inserted, so run it in a transaction that is rolled
+ * back, or drop the table afterwards.
+ */
+
+#include <postgres.h>
+
+#include <access/table.h>
+#include <catalog/pg_type.h>
+#include <executor/executor.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+#include <nodes/execnodes.h>
+#include <parser/parse_node.h>
+#include <parser/parse_relation.h>
+#include <portability/instr_time.h>
+#include <utils/builtins.h>
+#include <utils/json.h>
+#include <utils/rel.h>
+#include <utils/timestamp.h>
+
+#include "test_utils.h"
+#include <export.h>
+
+#include "compat/compat.h"
+#include "copy.h"
+#include "dimension.h"
+#include "hypertable.h"
+#include "hypertable_cache.h"
+
+TS_FUNCTION_INFO_V1(ts_ingest_bench);
+
+typedef enum IngestBenchPattern
+{
+	INGEST_PATTERN_ORDERED,
+	INGEST_PATTERN_SHUFFLED,
+	INGEST_PATTERN_MULTITENANT,
+} IngestBenchPattern;
+
+/* splitmix64, same deterministic generator as the other bench drivers. */
+static uint64
+ingest_bench_prng_next(uint64 *state)
+{
+	uint64 z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static IngestBenchPattern
+ingest_bench_parse_pattern(const char *name)
+{
+	if (strcmp(name, "ordered") == 0)
+		return INGEST_PATTERN_ORDERED;
+	if (strcmp(name, "shuffled") == 0)
+		return INGEST_PATTERN_SHUFFLED;
+	if (strcmp(name, "multitenant") == 0)
+		return INGEST_PATTERN_MULTITENANT;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("unknown ingest pattern '%s'", name),
+			 errhint("Valid patterns are 'ordered', 'shuffled' and 'multitenant'.")));
+	pg_unreachable();
+}
+
+/*
+ * The bench generates tuples positionally, so pin down the expected layout
+ * instead of guessing what to put into arbitrary columns.
+ */
+static void
+ingest_bench_check_tupdesc(const TupleDesc tupdesc)
+{
+	if (tupdesc->natts == 3 && !TupleDescAttr(tupdesc, 0)->attisdropped &&
+		TupleDescAttr(tupdesc, 0)->atttypid == TIMESTAMPTZOID &&
+		!TupleDescAttr(tupdesc, 1)->attisdropped &&
+		TupleDescAttr(tupdesc, 1)->atttypid == INT4OID &&
+		!TupleDescAttr(tupdesc, 2)->attisdropped &&
+		TupleDescAttr(tupdesc, 2)->atttypid == FLOAT8OID)
+		return;
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("unexpected column layout of the ingest bench hypertable"),
+			 errhint("The hypertable must have the columns "
+					 "(ts timestamptz, tenant int4, value float8).")));
+}
+
+Datum
+ts_ingest_bench(PG_FUNCTION_ARGS)
+{
+	Oid relid = PG_GETARG_OID(0);
+	const char *pattern_name = text_to_cstring(PG_GETARG_TEXT_PP(1));
+	int64 num_rows = PG_GETARG_INT64(2);
+	int32 num_tenants = PG_GETARG_INT32(3);
+	double step_ms = PG_GETARG_FLOAT8(4);
+
+	const IngestBenchPattern pattern = ingest_bench_parse_pattern(pattern_name);
+
+	if (num_rows < 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("num_rows must be positive")));
+	if (num_tenants < 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("num_tenants must be positive")));
+	if (!(step_ms > 0))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("step_ms must be positive")));
+
+	const int64 step_us = (int64) (step_ms * 1000.0);
+	const int64 span_us = num_rows * Max(step_us, 1);
+
+	Cache *hcache;
+	Hypertable *ht = ts_hypertable_cache_get_cache_and_entry(relid, CACHE_FLAG_NONE, &hcache);
+	Relation rel = table_open(relid, RowExclusiveLock);
+
+	ingest_bench_check_tupdesc(RelationGetDescr(rel));
+
+	/*
+	 * Set up the executor state the same way copyfrom() in copy.c does: the
+	 * range table holds the hypertable root as the single result relation,
+	 * and the per-chunk result relations are built on demand by the tuple
+	 * routing.
+	 */
+	EState *estate = CreateExecutorState();
+	ParseState *pstate = make_parsestate(NULL);
+	ParseNamespaceItem *nsitem =
+		addRangeTableEntryForRelation(pstate, rel, RowExclusiveLock, NULL, false, false);
+	addNSItemToQuery(pstate, nsitem, true, true, true);
+
+	ResultRelInfo *resultRelInfo = makeNode(ResultRelInfo);
+
+#if PG16_LT
+	ExecInitRangeTable(estate, pstate->p_rtable);
+#elif PG18_LT
+	Assert(pstate->p_rteperminfos != NULL);
+	ExecInitRangeTable(estate, pstate->p_rtable, pstate->p_rteperminfos);
+#else
+	Assert(pstate->p_rteperminfos != NULL);
+	ExecInitRangeTable(estate, pstate->p_rtable, pstate->p_rteperminfos, bms_make_singleton(1));
+#endif
+	ExecInitResultRelation(estate, resultRelInfo, 1);
+	ExecOpenIndices(resultRelInfo, false);
+
+	ChunkTupleRouting *ctr = ts_chunk_tuple_routing_create(estate, ht, resultRelInfo);
+	TSCopyMultiInsertInfo *miinfo = ts_copy_multi_insert_info_create(ctr, estate, ht);
+
+	TupleTableSlot *slot = MakeSingleTupleTableSlot(RelationGetDescr(rel), &TTSOpsVirtual);
+
+	/* Prepare to catch AFTER triggers, the flush path may fire them. */
+	AfterTriggerBeginQuery();
+
+	uint64 prng = 0xC0FFEEULL;
+	const TimestampTz start_time = 0; /* 2000-01-01, any fixed origin works */
+	Oid prev_chunk_relid = InvalidOid;
+	int64 chunk_switches = 0;
+	int64 fallback_rows = 0;
+	int reset_count = 0;
+
+	instr_time duration_start, duration;
+	INSTR_TIME_SET_CURRENT(duration_start);
+
+	for (int64 i = 0; i < num_rows; i++)
+	{
+		int64 offset_us;
+		int32 tenant;
+
+		CHECK_FOR_INTERRUPTS();
+
+		switch (pattern)
+		{
+			case INGEST_PATTERN_ORDERED:
+				offset_us = i * step_us;
+				tenant = (int32) (i % num_tenants);
+				break;
+			case INGEST_PATTERN_SHUFFLED:
+				offset_us = (int64) (ingest_bench_prng_next(&prng) % (uint64) span_us);
+				tenant = (int32) (ingest_bench_prng_next(&prng) % (uint64) num_tenants);
+				break;
+			case INGEST_PATTERN_MULTITENANT:
+				offset_us = (i / num_tenants) * step_us;
+				tenant = (int32) (i % num_tenants);
+				break;
+			default:
+				pg_unreachable();
+		}
+
+		/* Reset the per-tuple context periodically, like copyfrom() does. */
+		if (reset_count++ == 100)
+		{
+			ResetPerTupleExprContext(estate);
+			reset_count = 0;
+		}
+
+		MemoryContext oldcontext = MemoryContextSwitchTo(GetPerTupleMemoryContext(estate));
+
+		ExecClearTuple(slot);
+		slot->tts_values[0] = TimestampTzGetDatum(start_time + offset_us);
+		slot->tts_isnull[0] = false;
+		slot->tts_values[1] = Int32GetDatum(tenant);
+		slot->tts_isnull[1] = false;
+		slot->tts_values[2] = Float8GetDatum((double) (i % 1000) / 1000.0);
+		slot->tts_isnull[2] = false;
+		ExecStoreVirtualTuple(slot);
+
+		Point *point = ts_hyperspace_calculate_point(ht->space, slot);
+		ChunkInsertState *cis = ts_chunk_tuple_routing_find_chunk(ctr, point);
+
+		if (RelationGetRelid(cis->rel) != prev_chunk_relid)
+		{
+			if (OidIsValid(prev_chunk_relid))
+				chunk_switches++;
+			prev_chunk_relid = RelationGetRelid(cis->rel);
+		}
+
+		/*
+		 * Chunks with row triggers fall back to single inserts on the real
+		 * ingest path. The bench only measures the buffered path, so just
+		 * count and skip such rows.
+		 */
+		if (!ts_copy_multi_insert_buffer_tuple(miinfo, cis, point, slot))
+			fallback_rows++;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	const int64 flushes = ts_copy_multi_insert_info_finish(miinfo);
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, duration_start);
+	const double seconds = INSTR_TIME_GET_DOUBLE(duration);
+
+	AfterTriggerEndQuery(estate);
+
+	ts_chunk_tuple_routing_destroy(ctr);
+	ExecDropSingleTupleTableSlot(slot);
+	ExecCloseIndices(resultRelInfo);
+	ExecCloseResultRelations(estate);
+	ExecCloseRangeTableRelations(estate);
+	FreeExecutorState(estate);
+	free_parsestate(pstate);
+	table_close(rel, NoLock);
+	ts_cache_release(&hcache);
+
+	StringInfoData out;
+	initStringInfo(&out);
+	appendStringInfoString(&out, "{\"pattern\": ");
+	escape_json(&out, pattern_name);
+	appendStringInfo(&out, ", \"num_rows\": " INT64_FORMAT, num_rows);
+	appendStringInfo(&out, ", \"num_tenants\": %d", num_tenants);
+	appendStringInfo(&out, ", \"step_ms\": %g", step_ms);
+	appendStringInfo(&out, ", \"seconds\": %.3f", seconds);
+	appendStringInfo(&out, ", \"rows_per_second\": %.0f", num_rows / Max(seconds, 1e-9));
+	appendStringInfo(&out, ", \"flushes\": " INT64_FORMAT, flushes);
+	appendStringInfo(&out,
+					 ", \"rows_per_flush\": %.1f",
+					 flushes > 0 ? (double) num_rows / flushes : 0.0);
+	appendStringInfo(&out, ", \"chunk_switches\": " INT64_FORMAT, chunk_switches);
+	appendStringInfo(&out, ", \"chunk_switch_rate\": %.4f", (double) chunk_switches / num_rows);
+	if (fallback_rows > 0)
+		appendStringInfo(&out, ", \"fallback_rows\": " INT64_FORMAT, fallback_rows);
+	appendStringInfoString(&out, "}");
+
+	PG_RETURN_TEXT_P(cstring_to_text(out.data));
+}
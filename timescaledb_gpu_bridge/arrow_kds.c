@@ -4,8 +4,14 @@
  * Converts Arrow C Data Interface columnar batches into PG-Strom's
  * kern_data_store (KDS_FORMAT_COLUMN) layout for GPU transfer.
  *
- * Fixed-width columns use pointer aliasing (zero-copy) when possible.
+ * Producers that control their output buffers (e.g. decompression) should
+ * use kds_batch_create() to obtain per-column pointers into the final KDS
+ * buffer and write values there directly, avoiding a full-batch copy.
+ * arrow_batch_to_kds() is the copying path for existing Arrow batches.
  * Geometry columns require serialization with xpu_geometry_t headers.
+ * Text columns keep Arrow's offsets + data layout on the device; for
+ * dictionary-encoded text only the per-batch indexes travel once the
+ * chunk's dictionary has been uploaded (gpu_cache_dictionary_devptr()).
  * Validity bitmaps are copied directly (Arrow and KDS use the same format).
  */
 #include <postgres.h>
@@ -42,6 +48,93 @@
  *   data values (fixed-width) or offsets+data (variable-width)
  */
 
+/*
+ * Pinned staging pool.
+ *
+ * KDS buffers staged in pinned (page-locked) memory can be DMAed to the
+ * device directly, instead of the driver bouncing them through an internal
+ * staging area. Pinned allocation is expensive, so released buffers are kept
+ * on a free list and reused for subsequent batches. The pool grows on demand
+ * up to timescaledb.gpu_pinned_pool_size; beyond that, and whenever PG-Strom
+ * does not expose pinned allocation, batches fall back to pageable memory.
+ */
+typedef struct PinnedBlock
+{
+	struct PinnedBlock *next;  /* free list link */
+	size_t len;                /* usable bytes following the header */
+} PinnedBlock;
+
+static PinnedBlock *pinned_free_list = NULL;
+static size_t pinned_pool_bytes = 0;
+
+static char *
+staging_acquire(size_t len, bool *pinned)
+{
+	size_t pool_limit = (size_t) gpu_pinned_pool_size_mb * 1024 * 1024;
+
+	if (strom_api.pinned_alloc != NULL && pool_limit > 0)
+	{
+		PinnedBlock **prev = &pinned_free_list;
+
+		/* First fit from the free list */
+		for (PinnedBlock *blk = pinned_free_list; blk != NULL; prev = &blk->next, blk = blk->next)
+		{
+			if (blk->len >= len)
+			{
+				*prev = blk->next;
+				*pinned = true;
+				return (char *) (blk + 1);
+			}
+		}
+
+		/* No reusable block; grow the pool if below the configured limit */
+		if (pinned_pool_bytes + len <= pool_limit)
+		{
+			PinnedBlock *blk = strom_api.pinned_alloc(sizeof(PinnedBlock) + len);
+
+			if (blk != NULL)
+			{
+				blk->next = NULL;
+				blk->len = len;
+				pinned_pool_bytes += len;
+				*pinned = true;
+				return (char *) (blk + 1);
+			}
+			elog(DEBUG1, "gpu_bridge: pinned allocation of %zu bytes failed", len);
+		}
+	}
+
+	/* Pageable fallback */
+	*pinned = false;
+	return palloc(len);
+}
+
+static void
+staging_release(char *buffer, bool pinned)
+{
+	if (pinned)
+	{
+		PinnedBlock *blk = ((PinnedBlock *) buffer) - 1;
+		size_t pool_limit = (size_t) gpu_pinned_pool_size_mb * 1024 * 1024;
+
+		/* Return pool memory if the limit was lowered, otherwise recycle */
+		if (pinned_pool_bytes > pool_limit)
+		{
+			pinned_pool_bytes -= blk->len;
+			strom_api.pinned_free(blk);
+		}
+		else
+		{
+			blk->next = pinned_free_list;
+			pinned_free_list = blk;
+		}
+	}
+	else
+	{
+		pfree(buffer);
+	}
+}
+
 static size_t
 validity_bitmap_bytes(int nrows)
 {
@@ -54,6 +147,57 @@ fixed_column_bytes(int nrows, int typlen)
 	return validity_bitmap_bytes(nrows) + MAXALIGN((size_t) nrows * typlen);
 }
 
+/*
+ * Compressed-payload columns carry the on-disk compressed data to the
+ * device, prefixed by a header the decompression kernel reads:
+ *   uint32  payload_len
+ *   uint32  algorithm   (KDS_COMPRESSION_* tag)
+ */
+#define KDS_COMPRESSED_COL_HDR  (2 * sizeof(uint32))
+
+static size_t
+compressed_column_bytes(size_t payload_len)
+{
+	return MAXALIGN(KDS_COMPRESSED_COL_HDR + payload_len);
+}
+
+static size_t
+varlena_column_bytes(int nrows, size_t data_len)
+{
+	return validity_bitmap_bytes(nrows) +
+		   MAXALIGN(((size_t) nrows + 1) * sizeof(uint32)) +  /* offset array */
+		   MAXALIGN(data_len);
+}
+
+/*
+ * Dictionary-encoded columns carry a small header the device kernel uses to
+ * locate the dictionary:
+ *   uint32  dict_nitems
+ *   uint32  dict_inline_len   (0 when the dictionary is device-resident)
+ *   uint64  dict_devptr       (device copy shared by the chunk's batches, or 0)
+ * followed by the validity bitmap, the int16 index array, and - only when no
+ * device copy exists - the inlined dictionary in Arrow text layout
+ * (uint32 offsets[dict_nitems + 1] + value bytes).
+ */
+#define KDS_DICT_COL_HDR  (2 * sizeof(uint32) + sizeof(uint64))
+
+static size_t
+dictionary_inline_bytes(const KDSColumnDesc *desc)
+{
+	if (desc->dict_devptr != 0)
+		return 0;
+	return MAXALIGN(((size_t) desc->dict_nitems + 1) * sizeof(uint32)) +
+		   MAXALIGN(desc->dict_data_len);
+}
+
+static size_t
+dictionary_column_bytes(int nrows, const KDSColumnDesc *desc)
+{
+	return KDS_DICT_COL_HDR + validity_bitmap_bytes(nrows) +
+		   MAXALIGN((size_t) nrows * sizeof(int16)) +
+		   dictionary_inline_bytes(desc);
+}
+
 /*
  * Estimate the size of a geometry column in KDS format.
  * xpu_geometry_t header per POINT Z: 24 bytes (type, flags, srid, nitems, rawsize, rawdata ptr)
@@ -83,6 +227,8 @@ kds_col_typlen(KDSColumnType col_type)
 		case KDS_COL_FLOAT4:  return 4;
 		case KDS_COL_INT4:    return 4;
 		case KDS_COL_INT2:    return 2;
+		case KDS_COL_VARLENA: return -1;   /* variable-length */
+		case KDS_COL_DICTIONARY: return -1;
 		case KDS_COL_GEOMETRY: return -1;  /* variable-length */
 	}
 	return -1;
@@ -137,6 +283,64 @@ convert_fixed_column(char *dest, const ArrowArray *arrow, int nrows, int typlen)
 	}
 }
 
+/*
+ * Convert a variable-length (text/bytea) Arrow column. The device uses the
+ * same offsets + data layout as Arrow, so both buffers are copied verbatim.
+ */
+static void
+convert_varlena_column(char *dest, const ArrowArray *arrow, int nrows,
+					   size_t data_len)
+{
+	copy_validity_bitmap(dest, (const uint64 *) arrow->buffers[0], nrows);
+
+	uint32 *offsets = (uint32 *) (dest + validity_bitmap_bytes(nrows));
+	char *data_area =
+		(char *) offsets + MAXALIGN(((size_t) nrows + 1) * sizeof(uint32));
+
+	if (arrow->buffers[1] != NULL)
+		memcpy(offsets, arrow->buffers[1], ((size_t) nrows + 1) * sizeof(uint32));
+	else
+		memset(offsets, 0, ((size_t) nrows + 1) * sizeof(uint32));
+
+	if (arrow->buffers[2] != NULL && data_len > 0)
+		memcpy(data_area, arrow->buffers[2], data_len);
+}
+
+/*
+ * Convert a dictionary-encoded Arrow column. The int16 index array (the
+ * same encoding TimescaleDB uses host-side) always travels with the batch;
+ * the dictionary itself is inlined only when the descriptor carries no
+ * device-resident copy (dict_devptr == 0). buf points past the column
+ * header, which kds_batch_create() has already written.
+ */
+static void
+convert_dictionary_column(const KDSColumnBuffer *buf, const ArrowArray *arrow,
+						  int nrows, const KDSColumnDesc *desc)
+{
+	copy_validity_bitmap((char *) buf->validity,
+						 (const uint64 *) arrow->buffers[0], nrows);
+
+	if (arrow->buffers[1] != NULL)
+		memcpy(buf->data, arrow->buffers[1], (size_t) nrows * sizeof(int16));
+	else
+		memset(buf->data, 0, (size_t) nrows * sizeof(int16));
+
+	if (desc->dict_devptr != 0)
+		return;					/* dictionary already on the device */
+
+	/* Inline the dictionary in Arrow text layout after the index array */
+	const ArrowArray *dict = arrow->dictionary;
+	char *dict_area = buf->data + MAXALIGN((size_t) nrows * sizeof(int16));
+	size_t offsets_len = ((size_t) desc->dict_nitems + 1) * sizeof(uint32);
+
+	Assert(dict != NULL && dict->length == desc->dict_nitems);
+
+	memcpy(dict_area, dict->buffers[1], offsets_len);
+	if (desc->dict_data_len > 0)
+		memcpy(dict_area + MAXALIGN(offsets_len), dict->buffers[2],
+			   desc->dict_data_len);
+}
+
 /*
  * xpu_geometry_t header layout for POINT Z (matching PG-Strom):
  *   int32  type      (POINTTYPE = 1)
@@ -258,9 +462,8 @@ convert_geometry_column(char *dest, const ArrowArray *arrow, int nrows)
 }
 
 KDSBatch *
-arrow_batch_to_kds(const ArrowArray **arrow_arrays,
-				   const KDSColumnDesc *col_descs,
-				   int ncols, int nrows)
+kds_batch_create(const KDSColumnDesc *col_descs, int ncols, int nrows,
+				 KDSColumnBuffer *col_bufs)
 {
 	/* Calculate total buffer size */
 	size_t header_size = KDS_HEADER_SIZE(ncols);
@@ -270,7 +473,13 @@ arrow_batch_to_kds(const ArrowArray **arrow_arrays,
 	for (int i = 0; i < ncols; i++)
 	{
 		int typlen = kds_col_typlen(col_descs[i].col_type);
-		if (typlen > 0)
+		if (col_descs[i].compression != KDS_COMPRESSION_NONE)
+			col_sizes[i] = compressed_column_bytes(col_descs[i].payload_len);
+		else if (col_descs[i].col_type == KDS_COL_VARLENA)
+			col_sizes[i] = varlena_column_bytes(nrows, col_descs[i].varlena_data_len);
+		else if (col_descs[i].col_type == KDS_COL_DICTIONARY)
+			col_sizes[i] = dictionary_column_bytes(nrows, &col_descs[i]);
+		else if (typlen > 0)
 			col_sizes[i] = fixed_column_bytes(nrows, typlen);
 		else
 			col_sizes[i] = geometry_column_bytes(nrows);
@@ -278,9 +487,15 @@ arrow_batch_to_kds(const ArrowArray **arrow_arrays,
 		total_size += MAXALIGN(col_sizes[i]);
 	}
 
-	/* Allocate KDS buffer */
+	/*
+	 * Allocate the KDS buffer without zeroing it. Every column is fully
+	 * written either by the caller (through col_bufs) or by the conversion
+	 * routines, so pre-zeroing would write the whole batch twice. Only the
+	 * alignment padding between regions needs explicit clearing so the
+	 * buffer contents stay deterministic for transfer.
+	 */
 	KDSBatch *batch = palloc(sizeof(KDSBatch));
-	batch->buffer = palloc0(total_size);
+	batch->buffer = staging_acquire(total_size, &batch->pinned);
 	batch->buffer_len = total_size;
 	batch->ncols = ncols;
 	batch->nrows = nrows;
@@ -301,26 +516,92 @@ arrow_batch_to_kds(const ArrowArray **arrow_arrays,
 	uint32 nitems_val = (uint32) nrows;
 	memcpy(batch->buffer + KDS_HDR_NITEMS_OFF, &nitems_val, sizeof(uint32));
 
-	/* Write column offsets and data */
+	/* Clear header padding after the column offset array */
+	size_t offsets_end = KDS_HDR_COL_OFFSETS + ncols * sizeof(uint32);
+	memset(batch->buffer + offsets_end, 0, header_size - offsets_end);
+
+	/* Write column offsets and hand out column buffer pointers */
 	size_t current_offset = header_size;
 	for (int i = 0; i < ncols; i++)
 	{
-		/* Record column offset */
 		uint32 col_off = (uint32) current_offset;
 		memcpy(batch->buffer + KDS_HDR_COL_OFFSETS + i * sizeof(uint32),
 			   &col_off, sizeof(uint32));
 
-		/* Convert column data */
 		char *col_dest = batch->buffer + current_offset;
+		size_t bitmap_size = validity_bitmap_bytes(nrows);
 		int typlen = kds_col_typlen(col_descs[i].col_type);
 
+		if (col_descs[i].compression != KDS_COMPRESSION_NONE)
+		{
+			/* Write the header; the caller fills in the payload */
+			uint32 payload_len_val = (uint32) col_descs[i].payload_len;
+			uint32 algorithm_val = (uint32) col_descs[i].compression;
+
+			memcpy(col_dest, &payload_len_val, sizeof(uint32));
+			memcpy(col_dest + sizeof(uint32), &algorithm_val, sizeof(uint32));
+			memset(col_dest + KDS_COMPRESSED_COL_HDR + col_descs[i].payload_len, 0,
+				   MAXALIGN(col_sizes[i]) - KDS_COMPRESSED_COL_HDR -
+					   col_descs[i].payload_len);
+
+			if (col_bufs != NULL)
+			{
+				/* Nulls are encoded within the payload; no host bitmap */
+				col_bufs[i].validity = NULL;
+				col_bufs[i].data = col_dest + KDS_COMPRESSED_COL_HDR;
+				col_bufs[i].data_len = col_descs[i].payload_len;
+			}
+
+			current_offset += MAXALIGN(col_sizes[i]);
+			continue;
+		}
+
+		if (col_descs[i].col_type == KDS_COL_DICTIONARY)
+		{
+			/* Write the dictionary header; the rest is filled by the caller */
+			uint32 dict_nitems_val = (uint32) col_descs[i].dict_nitems;
+			uint32 dict_inline_val = (uint32) dictionary_inline_bytes(&col_descs[i]);
+			uint64 dict_devptr_val = col_descs[i].dict_devptr;
+
+			memcpy(col_dest, &dict_nitems_val, sizeof(uint32));
+			memcpy(col_dest + sizeof(uint32), &dict_inline_val, sizeof(uint32));
+			memcpy(col_dest + 2 * sizeof(uint32), &dict_devptr_val, sizeof(uint64));
+			memset(col_dest + KDS_DICT_COL_HDR, 0,
+				   MAXALIGN(col_sizes[i]) - KDS_DICT_COL_HDR);
+
+			if (col_bufs != NULL)
+			{
+				col_bufs[i].validity = (uint64 *) (col_dest + KDS_DICT_COL_HDR);
+				col_bufs[i].data = col_dest + KDS_DICT_COL_HDR + bitmap_size;
+				col_bufs[i].data_len =
+					MAXALIGN(col_sizes[i]) - KDS_DICT_COL_HDR - bitmap_size;
+			}
+
+			current_offset += MAXALIGN(col_sizes[i]);
+			continue;
+		}
+
 		if (typlen > 0)
 		{
-			convert_fixed_column(col_dest, arrow_arrays[i], nrows, typlen);
+			/* Clear alignment padding after the data values */
+			size_t data_size = (size_t) nrows * typlen;
+			memset(col_dest + bitmap_size + data_size, 0,
+				   MAXALIGN(col_sizes[i]) - bitmap_size - data_size);
 		}
 		else
 		{
-			convert_geometry_column(col_dest, arrow_arrays[i], nrows);
+			/*
+			 * Variable-length columns are written sparsely (NULL rows leave
+			 * gaps in the data area), so clear the whole column region.
+			 */
+			memset(col_dest, 0, MAXALIGN(col_sizes[i]));
+		}
+
+		if (col_bufs != NULL)
+		{
+			col_bufs[i].validity = (uint64 *) col_dest;
+			col_bufs[i].data = col_dest + bitmap_size;
+			col_bufs[i].data_len = MAXALIGN(col_sizes[i]) - bitmap_size;
 		}
 
 		current_offset += MAXALIGN(col_sizes[i]);
@@ -330,13 +611,57 @@ arrow_batch_to_kds(const ArrowArray **arrow_arrays,
 	return batch;
 }
 
+KDSBatch *
+arrow_batch_to_kds(const ArrowArray **arrow_arrays,
+				   const KDSColumnDesc *col_descs,
+				   int ncols, int nrows)
+{
+	KDSColumnBuffer *col_bufs = palloc(sizeof(KDSColumnBuffer) * ncols);
+	KDSBatch *batch = kds_batch_create(col_descs, ncols, nrows, col_bufs);
+
+	/* Convert column data */
+	for (int i = 0; i < ncols; i++)
+	{
+		char *col_dest = (char *) col_bufs[i].validity;
+		int typlen = kds_col_typlen(col_descs[i].col_type);
+
+		/*
+		 * Compressed-payload columns have no Arrow representation; they can
+		 * only be built through the direct-write path.
+		 */
+		Assert(col_descs[i].compression == KDS_COMPRESSION_NONE);
+
+		if (col_descs[i].col_type == KDS_COL_VARLENA)
+		{
+			convert_varlena_column(col_dest, arrow_arrays[i], nrows,
+								   col_descs[i].varlena_data_len);
+		}
+		else if (col_descs[i].col_type == KDS_COL_DICTIONARY)
+		{
+			convert_dictionary_column(&col_bufs[i], arrow_arrays[i], nrows,
+									  &col_descs[i]);
+		}
+		else if (typlen > 0)
+		{
+			convert_fixed_column(col_dest, arrow_arrays[i], nrows, typlen);
+		}
+		else
+		{
+			convert_geometry_column(col_dest, arrow_arrays[i], nrows);
+		}
+	}
+
+	pfree(col_bufs);
+	return batch;
+}
+
 void
 kds_batch_free(KDSBatch *batch)
 {
 	if (batch == NULL)
 		return;
 	if (batch->buffer != NULL)
-		pfree(batch->buffer);
+		staging_release(batch->buffer, batch->pinned);
 	pfree(batch);
 }
 
@@ -15,6 +15,16 @@
  */
 #define KDS_FORMAT_COLUMN   4
 
+/*
+ * Compression algorithm tags for compressed-payload columns. The values
+ * match TimescaleDB's on-disk CompressionAlgorithm IDs, which are
+ * static-asserted stable in tsl/src/compression/compression.h; we define
+ * our own copies here for the same reason as the KDS format constants.
+ */
+#define KDS_COMPRESSION_NONE        0
+#define KDS_COMPRESSION_GORILLA     3
+#define KDS_COMPRESSION_DELTADELTA  4
+
 /*
  * Opaque KDS representation. The actual structure is defined by PG-Strom;
  * we build a byte buffer matching the expected binary layout.
@@ -25,6 +35,7 @@ typedef struct KDSBatch
 	size_t  buffer_len;    /* total bytes allocated */
 	int     ncols;         /* number of columns */
 	int     nrows;         /* number of rows */
+	bool    pinned;        /* buffer is pinned (page-locked) staging memory */
 } KDSBatch;
 
 /*
@@ -37,6 +48,8 @@ typedef enum KDSColumnType
 	KDS_COL_FLOAT4,        /* float4 */
 	KDS_COL_INT4,          /* int32 */
 	KDS_COL_INT2,          /* int16 */
+	KDS_COL_VARLENA,       /* text/bytea (Arrow offsets + data layout) */
+	KDS_COL_DICTIONARY,    /* dictionary-encoded text (int16 indexes) */
 	KDS_COL_GEOMETRY       /* geometry (variable-length with xpu_geometry_t header) */
 } KDSColumnType;
 
@@ -46,8 +59,70 @@ typedef struct KDSColumnDesc
 	int            attnum;        /* attribute number in the original tuple */
 	int            typlen;        /* type length for fixed-width columns */
 	bool           typbyval;      /* pass-by-value? */
+
+	/*
+	 * When compression is not KDS_COMPRESSION_NONE, the column is shipped
+	 * to the device as its on-disk compressed payload of payload_len bytes
+	 * and decompressed by a GPU kernel before aggregation, instead of being
+	 * decompressed on the host and transferred uncompressed. The column
+	 * region then holds a small header (payload length and algorithm tag)
+	 * followed by the payload; nulls are encoded within the payload, so
+	 * there is no host-side validity bitmap. Only use this for algorithms
+	 * that gpu_device_decompress_supported() reports as available.
+	 */
+	int            compression;   /* KDS_COMPRESSION_* tag */
+	size_t         payload_len;   /* compressed payload size in bytes */
+
+	/*
+	 * Variable-length (KDS_COL_VARLENA) columns use the Arrow layout on the
+	 * device as well: uint32 offsets[nrows + 1] followed by the value bytes.
+	 * varlena_data_len is the total value-byte size for the batch; for Arrow
+	 * input this is the end offset, offsets[nrows].
+	 */
+	size_t         varlena_data_len;
+
+	/*
+	 * Dictionary-encoded (KDS_COL_DICTIONARY) columns always ship the
+	 * per-batch int16 index array and reference the chunk's dictionary. When
+	 * dict_devptr is nonzero the dictionary is already device-resident
+	 * (uploaded once per chunk via gpu_cache_dictionary_devptr()) and only
+	 * the indexes travel with the batch; otherwise the dictionary
+	 * (dict_nitems entries, dict_data_len value bytes) is inlined into every
+	 * batch after the index array.
+	 */
+	int            dict_nitems;
+	size_t         dict_data_len;
+	uint64         dict_devptr;
 } KDSColumnDesc;
 
+/*
+ * Writable view of one column inside an allocated KDS buffer. Returned by
+ * kds_batch_create() so that producers (e.g. decompression routines) can
+ * write column values directly into the dispatch buffer instead of building
+ * an intermediate Arrow batch that is then copied.
+ */
+typedef struct KDSColumnBuffer
+{
+	uint64 *validity;      /* validity bitmap, LSB-first 64-bit words */
+	char   *data;          /* fixed-width values, or offsets+data for
+							* variable-length columns */
+	size_t  data_len;      /* bytes available at data */
+} KDSColumnBuffer;
+
+/*
+ * Allocate a KDS batch and write its header and column offsets, leaving the
+ * column contents to be filled in by the caller.
+ *
+ * If col_bufs is non-NULL it must have room for ncols entries and is filled
+ * with pointers into the batch buffer, one per column in KDS column order
+ * and with KDS alignment. Writing decompression output through these
+ * pointers produces a dispatch-ready buffer with no further copying. The
+ * caller must fully populate each column, including setting the unused
+ * trailing bits of the last validity bitmap word to zero.
+ */
+extern KDSBatch *kds_batch_create(const KDSColumnDesc *col_descs, int ncols,
+								  int nrows, KDSColumnBuffer *col_bufs);
+
 /*
  * Convert a set of Arrow arrays into a KDS columnar batch.
  *
@@ -10,6 +10,8 @@
 #
 # Options:
 #   --size N              Dataset size (default: 100000)
+#   --sweep-sizes LIST    Comma-separated dataset sizes to sweep (overrides --size)
+#   --iterations N        Timed iterations per query and mode (default: 11)
 #   --orbit TYPE          Orbit type: LEO, MEO, GEO, mixed (default: mixed)
 #   --timespan INTERVAL   Time span for data (default: '24 hours')
 #   --create-baseline     Save results as baseline
@@ -25,6 +27,8 @@ BASELINE_FILE="${SCRIPT_DIR}/baseline.json"
 
 # Defaults
 DATASET_SIZE=100000
+SWEEP_SIZES=""
+ITERATIONS=11
 ORBIT_TYPE="mixed"
 TIMESPAN="24 hours"
 DB_NAME="gpu_benchmark"
@@ -38,6 +42,8 @@ REGRESSION_THRESHOLD=0.15  # 15%
 while [[ $# -gt 0 ]]; do
     case "$1" in
         --size)         DATASET_SIZE="$2"; shift 2;;
+        --sweep-sizes)  SWEEP_SIZES="$2"; shift 2;;
+        --iterations)   ITERATIONS="$2"; shift 2;;
         --orbit)        ORBIT_TYPE="$2"; shift 2;;
         --timespan)     TIMESPAN="$2"; shift 2;;
         --create-baseline) CREATE_BASELINE=true; shift;;
@@ -56,25 +62,14 @@ TIMESTAMP=$(date +%Y%m%d_%H%M%S)
 RESULT_FILE="${RESULTS_DIR}/benchmark_${TIMESTAMP}.json"
 
 echo "=== GPU VectorAgg Benchmark ==="
-echo "Dataset: ${DATASET_SIZE} rows, orbit=${ORBIT_TYPE}, timespan=${TIMESPAN}"
-echo "Database: ${DB_NAME}"
+echo "Dataset sizes: ${SWEEP_SIZES:-${DATASET_SIZE}}, orbit=${ORBIT_TYPE}, timespan=${TIMESPAN}"
+echo "Database: ${DB_NAME}, iterations: ${ITERATIONS}"
 echo ""
 
 # Create database if needed
 psql -d postgres -tc "SELECT 1 FROM pg_database WHERE datname='${DB_NAME}'" | grep -q 1 || \
     createdb "${DB_NAME}"
 
-# Generate dataset
-if [ "${SKIP_GENERATE}" = false ]; then
-    echo "--- Generating dataset ---"
-    psql -d "${DB_NAME}" \
-        -v num_rows="${DATASET_SIZE}" \
-        -v orbit_type="${ORBIT_TYPE}" \
-        -v timespan="${TIMESPAN}" \
-        -f "${SCRIPT_DIR}/generate_dataset.sql"
-    echo ""
-fi
-
 # Query names (must match queries.sql tags)
 QUERIES=("proximity_search" "frame_conversion_agg" "range_distance" "timebucket_spatial_agg")
 
@@ -82,24 +77,36 @@ QUERIES=("proximity_search" "frame_conversion_agg" "range_distance" "timebucket_
 echo "[" > "${RESULT_FILE}"
 FIRST_RESULT=true
 
+# Pull a single query out of queries.sql by its "-- Tag: <name>" comment,
+# dropping psql metacommands and EXPLAIN wrappers so the statement itself
+# is what gets timed and compared.
+extract_query() {
+    local query_name="$1"
+    awk -v tag="${query_name}" '
+        /^-- Tag: /       { active = ($3 == tag); next }
+        active && /^\\/   { next }
+        active && /^EXPLAIN/ { next }
+        active && /^--/   { next }
+        active            { print }
+        active && /;[[:space:]]*$/ { active = 0 }
+    ' "${SCRIPT_DIR}/queries.sql"
+}
+
 run_query() {
     local query_name="$1"
     local mode="$2"  # "gpu" or "cpu"
-    local query_file="${SCRIPT_DIR}/queries.sql"
 
-    # Extract query by its tag comment
-    local setting=""
+    local setting="RESET timescaledb.gpu_min_batch_rows;"
     if [ "${mode}" = "cpu" ]; then
         setting="SET timescaledb.gpu_min_batch_rows = 2147483647;"
-    else
-        setting="RESET timescaledb.gpu_min_batch_rows;"
     fi
 
     # Run with timing and capture output
     local start_time end_time elapsed_ms
     start_time=$(date +%s%N)
 
-    psql -d "${DB_NAME}" -c "${setting}" -f "${query_file}" >/dev/null 2>&1 || true
+    psql -d "${DB_NAME}" -c "${setting}" \
+        -c "$(extract_query "${query_name}")" >/dev/null 2>&1 || true
 
     end_time=$(date +%s%N)
     elapsed_ms=$(( (end_time - start_time) / 1000000 ))
@@ -107,6 +114,15 @@ run_query() {
     echo "${elapsed_ms}"
 }
 
+# Nearest-rank percentile of the given latency samples, e.g.
+# "percentile 99 ${times[@]}".
+percentile() {
+    local pct="$1"; shift
+    printf '%s\n' "$@" | sort -n | awk -v p="${pct}" '
+        { vals[NR] = $1 }
+        END { print vals[int((p / 100) * (NR - 1) + 0.5) + 1] }'
+}
+
 compare_results() {
     local query_name="$1"
 
@@ -128,57 +144,92 @@ compare_results() {
     fi
 }
 
+# Dataset sizes to sweep (a single size unless --sweep-sizes was given)
+if [ -n "${SWEEP_SIZES}" ]; then
+    IFS=',' read -r -a SIZES <<< "${SWEEP_SIZES}"
+else
+    SIZES=("${DATASET_SIZE}")
+fi
+
 # Run benchmarks
 echo "--- Running benchmarks ---"
 echo ""
 
-for query_name in "${QUERIES[@]}"; do
-    echo "Query: ${query_name}"
-
-    # Run 3 iterations for each mode, take median
-    declare -a gpu_times=()
-    declare -a cpu_times=()
-
-    for _iter in 1 2 3; do
-        gpu_ms=$(run_query "${query_name}" "gpu")
-        cpu_ms=$(run_query "${query_name}" "cpu")
-        gpu_times+=("${gpu_ms}")
-        cpu_times+=("${cpu_ms}")
-    done
-
-    # Sort and take median (index 1 of 3)
-    gpu_median=$(printf '%s\n' "${gpu_times[@]}" | sort -n | sed -n '2p')
-    cpu_median=$(printf '%s\n' "${cpu_times[@]}" | sort -n | sed -n '2p')
-
-    # Calculate speedup
-    if [ "${gpu_median}" -gt 0 ]; then
-        speedup=$(echo "scale=2; ${cpu_median} / ${gpu_median}" | bc)
-    else
-        speedup="N/A"
+for dataset_size in "${SIZES[@]}"; do
+    if [ "${SKIP_GENERATE}" = false ]; then
+        echo "--- Generating dataset (${dataset_size} rows) ---"
+        psql -d "${DB_NAME}" \
+            -v num_rows="${dataset_size}" \
+            -v orbit_type="${ORBIT_TYPE}" \
+            -v timespan="${TIMESPAN}" \
+            -f "${SCRIPT_DIR}/generate_dataset.sql" >/dev/null
+        echo ""
     fi
 
-    # Result match check
-    result_match=$(compare_results "${query_name}")
+    for query_name in "${QUERIES[@]}"; do
+        echo "Query: ${query_name} (${dataset_size} rows)"
+
+        declare -a gpu_times=()
+        declare -a cpu_times=()
+
+        # One untimed warmup per mode so cache/JIT effects land outside
+        # the measured iterations
+        run_query "${query_name}" "gpu" >/dev/null
+        run_query "${query_name}" "cpu" >/dev/null
+
+        for (( _iter = 0; _iter < ITERATIONS; _iter++ )); do
+            gpu_times+=("$(run_query "${query_name}" "gpu")")
+            cpu_times+=("$(run_query "${query_name}" "cpu")")
+        done
+
+        gpu_p50=$(percentile 50 "${gpu_times[@]}")
+        gpu_p99=$(percentile 99 "${gpu_times[@]}")
+        cpu_p50=$(percentile 50 "${cpu_times[@]}")
+        cpu_p99=$(percentile 99 "${cpu_times[@]}")
+
+        # Speedup and throughput from the medians
+        if [ "${gpu_p50}" -gt 0 ]; then
+            speedup=$(echo "scale=2; ${cpu_p50} / ${gpu_p50}" | bc)
+            gpu_rows_per_sec=$(echo "${dataset_size} * 1000 / ${gpu_p50}" | bc)
+        else
+            speedup="N/A"
+            gpu_rows_per_sec="N/A"
+        fi
+        if [ "${cpu_p50}" -gt 0 ]; then
+            cpu_rows_per_sec=$(echo "${dataset_size} * 1000 / ${cpu_p50}" | bc)
+        else
+            cpu_rows_per_sec="N/A"
+        fi
+
+        # Result match check
+        result_match=$(compare_results "${query_name}")
 
-    echo "  CPU: ${cpu_median}ms  GPU: ${gpu_median}ms  Speedup: ${speedup}x  Match: ${result_match}"
+        echo "  CPU: p50=${cpu_p50}ms p99=${cpu_p99}ms  GPU: p50=${gpu_p50}ms p99=${gpu_p99}ms  Speedup: ${speedup}x  Match: ${result_match}"
 
-    # Append to JSON
-    if [ "${FIRST_RESULT}" = false ]; then
-        echo "," >> "${RESULT_FILE}"
-    fi
-    FIRST_RESULT=false
+        # Append to JSON; *_median_ms duplicates the p50 values so older
+        # baseline files keep working with the regression check below
+        if [ "${FIRST_RESULT}" = false ]; then
+            echo "," >> "${RESULT_FILE}"
+        fi
+        FIRST_RESULT=false
 
-    cat >> "${RESULT_FILE}" <<ENTRY
+        cat >> "${RESULT_FILE}" <<ENTRY
   {
     "query": "${query_name}",
-    "cpu_median_ms": ${cpu_median},
-    "gpu_median_ms": ${gpu_median},
+    "dataset_size": ${dataset_size},
+    "iterations": ${ITERATIONS},
+    "cpu_median_ms": ${cpu_p50},
+    "cpu_p99_ms": ${cpu_p99},
+    "gpu_median_ms": ${gpu_p50},
+    "gpu_p99_ms": ${gpu_p99},
+    "cpu_rows_per_sec": "${cpu_rows_per_sec}",
+    "gpu_rows_per_sec": "${gpu_rows_per_sec}",
     "speedup": "${speedup}",
     "result_match": ${result_match},
-    "dataset_size": ${DATASET_SIZE},
     "timestamp": "${TIMESTAMP}"
   }
 ENTRY
+    done
 done
 
 echo "]" >> "${RESULT_FILE}"
@@ -13,6 +13,8 @@
 
 #include <nodes/nodeFuncs.h>
 #include <nodes/primnodes.h>
+#include <storage/shmem.h>
+#include <storage/spin.h>
 
 #include "cost_model.h"
 #include "gpu_bridge.h"
@@ -26,37 +28,175 @@
 #define DEFAULT_GPU_PARALLELISM         1024
 
 /*
- * Shared-memory state for auto-calibration results.
- * In this prototype, we use module-level globals since we don't have
- * shared memory infrastructure. A production version would use DSM.
+ * Execution feedback state.
+ *
+ * Every successful dispatch reports its batch size and measured wall-clock
+ * time. We maintain exponentially weighted moments of those (bytes, us)
+ * samples and fit a straight line through them: the slope is the per-byte
+ * transfer cost and the intercept the fixed launch overhead. The
+ * exponential weighting makes the estimates track the actual hardware
+ * (PCIe generation, current bus contention) while forgetting stale samples.
+ *
+ * The state lives in shared memory when the module is loaded via
+ * shared_preload_libraries so all backends share one set of estimates;
+ * otherwise each backend keeps a local copy that converges after a few
+ * dispatches of its own.
+ */
+#define FEEDBACK_EWMA_ALPHA   0.05
+#define FEEDBACK_MIN_SAMPLES  8
+
+typedef struct GpuCalibrationState
+{
+	slock_t mutex;
+	uint64  nsamples;
+	/* exponentially weighted moments of (bytes, elapsed_us) per dispatch */
+	double  ewma_bytes;
+	double  ewma_us;
+	double  ewma_bytes_sq;
+	double  ewma_bytes_us;
+	/* one-shot manual calibration results */
+	bool    calibration_done;
+	double  calibrated_transfer_cost;
+	double  calibrated_launch_overhead;
+} GpuCalibrationState;
+
+static GpuCalibrationState local_calibration_state;
+static GpuCalibrationState *calibration_state = &local_calibration_state;
+
+Size
+gpu_calibration_shmem_size(void)
+{
+	return MAXALIGN(sizeof(GpuCalibrationState));
+}
+
+/*
+ * Attach to (and on first call initialize) the shared calibration state.
+ * Called from the shmem startup hook; must be under AddinShmemInitLock.
+ */
+void
+gpu_calibration_shmem_init(void)
+{
+	bool found;
+
+	calibration_state =
+		ShmemInitStruct("timescaledb_gpu_bridge calibration",
+						gpu_calibration_shmem_size(), &found);
+	if (!found)
+	{
+		memset(calibration_state, 0, sizeof(GpuCalibrationState));
+		SpinLockInit(&calibration_state->mutex);
+	}
+}
+
+/*
+ * Initialize the backend-local fallback state. Called from _PG_init.
+ */
+void
+gpu_calibration_init(void)
+{
+	SpinLockInit(&local_calibration_state.mutex);
+}
+
+void
+gpu_cost_feedback(size_t bytes_transferred, double elapsed_us)
+{
+	GpuCalibrationState *state = calibration_state;
+	double b = (double) bytes_transferred;
+
+	if (bytes_transferred == 0 || elapsed_us <= 0.0)
+		return;
+
+	SpinLockAcquire(&state->mutex);
+	if (state->nsamples == 0)
+	{
+		state->ewma_bytes = b;
+		state->ewma_us = elapsed_us;
+		state->ewma_bytes_sq = b * b;
+		state->ewma_bytes_us = b * elapsed_us;
+	}
+	else
+	{
+		state->ewma_bytes += FEEDBACK_EWMA_ALPHA * (b - state->ewma_bytes);
+		state->ewma_us += FEEDBACK_EWMA_ALPHA * (elapsed_us - state->ewma_us);
+		state->ewma_bytes_sq += FEEDBACK_EWMA_ALPHA * (b * b - state->ewma_bytes_sq);
+		state->ewma_bytes_us += FEEDBACK_EWMA_ALPHA * (b * elapsed_us - state->ewma_bytes_us);
+	}
+	state->nsamples++;
+	SpinLockRelease(&state->mutex);
+}
+
+/*
+ * Fit the cost line through the feedback samples. Returns false until
+ * enough samples with enough batch-size spread have been collected to make
+ * the fit meaningful (all samples the same size would make the slope
+ * indeterminate).
  */
-static bool calibration_done = false;
-static double calibrated_transfer_cost = 0.0;
-static double calibrated_launch_overhead = 0.0;
+static bool
+feedback_estimates(double *transfer_cost, double *launch_overhead)
+{
+	GpuCalibrationState *state = calibration_state;
+	double var,
+		cov,
+		mean_bytes,
+		mean_us;
+	uint64 nsamples;
+
+	SpinLockAcquire(&state->mutex);
+	nsamples = state->nsamples;
+	mean_bytes = state->ewma_bytes;
+	mean_us = state->ewma_us;
+	var = state->ewma_bytes_sq - state->ewma_bytes * state->ewma_bytes;
+	cov = state->ewma_bytes_us - state->ewma_bytes * state->ewma_us;
+	SpinLockRelease(&state->mutex);
+
+	if (nsamples < FEEDBACK_MIN_SAMPLES || var <= 0.0 || cov <= 0.0)
+		return false;
+
+	*transfer_cost = cov / var;
+	*launch_overhead = mean_us - *transfer_cost * mean_bytes;
+	if (*launch_overhead < 1.0)
+		*launch_overhead = 1.0;
+
+	return true;
+}
 
 /*
- * Get the effective transfer cost per byte: user-set GUC > calibrated > default.
+ * Get the effective transfer cost per byte:
+ * user-set GUC > execution feedback > manual calibration > default.
  */
 static double
 effective_transfer_cost(void)
 {
+	double transfer_cost,
+		launch_overhead;
+
 	if (gpu_transfer_cost_per_byte > 0.0)
 		return gpu_transfer_cost_per_byte;
-	if (calibration_done && calibrated_transfer_cost > 0.0)
-		return calibrated_transfer_cost;
+	if (feedback_estimates(&transfer_cost, &launch_overhead))
+		return transfer_cost;
+	if (calibration_state->calibration_done &&
+		calibration_state->calibrated_transfer_cost > 0.0)
+		return calibration_state->calibrated_transfer_cost;
 	return DEFAULT_TRANSFER_COST_PER_BYTE;
 }
 
 /*
- * Get the effective launch overhead: user-set GUC > calibrated > default.
+ * Get the effective launch overhead:
+ * user-set GUC > execution feedback > manual calibration > default.
  */
 static double
 effective_launch_overhead(void)
 {
+	double transfer_cost,
+		launch_overhead;
+
 	if (gpu_launch_overhead > 0.0)
 		return gpu_launch_overhead;
-	if (calibration_done && calibrated_launch_overhead > 0.0)
-		return calibrated_launch_overhead;
+	if (feedback_estimates(&transfer_cost, &launch_overhead))
+		return launch_overhead;
+	if (calibration_state->calibration_done &&
+		calibration_state->calibrated_launch_overhead > 0.0)
+		return calibration_state->calibrated_launch_overhead;
 	return DEFAULT_LAUNCH_OVERHEAD;
 }
 
@@ -204,11 +344,13 @@ gpu_calibrate_transfer_cost(size_t bytes_transferred, double elapsed_us)
 	 * cost_per_byte = elapsed_us / bytes_transferred
 	 * This assumes cost units are roughly proportional to microseconds.
 	 */
-	calibrated_transfer_cost = elapsed_us / (double) bytes_transferred;
-	calibration_done = true;
+	SpinLockAcquire(&calibration_state->mutex);
+	calibration_state->calibrated_transfer_cost = elapsed_us / (double) bytes_transferred;
+	calibration_state->calibration_done = true;
+	SpinLockRelease(&calibration_state->mutex);
 
 	elog(DEBUG1, "gpu_bridge: calibrated transfer cost = %.6f per byte (from %zu bytes in %.1f us)",
-		 calibrated_transfer_cost, bytes_transferred, elapsed_us);
+		 elapsed_us / (double) bytes_transferred, bytes_transferred, elapsed_us);
 }
 
 void
@@ -218,9 +360,11 @@ gpu_calibrate_launch_overhead(double elapsed_us, double compute_cost)
 	if (overhead <= 0.0)
 		overhead = 1.0;  /* minimum overhead */
 
-	calibrated_launch_overhead = overhead;
-	calibration_done = true;
+	SpinLockAcquire(&calibration_state->mutex);
+	calibration_state->calibrated_launch_overhead = overhead;
+	calibration_state->calibration_done = true;
+	SpinLockRelease(&calibration_state->mutex);
 
 	elog(DEBUG1, "gpu_bridge: calibrated launch overhead = %.1f (from %.1f us elapsed, %.1f compute)",
-		 calibrated_launch_overhead, elapsed_us, compute_cost);
+		 overhead, elapsed_us, compute_cost);
 }
@@ -37,6 +37,23 @@ extern GpuCostEstimate gpu_estimate_cost(List *agg_exprs, int nrows, int row_wid
  */
 extern double gpu_sum_opcode_costs(Expr *expr);
 
+/*
+ * Record the measured wall-clock time of one successful dispatch. Called
+ * from the dispatch paths after every GPU execution; maintains
+ * exponentially weighted estimates of transfer cost and launch overhead
+ * that gpu_estimate_cost() prefers over the built-in defaults.
+ */
+extern void gpu_cost_feedback(size_t bytes_transferred, double elapsed_us);
+
+/*
+ * Shared-memory plumbing for the feedback state. The size/init pair is
+ * used from the shmem hooks when the module is preloaded; gpu_calibration_init
+ * sets up the backend-local fallback and is always called from _PG_init.
+ */
+extern Size gpu_calibration_shmem_size(void);
+extern void gpu_calibration_shmem_init(void);
+extern void gpu_calibration_init(void);
+
 /*
  * Auto-calibrate transfer cost by measuring actual GPU transfer time.
  * Called after the first GPU batch execution.
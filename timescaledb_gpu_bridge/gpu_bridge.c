@@ -11,10 +11,14 @@
 #include <fmgr.h>
 #include <funcapi.h>
 #include <miscadmin.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
 #include <utils/builtins.h>
 #include <utils/guc.h>
 
 #include "gpu_bridge.h"
+#include "gpu_cache.h"
 #include "gpu_dispatch.h"
 #include "cost_model.h"
 
@@ -28,6 +32,8 @@ GpuBridgeStromAPI strom_api = {0};
 double gpu_transfer_cost_per_byte = 0.0;   /* 0 = auto-calibrate */
 double gpu_launch_overhead = 0.0;          /* 0 = auto-calibrate */
 int gpu_min_batch_rows = 0;                /* 0 = use cost model */
+int gpu_pinned_pool_size_mb = 64;          /* 0 = pinned staging disabled */
+int gpu_cache_size_mb = 0;                 /* 0 = device cache disabled */
 
 /*
  * Attempt to resolve a symbol from any loaded shared library.
@@ -70,6 +76,74 @@ discover_pgstrom(void)
 		return false;
 	}
 
+	/*
+	 * Asynchronous submission is optional: older PG-Strom builds only
+	 * provide the synchronous command. The dispatch pipeline falls back to
+	 * synchronous execution when these are missing. Both symbols must be
+	 * present for the async path to be usable.
+	 */
+	strom_api.xpu_command_submit = (int (*)(void *, size_t, void **))
+		resolve_symbol("pgstrom_xpu_command_submit");
+	strom_api.xpu_command_wait = (int (*)(void *, void *, size_t *))
+		resolve_symbol("pgstrom_xpu_command_wait");
+
+	if (strom_api.xpu_command_submit == NULL || strom_api.xpu_command_wait == NULL)
+	{
+		strom_api.xpu_command_submit = NULL;
+		strom_api.xpu_command_wait = NULL;
+	}
+
+	/*
+	 * Pinned host memory allocation is likewise optional; the staging pool
+	 * in arrow_kds.c falls back to pageable memory when it is missing.
+	 */
+	strom_api.pinned_alloc = (void *(*)(size_t)) resolve_symbol("pgstrom_pinned_alloc");
+	strom_api.pinned_free = (void (*)(void *)) resolve_symbol("pgstrom_pinned_free");
+
+	if (strom_api.pinned_alloc == NULL || strom_api.pinned_free == NULL)
+	{
+		strom_api.pinned_alloc = NULL;
+		strom_api.pinned_free = NULL;
+	}
+
+	/*
+	 * Device-side decompression is optional as well; without it, batches
+	 * are decompressed on the host and shipped uncompressed.
+	 */
+	strom_api.device_decompress_lookup =
+		(int (*)(int)) resolve_symbol("pgstrom_device_decompress_lookup");
+
+	/*
+	 * Device-resident batch caching needs all three cache entry points.
+	 */
+	strom_api.devmem_upload =
+		(void *(*)(const void *, size_t)) resolve_symbol("pgstrom_devmem_upload");
+	strom_api.devmem_free = (void (*)(void *)) resolve_symbol("pgstrom_devmem_free");
+	strom_api.xpu_command_dev = (int (*)(void *, size_t, void *, size_t *))
+		resolve_symbol("pgstrom_xpu_command_dev");
+
+	if (strom_api.devmem_upload == NULL || strom_api.devmem_free == NULL ||
+		strom_api.xpu_command_dev == NULL)
+	{
+		strom_api.devmem_upload = NULL;
+		strom_api.devmem_free = NULL;
+		strom_api.xpu_command_dev = NULL;
+	}
+
+	/*
+	 * Multi-GPU support. Device-targeted submission requires the async
+	 * wait entry point; topology-aware selection is a further optional
+	 * refinement on top.
+	 */
+	strom_api.gpu_device_count = (int (*)(void)) resolve_symbol("pgstrom_gpu_device_count");
+	strom_api.gpu_device_preferred =
+		(int (*)(void)) resolve_symbol("pgstrom_gpu_device_preferred");
+	strom_api.xpu_command_submit_on = (int (*)(void *, size_t, int, void **))
+		resolve_symbol("pgstrom_xpu_command_submit_on");
+
+	if (strom_api.xpu_command_wait == NULL)
+		strom_api.xpu_command_submit_on = NULL;
+
 	return true;
 }
 
@@ -132,6 +206,63 @@ register_gucs(void)
 		PGC_USERSET,
 		0,
 		NULL, NULL, NULL);
+
+	DefineCustomIntVariable(
+		"timescaledb.gpu_pinned_pool_size",
+		"Size of the pinned host memory pool for GPU transfer staging, in MB",
+		"KDS batches are staged in pinned (page-locked) memory up to this "
+		"total, which allows the driver to DMA directly instead of going "
+		"through an internal staging copy. Set to 0 to always use pageable "
+		"memory.",
+		&gpu_pinned_pool_size_mb,
+		64,         /* default */
+		0,          /* min */
+		INT_MAX,    /* max */
+		PGC_USERSET,
+		GUC_UNIT_MB,
+		NULL, NULL, NULL);
+
+	DefineCustomIntVariable(
+		"timescaledb.gpu_cache_size",
+		"Size of the device-resident KDS batch cache, in MB",
+		"Uploaded batches stay cached in GPU memory up to this total so "
+		"that repeat aggregations over unchanged chunks skip the "
+		"host-to-device transfer. Set to 0 to disable caching.",
+		&gpu_cache_size_mb,
+		0,          /* default */
+		0,          /* min */
+		INT_MAX,    /* max */
+		PGC_USERSET,
+		GUC_UNIT_MB,
+		NULL, NULL, NULL);
+}
+
+/*
+ * Shared-memory hooks for the cost model feedback state. Only effective
+ * when the module is listed in shared_preload_libraries; otherwise the
+ * cost model falls back to backend-local state.
+ */
+static shmem_request_hook_type prev_shmem_request_hook = NULL;
+static shmem_startup_hook_type prev_shmem_startup_hook = NULL;
+
+static void
+gpu_bridge_shmem_request(void)
+{
+	if (prev_shmem_request_hook != NULL)
+		prev_shmem_request_hook();
+
+	RequestAddinShmemSpace(gpu_calibration_shmem_size());
+}
+
+static void
+gpu_bridge_shmem_startup(void)
+{
+	if (prev_shmem_startup_hook != NULL)
+		prev_shmem_startup_hook();
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+	gpu_calibration_shmem_init();
+	LWLockRelease(AddinShmemInitLock);
 }
 
 /*
@@ -141,6 +272,16 @@ void
 _PG_init(void)
 {
 	register_gucs();
+	gpu_calibration_init();
+	gpu_cache_init();
+
+	if (process_shared_preload_libraries_in_progress)
+	{
+		prev_shmem_request_hook = shmem_request_hook;
+		shmem_request_hook = gpu_bridge_shmem_request;
+		prev_shmem_startup_hook = shmem_startup_hook;
+		shmem_startup_hook = gpu_bridge_shmem_startup;
+	}
 
 	timescaledb_detected = discover_timescaledb();
 	if (!timescaledb_detected)
@@ -45,6 +45,92 @@ typedef struct GpuBridgeStromAPI
 	 * Signature: int (*)(void)
 	 */
 	int (*gpu_parallelism)(void);
+
+	/*
+	 * pgstrom_xpu_command_submit - enqueue a KDS batch for asynchronous GPU
+	 * execution. The batch buffer must stay valid until the command is
+	 * collected with xpu_command_wait. Optional; NULL when the loaded
+	 * PG-Strom build only supports synchronous commands.
+	 * Signature: int (*)(void *kds, size_t kds_len, void **handle)
+	 * Returns 0 on success and stores an opaque in-flight handle.
+	 */
+	int (*xpu_command_submit)(void *kds, size_t kds_len, void **handle);
+
+	/*
+	 * pgstrom_xpu_command_wait - wait for an in-flight command and collect
+	 * its result. Only present together with xpu_command_submit.
+	 * Signature: int (*)(void *handle, void *result, size_t *result_len)
+	 */
+	int (*xpu_command_wait)(void *handle, void *result, size_t *result_len);
+
+	/*
+	 * pgstrom_pinned_alloc - allocate pinned (page-locked) host memory for
+	 * staging GPU transfers. Optional; NULL when the loaded PG-Strom build
+	 * does not expose pinned allocation. Returns NULL on failure.
+	 * Signature: void *(*)(size_t len)
+	 */
+	void *(*pinned_alloc)(size_t len);
+
+	/*
+	 * pgstrom_pinned_free - release memory from pinned_alloc. Only present
+	 * together with pinned_alloc.
+	 * Signature: void (*)(void *ptr)
+	 */
+	void (*pinned_free)(void *ptr);
+
+	/*
+	 * pgstrom_device_decompress_lookup - check whether the device has a
+	 * decompression kernel for a compression algorithm (KDS_COMPRESSION_*
+	 * tag). Optional; NULL when the loaded PG-Strom build cannot
+	 * decompress on-device. Returns nonzero if supported.
+	 * Signature: int (*)(int algorithm)
+	 */
+	int (*device_decompress_lookup)(int algorithm);
+
+	/*
+	 * pgstrom_gpu_device_count - number of usable GPU devices. Optional;
+	 * a single device is assumed when missing.
+	 * Signature: int (*)(void)
+	 */
+	int (*gpu_device_count)(void);
+
+	/*
+	 * pgstrom_gpu_device_preferred - device with the best NUMA/PCIe
+	 * affinity to the calling process. Optional; device selection falls
+	 * back to round-robin when missing.
+	 * Signature: int (*)(void)
+	 */
+	int (*gpu_device_preferred)(void);
+
+	/*
+	 * pgstrom_xpu_command_submit_on - like xpu_command_submit, but targets
+	 * a specific device. Optional; required for multi-GPU dispatch.
+	 * Signature: int (*)(void *kds, size_t kds_len, int device, void **handle)
+	 */
+	int (*xpu_command_submit_on)(void *kds, size_t kds_len, int device, void **handle);
+
+	/*
+	 * pgstrom_devmem_upload - allocate device memory and upload a buffer,
+	 * returning an opaque device buffer handle. Optional; required for
+	 * the device-resident batch cache. Returns NULL on failure.
+	 * Signature: void *(*)(const void *host, size_t len)
+	 */
+	void *(*devmem_upload)(const void *host, size_t len);
+
+	/*
+	 * pgstrom_devmem_free - release a handle from devmem_upload. Only
+	 * present together with devmem_upload.
+	 * Signature: void (*)(void *devptr)
+	 */
+	void (*devmem_free)(void *devptr);
+
+	/*
+	 * pgstrom_xpu_command_dev - like xpu_command, but executes against a
+	 * device-resident KDS buffer from devmem_upload, skipping the
+	 * host-to-device transfer. Only present together with devmem_upload.
+	 * Signature: int (*)(void *devptr, size_t kds_len, void *result, size_t *result_len)
+	 */
+	int (*xpu_command_dev)(void *devptr, size_t kds_len, void *result, size_t *result_len);
 } GpuBridgeStromAPI;
 
 extern GpuBridgeStromAPI strom_api;
@@ -55,3 +141,5 @@ extern GpuBridgeStromAPI strom_api;
 extern double gpu_transfer_cost_per_byte;
 extern double gpu_launch_overhead;
 extern int gpu_min_batch_rows;
+extern int gpu_pinned_pool_size_mb;
+extern int gpu_cache_size_mb;
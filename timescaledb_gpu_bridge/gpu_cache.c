@@ -0,0 +1,231 @@
+/*
+ * gpu_cache.c - device-resident KDS batch cache
+ *
+ * Dashboards re-aggregate the same recent chunks every refresh interval,
+ * re-transferring identical KDS batches over PCIe each time. This cache
+ * keeps uploaded batches resident in GPU memory, keyed by
+ * (chunk relid, batch id, column set), with LRU eviction bounded by the
+ * timescaledb.gpu_cache_size GUC.
+ *
+ * Device memory itself is managed by PG-Strom through optional symbols
+ * (upload/free and a command variant that executes against a
+ * device-resident buffer); this file only keeps the host-side directory.
+ * The directory is per-backend, matching the per-backend device contexts
+ * the handles belong to.
+ */
+#include <postgres.h>
+
+#include <common/hashfn.h>
+#include <lib/ilist.h>
+#include <utils/hsearch.h>
+#include <utils/inval.h>
+#include <utils/memutils.h>
+
+#include "gpu_cache.h"
+#include "gpu_bridge.h"
+
+typedef struct GpuCacheKey
+{
+	Oid     chunk_relid;
+	int32   batch_id;
+	uint32  colset_hash;
+} GpuCacheKey;
+
+typedef struct GpuCacheEntry
+{
+	GpuCacheKey key;         /* hash key, must be first */
+	void       *devptr;      /* opaque device buffer handle */
+	size_t      len;         /* uploaded bytes */
+	dlist_node  lru_node;    /* position in LRU list, head = most recent */
+} GpuCacheEntry;
+
+static HTAB *gpu_cache_htab = NULL;
+static dlist_head gpu_cache_lru;
+static size_t gpu_cache_bytes = 0;
+
+static bool
+gpu_cache_available(void)
+{
+	return gpu_bridge_enabled && gpu_cache_size_mb > 0 &&
+		   strom_api.devmem_upload != NULL;
+}
+
+static void
+gpu_cache_remove(GpuCacheEntry *entry)
+{
+	dlist_delete(&entry->lru_node);
+	gpu_cache_bytes -= entry->len;
+	strom_api.devmem_free(entry->devptr);
+	hash_search(gpu_cache_htab, &entry->key, HASH_REMOVE, NULL);
+}
+
+/*
+ * Relcache invalidation callback: drop cached batches of relations whose
+ * relcache entry is invalidated. This catches rewrites, truncates and
+ * drops even if the integration layer forgets an explicit invalidation.
+ * relid is InvalidOid for sinval queue overflow, which invalidates
+ * everything.
+ */
+static void
+gpu_cache_relcache_callback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	GpuCacheEntry *entry;
+
+	if (gpu_cache_htab == NULL)
+		return;
+
+	hash_seq_init(&status, gpu_cache_htab);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		if (!OidIsValid(relid) || entry->key.chunk_relid == relid)
+			gpu_cache_remove(entry);
+	}
+}
+
+void
+gpu_cache_init(void)
+{
+	HASHCTL ctl = {
+		.keysize = sizeof(GpuCacheKey),
+		.entrysize = sizeof(GpuCacheEntry),
+		.hcxt = TopMemoryContext,
+	};
+
+	gpu_cache_htab = hash_create("gpu_bridge batch cache",
+								 256,
+								 &ctl,
+								 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	dlist_init(&gpu_cache_lru);
+	CacheRegisterRelcacheCallback(gpu_cache_relcache_callback, (Datum) 0);
+}
+
+uint32
+gpu_cache_colset_hash(const KDSColumnDesc *col_descs, int ncols)
+{
+	uint32 hash = (uint32) ncols;
+
+	for (int i = 0; i < ncols; i++)
+	{
+		hash = hash_combine(hash, (uint32) col_descs[i].attnum);
+		hash = hash_combine(hash, (uint32) col_descs[i].col_type);
+		hash = hash_combine(hash, (uint32) col_descs[i].compression);
+	}
+	return hash;
+}
+
+void *
+gpu_cache_lookup(Oid chunk_relid, int32 batch_id, uint32 colset_hash, size_t *len)
+{
+	GpuCacheKey key = {
+		.chunk_relid = chunk_relid,
+		.batch_id = batch_id,
+		.colset_hash = colset_hash,
+	};
+	GpuCacheEntry *entry;
+
+	if (!gpu_cache_available())
+		return NULL;
+
+	entry = hash_search(gpu_cache_htab, &key, HASH_FIND, NULL);
+	if (entry == NULL)
+		return NULL;
+
+	/* Move to the front of the LRU */
+	dlist_delete(&entry->lru_node);
+	dlist_push_head(&gpu_cache_lru, &entry->lru_node);
+
+	if (len != NULL)
+		*len = entry->len;
+	return entry->devptr;
+}
+
+void *
+gpu_cache_insert(Oid chunk_relid, int32 batch_id, uint32 colset_hash,
+				 const void *kds_buffer, size_t kds_len)
+{
+	GpuCacheKey key = {
+		.chunk_relid = chunk_relid,
+		.batch_id = batch_id,
+		.colset_hash = colset_hash,
+	};
+	size_t cache_limit = (size_t) gpu_cache_size_mb * 1024 * 1024;
+	GpuCacheEntry *entry;
+	void *devptr;
+	bool found;
+
+	if (!gpu_cache_available() || kds_len > cache_limit)
+		return NULL;
+
+	/* Evict from the LRU tail until the batch fits */
+	while (gpu_cache_bytes + kds_len > cache_limit && !dlist_is_empty(&gpu_cache_lru))
+	{
+		GpuCacheEntry *victim =
+			dlist_container(GpuCacheEntry, lru_node, dlist_tail_node(&gpu_cache_lru));
+
+		gpu_cache_remove(victim);
+	}
+
+	devptr = strom_api.devmem_upload(kds_buffer, kds_len);
+	if (devptr == NULL)
+	{
+		elog(DEBUG1, "gpu_bridge: device upload of %zu bytes failed, not caching", kds_len);
+		return NULL;
+	}
+
+	entry = hash_search(gpu_cache_htab, &key, HASH_ENTER, &found);
+	if (found)
+	{
+		/* Stale entry under the same key; replace its buffer */
+		dlist_delete(&entry->lru_node);
+		gpu_cache_bytes -= entry->len;
+		strom_api.devmem_free(entry->devptr);
+	}
+	entry->devptr = devptr;
+	entry->len = kds_len;
+	dlist_push_head(&gpu_cache_lru, &entry->lru_node);
+	gpu_cache_bytes += kds_len;
+
+	return devptr;
+}
+
+/*
+ * Dictionary uploads share the batch directory and its LRU/invalidation
+ * machinery, keyed with negative batch ids so they can never collide with
+ * real batch numbers (which are always >= 0).
+ */
+#define GPU_CACHE_DICT_BATCH_ID(attnum) (-(attnum) - 1)
+
+uint64
+gpu_cache_dictionary_devptr(Oid chunk_relid, int attnum, const uint32 *offsets,
+							const char *data, int nitems, size_t data_len)
+{
+	int32 batch_id = GPU_CACHE_DICT_BATCH_ID(attnum);
+	size_t offsets_len = MAXALIGN(((size_t) nitems + 1) * sizeof(uint32));
+	size_t total_len = offsets_len + MAXALIGN(data_len);
+	void *devptr;
+	char *staged;
+
+	devptr = gpu_cache_lookup(chunk_relid, batch_id, 0, NULL);
+	if (devptr != NULL)
+		return (uint64) (uintptr_t) devptr;
+
+	if (!gpu_cache_available())
+		return 0;
+
+	/* Assemble the device layout: offset array, then value bytes */
+	staged = palloc0(total_len);
+	memcpy(staged, offsets, ((size_t) nitems + 1) * sizeof(uint32));
+	memcpy(staged + offsets_len, data, data_len);
+
+	devptr = gpu_cache_insert(chunk_relid, batch_id, 0, staged, total_len);
+	pfree(staged);
+
+	return (uint64) (uintptr_t) devptr;
+}
+
+void
+gpu_cache_invalidate_rel(Oid chunk_relid)
+{
+	gpu_cache_relcache_callback((Datum) 0, chunk_relid);
+}
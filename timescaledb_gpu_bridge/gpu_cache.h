@@ -0,0 +1,60 @@
+/*
+ * gpu_cache.h - device-resident KDS batch cache
+ *
+ * Caches uploaded KDS batches in GPU memory so that repeated aggregations
+ * over the same chunks (e.g. dashboard refreshes) skip the host-to-device
+ * transfer entirely.
+ */
+#pragma once
+
+#include <postgres.h>
+
+#include "arrow_kds.h"
+
+/*
+ * Initialize the cache machinery; called from _PG_init.
+ */
+extern void gpu_cache_init(void);
+
+/*
+ * Hash a column set so that the same batch aggregated over different
+ * column subsets gets distinct cache entries.
+ */
+extern uint32 gpu_cache_colset_hash(const KDSColumnDesc *col_descs, int ncols);
+
+/*
+ * Look up the device-resident copy of a batch. Returns the opaque device
+ * buffer handle and its length, or NULL if not cached. A hit moves the
+ * entry to the front of the LRU.
+ */
+extern void *gpu_cache_lookup(Oid chunk_relid, int32 batch_id, uint32 colset_hash,
+							  size_t *len);
+
+/*
+ * Upload a KDS batch to device memory and remember it under the given key,
+ * evicting least-recently-used entries to stay within
+ * timescaledb.gpu_cache_size. Returns the device buffer handle, or NULL if
+ * caching is disabled or the upload failed (the caller then dispatches
+ * from host memory as usual).
+ */
+extern void *gpu_cache_insert(Oid chunk_relid, int32 batch_id, uint32 colset_hash,
+							  const void *kds_buffer, size_t kds_len);
+
+/*
+ * Device-resident copy of a chunk's text dictionary, uploaded on first use
+ * and shared by every batch of the chunk (see KDS_COL_DICTIONARY). offsets
+ * and data are the Arrow text buffers of the dictionary array. Returns 0
+ * when caching is unavailable or the upload failed; the converter then
+ * inlines the dictionary into each batch instead.
+ */
+extern uint64 gpu_cache_dictionary_devptr(Oid chunk_relid, int attnum,
+										  const uint32 *offsets, const char *data,
+										  int nitems, size_t data_len);
+
+/*
+ * Drop all cached batches of one chunk. Must be called whenever the
+ * chunk's contents change (DML into a compressed chunk, recompression,
+ * truncate); relation-level invalidations (rewrites, drops) are also
+ * picked up automatically through a relcache callback.
+ */
+extern void gpu_cache_invalidate_rel(Oid chunk_relid);
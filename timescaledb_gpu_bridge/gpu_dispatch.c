@@ -10,11 +10,13 @@
 
 #include <nodes/nodeFuncs.h>
 #include <nodes/primnodes.h>
+#include <portability/instr_time.h>
 #include <utils/lsyscache.h>
 
 #include "gpu_dispatch.h"
 #include "gpu_bridge.h"
 #include "arrow_kds.h"
+#include "cost_model.h"
 
 /*
  * Recursively check if a single expression node is GPU-eligible.
@@ -109,6 +111,18 @@ gpu_expr_is_eligible(Expr *expr)
 	}
 }
 
+bool
+gpu_device_decompress_supported(int algorithm)
+{
+	if (!gpu_bridge_enabled || strom_api.device_decompress_lookup == NULL)
+		return false;
+
+	if (algorithm == KDS_COMPRESSION_NONE)
+		return false;
+
+	return strom_api.device_decompress_lookup(algorithm) != 0;
+}
+
 bool
 gpu_check_eligibility(List *agg_exprs)
 {
@@ -139,12 +153,450 @@ gpu_dispatch_batch(void *kds_buffer, size_t kds_len,
 		return false;
 	}
 
+	instr_time start,
+		duration;
+
+	INSTR_TIME_SET_CURRENT(start);
 	int rc = strom_api.xpu_command(kds_buffer, kds_len, result, result_len);
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+
+	if (rc != 0)
+	{
+		elog(DEBUG1, "gpu_bridge: GPU execution failed (rc=%d), falling back to CPU", rc);
+		return false;
+	}
+
+	gpu_cost_feedback(kds_len, INSTR_TIME_GET_MICROSEC(duration));
+	return true;
+}
+
+bool
+gpu_dispatch_cached(void *devptr, size_t kds_len, void *result, size_t *result_len)
+{
+	if (!gpu_bridge_enabled || strom_api.xpu_command_dev == NULL)
+	{
+		elog(DEBUG1, "gpu_bridge: cached GPU dispatch not available, falling back to CPU");
+		return false;
+	}
+
+	int rc = strom_api.xpu_command_dev(devptr, kds_len, result, result_len);
 	if (rc != 0)
 	{
 		elog(DEBUG1, "gpu_bridge: GPU execution failed (rc=%d), falling back to CPU", rc);
 		return false;
 	}
 
+	/*
+	 * No cost model feedback here: cached executions have no transfer
+	 * component and would skew the per-byte transfer estimate.
+	 */
 	return true;
 }
+
+/*
+ * Pipelined dispatch.
+ *
+ * A fixed ring of slots tracks batches that have been submitted but not yet
+ * retired. With PG-Strom's asynchronous commands, submitting batch N+1
+ * overlaps its host-to-device transfer with batch N's execution; the
+ * synchronous fallback executes at submit time and merely holds the result
+ * until drained, so callers use the same loop either way.
+ */
+typedef struct GpuPipelineSlot
+{
+	void   *handle;      /* opaque in-flight handle, NULL in sync mode */
+	void   *kds_buffer;  /* staging buffer, referenced until retired */
+	size_t  kds_len;     /* batch size, for cost model feedback */
+	void   *result;      /* caller's result buffer */
+	size_t *result_len;
+	bool    completed;   /* result already produced (sync mode) */
+	int     rc;          /* command status, valid once completed */
+	instr_time submit_time; /* when the command was handed to the GPU */
+} GpuPipelineSlot;
+
+struct GpuBatchPipeline
+{
+	GpuPipelineSlot slots[GPU_PIPELINE_DEPTH];
+	int     head;        /* oldest in-flight slot */
+	int     inflight;    /* number of occupied slots */
+	int     device;      /* target device, or -1 for PG-Strom's default */
+};
+
+GpuBatchPipeline *
+gpu_pipeline_create(void)
+{
+	return gpu_pipeline_create_for_device(-1);
+}
+
+GpuBatchPipeline *
+gpu_pipeline_create_for_device(int device)
+{
+	GpuBatchPipeline *pipeline = palloc0(sizeof(GpuBatchPipeline));
+
+	pipeline->device = device;
+	return pipeline;
+}
+
+bool
+gpu_pipeline_full(const GpuBatchPipeline *pipeline)
+{
+	return pipeline->inflight == GPU_PIPELINE_DEPTH;
+}
+
+/*
+ * Submit a batch to the pipeline. The caller must have drained at least one
+ * slot if the pipeline is full, and must keep kds_buffer valid until the
+ * batch is retired by gpu_pipeline_drain().
+ *
+ * Returns false if the batch could not be handed to the GPU at all, in
+ * which case it occupies no slot and the caller should execute it on CPU.
+ */
+bool
+gpu_pipeline_submit(GpuBatchPipeline *pipeline, void *kds_buffer, size_t kds_len,
+					void *result, size_t *result_len)
+{
+	GpuPipelineSlot *slot;
+
+	if (!gpu_bridge_enabled || strom_api.xpu_command == NULL)
+	{
+		elog(DEBUG1, "gpu_bridge: GPU dispatch not available, falling back to CPU");
+		return false;
+	}
+
+	if (gpu_pipeline_full(pipeline))
+		elog(ERROR, "gpu_bridge: batch submitted to full pipeline");
+
+	slot = &pipeline->slots[(pipeline->head + pipeline->inflight) % GPU_PIPELINE_DEPTH];
+	slot->kds_buffer = kds_buffer;
+	slot->kds_len = kds_len;
+	slot->result = result;
+	slot->result_len = result_len;
+	INSTR_TIME_SET_CURRENT(slot->submit_time);
+
+	if (pipeline->device >= 0 && strom_api.xpu_command_submit_on != NULL)
+	{
+		int rc = strom_api.xpu_command_submit_on(kds_buffer,
+												 kds_len,
+												 pipeline->device,
+												 &slot->handle);
+
+		if (rc != 0)
+		{
+			elog(DEBUG1, "gpu_bridge: GPU submit failed (rc=%d), falling back to CPU", rc);
+			return false;
+		}
+		slot->completed = false;
+	}
+	else if (strom_api.xpu_command_submit != NULL)
+	{
+		int rc = strom_api.xpu_command_submit(kds_buffer, kds_len, &slot->handle);
+
+		if (rc != 0)
+		{
+			elog(DEBUG1, "gpu_bridge: GPU submit failed (rc=%d), falling back to CPU", rc);
+			return false;
+		}
+		slot->completed = false;
+	}
+	else
+	{
+		/* Synchronous fallback: execute now, retire on drain */
+		instr_time duration;
+
+		slot->handle = NULL;
+		slot->rc = strom_api.xpu_command(kds_buffer, kds_len, result, result_len);
+		slot->completed = true;
+
+		if (slot->rc != 0)
+		{
+			elog(DEBUG1,
+				 "gpu_bridge: GPU execution failed (rc=%d), falling back to CPU",
+				 slot->rc);
+			return false;
+		}
+
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, slot->submit_time);
+		gpu_cost_feedback(kds_len, INSTR_TIME_GET_MICROSEC(duration));
+	}
+
+	pipeline->inflight++;
+	return true;
+}
+
+/*
+ * Retire the oldest in-flight batch, waiting for it if necessary. Returns
+ * false when the pipeline is empty. On a failed command, retired->success
+ * is false and the caller should execute the batch on CPU.
+ */
+bool
+gpu_pipeline_drain(GpuBatchPipeline *pipeline, GpuPipelineResult *retired)
+{
+	GpuPipelineSlot *slot;
+
+	if (pipeline->inflight == 0)
+		return false;
+
+	slot = &pipeline->slots[pipeline->head];
+
+	if (!slot->completed)
+	{
+		slot->rc = strom_api.xpu_command_wait(slot->handle, slot->result, slot->result_len);
+		slot->completed = true;
+
+		if (slot->rc != 0)
+			elog(DEBUG1,
+				 "gpu_bridge: GPU execution failed (rc=%d), falling back to CPU",
+				 slot->rc);
+		else
+		{
+			/*
+			 * Submit-to-completion time includes any queueing behind the
+			 * previous batch, so this slightly overestimates cost under
+			 * full pipelining; that bias is conservative (it never makes
+			 * the GPU look cheaper than it is).
+			 */
+			instr_time duration;
+
+			INSTR_TIME_SET_CURRENT(duration);
+			INSTR_TIME_SUBTRACT(duration, slot->submit_time);
+			gpu_cost_feedback(slot->kds_len, INSTR_TIME_GET_MICROSEC(duration));
+		}
+	}
+
+	retired->kds_buffer = slot->kds_buffer;
+	retired->result = slot->result;
+	retired->result_len = slot->result_len;
+	retired->success = (slot->rc == 0);
+
+	pipeline->head = (pipeline->head + 1) % GPU_PIPELINE_DEPTH;
+	pipeline->inflight--;
+
+	return true;
+}
+
+/*
+ * Destroy a pipeline, waiting out any in-flight commands so their staging
+ * buffers are no longer referenced by the GPU. Results are discarded.
+ */
+void
+gpu_pipeline_destroy(GpuBatchPipeline *pipeline)
+{
+	GpuPipelineResult retired;
+
+	while (gpu_pipeline_drain(pipeline, &retired))
+		;
+
+	pfree(pipeline);
+}
+
+/*
+ * Multi-GPU dispatch.
+ *
+ * One pipeline per device partitions a query's batches across all GPUs.
+ * Devices only differ in where a batch executes; results are per-batch
+ * partial aggregates either way, so drains can retire batches from any
+ * device in any order.
+ */
+struct GpuMultiPipeline
+{
+	int     ndevices;
+	int     next_device;   /* round-robin cursor for submissions */
+	int     drain_cursor;  /* round-robin cursor for drains */
+	GpuBatchPipeline *pipelines[FLEXIBLE_ARRAY_MEMBER];
+};
+
+int
+gpu_device_count(void)
+{
+	if (gpu_bridge_enabled && strom_api.gpu_device_count != NULL)
+	{
+		int n = strom_api.gpu_device_count();
+
+		if (n > 0)
+			return n;
+	}
+	return 1;
+}
+
+GpuMultiPipeline *
+gpu_multi_pipeline_create(void)
+{
+	GpuMultiPipeline *pipeline;
+	int ndevices = 1;
+
+	/* Per-device queues need device-targeted submission */
+	if (gpu_bridge_enabled && strom_api.xpu_command_submit_on != NULL)
+		ndevices = gpu_device_count();
+
+	pipeline = palloc0(offsetof(GpuMultiPipeline, pipelines) +
+					   sizeof(GpuBatchPipeline *) * ndevices);
+	pipeline->ndevices = ndevices;
+
+	for (int i = 0; i < ndevices; i++)
+		pipeline->pipelines[i] = gpu_pipeline_create_for_device(ndevices > 1 ? i : -1);
+
+	return pipeline;
+}
+
+bool
+gpu_multi_pipeline_full(const GpuMultiPipeline *pipeline)
+{
+	for (int i = 0; i < pipeline->ndevices; i++)
+	{
+		if (!gpu_pipeline_full(pipeline->pipelines[i]))
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Submit a batch to the least-loaded suitable device. The device with the
+ * best NUMA/PCIe affinity to this backend is tried first when PG-Strom
+ * reports one; otherwise devices are probed round-robin, skipping full
+ * queues so one slow device does not stall the others.
+ */
+bool
+gpu_multi_pipeline_submit(GpuMultiPipeline *pipeline, void *kds_buffer, size_t kds_len,
+						  void *result, size_t *result_len)
+{
+	int start = pipeline->next_device;
+
+	if (pipeline->ndevices > 1 && strom_api.gpu_device_preferred != NULL)
+	{
+		int preferred = strom_api.gpu_device_preferred();
+
+		if (preferred >= 0 && preferred < pipeline->ndevices)
+			start = preferred;
+	}
+
+	for (int i = 0; i < pipeline->ndevices; i++)
+	{
+		int device = (start + i) % pipeline->ndevices;
+
+		if (!gpu_pipeline_full(pipeline->pipelines[device]))
+		{
+			pipeline->next_device = (device + 1) % pipeline->ndevices;
+			return gpu_pipeline_submit(pipeline->pipelines[device],
+									   kds_buffer,
+									   kds_len,
+									   result,
+									   result_len);
+		}
+	}
+
+	elog(ERROR, "gpu_bridge: batch submitted to full pipeline");
+	pg_unreachable();
+}
+
+/*
+ * Retire a batch from any device, cycling through them so no device's
+ * completed work waits behind another's. Returns false when all device
+ * queues are empty.
+ */
+bool
+gpu_multi_pipeline_drain(GpuMultiPipeline *pipeline, GpuPipelineResult *retired)
+{
+	for (int i = 0; i < pipeline->ndevices; i++)
+	{
+		int device = (pipeline->drain_cursor + i) % pipeline->ndevices;
+
+		if (gpu_pipeline_drain(pipeline->pipelines[device], retired))
+		{
+			pipeline->drain_cursor = (device + 1) % pipeline->ndevices;
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+gpu_multi_pipeline_destroy(GpuMultiPipeline *pipeline)
+{
+	for (int i = 0; i < pipeline->ndevices; i++)
+		gpu_pipeline_destroy(pipeline->pipelines[i]);
+	pfree(pipeline);
+}
+
+/*
+ * Adaptive CPU/GPU batch routing.
+ *
+ * The router targets a GPU batch share of
+ *
+ *   share = cpu_time / (cpu_time + gpu_time)
+ *
+ * per byte, which equalizes the finishing times of the two sides when
+ * both process their shares concurrently. The share is realized with an
+ * error accumulator (Bresenham-style), so e.g. share 0.75 routes three of
+ * every four batches to the GPU with no randomness. Until both sides have
+ * produced enough samples, batches alternate 50/50 to gather timings.
+ */
+#define ROUTER_EWMA_ALPHA   0.2
+#define ROUTER_MIN_SAMPLES  4
+
+void
+gpu_router_init(GpuBatchRouter *router)
+{
+	memset(router, 0, sizeof(GpuBatchRouter));
+}
+
+bool
+gpu_router_choose_gpu(GpuBatchRouter *router, const GpuMultiPipeline *pipeline)
+{
+	double share;
+
+	if (!gpu_bridge_enabled)
+		return false;
+
+	/* Never stall the scan behind the GPU; keep the CPU side busy */
+	if (gpu_multi_pipeline_full(pipeline))
+		return false;
+
+	if (router->gpu_samples < ROUTER_MIN_SAMPLES ||
+		router->cpu_samples < ROUTER_MIN_SAMPLES ||
+		router->gpu_us_per_byte + router->cpu_us_per_byte <= 0.0)
+		share = 0.5;
+	else
+		share = router->cpu_us_per_byte /
+				(router->cpu_us_per_byte + router->gpu_us_per_byte);
+
+	router->gpu_share_accum += share;
+	if (router->gpu_share_accum >= 1.0)
+	{
+		router->gpu_share_accum -= 1.0;
+		return true;
+	}
+	return false;
+}
+
+void
+gpu_router_report(GpuBatchRouter *router, bool on_gpu, size_t batch_bytes,
+				  double elapsed_us)
+{
+	double us_per_byte;
+
+	if (batch_bytes == 0 || elapsed_us <= 0.0)
+		return;
+
+	us_per_byte = elapsed_us / (double) batch_bytes;
+
+	if (on_gpu)
+	{
+		if (router->gpu_samples == 0)
+			router->gpu_us_per_byte = us_per_byte;
+		else
+			router->gpu_us_per_byte +=
+				ROUTER_EWMA_ALPHA * (us_per_byte - router->gpu_us_per_byte);
+		router->gpu_samples++;
+	}
+	else
+	{
+		if (router->cpu_samples == 0)
+			router->cpu_us_per_byte = us_per_byte;
+		else
+			router->cpu_us_per_byte +=
+				ROUTER_EWMA_ALPHA * (us_per_byte - router->cpu_us_per_byte);
+		router->cpu_samples++;
+	}
+}
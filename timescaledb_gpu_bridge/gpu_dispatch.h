@@ -20,6 +20,14 @@ extern bool gpu_check_eligibility(List *agg_exprs);
  */
 extern bool gpu_expr_is_eligible(Expr *expr);
 
+/*
+ * Check whether the device can decompress a compression algorithm
+ * (KDS_COMPRESSION_* tag) on the GPU. When true, the column should be
+ * shipped as its compressed payload instead of being decompressed on the
+ * host, cutting PCIe traffic by the compression ratio.
+ */
+extern bool gpu_device_decompress_supported(int algorithm);
+
 /*
  * Submit a batch to the GPU via PG-Strom's XPU engine.
  * On failure, returns false and the caller should fall back to CPU.
@@ -31,3 +39,109 @@ extern bool gpu_expr_is_eligible(Expr *expr);
  */
 extern bool gpu_dispatch_batch(void *kds_buffer, size_t kds_len,
 							   void *result, size_t *result_len);
+
+/*
+ * Like gpu_dispatch_batch, but executes against a device-resident buffer
+ * handle from the batch cache (gpu_cache_lookup/insert), skipping the
+ * host-to-device transfer.
+ */
+extern bool gpu_dispatch_cached(void *devptr, size_t kds_len,
+								void *result, size_t *result_len);
+
+/*
+ * Number of batches that can be in flight at once. Double buffering is
+ * enough to overlap batch N+1's host-to-device transfer with batch N's
+ * execution; the staging buffers of retired batches are handed back for
+ * reuse so the caller can maintain a fixed ring of KDS buffers.
+ */
+#define GPU_PIPELINE_DEPTH 2
+
+typedef struct GpuBatchPipeline GpuBatchPipeline;
+
+/*
+ * A retired pipeline batch. The kds_buffer is no longer referenced by the
+ * GPU and may be reused for the next submission. If success is false, the
+ * result buffer is not valid and the batch should be executed on CPU.
+ */
+typedef struct GpuPipelineResult
+{
+	void   *kds_buffer;
+	void   *result;
+	size_t *result_len;
+	bool    success;
+} GpuPipelineResult;
+
+/*
+ * Pipelined batch dispatch. Submissions overlap transfer and execution
+ * when PG-Strom exposes asynchronous commands, and degrade to immediate
+ * synchronous execution otherwise (results are then simply held until
+ * drained, keeping the caller loop identical in both modes).
+ *
+ * Usage:
+ *   if (gpu_pipeline_full(p))
+ *       gpu_pipeline_drain(p, &res);        // consume res, recycle buffer
+ *   if (!gpu_pipeline_submit(p, kds, len, result, result_len))
+ *       ...run this batch on CPU...
+ *   ...
+ *   while (gpu_pipeline_drain(p, &res))     // after the last submission
+ *       ...consume res...
+ */
+extern GpuBatchPipeline *gpu_pipeline_create(void);
+extern GpuBatchPipeline *gpu_pipeline_create_for_device(int device);
+extern bool gpu_pipeline_full(const GpuBatchPipeline *pipeline);
+extern bool gpu_pipeline_submit(GpuBatchPipeline *pipeline, void *kds_buffer,
+								size_t kds_len, void *result, size_t *result_len);
+extern bool gpu_pipeline_drain(GpuBatchPipeline *pipeline, GpuPipelineResult *retired);
+extern void gpu_pipeline_destroy(GpuBatchPipeline *pipeline);
+
+/*
+ * Multi-GPU dispatch: one pipeline per device, with batch-granular
+ * partitioning of a query's work across devices. Submissions go to the
+ * device with the best topology affinity when PG-Strom reports one, and
+ * round-robin across non-full device queues otherwise. Each retired batch
+ * carries its own partial aggregate result, which the caller merges the
+ * same way regardless of which device produced it, so no separate
+ * per-device combine step is needed.
+ *
+ * Degrades to a single queue when PG-Strom lacks device-targeted
+ * submission or reports a single device; the submit/drain contract is
+ * identical to the single pipeline.
+ */
+typedef struct GpuMultiPipeline GpuMultiPipeline;
+
+extern int gpu_device_count(void);
+extern GpuMultiPipeline *gpu_multi_pipeline_create(void);
+extern bool gpu_multi_pipeline_full(const GpuMultiPipeline *pipeline);
+extern bool gpu_multi_pipeline_submit(GpuMultiPipeline *pipeline, void *kds_buffer,
+									  size_t kds_len, void *result, size_t *result_len);
+extern bool gpu_multi_pipeline_drain(GpuMultiPipeline *pipeline, GpuPipelineResult *retired);
+extern void gpu_multi_pipeline_destroy(GpuMultiPipeline *pipeline);
+
+/*
+ * Adaptive CPU/GPU batch router for hybrid execution within one scan.
+ *
+ * Instead of sending a qualifying scan entirely to the GPU, the router
+ * splits its batches between the GPU pipeline and the CPU aggregation
+ * kernels so both sides stay busy: batches enqueued on the GPU execute
+ * while the backend aggregates other batches on the CPU. The split ratio
+ * adapts to observed per-batch completion times reported from each side,
+ * giving the GPU a share of batches proportional to its measured speed
+ * advantage; a full GPU queue always routes to the CPU rather than
+ * stalling the scan.
+ *
+ * The struct is small and per-scan; embed it in the scan state and
+ * initialize with gpu_router_init().
+ */
+typedef struct GpuBatchRouter
+{
+	double  gpu_us_per_byte;   /* EWMA of measured GPU batch times */
+	double  cpu_us_per_byte;   /* EWMA of measured CPU batch times */
+	double  gpu_share_accum;   /* error accumulator for the split ratio */
+	uint64  gpu_samples;
+	uint64  cpu_samples;
+} GpuBatchRouter;
+
+extern void gpu_router_init(GpuBatchRouter *router);
+extern bool gpu_router_choose_gpu(GpuBatchRouter *router, const GpuMultiPipeline *pipeline);
+extern void gpu_router_report(GpuBatchRouter *router, bool on_gpu, size_t batch_bytes,
+							  double elapsed_us);
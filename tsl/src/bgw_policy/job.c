@@ -49,8 +49,6 @@
 #include "telemetry/telemetry.h"
 #endif
 
-#include "tsl/src/chunk.h"
-
 #include "chunk.h"
 #include "config.h"
 #include "dimension.h"
@@ -59,10 +57,14 @@
 #include "job.h"
 #include "jsonb_utils.h"
 #include "reorder.h"
+#include "time_utils.h"
 #include "utils.h"
 
 #define REORDER_SKIP_RECENT_DIM_SLICES_N 3
 
+/* Number of chunks the retention policy drops per transaction */
+#define RETENTION_MAX_CHUNKS_PER_BATCH 10
+
 static void
 log_retention_boundary(int elevel, PolicyRetentionData *policy_data, const char *message)
 {
@@ -298,6 +300,7 @@ policy_retention_execute(int32 job_id, Jsonb *config)
 {
 	PolicyRetentionData policy_data;
 	bool verbose_log;
+	int batch_dropped;
 
 	policy_retention_read_and_validate_config(config, &policy_data);
 
@@ -305,10 +308,44 @@ policy_retention_execute(int32 job_id, Jsonb *config)
 	if (verbose_log)
 		log_retention_boundary(LOG, &policy_data, "applying retention policy to hypertable");
 
-	chunk_invoke_drop_chunks(policy_data.object_relid,
-							 policy_data.boundary,
-							 policy_data.boundary_type,
-							 policy_data.use_creation_time);
+	if (ActiveSnapshotSet())
+		PopActiveSnapshot();
+
+	/* Drop the eligible chunks in small batches, committing between batches,
+	 * instead of dropping them all in a single transaction. Each chunk drop
+	 * takes an access exclusive lock on the chunk and on the tables the
+	 * hypertable references via foreign keys, so dropping a large backlog in
+	 * one transaction holds those locks for the whole run and can stall
+	 * concurrent inserts and queries. Committing between batches keeps the
+	 * lock hold times short and bounded by the batch size.
+	 *
+	 * Frozen and tiered chunks are skipped by the drop, so a batch can come
+	 * back short while eligible chunks remain; we loop until a batch drops
+	 * nothing at all. */
+	do
+	{
+		Cache *hcache;
+		Hypertable *ht;
+		List *dropped_names;
+
+		CommitTransactionCommand();
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		hcache = ts_hypertable_cache_pin();
+		ht = ts_resolve_hypertable_from_table_or_cagg(hcache, policy_data.object_relid, false);
+		dropped_names = ts_chunk_do_drop_chunks(ht,
+												policy_data.boundary_internal,
+												PG_INT64_MIN,
+												DEBUG2,
+												policy_data.time_type,
+												policy_data.boundary_type,
+												policy_data.older_newer,
+												RETENTION_MAX_CHUNKS_PER_BATCH);
+		batch_dropped = list_length(dropped_names);
+		ts_cache_release(&hcache);
+		PopActiveSnapshot();
+	} while (batch_dropped > 0);
 
 	return true;
 }
@@ -375,15 +412,43 @@ policy_retention_read_and_validate_config(Jsonb *config, PolicyRetentionData *po
 											 false);
 	}
 
-	ts_cache_release(&hcache);
-
 	if (policy_data)
 	{
+		Oid time_type = ts_dimension_get_partition_type(open_dim);
+
+		/* drop_chunks compares UUID (v7) partitioned hypertables against a
+		 * TIMESTAMPTZ boundary */
+		if (IS_UUID_TYPE(time_type))
+			time_type = TIMESTAMPTZOID;
+
 		policy_data->object_relid = object_relid;
 		policy_data->boundary = boundary;
 		policy_data->boundary_type = boundary_type;
 		policy_data->use_creation_time = use_creation_time;
+		policy_data->time_type = time_type;
+
+		if (use_creation_time)
+		{
+			/* The boundary is an interval relative to now() that selects
+			 * chunks by creation time, mirroring the "created_before"
+			 * argument of drop_chunks. */
+			policy_data->boundary_internal =
+				ts_internal_to_time_int64(ts_time_value_from_arg(boundary,
+																 INTERVALOID,
+																 TIMESTAMPTZOID,
+																 false),
+										  TIMESTAMPTZOID);
+			policy_data->older_newer = false;
+		}
+		else
+		{
+			policy_data->boundary_internal =
+				ts_time_value_from_arg(boundary, boundary_type, time_type, true);
+			policy_data->older_newer = true;
+		}
 	}
+
+	ts_cache_release(&hcache);
 }
 
 bool
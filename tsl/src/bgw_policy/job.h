@@ -36,6 +36,13 @@ typedef struct PolicyRetentionData
 	Datum boundary;
 	Oid boundary_type;
 	bool use_creation_time;
+	/* The boundary converted to the internal time format, plus the dimension
+	 * type information needed to invoke the chunk drop directly. Precomputed
+	 * during config validation since the execute path drops chunks across
+	 * several transactions and cannot rely on transaction-local memory. */
+	int64 boundary_internal;
+	Oid time_type;
+	bool older_newer;
 } PolicyRetentionData;
 
 typedef struct PolicyContinuousAggData
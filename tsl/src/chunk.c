@@ -19,6 +19,7 @@
 #include <nodes/lockoptions.h>
 #include <nodes/makefuncs.h>
 #include <nodes/nodes.h>
+#include <nodes/parsenodes.h>
 #include <nodes/value.h>
 #include <parser/parse_coerce.h>
 #include <parser/parse_func.h>
@@ -38,6 +39,63 @@
 #include "hypertable.h"
 #include "utils.h"
 
+/*
+ * Relation options applied to a chunk's tables when the chunk is frozen.
+ *
+ * A frozen chunk no longer receives writes, so the next (auto)vacuum might as
+ * well freeze all remaining heap tuples right away instead of waiting for
+ * them to pass the default freeze ages. Once every page is marked all-visible
+ * and all-frozen in the visibility map, sequential scans no longer perform
+ * per-tuple visibility checks on the chunk and future vacuums (including
+ * anti-wraparound ones) skip it entirely, which is the desired steady state
+ * for cold data. The insert threshold options make autovacuum pick the chunk
+ * up promptly rather than waiting for the default scale factor to trigger on
+ * a chunk that will never see another insert.
+ */
+static const char *chunk_frozen_reloptions[][2] = {
+	{ "autovacuum_freeze_min_age", "0" },
+	{ "autovacuum_freeze_table_age", "0" },
+	{ "autovacuum_vacuum_insert_threshold", "1" },
+	{ "autovacuum_vacuum_insert_scale_factor", "0" },
+};
+
+/*
+ * Set (or reset) the frozen-chunk relation options on the chunk's table and,
+ * if the chunk is compressed, on the internal compressed chunk's table as
+ * well. The compressed table matters too: batches written by segmentwise
+ * recompression are inserted unfrozen into an existing relation, unlike the
+ * initial compression which writes the new relation with HEAP_INSERT_FROZEN.
+ */
+static void
+chunk_update_frozen_reloptions(const Chunk *chunk, bool set)
+{
+	AlterTableCmd *cmd = makeNode(AlterTableCmd);
+	List *options = NIL;
+
+	for (size_t i = 0; i < lengthof(chunk_frozen_reloptions); i++)
+	{
+		Node *value = set ? (Node *) makeString(pstrdup(chunk_frozen_reloptions[i][1])) : NULL;
+
+		options = lappend(options, makeDefElem(pstrdup(chunk_frozen_reloptions[i][0]), value, -1));
+	}
+
+	cmd->subtype = set ? AT_SetRelOptions : AT_ResetRelOptions;
+	cmd->def = (Node *) options;
+
+	ts_alter_table_with_event_trigger(chunk->table_id, NULL, list_make1(cmd), false);
+
+	if (chunk->fd.compressed_chunk_id != INVALID_CHUNK_ID)
+	{
+		const Chunk *compressed_chunk = ts_chunk_get_by_id(chunk->fd.compressed_chunk_id, false);
+
+		if (compressed_chunk != NULL)
+			ts_alter_table_with_event_trigger(compressed_chunk->table_id,
+											  NULL,
+											  list_make1(cmd),
+											  false);
+	}
+}
+
 /* Data in a frozen chunk cannot be modified. So any operation
  * that rewrites data for a frozen chunk will be blocked.
  * Note that a frozen chunk can still be dropped.
@@ -65,6 +123,15 @@ chunk_freeze_chunk(PG_FUNCTION_ARGS)
 	DEBUG_WAITPOINT("freeze_chunk_before_lock");
 	LockRelationOid(chunk_relid, ShareLock);
 	bool ret = ts_chunk_set_frozen(chunk);
+
+	/*
+	 * Encourage autovacuum to immediately freeze the chunk's heap pages and
+	 * mark them all-visible so that scans can skip visibility checks on data
+	 * that will no longer change.
+	 */
+	if (ret)
+		chunk_update_frozen_reloptions(chunk, true);
+
 	PG_RETURN_BOOL(ret);
 }
 
@@ -88,96 +155,11 @@ chunk_unfreeze_chunk(PG_FUNCTION_ARGS)
 	 * This changes the status in the catalog to allow previously blocked operations.
 	 */
 	bool ret = ts_chunk_unset_frozen(chunk);
-	PG_RETURN_BOOL(ret);
-}
-
-/*
- * Invoke drop_chunks via fmgr so that the call can be deparsed and sent to
- * remote data nodes.
- *
- * Given that drop_chunks is an SRF, and has pseudo parameter types, we need
- * to provide a FuncExpr with type information for the deparser.
- *
- * Returns the number of dropped chunks.
- */
-int
-chunk_invoke_drop_chunks(Oid relid, Datum older_than, Datum older_than_type, bool use_creation_time)
-{
-	EState *estate;
-	ExprContext *econtext;
-	FuncExpr *fexpr;
-	List *args = NIL;
-	int num_results = 0;
-	SetExprState *state;
-	Oid restype;
-	Oid func_oid;
-	Const *TypeNullCons = makeNullConst(older_than_type, -1, InvalidOid);
-	Const *IntervalVal = makeConst(older_than_type,
-								   -1,
-								   InvalidOid,
-								   get_typlen(older_than_type),
-								   older_than,
-								   false,
-								   get_typbyval(older_than_type));
-	Const *argarr[DROP_CHUNKS_NARGS] = { makeConst(REGCLASSOID,
-												   -1,
-												   InvalidOid,
-												   sizeof(relid),
-												   ObjectIdGetDatum(relid),
-												   false,
-												   false),
-										 TypeNullCons,
-										 TypeNullCons,
-										 castNode(Const, makeBoolConst(false, true)),
-										 TypeNullCons,
-										 TypeNullCons };
-	Oid type_id[DROP_CHUNKS_NARGS] = { REGCLASSOID, ANYOID, ANYOID, BOOLOID, ANYOID, ANYOID };
-	char *const schema_name = ts_extension_schema_name();
-	List *const fqn = list_make2(makeString(schema_name), makeString(DROP_CHUNKS_FUNCNAME));
-
-	StaticAssertStmt(lengthof(type_id) == lengthof(argarr),
-					 "argarr and type_id should have matching lengths");
-
-	func_oid = LookupFuncName(fqn, lengthof(type_id), type_id, false);
-	Assert(func_oid); /* LookupFuncName should not return an invalid OID */
-
-	/* decide whether to use "older_than" or "drop_created_before" */
-	if (use_creation_time)
-		argarr[4] = IntervalVal;
-	else
-		argarr[1] = IntervalVal;
 
-	/* Prepare the function expr with argument list */
-	get_func_result_type(func_oid, &restype, NULL);
+	/* Restore the default vacuum behavior now that the chunk can receive
+	 * writes again */
+	if (ret)
+		chunk_update_frozen_reloptions(chunk, false);
 
-	for (size_t i = 0; i < lengthof(argarr); i++)
-		args = lappend(args, argarr[i]);
-
-	fexpr = makeFuncExpr(func_oid, restype, args, InvalidOid, InvalidOid, COERCE_EXPLICIT_CALL);
-	fexpr->funcretset = true;
-
-	/* Execute the SRF */
-	estate = CreateExecutorState();
-	econtext = CreateExprContext(estate);
-	state = ExecInitFunctionResultSet(&fexpr->xpr, econtext, NULL);
-
-	while (true)
-	{
-		ExprDoneCond isdone;
-		bool isnull;
-
-		ExecMakeFunctionResultSet(state, econtext, estate->es_query_cxt, &isnull, &isdone);
-
-		if (isdone == ExprEndResult)
-			break;
-
-		if (!isnull)
-			num_results++;
-	}
-
-	/* Cleanup */
-	FreeExprContext(econtext, false);
-	FreeExecutorState(estate);
-
-	return num_results;
+	PG_RETURN_BOOL(ret);
 }
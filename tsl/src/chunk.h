@@ -11,8 +11,6 @@
 
 extern Datum chunk_freeze_chunk(PG_FUNCTION_ARGS);
 extern Datum chunk_unfreeze_chunk(PG_FUNCTION_ARGS);
-extern int chunk_invoke_drop_chunks(Oid relid, Datum older_than, Datum older_than_type,
-									bool use_creation_time);
 extern Datum chunk_merge_chunks(PG_FUNCTION_ARGS);
 extern Datum chunk_split_chunk(PG_FUNCTION_ARGS);
 extern void update_relstats(Relation catrel, Oid relid, BlockNumber num_pages, double ntuples);
@@ -42,6 +42,7 @@
 #include "ts_catalog/catalog.h"
 #include "ts_catalog/chunk_rewrite.h"
 #include "ts_catalog/compression_chunk_size.h"
+#include "ts_catalog/compression_settings.h"
 
 typedef struct RelationMergeInfo
 {
@@ -985,6 +986,7 @@ chunk_merge_chunks(PG_FUNCTION_ARGS)
 	int32 hypertable_id = INVALID_HYPERTABLE_ID;
 	Hypercube *merged_cube = NULL;
 	const Hypercube *prev_cube = NULL;
+	const CompressionSettings *merged_settings = NULL;
 	int mergeindex = -1;
 	MemoryContext merge_cxt = NULL;
 	List *rellocks = NIL;
@@ -1188,6 +1190,28 @@ chunk_merge_chunks(PG_FUNCTION_ARGS)
 			rellocks = append_rellock(rellocks, crel, lockmode, merge_cxt);
 			table_close(crel, NoLock);
 
+			/*
+			 * The merge concatenates the compressed batches of the merged
+			 * chunks without recompressing them, so all compressed chunks
+			 * must have the same compression settings. Chunks compressed
+			 * with different segmentby or orderby settings have different
+			 * columns in their internal compressed relations and their
+			 * batches cannot be mixed.
+			 */
+			const CompressionSettings *csettings = ts_compression_settings_get(relid);
+
+			if (merged_settings == NULL)
+				merged_settings = csettings;
+			else if (csettings == NULL ||
+					 !ts_compression_settings_equal(merged_settings, csettings))
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("cannot merge chunks with different compression settings"),
+						 errdetail("Chunk \"%s\" is compressed with different settings than "
+								   "the other chunks in the merge.",
+								   NameStr(chunk->fd.table_name)),
+						 errhint("Decompress the chunks before merging them.")));
+
 			if (mergeindex == -1)
 				mergeindex = i;
 
@@ -472,6 +472,68 @@ route_next_compressed_tuple(TupleTableSlot *slot, SplitContext *scontext, int *r
 	return ExecFetchSlotHeapTuple(slot, false, NULL);
 }
 
+/*
+ * Check whether the compressed relation is left unchanged by the split.
+ *
+ * Each compressed batch is routed on its min/max metadata, so a single scan
+ * of the batch tuples (without decompressing them) can tell whether any batch
+ * straddles the split point or belongs to the new partition. If all batches
+ * sort into the partition kept by the original chunk, the compressed relation
+ * needs no rewrite at all and the new compressed chunk stays empty.
+ *
+ * The scan uses SnapshotAny like the rewrite does, since batches that are
+ * deleted but still visible to concurrent transactions would have to be
+ * transferred by a rewrite. Fully dead batches are vacuumed by the rewrite,
+ * so they cannot prevent the metadata-only path; skipping the rewrite just
+ * leaves them for a later vacuum.
+ *
+ * The number of tuples in the kept segments is returned in
+ * tuples_in_segments, since it is needed for the stats update after the
+ * split and there will be no rewrite to count them.
+ */
+static bool
+compressed_rel_unchanged_by_split(Relation crel, CompressedSplitPoint *csp,
+								  TransactionId oldest_xmin, int64 *tuples_in_segments)
+{
+	TupleTableSlot *slot = table_slot_create(crel, NULL);
+	TableScanDesc scan = table_beginscan(crel, SnapshotAny, 0, NULL);
+	int64 num_tuples = 0;
+	bool unchanged = true;
+
+	while (table_scan_getnextslot(scan, ForwardScanDirection, slot))
+	{
+		BufferHeapTupleTableSlot *hslot = (BufferHeapTupleTableSlot *) slot;
+		HeapTuple tuple = ExecFetchSlotHeapTuple(slot, false, NULL);
+		bool isdead;
+		bool isnull;
+
+		CHECK_FOR_INTERRUPTS();
+
+		LockBuffer(hslot->buffer, BUFFER_LOCK_SHARE);
+		isdead = HeapTupleSatisfiesVacuum(tuple, oldest_xmin, hslot->buffer) == HEAPTUPLE_DEAD;
+		LockBuffer(hslot->buffer, BUFFER_LOCK_UNLOCK);
+
+		if (isdead)
+			continue;
+
+		if (route_compressed_tuple(slot, &csp->base) != 0)
+		{
+			unchanged = false;
+			break;
+		}
+
+		Datum count = slot_getattr(slot, csp->attnum_count, &isnull);
+		num_tuples += DatumGetInt32(count);
+	}
+
+	table_endscan(scan);
+	ExecDropSingleTupleTableSlot(slot);
+
+	*tuples_in_segments = num_tuples;
+
+	return unchanged;
+}
+
 static double
 copy_tuples_for_split(SplitContext *scontext)
 {
@@ -1189,7 +1251,31 @@ chunk_split_chunk(PG_FUNCTION_ARGS)
 		Relation compressed_rel =
 			table_open(compress_settings->fd.compress_relid, AccessExclusiveLock);
 		compressed_split_relations = csplit_relations;
-		split_relation(compressed_rel, &csp.base, SPLIT_FACTOR, compressed_split_relations);
+
+		struct VacuumCutoffs ccutoffs;
+		int64 tuples_in_segments = 0;
+
+		compute_rel_vacuum_cutoffs(compressed_rel, &ccutoffs);
+
+		if (compressed_rel_unchanged_by_split(compressed_rel,
+											  &csp,
+											  ccutoffs.OldestXmin,
+											  &tuples_in_segments))
+		{
+			/*
+			 * No compressed batch straddles the split point and all batches
+			 * belong to the partition kept by the original chunk, so the
+			 * compressed relation can be left as it is instead of being
+			 * rewritten. The new compressed chunk stays empty.
+			 */
+			elog(DEBUG1,
+				 "split of \"%s\" leaves the compressed relation intact",
+				 get_rel_name(relid));
+			csplit_relations[0].stats.tuples_in_segments = tuples_in_segments;
+			table_close(compressed_rel, NoLock);
+		}
+		else
+			split_relation(compressed_rel, &csp.base, SPLIT_FACTOR, compressed_split_relations);
 	}
 
 	/* Now split the non-compressed relation */
@@ -343,6 +343,48 @@ add_partially_aggregated_subpaths(PlannerInfo *root, PathTarget *input_target,
 	}
 }
 
+/*
+ * Add a parallel Append path that distributes the per-chunk partial
+ * aggregation paths across the workers. Each subpath aggregates a whole chunk,
+ * so it is executed by a single worker. This makes the aggregation parallel
+ * even when the underlying chunk scans are not parallel-aware, which is
+ * typical for the compressed chunks. Each worker keeps its own partial
+ * aggregation states, and the duplicate partial results are combined by the
+ * finalize aggregation node above the Gather.
+ */
+static void
+add_parallel_append_agg_path(PlannerInfo *root, RelOptInfo *partially_grouped_rel, List *subpaths,
+							 PathTarget *partial_grouping_target)
+{
+	if (!partially_grouped_rel->consider_parallel)
+		return;
+
+	ListCell *lc;
+	foreach (lc, subpaths)
+	{
+		Path *subpath = lfirst(lc);
+		if (!subpath->parallel_safe)
+			return;
+	}
+
+	const int parallel_workers = Min(list_length(subpaths), max_parallel_workers_per_gather);
+	if (parallel_workers == 0)
+		return;
+
+	AppendPath *parallel_append = create_append_path(root,
+													 partially_grouped_rel,
+													 subpaths,
+													 /* partial_subpaths = */ NIL,
+													 /* pathkeys = */ NIL,
+													 /* required_outer = */ NULL,
+													 parallel_workers,
+													 /* parallel_aware = */ true,
+													 /* rows = */ -1);
+	parallel_append->path.pathtarget = copy_pathtarget(partial_grouping_target);
+
+	add_partial_path(partially_grouped_rel, &parallel_append->path);
+}
+
 /*
  * Generate a total aggregation path for partial aggregations.
  *
@@ -351,7 +393,9 @@ add_partially_aggregated_subpaths(PlannerInfo *root, PathTarget *input_target,
  * AGGSPLIT_FINAL_DESERIAL step.
  *
  * The original path can be either parallel or non-parallel aggregation, and the
- * resulting path will be parallel accordingly.
+ * resulting path will be parallel accordingly. For a non-parallel original
+ * path, we additionally consider a parallel Append that distributes the
+ * per-chunk partial aggregations across the workers.
  */
 static void
 generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptInfo *input_rel,
@@ -482,6 +526,29 @@ generate_agg_pushdown_path(PlannerInfo *root, Path *cheapest_total_path, RelOptI
 										   hashed_subpaths,
 										   partial_grouping_target));
 		}
+
+		/*
+		 * The per-chunk partial aggregations are independent, so they can also
+		 * be distributed across parallel workers even when the original plan
+		 * was not parallel. The plain parallel Append doesn't preserve the
+		 * ordering of the sorted subpaths, but the finalization code adds the
+		 * required Sort above it.
+		 */
+		if (sorted_subpaths != NIL)
+		{
+			add_parallel_append_agg_path(root,
+										 partially_grouped_rel,
+										 sorted_subpaths,
+										 partial_grouping_target);
+		}
+
+		if (hashed_subpaths != NIL)
+		{
+			add_parallel_append_agg_path(root,
+										 partially_grouped_rel,
+										 hashed_subpaths,
+										 partial_grouping_target);
+		}
 	}
 	else
 	{
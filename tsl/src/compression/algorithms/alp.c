@@ -0,0 +1,879 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#include <postgres.h>
+#include <catalog/pg_type.h>
+#include <funcapi.h>
+#include <lib/stringinfo.h>
+#include <libpq/pqformat.h>
+#include <math.h>
+#include <utils/builtins.h>
+#include <utils/memutils.h>
+
+#include "alp.h"
+
+#include "compression/arrow_c_data_interface.h"
+#include "compression/compression.h"
+#include "float_utils.h"
+#include "simd_support.h"
+#include "simple8b_rle.h"
+#include "simple8b_rle_bitmap.h"
+
+#define ELEMENT_TYPE uint64
+#include "simple8b_rle_decompress_all.h"
+#undef ELEMENT_TYPE
+
+/*
+ * Alp compressed data is stored as
+ *     uint16 compression_algorithm: id number for the compression scheme
+ *     uint8 has_nulls: 1 if we store a NULLs bitmap after the data, otherwise 0
+ *     uint8 exponent: the decimal exponent e, so value ~= digits / 10^e
+ *     uint8 element_width: 4 for float4, 8 for float8, for sanity checks
+ *     uint32 num_exceptions: number of verbatim values at the end
+ *     simple8b_rle digits: zigzag-encoded scaled integers, 0 for exceptions
+ *     simple8b_rle exception positions: 1 if the value is stored verbatim
+ *     simple8b_rle nulls: 1 if the value is NULL, else 0
+ *     uint64 exceptions[]: the verbatim bit patterns of the exception values
+ */
+
+typedef struct AlpCompressed
+{
+	CompressedDataHeaderFields;
+	uint8 has_nulls;
+	uint8 exponent;
+	uint8 element_width;
+	uint32 num_exceptions;
+	uint32 padding;
+	char data[FLEXIBLE_ARRAY_MEMBER];
+} AlpCompressed;
+
+static void
+pg_attribute_unused() assertions(void)
+{
+	AlpCompressed test_val = { .vl_len_ = { 0 } };
+	/* make sure no padding bytes make it to disk */
+	StaticAssertStmt(sizeof(AlpCompressed) ==
+						 sizeof(test_val.vl_len_) + sizeof(test_val.compression_algorithm) +
+							 sizeof(test_val.has_nulls) + sizeof(test_val.exponent) +
+							 sizeof(test_val.element_width) + sizeof(test_val.num_exceptions) +
+							 sizeof(test_val.padding),
+					 "Alp wrong size");
+	StaticAssertStmt(sizeof(AlpCompressed) == 16, "Alp wrong size");
+}
+
+/*
+ * The powers of ten we try as scales. 10^15 is the last power of ten where
+ * the full range of decimal digits is still exactly representable in a
+ * double, so higher exponents cannot win anything.
+ */
+static const double alp_pow10[] = {
+	1.,	  1e1,	1e2,  1e3,	1e4,  1e5,	1e6,  1e7,
+	1e8,  1e9,	1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+#define ALP_MAX_EXPONENT ((int) (sizeof(alp_pow10) / sizeof(*alp_pow10) - 1))
+
+/*
+ * The scaled value must stay well within the exactly-representable integer
+ * range of a double, otherwise the round-trip check itself becomes inexact.
+ */
+#define ALP_MAX_SCALED 9.0e15
+
+typedef struct AlpCompressor
+{
+	/* Buffered not-null values. ALP chooses the exponent per batch, so unlike
+	 * the other compressors we can only encode on finish. */
+	double *values;
+	uint32 num_values;
+	uint32 capacity;
+
+	Simple8bRleCompressor nulls;
+	bool has_nulls;
+	bool is_float4;
+} AlpCompressor;
+
+typedef struct ExtendedCompressor
+{
+	Compressor base;
+	AlpCompressor *internal;
+	Oid element_type;
+} ExtendedCompressor;
+
+typedef struct AlpDecompressionIterator
+{
+	DecompressionIterator base;
+
+	/* Still zigzag-encoded, decoded on access. */
+	const uint64 *digits;
+	uint32 num_notnull;
+
+	/* Prefix sums of the exception positions bitmap. */
+	Simple8bRleBitmap exceptions;
+	const uint64 *exception_values;
+
+	/* num_elements == 0 when there are no nulls. */
+	Simple8bRleBitmap nulls;
+
+	double scale;
+	int32 total;
+	int32 position;
+	int32 notnull_position;
+} AlpDecompressionIterator;
+
+/*
+ * Local helpers
+ */
+static void alp_compressor_append_float(Compressor *compressor, Datum val);
+static void alp_compressor_append_double(Compressor *compressor, Datum val);
+static void alp_compressor_append_null_value(Compressor *compressor);
+static void *alp_compressor_finish_and_reset(Compressor *compressor);
+
+static const Compressor alp_float_compressor_initializer = {
+	.append_val = alp_compressor_append_float,
+	.append_null = alp_compressor_append_null_value,
+	.is_full = NULL,
+	.finish = alp_compressor_finish_and_reset,
+};
+
+static const Compressor alp_double_compressor_initializer = {
+	.append_val = alp_compressor_append_double,
+	.append_null = alp_compressor_append_null_value,
+	.is_full = NULL,
+	.finish = alp_compressor_finish_and_reset,
+};
+
+static uint64
+alp_zig_zag_encode(int64 value)
+{
+	return ((uint64) value << 1) ^ (uint64) (value >> 63);
+}
+
+static int64
+alp_zig_zag_decode(uint64 value)
+{
+	return (int64) ((value >> 1) ^ (uint64) -(int64) (value & 1));
+}
+
+/*
+ * Try to encode one value as scaled decimal digits. Returns false if the
+ * value does not survive the exact round trip and has to be stored verbatim.
+ */
+static bool
+alp_encode_value(double value, bool is_float4, double scale, int64 *digits_out)
+{
+	const double candidate = value * scale;
+
+	/* This also rejects NaN and the infinities. */
+	if (!(candidate >= -ALP_MAX_SCALED && candidate <= ALP_MAX_SCALED))
+		return false;
+
+	const int64 digits = (int64) rint(candidate);
+	const double decoded = (double) digits / scale;
+
+	if (is_float4)
+	{
+		/* Note that this makes -0 an exception, which is what we want. */
+		if (float_get_bits((float) decoded) != float_get_bits((float) value))
+			return false;
+	}
+	else
+	{
+		if (double_get_bits(decoded) != double_get_bits(value))
+			return false;
+	}
+
+	*digits_out = digits;
+	return true;
+}
+
+/*
+ * Choose the decimal exponent for the batch by sampling. Prefer the higher
+ * exponent on ties, because more decimal places means fewer exceptions on the
+ * values we did not sample.
+ */
+static uint8
+alp_choose_exponent(const double *values, uint32 n, bool is_float4)
+{
+	const uint32 sample_step = Max(1, n / 128);
+
+	uint8 best_exponent = 0;
+	uint32 best_exceptions = PG_UINT32_MAX;
+
+	for (int e = 0; e <= ALP_MAX_EXPONENT; e++)
+	{
+		uint32 exceptions = 0;
+		uint32 sampled = 0;
+		for (uint32 i = 0; i < n; i += sample_step)
+		{
+			int64 digits;
+			if (!alp_encode_value(values[i], is_float4, alp_pow10[e], &digits))
+				exceptions++;
+			sampled++;
+		}
+
+		if (exceptions <= best_exceptions)
+		{
+			best_exceptions = exceptions;
+			best_exponent = e;
+		}
+
+		/* Can't do better than no exceptions at the highest scale. */
+		if (exceptions == 0 && e == ALP_MAX_EXPONENT)
+			break;
+	}
+
+	return best_exponent;
+}
+
+/*
+ * Compressor framework functions and definitions for the alp algorithm.
+ */
+
+extern AlpCompressor *
+alp_compressor_alloc(Oid element_type)
+{
+	AlpCompressor *compressor = palloc0(sizeof(*compressor));
+	compressor->is_float4 = element_type == FLOAT4OID;
+	compressor->capacity = 128;
+	compressor->values = palloc(sizeof(double) * compressor->capacity);
+	simple8brle_compressor_init(&compressor->nulls);
+	return compressor;
+}
+
+extern void
+alp_compressor_append_null(AlpCompressor *compressor)
+{
+	compressor->has_nulls = true;
+	simple8brle_compressor_append(&compressor->nulls, 1);
+}
+
+extern void
+alp_compressor_append_value(AlpCompressor *compressor, double next_val)
+{
+	if (compressor->num_values == compressor->capacity)
+	{
+		compressor->capacity *= 2;
+		compressor->values = repalloc(compressor->values, sizeof(double) * compressor->capacity);
+	}
+
+	compressor->values[compressor->num_values++] = next_val;
+	simple8brle_compressor_append(&compressor->nulls, 0);
+}
+
+static AlpCompressed *
+alp_compressed_from_parts(Simple8bRleSerialized *digits, Simple8bRleSerialized *exception_bitmap,
+						  Simple8bRleSerialized *nulls, const uint64 *exceptions,
+						  uint32 num_exceptions, uint8 exponent, uint8 element_width)
+{
+	const uint32 digits_size = simple8brle_serialized_total_size(digits);
+	const uint32 exception_bitmap_size = simple8brle_serialized_total_size(exception_bitmap);
+	const uint32 nulls_size = nulls != NULL ? simple8brle_serialized_total_size(nulls) : 0;
+
+	const Size compressed_size = sizeof(AlpCompressed) + digits_size + exception_bitmap_size +
+								 nulls_size + sizeof(uint64) * num_exceptions;
+
+	if (!AllocSizeIsValid(compressed_size))
+		ereport(ERROR,
+				(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+				 errmsg("compressed size exceeds the maximum allowed (%d)", (int) MaxAllocSize)));
+
+	char *compressed_data = palloc(compressed_size);
+	AlpCompressed *compressed = (AlpCompressed *) compressed_data;
+	SET_VARSIZE(&compressed->vl_len_, compressed_size);
+
+	compressed->compression_algorithm = COMPRESSION_ALGORITHM_ALP;
+	compressed->has_nulls = nulls != NULL ? 1 : 0;
+	compressed->exponent = exponent;
+	compressed->element_width = element_width;
+	compressed->num_exceptions = num_exceptions;
+	compressed->padding = 0;
+
+	compressed_data += sizeof(*compressed);
+	compressed_data = bytes_serialize_simple8b_and_advance(compressed_data, digits_size, digits);
+	compressed_data = bytes_serialize_simple8b_and_advance(compressed_data,
+														   exception_bitmap_size,
+														   exception_bitmap);
+	if (nulls != NULL)
+		compressed_data = bytes_serialize_simple8b_and_advance(compressed_data, nulls_size, nulls);
+
+	memcpy(compressed_data, exceptions, sizeof(uint64) * num_exceptions);
+
+	return compressed;
+}
+
+extern void *
+alp_compressor_finish(AlpCompressor *compressor)
+{
+	if (compressor == NULL)
+		return NULL;
+
+	const uint32 n = compressor->num_values;
+
+	/* When only nulls are present, we can return NULL */
+	if (n == 0)
+		return NULL;
+
+	const uint8 exponent = alp_choose_exponent(compressor->values, n, compressor->is_float4);
+	const double scale = alp_pow10[exponent];
+
+	Simple8bRleCompressor digits_compressor;
+	Simple8bRleCompressor exception_bitmap_compressor;
+	simple8brle_compressor_init(&digits_compressor);
+	simple8brle_compressor_init(&exception_bitmap_compressor);
+
+	uint64 *exceptions = palloc(sizeof(uint64) * n);
+	uint32 num_exceptions = 0;
+
+	for (uint32 i = 0; i < n; i++)
+	{
+		int64 digits;
+		if (alp_encode_value(compressor->values[i], compressor->is_float4, scale, &digits))
+		{
+			simple8brle_compressor_append(&digits_compressor, alp_zig_zag_encode(digits));
+			simple8brle_compressor_append(&exception_bitmap_compressor, 0);
+		}
+		else
+		{
+			/* A zero placeholder keeps the digit positions aligned. */
+			simple8brle_compressor_append(&digits_compressor, alp_zig_zag_encode(0));
+			simple8brle_compressor_append(&exception_bitmap_compressor, 1);
+
+			if (compressor->is_float4)
+				exceptions[num_exceptions++] =
+					(uint64) float_get_bits((float) compressor->values[i]);
+			else
+				exceptions[num_exceptions++] = double_get_bits(compressor->values[i]);
+		}
+	}
+
+	Simple8bRleSerialized *digits_serialized = simple8brle_compressor_finish(&digits_compressor);
+	Simple8bRleSerialized *exception_bitmap_serialized =
+		simple8brle_compressor_finish(&exception_bitmap_compressor);
+	Simple8bRleSerialized *nulls_serialized =
+		compressor->has_nulls ? simple8brle_compressor_finish(&compressor->nulls) : NULL;
+
+	AlpCompressed *compressed = alp_compressed_from_parts(digits_serialized,
+														  exception_bitmap_serialized,
+														  nulls_serialized,
+														  exceptions,
+														  num_exceptions,
+														  exponent,
+														  compressor->is_float4 ? 4 : 8);
+	Assert(compressed->compression_algorithm == COMPRESSION_ALGORITHM_ALP);
+	return compressed;
+}
+
+extern bool
+alp_compressed_has_nulls(const CompressedDataHeader *header)
+{
+	const AlpCompressed *ac = (const AlpCompressed *) header;
+	return ac->has_nulls;
+}
+
+/*
+ * Decompression.
+ */
+
+static void
+decompression_iterator_init(AlpDecompressionIterator *iter, void *compressed, Oid element_type,
+							bool forward)
+{
+	StringInfoData si = { .data = compressed, .len = VARSIZE(compressed) };
+	AlpCompressed *header = consumeCompressedData(&si, sizeof(AlpCompressed));
+
+	CheckCompressedData(header->has_nulls == 0 || header->has_nulls == 1);
+	CheckCompressedData(header->exponent <= ALP_MAX_EXPONENT);
+	CheckCompressedData(element_type == FLOAT8OID || element_type == FLOAT4OID);
+	CheckCompressedData(header->element_width == (element_type == FLOAT4OID ? 4 : 8));
+
+	Simple8bRleSerialized *digits_serialized = bytes_deserialize_simple8b_and_advance(&si);
+	Simple8bRleSerialized *exception_bitmap_serialized =
+		bytes_deserialize_simple8b_and_advance(&si);
+	Simple8bRleSerialized *nulls_serialized =
+		header->has_nulls ? bytes_deserialize_simple8b_and_advance(&si) : NULL;
+
+	*iter = (AlpDecompressionIterator){
+		.base = { .compression_algorithm = COMPRESSION_ALGORITHM_ALP,
+				  .forward = forward,
+				  .element_type = element_type,
+				  .try_next = (forward ? alp_decompression_iterator_try_next_forward :
+									     alp_decompression_iterator_try_next_reverse) },
+		.scale = alp_pow10[header->exponent],
+	};
+
+	uint32 num_notnull;
+	iter->digits = simple8brle_decompress_all_uint64(digits_serialized, &num_notnull);
+	iter->num_notnull = num_notnull;
+
+	iter->exceptions = simple8brle_bitmap_prefixsums(exception_bitmap_serialized);
+	CheckCompressedData(iter->exceptions.num_elements == num_notnull);
+	CheckCompressedData(simple8brle_bitmap_num_ones(&iter->exceptions) == header->num_exceptions);
+
+	const uint64 *exception_values = (const uint64 *) (si.data + si.cursor);
+	CheckCompressedData(si.cursor + sizeof(uint64) * (Size) header->num_exceptions <= (Size) si.len);
+	iter->exception_values = exception_values;
+
+	if (header->has_nulls)
+	{
+		iter->nulls = simple8brle_bitmap_decompress(nulls_serialized);
+		CheckCompressedData(iter->nulls.num_elements >= num_notnull);
+		iter->total = iter->nulls.num_elements;
+	}
+	else
+	{
+		iter->total = num_notnull;
+	}
+
+	if (forward)
+	{
+		iter->position = 0;
+		iter->notnull_position = 0;
+	}
+	else
+	{
+		iter->position = iter->total - 1;
+		iter->notnull_position = num_notnull - 1;
+	}
+}
+
+/*
+ * Decode the not-null value at the given position among the not-null values.
+ */
+static Datum
+alp_decode_notnull(AlpDecompressionIterator *iter, int32 i)
+{
+	const uint16 prefix_sum = simple8brle_bitmap_prefix_sum(&iter->exceptions, i);
+	const uint16 prev_prefix_sum = i > 0 ? simple8brle_bitmap_prefix_sum(&iter->exceptions, i - 1) : 0;
+
+	if (prefix_sum != prev_prefix_sum)
+	{
+		/* An exception, stored verbatim. */
+		const uint64 bits = iter->exception_values[prefix_sum - 1];
+		if (iter->base.element_type == FLOAT4OID)
+			return Float4GetDatum(bits_get_float((uint32) bits));
+		return Float8GetDatum(bits_get_double(bits));
+	}
+
+	const int64 digits = alp_zig_zag_decode(iter->digits[i]);
+	const double value = (double) digits / iter->scale;
+	if (iter->base.element_type == FLOAT4OID)
+		return Float4GetDatum((float) value);
+	return Float8GetDatum(value);
+}
+
+extern DecompressResult
+alp_decompression_iterator_try_next_forward(DecompressionIterator *iter_base)
+{
+	Assert(iter_base->compression_algorithm == COMPRESSION_ALGORITHM_ALP && iter_base->forward);
+	AlpDecompressionIterator *iter = (AlpDecompressionIterator *) iter_base;
+
+	if (iter->position >= iter->total)
+		return (DecompressResult){
+			.is_done = true,
+		};
+
+	if (iter->nulls.num_elements > 0 && simple8brle_bitmap_get_at(&iter->nulls, iter->position))
+	{
+		iter->position++;
+		return (DecompressResult){
+			.is_null = true,
+		};
+	}
+
+	CheckCompressedData(iter->notnull_position < (int32) iter->num_notnull);
+	Datum val = alp_decode_notnull(iter, iter->notnull_position);
+	iter->position++;
+	iter->notnull_position++;
+
+	return (DecompressResult){
+		.val = val,
+	};
+}
+
+extern DecompressResult
+alp_decompression_iterator_try_next_reverse(DecompressionIterator *iter_base)
+{
+	Assert(iter_base->compression_algorithm == COMPRESSION_ALGORITHM_ALP && !iter_base->forward);
+	AlpDecompressionIterator *iter = (AlpDecompressionIterator *) iter_base;
+
+	if (iter->position < 0)
+		return (DecompressResult){
+			.is_done = true,
+		};
+
+	if (iter->nulls.num_elements > 0 && simple8brle_bitmap_get_at(&iter->nulls, iter->position))
+	{
+		iter->position--;
+		return (DecompressResult){
+			.is_null = true,
+		};
+	}
+
+	CheckCompressedData(iter->notnull_position >= 0);
+	Datum val = alp_decode_notnull(iter, iter->notnull_position);
+	iter->position--;
+	iter->notnull_position--;
+
+	return (DecompressResult){
+		.val = val,
+	};
+}
+
+extern DecompressionIterator *
+alp_decompression_iterator_from_datum_forward(Datum alp_compressed, Oid element_type)
+{
+	AlpDecompressionIterator *iterator = palloc(sizeof(*iterator));
+	CheckCompressedData(DatumGetPointer(alp_compressed) != NULL);
+	decompression_iterator_init(iterator,
+								(void *) PG_DETOAST_DATUM(alp_compressed),
+								element_type,
+								true);
+	return &iterator->base;
+}
+
+extern DecompressionIterator *
+alp_decompression_iterator_from_datum_reverse(Datum alp_compressed, Oid element_type)
+{
+	AlpDecompressionIterator *iterator = palloc(sizeof(*iterator));
+	CheckCompressedData(DatumGetPointer(alp_compressed) != NULL);
+	decompression_iterator_init(iterator,
+								(void *) PG_DETOAST_DATUM(alp_compressed),
+								element_type,
+								false);
+	return &iterator->base;
+}
+
+/*
+ * Bulk decompression into an Arrow array. The decode is a multiplication per
+ * value with no serial dependencies, so the main loop vectorizes well.
+ */
+extern ArrowArray *
+alp_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
+{
+	CheckCompressedData(DatumGetPointer(compressed) != NULL);
+
+	void *detoasted = PG_DETOAST_DATUM(compressed);
+	StringInfoData si = { .data = detoasted, .len = VARSIZE(detoasted) };
+	AlpCompressed *header = consumeCompressedData(&si, sizeof(AlpCompressed));
+
+	CheckCompressedData(header->has_nulls == 0 || header->has_nulls == 1);
+	CheckCompressedData(header->exponent <= ALP_MAX_EXPONENT);
+	CheckCompressedData(element_type == FLOAT8OID || element_type == FLOAT4OID);
+	CheckCompressedData(header->element_width == (element_type == FLOAT4OID ? 4 : 8));
+
+	const bool is_float4 = element_type == FLOAT4OID;
+	const bool has_nulls = header->has_nulls == 1;
+	const double scale = alp_pow10[header->exponent];
+
+	Simple8bRleSerialized *digits_serialized = bytes_deserialize_simple8b_and_advance(&si);
+	Simple8bRleSerialized *exception_bitmap_serialized =
+		bytes_deserialize_simple8b_and_advance(&si);
+	Simple8bRleSerialized *nulls_serialized =
+		has_nulls ? bytes_deserialize_simple8b_and_advance(&si) : NULL;
+
+	uint32 num_notnull;
+	const uint64 *digits = simple8brle_decompress_all_uint64(digits_serialized, &num_notnull);
+
+	const Simple8bRleBitmap exception_prefix_sums =
+		simple8brle_bitmap_prefixsums(exception_bitmap_serialized);
+	CheckCompressedData(exception_prefix_sums.num_elements == num_notnull);
+	CheckCompressedData(simple8brle_bitmap_num_ones(&exception_prefix_sums) ==
+						header->num_exceptions);
+
+	const uint64 *exception_values = (const uint64 *) (si.data + si.cursor);
+	CheckCompressedData(si.cursor + sizeof(uint64) * (Size) header->num_exceptions <= (Size) si.len);
+
+	Simple8bRleBitmap nulls = { 0 };
+	if (has_nulls)
+	{
+		nulls = simple8brle_bitmap_decompress(nulls_serialized);
+	}
+
+	const uint32 n_total = has_nulls ? nulls.num_elements : num_notnull;
+	CheckCompressedData(n_total >= num_notnull);
+	CheckCompressedData(n_total <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+	const int element_width = is_float4 ? 4 : 8;
+
+	/*
+	 * Pad the number of elements to multiple of 64 bytes if needed, so that we
+	 * can work in 64-byte blocks, and add 8 bytes on top because the code that
+	 * converts the elements to postgres Datum always reads in 8 bytes.
+	 */
+	const uint32 n_total_padded = ((n_total * element_width + 63) / 64) * 64 / element_width;
+	const int buffer_bytes = n_total_padded * element_width + 8;
+	char *restrict decompressed_values = MemoryContextAlloc(dest_mctx, buffer_bytes);
+
+	/* 1) Decode the digits into the not-null positions. */
+	if (is_float4)
+	{
+		float *restrict values = (float *) decompressed_values;
+		for (uint32 i = 0; i < num_notnull; i++)
+		{
+			values[i] = (float) ((double) alp_zig_zag_decode(digits[i]) / scale);
+		}
+	}
+	else
+	{
+		double *restrict values = (double *) decompressed_values;
+		for (uint32 i = 0; i < num_notnull; i++)
+		{
+			values[i] = (double) alp_zig_zag_decode(digits[i]) / scale;
+		}
+	}
+
+	/* 2) Patch in the exceptions. */
+	for (uint32 i = 0; i < num_notnull; i++)
+	{
+		const uint16 prefix_sum = simple8brle_bitmap_prefix_sum(&exception_prefix_sums, i);
+		const uint16 prev_prefix_sum =
+			i > 0 ? simple8brle_bitmap_prefix_sum(&exception_prefix_sums, i - 1) : 0;
+		if (prefix_sum == prev_prefix_sum)
+			continue;
+
+		const uint64 bits = exception_values[prefix_sum - 1];
+		if (is_float4)
+			((float *) decompressed_values)[i] = bits_get_float((uint32) bits);
+		else
+			((double *) decompressed_values)[i] = bits_get_double(bits);
+	}
+
+	/* 3) Reshuffle for nulls and build the validity bitmap, if needed. */
+	uint64 *restrict validity_bitmap = NULL;
+	if (has_nulls)
+	{
+		const int validity_bitmap_bytes = sizeof(uint64) * ((n_total + 64 - 1) / 64);
+		validity_bitmap = MemoryContextAlloc(dest_mctx, validity_bitmap_bytes);
+
+		memset(validity_bitmap, 0xFF, validity_bitmap_bytes);
+		if (n_total % 64)
+		{
+			const uint64 tail_mask = ~0ULL >> (64 - n_total % 64);
+			validity_bitmap[n_total / 64] &= tail_mask;
+		}
+
+		CheckCompressedData(num_notnull + simple8brle_bitmap_num_ones(&nulls) == n_total);
+
+		int current_notnull_element = num_notnull - 1;
+		for (int i = n_total - 1; i >= 0; i--)
+		{
+			Assert(i >= current_notnull_element);
+
+			if (simple8brle_bitmap_get_at(&nulls, i))
+			{
+				arrow_set_row_validity(validity_bitmap, i, false);
+			}
+			else
+			{
+				Assert(current_notnull_element >= 0);
+				if (is_float4)
+					((float *) decompressed_values)[i] =
+						((float *) decompressed_values)[current_notnull_element];
+				else
+					((double *) decompressed_values)[i] =
+						((double *) decompressed_values)[current_notnull_element];
+				current_notnull_element--;
+			}
+		}
+
+		Assert(current_notnull_element == -1);
+	}
+
+	ArrowArray *result = MemoryContextAllocZero(dest_mctx, sizeof(ArrowArray) + sizeof(void *) * 2);
+	const void **buffers = (const void **) &result[1];
+	buffers[0] = validity_bitmap;
+	buffers[1] = decompressed_values;
+	result->n_buffers = 2;
+	result->buffers = buffers;
+	result->length = n_total;
+	result->null_count = n_total - num_notnull;
+	return result;
+}
+
+/*************
+ ***  I/O  ***
+ *************/
+
+extern void
+alp_compressed_send(CompressedDataHeader *header, StringInfo buffer)
+{
+	const AlpCompressed *data = (AlpCompressed *) header;
+	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_ALP);
+
+	pq_sendbyte(buffer, data->has_nulls);
+	pq_sendbyte(buffer, data->exponent);
+	pq_sendbyte(buffer, data->element_width);
+	pq_sendint32(buffer, data->num_exceptions);
+
+	const char *cursor = data->data;
+	const Simple8bRleSerialized *digits = (const Simple8bRleSerialized *) cursor;
+	simple8brle_serialized_send(buffer, digits);
+	cursor += simple8brle_serialized_total_size(digits);
+
+	const Simple8bRleSerialized *exception_bitmap = (const Simple8bRleSerialized *) cursor;
+	simple8brle_serialized_send(buffer, exception_bitmap);
+	cursor += simple8brle_serialized_total_size(exception_bitmap);
+
+	if (data->has_nulls)
+	{
+		const Simple8bRleSerialized *nulls = (const Simple8bRleSerialized *) cursor;
+		simple8brle_serialized_send(buffer, nulls);
+		cursor += simple8brle_serialized_total_size(nulls);
+	}
+
+	const uint64 *exceptions = (const uint64 *) cursor;
+	for (uint32 i = 0; i < data->num_exceptions; i++)
+		pq_sendint64(buffer, exceptions[i]);
+}
+
+extern Datum
+alp_compressed_recv(StringInfo buffer)
+{
+	const uint8 has_nulls = pq_getmsgbyte(buffer);
+	const uint8 exponent = pq_getmsgbyte(buffer);
+	const uint8 element_width = pq_getmsgbyte(buffer);
+	const uint32 num_exceptions = pq_getmsgint(buffer, 4);
+
+	CheckCompressedData(has_nulls == 0 || has_nulls == 1);
+	CheckCompressedData(exponent <= ALP_MAX_EXPONENT);
+	CheckCompressedData(element_width == 4 || element_width == 8);
+	CheckCompressedData(num_exceptions <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+	Simple8bRleSerialized *digits = simple8brle_serialized_recv(buffer);
+	Simple8bRleSerialized *exception_bitmap = simple8brle_serialized_recv(buffer);
+	Simple8bRleSerialized *nulls = NULL;
+	if (has_nulls)
+		nulls = simple8brle_serialized_recv(buffer);
+
+	CheckCompressedData(num_exceptions <= digits->num_elements);
+
+	uint64 *exceptions = palloc(sizeof(uint64) * num_exceptions);
+	for (uint32 i = 0; i < num_exceptions; i++)
+		exceptions[i] = pq_getmsgint64(buffer);
+
+	AlpCompressed *compressed = alp_compressed_from_parts(digits,
+														  exception_bitmap,
+														  nulls,
+														  exceptions,
+														  num_exceptions,
+														  exponent,
+														  element_width);
+
+	PG_RETURN_POINTER(compressed);
+}
+
+extern Compressor *
+alp_compressor_for_type(Oid element_type)
+{
+	ExtendedCompressor *compressor = palloc(sizeof(*compressor));
+	switch (element_type)
+	{
+		case FLOAT4OID:
+			*compressor = (ExtendedCompressor){ .base = alp_float_compressor_initializer,
+												.element_type = element_type };
+			return &compressor->base;
+		case FLOAT8OID:
+			*compressor = (ExtendedCompressor){ .base = alp_double_compressor_initializer,
+												.element_type = element_type };
+			return &compressor->base;
+		default:
+			elog(ERROR, "invalid type for alp compressor \"%s\"", format_type_be(element_type));
+	}
+
+	pg_unreachable();
+}
+
+/*
+ * Cross-module functions for the alp algorithm.
+ */
+
+extern Datum
+tsl_alp_compressor_append(PG_FUNCTION_ARGS)
+{
+	MemoryContext old_context;
+	MemoryContext agg_context;
+	Compressor *compressor = (Compressor *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+
+	if (!AggCheckCallContext(fcinfo, &agg_context))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "tsl_alp_compressor_append called in non-aggregate context");
+	}
+
+	old_context = MemoryContextSwitchTo(agg_context);
+
+	if (compressor == NULL)
+	{
+		compressor = alp_compressor_for_type(get_fn_expr_argtype(fcinfo->flinfo, 1));
+	}
+
+	if (PG_ARGISNULL(1))
+		compressor->append_null(compressor);
+	else
+		compressor->append_val(compressor, PG_GETARG_DATUM(1));
+
+	MemoryContextSwitchTo(old_context);
+	PG_RETURN_POINTER(compressor);
+}
+
+extern Datum
+tsl_alp_compressor_finish(PG_FUNCTION_ARGS)
+{
+	Compressor *compressor = PG_ARGISNULL(0) ? NULL : (Compressor *) PG_GETARG_POINTER(0);
+	if (compressor == NULL)
+		PG_RETURN_NULL();
+
+	void *compressed = compressor->finish(compressor);
+	if (compressed == NULL)
+		PG_RETURN_NULL();
+	PG_RETURN_POINTER(compressed);
+}
+
+/*
+ * Local helpers
+ */
+static void
+alp_compressor_append_float(Compressor *compressor, Datum val)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = alp_compressor_alloc(extended->element_type);
+
+	alp_compressor_append_value(extended->internal, (double) DatumGetFloat4(val));
+}
+
+static void
+alp_compressor_append_double(Compressor *compressor, Datum val)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = alp_compressor_alloc(extended->element_type);
+
+	alp_compressor_append_value(extended->internal, DatumGetFloat8(val));
+}
+
+static void
+alp_compressor_append_null_value(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = alp_compressor_alloc(extended->element_type);
+
+	alp_compressor_append_null(extended->internal);
+}
+
+static void *
+alp_compressor_finish_and_reset(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	void *compressed = NULL;
+	if (extended != NULL && extended->internal != NULL)
+	{
+		compressed = alp_compressor_finish(extended->internal);
+		pfree(extended->internal);
+		extended->internal = NULL;
+	}
+	return compressed;
+}
@@ -0,0 +1,73 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+/*
+ * alp is an adaptive lossless floating point codec in the spirit of the ALP
+ * paper. It targets "decimal" floats, i.e. values that are short decimal
+ * numbers like sensor readings, where gorilla gets poor ratios. Each batch is
+ * encoded as scaled integers:
+ *
+ *     digits = round(value * 10^e)
+ *
+ * with a per-batch decimal exponent e chosen by sampling, and the digits are
+ * zigzag + simple8b_rle encoded. Values that do not survive the exact
+ * round-trip through this formula (including NaN, infinities and -0) are
+ * stored verbatim as exceptions, with their positions in a simple8b_rle
+ * bitmap. Decompression is a multiplication per value, which is also much
+ * cheaper than the bitwise gorilla decode.
+ */
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+
+#include "compression/compression.h"
+
+typedef struct AlpCompressor AlpCompressor;
+typedef struct AlpCompressed AlpCompressed;
+
+/*
+ * Compressor framework functions and definitions for the alp algorithm.
+ */
+
+extern AlpCompressor *alp_compressor_alloc(Oid element_type);
+extern void alp_compressor_append_null(AlpCompressor *compressor);
+extern void alp_compressor_append_value(AlpCompressor *compressor, double next_val);
+extern void *alp_compressor_finish(AlpCompressor *compressor);
+extern bool alp_compressed_has_nulls(const CompressedDataHeader *header);
+
+extern DecompressResult alp_decompression_iterator_try_next_forward(DecompressionIterator *iter);
+extern DecompressionIterator *alp_decompression_iterator_from_datum_forward(Datum alp_compressed,
+																			Oid element_type);
+
+extern DecompressResult alp_decompression_iterator_try_next_reverse(DecompressionIterator *iter);
+extern DecompressionIterator *alp_decompression_iterator_from_datum_reverse(Datum alp_compressed,
+																			Oid element_type);
+
+extern void alp_compressed_send(CompressedDataHeader *header, StringInfo buffer);
+extern Datum alp_compressed_recv(StringInfo buffer);
+
+extern ArrowArray *alp_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx);
+
+extern Compressor *alp_compressor_for_type(Oid element_type);
+
+#define ALP_ALGORITHM_DEFINITION                                                                   \
+	{                                                                                              \
+		.iterator_init_forward = alp_decompression_iterator_from_datum_forward,                    \
+		.iterator_init_reverse = alp_decompression_iterator_from_datum_reverse,                    \
+		.decompress_all = alp_decompress_all, .compressed_data_send = alp_compressed_send,         \
+		.compressed_data_recv = alp_compressed_recv,                                               \
+		.compressor_for_type = alp_compressor_for_type,                                            \
+		.compressed_data_storage = TOAST_STORAGE_EXTERNAL,                                         \
+	}
+
+/*
+ * Cross-module functions for the alp algorithm.
+ */
+
+extern Datum tsl_alp_compressor_append(PG_FUNCTION_ARGS);
+extern Datum tsl_alp_compressor_finish(PG_FUNCTION_ARGS);
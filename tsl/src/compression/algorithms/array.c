@@ -17,6 +17,7 @@
 #include "array.h"
 #include "compression/compression.h"
 #include "datum_serialize.h"
+#include "simd_support.h"
 #include "simple8b_rle.h"
 #include "simple8b_rle_bitarray.h"
 #include "simple8b_rle_bitmap.h"
@@ -509,6 +510,12 @@ tsl_array_decompress_all(Datum compressed_array, Oid element_type, MemoryContext
 		case BOOLOID:
 			return tsl_bool_array_decompress_all(compressed_array, element_type, dest_mctx);
 		case TEXTOID:
+		case NUMERICOID:
+			/*
+			 * The text decompression copies the varlena bodies without looking
+			 * inside them, so it works for any varlena type. Numeric is the
+			 * only other one we allow, for the vectorized aggregation.
+			 */
 			return tsl_text_array_decompress_all(compressed_array, element_type, dest_mctx);
 		case UUIDOID:
 			return tsl_uuid_array_decompress_all(compressed_array, element_type, dest_mctx);
@@ -675,13 +682,13 @@ tsl_uuid_array_decompress_all(Datum compressed_array, Oid element_type, MemoryCo
 static ArrowArray *
 tsl_text_array_decompress_all(Datum compressed_array, Oid element_type, MemoryContext dest_mctx)
 {
-	Assert(element_type == TEXTOID);
+	Assert(element_type == TEXTOID || element_type == NUMERICOID);
 	void *compressed_data = PG_DETOAST_DATUM(compressed_array);
 	StringInfoData si = { .data = compressed_data, .len = VARSIZE(compressed_data) };
 	ArrayCompressed *header = consumeCompressedData(&si, sizeof(ArrayCompressed));
 
 	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_ARRAY);
-	CheckCompressedData(header->element_type == TEXTOID);
+	CheckCompressedData(header->element_type == element_type);
 
 	return text_array_decompress_all_serialized_no_header(&si, header->has_nulls, dest_mctx);
 }
@@ -0,0 +1,257 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#include <postgres.h>
+#include <libpq/pqformat.h>
+#include <utils/builtins.h>
+
+#include "array_zstd.h"
+
+#include "array.h"
+#include "compression/compression.h"
+
+#ifdef TS_USE_ZSTD
+#include <zstd.h>
+#endif
+
+/*
+ * Array zstd compressed data is stored as
+ *     uint16 compression_algorithm: id number for the compression scheme
+ *     uint8 has_nulls: 1 if the wrapped array batch has a NULLs bitmap
+ *     uint32 inner_size: size in bytes of the inflated array batch
+ *     char payload[]: the zstd frame holding the serialized array batch
+ */
+typedef struct ArrayZstdCompressed
+{
+	CompressedDataHeaderFields;
+	uint8 has_nulls;
+	uint8 padding[2];
+	uint32 inner_size;
+	char payload[FLEXIBLE_ARRAY_MEMBER];
+} ArrayZstdCompressed;
+
+static void
+pg_attribute_unused() assertions(void)
+{
+	ArrayZstdCompressed test_val = { .vl_len_ = { 0 } };
+	/* make sure no padding bytes make it to disk */
+	StaticAssertStmt(sizeof(ArrayZstdCompressed) ==
+						 sizeof(test_val.vl_len_) + sizeof(test_val.compression_algorithm) +
+							 sizeof(test_val.has_nulls) + sizeof(test_val.padding) +
+							 sizeof(test_val.inner_size),
+					 "ArrayZstd wrong size");
+	StaticAssertStmt(sizeof(ArrayZstdCompressed) == 12, "ArrayZstd wrong size");
+}
+
+/*
+ * A middle-of-the-road level; the decode speed barely depends on it, and the
+ * diminishing returns above this are not worth the compression CPU.
+ */
+#define ARRAY_ZSTD_COMPRESSION_LEVEL 3
+
+typedef struct ExtendedCompressor
+{
+	Compressor base;
+	ArrayCompressor *internal;
+	Oid element_type;
+} ExtendedCompressor;
+
+#ifdef TS_USE_ZSTD
+
+/*
+ * Inflate the wrapped array batch. The result is a plain ArrayCompressed
+ * datum that the array code can work on directly.
+ */
+static void *
+array_zstd_inflate(const ArrayZstdCompressed *compressed)
+{
+	CheckCompressedData(compressed->inner_size > 0);
+	CheckCompressedData(AllocSizeIsValid(compressed->inner_size));
+
+	const uint32 payload_size = VARSIZE(compressed) - sizeof(ArrayZstdCompressed);
+	void *inner = palloc(compressed->inner_size);
+	const size_t decompressed_size =
+		ZSTD_decompress(inner, compressed->inner_size, compressed->payload, payload_size);
+
+	CheckCompressedData(!ZSTD_isError(decompressed_size));
+	CheckCompressedData(decompressed_size == compressed->inner_size);
+	CheckCompressedData(VARSIZE(inner) == compressed->inner_size);
+	CheckCompressedData(((CompressedDataHeader *) inner)->compression_algorithm ==
+						COMPRESSION_ALGORITHM_ARRAY);
+
+	return inner;
+}
+
+static void *
+array_zstd_compressor_finish_and_reset(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended == NULL || extended->internal == NULL)
+		return NULL;
+
+	void *inner = array_compressor_finish(extended->internal);
+	extended->internal = NULL;
+	if (inner == NULL)
+		return NULL;
+
+	const uint32 inner_size = VARSIZE(inner);
+	const size_t bound = ZSTD_compressBound(inner_size);
+	char *scratch = palloc(bound);
+	const size_t payload_size =
+		ZSTD_compress(scratch, bound, inner, inner_size, ARRAY_ZSTD_COMPRESSION_LEVEL);
+	if (ZSTD_isError(payload_size))
+		elog(ERROR, "zstd compression failed: %s", ZSTD_getErrorName(payload_size));
+
+	const Size compressed_size = sizeof(ArrayZstdCompressed) + payload_size;
+	if (compressed_size >= inner_size)
+	{
+		/*
+		 * Zstd doesn't shrink this batch, store the plain array datum. The
+		 * batches are self-describing, so decompression handles both forms.
+		 */
+		pfree(scratch);
+		return inner;
+	}
+
+	ArrayZstdCompressed *compressed = palloc(compressed_size);
+	SET_VARSIZE(&compressed->vl_len_, compressed_size);
+	compressed->compression_algorithm = COMPRESSION_ALGORITHM_ARRAY_ZSTD;
+	compressed->has_nulls = array_compressed_has_nulls(inner) ? 1 : 0;
+	memset(compressed->padding, 0, sizeof(compressed->padding));
+	compressed->inner_size = inner_size;
+	memcpy(compressed->payload, scratch, payload_size);
+
+	pfree(scratch);
+	pfree(inner);
+	return compressed;
+}
+
+static void
+array_zstd_compressor_append_datum(Compressor *compressor, Datum val)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = array_compressor_alloc(extended->element_type);
+
+	array_compressor_append(extended->internal, val);
+}
+
+static void
+array_zstd_compressor_append_null_value(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = array_compressor_alloc(extended->element_type);
+
+	array_compressor_append_null(extended->internal);
+}
+
+static const Compressor array_zstd_compressor_initializer = {
+	.append_val = array_zstd_compressor_append_datum,
+	.append_null = array_zstd_compressor_append_null_value,
+	.is_full = NULL,
+	.finish = array_zstd_compressor_finish_and_reset,
+};
+
+#else /* !TS_USE_ZSTD */
+
+static void *
+array_zstd_inflate(const ArrayZstdCompressed *compressed)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("cannot decompress zstd-compressed data"),
+			 errdetail("TimescaleDB was compiled without zstd support.")));
+	pg_unreachable();
+}
+
+#endif /* TS_USE_ZSTD */
+
+extern bool
+array_zstd_compressed_has_nulls(const CompressedDataHeader *header)
+{
+	const ArrayZstdCompressed *compressed = (const ArrayZstdCompressed *) header;
+	return compressed->has_nulls;
+}
+
+extern Compressor *
+array_zstd_compressor_for_type(Oid element_type)
+{
+#ifdef TS_USE_ZSTD
+	ExtendedCompressor *compressor = palloc(sizeof(*compressor));
+	*compressor = (ExtendedCompressor){ .base = array_zstd_compressor_initializer,
+										.element_type = element_type };
+	return &compressor->base;
+#else
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("cannot compress data with the array_zstd algorithm"),
+			 errdetail("TimescaleDB was compiled without zstd support.")));
+	pg_unreachable();
+#endif
+}
+
+extern DecompressionIterator *
+array_zstd_decompression_iterator_from_datum_forward(Datum zstd_compressed, Oid element_type)
+{
+	CheckCompressedData(DatumGetPointer(zstd_compressed) != NULL);
+	void *inner = array_zstd_inflate((ArrayZstdCompressed *) PG_DETOAST_DATUM(zstd_compressed));
+	return tsl_array_decompression_iterator_from_datum_forward(PointerGetDatum(inner),
+															   element_type);
+}
+
+extern DecompressionIterator *
+array_zstd_decompression_iterator_from_datum_reverse(Datum zstd_compressed, Oid element_type)
+{
+	CheckCompressedData(DatumGetPointer(zstd_compressed) != NULL);
+	void *inner = array_zstd_inflate((ArrayZstdCompressed *) PG_DETOAST_DATUM(zstd_compressed));
+	return tsl_array_decompression_iterator_from_datum_reverse(PointerGetDatum(inner),
+															   element_type);
+}
+
+extern ArrowArray *
+array_zstd_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
+{
+	CheckCompressedData(DatumGetPointer(compressed) != NULL);
+	void *inner = array_zstd_inflate((ArrayZstdCompressed *) PG_DETOAST_DATUM(compressed));
+	return tsl_array_decompress_all(PointerGetDatum(inner), element_type, dest_mctx);
+}
+
+extern void
+array_zstd_compressed_send(CompressedDataHeader *header, StringInfo buffer)
+{
+	const ArrayZstdCompressed *compressed = (ArrayZstdCompressed *) header;
+	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_ARRAY_ZSTD);
+
+	const uint32 payload_size = VARSIZE(compressed) - sizeof(ArrayZstdCompressed);
+	pq_sendbyte(buffer, compressed->has_nulls);
+	pq_sendint32(buffer, compressed->inner_size);
+	pq_sendint32(buffer, payload_size);
+	pq_sendbytes(buffer, compressed->payload, payload_size);
+}
+
+extern Datum
+array_zstd_compressed_recv(StringInfo buffer)
+{
+	const uint8 has_nulls = pq_getmsgbyte(buffer);
+	const uint32 inner_size = pq_getmsgint(buffer, 4);
+	const uint32 payload_size = pq_getmsgint(buffer, 4);
+
+	CheckCompressedData(has_nulls == 0 || has_nulls == 1);
+	CheckCompressedData(inner_size > 0 && AllocSizeIsValid(inner_size));
+	CheckCompressedData(payload_size > 0 &&
+						AllocSizeIsValid((Size) payload_size + sizeof(ArrayZstdCompressed)));
+
+	const Size compressed_size = sizeof(ArrayZstdCompressed) + payload_size;
+	ArrayZstdCompressed *compressed = palloc(compressed_size);
+	SET_VARSIZE(&compressed->vl_len_, compressed_size);
+	compressed->compression_algorithm = COMPRESSION_ALGORITHM_ARRAY_ZSTD;
+	compressed->has_nulls = has_nulls;
+	memset(compressed->padding, 0, sizeof(compressed->padding));
+	compressed->inner_size = inner_size;
+	pq_copymsgbytes(buffer, compressed->payload, payload_size);
+
+	PG_RETURN_POINTER(compressed);
+}
@@ -0,0 +1,52 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+/*
+ * array_zstd wraps the array algorithm with a zstd-compressed payload. The
+ * array format stores variable-length data essentially raw, which compresses
+ * terribly for things like JSON payload columns. This codec runs the
+ * serialized array batch through zstd, and inflates it again before
+ * delegating decompression to the array code, including the ArrowArray bulk
+ * path. If zstd does not shrink a batch, the compressor returns the plain
+ * array datum instead -- compressed batches are self-describing through
+ * their algorithm byte, so both forms can coexist in one column.
+ *
+ * Only available when the extension is built with zstd (TS_USE_ZSTD).
+ */
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+
+#include "compression/compression.h"
+
+typedef struct ArrayZstdCompressor ArrayZstdCompressor;
+
+extern bool array_zstd_compressed_has_nulls(const CompressedDataHeader *header);
+extern Compressor *array_zstd_compressor_for_type(Oid element_type);
+
+extern DecompressionIterator *
+array_zstd_decompression_iterator_from_datum_forward(Datum zstd_compressed, Oid element_type);
+extern DecompressionIterator *
+array_zstd_decompression_iterator_from_datum_reverse(Datum zstd_compressed, Oid element_type);
+
+extern void array_zstd_compressed_send(CompressedDataHeader *header, StringInfo buffer);
+extern Datum array_zstd_compressed_recv(StringInfo buffer);
+
+extern ArrowArray *array_zstd_decompress_all(Datum compressed, Oid element_type,
+											 MemoryContext dest_mctx);
+
+#define ARRAY_ZSTD_ALGORITHM_DEFINITION                                                            \
+	{                                                                                              \
+		.iterator_init_forward = array_zstd_decompression_iterator_from_datum_forward,             \
+		.iterator_init_reverse = array_zstd_decompression_iterator_from_datum_reverse,             \
+		.decompress_all = array_zstd_decompress_all,                                               \
+		.compressed_data_send = array_zstd_compressed_send,                                        \
+		.compressed_data_recv = array_zstd_compressed_recv,                                        \
+		.compressor_for_type = array_zstd_compressor_for_type,                                     \
+		.compressed_data_storage = TOAST_STORAGE_EXTERNAL,                                         \
+	}
@@ -5,6 +5,9 @@
  */
 
 #include "bool_compress.h"
+
+#include <port/pg_bitutils.h>
+
 #include "compression/arrow_c_data_interface.h"
 #include "compression/compression.h"
 #include "simple8b_rle.h"
@@ -49,9 +52,12 @@ static void bool_compressor_append_bool(Compressor *compressor, Datum val);
 
 static void bool_compressor_append_null_value(Compressor *compressor);
 
+static void bool_compressor_append_vector(Compressor *compressor, const ArrowArray *vector);
+
 static void *bool_compressor_finish_and_reset(Compressor *compressor);
 
 const Compressor bool_compressor_initializer = {
+	.append_vector = bool_compressor_append_vector,
 	.append_val = bool_compressor_append_bool,
 	.append_null = bool_compressor_append_null_value,
 	.is_full = NULL,
@@ -100,6 +106,74 @@ bool_compressor_append_value(BoolCompressor *compressor, bool next_val)
 	simple8brle_compressor_append(&compressor->validity_bitmap, 1);
 }
 
+/*
+ * Bulk append from Arrow-layout bitmaps: `values` holds the bool values and
+ * `validity` the not-null flags, both with 64 LSB-first elements per word.
+ * A NULL `validity` means that all values are valid. Instead of going bit by
+ * bit, whole words are translated into runs that are appended to the RLE
+ * compressors in one go, falling back to the per-bit path only for words that
+ * mix valid and null elements.
+ */
+extern void
+bool_compressor_append_bitmap(BoolCompressor *compressor, const uint64 *validity,
+							  const uint64 *values, uint32 num_values)
+{
+	const uint32 num_full_words = num_values / 64;
+	for (uint32 word = 0; word < num_full_words; word++)
+	{
+		const uint64 validity_word = validity ? validity[word] : ~0ULL;
+		const uint64 values_word = values[word];
+
+		if (validity_word == ~0ULL)
+		{
+			/* All elements valid, append the runs of the values word. */
+			uint32 pos = 0;
+			while (pos < 64)
+			{
+				const bool bit = (values_word >> pos) & 1;
+				const uint64 rest = (bit ? ~values_word : values_word) >> pos;
+				const uint32 run = rest == 0 ? 64 - pos : pg_rightmost_one_pos64(rest);
+				simple8brle_compressor_append_repeated(&compressor->values, bit, run);
+				simple8brle_compressor_append_repeated(&compressor->validity_bitmap, 1, run);
+				compressor->last_value = bit;
+				pos += run;
+			}
+		}
+		else if (validity_word == 0)
+		{
+			/*
+			 * All elements null. Like in the per-element append, the values
+			 * bitmap gets the last seen value, not to break the RLE sequences.
+			 */
+			compressor->has_nulls = true;
+			compressor->num_nulls += 64;
+			simple8brle_compressor_append_repeated(&compressor->values,
+												   compressor->last_value,
+												   64);
+			simple8brle_compressor_append_repeated(&compressor->validity_bitmap, 0, 64);
+		}
+		else
+		{
+			for (uint32 bit = 0; bit < 64; bit++)
+			{
+				if ((validity_word >> bit) & 1)
+					bool_compressor_append_value(compressor, (values_word >> bit) & 1);
+				else
+					bool_compressor_append_null(compressor);
+			}
+		}
+	}
+
+	for (uint32 i = num_full_words * 64; i < num_values; i++)
+	{
+		const bool valid = validity == NULL || ((validity[i / 64] >> (i % 64)) & 1);
+		if (valid)
+			bool_compressor_append_value(compressor, (values[i / 64] >> (i % 64)) & 1);
+		else
+			bool_compressor_append_null(compressor);
+	}
+}
+
 extern void *
 bool_compressor_finish(BoolCompressor *compressor)
 {
@@ -400,6 +474,24 @@ bool_compressor_append_null_value(Compressor *compressor)
 	bool_compressor_append_null(extended->internal);
 }
 
+/*
+ * Bulk appends from a column vector in the Arrow layout. The bit-packed value
+ * and validity buffers go straight into the word-wide bitmap append, so no
+ * per-row Datums are built.
+ */
+static void
+bool_compressor_append_vector(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = bool_compressor_alloc();
+
+	bool_compressor_append_bitmap(extended->internal,
+								  vector->buffers[0],
+								  vector->buffers[1],
+								  vector->length);
+}
+
 static void *
 bool_compressor_finish_and_reset(Compressor *compressor)
 {
@@ -38,6 +38,8 @@ typedef struct BoolDecompressionIterator BoolDecompressionIterator;
 extern BoolCompressor *bool_compressor_alloc(void);
 extern void bool_compressor_append_null(BoolCompressor *compressor);
 extern void bool_compressor_append_value(BoolCompressor *compressor, bool next_val);
+extern void bool_compressor_append_bitmap(BoolCompressor *compressor, const uint64 *validity,
+										  const uint64 *values, uint32 num_values);
 extern void *bool_compressor_finish(BoolCompressor *compressor);
 extern bool bool_compressed_has_nulls(const CompressedDataHeader *header);
 
@@ -298,7 +298,14 @@ load_recv_fn(DatumDeserializer *des, bool use_binary)
 		fmgr_info(des->type_in, &des->recv_flinfo);
 }
 
-/* Loosely based on `range_deserialize` in rangetypes.c */
+/*
+ * Loosely based on `range_deserialize` in rangetypes.c.
+ *
+ * Note that this is zero-copy for by-reference types: the returned datum
+ * points directly into the given buffer, through fetch_att. The callers rely
+ * on this, so the buffer must live at least as long as the deserialized
+ * datums, e.g. the per-batch memory context for compressed batch reads.
+ */
 Datum
 bytes_to_datum_and_advance(DatumDeserializer *deserializer, const char **ptr)
 {
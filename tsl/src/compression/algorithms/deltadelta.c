@@ -23,9 +23,14 @@
 
 #include "compression/arrow_c_data_interface.h"
 #include "compression/compression.h"
+#include "simd_support.h"
 #include "simple8b_rle.h"
 #include "simple8b_rle_bitmap.h"
 
+#ifdef TS_USE_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
 static uint64 zig_zag_encode(uint64 value);
 static uint64 zig_zag_decode(uint64 value);
 
@@ -164,6 +169,83 @@ deltadelta_compressor_append_null_value(Compressor *compressor)
 	delta_delta_compressor_append_null(extended->internal);
 }
 
+/*
+ * Bulk appends from a column vector in the Arrow layout. The value buffer is
+ * read directly at the element width, so no per-row Datums are built.
+ */
+static void
+deltadelta_compressor_append_vector_bool(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = delta_delta_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const uint64 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			delta_delta_compressor_append_value(extended->internal,
+												arrow_row_is_valid(values, i) ? 1 : 0);
+		else
+			delta_delta_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+deltadelta_compressor_append_vector_int16(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = delta_delta_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const int16 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			delta_delta_compressor_append_value(extended->internal, values[i]);
+		else
+			delta_delta_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+deltadelta_compressor_append_vector_int32(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = delta_delta_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const int32 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			delta_delta_compressor_append_value(extended->internal, values[i]);
+		else
+			delta_delta_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+deltadelta_compressor_append_vector_int64(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = delta_delta_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const int64 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			delta_delta_compressor_append_value(extended->internal, values[i]);
+		else
+			delta_delta_compressor_append_null(extended->internal);
+	}
+}
+
 static void *
 deltadelta_compressor_finish_and_reset(Compressor *compressor)
 {
@@ -175,6 +257,7 @@ deltadelta_compressor_finish_and_reset(Compressor *compressor)
 }
 
 const Compressor deltadelta_bool_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_bool,
 	.append_val = deltadelta_compressor_append_bool,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
@@ -182,18 +265,21 @@ const Compressor deltadelta_bool_compressor = {
 };
 
 const Compressor deltadelta_uint16_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int16,
 	.append_val = deltadelta_compressor_append_int16,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
 	.finish = deltadelta_compressor_finish_and_reset,
 };
 const Compressor deltadelta_uint32_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int32,
 	.append_val = deltadelta_compressor_append_int32,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
 	.finish = deltadelta_compressor_finish_and_reset,
 };
 const Compressor deltadelta_uint64_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int64,
 	.append_val = deltadelta_compressor_append_int64,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
@@ -201,6 +287,7 @@ const Compressor deltadelta_uint64_compressor = {
 };
 
 const Compressor deltadelta_date_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int32,
 	.append_val = deltadelta_compressor_append_date,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
@@ -208,6 +295,7 @@ const Compressor deltadelta_date_compressor = {
 };
 
 const Compressor deltadelta_timestamp_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int64,
 	.append_val = deltadelta_compressor_append_timestamp,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
@@ -215,6 +303,7 @@ const Compressor deltadelta_timestamp_compressor = {
 };
 
 const Compressor deltadelta_timestamptz_compressor = {
+	.append_vector = deltadelta_compressor_append_vector_int64,
 	.append_val = deltadelta_compressor_append_timestamptz,
 	.append_null = deltadelta_compressor_append_null_value,
 	.is_full = NULL,
@@ -26,6 +26,7 @@
 #include "datum_serialize.h"
 #include "dictionary.h"
 #include "dictionary_hash.h"
+#include "simd_support.h"
 #include "simple8b_rle.h"
 #include "simple8b_rle_bitarray.h"
 #include "simple8b_rle_bitmap.h"
@@ -445,7 +446,8 @@ dictionary_decompression_iterator_init(DictionaryDecompressionIterator *iter, co
 static ArrowArray *tsl_bool_dictionary_decompress_all(Datum compressed, Oid element_type,
 													  MemoryContext dest_mctx);
 static ArrowArray *tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type,
-													  MemoryContext dest_mctx);
+													  MemoryContext dest_mctx,
+													  DictionaryDecompressionCache *cache);
 static ArrowArray *tsl_uuid_dictionary_decompress_all(Datum compressed, Oid element_type,
 													  MemoryContext dest_mctx);
 
@@ -458,7 +460,16 @@ tsl_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryContext
 		case BOOLOID:
 			return tsl_bool_dictionary_decompress_all(compressed, element_type, dest_mctx);
 		case TEXTOID:
-			return tsl_text_dictionary_decompress_all(compressed, element_type, dest_mctx);
+		case NUMERICOID:
+			/*
+			 * The text decompression copies the varlena bodies without looking
+			 * inside them, so it works for any varlena type. Numeric is the
+			 * only other one we allow, for the vectorized aggregation.
+			 */
+			return tsl_text_dictionary_decompress_all(compressed,
+													  element_type,
+													  dest_mctx,
+													  /* cache = */ NULL);
 		case UUIDOID:
 			return tsl_uuid_dictionary_decompress_all(compressed, element_type, dest_mctx);
 		default:
@@ -642,9 +653,10 @@ tsl_uuid_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryCon
 }
 
 static ArrowArray *
-tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
+tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx,
+								   DictionaryDecompressionCache *cache)
 {
-	Assert(element_type == TEXTOID);
+	Assert(element_type == TEXTOID || element_type == NUMERICOID);
 
 	compressed = PointerGetDatum(PG_DETOAST_DATUM(compressed));
 
@@ -653,7 +665,7 @@ tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryCon
 	const DictionaryCompressed *header = consumeCompressedData(&si, sizeof(DictionaryCompressed));
 
 	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_DICTIONARY);
-	CheckCompressedData(header->element_type == TEXTOID);
+	CheckCompressedData(header->element_type == element_type);
 
 	Simple8bRleSerialized *indices_serialized = bytes_deserialize_simple8b_and_advance(&si);
 
@@ -685,9 +697,38 @@ tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryCon
 	}
 	CheckCompressedData(!have_incorrect_index);
 
-	/* Decompress the actual values in the dictionary. */
-	ArrowArray *dict =
-		text_array_decompress_all_serialized_no_header(&si, /* has_nulls = */ false, dest_mctx);
+	/*
+	 * Decompress the actual values in the dictionary. The batches of one chunk
+	 * typically repeat the same dictionary, so when the caller passes a cache,
+	 * reuse the previously materialized string pool if the serialized bytes
+	 * match, and only materialize into the cache on a miss. We deliberately
+	 * don't free the replaced dictionary on a miss, because with batch sorted
+	 * merge other open batches may still reference it; it is freed with the
+	 * cache context at the end of the scan.
+	 */
+	ArrowArray *dict = NULL;
+	const char *dict_serialized = si.data + si.cursor;
+	const uint32 dict_serialized_bytes = si.len - si.cursor;
+	if (cache != NULL && cache->dict != NULL &&
+		cache->serialized_bytes == dict_serialized_bytes &&
+		memcmp(cache->serialized, dict_serialized, dict_serialized_bytes) == 0)
+	{
+		dict = cache->dict;
+	}
+	else if (cache != NULL)
+	{
+		dict = text_array_decompress_all_serialized_no_header(&si,
+															  /* has_nulls = */ false,
+															  cache->mctx);
+		cache->serialized = MemoryContextAlloc(cache->mctx, dict_serialized_bytes);
+		memcpy(cache->serialized, dict_serialized, dict_serialized_bytes);
+		cache->serialized_bytes = dict_serialized_bytes;
+		cache->dict = dict;
+	}
+	else
+	{
+		dict = text_array_decompress_all_serialized_no_header(&si, /* has_nulls = */ false, dest_mctx);
+	}
 	CheckCompressedData(header->num_distinct == dict->length);
 
 	uint64 *restrict validity_bitmap = NULL;
@@ -753,6 +794,19 @@ tsl_text_dictionary_decompress_all(Datum compressed, Oid element_type, MemoryCon
 	return result;
 }
 
+/*
+ * Like tsl_dictionary_decompress_all for text, but shares the materialized
+ * dictionary across the batches of one chunk scan through the given cache.
+ */
+ArrowArray *
+tsl_text_dictionary_decompress_all_cached(Datum compressed, Oid element_type,
+										  MemoryContext dest_mctx,
+										  DictionaryDecompressionCache *cache)
+{
+	Assert(cache != NULL && cache->mctx != NULL);
+	return tsl_text_dictionary_decompress_all(compressed, element_type, dest_mctx, cache);
+}
+
 DecompressionIterator *
 tsl_dictionary_decompression_iterator_from_datum_forward(Datum dictionary_compressed,
 														 Oid element_type)
@@ -52,6 +52,29 @@ extern Datum tsl_dictionary_compressor_finish(PG_FUNCTION_ARGS);
 ArrowArray *tsl_dictionary_decompress_all(Datum compressed, Oid element_type,
 										  MemoryContext dest_mctx);
 
+/*
+ * Cache of a materialized dictionary, shared across the batches of one chunk
+ * scan. The batches of a chunk typically repeat the same small dictionary, so
+ * the scan can keep the last materialized one and reuse it when the serialized
+ * bytes match, instead of re-materializing the same string pool per batch.
+ * The materialized dictionary and the key bytes live in the given memory
+ * context, which must outlive the per-batch contexts.
+ */
+typedef struct DictionaryDecompressionCache
+{
+	MemoryContext mctx;
+
+	/* The serialized dictionary part of the compressed datum, used as key. */
+	char *serialized;
+	uint32 serialized_bytes;
+
+	ArrowArray *dict;
+} DictionaryDecompressionCache;
+
+ArrowArray *tsl_text_dictionary_decompress_all_cached(Datum compressed, Oid element_type,
+													  MemoryContext dest_mctx,
+													  DictionaryDecompressionCache *cache);
+
 #define DICTIONARY_ALGORITHM_DEFINITION                                                            \
 	{                                                                                              \
 		.iterator_init_forward = tsl_dictionary_decompression_iterator_from_datum_forward,         \
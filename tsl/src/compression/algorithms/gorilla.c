@@ -16,6 +16,12 @@
 
 #include "gorilla.h"
 
+#include "simd_support.h"
+
+#ifdef TS_USE_X86_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
 #include "adts/bit_array.h"
 #include "compression/arrow_c_data_interface.h"
 #include "compression/compression.h"
@@ -189,6 +195,100 @@ gorilla_compressor_append_null_value(Compressor *compressor)
 	gorilla_compressor_append_null(extended->internal);
 }
 
+/*
+ * Bulk appends from a column vector in the Arrow layout. The value buffer is
+ * read directly at the element width, so no per-row Datums are built.
+ */
+static void
+gorilla_compressor_append_vector_float(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = gorilla_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const float *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			gorilla_compressor_append_value(extended->internal, float_get_bits(values[i]));
+		else
+			gorilla_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+gorilla_compressor_append_vector_double(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = gorilla_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const double *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			gorilla_compressor_append_value(extended->internal, double_get_bits(values[i]));
+		else
+			gorilla_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+gorilla_compressor_append_vector_int16(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = gorilla_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const uint16 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			gorilla_compressor_append_value(extended->internal, values[i]);
+		else
+			gorilla_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+gorilla_compressor_append_vector_int32(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = gorilla_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const uint32 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			gorilla_compressor_append_value(extended->internal, values[i]);
+		else
+			gorilla_compressor_append_null(extended->internal);
+	}
+}
+
+static void
+gorilla_compressor_append_vector_int64(Compressor *compressor, const ArrowArray *vector)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = gorilla_compressor_alloc();
+
+	const uint64 *validity = vector->buffers[0];
+	const uint64 *values = vector->buffers[1];
+	for (int i = 0; i < vector->length; i++)
+	{
+		if (validity == NULL || arrow_row_is_valid(validity, i))
+			gorilla_compressor_append_value(extended->internal, values[i]);
+		else
+			gorilla_compressor_append_null(extended->internal);
+	}
+}
+
 static void *
 gorilla_compressor_finish_and_reset(Compressor *compressor)
 {
@@ -200,6 +300,7 @@ gorilla_compressor_finish_and_reset(Compressor *compressor)
 }
 
 const Compressor gorilla_float_compressor = {
+	.append_vector = gorilla_compressor_append_vector_float,
 	.append_val = gorilla_compressor_append_float,
 	.append_null = gorilla_compressor_append_null_value,
 	.is_full = NULL,
@@ -207,24 +308,28 @@ const Compressor gorilla_float_compressor = {
 };
 
 const Compressor gorilla_double_compressor = {
+	.append_vector = gorilla_compressor_append_vector_double,
 	.append_val = gorilla_compressor_append_double,
 	.append_null = gorilla_compressor_append_null_value,
 	.is_full = NULL,
 	.finish = gorilla_compressor_finish_and_reset,
 };
 const Compressor gorilla_uint16_compressor = {
+	.append_vector = gorilla_compressor_append_vector_int16,
 	.append_val = gorilla_compressor_append_int16,
 	.append_null = gorilla_compressor_append_null_value,
 	.is_full = NULL,
 	.finish = gorilla_compressor_finish_and_reset,
 };
 const Compressor gorilla_uint32_compressor = {
+	.append_vector = gorilla_compressor_append_vector_int32,
 	.append_val = gorilla_compressor_append_int32,
 	.append_null = gorilla_compressor_append_null_value,
 	.is_full = NULL,
 	.finish = gorilla_compressor_finish_and_reset,
 };
 const Compressor gorilla_uint64_compressor = {
+	.append_vector = gorilla_compressor_append_vector_int64,
 	.append_val = gorilla_compressor_append_int64,
 	.append_null = gorilla_compressor_append_null_value,
 	.is_full = NULL,
@@ -0,0 +1,899 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#include <postgres.h>
+#include <adts/char_vec.h>
+#include <catalog/pg_type.h>
+#include <utils/datum.h>
+#include <utils/lsyscache.h>
+#include <utils/typcache.h>
+
+#include "rle.h"
+#include "array.h"
+#include "compression/compression.h"
+#include "datum_serialize.h"
+#include "dictionary.h"
+#include "simple8b_rle.h"
+#include "simple8b_rle_bitarray.h"
+
+#include "compression/arrow_c_data_interface.h"
+
+typedef struct RleCompressed
+{
+	CompressedDataHeaderFields;
+	uint8 has_nulls;
+	uint8 padding[6];
+	Oid element_type;
+	/* 8-byte alignment sentinel for the following fields */
+	uint64 alignment_sentinel[FLEXIBLE_ARRAY_MEMBER];
+} RleCompressed;
+
+static void
+pg_attribute_unused() assertions(void)
+{
+	RleCompressed test_val = { .vl_len_ = { 0 } };
+	/* make sure no padding bytes make it to disk */
+	StaticAssertStmt(sizeof(RleCompressed) ==
+						 sizeof(test_val.vl_len_) + sizeof(test_val.compression_algorithm) +
+							 sizeof(test_val.has_nulls) + sizeof(test_val.padding) +
+							 sizeof(test_val.element_type),
+					 "RleCompressed wrong size");
+	StaticAssertStmt(sizeof(RleCompressed) == 16, "RleCompressed wrong size");
+
+	/* The same alignment considerations as in array.c apply: data[] stores
+	 * arbitrary Postgres types, so its start must be MAXALIGNed. All
+	 * simple8b_rle streams before it are 8-byte sized, so keeping the header
+	 * at 16 bytes is enough.
+	 */
+	StaticAssertStmt(offsetof(RleCompressed, alignment_sentinel) % MAXIMUM_ALIGNOF == 0,
+					 "variable sized data must be 8-byte aligned");
+}
+
+/*
+ * When run-length encoding does not pay off, the values are recompressed with
+ * the dictionary or array algorithm instead. This is the ratio of runs to
+ * values above which the recompression is attempted.
+ */
+#define RLE_FALLBACK_RUN_FRACTION 0.75
+
+typedef struct RleCompressor
+{
+	/* Bitmap of nulls, 1 entry per row. Nulls do not terminate runs. */
+	Simple8bRleCompressor nulls;
+	/* Repeat count of each run of equal non-null values. */
+	Simple8bRleCompressor run_lengths;
+	/* Serialized size of each run's value, as in the array algorithm. */
+	Simple8bRleCompressor sizes;
+	char_vec data;
+	Oid type;
+	int16 typlen;
+	bool typbyval;
+	DatumSerializer *serializer;
+	bool has_nulls;
+
+	/* State of the currently open run. */
+	bool has_run;
+	Datum run_value;
+	uint32 run_count;
+
+	uint32 num_values;
+	uint32 num_runs;
+} RleCompressor;
+
+typedef struct ExtendedCompressor
+{
+	Compressor base;
+	RleCompressor *internal;
+	Oid element_type;
+} ExtendedCompressor;
+
+typedef struct RleCompressedData
+{
+	Oid element_type;
+	Simple8bRleSerialized *nulls; /* NULL if no nulls */
+	Simple8bRleSerialized *run_lengths;
+	Simple8bRleSerialized *sizes;
+	const char *data;
+	Size data_len;
+} RleCompressedData;
+
+typedef struct RleDecompressionIterator
+{
+	DecompressionIterator base;
+	Simple8bRleDecompressionIterator nulls;
+	Simple8bRleDecompressionIterator run_lengths;
+	Simple8bRleDecompressionIterator sizes;
+	const char *data;
+	uint32 num_data_bytes;
+	uint32 data_offset;
+	DatumDeserializer *deserializer;
+	bool has_nulls;
+
+	/* Value of the current run and how many more rows it covers. */
+	Datum val;
+	uint32 run_remaining;
+} RleDecompressionIterator;
+
+/******************
+ *** Compressor ***
+ ******************/
+
+static void
+rle_compressor_append_datum(Compressor *compressor, Datum val)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = rle_compressor_alloc(extended->element_type);
+
+	rle_compressor_append(extended->internal, val);
+}
+
+static void
+rle_compressor_append_null_value(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	if (extended->internal == NULL)
+		extended->internal = rle_compressor_alloc(extended->element_type);
+
+	rle_compressor_append_null(extended->internal);
+}
+
+static void *
+rle_compressor_finish_and_reset(Compressor *compressor)
+{
+	ExtendedCompressor *extended = (ExtendedCompressor *) compressor;
+	void *compressed = NULL;
+	if (extended != NULL && extended->internal != NULL)
+	{
+		compressed = rle_compressor_finish(extended->internal);
+		pfree(extended->internal);
+		extended->internal = NULL;
+	}
+	return compressed;
+}
+
+const Compressor rle_compressor = {
+	.append_val = rle_compressor_append_datum,
+	.append_null = rle_compressor_append_null_value,
+	.is_full = NULL,
+	.finish = rle_compressor_finish_and_reset,
+};
+
+Compressor *
+rle_compressor_for_type(Oid element_type)
+{
+	ExtendedCompressor *compressor = palloc(sizeof(*compressor));
+	*compressor = (ExtendedCompressor){
+		.base = rle_compressor,
+		.element_type = element_type,
+	};
+	return &compressor->base;
+}
+
+RleCompressor *
+rle_compressor_alloc(Oid type_to_compress)
+{
+	RleCompressor *compressor = palloc0(sizeof(*compressor));
+
+	simple8brle_compressor_init(&compressor->nulls);
+	simple8brle_compressor_init(&compressor->run_lengths);
+	simple8brle_compressor_init(&compressor->sizes);
+	char_vec_init(&compressor->data, CurrentMemoryContext, 0);
+
+	compressor->type = type_to_compress;
+	get_typlenbyval(type_to_compress, &compressor->typlen, &compressor->typbyval);
+	compressor->serializer = create_datum_serializer(type_to_compress);
+	return compressor;
+}
+
+void
+rle_compressor_append_null(RleCompressor *compressor)
+{
+	compressor->has_nulls = true;
+	simple8brle_compressor_append(&compressor->nulls, 1);
+}
+
+static void
+rle_compressor_flush_run(RleCompressor *compressor)
+{
+	if (!compressor->has_run)
+		return;
+
+	simple8brle_compressor_append(&compressor->run_lengths, compressor->run_count);
+	if (!compressor->typbyval)
+		pfree(DatumGetPointer(compressor->run_value));
+	compressor->has_run = false;
+	compressor->run_count = 0;
+}
+
+void
+rle_compressor_append(RleCompressor *compressor, Datum val)
+{
+	Size datum_size_and_align;
+	char *start_ptr;
+
+	simple8brle_compressor_append(&compressor->nulls, 0);
+	if (datum_serializer_value_may_be_toasted(compressor->serializer))
+		val = PointerGetDatum(PG_DETOAST_DATUM_PACKED(val));
+
+	compressor->num_values++;
+
+	if (compressor->has_run &&
+		datumIsEqual(compressor->run_value, val, compressor->typbyval, compressor->typlen))
+	{
+		compressor->run_count++;
+		return;
+	}
+
+	rle_compressor_flush_run(compressor);
+
+	/* Start a new run: serialize its value, just like array does */
+	datum_size_and_align =
+		datum_get_bytes_size(compressor->serializer, compressor->data.num_elements, val) -
+		compressor->data.num_elements;
+
+	simple8brle_compressor_append(&compressor->sizes, datum_size_and_align);
+
+	/* datum_to_bytes_and_advance will zero any padding bytes, so we need not do so here */
+	char_vec_reserve(&compressor->data, datum_size_and_align);
+	start_ptr = compressor->data.data + compressor->data.num_elements;
+	compressor->data.num_elements += datum_size_and_align;
+
+	datum_to_bytes_and_advance(compressor->serializer, start_ptr, &datum_size_and_align, val);
+	Assert(datum_size_and_align == 0);
+
+	/* Keep a copy for the equality check; the caller's datum may not survive */
+	compressor->run_value = datumCopy(val, compressor->typbyval, compressor->typlen);
+	compressor->has_run = true;
+	compressor->run_count = 1;
+	compressor->num_runs++;
+}
+
+/*
+ * Recompress the finished blob with the algorithm the default path would have
+ * chosen for this type. Used when the data turned out to have too few repeats
+ * for run-length encoding to pay off.
+ */
+static void *
+rle_compressor_recompress(Oid element_type, void *compressed)
+{
+	TypeCacheEntry *tentry =
+		lookup_type_cache(element_type, TYPECACHE_EQ_OPR_FINFO | TYPECACHE_HASH_PROC_FINFO);
+	Compressor *fallback;
+	DecompressionIterator *iter;
+
+	if (tentry->hash_proc_finfo.fn_addr == NULL || tentry->eq_opr_finfo.fn_addr == NULL)
+		fallback = array_compressor_for_type(element_type);
+	else
+		fallback = dictionary_compressor_for_type(element_type);
+
+	iter = rle_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), element_type);
+	for (DecompressResult r = rle_decompression_iterator_try_next_forward(iter); !r.is_done;
+		 r = rle_decompression_iterator_try_next_forward(iter))
+	{
+		if (r.is_null)
+			fallback->append_null(fallback);
+		else
+			fallback->append_val(fallback, r.val);
+	}
+	pfree(iter);
+
+	return fallback->finish(fallback);
+}
+
+static void *
+rle_compressor_finish_internal(RleCompressor *compressor, bool allow_recompress)
+{
+	Simple8bRleSerialized *nulls;
+	Simple8bRleSerialized *run_lengths;
+	Simple8bRleSerialized *sizes;
+	Size compressed_size;
+	char *compressed_data;
+	RleCompressed *compressed;
+
+	rle_compressor_flush_run(compressor);
+
+	if (compressor->num_values == 0)
+		return NULL;
+
+	nulls = compressor->has_nulls ? simple8brle_compressor_finish(&compressor->nulls) : NULL;
+	run_lengths = simple8brle_compressor_finish(&compressor->run_lengths);
+	sizes = simple8brle_compressor_finish(&compressor->sizes);
+	Assert(run_lengths != NULL && sizes != NULL);
+	Assert(run_lengths->num_elements == compressor->num_runs);
+
+	compressed_size = sizeof(RleCompressed);
+	if (nulls != NULL)
+		compressed_size += simple8brle_serialized_total_size(nulls);
+	compressed_size += simple8brle_serialized_total_size(run_lengths);
+	compressed_size += simple8brle_serialized_total_size(sizes);
+	compressed_size += compressor->data.num_elements;
+
+	if (!AllocSizeIsValid(compressed_size))
+		ereport(ERROR,
+				(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+				 errmsg("compressed size exceeds the maximum allowed (%d)", (int) MaxAllocSize)));
+
+	compressed_data = palloc0(compressed_size);
+	compressed = (RleCompressed *) compressed_data;
+	*compressed = (RleCompressed){
+		.compression_algorithm = COMPRESSION_ALGORITHM_RLE,
+		.has_nulls = nulls != NULL,
+		.element_type = compressor->type,
+	};
+	SET_VARSIZE(compressed->vl_len_, compressed_size);
+
+	compressed_data += sizeof(RleCompressed);
+	if (nulls != NULL)
+		compressed_data = bytes_serialize_simple8b_and_advance(compressed_data,
+															   simple8brle_serialized_total_size(
+																   nulls),
+															   nulls);
+	compressed_data =
+		bytes_serialize_simple8b_and_advance(compressed_data,
+											 simple8brle_serialized_total_size(run_lengths),
+											 run_lengths);
+	compressed_data = bytes_serialize_simple8b_and_advance(compressed_data,
+														   simple8brle_serialized_total_size(sizes),
+														   sizes);
+	memcpy(compressed_data, compressor->data.data, compressor->data.num_elements);
+
+	/*
+	 * If nearly every value started its own run, this is high-churn data and
+	 * the dictionary or array algorithm will do better. Like the uuid
+	 * algorithm's dictionary fallback, recompress and keep whichever is
+	 * smaller.
+	 */
+	if (allow_recompress &&
+		compressor->num_runs > compressor->num_values * RLE_FALLBACK_RUN_FRACTION)
+	{
+		void *recompressed = rle_compressor_recompress(compressor->type, compressed);
+		if (recompressed != NULL && VARSIZE(recompressed) < VARSIZE(compressed))
+		{
+			pfree(compressed);
+			return recompressed;
+		}
+		if (recompressed != NULL)
+			pfree(recompressed);
+	}
+
+	return compressed;
+}
+
+void *
+rle_compressor_finish(RleCompressor *compressor)
+{
+	if (compressor == NULL)
+		return NULL;
+
+	return rle_compressor_finish_internal(compressor, true);
+}
+
+bool
+rle_compressed_has_nulls(const CompressedDataHeader *header)
+{
+	const RleCompressed *rc = (const RleCompressed *) header;
+	return rc->has_nulls;
+}
+
+/******************
+ *** Decompress ***
+ ******************/
+
+static RleCompressedData
+rle_compressed_data_from_bytes(StringInfo serialized_data, Oid element_type, bool has_nulls)
+{
+	RleCompressedData data = { .element_type = element_type };
+
+	if (has_nulls)
+	{
+		data.nulls = bytes_deserialize_simple8b_and_advance(serialized_data);
+	}
+
+	data.run_lengths = bytes_deserialize_simple8b_and_advance(serialized_data);
+	data.sizes = bytes_deserialize_simple8b_and_advance(serialized_data);
+
+	data.data = serialized_data->data + serialized_data->cursor;
+	data.data_len = serialized_data->len - serialized_data->cursor;
+
+	return data;
+}
+
+static void
+rle_decompression_iterator_init(RleDecompressionIterator *iterator, void *compressed,
+								Oid element_type, bool forward)
+{
+	StringInfoData si = { .data = compressed, .len = VARSIZE(compressed) };
+	RleCompressed *header = consumeCompressedData(&si, sizeof(RleCompressed));
+	RleCompressedData data;
+
+	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_RLE);
+	CheckCompressedData(element_type == header->element_type);
+
+	data = rle_compressed_data_from_bytes(&si, header->element_type, header->has_nulls == 1);
+
+	*iterator = (RleDecompressionIterator){
+		.base = { .compression_algorithm = COMPRESSION_ALGORITHM_RLE,
+				  .forward = forward,
+				  .element_type = element_type,
+				  .try_next = (forward ? rle_decompression_iterator_try_next_forward :
+									   rle_decompression_iterator_try_next_reverse) },
+		.has_nulls = data.nulls != NULL,
+		.data = data.data,
+		.num_data_bytes = data.data_len,
+		.data_offset = forward ? 0 : data.data_len,
+		.deserializer = create_datum_deserializer(element_type),
+	};
+
+	if (forward)
+	{
+		if (iterator->has_nulls)
+			simple8brle_decompression_iterator_init_forward(&iterator->nulls, data.nulls);
+		simple8brle_decompression_iterator_init_forward(&iterator->run_lengths, data.run_lengths);
+		simple8brle_decompression_iterator_init_forward(&iterator->sizes, data.sizes);
+	}
+	else
+	{
+		if (iterator->has_nulls)
+			simple8brle_decompression_iterator_init_reverse(&iterator->nulls, data.nulls);
+		simple8brle_decompression_iterator_init_reverse(&iterator->run_lengths, data.run_lengths);
+		simple8brle_decompression_iterator_init_reverse(&iterator->sizes, data.sizes);
+	}
+}
+
+DecompressionIterator *
+rle_decompression_iterator_from_datum_forward(Datum rle_compressed, Oid element_type)
+{
+	RleDecompressionIterator *iterator = palloc(sizeof(*iterator));
+	CheckCompressedData(DatumGetPointer(rle_compressed) != NULL);
+	rle_decompression_iterator_init(iterator,
+									(void *) PG_DETOAST_DATUM(rle_compressed),
+									element_type,
+									true);
+	return &iterator->base;
+}
+
+DecompressResult
+rle_decompression_iterator_try_next_forward(DecompressionIterator *general_iter)
+{
+	RleDecompressionIterator *iter;
+
+	Assert(general_iter->compression_algorithm == COMPRESSION_ALGORITHM_RLE &&
+		   general_iter->forward);
+	iter = (RleDecompressionIterator *) general_iter;
+
+	if (iter->has_nulls)
+	{
+		Simple8bRleDecompressResult null =
+			simple8brle_decompression_iterator_try_next_forward(&iter->nulls);
+		if (null.is_done)
+			return (DecompressResult){
+				.is_done = true,
+			};
+
+		if ((null.val & 1) != 0)
+		{
+			return (DecompressResult){
+				.is_null = true,
+			};
+		}
+	}
+
+	if (iter->run_remaining == 0)
+	{
+		Simple8bRleDecompressResult run_length =
+			simple8brle_decompression_iterator_try_next_forward(&iter->run_lengths);
+		Simple8bRleDecompressResult datum_size;
+		const char *start_pointer;
+
+		if (run_length.is_done)
+		{
+			/* With nulls the row count is governed by the nulls bitmap, so
+			 * running out of runs on a non-null row means corrupt data.
+			 */
+			CheckCompressedData(!iter->has_nulls);
+			return (DecompressResult){
+				.is_done = true,
+			};
+		}
+		CheckCompressedData(run_length.val > 0);
+		CheckCompressedData(run_length.val <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+		datum_size = simple8brle_decompression_iterator_try_next_forward(&iter->sizes);
+		CheckCompressedData(!datum_size.is_done);
+		CheckCompressedData(iter->data_offset + datum_size.val <= iter->num_data_bytes);
+
+		start_pointer = iter->data + iter->data_offset;
+		iter->val = bytes_to_datum_and_advance(iter->deserializer, &start_pointer);
+		iter->data_offset += datum_size.val;
+		CheckCompressedData(iter->data + iter->data_offset == start_pointer);
+
+		iter->run_remaining = run_length.val;
+	}
+
+	iter->run_remaining--;
+	return (DecompressResult){
+		.val = iter->val,
+	};
+}
+
+/**************************
+ *** Decompress Reverse ***
+ **************************/
+
+DecompressionIterator *
+rle_decompression_iterator_from_datum_reverse(Datum rle_compressed, Oid element_type)
+{
+	RleDecompressionIterator *iterator = palloc(sizeof(*iterator));
+	CheckCompressedData(DatumGetPointer(rle_compressed) != NULL);
+	rle_decompression_iterator_init(iterator,
+									(void *) PG_DETOAST_DATUM(rle_compressed),
+									element_type,
+									false);
+	return &iterator->base;
+}
+
+DecompressResult
+rle_decompression_iterator_try_next_reverse(DecompressionIterator *general_iter)
+{
+	RleDecompressionIterator *iter;
+
+	Assert(general_iter->compression_algorithm == COMPRESSION_ALGORITHM_RLE &&
+		   !general_iter->forward);
+	iter = (RleDecompressionIterator *) general_iter;
+
+	if (iter->has_nulls)
+	{
+		Simple8bRleDecompressResult null =
+			simple8brle_decompression_iterator_try_next_reverse(&iter->nulls);
+		if (null.is_done)
+			return (DecompressResult){
+				.is_done = true,
+			};
+
+		if ((null.val & 1) != 0)
+		{
+			return (DecompressResult){
+				.is_null = true,
+			};
+		}
+	}
+
+	if (iter->run_remaining == 0)
+	{
+		Simple8bRleDecompressResult run_length =
+			simple8brle_decompression_iterator_try_next_reverse(&iter->run_lengths);
+		Simple8bRleDecompressResult datum_size;
+		const char *start_pointer;
+
+		if (run_length.is_done)
+		{
+			CheckCompressedData(!iter->has_nulls);
+			return (DecompressResult){
+				.is_done = true,
+			};
+		}
+		CheckCompressedData(run_length.val > 0);
+		CheckCompressedData(run_length.val <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+		datum_size = simple8brle_decompression_iterator_try_next_reverse(&iter->sizes);
+		CheckCompressedData(!datum_size.is_done);
+		CheckCompressedData(datum_size.val <= iter->data_offset);
+
+		iter->data_offset -= datum_size.val;
+		start_pointer = iter->data + iter->data_offset;
+		iter->val = bytes_to_datum_and_advance(iter->deserializer, &start_pointer);
+
+		iter->run_remaining = run_length.val;
+	}
+
+	iter->run_remaining--;
+	return (DecompressResult){
+		.val = iter->val,
+	};
+}
+
+/**********************
+ *** Decompress all ***
+ **********************/
+
+/*
+ * Bulk decompression is only implemented for fixed-width by-value types,
+ * which can be emitted as a plain Arrow values buffer. This notably covers
+ * enums, which are common for the low-churn columns this algorithm targets.
+ * Bool is excluded because its Arrow representation is a bitmap.
+ */
+bool
+rle_decompress_all_possible(Oid element_type)
+{
+	int16 typlen;
+	bool typbyval;
+
+	if (element_type == BOOLOID)
+		return false;
+
+	get_typlenbyval(element_type, &typlen, &typbyval);
+	return typbyval && (typlen == 2 || typlen == 4 || typlen == 8);
+}
+
+ArrowArray *
+rle_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
+{
+	int16 typlen;
+	bool typbyval;
+
+	CheckCompressedData(DatumGetPointer(compressed) != NULL);
+
+	get_typlenbyval(element_type, &typlen, &typbyval);
+	if (!typbyval || (typlen != 2 && typlen != 4 && typlen != 8))
+		elog(ERROR, "unsupported rle type %u for bulk decompression", element_type);
+
+	void *detoasted = PG_DETOAST_DATUM(compressed);
+	StringInfoData si = { .data = detoasted, .len = VARSIZE(detoasted) };
+	RleCompressed *header = consumeCompressedData(&si, sizeof(RleCompressed));
+
+	CheckCompressedData(header->compression_algorithm == COMPRESSION_ALGORITHM_RLE);
+	CheckCompressedData(header->element_type == element_type);
+
+	RleCompressedData data =
+		rle_compressed_data_from_bytes(&si, header->element_type, header->has_nulls == 1);
+
+	/* Sum the run lengths to get the number of non-null rows, O(runs) */
+	Simple8bRleDecompressionIterator run_lengths;
+	uint64 n_notnull = 0;
+	simple8brle_decompression_iterator_init_forward(&run_lengths, data.run_lengths);
+	for (Simple8bRleDecompressResult run =
+			 simple8brle_decompression_iterator_try_next_forward(&run_lengths);
+		 !run.is_done;
+		 run = simple8brle_decompression_iterator_try_next_forward(&run_lengths))
+	{
+		CheckCompressedData(run.val > 0);
+		n_notnull += run.val;
+	}
+	CheckCompressedData(n_notnull > 0);
+	CheckCompressedData(n_notnull <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+	const uint32 n_total = data.nulls != NULL ? data.nulls->num_elements : (uint32) n_notnull;
+	CheckCompressedData(n_total >= n_notnull);
+	CheckCompressedData(n_total <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+
+	uint8 *restrict values =
+		MemoryContextAllocZero(dest_mctx, pad_to_multiple(64, n_total * typlen));
+
+	MemoryContext old_context = MemoryContextSwitchTo(dest_mctx);
+	Simple8bRleBitArray validity_bits =
+		simple8brle_bitarray_decompress(data.nulls, /* inverted = */ true);
+	MemoryContextSwitchTo(old_context);
+	const uint64 *restrict validity_bitmap = validity_bits.data;
+
+	/* Expand the runs into the values buffer */
+	Simple8bRleDecompressionIterator sizes;
+	DatumDeserializer *deserializer = create_datum_deserializer(element_type);
+	simple8brle_decompression_iterator_init_forward(&run_lengths, data.run_lengths);
+	simple8brle_decompression_iterator_init_forward(&sizes, data.sizes);
+
+	uint32 data_offset = 0;
+	uint32 run_remaining = 0;
+	Datum val = 0;
+	for (uint32 i = 0; i < n_total; i++)
+	{
+		if (!arrow_row_is_valid(validity_bitmap, i))
+			continue;
+
+		if (run_remaining == 0)
+		{
+			Simple8bRleDecompressResult run =
+				simple8brle_decompression_iterator_try_next_forward(&run_lengths);
+			Simple8bRleDecompressResult datum_size =
+				simple8brle_decompression_iterator_try_next_forward(&sizes);
+			const char *start_pointer;
+
+			CheckCompressedData(!run.is_done && !datum_size.is_done);
+			CheckCompressedData(data_offset + datum_size.val <= data.data_len);
+
+			start_pointer = data.data + data_offset;
+			val = bytes_to_datum_and_advance(deserializer, &start_pointer);
+			data_offset += datum_size.val;
+
+			run_remaining = run.val;
+		}
+		run_remaining--;
+
+		switch (typlen)
+		{
+			case 2:
+				((uint16 *) values)[i] = DatumGetUInt16(val);
+				break;
+			case 4:
+				((uint32 *) values)[i] = DatumGetUInt32(val);
+				break;
+			case 8:
+				((uint64 *) values)[i] = DatumGetUInt64(val);
+				break;
+		}
+	}
+
+	ArrowArray *result =
+		MemoryContextAllocZero(dest_mctx, sizeof(ArrowArray) + (sizeof(void *) * 2));
+	const void **buffers = (const void **) &result[1];
+	buffers[0] = validity_bitmap;
+	buffers[1] = values;
+	result->n_buffers = 2;
+	result->buffers = buffers;
+	result->length = n_total;
+	result->null_count = n_total - n_notnull;
+	return result;
+}
+
+/*********************
+ ***  send / recv  ***
+ *********************/
+
+void
+rle_compressed_send(CompressedDataHeader *header, StringInfo buffer)
+{
+	const RleCompressed *compressed = (RleCompressed *) header;
+	Assert(header->compression_algorithm == COMPRESSION_ALGORITHM_RLE);
+
+	DatumSerializer *serializer = create_datum_serializer(compressed->element_type);
+	BinaryStringEncoding encoding = datum_serializer_binary_string_encoding(serializer);
+	DatumDeserializer *deserializer = create_datum_deserializer(compressed->element_type);
+
+	StringInfoData si = { .data = (char *) compressed, .len = VARSIZE(compressed) };
+	consumeCompressedData(&si, sizeof(RleCompressed));
+	RleCompressedData data =
+		rle_compressed_data_from_bytes(&si, compressed->element_type, compressed->has_nulls == 1);
+
+	pq_sendbyte(buffer, compressed->has_nulls);
+	type_append_to_binary_string(compressed->element_type, buffer);
+	if (data.nulls != NULL)
+		simple8brle_serialized_send(buffer, data.nulls);
+	simple8brle_serialized_send(buffer, data.run_lengths);
+
+	pq_sendbyte(buffer, encoding == BINARY_ENCODING);
+
+	/* One value per run; the sizes need not survive the roundtrip and are
+	 * recalculated on recv, like in the array algorithm.
+	 */
+	pq_sendint32(buffer, data.sizes->num_elements);
+
+	Simple8bRleDecompressionIterator sizes;
+	simple8brle_decompression_iterator_init_forward(&sizes, data.sizes);
+	uint32 data_offset = 0;
+	for (Simple8bRleDecompressResult datum_size =
+			 simple8brle_decompression_iterator_try_next_forward(&sizes);
+		 !datum_size.is_done;
+		 datum_size = simple8brle_decompression_iterator_try_next_forward(&sizes))
+	{
+		const char *start_pointer = data.data + data_offset;
+		Datum val = bytes_to_datum_and_advance(deserializer, &start_pointer);
+		data_offset += datum_size.val;
+		datum_append_to_binary_string(serializer, encoding, buffer, val);
+	}
+}
+
+Datum
+rle_compressed_recv(StringInfo buffer)
+{
+	Simple8bRleDecompressionIterator nulls;
+	Simple8bRleDecompressionIterator run_lengths;
+
+	uint8 has_nulls = pq_getmsgbyte(buffer);
+	CheckCompressedData(has_nulls == 0 || has_nulls == 1);
+
+	Oid element_type = binary_string_get_type(buffer);
+
+	if (has_nulls)
+		simple8brle_decompression_iterator_init_forward(&nulls,
+														simple8brle_serialized_recv(buffer));
+	simple8brle_decompression_iterator_init_forward(&run_lengths,
+													simple8brle_serialized_recv(buffer));
+
+	BinaryStringEncoding encoding =
+		pq_getmsgbyte(buffer) != 0 ? BINARY_ENCODING : TEXT_ENCODING;
+	uint32 num_runs = pq_getmsgint32(buffer);
+	CheckCompressedData(num_runs > 0);
+	CheckCompressedData(num_runs <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+	CheckCompressedData(num_runs == run_lengths.num_elements);
+
+	DatumDeserializer *deserializer = create_datum_deserializer(element_type);
+	RleCompressor *compressor = rle_compressor_alloc(element_type);
+
+	/* Replay the rows through the compressor; equal consecutive values
+	 * re-form the same runs.
+	 */
+	uint32 runs_consumed = 0;
+	uint32 run_remaining = 0;
+	Datum val = 0;
+	for (;;)
+	{
+		if (has_nulls)
+		{
+			Simple8bRleDecompressResult null =
+				simple8brle_decompression_iterator_try_next_forward(&nulls);
+			if (null.is_done)
+				break;
+			if (null.val != 0)
+			{
+				rle_compressor_append_null(compressor);
+				continue;
+			}
+		}
+		else if (run_remaining == 0 && runs_consumed == num_runs)
+			break;
+
+		if (run_remaining == 0)
+		{
+			Simple8bRleDecompressResult run_length =
+				simple8brle_decompression_iterator_try_next_forward(&run_lengths);
+			CheckCompressedData(!run_length.is_done);
+			CheckCompressedData(run_length.val > 0);
+			CheckCompressedData(run_length.val <= GLOBAL_MAX_ROWS_PER_COMPRESSION);
+			val = binary_string_to_datum(deserializer, encoding, buffer);
+			run_remaining = run_length.val;
+			runs_consumed++;
+		}
+		run_remaining--;
+
+		rle_compressor_append(compressor, val);
+	}
+	CheckCompressedData(run_remaining == 0);
+	CheckCompressedData(runs_consumed == num_runs);
+
+	/* Don't fall back to another algorithm here; the received data must stay
+	 * an rle blob, since the caller dispatched on the algorithm.
+	 */
+	void *compressed = rle_compressor_finish_internal(compressor, false);
+	CheckCompressedData(compressed != NULL);
+
+	PG_RETURN_POINTER(compressed);
+}
+
+/*
+ * Cross-module functions for the rle algorithm.
+ */
+extern Datum
+tsl_rle_compressor_append(PG_FUNCTION_ARGS)
+{
+	RleCompressor *compressor = (RleCompressor *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+	MemoryContext agg_context;
+	MemoryContext old_context;
+
+	if (!AggCheckCallContext(fcinfo, &agg_context))
+	{
+		/* cannot be called directly because of internal-type argument */
+		elog(ERROR, "tsl_rle_compressor_append called in non-aggregate context");
+	}
+
+	old_context = MemoryContextSwitchTo(agg_context);
+
+	if (compressor == NULL)
+	{
+		Oid type_to_compress = get_fn_expr_argtype(fcinfo->flinfo, 1);
+		compressor = rle_compressor_alloc(type_to_compress);
+	}
+	if (PG_ARGISNULL(1))
+		rle_compressor_append_null(compressor);
+	else
+		rle_compressor_append(compressor, PG_GETARG_DATUM(1));
+
+	MemoryContextSwitchTo(old_context);
+	PG_RETURN_POINTER(compressor);
+}
+
+extern Datum
+tsl_rle_compressor_finish(PG_FUNCTION_ARGS)
+{
+	RleCompressor *compressor = (RleCompressor *) (PG_ARGISNULL(0) ? NULL : PG_GETARG_POINTER(0));
+	void *compressed;
+	if (compressor == NULL)
+		PG_RETURN_NULL();
+
+	compressed = rle_compressor_finish(compressor);
+	if (compressed == NULL)
+		PG_RETURN_NULL();
+
+	PG_RETURN_POINTER(compressed);
+}
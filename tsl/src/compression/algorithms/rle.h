@@ -0,0 +1,81 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+/*
+ * rle is a run-length encoding for columns of any type that change rarely
+ * from row to row (status flags, versions, region labels and the like). A
+ * run of consecutive equal non-null values is stored once, together with
+ * its repeat count. Nulls are tracked in a separate bitmap and do not break
+ * runs, so a constant column with scattered nulls still compresses to a
+ * single run.
+ *
+ * The compressed layout is:
+ *     uint8 has_nulls: 1 iff this has a nulls bitmap stored before the data
+ *     Oid element_type: the element stored by this column
+ *     simple8b_rle nulls: optional bitmap of nulls within the column
+ *     simple8b_rle run_lengths: the repeat count of each run
+ *     simple8b_rle sizes: the serialized size of each run's value
+ *     char data[]: the value of each run, serialized like in array
+ */
+
+#include <postgres.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+
+#include "compression/compression.h"
+
+typedef struct RleCompressor RleCompressor;
+typedef struct RleCompressed RleCompressed;
+typedef struct RleDecompressionIterator RleDecompressionIterator;
+
+/*
+ * Compressor framework functions and definitions for the rle algorithm.
+ */
+
+extern RleCompressor *rle_compressor_alloc(Oid type_to_compress);
+extern void rle_compressor_append_null(RleCompressor *compressor);
+extern void rle_compressor_append(RleCompressor *compressor, Datum val);
+extern void *rle_compressor_finish(RleCompressor *compressor);
+extern bool rle_compressed_has_nulls(const CompressedDataHeader *header);
+
+/* Whether rle_decompress_all can produce an ArrowArray for the given type */
+extern bool rle_decompress_all_possible(Oid element_type);
+
+extern DecompressResult rle_decompression_iterator_try_next_forward(DecompressionIterator *iter);
+
+extern DecompressionIterator *rle_decompression_iterator_from_datum_forward(Datum rle_compressed,
+																			Oid element_type);
+
+extern DecompressResult rle_decompression_iterator_try_next_reverse(DecompressionIterator *iter);
+
+extern DecompressionIterator *rle_decompression_iterator_from_datum_reverse(Datum rle_compressed,
+																			Oid element_type);
+
+extern void rle_compressed_send(CompressedDataHeader *header, StringInfo buffer);
+
+extern Datum rle_compressed_recv(StringInfo buffer);
+
+extern ArrowArray *rle_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx);
+
+extern Compressor *rle_compressor_for_type(Oid element_type);
+
+#define RLE_COMPRESS_ALGORITHM_DEFINITION                                                          \
+	{                                                                                              \
+		.iterator_init_forward = rle_decompression_iterator_from_datum_forward,                    \
+		.iterator_init_reverse = rle_decompression_iterator_from_datum_reverse,                    \
+		.decompress_all = rle_decompress_all, .compressed_data_send = rle_compressed_send,         \
+		.compressed_data_recv = rle_compressed_recv,                                               \
+		.compressor_for_type = rle_compressor_for_type,                                            \
+		.compressed_data_storage = TOAST_STORAGE_EXTENDED,                                         \
+	}
+
+/*
+ * Cross-module functions for the rle algorithm.
+ */
+
+extern Datum tsl_rle_compressor_append(PG_FUNCTION_ARGS);
+extern Datum tsl_rle_compressor_finish(PG_FUNCTION_ARGS);
@@ -167,6 +167,8 @@ simple8brle_compressor_finish(Simple8bRleCompressor *compressor);
 static inline char *simple8brle_compressor_finish_into(Simple8bRleCompressor *compressor,
 													   char *dest, size_t expected_size);
 static inline void simple8brle_compressor_append(Simple8bRleCompressor *compressor, uint64 val);
+static inline void simple8brle_compressor_append_repeated(Simple8bRleCompressor *compressor,
+														  uint64 val, uint32 repcount);
 static inline bool simple8brle_compressor_is_empty(Simple8bRleCompressor *compressor);
 
 static inline void
@@ -689,6 +691,49 @@ simple8brle_compressor_append(Simple8bRleCompressor *compressor, uint64 val)
 	compressor->last_value = val;
 }
 
+/*
+ * Append a run of `repcount` identical values in one go. This extends the RLE
+ * buffer entry directly instead of going through the per-element append, so
+ * appending a long run costs the same as appending a single element.
+ */
+static void
+simple8brle_compressor_append_repeated(Simple8bRleCompressor *compressor, uint64 val,
+									   uint32 repcount)
+{
+	Assert(compressor != NULL);
+
+	if (repcount == 0)
+		return;
+
+	if (unlikely(compressor->num_buffered_elements >= SIMPLE8B_MAX_BUFFERED))
+	{
+		simple8brle_compressor_partial_flush(compressor);
+	}
+
+	uint32 num_buffered = compressor->num_buffered_elements;
+
+	if (likely(num_buffered > 0) && likely(compressor->last_value == val))
+	{
+		Simple8bRleBuffer *restrict last_entry = &compressor->uncompressed_buffer[num_buffered - 1];
+
+		if (likely(val == last_entry->data))
+		{
+			last_entry->repcount += repcount;
+			compressor->num_elements += repcount;
+			return;
+		}
+	}
+
+	Simple8bRleBuffer *restrict new_entry = &compressor->uncompressed_buffer[num_buffered];
+
+	new_entry->data = val;
+	new_entry->repcount = repcount;
+
+	compressor->num_buffered_elements = num_buffered + 1;
+	compressor->num_elements += repcount;
+	compressor->last_value = val;
+}
+
 static bool
 simple8brle_compressor_is_empty(Simple8bRleCompressor *compressor)
 {
@@ -260,22 +260,15 @@ simple8brle_bitmap_decompress(Simple8bRleSerialized *compressed)
 
 			CheckCompressedData(decompressed_index + n_block_values <= num_elements);
 
+			/*
+			 * Fill the entire run with one memset instead of testing the
+			 * repeated value per element.
+			 */
+			memset(&bitmap_bools_[decompressed_index], repeated_value, n_block_values);
 			if (repeated_value)
 			{
-				for (uint32 i = 0; i < n_block_values; i++)
-				{
-					bitmap_bools_[decompressed_index + i] = true;
-				}
-
 				num_ones += n_block_values;
 			}
-			else
-			{
-				for (uint32 i = 0; i < n_block_values; i++)
-				{
-					bitmap_bools_[decompressed_index + i] = false;
-				}
-			}
 
 			decompressed_index += n_block_values;
 			Assert(decompressed_index <= num_elements);
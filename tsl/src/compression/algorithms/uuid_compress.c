@@ -577,7 +577,7 @@ uuid_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
 	CheckCompressedData(DatumGetPointer(compressed) != NULL);
 
 	void *detoasted = PG_DETOAST_DATUM(compressed);
-	StringInfoData si = { .data = detoasted, .len = VARSIZE_ANY(compressed) };
+	StringInfoData si = { .data = detoasted, .len = VARSIZE_ANY(detoasted) };
 	UuidCompressed *header = consumeCompressedData(&si, sizeof(UuidCompressed));
 	char *timestamp_compressed_data = NULL;
 	char *rand_b_and_variant_compressed_data;
@@ -623,8 +623,12 @@ uuid_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
 	CheckCompressedData(timestamp_array->length == total_elements);
 	CheckCompressedData(timestamp_array->null_count == header->num_nulls);
 
-	uint64 *rand_b_and_variant = (uint64 *) palloc(header->rand_b_and_variant_size);
-	memcpy(rand_b_and_variant, rand_b_and_variant_compressed_data, header->rand_b_and_variant_size);
+	/*
+	 * The random half is stored raw, so it can be read in place from the
+	 * compressed buffer. It is not guaranteed to be 8-byte aligned within the
+	 * varlena, hence the memcpy per element below.
+	 */
+	const char *rand_b_and_variant = rand_b_and_variant_compressed_data;
 
 	uint64 *validity_bitmap = NULL;
 	uint64 *timestamp_values = (uint64 *) timestamp_array->buffers[1];
@@ -641,7 +645,9 @@ uuid_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
 			{
 				Assert(value_position < num_values);
 				uuid_buffer[i].components[0] = pg_ntoh64(timestamp_values[i]);
-				uuid_buffer[i].components[1] = rand_b_and_variant[value_position];
+				memcpy(&uuid_buffer[i].components[1],
+					   rand_b_and_variant + value_position * sizeof(uint64),
+					   sizeof(uint64));
 				++value_position;
 			}
 		}
@@ -651,7 +657,9 @@ uuid_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
 		for (int i = 0; i < total_elements; i++)
 		{
 			uuid_buffer[i].components[0] = pg_ntoh64(timestamp_values[i]);
-			uuid_buffer[i].components[1] = rand_b_and_variant[i];
+			memcpy(&uuid_buffer[i].components[1],
+				   rand_b_and_variant + i * sizeof(uint64),
+				   sizeof(uint64));
 		}
 	}
 
@@ -662,7 +670,6 @@ uuid_decompress_all(Datum compressed, Oid element_type, MemoryContext dest_mctx)
 	 * as timestamp_array->buffers[1] , the second buffer in the ArrowArray.
 	 * This will be replaced with the uuid array.
 	 * */
-	pfree(rand_b_and_variant);
 	pfree(timestamp_values);
 	MemoryContextSwitchTo(old_context);
 
@@ -9,6 +9,7 @@
  */
 #include <postgres.h>
 #include <access/tableam.h>
+#include <access/tupconvert.h>
 #include <access/xact.h>
 #include <catalog/dependency.h>
 #include <catalog/index.h>
@@ -17,6 +18,7 @@
 #include <commands/event_trigger.h>
 #include <commands/tablecmds.h>
 #include <commands/trigger.h>
+#include <executor/tuptable.h>
 #include <libpq-fe.h>
 #include <miscadmin.h>
 #include <nodes/makefuncs.h>
@@ -32,6 +34,7 @@
 #include <utils/elog.h>
 #include <utils/fmgrprotos.h>
 #include <utils/inval.h>
+#include <utils/snapmgr.h>
 
 #include "compat/compat.h"
 #include "annotations.h"
@@ -1021,3 +1024,123 @@ tsl_estimate_compressed_batch_size(PG_FUNCTION_ARGS)
 
 	PG_RETURN_FLOAT8(approx_batch_size);
 }
+
+/*
+ * Backfill a columnstore chunk directly from a staging relation.
+ *
+ * The source relation must have the same column layout as the chunk. Its rows
+ * are run straight through the row compressor into the compressed chunk,
+ * bypassing the uncompressed chunk heap entirely, which roughly halves the
+ * I/O of a restore compared to inserting the rows and compressing afterwards.
+ * With sorted = true the input is assumed to already be ordered by the
+ * compression (segmentby, orderby) keys and batches are cut in input order;
+ * otherwise the rows are sorted before the batches are formed.
+ *
+ * Returns the number of rows written to the chunk.
+ */
+Datum
+tsl_backfill_compressed_chunk(PG_FUNCTION_ARGS)
+{
+	Oid chunk_relid = PG_ARGISNULL(0) ? InvalidOid : PG_GETARG_OID(0);
+	Oid source_relid = PG_ARGISNULL(1) ? InvalidOid : PG_GETARG_OID(1);
+	bool sorted = PG_ARGISNULL(2) ? true : PG_GETARG_BOOL(2);
+	Cache *hcache;
+
+	ts_feature_flag_check(FEATURE_HYPERTABLE_COMPRESSION);
+	TS_PREVENT_FUNC_IF_READ_ONLY();
+
+	if (!OidIsValid(chunk_relid) || !OidIsValid(source_relid))
+		ereport(ERROR, (errcode(ERRCODE_INVALID_PARAMETER_VALUE), errmsg("invalid relation OID")));
+
+	Chunk *chunk = ts_chunk_get_by_relid(chunk_relid, true);
+	Hypertable *ht =
+		ts_hypertable_cache_get_cache_and_entry(chunk->hypertable_relid, CACHE_FLAG_NONE, &hcache);
+	ts_hypertable_permissions_check(ht->main_table_relid, GetUserId());
+
+	if (!ts_chunk_is_compressed(chunk) || ts_chunk_is_frozen(chunk))
+		ereport(ERROR,
+				(errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+				 errmsg("chunk \"%s.%s\" is not converted to columnstore or is frozen",
+						NameStr(chunk->fd.schema_name),
+						NameStr(chunk->fd.table_name)),
+				 errhint("Convert the chunk to columnstore before backfilling into it.")));
+
+	/* Lock in the same order as compress_chunk_impl to avoid deadlocks */
+	LockRelationOid(ht->main_table_relid, AccessShareLock);
+	LockRelationOid(chunk->table_id, ExclusiveLock);
+
+	Chunk *compressed_chunk = ts_chunk_get_by_id(chunk->fd.compressed_chunk_id, true);
+	Relation chunk_rel = table_open(chunk->table_id, NoLock);
+	Relation source_rel = table_open(source_relid, AccessShareLock);
+
+	/*
+	 * The source rows have to be converted when the physical layouts differ,
+	 * e.g. because the chunk has dropped columns. This also errors out when
+	 * the source does not match the chunk row type.
+	 */
+	TupleConversionMap *map =
+		convert_tuples_by_name(RelationGetDescr(source_rel), RelationGetDescr(chunk_rel));
+
+	RelationSize source_size = ts_relation_size_impl(source_relid);
+	bool had_batches = ts_table_has_tuples(compressed_chunk->table_id, AccessShareLock);
+
+	BulkWriter *writer = NULL;
+	RowCompressor *compressor =
+		tsl_compressor_init(chunk_rel,
+							&writer,
+							sorted ? COMPRESSOR_INGEST_ORDERED : COMPRESSOR_INGEST_SORT_BATCHES,
+							0 /* flush only at the end */);
+
+	if (ts_continuous_agg_hypertable_status(ht->fd.id) == HypertableIsRawTable)
+		tsl_compressor_set_invalidation(compressor, ht, chunk->table_id);
+
+	TupleTableSlot *slot = table_slot_create(source_rel, NULL);
+	TupleTableSlot *chunk_slot =
+		map ? MakeSingleTupleTableSlot(RelationGetDescr(chunk_rel), &TTSOpsVirtual) : NULL;
+	TableScanDesc scan = table_beginscan(source_rel, GetLatestSnapshot(), 0, NULL);
+	int64 nrows = 0;
+
+	while (table_scan_getnextslot(scan, ForwardScanDirection, slot))
+	{
+		TupleTableSlot *compress_slot =
+			map ? execute_attr_map_slot(map->attrMap, slot, chunk_slot) : slot;
+		tsl_compressor_add_slot(compressor, writer, compress_slot);
+		nrows++;
+	}
+
+	table_endscan(scan);
+	ExecDropSingleTupleTableSlot(slot);
+	if (chunk_slot)
+		ExecDropSingleTupleTableSlot(chunk_slot);
+
+	tsl_compressor_flush(compressor, writer);
+
+	int64 rowcnt_pre_compression = compressor->rowcnt_pre_compression;
+	int64 rowcnt_post_compression = compressor->num_compressed_rows;
+
+	/* Also closes the compressed relation opened by the compressor */
+	tsl_compressor_free(compressor, writer);
+
+	RelationSize compressed_size = ts_relation_size_impl(compressed_chunk->table_id);
+
+	compression_chunk_size_catalog_update_merged(chunk->fd.id,
+												 &source_size,
+												 compressed_chunk->fd.id,
+												 &compressed_size,
+												 rowcnt_pre_compression,
+												 rowcnt_post_compression);
+
+	/*
+	 * The new batches can overlap the batches that were already present in
+	 * the chunk, in which case the chunk-global batch order is no longer
+	 * guaranteed, same as for unsorted direct compressed COPY.
+	 */
+	if (had_batches && nrows > 0 && !ts_chunk_is_unordered(chunk))
+		ts_chunk_set_unordered(chunk);
+
+	table_close(source_rel, NoLock);
+	table_close(chunk_rel, NoLock);
+	ts_cache_release(&hcache);
+
+	PG_RETURN_INT64(nrows);
+}
@@ -12,6 +12,7 @@
 #include "chunk.h"
 
 extern Datum tsl_create_compressed_chunk(PG_FUNCTION_ARGS);
+extern Datum tsl_backfill_compressed_chunk(PG_FUNCTION_ARGS);
 extern Datum tsl_compress_chunk(PG_FUNCTION_ARGS);
 extern Datum tsl_decompress_chunk(PG_FUNCTION_ARGS);
 extern Datum tsl_rebuild_columnstore(PG_FUNCTION_ARGS);
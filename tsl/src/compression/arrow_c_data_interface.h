@@ -170,6 +170,43 @@ arrow_row_both_valid(const uint64 *bitmap1, const uint64 *bitmap2, size_t row_nu
 	return (bitmap1[qword_index] & bitmap2[qword_index]) & mask;
 }
 
+/*
+ * Find the next valid row in the bitmap, starting at and including the given
+ * row. Returns total_rows if there are no more valid rows. This scans word by
+ * word using the count-trailing-zeros instruction instead of testing each bit,
+ * which matters when most of the rows are filtered out. The bits for
+ * past-the-end rows must be zero. A NULL bitmap means all rows are valid.
+ *
+ * The consumers must include <port/pg_bitutils.h> themselves.
+ */
+static inline size_t
+arrow_next_valid_row(const uint64 *bitmap, size_t start_row, size_t total_rows)
+{
+	if (bitmap == NULL)
+	{
+		return start_row;
+	}
+
+	const size_t num_qwords = (total_rows + 63) / 64;
+	size_t qword_index = start_row / 64;
+	uint64 qword = bitmap[qword_index] & (~0ULL << (start_row % 64));
+
+	while (qword == 0)
+	{
+		qword_index++;
+		if (qword_index >= num_qwords)
+		{
+			return total_rows;
+		}
+		qword = bitmap[qword_index];
+	}
+
+	const size_t row = qword_index * 64 + pg_rightmost_one_pos64(qword);
+	Assert(row >= start_row);
+	Assert(row <= total_rows);
+	return row;
+}
+
 static pg_attribute_always_inline void
 arrow_set_row_validity(uint64 *bitmap, size_t row_number, bool value)
 {
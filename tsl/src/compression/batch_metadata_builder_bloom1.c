@@ -416,6 +416,16 @@ typedef struct Bloom1ContainsContext
 	bool element_typbyval;
 	char element_typalign;
 
+	/*
+	 * When the array argument is stable across the rows, which is the typical
+	 * case of an IN-list of constants, the sorted per-item hashes are computed
+	 * once on the first call and reused for all rows, see bloom1_contains_any().
+	 */
+	bool array_arg_is_stable;
+	bool cached_hashes_set;
+	uint64 *cached_hashes;
+	int num_cached_hashes;
+
 	/* This is per-row, here for convenience. */
 	struct varlena *current_row_bloom;
 } Bloom1ContainsContext;
@@ -459,6 +469,11 @@ bloom1_contains_context_prepare(FunctionCallInfo fcinfo, bool use_element_type)
 							 &context->element_typbyval,
 							 &context->element_typalign);
 
+		if (use_element_type)
+		{
+			context->array_arg_is_stable = get_fn_expr_arg_stable(fcinfo->flinfo, 1);
+		}
+
 		fcinfo->flinfo->fn_extra = context;
 	}
 
@@ -504,6 +519,22 @@ bloom1_contains(PG_FUNCTION_ARGS)
 		PG_RETURN_BOOL(false);
 	}
 
+	PG_RETURN_BOOL(bloom1_maybe_contains(context->hash_function_pointer,
+										 context->hash_function_finfo,
+										 bloom,
+										 PG_GETARG_DATUM(1)));
+}
+
+/*
+ * The core of bloom1_contains() that is also callable directly from C code,
+ * e.g. for filtering out compressed batches that cannot contain a tuple that
+ * conflicts with a unique constraint on INSERT. The hash function for the
+ * needle type is looked up with bloom1_get_hash_function().
+ */
+bool
+bloom1_maybe_contains(PGFunction hash_function, FmgrInfo *hash_finfo, struct varlena *bloom,
+					  Datum needle)
+{
 	/*
 	 * Compute the bloom filter parameters.
 	 */
@@ -524,9 +555,7 @@ bloom1_contains(PG_FUNCTION_ARGS)
 	const uint32 word_mask = num_word_bits - 1;
 	Assert((word_mask >> num_word_bits) == 0);
 
-	Datum needle = PG_GETARG_DATUM(1);
-	const uint64 datum_hash_1 =
-		calculate_hash(context->hash_function_pointer, context->hash_function_finfo, needle);
+	const uint64 datum_hash_1 = calculate_hash(hash_function, hash_finfo, needle);
 	const uint32 absolute_mask = num_bits - 1;
 	for (int i = 0; i < BLOOM1_HASHES; i++)
 	{
@@ -535,10 +564,10 @@ bloom1_contains(PG_FUNCTION_ARGS)
 		const uint32 word_bit_index = absolute_bit_index & word_mask;
 		if ((words_buf[word_index] & (1ULL << word_bit_index)) == 0)
 		{
-			PG_RETURN_BOOL(false);
+			return false;
 		}
 	}
-	PG_RETURN_BOOL(true);
+	return true;
 }
 
 #define ST_SORT sort_hashes
@@ -579,50 +608,78 @@ bloom1_contains_any(PG_FUNCTION_ARGS)
 		PG_RETURN_BOOL(false);
 	}
 
-	int num_items;
-	Datum *items;
-	bool *nulls;
-	deconstruct_array(PG_GETARG_ARRAYTYPE_P(1),
-					  context->element_type,
-					  context->element_typlen,
-					  context->element_typbyval,
-					  context->element_typalign,
-					  &items,
-					  &nulls,
-					  &num_items);
-
-	if (num_items == 0)
+	/*
+	 * Compute the sorted per-item base hashes, or reuse the cached ones if the
+	 * array argument is stable across the rows. This function is called for
+	 * every compressed row, and hashing the entire IN-list anew for each row
+	 * would dwarf the cost of the actual probing.
+	 */
+	uint64 *item_base_hashes;
+	int valid;
+	if (context->cached_hashes_set)
 	{
-		PG_RETURN_BOOL(false);
+		item_base_hashes = context->cached_hashes;
+		valid = context->num_cached_hashes;
 	}
+	else
+	{
+		int num_items;
+		Datum *items;
+		bool *nulls;
+		deconstruct_array(PG_GETARG_ARRAYTYPE_P(1),
+						  context->element_type,
+						  context->element_typlen,
+						  context->element_typbyval,
+						  context->element_typalign,
+						  &items,
+						  &nulls,
+						  &num_items);
 
-	/*
-	 * Calculate the per-item base hashes that will be used for computing the
-	 * individual bloom filter bit offsets. We can reuse the "items" space to
-	 * avoid more allocations, but have to allocate as a fallback on 32-bit
-	 * systems.
-	 */
+		/*
+		 * Calculate the per-item base hashes that will be used for computing
+		 * the individual bloom filter bit offsets. We can reuse the "items"
+		 * space to avoid more allocations, but have to allocate as a fallback
+		 * on 32-bit systems.
+		 */
 #if FLOAT8PASSBYVAL
-	uint64 *item_base_hashes = (uint64 *) items;
+		item_base_hashes = (uint64 *) items;
 #else
-	uint64 *item_base_hashes = palloc(sizeof(uint64) * num_items);
+		item_base_hashes = palloc(sizeof(uint64) * Max(num_items, 1));
 #endif
 
-	FmgrInfo *finfo = context->hash_function_finfo;
-	PGFunction hash_fn = context->hash_function_pointer;
+		FmgrInfo *finfo = context->hash_function_finfo;
+		PGFunction hash_fn = context->hash_function_pointer;
 
-	int valid = 0;
-	for (int i = 0; i < num_items; i++)
-	{
-		if (nulls[i])
+		valid = 0;
+		for (int i = 0; i < num_items; i++)
 		{
-			/*
-			 * A null value cannot match the equality condition.
-			 */
-			continue;
+			if (nulls[i])
+			{
+				/*
+				 * A null value cannot match the equality condition.
+				 */
+				continue;
+			}
+
+			item_base_hashes[valid++] = calculate_hash(hash_fn, finfo, items[i]);
 		}
 
-		item_base_hashes[valid++] = calculate_hash(hash_fn, finfo, items[i]);
+		/*
+		 * Sort the hashes for cache-friendly probing.
+		 */
+		sort_hashes(item_base_hashes, valid);
+
+		if (context->array_arg_is_stable)
+		{
+			if (valid > 0)
+			{
+				context->cached_hashes =
+					MemoryContextAlloc(fcinfo->flinfo->fn_mcxt, sizeof(uint64) * valid);
+				memcpy(context->cached_hashes, item_base_hashes, sizeof(uint64) * valid);
+			}
+			context->num_cached_hashes = valid;
+			context->cached_hashes_set = true;
+		}
 	}
 
 	if (valid == 0)
@@ -633,11 +690,6 @@ bloom1_contains_any(PG_FUNCTION_ARGS)
 		PG_RETURN_BOOL(false);
 	}
 
-	/*
-	 * Sort the hashes for cache-friendly probing.
-	 */
-	sort_hashes(item_base_hashes, valid);
-
 	/*
 	 * Get the bloom filter parameters.
 	 */
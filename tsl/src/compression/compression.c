@@ -13,11 +13,14 @@
 #include <catalog/indexing.h>
 #include <catalog/pg_am.h>
 #include <common/base64.h>
+#include <common/hashfn.h>
 #include <funcapi.h>
 #include <libpq/pqformat.h>
+#include <storage/bufmgr.h>
 #include <storage/predicate.h>
 #include <utils/datum.h>
 #include <utils/elog.h>
+#include <utils/hsearch.h>
 #include <utils/lsyscache.h>
 #include <utils/palloc.h>
 #include <utils/rel.h>
@@ -28,11 +31,14 @@
 #include "compat/compat.h"
 
 #include "algorithms/array.h"
+#include "algorithms/array_zstd.h"
+#include "algorithms/alp.h"
 #include "algorithms/bool_compress.h"
 #include "algorithms/deltadelta.h"
 #include "algorithms/dictionary.h"
 #include "algorithms/gorilla.h"
 #include "algorithms/null.h"
+#include "algorithms/rle.h"
 #include "algorithms/uuid_compress.h"
 #include "batch_metadata_builder.h"
 #include "chunk_insert_state.h"
@@ -58,6 +64,16 @@
 #define COMPRESS_TRUNCATE_LOCK_WAIT_INTERVAL 50 /* ms */
 #define COMPRESS_TRUNCATE_LOCK_TIMEOUT 5000		/* ms */
 
+/* Number of compressed tuples buffered per multi-insert WAL record */
+#define BULK_WRITER_MULTI_INSERT_SLOTS 64
+
+/*
+ * Minimum number of rows in a batch for the adaptive codec trial. Trialing
+ * on fewer rows mostly measures per-blob header overhead instead of how the
+ * algorithms fare on the column's data.
+ */
+#define ADAPTIVE_CODEC_TRIAL_MIN_ROWS 64
+
 StaticAssertDecl(GLOBAL_MAX_ROWS_PER_COMPRESSION >= TARGET_COMPRESSED_BATCH_SIZE,
 				 "max row numbers must be harmonized");
 StaticAssertDecl(GLOBAL_MAX_ROWS_PER_COMPRESSION <= INT16_MAX,
@@ -71,6 +87,9 @@ static const CompressionAlgorithmDefinition definitions[_END_COMPRESSION_ALGORIT
 	[COMPRESSION_ALGORITHM_BOOL] = BOOL_COMPRESS_ALGORITHM_DEFINITION,
 	[COMPRESSION_ALGORITHM_NULL] = NULL_COMPRESS_ALGORITHM_DEFINITION,
 	[COMPRESSION_ALGORITHM_UUID] = UUID_COMPRESS_ALGORITHM_DEFINITION,
+	[COMPRESSION_ALGORITHM_ALP] = ALP_ALGORITHM_DEFINITION,
+	[COMPRESSION_ALGORITHM_ARRAY_ZSTD] = ARRAY_ZSTD_ALGORITHM_DEFINITION,
+	[COMPRESSION_ALGORITHM_RLE] = RLE_COMPRESS_ALGORITHM_DEFINITION,
 };
 
 static NameData compression_algorithm_name[] = {
@@ -82,6 +101,9 @@ static NameData compression_algorithm_name[] = {
 	[COMPRESSION_ALGORITHM_BOOL] = { "BOOL" },
 	[COMPRESSION_ALGORITHM_NULL] = { "NULL" },
 	[COMPRESSION_ALGORITHM_UUID] = { "UUID" },
+	[COMPRESSION_ALGORITHM_ALP] = { "ALP" },
+	[COMPRESSION_ALGORITHM_ARRAY_ZSTD] = { "ARRAY_ZSTD" },
+	[COMPRESSION_ALGORITHM_RLE] = { "RLE" },
 };
 
 Name
@@ -118,14 +140,19 @@ tsl_get_decompress_all_function(CompressionAlgorithm algorithm, Oid type)
 	if (algorithm >= _END_COMPRESSION_ALGORITHMS)
 		elog(ERROR, "invalid compression algorithm %d", algorithm);
 
-	if (type != TEXTOID && type != BOOLOID && type != UUIDOID &&
-		(algorithm == COMPRESSION_ALGORITHM_DICTIONARY || algorithm == COMPRESSION_ALGORITHM_ARRAY))
+	if (type != TEXTOID && type != BOOLOID && type != UUIDOID && type != NUMERICOID &&
+		(algorithm == COMPRESSION_ALGORITHM_DICTIONARY || algorithm == COMPRESSION_ALGORITHM_ARRAY ||
+		 algorithm == COMPRESSION_ALGORITHM_ARRAY_ZSTD))
 	{
 		/* Bulk decompression of array and dictionary is only supported for
-		 * text, bool and uuid */
+		 * text, bool, uuid and numeric */
 		return NULL;
 	}
 
+	/* Bulk decompression of rle is only supported for fixed-width by-value types */
+	if (algorithm == COMPRESSION_ALGORITHM_RLE && !rle_decompress_all_possible(type))
+		return NULL;
+
 	return definitions[algorithm].decompress_all;
 }
 
@@ -308,6 +335,13 @@ compress_chunk(Oid in_table, Oid out_table, int insert_options)
 	Relation out_rel = relation_open(out_table, out_rel_lockmode);
 	BulkWriter writer = bulk_writer_build(out_rel, insert_options);
 
+	/*
+	 * Chunk conversion writes the whole compressed relation in one go and
+	 * never reads back its own pending writes, so the inserts can be grouped
+	 * into multi-inserts to cut down the WAL volume.
+	 */
+	bulk_writer_enable_multi_insert(&writer);
+
 	/* Sanity check we are dealing with relations */
 	Ensure(in_rel->rd_rel->relkind == RELKIND_RELATION, "compress_chunk called on non-relation");
 	Ensure(out_rel->rd_rel->relkind == RELKIND_RELATION, "compress_chunk called on non-relation");
@@ -850,6 +884,7 @@ build_column_map(const CompressionSettings *settings, const TupleDesc in_desc,
 
 			*column = (PerColumn){
 				.compressor = compressor_for_type(attr->atttypid),
+				.typid = attr->atttypid,
 				.metadata_builder = batch_minmax_builder,
 				.segmentby_column_index = -1,
 			};
@@ -884,6 +919,290 @@ check_for_limited_size_compressors(PerColumn *pcolumns, int16 natts)
 	return false;
 }
 
+/*****************************
+ ** per-segment staging     **
+ *****************************/
+
+/*
+ * Staging area for direct compressed ingestion of unordered input
+ * (COMPRESSOR_INGEST_SEGMENT_STAGING).
+ *
+ * Feeding unordered tuples straight into the row compressor cuts a new
+ * compressed batch every time the segmentby key changes, so input that
+ * interleaves rows from many segments degenerates into a stream of tiny
+ * batches. Instead, stage the tuples in a hash table keyed on the segmentby
+ * columns and only release a segment to the row compressor once it has
+ * accumulated a full batch. The staged tuples keep their arrival order within
+ * a segment; the resulting batches can overlap on the orderby columns, which
+ * is why the callers mark chunks written this way as unordered.
+ */
+
+typedef struct SegmentStagingBuffer
+{
+	/* the staged segmentby key, one entry per segmentby column */
+	SegmentInfo **keys;
+	MinimalTuple tuples[TARGET_COMPRESSED_BATCH_SIZE];
+	int nused;
+} SegmentStagingBuffer;
+
+/*
+ * The hash table entry. Keyed on the combined hash of the segmentby datums,
+ * so the list holds more than one buffer only on a hash collision.
+ */
+typedef struct SegmentStagingEntry
+{
+	uint32 hash;
+	List *buffers;
+} SegmentStagingEntry;
+
+typedef struct CompressorSegmentStaging
+{
+	HTAB *entries;
+	/* long-lived context holding the staged tuples and keys */
+	MemoryContext mctx;
+	/* slot used to feed staged tuples to the row compressor */
+	TupleTableSlot *slot;
+	/* offsets of the segmentby columns in the uncompressed tuple */
+	int16 *segmentby_offsets;
+	FmgrInfo *hash_fns;
+	Oid *collations;
+	int n_segmentby;
+	/* total staged tuples over all segments */
+	int total_staged;
+	/* emit the largest segment when total_staged reaches this, 0 for no limit */
+	int staging_limit;
+} CompressorSegmentStaging;
+
+/*
+ * Set up a staging area from the segmentby columns of an initialized row
+ * compressor. Returns NULL when there are no segmentby columns; there is only
+ * a single group then and ordered processing already fills every batch.
+ */
+static CompressorSegmentStaging *
+compressor_segment_staging_create(const RowCompressor *compressor, int staging_limit)
+{
+	CompressorSegmentStaging *staging = palloc0(sizeof(CompressorSegmentStaging));
+
+	staging->segmentby_offsets = palloc(sizeof(int16) * compressor->n_input_columns);
+	staging->hash_fns = palloc(sizeof(FmgrInfo) * compressor->n_input_columns);
+	staging->collations = palloc(sizeof(Oid) * compressor->n_input_columns);
+
+	for (int col = 0; col < compressor->n_input_columns; col++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(compressor->in_desc, col);
+
+		if (compressor->per_column[col].segment_info == NULL)
+			continue;
+
+		TypeCacheEntry *tce = lookup_type_cache(attr->atttypid, TYPECACHE_HASH_PROC_FINFO);
+
+		if (!OidIsValid(tce->hash_proc_finfo.fn_oid))
+			elog(ERROR, "no hash function for column \"%s\"", NameStr(attr->attname));
+
+		staging->segmentby_offsets[staging->n_segmentby] = col;
+		staging->collations[staging->n_segmentby] = attr->attcollation;
+		fmgr_info_copy(&staging->hash_fns[staging->n_segmentby],
+					   &tce->hash_proc_finfo,
+					   CurrentMemoryContext);
+		staging->n_segmentby++;
+	}
+
+	if (staging->n_segmentby == 0)
+	{
+		pfree(staging->segmentby_offsets);
+		pfree(staging->hash_fns);
+		pfree(staging->collations);
+		pfree(staging);
+		return NULL;
+	}
+
+	staging->mctx = AllocSetContextCreate(CurrentMemoryContext,
+										  "compressor segment staging",
+										  ALLOCSET_DEFAULT_SIZES);
+
+	struct HASHCTL hctl = {
+		.keysize = sizeof(uint32),
+		.entrysize = sizeof(SegmentStagingEntry),
+		.hcxt = staging->mctx,
+	};
+	staging->entries = hash_create("compressor segment staging",
+								   64,
+								   &hctl,
+								   HASH_ELEM | HASH_CONTEXT | HASH_BLOBS);
+
+	staging->slot = MakeTupleTableSlot(compressor->in_desc, &TTSOpsMinimalTuple);
+	staging->staging_limit = staging_limit;
+
+	return staging;
+}
+
+/*
+ * Compress one staged segment. All tuples in the buffer share a segmentby
+ * key, so apart from cuts on the batch size limit this produces a single
+ * full compressed batch.
+ */
+static void
+compressor_segment_staging_emit(RowCompressor *compressor, BulkWriter *writer,
+								SegmentStagingBuffer *buffer)
+{
+	CompressorSegmentStaging *staging = compressor->staging;
+
+	for (int i = 0; i < buffer->nused; i++)
+	{
+		/* shouldFree is true so clearing the slot releases the staged copy */
+		ExecStoreMinimalTuple(buffer->tuples[i], staging->slot, true);
+		row_compressor_process_ordered_slot(compressor, staging->slot, writer);
+	}
+
+	if (compressor->rows_compressed_into_current_value > 0)
+		row_compressor_flush(compressor, writer, true);
+
+	/* The flush freed the group keys, re-group on the next emission */
+	row_compressor_reset(compressor);
+
+	staging->total_staged -= buffer->nused;
+	buffer->nused = 0;
+}
+
+/*
+ * Stage a tuple under its segmentby key, emitting its segment when the
+ * segment reaches a full batch. When the staging area as a whole reaches the
+ * staging limit, the largest staged segment is emitted to bound memory use.
+ */
+static void
+compressor_segment_staging_add(RowCompressor *compressor, BulkWriter *writer, TupleTableSlot *slot)
+{
+	CompressorSegmentStaging *staging = compressor->staging;
+	SegmentStagingBuffer *buffer = NULL;
+	uint32 hash = 0;
+	bool found;
+	ListCell *lc;
+
+	slot_getallattrs(slot);
+
+	for (int i = 0; i < staging->n_segmentby; i++)
+	{
+		int16 col = staging->segmentby_offsets[i];
+		uint32 colhash = 0;
+
+		if (!slot->tts_isnull[col])
+			colhash = DatumGetUInt32(FunctionCall1Coll(&staging->hash_fns[i],
+													   staging->collations[i],
+													   slot->tts_values[col]));
+		hash = hash_combine(hash, colhash);
+	}
+
+	SegmentStagingEntry *entry = hash_search(staging->entries, &hash, HASH_ENTER, &found);
+	if (!found)
+		entry->buffers = NIL;
+
+	foreach (lc, entry->buffers)
+	{
+		SegmentStagingBuffer *candidate = lfirst(lc);
+		int i;
+
+		for (i = 0; i < staging->n_segmentby; i++)
+		{
+			int16 col = staging->segmentby_offsets[i];
+			if (!segment_info_datum_is_in_group(candidate->keys[i],
+												slot->tts_values[col],
+												slot->tts_isnull[col]))
+				break;
+		}
+
+		if (i == staging->n_segmentby)
+		{
+			buffer = candidate;
+			break;
+		}
+	}
+
+	MemoryContext oldctx = MemoryContextSwitchTo(staging->mctx);
+
+	if (buffer == NULL)
+	{
+		buffer = palloc0(sizeof(SegmentStagingBuffer));
+		buffer->keys = palloc(sizeof(SegmentInfo *) * staging->n_segmentby);
+
+		for (int i = 0; i < staging->n_segmentby; i++)
+		{
+			int16 col = staging->segmentby_offsets[i];
+			buffer->keys[i] = segment_info_new(TupleDescAttr(compressor->in_desc, col));
+			segment_info_update(buffer->keys[i], slot->tts_values[col], slot->tts_isnull[col]);
+		}
+
+		entry->buffers = lappend(entry->buffers, buffer);
+	}
+
+	buffer->tuples[buffer->nused++] = ExecCopySlotMinimalTuple(slot);
+	MemoryContextSwitchTo(oldctx);
+	staging->total_staged++;
+
+	if (buffer->nused == TARGET_COMPRESSED_BATCH_SIZE)
+	{
+		compressor_segment_staging_emit(compressor, writer, buffer);
+		return;
+	}
+
+	if (staging->staging_limit > 0 && staging->total_staged >= staging->staging_limit)
+	{
+		HASH_SEQ_STATUS status;
+		SegmentStagingEntry *scan_entry;
+		SegmentStagingBuffer *largest = NULL;
+
+		hash_seq_init(&status, staging->entries);
+		for (scan_entry = hash_seq_search(&status); scan_entry != NULL;
+			 scan_entry = hash_seq_search(&status))
+		{
+			foreach (lc, scan_entry->buffers)
+			{
+				SegmentStagingBuffer *candidate = lfirst(lc);
+				if (largest == NULL || candidate->nused > largest->nused)
+					largest = candidate;
+			}
+		}
+
+		Assert(largest != NULL);
+		compressor_segment_staging_emit(compressor, writer, largest);
+	}
+}
+
+/*
+ * Emit everything that is still staged.
+ */
+static void
+compressor_segment_staging_flush(RowCompressor *compressor, BulkWriter *writer)
+{
+	HASH_SEQ_STATUS status;
+	SegmentStagingEntry *entry;
+	ListCell *lc;
+
+	hash_seq_init(&status, compressor->staging->entries);
+	for (entry = hash_seq_search(&status); entry != NULL; entry = hash_seq_search(&status))
+	{
+		foreach (lc, entry->buffers)
+		{
+			SegmentStagingBuffer *buffer = lfirst(lc);
+			if (buffer->nused > 0)
+				compressor_segment_staging_emit(compressor, writer, buffer);
+		}
+	}
+
+	Assert(compressor->staging->total_staged == 0);
+}
+
+static void
+compressor_segment_staging_free(CompressorSegmentStaging *staging)
+{
+	ExecDropSingleTupleTableSlot(staging->slot);
+	/* the hash table and all staged state live in the staging context */
+	MemoryContextDelete(staging->mctx);
+	pfree(staging->segmentby_offsets);
+	pfree(staging->hash_fns);
+	pfree(staging->collations);
+	pfree(staging);
+}
+
 void
 tsl_compressor_set_invalidation(RowCompressor *compressor, Hypertable *ht, Oid chunk_relid)
 {
@@ -900,7 +1219,11 @@ tsl_compressor_set_invalidation(RowCompressor *compressor, Hypertable *ht, Oid c
 void
 tsl_compressor_add_slot(RowCompressor *compressor, BulkWriter *bulk_writer, TupleTableSlot *slot)
 {
-	if (compressor->sort_state)
+	if (compressor->staging)
+	{
+		compressor_segment_staging_add(compressor, bulk_writer, slot);
+	}
+	else if (compressor->sort_state)
 	{
 		tuplesort_puttupleslot(compressor->sort_state, slot);
 		compressor->tuples_to_sort++;
@@ -918,7 +1241,11 @@ tsl_compressor_add_slot(RowCompressor *compressor, BulkWriter *bulk_writer, Tupl
 void
 tsl_compressor_flush(RowCompressor *compressor, BulkWriter *bulk_writer)
 {
-	if (compressor->sort_state)
+	if (compressor->staging)
+	{
+		compressor_segment_staging_flush(compressor, bulk_writer);
+	}
+	else if (compressor->sort_state)
 	{
 		if (compressor->tuples_to_sort)
 		{
@@ -956,6 +1283,11 @@ tsl_compressor_free(RowCompressor *compressor, BulkWriter *bulk_writer)
 	if (compressor->invalidation)
 		pfree(compressor->invalidation);
 	tsl_compressor_flush(compressor, bulk_writer);
+	if (compressor->staging)
+	{
+		compressor_segment_staging_free(compressor->staging);
+		compressor->staging = NULL;
+	}
 	row_compressor_close(compressor);
 	bulk_writer_close(bulk_writer);
 	table_close(bulk_writer->out_rel, NoLock);
@@ -964,11 +1296,15 @@ tsl_compressor_free(RowCompressor *compressor, BulkWriter *bulk_writer)
 /*
  * Initialize a RowCompressor for compressing tuples
  *
- * When `sort` is true, the compressor will buffer all the tuples in a
- * Tuplesortstate and sort them before flushing to the output relation.
+ * With COMPRESSOR_INGEST_SORT_BATCHES, the compressor buffers up to
+ * `tuple_limit` tuples in a Tuplesortstate and sorts them before flushing to
+ * the output relation. With COMPRESSOR_INGEST_SEGMENT_STAGING, unordered
+ * tuples are staged per segmentby group until a group fills a batch, with
+ * `tuple_limit` capping the total number of staged tuples.
  */
 RowCompressor *
-tsl_compressor_init(Relation in_rel, BulkWriter **bulk_writer, bool sort, int sort_limit)
+tsl_compressor_init(Relation in_rel, BulkWriter **bulk_writer, CompressorIngestMode ingest_mode,
+					int tuple_limit)
 {
 	RowCompressor *compressor = palloc0(sizeof(RowCompressor));
 	CompressionSettings *settings = ts_compression_settings_get(in_rel->rd_id);
@@ -976,10 +1312,17 @@ tsl_compressor_init(Relation in_rel, BulkWriter **bulk_writer, bool sort, int so
 	*bulk_writer = bulk_writer_alloc(out_rel, 0);
 	row_compressor_init(compressor, settings, RelationGetDescr(in_rel), RelationGetDescr(out_rel));
 
-	if (sort)
+	switch (ingest_mode)
 	{
-		compressor->sort_state = compression_create_tuplesort_state(settings, in_rel);
-		compressor->tuple_sort_limit = sort_limit;
+		case COMPRESSOR_INGEST_ORDERED:
+			break;
+		case COMPRESSOR_INGEST_SORT_BATCHES:
+			compressor->sort_state = compression_create_tuplesort_state(settings, in_rel);
+			compressor->tuple_sort_limit = tuple_limit;
+			break;
+		case COMPRESSOR_INGEST_SEGMENT_STAGING:
+			compressor->staging = compressor_segment_staging_create(compressor, tuple_limit);
+			break;
 	}
 
 	return compressor;
@@ -1081,22 +1424,22 @@ row_compressor_is_full(RowCompressor *row_compressor, TupleTableSlot *row)
 	if (!row_compressor->needs_fullness_check)
 		return false;
 
+	Assert(row_compressor->n_input_columns <= row->tts_nvalid);
+
 	/* Check with every column compressor if they can add the next value to current batch */
 	int col;
 	for (col = 0; col < row_compressor->n_input_columns; col++)
 	{
 		Compressor *compressor = row_compressor->per_column[col].compressor;
-		bool is_null;
-		Datum val;
 
 		/* No compressor or the compressor has no check, just skip */
 		if (compressor == NULL || compressor->is_full == NULL)
 			continue;
 
-		val = slot_getattr(row, AttrOffsetGetAttrNumber(col), &is_null);
-		if (!is_null)
+		/* The caller has fetched all attributes, so access the arrays directly. */
+		if (!row->tts_isnull[col])
 		{
-			if (compressor->is_full(compressor, val))
+			if (compressor->is_full(compressor, row->tts_values[col]))
 				return true;
 		}
 	}
@@ -1166,18 +1509,14 @@ row_compressor_update_group(RowCompressor *row_compressor, TupleTableSlot *row)
 	for (col = 0; col < row_compressor->n_input_columns; col++)
 	{
 		PerColumn *column = &row_compressor->per_column[col];
-		Datum val;
-		bool is_null;
 
 		if (column->segment_info == NULL)
 			continue;
 
 		Assert(column->compressor == NULL);
 
-		/* Performance Improvement: We should just use array access here; everything is guaranteed
-		   to be fetched */
-		val = slot_getattr(row, AttrOffsetGetAttrNumber(col), &is_null);
-		segment_info_update(column->segment_info, val, is_null);
+		/* Everything is guaranteed to be fetched, so access the arrays directly. */
+		segment_info_update(column->segment_info, row->tts_values[col], row->tts_isnull[col]);
 	}
 	/* switch to original memory context */
 	MemoryContextSwitchTo(oldcontext);
@@ -1187,20 +1526,21 @@ static bool
 row_compressor_new_row_is_in_new_group(RowCompressor *row_compressor, TupleTableSlot *row)
 {
 	int col;
+
+	Assert(row_compressor->n_input_columns <= row->tts_nvalid);
+
 	for (col = 0; col < row_compressor->n_input_columns; col++)
 	{
 		PerColumn *column = &row_compressor->per_column[col];
-		Datum datum = CharGetDatum(0);
-		bool is_null;
 
 		if (column->segment_info == NULL)
 			continue;
 
 		Assert(column->compressor == NULL);
 
-		datum = slot_getattr(row, AttrOffsetGetAttrNumber(col), &is_null);
-
-		if (!segment_info_datum_is_in_group(column->segment_info, datum, is_null))
+		if (!segment_info_datum_is_in_group(column->segment_info,
+											row->tts_values[col],
+											row->tts_isnull[col]))
 			return true;
 	}
 
@@ -1211,21 +1551,26 @@ void
 row_compressor_append_row(RowCompressor *row_compressor, TupleTableSlot *row)
 {
 	int col;
+
+	Assert(row_compressor->n_input_columns <= row->tts_nvalid);
+
 	for (col = 0; col < row_compressor->n_input_columns; col++)
 	{
 		Compressor *compressor = row_compressor->per_column[col].compressor;
-		bool is_null;
-		Datum val;
 
 		/* if there is no compressor, this must be a segmenter, so just skip */
 		if (compressor == NULL)
 			continue;
 
-		/* Performance Improvement: Since we call getallatts at the beginning, slot_getattr is
-		 * useless overhead here, and we should just access the array directly.
+		/*
+		 * All attributes were fetched with slot_getallattrs at the beginning,
+		 * so access the slot arrays directly instead of going through
+		 * slot_getattr for every value. On wide rows the per-attribute calls
+		 * are a measurable part of the compression time.
 		 */
 		BatchMetadataBuilder *builder = row_compressor->per_column[col].metadata_builder;
-		val = slot_getattr(row, AttrOffsetGetAttrNumber(col), &is_null);
+		bool is_null = row->tts_isnull[col];
+		Datum val = row->tts_values[col];
 		if (is_null)
 		{
 			compressor->append_null(compressor);
@@ -1247,6 +1592,112 @@ row_compressor_append_row(RowCompressor *row_compressor, TupleTableSlot *row)
 	row_compressor->rows_compressed_into_current_value += 1;
 }
 
+/*
+ * The codec worth trialing against the one that compressed the first batch of
+ * a column. The candidates are the pairs where real data regularly favors
+ * either side: ALP vs. Gorilla for floats, run-length encoding vs. delta-delta
+ * for the integer family, and dictionary vs. array for the generic types.
+ * Codecs that are disabled by their GUC are not offered, and the bool, uuid
+ * and rle codecs already pick their own fallback internally. Returns
+ * _INVALID_COMPRESSION_ALGORITHM when there is nothing to trial.
+ */
+static CompressionAlgorithm
+compression_get_trial_algorithm(CompressionAlgorithm algorithm, Oid typeoid)
+{
+	switch (algorithm)
+	{
+		case COMPRESSION_ALGORITHM_ALP:
+			return COMPRESSION_ALGORITHM_GORILLA;
+
+		case COMPRESSION_ALGORITHM_GORILLA:
+			if (ts_guc_enable_alp_compression)
+				return COMPRESSION_ALGORITHM_ALP;
+			return _INVALID_COMPRESSION_ALGORITHM;
+
+		case COMPRESSION_ALGORITHM_DELTADELTA:
+			if (ts_guc_enable_rle_compression && rle_decompress_all_possible(typeoid))
+				return COMPRESSION_ALGORITHM_RLE;
+			return _INVALID_COMPRESSION_ALGORITHM;
+
+		case COMPRESSION_ALGORITHM_DICTIONARY:
+			if (ts_guc_enable_zstd_array_compression)
+				return COMPRESSION_ALGORITHM_ARRAY_ZSTD;
+			return COMPRESSION_ALGORITHM_ARRAY;
+
+		case COMPRESSION_ALGORITHM_ARRAY:
+		case COMPRESSION_ALGORITHM_ARRAY_ZSTD:
+		{
+			TypeCacheEntry *tentry =
+				lookup_type_cache(typeoid, TYPECACHE_EQ_OPR_FINFO | TYPECACHE_HASH_PROC_FINFO);
+
+			if (tentry->hash_proc_finfo.fn_addr != NULL && tentry->eq_opr_finfo.fn_addr != NULL)
+				return COMPRESSION_ALGORITHM_DICTIONARY;
+			return _INVALID_COMPRESSION_ALGORITHM;
+		}
+
+		default:
+			return _INVALID_COMPRESSION_ALGORITHM;
+	}
+}
+
+/*
+ * Trial-compress the first full batch of a column with the alternative codec
+ * for its type and keep whichever output is smaller, like the rle and uuid
+ * codecs already do with their fallbacks. The winning codec is also adopted
+ * for the remaining batches of this compression run, so the decompression and
+ * recompression cost of the trial is paid once per column. Returns the blob
+ * to store for this batch.
+ */
+static void *
+row_compressor_codec_trial(RowCompressor *row_compressor, PerColumn *column, void *compressed_data)
+{
+	CompressedDataHeader *header = (CompressedDataHeader *) compressed_data;
+	CompressionAlgorithm alternative =
+		compression_get_trial_algorithm(header->compression_algorithm, column->typid);
+
+	column->codec_trial_done = true;
+
+	if (alternative == _INVALID_COMPRESSION_ALGORITHM)
+		return compressed_data;
+
+	/*
+	 * The trial runs entirely in the current per-row context, so a losing
+	 * candidate is freed with the batch. If the candidate wins, a fresh
+	 * compressor is allocated in the per-column context below to replace the
+	 * column's compressor for the remaining batches.
+	 */
+	Compressor *candidate = definitions[alternative].compressor_for_type(column->typid);
+
+	DecompressionInitializer initializer =
+		tsl_get_decompression_iterator_init(header->compression_algorithm, false);
+	DecompressionIterator *iter = initializer(PointerGetDatum(compressed_data), column->typid);
+
+	for (DecompressResult r = iter->try_next(iter); !r.is_done; r = iter->try_next(iter))
+	{
+		if (r.is_null)
+			candidate->append_null(candidate);
+		else
+			candidate->append_val(candidate, r.val);
+	}
+
+	void *recompressed = candidate->finish(candidate);
+
+	if (recompressed != NULL && VARSIZE(recompressed) < VARSIZE(compressed_data))
+	{
+		MemoryContext column_cxt = GetMemoryChunkContext(row_compressor->per_column);
+		MemoryContext old_cxt = MemoryContextSwitchTo(column_cxt);
+		column->compressor = definitions[alternative].compressor_for_type(column->typid);
+		MemoryContextSwitchTo(old_cxt);
+		pfree(compressed_data);
+		return recompressed;
+	}
+
+	if (recompressed != NULL)
+		pfree(recompressed);
+
+	return compressed_data;
+}
+
 HeapTuple
 row_compressor_build_tuple(RowCompressor *row_compressor)
 {
@@ -1271,6 +1722,13 @@ row_compressor_build_tuple(RowCompressor *row_compressor)
 			Assert(column->segment_info == NULL);
 
 			compressed_data = compressor->finish(compressor);
+
+			if (ts_guc_enable_adaptive_compression && !column->codec_trial_done &&
+				compressed_data != NULL &&
+				row_compressor->rows_compressed_into_current_value >=
+					ADAPTIVE_CODEC_TRIAL_MIN_ROWS)
+				compressed_data = row_compressor_codec_trial(row_compressor, column, compressed_data);
+
 			if (compressed_data == NULL)
 			{
 				if (ts_guc_enable_null_compression &&
@@ -1372,14 +1830,29 @@ row_compressor_flush(RowCompressor *row_compressor, BulkWriter *writer, bool cha
 	}
 
 	Assert(writer->bistate != NULL);
-	heap_insert(writer->out_rel,
-				compressed_tuple,
-				writer->mycid,
-				writer->insert_options /*=options*/,
-				writer->bistate);
-	if (writer->indexstate->ri_NumIndices > 0)
+	if (writer->multi_insert_slots != NULL)
+	{
+		/*
+		 * Defer the write so that it can be grouped with the following
+		 * batches into one multi-insert WAL record per data page.
+		 */
+		TupleTableSlot *buffer_slot = writer->multi_insert_slots[writer->num_buffered++];
+		ExecStoreHeapTuple(compressed_tuple, buffer_slot, false);
+		ExecMaterializeSlot(buffer_slot);
+		if (writer->num_buffered == BULK_WRITER_MULTI_INSERT_SLOTS)
+			bulk_writer_flush(writer);
+	}
+	else
 	{
-		ts_catalog_index_insert(writer->indexstate, compressed_tuple);
+		heap_insert(writer->out_rel,
+					compressed_tuple,
+					writer->mycid,
+					writer->insert_options /*=options*/,
+					writer->bistate);
+		if (writer->indexstate->ri_NumIndices > 0)
+		{
+			ts_catalog_index_insert(writer->indexstate, compressed_tuple);
+		}
 	}
 
 	heap_freetuple(compressed_tuple);
@@ -1563,7 +2036,7 @@ bulk_writer_build(Relation out_rel, int insert_options)
 BulkWriter *
 bulk_writer_alloc(Relation out_rel, int insert_options)
 {
-	BulkWriter *writer = palloc(sizeof(BulkWriter));
+	BulkWriter *writer = palloc0(sizeof(BulkWriter));
 	writer->out_rel = out_rel;
 	writer->indexstate = CatalogOpenIndexes(out_rel);
 	writer->mycid = GetCurrentCommandId(true);
@@ -1574,9 +2047,64 @@ bulk_writer_alloc(Relation out_rel, int insert_options)
 	return writer;
 }
 
+/*
+ * Switch the writer to grouping the compressed tuple writes into
+ * multi-inserts, which WAL-log one record per filled data page instead of one
+ * per tuple. The writes become visible only when the buffer fills up or the
+ * writer is flushed or closed, so this must not be used when the caller needs
+ * to read its own pending writes from the result relation.
+ */
+void
+bulk_writer_enable_multi_insert(BulkWriter *writer)
+{
+	writer->multi_insert_slots =
+		palloc(sizeof(TupleTableSlot *) * BULK_WRITER_MULTI_INSERT_SLOTS);
+	for (int i = 0; i < BULK_WRITER_MULTI_INSERT_SLOTS; i++)
+		writer->multi_insert_slots[i] =
+			MakeSingleTupleTableSlot(RelationGetDescr(writer->out_rel), &TTSOpsHeapTuple);
+	writer->num_buffered = 0;
+}
+
+void
+bulk_writer_flush(BulkWriter *writer)
+{
+	if (writer->multi_insert_slots == NULL || writer->num_buffered == 0)
+		return;
+
+	table_multi_insert(writer->out_rel,
+					   writer->multi_insert_slots,
+					   writer->num_buffered,
+					   writer->mycid,
+					   writer->insert_options,
+					   writer->bistate);
+
+	if (writer->indexstate->ri_NumIndices > 0 && !writer->skip_index_inserts)
+	{
+		for (int i = 0; i < writer->num_buffered; i++)
+		{
+			bool should_free;
+			HeapTuple tuple =
+				ExecFetchSlotHeapTuple(writer->multi_insert_slots[i], false, &should_free);
+			ts_catalog_index_insert(writer->indexstate, tuple);
+		}
+	}
+
+	for (int i = 0; i < writer->num_buffered; i++)
+		ExecClearTuple(writer->multi_insert_slots[i]);
+	writer->num_buffered = 0;
+}
+
 void
 bulk_writer_close(BulkWriter *writer)
 {
+	bulk_writer_flush(writer);
+	if (writer->multi_insert_slots != NULL)
+	{
+		for (int i = 0; i < BULK_WRITER_MULTI_INSERT_SLOTS; i++)
+			ExecDropSingleTupleTableSlot(writer->multi_insert_slots[i]);
+		pfree(writer->multi_insert_slots);
+		writer->multi_insert_slots = NULL;
+	}
 	FreeBulkInsertState(writer->bistate);
 	if (writer->indexstate)
 		CatalogCloseIndexes(writer->indexstate);
@@ -1674,6 +2202,18 @@ decompress_chunk(Oid in_table, Oid out_table)
 
 	PushActiveSnapshot(GetLatestSnapshot());
 	BulkWriter writer = bulk_writer_build(out_rel, 0);
+
+	/*
+	 * When the non-compressed chunk starts out empty, which is the common
+	 * case since only partial chunks hold non-compressed data, it is cheaper
+	 * to rebuild the indexes from scratch after all rows are written than to
+	 * maintain them row by row during the load. A bulk index build sorts the
+	 * entries and writes each index out sequentially, and B-tree builds can
+	 * use parallel workers.
+	 */
+	writer.skip_index_inserts =
+		writer.indexstate->ri_NumIndices > 0 && RelationGetNumberOfBlocks(out_rel) == 0;
+
 	RowDecompressor decompressor =
 		build_decompressor(RelationGetDescr(in_rel), RelationGetDescr(out_rel));
 	TupleTableSlot *slot = table_slot_create(in_rel, NULL);
@@ -1709,11 +2249,21 @@ decompress_chunk(Oid in_table, Oid out_table)
 	table_endscan(scan);
 	ExecDropSingleTupleTableSlot(slot);
 	row_decompressor_close(&decompressor);
+
+	bool reindex_after_load = writer.skip_index_inserts;
+
 	bulk_writer_close(&writer);
 
 	table_close(out_rel, NoLock);
 	table_close(in_rel, NoLock);
 
+	if (reindex_after_load)
+	{
+		ReindexParams params = { 0 };
+
+		reindex_relation_compat(NULL, out_table, 0, &params);
+	}
+
 	PopActiveSnapshot();
 }
 
@@ -2105,7 +2655,7 @@ row_decompressor_decompress_row_to_table(RowDecompressor *decompressor, BulkWrit
 	 * set it to this temporary ResultRelInfo, and insert all rows into this
 	 * single index.
 	 */
-	if (writer->indexstate->ri_NumIndices > 0)
+	if (writer->indexstate->ri_NumIndices > 0 && !writer->skip_index_inserts)
 	{
 		ResultRelInfo indexstate_copy = *writer->indexstate;
 		Relation single_index_relation;
@@ -2539,6 +3089,15 @@ tsl_compressed_data_info(PG_FUNCTION_ARGS)
 		case COMPRESSION_ALGORITHM_UUID:
 			has_nulls = uuid_compressed_has_nulls(header);
 			break;
+		case COMPRESSION_ALGORITHM_ALP:
+			has_nulls = alp_compressed_has_nulls(header);
+			break;
+		case COMPRESSION_ALGORITHM_ARRAY_ZSTD:
+			has_nulls = array_zstd_compressed_has_nulls(header);
+			break;
+		case COMPRESSION_ALGORITHM_RLE:
+			has_nulls = rle_compressed_has_nulls(header);
+			break;
 		default:
 			elog(ERROR, "unknown compression algorithm %d", header->compression_algorithm);
 			break;
@@ -2586,6 +3145,15 @@ tsl_compressed_data_has_nulls(PG_FUNCTION_ARGS)
 		case COMPRESSION_ALGORITHM_UUID:
 			has_nulls = uuid_compressed_has_nulls(header);
 			break;
+		case COMPRESSION_ALGORITHM_ALP:
+			has_nulls = alp_compressed_has_nulls(header);
+			break;
+		case COMPRESSION_ALGORITHM_ARRAY_ZSTD:
+			has_nulls = array_zstd_compressed_has_nulls(header);
+			break;
+		case COMPRESSION_ALGORITHM_RLE:
+			has_nulls = rle_compressed_has_nulls(header);
+			break;
 		default:
 			elog(ERROR, "unknown compression algorithm %d", header->compression_algorithm);
 			break;
@@ -2625,10 +3193,16 @@ compression_get_default_algorithm(Oid typeoid)
 
 		case FLOAT4OID:
 		case FLOAT8OID:
-			return COMPRESSION_ALGORITHM_GORILLA;
+			if (ts_guc_enable_alp_compression)
+				return COMPRESSION_ALGORITHM_ALP;
+			else
+				return COMPRESSION_ALGORITHM_GORILLA;
 
 		case NUMERICOID:
-			return COMPRESSION_ALGORITHM_ARRAY;
+			if (ts_guc_enable_zstd_array_compression)
+				return COMPRESSION_ALGORITHM_ARRAY_ZSTD;
+			else
+				return COMPRESSION_ALGORITHM_ARRAY;
 
 		case BOOLOID:
 			if (ts_guc_enable_bool_compression)
@@ -2644,11 +3218,23 @@ compression_get_default_algorithm(Oid typeoid)
 
 		default:
 		{
+			/*
+			 * The rle compressor falls back to dictionary or array on its own
+			 * when the data turns out to have too few runs.
+			 */
+			if (ts_guc_enable_rle_compression)
+				return COMPRESSION_ALGORITHM_RLE;
+
 			/* use dictionary if possible, otherwise use array */
 			TypeCacheEntry *tentry =
 				lookup_type_cache(typeoid, TYPECACHE_EQ_OPR_FINFO | TYPECACHE_HASH_PROC_FINFO);
 			if (tentry->hash_proc_finfo.fn_addr == NULL || tentry->eq_opr_finfo.fn_addr == NULL)
-				return COMPRESSION_ALGORITHM_ARRAY;
+			{
+				if (ts_guc_enable_zstd_array_compression)
+					return COMPRESSION_ALGORITHM_ARRAY_ZSTD;
+				else
+					return COMPRESSION_ALGORITHM_ARRAY;
+			}
 			return COMPRESSION_ALGORITHM_DICTIONARY;
 		}
 	}
@@ -17,6 +17,7 @@
 typedef struct BulkInsertStateData *BulkInsertState;
 
 #include "batch_metadata_builder_minmax.h"
+#include "cross_module_fn.h"
 #include "hypertable.h"
 #include "nodes/columnar_scan/detoaster.h"
 #include "ts_catalog/compression_settings.h"
@@ -67,6 +68,16 @@ struct Compressor
 {
 	void (*append_null)(Compressor *compressord);
 	void (*append_val)(Compressor *compressor, Datum val);
+
+	/*
+	 * Optional bulk append of a whole column vector in the Arrow layout,
+	 * including the nulls from the validity bitmap. This avoids boxing every
+	 * value into a Datum just to unbox it again in append_val. NULL when the
+	 * algorithm doesn't support it, in which case the caller has to fall back
+	 * to the per-value appends.
+	 */
+	void (*append_vector)(Compressor *compressor, const struct ArrowArray *vector);
+
 	bool (*is_full)(Compressor *compressor, Datum val);
 	void *(*finish)(Compressor *data);
 };
@@ -129,6 +140,19 @@ typedef struct BulkWriter
 	CommandId mycid;
 	BulkInsertState bistate;
 	int insert_options; /* heap insert options */
+	/*
+	 * Skip per-row index maintenance during the writes. The caller is
+	 * responsible for rebuilding the indexes of the result relation after
+	 * the load.
+	 */
+	bool skip_index_inserts;
+	/*
+	 * Buffer of slots for grouping compressed tuple writes into
+	 * multi-inserts, which WAL-log one record per data page instead of one
+	 * per tuple. NULL when the writes go through plain heap_insert.
+	 */
+	TupleTableSlot **multi_insert_slots;
+	int num_buffered;
 } BulkWriter;
 
 typedef struct RowDecompressor
@@ -196,6 +220,9 @@ typedef enum CompressionAlgorithm
 	COMPRESSION_ALGORITHM_BOOL,
 	COMPRESSION_ALGORITHM_NULL,
 	COMPRESSION_ALGORITHM_UUID,
+	COMPRESSION_ALGORITHM_ALP,
+	COMPRESSION_ALGORITHM_ARRAY_ZSTD,
+	COMPRESSION_ALGORITHM_RLE,
 
 	/* When adding an algorithm also add a static assert statement below */
 	/* end of real values */
@@ -214,6 +241,13 @@ typedef struct PerColumn
 {
 	/* the compressor to use for regular columns, NULL for segmenters */
 	Compressor *compressor;
+	/* element type of the uncompressed column */
+	Oid typid;
+	/*
+	 * Set once the adaptive codec trial has run for this column, so that its
+	 * cost is only paid once per compression run.
+	 */
+	bool codec_trial_done;
 	/*
 	 * Information on the metadata we'll store for this column (currently only min/max).
 	 * Only used for order-by columns right now, will be {-1, NULL} for others.
@@ -279,6 +313,10 @@ typedef struct RowCompressor
 	Tuplesortstate *sort_state;
 	int64 tuples_to_sort;	/* number of tuples to sort with tuplesort */
 	int64 tuple_sort_limit; /* number of tuples to flush the compressor on */
+
+	/* per-segment staging area for unordered direct ingestion, NULL unless
+	 * initialized with COMPRESSOR_INGEST_SEGMENT_STAGING */
+	struct CompressorSegmentStaging *staging;
 } RowCompressor;
 
 /*
@@ -331,13 +369,16 @@ pg_attribute_unused() assert_num_compression_algorithms_sane(void)
 	StaticAssertStmt(COMPRESSION_ALGORITHM_BOOL == 5, "algorithm index has changed");
 	StaticAssertStmt(COMPRESSION_ALGORITHM_NULL == 6, "algorithm index has changed");
 	StaticAssertStmt(COMPRESSION_ALGORITHM_UUID == 7, "algorithm index has changed");
+	StaticAssertStmt(COMPRESSION_ALGORITHM_ALP == 8, "algorithm index has changed");
+	StaticAssertStmt(COMPRESSION_ALGORITHM_ARRAY_ZSTD == 9, "algorithm index has changed");
+	StaticAssertStmt(COMPRESSION_ALGORITHM_RLE == 10, "algorithm index has changed");
 
 	/*
 	 * This should change when adding a new algorithm after adding the new
 	 * algorithm to the assert list above. This statement prevents adding a
 	 * new algorithm without updating the asserts above
 	 */
-	StaticAssertStmt(_END_COMPRESSION_ALGORITHMS == 8,
+	StaticAssertStmt(_END_COMPRESSION_ALGORITHMS == 11,
 					 "number of algorithms have changed, the asserts should be updated");
 }
 
@@ -384,8 +425,8 @@ extern void row_compressor_init(RowCompressor *row_compressor, const Compression
 								const TupleDesc noncompressed_tupdesc,
 								const TupleDesc compressed_tupdesc);
 
-extern RowCompressor *tsl_compressor_init(Relation in_rel, BulkWriter **bulk_writer, bool sort,
-										  int tuple_sort_limit);
+extern RowCompressor *tsl_compressor_init(Relation in_rel, BulkWriter **bulk_writer,
+										  CompressorIngestMode ingest_mode, int tuple_limit);
 extern void tsl_compressor_set_invalidation(RowCompressor *compressor, Hypertable *ht,
 											Oid chunk_relid);
 extern void tsl_compressor_add_slot(RowCompressor *compressor, BulkWriter *bulk_writer,
@@ -408,6 +449,8 @@ extern void segment_info_update(SegmentInfo *segment_info, Datum val, bool is_nu
 
 extern BulkWriter bulk_writer_build(Relation out_rel, int insert_options);
 extern BulkWriter *bulk_writer_alloc(Relation out_rel, int insert_options);
+extern void bulk_writer_enable_multi_insert(BulkWriter *writer);
+extern void bulk_writer_flush(BulkWriter *writer);
 extern void bulk_writer_close(BulkWriter *writer);
 extern RowDecompressor build_decompressor(const TupleDesc in_desc, const TupleDesc out_desc);
 
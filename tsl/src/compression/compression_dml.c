@@ -5,6 +5,7 @@
  */
 #include <postgres.h>
 #include <access/genam.h>
+#include <access/htup_details.h>
 #include <access/sdir.h>
 #include <access/tableam.h>
 #include <access/valid.h>
@@ -14,9 +15,12 @@
 #include <parser/parse_coerce.h>
 #include <parser/parse_relation.h>
 #include <parser/parsetree.h>
+#include <utils/datum.h>
 #include <utils/lsyscache.h>
+#include <utils/memutils.h>
 #include <utils/relcache.h>
 #include <utils/snapmgr.h>
+#include <utils/syscache.h>
 #include <utils/typcache.h>
 
 #include <compat/compat.h>
@@ -25,6 +29,7 @@
 #include <compression/compression.h>
 #include <compression/compression_dml.h>
 #include <compression/create.h>
+#include <compression/sparse_index_bloom1.h>
 #include <compression/wal_utils.h>
 #include <continuous_aggs/insert.h>
 #include <expression_utils.h>
@@ -57,8 +62,10 @@ static struct decompress_batches_stats decompress_batches_scan(
 	Relation in_rel, Relation out_rel, Relation index_rel, Snapshot snapshot,
 	ScanKeyData *index_scankeys, int num_index_scankeys, ScanKeyData *heap_scankeys,
 	int num_heap_scankeys, ScanKeyData *mem_scankeys, int num_mem_scankeys,
+	ScanKeyData *full_match_scankeys, int num_full_match_scankeys, InsertBloomProbes *bloom_probes,
 	tuple_filtering_constraints *constraints, bool *skip_current_tuple, bool delete_only,
-	Bitmapset *null_columns, List *is_nulls, InvalidationContext *invalidation_ctx);
+	bool vectorized_filtering, Bitmapset *null_columns, List *is_nulls,
+	InvalidationContext *invalidation_ctx);
 
 static BatchQualSummary batch_matches(RowDecompressor *decompressor, ScanKeyData *scankeys,
 									  int num_scankeys, tuple_filtering_constraints *constraints,
@@ -69,7 +76,8 @@ static BatchQualSummary batch_matches_vectorized(RowDecompressor *decompressor,
 												 bool check_full_match, bool *skip_current_tuple);
 static void process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 							   ScanKeyData **mem_scankeys, int *num_mem_scankeys,
-							   List **heap_filters, List **index_filters, List **is_null);
+							   List **heap_filters, List **index_filters,
+							   List **full_match_filters, List **is_null);
 static Relation find_matching_index(Relation comp_chunk_rel, List **index_filters,
 									List **heap_filters);
 static tuple_filtering_constraints *get_batch_keys_for_unique_constraints(Relation relation);
@@ -86,6 +94,15 @@ static bool can_delete_without_decompression(ModifyHypertableState *ht_state,
 static bool can_vectorize_constraint_checks(tuple_filtering_constraints *constraints,
 											CompressionSettings *settings, Relation chunk_rel,
 											Oid ht_relid, ScanKeyWithAttnos *mem_scankeys);
+static bool can_vectorize_dml_scankeys(Relation chunk_rel, ScanKeyData *mem_scankeys,
+									   int num_mem_scankeys);
+static InsertBloomProbes *build_bloom1_probes(Oid ht_relid, CompressionSettings *settings,
+											  Relation out_rel,
+											  tuple_filtering_constraints *constraints);
+static bool batch_may_contain_tuple(RowDecompressor *decompressor, InsertBloomProbes *probes);
+static void init_insert_key_cache(CachedDecompressionState *cdst, TupleTableSlot *slot);
+static bool insert_key_matches_cached(CachedDecompressionState *cdst, TupleTableSlot *slot);
+static void cache_insert_key(CachedDecompressionState *cdst, TupleTableSlot *slot);
 static ScanKeyData *get_updated_scankeys(const ScanKeyWithAttnos *scankeys, TupleTableSlot *slot,
 										 int null_flags);
 
@@ -158,6 +175,11 @@ init_decompress_state_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 												cis->hypertable_relid,
 												&cdst->mem_scankeys);
 
+			cdst->bloom_probes = build_bloom1_probes(cis->hypertable_relid,
+													 compression_settings,
+													 cis->rel,
+													 constraints);
+
 			cdst->index_scankeys.scankeys =
 				build_index_scankeys_using_slot(cis->hypertable_relid,
 												in_rel,
@@ -198,6 +220,9 @@ init_decompress_state_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 
 		cdst->columns_with_null_check = columns_with_null_check;
 		table_close(in_rel, NoLock);
+
+		if (ts_guc_enable_dml_decompression_key_caching)
+			init_insert_key_cache(cdst, slot);
 	}
 	cis->cached_decompression_state = cdst;
 
@@ -268,6 +293,18 @@ decompress_batches_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 		return;
 	}
 
+	if (cdst->num_key_attnos > 0 && insert_key_matches_cached(cdst, slot))
+	{
+		/*
+		 * Same key values as the previous conflict probe. All batches that
+		 * could conflict with this key were already decompressed by that
+		 * probe, so scanning again would come up empty.
+		 */
+		if (ts_guc_debug_compression_path_info)
+			elog(INFO, "Skipping conflict probe for repeated unique key values. ");
+		return;
+	}
+
 	Assert(cdst->compression_settings->fd.relid == RelationGetRelid(out_rel));
 	Relation in_rel =
 		relation_open(cdst->compression_settings->fd.compress_relid, RowExclusiveLock);
@@ -288,14 +325,26 @@ decompress_batches_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 		get_updated_scankeys(&cdst->heap_scankeys, slot, SK_ISNULL | SK_SEARCHNULL);
 	ScanKeyData *mem_scankeys = get_updated_scankeys(&cdst->mem_scankeys, slot, SK_ISNULL);
 
+	/* Refresh the bloom probe needle values from the inserted tuple */
+	InsertBloomProbes *bloom_probes = cdst->bloom_probes;
+	if (bloom_probes)
+	{
+		for (int i = 0; i < bloom_probes->num_probes; i++)
+		{
+			bloom_probes->values[i] =
+				slot_getattr(slot, bloom_probes->slot_attnos[i], &bloom_probes->isnulls[i]);
+		}
+	}
+
 	if (ts_guc_debug_compression_path_info)
 	{
 		elog(INFO,
-			 "Using %s scan with scan keys: index %d, heap %d, memory %d. ",
+			 "Using %s scan with scan keys: index %d, heap %d, memory %d, bloom probes %d. ",
 			 OidIsValid(cdst->index_relid) ? "index" : "table",
 			 cdst->index_scankeys.num_scankeys,
 			 cdst->heap_scankeys.num_scankeys,
-			 cdst->mem_scankeys.num_scankeys);
+			 cdst->mem_scankeys.num_scankeys,
+			 bloom_probes ? bloom_probes->num_probes : 0);
 	}
 
 	/*
@@ -314,9 +363,13 @@ decompress_batches_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 									cdst->heap_scankeys.num_scankeys,
 									mem_scankeys,
 									cdst->mem_scankeys.num_scankeys,
+									NULL,
+									0,
+									bloom_probes,
 									cdst->constraints,
 									&skip_current_tuple,
 									false,
+									false, /* vectorization decided by the constraints */
 									cdst->columns_with_null_check, /* no null column check for
 														   non-segmentby columns */
 									NIL,
@@ -335,6 +388,19 @@ decompress_batches_for_insert(ChunkInsertState *cis, TupleTableSlot *slot)
 	cis->counters->batches_decompressed += stats.batches_decompressed;
 	cis->counters->tuples_decompressed += stats.tuples_decompressed;
 
+	if (cdst->num_key_attnos > 0)
+	{
+		/*
+		 * With ON CONFLICT DO NOTHING a conflicting tuple may remain
+		 * compressed, so a following tuple with the same key values has to
+		 * probe again to be skipped as well.
+		 */
+		if (skip_current_tuple)
+			cdst->last_key_valid = false;
+		else
+			cache_insert_key(cdst, slot);
+	}
+
 	if (index_scankeys)
 		pfree(index_scankeys);
 	if (heap_scankeys)
@@ -364,6 +430,7 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 
 	List *heap_filters = NIL;
 	List *index_filters = NIL;
+	List *full_match_filters = NIL;
 	List *is_null = NIL;
 	ListCell *lc = NULL;
 	Relation chunk_rel;
@@ -379,6 +446,8 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 	struct decompress_batches_stats stats;
 	int num_mem_scankeys = 0;
 	ScanKeyData *mem_scankeys = NULL;
+	int num_full_match_scankeys = 0;
+	ScanKeyData *full_match_scankeys = NULL;
 
 	CompressionSettings *settings = ts_compression_settings_get(chunk->table_id);
 	bool delete_only = ht_state->mt->operation == CMD_DELETE && !has_joins &&
@@ -419,11 +488,20 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 					   &num_mem_scankeys,
 					   &heap_filters,
 					   &index_filters,
+					   &full_match_filters,
 					   &is_null);
 
 	chunk_rel = table_open(chunk->table_id, RowExclusiveLock);
 	comp_chunk_rel = table_open(settings->fd.compress_relid, RowExclusiveLock);
 
+	/*
+	 * Evaluate the in-memory scankeys against whole batches at once when all
+	 * of them have a vectorized implementation, like the unique constraint
+	 * checks on the INSERT path do.
+	 */
+	bool vectorized_filtering =
+		can_vectorize_dml_scankeys(chunk_rel, mem_scankeys, num_mem_scankeys);
+
 	if (index_filters)
 	{
 		matching_index_rel = find_matching_index(comp_chunk_rel, &index_filters, &heap_filters);
@@ -443,6 +521,25 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 		index_scankeys =
 			build_index_scankeys(matching_index_rel, index_filters, &num_index_scankeys);
 	}
+
+	/*
+	 * Build the scankeys that prove from the batch metadata alone that every
+	 * row of a batch matches the predicates, so that such batches can be
+	 * deleted directly without checking the individual rows.
+	 */
+	if (delete_only && full_match_filters)
+	{
+		bool all_keys_created = true;
+		Bitmapset *unused_null_columns = NULL;
+		full_match_scankeys = build_update_delete_scankeys(comp_chunk_rel,
+														   full_match_filters,
+														   &num_full_match_scankeys,
+														   &unused_null_columns,
+														   &all_keys_created);
+		if (!all_keys_created)
+			num_full_match_scankeys = 0;
+	}
+
 	PushActiveSnapshot(GetTransactionSnapshot());
 	stats = decompress_batches_scan(comp_chunk_rel,
 									chunk_rel,
@@ -454,9 +551,13 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 									num_scankeys,
 									mem_scankeys,
 									num_mem_scankeys,
+									full_match_scankeys,
+									num_full_match_scankeys,
+									NULL, /* no bloom probes outside the INSERT path */
 									NULL,
 									NULL,
 									delete_only,
+									vectorized_filtering,
 									null_columns,
 									is_null,
 									ht_state->has_continuous_aggregate ? &invalidation_ctx : NULL);
@@ -472,8 +573,18 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 	 * to staging area, thus mark this chunk as partially compressed
 	 */
 	if (stats.batches_decompressed > 0)
+	{
 		ts_chunk_set_partial(chunk);
 
+		/*
+		 * Remember the chunk so that it can be recompressed at the end of the
+		 * statement, once the updated rows are in place in the staging area.
+		 */
+		if (ts_guc_enable_dml_recompression && ht_state->mt->operation == CMD_UPDATE)
+			ht_state->chunks_for_recompression =
+				list_append_unique_oid(ht_state->chunks_for_recompression, chunk->table_id);
+	}
+
 	table_close(chunk_rel, NoLock);
 	table_close(comp_chunk_rel, NoLock);
 
@@ -487,6 +598,13 @@ decompress_batches_for_update_delete(ModifyHypertableState *ht_state, Chunk *chu
 		filter = lfirst(lc);
 		pfree(filter);
 	}
+	foreach (lc, full_match_filters)
+	{
+		filter = lfirst(lc);
+		pfree(filter);
+	}
+	if (full_match_scankeys)
+		pfree(full_match_scankeys);
 	ht_state->batches_deleted += stats.batches_deleted;
 	ht_state->batches_filtered += stats.batches_filtered;
 	ht_state->batches_decompressed += stats.batches_decompressed;
@@ -571,8 +689,10 @@ decompress_batches_scan(Relation in_rel, Relation out_rel, Relation index_rel, S
 						ScanKeyData *index_scankeys, int num_index_scankeys,
 						ScanKeyData *heap_scankeys, int num_heap_scankeys,
 						ScanKeyData *mem_scankeys, int num_mem_scankeys,
-						tuple_filtering_constraints *constraints, bool *skip_current_tuple,
-						bool delete_only, Bitmapset *null_columns, List *is_nulls,
+						ScanKeyData *full_match_scankeys, int num_full_match_scankeys,
+						InsertBloomProbes *bloom_probes, tuple_filtering_constraints *constraints,
+						bool *skip_current_tuple, bool delete_only, bool vectorized_filtering,
+						Bitmapset *null_columns, List *is_nulls,
 						InvalidationContext *invalidation_ctx)
 {
 	HeapTuple compressed_tuple;
@@ -585,7 +705,9 @@ decompress_batches_scan(Relation in_rel, Relation out_rel, Relation index_rel, S
 	TM_Result result;
 	DecompressBatchScanDesc scan = NULL;
 	BatchMatcher *batch_matcher =
-		constraints && constraints->vectorized_filtering ? batch_matches_vectorized : batch_matches;
+		(constraints && constraints->vectorized_filtering) || vectorized_filtering ?
+			batch_matches_vectorized :
+			batch_matches;
 	AttrNumber meta_count_attno = InvalidAttrNumber;
 
 	struct decompress_batches_stats stats = { 0 };
@@ -686,7 +808,43 @@ decompress_batches_scan(Relation in_rel, Relation out_rel, Relation index_rel, S
 
 		/* If there are no in-memory quals, all rows pass */
 		BatchQualSummary summary = AllRowsPass;
-		if (num_mem_scankeys)
+
+		/*
+		 * A negative probe against the bloom1 sparse index columns proves that
+		 * the batch cannot contain a tuple conflicting with the inserted one,
+		 * so it does not have to be decompressed at all.
+		 */
+		if (bloom_probes && !batch_may_contain_tuple(&decompressor, bloom_probes))
+		{
+			row_decompressor_reset(&decompressor);
+			stats.batches_filtered++;
+			continue;
+		}
+
+		/*
+		 * When the min/max metadata of this batch already proves that every
+		 * row matches the predicates, the batch can be deleted directly and
+		 * we can skip the row-by-row check, which would have to decompress
+		 * the filter columns.
+		 */
+		bool full_match_proven = false;
+		if (delete_only && num_full_match_scankeys)
+		{
+#if PG16_LT
+			HeapKeyTest(compressed_tuple,
+						RelationGetDescr(in_rel),
+						num_full_match_scankeys,
+						full_match_scankeys,
+						full_match_proven);
+#else
+			full_match_proven = HeapKeyTest(compressed_tuple,
+											RelationGetDescr(in_rel),
+											num_full_match_scankeys,
+											full_match_scankeys);
+#endif
+		}
+
+		if (!full_match_proven && num_mem_scankeys)
 		{
 			summary = batch_matcher(&decompressor,
 									mem_scankeys,
@@ -1248,6 +1406,21 @@ get_batch_keys_for_unique_constraints(Relation relation)
 	return constraints;
 }
 
+/*
+ * Whether the given chunk column is declared NOT NULL.
+ */
+static bool
+chunk_attr_is_notnull(Oid chunk_relid, AttrNumber attno)
+{
+	HeapTuple tp = SearchSysCache2(ATTNUM, ObjectIdGetDatum(chunk_relid), Int16GetDatum(attno));
+	if (!HeapTupleIsValid(tp))
+		return false;
+	Form_pg_attribute att_tup = (Form_pg_attribute) GETSTRUCT(tp);
+	bool result = att_tup->attnotnull;
+	ReleaseSysCache(tp);
+	return result;
+}
+
 /*
  * This method will evaluate the predicates, extract
  * left and right operands, check if any of the operands
@@ -1256,13 +1429,20 @@ get_batch_keys_for_unique_constraints(Relation relation)
  * list.
  * Any segmentby filter is put into index_filters list other
  * filters are put into heap_filters list.
+ *
+ * Additionally, full_match_filters is filled with filters on the min/max
+ * metadata columns which prove that every row of a batch matches the
+ * predicates, so that direct DELETE can skip the row-by-row check for such
+ * batches. These filters are only produced when every non-segmentby
+ * predicate can be proven this way, otherwise the list is left empty.
  */
 static void
 process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 				   ScanKeyData **mem_scankeys, int *num_mem_scankeys, List **heap_filters,
-				   List **index_filters, List **is_null)
+				   List **index_filters, List **full_match_filters, List **is_null)
 {
 	ListCell *lc;
+	bool can_prove_full_match = true;
 	if (ts_guc_enable_dml_decompression_tuple_filtering)
 	{
 		*mem_scankeys = palloc0(sizeof(ScanKeyData) * list_length(predicates));
@@ -1373,7 +1553,10 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 																 settings->fd.compress_relid,
 																 "min");
 				if (min_attno == InvalidAttrNumber)
+				{
+					can_prove_full_match = false;
 					continue;
+				}
 
 				int max_attno = compressed_column_metadata_attno(settings,
 																 ch->table_id,
@@ -1381,7 +1564,19 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 																 settings->fd.compress_relid,
 																 "max");
 				if (max_attno == InvalidAttrNumber)
+				{
+					can_prove_full_match = false;
 					continue;
+				}
+
+				/*
+				 * The min/max metadata ignores null values, so a full-batch
+				 * match can only be proven from it when the column cannot
+				 * contain nulls. A null comparison value never matches any
+				 * row, so there is nothing to prove in that case either.
+				 */
+				if (arg_value->constisnull || !chunk_attr_is_notnull(ch->table_id, var->varattno))
+					can_prove_full_match = false;
 
 				/* Need both min and max metadata attributes to build heap filters */
 
@@ -1416,6 +1611,33 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 													 false, /* is_null */
 													 false	/* is_array_op */
 													 ));
+						/* every row matches when min >= value and max <= value */
+						*full_match_filters =
+							lappend(*full_match_filters,
+									make_batchfilter(get_attname(settings->fd.compress_relid,
+																 min_attno,
+																 false),
+													 BTGreaterEqualStrategyNumber,
+													 collation,
+													 opcode,
+													 arg_value,
+													 false, /* is_null_check */
+													 false, /* is_null */
+													 false	/* is_array_op */
+													 ));
+						*full_match_filters =
+							lappend(*full_match_filters,
+									make_batchfilter(get_attname(settings->fd.compress_relid,
+																 max_attno,
+																 false),
+													 BTLessEqualStrategyNumber,
+													 collation,
+													 opcode,
+													 arg_value,
+													 false, /* is_null_check */
+													 false, /* is_null */
+													 false	/* is_array_op */
+													 ));
 					}
 					break;
 					case BTLessStrategyNumber:
@@ -1435,6 +1657,20 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 													 false, /* is_null */
 													 false	/* is_array_op */
 													 ));
+						/* every row matches when max <[=] value */
+						*full_match_filters =
+							lappend(*full_match_filters,
+									make_batchfilter(get_attname(settings->fd.compress_relid,
+																 max_attno,
+																 false),
+													 op_strategy,
+													 collation,
+													 opcode,
+													 arg_value,
+													 false, /* is_null_check */
+													 false, /* is_null */
+													 false	/* is_array_op */
+													 ));
 					}
 					break;
 					case BTGreaterStrategyNumber:
@@ -1454,10 +1690,25 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 													 false, /* is_null */
 													 false	/* is_array_op */
 													 ));
+						/* every row matches when min >[=] value */
+						*full_match_filters =
+							lappend(*full_match_filters,
+									make_batchfilter(get_attname(settings->fd.compress_relid,
+																 min_attno,
+																 false),
+													 op_strategy,
+													 collation,
+													 opcode,
+													 arg_value,
+													 false, /* is_null_check */
+													 false, /* is_null */
+													 false	/* is_array_op */
+													 ));
 					}
 					break;
 					default:
 						/* Do nothing for unknown operator strategies. */
+						can_prove_full_match = false;
 						break;
 				}
 			}
@@ -1521,6 +1772,7 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 					continue;
 				}
 
+				can_prove_full_match = false;
 				break;
 			}
 			case T_NullTest:
@@ -1551,6 +1803,10 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 						else
 							*is_null = lappend_int(*is_null, 0);
 					}
+					else
+					{
+						can_prove_full_match = false;
+					}
 					/* We cannot optimize filtering decompression using ORDERBY
 					 * metadata and null check qualifiers. We could possibly do that by checking the
 					 * compressed data in combination with the ORDERBY nulls first setting and
@@ -1560,9 +1816,25 @@ process_predicates(Chunk *ch, CompressionSettings *settings, List *predicates,
 			}
 			break;
 			default:
+				can_prove_full_match = false;
 				break;
 		}
 	}
+
+	/*
+	 * The full-batch match can only be proven when all non-segmentby
+	 * predicates contribute a metadata filter. Segmentby predicates need no
+	 * proof since the segmentby value is the same for all rows of a batch.
+	 */
+	if (!can_prove_full_match && *full_match_filters != NIL)
+	{
+		foreach (lc, *full_match_filters)
+		{
+			pfree(lfirst(lc));
+		}
+		list_free(*full_match_filters);
+		*full_match_filters = NIL;
+	}
 }
 
 static BatchFilter *
@@ -1906,3 +2178,279 @@ can_vectorize_constraint_checks(tuple_filtering_constraints *constraints,
 
 	return true;
 }
+
+/*
+ * Like can_vectorize_constraint_checks, but for the in-memory scankeys built
+ * from UPDATE/DELETE predicates, which reference the columns of the
+ * uncompressed chunk directly.
+ */
+static bool
+can_vectorize_dml_scankeys(Relation chunk_rel, ScanKeyData *mem_scankeys, int num_mem_scankeys)
+{
+	Oid typoid, collid;
+	int32 typmod;
+
+	if (num_mem_scankeys == 0)
+		return false;
+
+	/* We can only vectorize if a vectorized check is available for all scankeys */
+	for (int sk = 0; sk < num_mem_scankeys; sk++)
+	{
+		ScanKeyData *scankey = &mem_scankeys[sk];
+
+		/* Null checks are handled by the vectorized null test */
+		if (scankey->sk_flags & SK_ISNULL)
+			continue;
+
+		if (get_vector_const_predicate(scankey->sk_func.fn_oid) == NULL)
+			return false;
+
+		get_atttypetypmodcoll(chunk_rel->rd_id, scankey->sk_attno, &typoid, &typmod, &collid);
+
+		/* No bulk decompression function, no vectorized filtering */
+		if (tsl_get_decompress_all_function(compression_get_default_algorithm(typoid), typoid) ==
+			NULL)
+			return false;
+
+		/* For text types, check for non-deterministic collation which
+		 * prevents vectorized filtering */
+		if (typoid == TEXTOID && OidIsValid(collid) && !get_collation_isdeterministic(collid))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Build bloom filter probes for the unique key columns that have a bloom1
+ * sparse index on the compressed chunk. Returns NULL when no key column has
+ * a bloom1 metadata column or a suitable hash function.
+ */
+static InsertBloomProbes *
+build_bloom1_probes(Oid ht_relid, CompressionSettings *settings, Relation out_rel,
+					tuple_filtering_constraints *constraints)
+{
+	TupleDesc out_desc = RelationGetDescr(out_rel);
+	int max_probes = bms_num_members(constraints->key_columns);
+
+	if (max_probes == 0)
+		return NULL;
+
+	InsertBloomProbes *probes = palloc0(sizeof(InsertBloomProbes));
+	probes->bloom_attnos = palloc(sizeof(AttrNumber) * max_probes);
+	probes->slot_attnos = palloc(sizeof(AttrNumber) * max_probes);
+	probes->hash_functions = palloc(sizeof(PGFunction) * max_probes);
+	probes->hash_finfos = palloc(sizeof(FmgrInfo *) * max_probes);
+	probes->values = palloc0(sizeof(Datum) * max_probes);
+	probes->isnulls = palloc0(sizeof(bool) * max_probes);
+
+	AttrNumber attno = -1;
+	while ((attno = bms_next_member(constraints->key_columns, attno)) > 0)
+	{
+		char *attname = get_attname(out_rel->rd_id, attno, false);
+
+		/*
+		 * Segmentby columns are matched exactly by the batch scan keys, so a
+		 * bloom probe on them would be redundant.
+		 */
+		if (ts_array_is_member(settings->fd.segmentby, attname))
+			continue;
+
+		AttrNumber bloom_attno = compressed_column_metadata_attno(settings,
+																  out_rel->rd_id,
+																  attno,
+																  settings->fd.compress_relid,
+																  bloom1_column_prefix);
+
+		if (bloom_attno == InvalidAttrNumber && ts_guc_read_legacy_bloom1_v1)
+		{
+			/*
+			 * The version 1 of bloom1 indexes is disabled by default because
+			 * its hashing was dependent on build options leading to corrupt
+			 * indexes, but can be enabled manually.
+			 */
+			bloom_attno = compressed_column_metadata_attno(settings,
+														   out_rel->rd_id,
+														   attno,
+														   settings->fd.compress_relid,
+														   "bloom1");
+		}
+
+		if (bloom_attno == InvalidAttrNumber)
+			continue;
+
+		Oid atttypid = TupleDescAttr(out_desc, AttrNumberGetAttrOffset(attno))->atttypid;
+		FmgrInfo *hash_finfo = NULL;
+		PGFunction hash_function = bloom1_get_hash_function(atttypid, &hash_finfo);
+		if (hash_function == NULL)
+			continue;
+
+		const int i = probes->num_probes++;
+		probes->bloom_attnos[i] = bloom_attno;
+		probes->slot_attnos[i] = get_attnum(ht_relid, attname);
+		probes->hash_functions[i] = hash_function;
+		probes->hash_finfos[i] = hash_finfo;
+	}
+
+	if (probes->num_probes == 0)
+	{
+		pfree(probes->bloom_attnos);
+		pfree(probes->slot_attnos);
+		pfree(probes->hash_functions);
+		pfree(probes->hash_finfos);
+		pfree(probes->values);
+		pfree(probes->isnulls);
+		pfree(probes);
+		return NULL;
+	}
+
+	return probes;
+}
+
+/*
+ * Probe the bloom1 sparse index columns of a compressed batch with the unique
+ * key values of the tuple that is being inserted. Returns false when some
+ * probe proves that the batch cannot contain a conflicting tuple.
+ */
+static bool
+batch_may_contain_tuple(RowDecompressor *decompressor, InsertBloomProbes *probes)
+{
+	for (int i = 0; i < probes->num_probes; i++)
+	{
+		/*
+		 * A NULL key value is handled by the null checks, not by the bloom
+		 * filters, which only hash non-null values.
+		 */
+		if (probes->isnulls[i])
+			continue;
+
+		const int bloom_offset = AttrNumberGetAttrOffset(probes->bloom_attnos[i]);
+
+		/* No bloom filter stored for this batch, so it may contain anything */
+		if (decompressor->compressed_is_nulls[bloom_offset])
+			continue;
+
+		struct varlena *bloom =
+			(struct varlena *) PG_DETOAST_DATUM(decompressor->compressed_datums[bloom_offset]);
+		if (!bloom1_maybe_contains(probes->hash_functions[i],
+								   probes->hash_finfos[i],
+								   bloom,
+								   probes->values[i]))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Collect the slot attribute numbers that feed the conflict probe, i.e. the
+ * arguments of the index, heap and memory scan keys and the bloom probe
+ * needles. When consecutive inserted tuples have equal values for all of
+ * them, the probe would look for exactly the same batches again, and those
+ * were already decompressed by the previous probe, so it can be skipped.
+ * Upsert-heavy workloads routinely send long runs of tuples per key.
+ */
+static void
+init_insert_key_cache(CachedDecompressionState *cdst, TupleTableSlot *slot)
+{
+	const ScanKeyWithAttnos *scankeys[] = { &cdst->index_scankeys,
+											&cdst->heap_scankeys,
+											&cdst->mem_scankeys };
+	int max_attnos = 0;
+	for (size_t i = 0; i < lengthof(scankeys); i++)
+		max_attnos += scankeys[i]->num_scankeys;
+	if (cdst->bloom_probes)
+		max_attnos += cdst->bloom_probes->num_probes;
+
+	if (max_attnos == 0)
+		return;
+
+	AttrNumber *attnos = palloc(sizeof(AttrNumber) * max_attnos);
+	int num_attnos = 0;
+	for (size_t i = 0; i < lengthof(scankeys); i++)
+	{
+		for (int j = 0; j < scankeys[i]->num_scankeys; j++)
+		{
+			const AttrNumber attno = scankeys[i]->attnos[j];
+			bool found = false;
+			for (int k = 0; k < num_attnos; k++)
+				found |= attnos[k] == attno;
+			if (!found)
+				attnos[num_attnos++] = attno;
+		}
+	}
+	if (cdst->bloom_probes)
+	{
+		for (int j = 0; j < cdst->bloom_probes->num_probes; j++)
+		{
+			const AttrNumber attno = cdst->bloom_probes->slot_attnos[j];
+			bool found = false;
+			for (int k = 0; k < num_attnos; k++)
+				found |= attnos[k] == attno;
+			if (!found)
+				attnos[num_attnos++] = attno;
+		}
+	}
+
+	TupleDesc desc = slot->tts_tupleDescriptor;
+	cdst->key_attnos = attnos;
+	cdst->num_key_attnos = num_attnos;
+	cdst->key_attlens = palloc(sizeof(int16) * num_attnos);
+	cdst->key_attbyvals = palloc(sizeof(bool) * num_attnos);
+	for (int i = 0; i < num_attnos; i++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(desc, AttrNumberGetAttrOffset(attnos[i]));
+		cdst->key_attlens[i] = attr->attlen;
+		cdst->key_attbyvals[i] = attr->attbyval;
+	}
+	cdst->last_key_values = palloc0(sizeof(Datum) * num_attnos);
+	cdst->last_key_isnulls = palloc(sizeof(bool) * num_attnos);
+	cdst->last_key_valid = false;
+	cdst->last_key_mctx = AllocSetContextCreate(CurrentMemoryContext,
+												"insert conflict probe key cache",
+												ALLOCSET_SMALL_SIZES);
+}
+
+static bool
+insert_key_matches_cached(CachedDecompressionState *cdst, TupleTableSlot *slot)
+{
+	if (!cdst->last_key_valid)
+		return false;
+
+	for (int i = 0; i < cdst->num_key_attnos; i++)
+	{
+		bool isnull;
+		Datum value = slot_getattr(slot, cdst->key_attnos[i], &isnull);
+		if (isnull != cdst->last_key_isnulls[i])
+			return false;
+		/*
+		 * Binary equality is conservative: a false negative only means we
+		 * run the probe again.
+		 */
+		if (!isnull && !datumIsEqual(value,
+									 cdst->last_key_values[i],
+									 cdst->key_attbyvals[i],
+									 cdst->key_attlens[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static void
+cache_insert_key(CachedDecompressionState *cdst, TupleTableSlot *slot)
+{
+	MemoryContextReset(cdst->last_key_mctx);
+	MemoryContext old_context = MemoryContextSwitchTo(cdst->last_key_mctx);
+	for (int i = 0; i < cdst->num_key_attnos; i++)
+	{
+		bool isnull;
+		Datum value = slot_getattr(slot, cdst->key_attnos[i], &isnull);
+		cdst->last_key_isnulls[i] = isnull;
+		cdst->last_key_values[i] =
+			isnull ? (Datum) 0 :
+					 datumCopy(value, cdst->key_attbyvals[i], cdst->key_attlens[i]);
+	}
+	MemoryContextSwitchTo(old_context);
+	cdst->last_key_valid = true;
+}
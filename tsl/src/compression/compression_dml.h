@@ -31,6 +31,28 @@ typedef struct tuple_filtering_constraints
 	bool vectorized_filtering;
 } tuple_filtering_constraints;
 
+/*
+ * Bloom filter probes over the unique key columns of the inserted tuple.
+ * A negative probe against the bloom1 sparse index column of a compressed
+ * batch proves that the batch cannot contain a conflicting tuple, so it
+ * does not have to be decompressed for the speculative insertion check.
+ * The probes are built once per chunk; the needle values are refreshed
+ * from the slot for every inserted tuple.
+ */
+typedef struct InsertBloomProbes
+{
+	int num_probes;
+	/* Attnos of the bloom1 metadata columns in the compressed chunk */
+	AttrNumber *bloom_attnos;
+	/* Attnos of the corresponding key columns in the hypertable slot */
+	AttrNumber *slot_attnos;
+	PGFunction *hash_functions;
+	FmgrInfo **hash_finfos;
+	/* Needle values taken from the currently inserted tuple */
+	Datum *values;
+	bool *isnulls;
+} InsertBloomProbes;
+
 bool slot_key_test(TupleTableSlot *slot, ScanKey skey);
 
 ScanKeyData *build_mem_scankeys_from_slot(Oid ht_relid, CompressionSettings *settings,
@@ -138,6 +138,16 @@ compression_chunk_create(Chunk *src_chunk, Chunk *chunk, List *column_defs, Oid
 	/* Inherit the persistence (LOGGED or UNLOGGED) from the uncompressed chunk */
 	create->relation->relpersistence = get_rel_persistence(src_chunk->table_id);
 
+	/*
+	 * In unlogged staging mode the uncompressed chunks are unlogged and
+	 * compression is where the data gets sealed into durable storage. Create
+	 * the compressed chunk logged, so the compressor's bulk writes emit the
+	 * (much smaller) compressed data to the WAL in one batch.
+	 */
+	Hypertable *uncompressed_ht = ts_hypertable_get_by_id(src_chunk->fd.hypertable_id);
+	if (ts_flags_are_set_32(uncompressed_ht->fd.status, HYPERTABLE_STATUS_UNLOGGED_STAGING))
+		create->relation->relpersistence = RELPERSISTENCE_PERMANENT;
+
 	tbladdress = DefineRelation(create, RELKIND_RELATION, owner, NULL, NULL);
 	CommandCounterIncrement();
 	chunk->table_id = tbladdress.objectId;
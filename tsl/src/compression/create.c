@@ -933,8 +933,17 @@ tsl_process_compress_table(Hypertable *ht, WithClauseResult *with_clause_options
 
 	validate_hypertable_for_compression(ht);
 
-	/* Lock the uncompressed ht in exclusive mode and keep till end of txn */
-	LockRelationOid(ht->main_table_relid, AccessExclusiveLock);
+	/*
+	 * Enabling compression or changing the settings only writes catalog
+	 * entries and possibly creates the internal compressed hypertable, so a
+	 * self-conflicting ShareUpdateExclusiveLock on the uncompressed
+	 * hypertable is enough to serialize concurrent settings changes without
+	 * blocking ingest into the existing chunks. Disabling compression drops
+	 * the internal compressed hypertable and still requires an
+	 * AccessExclusiveLock. Either lock is kept till end of txn.
+	 */
+	LockRelationOid(ht->main_table_relid,
+					compress_disable ? AccessExclusiveLock : ShareUpdateExclusiveLock);
 
 	/* reload info after lock */
 	ht = ts_hypertable_get_by_id(ht->fd.id);
@@ -119,6 +119,32 @@ tsl_recompress_chunk_segmentwise(PG_FUNCTION_ARGS)
 	PG_RETURN_OID(uncompressed_chunk_id);
 }
 
+/*
+ * Recompress a chunk that was partially decompressed by an UPDATE, at the end
+ * of the statement. Unlike the SQL-callable recompression, this runs as a
+ * side effect of DML, so any precondition that is not met silently skips the
+ * recompression instead of erroring out; the chunk then simply stays partial
+ * until the next recompression, as it would without this optimization.
+ */
+void
+tsl_recompress_chunk_for_dml(Oid chunk_relid)
+{
+	Assert(ts_guc_enable_dml_recompression);
+
+	if (!ts_guc_enable_segmentwise_recompression)
+		return;
+
+	Chunk *chunk = ts_chunk_get_by_relid(chunk_relid, false);
+	if (chunk == NULL || !ts_chunk_is_compressed(chunk) || !ts_chunk_is_partial(chunk))
+		return;
+
+	CompressionSettings *settings = ts_compression_settings_get(chunk_relid);
+	if (settings == NULL || !settings->fd.orderby)
+		return;
+
+	recompress_chunk_segmentwise_impl(chunk);
+}
+
 static RecompressContext *
 compress_chunk_populate_recompress_ctx(CompressionSettings *settings,
 									   Relation uncompressed_chunk_rel,
@@ -27,6 +27,7 @@ typedef struct RecompressContext
 } RecompressContext;
 
 extern Datum tsl_recompress_chunk_segmentwise(PG_FUNCTION_ARGS);
+extern void tsl_recompress_chunk_for_dml(Oid chunk_relid);
 
 Oid recompress_chunk_segmentwise_impl(Chunk *chunk);
 bool recompress_chunk_in_memory_impl(Chunk *uncompressed_chunk);
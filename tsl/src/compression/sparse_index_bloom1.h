@@ -9,6 +9,9 @@
 
 Datum bloom1_contains(PG_FUNCTION_ARGS);
 
+bool bloom1_maybe_contains(PGFunction hash_function, FmgrInfo *hash_finfo, struct varlena *bloom,
+						   Datum needle);
+
 Datum bloom1_contains_any(PG_FUNCTION_ARGS);
 
 PGFunction bloom1_get_hash_function(Oid type, FmgrInfo **finfo);
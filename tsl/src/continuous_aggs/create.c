@@ -76,6 +76,7 @@
 #include "hypertable.h"
 #include "hypertable_cache.h"
 #include "invalidation.h"
+#include "options.h"
 #include "refresh.h"
 #include "time_utils.h"
 #include "ts_catalog/catalog.h"
@@ -545,25 +546,23 @@ fixup_userview_query_tlist(Query *userquery, List *tlist_aliases)
  * CREATE VIEW mcagg ...
  * AS  select a, min(b)+max(d) from foo group by a,timebucket(a);
  *
- * Step 1. create a materialiation table which stores the partials for the
- * aggregates and the grouping columns + internal columns.
+ * Step 1. create a materialization table which stores the finalized aggregate
+ * values and the grouping columns + internal columns.
  * So we have a table like _materialization_hypertable
  * with columns:
- *( a, col1, col2, col3, internal-columns)
- * where col1 =  partialize(min(b)), col2= partialize(max(d)),
- * col3= timebucket(a))
+ *( a, col1, col2, internal-columns)
+ * where col1 = min(b)+max(d), col2= timebucket(a))
  *
  * Step 2: Create a view with modified select query
  * CREATE VIEW mcagg
  * as
- * select a, finalize( col1) + finalize(col2))
+ * select a, col1
  * from _materialization_hypertable
- * group by a, col3
  *
  * Step 3: Create a view to populate the materialization table
  * create view ts_internal_mcagg_view
  * as
- * select a, partialize(min(b)), partialize(max(d)), timebucket(a), <internal-columns>
+ * select a, min(b)+max(d), timebucket(a), <internal-columns>
  * from foo
  * group by <internal-columns> , a , timebucket(a);
  *
@@ -578,10 +577,9 @@ fixup_userview_query_tlist(Query *userquery, List *tlist_aliases)
  * CREATE VIEW mcagg
  * as
  * SELECT * from
- *        ( SELECT a, finalize(col1) + finalize(col2) from ts_internal_mcagg_view
+ *        ( SELECT a, col1 from ts_internal_mcagg_view
  *                 ---> query from Step 2 with additional where clause
  *          WHERE timecol < materialization threshold
- *          group by <internal-columns> , a , timebucket(a);
  *          UNION ALL
  *          SELECT a, min(b)+max(d) from foo ---> original view stmt
  *                              ----> with additional where clause
@@ -808,14 +806,6 @@ tsl_process_continuous_agg_viewstmt(Node *node, const char *query_string, void *
 		}
 	}
 
-	if (!with_clause_options[CreateMaterializedViewFlagColumnstore].is_default)
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-				 errmsg("cannot enable compression while creating a continuous aggregate"),
-				 errhint("Use ALTER MATERIALIZED VIEW to enable compression.")));
-	}
-
 	schema_name = get_namespace_name(nspid);
 	timebucket_exprinfo = cagg_validate_query((Query *) stmt->into->viewQuery,
 											  schema_name,
@@ -844,6 +834,15 @@ tsl_process_continuous_agg_viewstmt(Node *node, const char *query_string, void *
 
 	invalidation_threshold_initialize(cagg);
 
+	/* Forward any compression options from the WITH clause to the
+	 * materialization hypertable. This happens before the initial refresh so
+	 * that the columnstore settings are in place from the start. Unless
+	 * segmentby is given explicitly, it defaults to the grouping columns of
+	 * the continuous aggregate query. */
+	List *compression_options = ts_continuous_agg_get_compression_defelems(with_clause_options);
+	if (list_length(compression_options) > 0)
+		continuous_agg_alter_compression(cagg, mat_ht, compression_options, true);
+
 	if (!stmt->into->skipData)
 	{
 		InternalTimeRange refresh_window = {
@@ -15,6 +15,7 @@
 #include "guc.h"
 #include "invalidation.h"
 #include "partitioning.h"
+#include "ts_catalog/invalidation_threshold_cache.h"
 
 /*
  * When tuples in a hypertable that has a continuous aggregate are modified, the
@@ -60,6 +61,15 @@ static inline int64 cache_get_lowest_invalidated_time_for_hypertable(int32 hyper
 static HTAB *continuous_aggs_cache_inval_htab = NULL;
 static HTAB *continuous_aggs_cache_hyper_inval_threshold_htab = NULL;
 
+/*
+ * The entry used by the last invalidation. Rows typically arrive many in a
+ * row for the same chunk, so remembering the last entry avoids a hash probe
+ * per modified row on the hot DML path. Entry pointers are stable in a
+ * dynahash table, so the cached pointer stays valid until the hash table is
+ * destroyed at the end of the transaction.
+ */
+static ContinuousAggsCacheInvalEntry *last_cache_inval_entry = NULL;
+
 static MemoryContext continuous_aggs_invalidation_mctx = NULL;
 
 static inline void cache_inval_entry_init(ContinuousAggsCacheInvalEntry *cache_entry,
@@ -162,6 +172,9 @@ get_cache_inval_entry(int32 hypertable_id, Oid chunk_relid)
 	ContinuousAggsCacheInvalEntry *cache_entry;
 	bool found;
 
+	if (last_cache_inval_entry && last_cache_inval_entry->chunk_relid == chunk_relid)
+		return last_cache_inval_entry;
+
 	if (!continuous_aggs_cache_inval_htab)
 		cache_inval_init();
 
@@ -171,6 +184,8 @@ get_cache_inval_entry(int32 hypertable_id, Oid chunk_relid)
 	if (!found)
 		cache_inval_entry_init(cache_entry, hypertable_id, chunk_relid);
 
+	last_cache_inval_entry = cache_entry;
+
 	return cache_entry;
 }
 
@@ -249,6 +264,7 @@ cache_inval_cleanup(void)
 	continuous_aggs_cache_inval_htab = NULL;
 	continuous_aggs_cache_hyper_inval_threshold_htab = NULL;
 	continuous_aggs_invalidation_mctx = NULL;
+	last_cache_inval_entry = NULL;
 };
 
 static void
@@ -370,6 +386,13 @@ get_lowest_invalidated_time_for_hypertable(int32 hypertable_id)
 	ScanKeyData scankey[1];
 	ScannerCtx scanctx;
 
+	/* The shared-memory cache saves us the snapshot and catalog scan below.
+	 * Cached values are committed thresholds that can lag behind the catalog
+	 * but never run ahead of it, so at worst we write an invalidation entry
+	 * that the threshold already covers. */
+	if (ts_invalidation_threshold_cache_get(hypertable_id, &min_val))
+		return min_val;
+
 	PushActiveSnapshot(GetLatestSnapshot());
 	ScanKeyInit(&scankey[0],
 				Anum_continuous_aggs_invalidation_threshold_pkey_hypertable_id,
@@ -404,6 +427,8 @@ get_lowest_invalidated_time_for_hypertable(int32 hypertable_id)
 	 */
 	if (!ts_scanner_scan_one(&scanctx, false, CAGG_INVALIDATION_THRESHOLD_NAME))
 		min_val = INVAL_NEG_INFINITY;
+	else
+		ts_invalidation_threshold_cache_advance(hypertable_id, min_val);
 	PopActiveSnapshot();
 
 	return min_val;
@@ -102,6 +102,14 @@ typedef struct ContinuousAggInvalidationState
 	Relation cagg_queue_rel;
 	Snapshot snapshot;
 	Tuplestorestate *invalidations;
+
+	/* Invalidated ranges within the refresh window, in order of
+	 * lowest_modified_value. They are buffered here so that the number of
+	 * individual materializations can be capped before the ranges are
+	 * saved. */
+	Invalidation *refresh_ranges;
+	long num_refresh_ranges;
+	long refresh_ranges_capacity;
 } ContinuousAggInvalidationState;
 
 /*
@@ -158,9 +166,12 @@ static Invalidation cut_cagg_invalidation(const ContinuousAggInvalidationState *
 										  const InternalTimeRange *refresh_window,
 										  const Invalidation *entry);
 static Invalidation cut_cagg_invalidation_and_compute_remainder(
-	const ContinuousAggInvalidationState *state, const InternalTimeRange *refresh_window,
+	ContinuousAggInvalidationState *state, const InternalTimeRange *refresh_window,
 	const Invalidation *mergedentry, const Invalidation *current_remainder);
-static void clear_cagg_invalidations_for_refresh(const ContinuousAggInvalidationState *state,
+static void buffer_invalidation_for_refresh(ContinuousAggInvalidationState *state,
+											const Invalidation *invalidation);
+static long merge_closest_refresh_ranges(Invalidation *ranges, long num_ranges, long max_ranges);
+static void clear_cagg_invalidations_for_refresh(ContinuousAggInvalidationState *state,
 												 const InternalTimeRange *refresh_window,
 												 bool force);
 static void cagg_invalidation_state_init(ContinuousAggInvalidationState *state,
@@ -446,6 +457,120 @@ save_invalidation_for_refresh(const ContinuousAggInvalidationState *state,
 	return true;
 }
 
+/*
+ * Buffer an invalidated range that falls within the refresh window.
+ *
+ * The ranges are saved for refresh only after all invalidations have been
+ * processed, so that the number of individual materializations can be capped
+ * by merging ranges first.
+ */
+static void
+buffer_invalidation_for_refresh(ContinuousAggInvalidationState *state,
+								const Invalidation *invalidation)
+{
+	if (!IsValidInvalidation(invalidation))
+		return;
+
+	if (state->num_refresh_ranges == state->refresh_ranges_capacity)
+	{
+		state->refresh_ranges_capacity *= 2;
+		state->refresh_ranges =
+			repalloc(state->refresh_ranges, sizeof(Invalidation) * state->refresh_ranges_capacity);
+	}
+
+	state->refresh_ranges[state->num_refresh_ranges++] = *invalidation;
+}
+
+static int
+gap_cmp(const void *a, const void *b)
+{
+	int64 gap_a = *(const int64 *) a;
+	int64 gap_b = *(const int64 *) b;
+
+	if (gap_a < gap_b)
+		return -1;
+	if (gap_a > gap_b)
+		return 1;
+	return 0;
+}
+
+/*
+ * Reduce the number of refresh ranges down to max_ranges by merging the
+ * ranges that are closest together.
+ *
+ * The ranges arrive ordered by lowest_modified_value and do not overlap, so
+ * the merge candidates are consecutive pairs. Merging the pairs with the
+ * smallest gaps first keeps scattered invalidations as small targeted
+ * refreshes, while dense clusters of invalidations collapse into larger
+ * windows. The amount of up-to-date data that is re-materialized is the sum
+ * of the merged gaps, so picking the smallest gaps minimizes the extra work.
+ *
+ * Returns the new number of ranges, which is exactly max_ranges.
+ */
+static long
+merge_closest_refresh_ranges(Invalidation *ranges, long num_ranges, long max_ranges)
+{
+	const long num_gaps = num_ranges - 1;
+	long num_merges = num_ranges - max_ranges;
+	int64 *gaps;
+	int64 *sorted_gaps;
+	int64 gap_threshold;
+	long ties_left;
+	long out = 0;
+
+	Assert(num_merges > 0 && max_ranges > 0);
+
+	gaps = palloc(sizeof(int64) * num_gaps);
+
+	for (long i = 0; i < num_gaps; i++)
+	{
+		Assert(ranges[i].greatest_modified_value < ranges[i + 1].lowest_modified_value);
+		gaps[i] = int64_saturating_sub(ranges[i + 1].lowest_modified_value,
+									   ranges[i].greatest_modified_value);
+	}
+
+	/* Find the gap size at which the number of gaps that are smaller or equal
+	 * covers the needed number of merges. */
+	sorted_gaps = palloc(sizeof(int64) * num_gaps);
+	memcpy(sorted_gaps, gaps, sizeof(int64) * num_gaps);
+	qsort(sorted_gaps, num_gaps, sizeof(int64), gap_cmp);
+	gap_threshold = sorted_gaps[num_merges - 1];
+
+	/* There can be more gaps equal to the threshold than needed merges, so
+	 * put a budget on how many of them get merged. Gaps strictly below the
+	 * threshold are always merged. */
+	ties_left = num_merges;
+	for (long i = 0; i < num_gaps; i++)
+	{
+		if (sorted_gaps[i] < gap_threshold)
+			ties_left--;
+	}
+
+	for (long i = 1; i < num_ranges; i++)
+	{
+		const int64 gap = gaps[i - 1];
+
+		if (gap < gap_threshold || (gap == gap_threshold && ties_left > 0))
+		{
+			if (gap == gap_threshold)
+				ties_left--;
+			ranges[out].greatest_modified_value = ranges[i].greatest_modified_value;
+			ranges[out].is_modified = true;
+		}
+		else
+		{
+			ranges[++out] = ranges[i];
+		}
+	}
+
+	pfree(gaps);
+	pfree(sorted_gaps);
+
+	Assert(out + 1 == max_ranges);
+
+	return out + 1;
+}
+
 static void
 set_remainder_after_cut(Invalidation *remainder, int32 hyper_id, int64 lowest_modified_value,
 						int64 greatest_modified_value)
@@ -846,43 +971,49 @@ move_invalidations_from_hyper_to_cagg_log(const HypertableInvalidationState *sta
 {
 	const ContinuousAggInfo *all_caggs = state->all_caggs;
 	int32 hyper_id = state->hypertable_id;
-	int32 last_cagg_hyper_id;
+	int ncaggs = list_length(all_caggs->mat_hypertable_ids);
+	Invalidation *mergedentries;
+	ScanIterator iterator;
 	ListCell *lc1, *lc2;
-
-	last_cagg_hyper_id = llast_int(all_caggs->mat_hypertable_ids);
+	int i;
+
+	/* Per-cagg merge state. Entries need to expand to each continuous
+	 * aggregate's bucket boundaries, so each continuous aggregate merges
+	 * independently while sharing a single scan of the hypertable
+	 * invalidation log. The log can hold a large number of entries between
+	 * refreshes, so one shared scan beats one scan per continuous
+	 * aggregate. Since the merge only depends on entries arriving in order of
+	 * lowest_modified_value, feeding all merge states from the same ordered
+	 * scan produces the same entries in the cagg invalidation log as separate
+	 * scans would. */
+	Assert(ncaggs > 0);
+	mergedentries = palloc0(sizeof(Invalidation) * ncaggs);
 
 	/* We use a per-tuple memory context in the scan loop since we could be
 	 * processing a lot of invalidations (basically an unbounded
 	 * amount). Initialize it here by resetting it. */
 	MemoryContextReset(state->per_tuple_mctx);
 
-	/*
-	 * Looping over all continuous aggregates in the outer loop ensures all
-	 * tuples for a specific continuous aggregate is inserted consecutively in
-	 * the cagg invalidation log. This creates better locality for scanning
-	 * the invalidations later.
-	 */
-	forboth (lc1, all_caggs->mat_hypertable_ids, lc2, all_caggs->bucket_functions)
-	{
-		int32 cagg_hyper_id = lfirst_int(lc1);
-		const ContinuousAggBucketFunction *bucket_function = lfirst(lc2);
+	hypertable_invalidation_scan_init(&iterator, hyper_id, RowExclusiveLock);
+	iterator.ctx.snapshot = state->snapshot;
 
-		Invalidation mergedentry;
-		ScanIterator iterator;
+	/* Scan all invalidations */
+	ts_scanner_foreach(&iterator)
+	{
+		TupleInfo *ti;
+		MemoryContext oldmctx;
+		Invalidation logentry;
+		CatalogSecurityContext sec_ctx;
 
-		invalidation_entry_reset(&mergedentry);
-		hypertable_invalidation_scan_init(&iterator, hyper_id, RowExclusiveLock);
-		iterator.ctx.snapshot = state->snapshot;
+		oldmctx = MemoryContextSwitchTo(state->per_tuple_mctx);
+		ti = ts_scan_iterator_tuple_info(&iterator);
 
-		/* Scan all invalidations */
-		ts_scanner_foreach(&iterator)
+		i = 0;
+		forboth (lc1, all_caggs->mat_hypertable_ids, lc2, all_caggs->bucket_functions)
 		{
-			TupleInfo *ti;
-			MemoryContext oldmctx;
-			Invalidation logentry;
-
-			oldmctx = MemoryContextSwitchTo(state->per_tuple_mctx);
-			ti = ts_scan_iterator_tuple_info(&iterator);
+			int32 cagg_hyper_id = lfirst_int(lc1);
+			const ContinuousAggBucketFunction *bucket_function = lfirst(lc2);
+			Invalidation *mergedentry = &mergedentries[i++];
 
 			invalidation_entry_set_from_hyper_invalidation(&logentry,
 														   ti,
@@ -890,39 +1021,43 @@ move_invalidations_from_hyper_to_cagg_log(const HypertableInvalidationState *sta
 														   state->dimtype,
 														   bucket_function);
 
-			if (!IsValidInvalidation(&mergedentry))
+			if (!IsValidInvalidation(mergedentry))
 			{
-				mergedentry = logentry;
-				mergedentry.hyper_id = cagg_hyper_id;
+				*mergedentry = logentry;
+				mergedentry->hyper_id = cagg_hyper_id;
 			}
-			else if (!invalidation_entry_try_merge(&mergedentry, &logentry))
+			else if (!invalidation_entry_try_merge(mergedentry, &logentry))
 			{
-				insert_new_cagg_invalidation(state, &mergedentry, cagg_hyper_id);
-				mergedentry = logentry;
+				insert_new_cagg_invalidation(state, mergedentry, cagg_hyper_id);
+				*mergedentry = logentry;
 			}
+		}
 
-			if (cagg_hyper_id == last_cagg_hyper_id)
-			{
-				CatalogSecurityContext sec_ctx;
-
-				/* The invalidation has been processed for all caggs, so the
-				 * only thing left is to delete it from the source hypertable
-				 * invalidation log. */
-				ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
-				ts_catalog_delete_tid_only(ti->scanrel, &logentry.tid);
-				ts_catalog_restore_user(&sec_ctx);
-			}
+		/* The invalidation has been processed for all caggs, so the only
+		 * thing left is to delete it from the source hypertable invalidation
+		 * log. */
+		ts_catalog_database_info_become_owner(ts_catalog_database_info_get(), &sec_ctx);
+		ts_catalog_delete_tid_only(ti->scanrel, &logentry.tid);
+		ts_catalog_restore_user(&sec_ctx);
 
-			MemoryContextSwitchTo(oldmctx);
-			MemoryContextReset(state->per_tuple_mctx);
-		}
+		MemoryContextSwitchTo(oldmctx);
+		MemoryContextReset(state->per_tuple_mctx);
+	}
 
-		ts_scan_iterator_close(&iterator);
+	ts_scan_iterator_close(&iterator);
 
-		/* Handle the last merged invalidation */
-		if (IsValidInvalidation(&mergedentry))
-			insert_new_cagg_invalidation(state, &mergedentry, cagg_hyper_id);
+	/* Handle the last merged invalidation of each continuous aggregate */
+	i = 0;
+	foreach (lc1, all_caggs->mat_hypertable_ids)
+	{
+		int32 cagg_hyper_id = lfirst_int(lc1);
+		Invalidation *mergedentry = &mergedentries[i++];
+
+		if (IsValidInvalidation(mergedentry))
+			insert_new_cagg_invalidation(state, mergedentry, cagg_hyper_id);
 	}
+
+	pfree(mergedentries);
 }
 
 static void
@@ -988,7 +1123,7 @@ cut_cagg_invalidation(const ContinuousAggInvalidationState *state,
 }
 
 static Invalidation
-cut_cagg_invalidation_and_compute_remainder(const ContinuousAggInvalidationState *state,
+cut_cagg_invalidation_and_compute_remainder(ContinuousAggInvalidationState *state,
 											const InternalTimeRange *refresh_window,
 											const Invalidation *mergedentry,
 											const Invalidation *current_remainder)
@@ -1004,7 +1139,7 @@ cut_cagg_invalidation_and_compute_remainder(const ContinuousAggInvalidationState
 		remainder = new_remainder;
 	else if (!invalidation_entry_try_merge(&remainder, &new_remainder))
 	{
-		save_invalidation_for_refresh(state, &remainder);
+		buffer_invalidation_for_refresh(state, &remainder);
 		remainder = new_remainder;
 	}
 
@@ -1030,7 +1165,7 @@ cut_cagg_invalidation_and_compute_remainder(const ContinuousAggInvalidationState
  * lowest_modified_value.
  */
 static void
-clear_cagg_invalidations_for_refresh(const ContinuousAggInvalidationState *state,
+clear_cagg_invalidations_for_refresh(ContinuousAggInvalidationState *state,
 									 const InternalTimeRange *refresh_window, bool force)
 {
 	ScanIterator iterator;
@@ -1114,7 +1249,7 @@ process_remainder:
 																&remainder);
 
 	/* Handle the last (merged) remainder */
-	save_invalidation_for_refresh(state, &remainder);
+	buffer_invalidation_for_refresh(state, &remainder);
 }
 
 static void
@@ -1127,6 +1262,9 @@ cagg_invalidation_state_init(ContinuousAggInvalidationState *state, const Contin
 												  "Materialization invalidations",
 												  ALLOCSET_DEFAULT_SIZES);
 	state->snapshot = RegisterSnapshot(GetTransactionSnapshot());
+	state->refresh_ranges_capacity = 16;
+	state->refresh_ranges = palloc(sizeof(Invalidation) * state->refresh_ranges_capacity);
+	state->num_refresh_ranges = 0;
 }
 
 static void
@@ -1136,6 +1274,7 @@ cagg_invalidation_state_cleanup(const ContinuousAggInvalidationState *state)
 	table_close(state->cagg_queue_rel, NoLock);
 	UnregisterSnapshot(state->snapshot);
 	MemoryContextDelete(state->per_tuple_mctx);
+	pfree(state->refresh_ranges);
 }
 
 static void
@@ -1188,6 +1327,21 @@ invalidation_process_cagg_log(const ContinuousAgg *cagg, const InternalTimeRange
 	cagg_invalidation_state_init(&state, cagg);
 	state.invalidations = tuplestore_begin_heap(false, false, work_mem);
 	clear_cagg_invalidations_for_refresh(&state, refresh_window, force);
+
+	/*
+	 * Materializing a lot of scattered ranges separately is not efficient, so
+	 * cap the number of individual materializations by merging the ranges
+	 * that are closest together. See merge_closest_refresh_ranges() and the
+	 * comment on continuous_agg_refresh_with_window() for the reasoning.
+	 */
+	if (max_materializations > 0 && state.num_refresh_ranges > max_materializations)
+		state.num_refresh_ranges = merge_closest_refresh_ranges(state.refresh_ranges,
+																state.num_refresh_ranges,
+																max_materializations);
+
+	for (long i = 0; i < state.num_refresh_ranges; i++)
+		save_invalidation_for_refresh(&state, &state.refresh_ranges[i]);
+
 	count = tuplestore_tuple_count(state.invalidations);
 
 	if (count == 0)
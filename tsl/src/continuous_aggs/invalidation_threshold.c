@@ -26,6 +26,7 @@
 #include "debug_point.h"
 #include "invalidation_threshold.h"
 #include "ts_catalog/continuous_agg.h"
+#include "ts_catalog/invalidation_threshold_cache.h"
 
 /*
  * Invalidation threshold.
@@ -371,6 +372,12 @@ invalidation_threshold_initialize(const ContinuousAgg *cagg)
 
 	if (!found)
 	{
+		/* Creating the threshold at the MIN value moves it backwards compared
+		 * to whatever an earlier continuous aggregate on this hypertable left
+		 * behind, so the shared-memory threshold cache must be dropped before
+		 * writers can consult it again. */
+		ts_invalidation_threshold_cache_invalidate(cagg->data.raw_hypertable_id);
+
 		Relation rel =
 			table_open(catalog_get_table_id(catalog, CONTINUOUS_AGGS_INVALIDATION_THRESHOLD),
 					   ShareUpdateExclusiveLock);
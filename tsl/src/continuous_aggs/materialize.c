@@ -51,6 +51,7 @@ typedef enum MaterializationPlanType
 	PLAN_TYPE_MERGE,
 	PLAN_TYPE_MERGE_DELETE,
 	PLAN_TYPE_RANGES_SELECT,
+	PLAN_TYPE_RANGES_WAIT,
 	PLAN_TYPE_RANGES_DELETE,
 	PLAN_TYPE_RANGES_PENDING,
 	_MAX_MATERIALIZATION_PLAN_TYPES
@@ -67,6 +68,7 @@ typedef struct MaterializationContext
 	InternalTimeRange internal_materialization_range;
 	ItemPointer tupleid;
 	int nargs;
+	bool wait_for_inflight_ranges;
 } MaterializationContext;
 
 typedef char *(*MaterializationCreateStatement)(MaterializationContext *context);
@@ -89,6 +91,7 @@ static char *create_materialization_exists_statement(MaterializationContext *con
 static char *create_materialization_merge_statement(MaterializationContext *context);
 static char *create_materialization_merge_delete_statement(MaterializationContext *context);
 static char *create_materialization_ranges_select_statement(MaterializationContext *context);
+static char *create_materialization_ranges_wait_statement(MaterializationContext *context);
 static char *create_materialization_ranges_delete_statement(MaterializationContext *context);
 static char *create_materialization_ranges_pending_statement(MaterializationContext *context);
 
@@ -128,6 +131,11 @@ static MaterializationPlan materialization_plans[_MAX_MATERIALIZATION_PLAN_TYPES
 									  create_materialization_ranges_select_statement,
 								  .error_message = "could not select invalidation entries for "
 												   "materialization table \"%s.%s\"" },
+	[PLAN_TYPE_RANGES_WAIT] = { .catalog_security_context = true,
+								.nargs = 3,
+								.create_statement = create_materialization_ranges_wait_statement,
+								.error_message = "could not select invalidation entries for "
+												 "materialization table \"%s.%s\"" },
 	[PLAN_TYPE_RANGES_DELETE] = { .catalog_security_context = true,
 								  .nargs = 1,
 								  .create_statement =
@@ -156,6 +164,7 @@ static void free_materialization_plan(MaterializationContext *context,
 static void free_materialization_plans(MaterializationContext *context);
 
 static void update_watermark(MaterializationContext *context);
+static uint64 materialize_selected_range(MaterializationContext *context);
 static void execute_materializations(MaterializationContext *context);
 
 /* API to update materializations from refresh code */
@@ -164,7 +173,8 @@ continuous_agg_update_materialization(Hypertable *mat_ht, const ContinuousAgg *c
 									  SchemaAndName partial_view,
 									  SchemaAndName materialization_table,
 									  const NameData *time_column_name,
-									  InternalTimeRange materialization_range)
+									  InternalTimeRange materialization_range,
+									  bool wait_for_inflight_ranges)
 {
 	MaterializationContext context = {
 		.mat_ht = mat_ht,
@@ -174,6 +184,7 @@ continuous_agg_update_materialization(Hypertable *mat_ht, const ContinuousAgg *c
 		.time_column_name = (NameData *) time_column_name,
 		.materialization_range = internal_time_range_to_time_range(materialization_range),
 		.internal_materialization_range = materialization_range,
+		.wait_for_inflight_ranges = wait_for_inflight_ranges,
 	};
 
 	/* Lock down search_path */
@@ -637,6 +648,35 @@ create_materialization_ranges_select_statement(MaterializationContext *context)
 	return query.data;
 }
 
+/*
+ * Same as the ranges select statement, but without SKIP LOCKED so that the
+ * scan blocks on range entries a concurrent refresh is materializing. Once
+ * the concurrent refresh commits, its entries are deleted and the select
+ * comes back empty; if it aborts, the entries are returned and picked up
+ * here.
+ */
+static char *
+create_materialization_ranges_wait_statement(MaterializationContext *context)
+{
+	StringInfoData query;
+	initStringInfo(&query);
+
+	appendStringInfo(&query,
+					 "SELECT ctid, lowest_modified_value, greatest_modified_value "
+					 "FROM _timescaledb_catalog.continuous_aggs_materialization_ranges "
+					 "WHERE materialization_id = $1 "
+					 "AND greatest_modified_value >= lowest_modified_value "
+					 "AND lowest_modified_value >= $2 "
+					 "AND greatest_modified_value <= $3 "
+					 "AND pg_catalog.int8range(lowest_modified_value, greatest_modified_value) && "
+					 "pg_catalog.int8range($2, $3) "
+					 "ORDER BY lowest_modified_value ASC "
+					 "LIMIT 1 "
+					 "FOR UPDATE ");
+
+	return query.data;
+}
+
 static char *
 create_materialization_ranges_delete_statement(MaterializationContext *context)
 {
@@ -680,6 +720,7 @@ create_materialization_plan_argtypes(MaterializationContext *context,
 	switch (plan_type)
 	{
 		case PLAN_TYPE_RANGES_SELECT: /* 3 arguments */
+		case PLAN_TYPE_RANGES_WAIT:
 		case PLAN_TYPE_RANGES_PENDING:
 			argtypes[0] = INT4OID; /* materialization_id */
 			argtypes[1] = INT8OID;
@@ -733,6 +774,7 @@ create_materialization_plan_args(MaterializationContext *context, Materializatio
 	switch (plan_type)
 	{
 		case PLAN_TYPE_RANGES_SELECT: /* 3 arguments */
+		case PLAN_TYPE_RANGES_WAIT:
 		case PLAN_TYPE_RANGES_PENDING:
 		{
 			/* read the maximum of one bucket before the window start and after the window end to
@@ -817,7 +859,8 @@ execute_materialization_plan(MaterializationContext *context, MaterializationPla
 			 NameStr(*context->materialization_table.name));
 	}
 
-	if (SPI_processed > 0 && plan_type == PLAN_TYPE_RANGES_SELECT)
+	if (SPI_processed > 0 &&
+		(plan_type == PLAN_TYPE_RANGES_SELECT || plan_type == PLAN_TYPE_RANGES_WAIT))
 	{
 		bool isnull;
 		Datum dat;
@@ -920,6 +963,47 @@ update_watermark(MaterializationContext *context)
 	}
 }
 
+/*
+ * Materialize the range entry selected into the context by a preceding
+ * ranges select plan and delete it from the pending ranges table.
+ */
+static uint64
+materialize_selected_range(MaterializationContext *context)
+{
+	uint64 rows_processed = 0;
+
+	/* MERGE statement is supported only for non-compressed CAggs */
+	if (ts_guc_enable_merge_on_cagg_refresh &&
+		!TS_HYPERTABLE_HAS_COMPRESSION_ENABLED(context->mat_ht))
+	{
+		/* Fallback to INSERT materializations if there are no rows to change on it */
+		if (execute_materialization_plan(context, PLAN_TYPE_EXISTS) == 0)
+		{
+			elog(DEBUG2,
+				 "no rows to merge on materialization table \"%s.%s\", falling back to "
+				 "INSERT",
+				 NameStr(*context->materialization_table.schema),
+				 NameStr(*context->materialization_table.name));
+			rows_processed = execute_materialization_plan(context, PLAN_TYPE_INSERT);
+		}
+		else
+		{
+			rows_processed += execute_materialization_plan(context, PLAN_TYPE_MERGE);
+			rows_processed += execute_materialization_plan(context, PLAN_TYPE_MERGE_DELETE);
+		}
+	}
+	else
+	{
+		rows_processed += execute_materialization_plan(context, PLAN_TYPE_DELETE);
+		rows_processed += execute_materialization_plan(context, PLAN_TYPE_INSERT);
+	}
+
+	/* Delete the pending range entry */
+	rows_processed += execute_materialization_plan(context, PLAN_TYPE_RANGES_DELETE);
+
+	return rows_processed;
+}
+
 static void
 execute_materializations(MaterializationContext *context)
 {
@@ -927,6 +1011,7 @@ execute_materializations(MaterializationContext *context)
 	bool prev_enable_direct_compress_insert = ts_guc_enable_direct_compress_insert;
 	bool prev_enable_direct_compress_insert_client_sorted =
 		ts_guc_enable_direct_compress_insert_client_sorted;
+	bool prev_enable_insert_batching = ts_guc_enable_insert_batching;
 
 	if (has_direct_compress_on_cagg_refresh_enabled(context))
 	{
@@ -941,39 +1026,32 @@ execute_materializations(MaterializationContext *context)
 						PGC_USERSET,
 						PGC_S_SESSION);
 	}
+	else
+	{
+		/* Force multi-insert buffering for the materialization INSERT. The
+		 * INSERT from the partial view is a pure bulk load into the
+		 * materialized hypertable (no RETURNING, ON CONFLICT or row triggers
+		 * observing per-row insert order), which is exactly the case the
+		 * buffered insert path is made for. The insert path re-checks these
+		 * conditions and falls back to single inserts if they do not hold. */
+		SetConfigOption("timescaledb.enable_insert_batching", "on", PGC_USERSET, PGC_S_SESSION);
+	}
 
 	PG_TRY();
 	{
 		while (execute_materialization_plan(context, PLAN_TYPE_RANGES_SELECT) > 0)
+			rows_processed += materialize_selected_range(context);
+
+		/* The SKIP LOCKED scan above passes over range entries that a
+		 * concurrent refresh is materializing. When requested, wait for
+		 * those refreshes by re-scanning without SKIP LOCKED so that the
+		 * overlapping part of the window is guaranteed to be materialized
+		 * when we return. Entries whose holder aborted are picked up and
+		 * materialized here. */
+		if (context->wait_for_inflight_ranges)
 		{
-			/* MERGE statement is supported only for non-compressed CAggs */
-			if (ts_guc_enable_merge_on_cagg_refresh &&
-				!TS_HYPERTABLE_HAS_COMPRESSION_ENABLED(context->mat_ht))
-			{
-				/* Fallback to INSERT materializations if there are no rows to change on it */
-				if (execute_materialization_plan(context, PLAN_TYPE_EXISTS) == 0)
-				{
-					elog(DEBUG2,
-						 "no rows to merge on materialization table \"%s.%s\", falling back to "
-						 "INSERT",
-						 NameStr(*context->materialization_table.schema),
-						 NameStr(*context->materialization_table.name));
-					rows_processed = execute_materialization_plan(context, PLAN_TYPE_INSERT);
-				}
-				else
-				{
-					rows_processed += execute_materialization_plan(context, PLAN_TYPE_MERGE);
-					rows_processed += execute_materialization_plan(context, PLAN_TYPE_MERGE_DELETE);
-				}
-			}
-			else
-			{
-				rows_processed += execute_materialization_plan(context, PLAN_TYPE_DELETE);
-				rows_processed += execute_materialization_plan(context, PLAN_TYPE_INSERT);
-			}
-
-			/* Delete the pending range entry */
-			rows_processed += execute_materialization_plan(context, PLAN_TYPE_RANGES_DELETE);
+			while (execute_materialization_plan(context, PLAN_TYPE_RANGES_WAIT) > 0)
+				rows_processed += materialize_selected_range(context);
 		}
 
 		/* Free all cached plans */
@@ -1002,4 +1080,8 @@ execute_materializations(MaterializationContext *context)
 					prev_enable_direct_compress_insert_client_sorted ? "on" : "off",
 					PGC_USERSET,
 					PGC_S_SESSION);
+	SetConfigOption("timescaledb.enable_insert_batching",
+					prev_enable_insert_batching ? "on" : "off",
+					PGC_USERSET,
+					PGC_S_SESSION);
 }
@@ -29,8 +29,8 @@
 
 static void cagg_update_materialized_only(ContinuousAgg *agg, bool materialized_only);
 static List *cagg_get_compression_params(ContinuousAgg *agg, Hypertable *mat_ht,
-										 WithClauseResult *with_clause_options);
-static void cagg_alter_compression(ContinuousAgg *agg, Hypertable *mat_ht, List *compress_defelems);
+										 WithClauseResult *with_clause_options,
+										 bool segmentby_from_groupcols);
 
 static void
 cagg_update_materialized_only(ContinuousAgg *agg, bool materialized_only)
@@ -78,15 +78,26 @@ cagg_update_materialized_only(ContinuousAgg *agg, bool materialized_only)
 /* get the compression parameters for cagg. The parameters are
  * derived from the cagg view definition.
  * Computes:
- * compress_orderby = time_bucket column from cagg query followed by remaining grouping columns
+ * compress_segmentby = grouping columns of the cagg query, when
+ *                      segmentby_from_groupcols is set and no explicit
+ *                      segmentby was given
+ * compress_orderby = time_bucket column from cagg query followed by any
+ *                    grouping columns not covered by segmentby
+ *
+ * Only the create path opts into deriving segmentby from the grouping
+ * columns: changing the default under existing continuous aggregates that
+ * enabled columnstore earlier would silently alter their settings when
+ * columnstore is re-enabled.
  */
 static List *
 cagg_get_compression_params(ContinuousAgg *agg, Hypertable *mat_ht,
-							WithClauseResult *with_clause_options)
+							WithClauseResult *with_clause_options, bool segmentby_from_groupcols)
 {
 	const Dimension *mat_ht_dim = hyperspace_get_open_dimension(mat_ht->space, 0);
 	StringInfoData info;
 	initStringInfo(&info);
+	StringInfoData segmentby_info;
+	initStringInfo(&segmentby_info);
 	ArrayType *segmentby_columns = NULL;
 
 	/* add time column as first entry */
@@ -113,6 +124,19 @@ cagg_get_compression_params(ContinuousAgg *agg, Hypertable *mat_ht,
 			if (segmentby_columns && ts_array_is_member(segmentby_columns, grpcol))
 				continue;
 
+			/* Without an explicit segmentby, segment by the grouping columns
+			 * instead of folding them into the orderby. Queries over the cagg
+			 * typically filter or group on these columns, and making them
+			 * segmentby keeps each group's buckets in contiguous compressed
+			 * batches that can be filtered without decompression. */
+			if (segmentby_from_groupcols && with_clause_options[AlterTableFlagSegmentBy].is_default)
+			{
+				if (segmentby_info.len > 0)
+					appendStringInfoString(&segmentby_info, ",");
+				appendStringInfoString(&segmentby_info, quote_identifier(grpcol));
+				continue;
+			}
+
 			if (info.len > 0)
 				appendStringInfoString(&info, ",");
 			appendStringInfoString(&info, quote_identifier(grpcol));
@@ -124,13 +148,23 @@ cagg_get_compression_params(ContinuousAgg *agg, Hypertable *mat_ht,
 										 (Node *) makeString(info.data),
 										 DEFELEM_UNSPEC,
 										 -1);
+	List *params = list_make1(ordby);
 
-	return list_make1(ordby);
+	if (segmentby_info.len > 0)
+		params = lappend(params,
+						 makeDefElemExtended(EXTENSION_NAMESPACE,
+											 "compress_segmentby",
+											 (Node *) makeString(segmentby_info.data),
+											 DEFELEM_UNSPEC,
+											 -1));
+
+	return params;
 }
 
 /* forwards compression related changes via an alter statement to the underlying HT */
-static void
-cagg_alter_compression(ContinuousAgg *agg, Hypertable *mat_ht, List *compress_defelems)
+void
+continuous_agg_alter_compression(ContinuousAgg *agg, Hypertable *mat_ht, List *compress_defelems,
+								 bool segmentby_from_groupcols)
 {
 	Assert(mat_ht != NULL);
 	WithClauseResult *with_clause_options = ts_alter_table_with_clause_parse(compress_defelems);
@@ -138,7 +172,7 @@ cagg_alter_compression(ContinuousAgg *agg, Hypertable *mat_ht, List *compress_de
 	if (with_clause_options[AlterTableFlagColumnstore].parsed)
 	{
 		List *default_compress_defelems =
-			cagg_get_compression_params(agg, mat_ht, with_clause_options);
+			cagg_get_compression_params(agg, mat_ht, with_clause_options, segmentby_from_groupcols);
 		WithClauseResult *default_with_clause_options =
 			ts_alter_table_with_clause_parse(default_compress_defelems);
 		/* Merge defaults if there's any. */
@@ -210,7 +244,7 @@ continuous_agg_update_options(ContinuousAgg *agg, WithClauseResult *with_clause_
 			ts_hypertable_cache_get_entry_by_id(hcache, agg->data.mat_hypertable_id);
 		Assert(mat_ht != NULL);
 
-		cagg_alter_compression(agg, mat_ht, compression_options);
+		continuous_agg_alter_compression(agg, mat_ht, compression_options, false);
 		ts_cache_release(&hcache);
 	}
 
@@ -12,3 +12,6 @@
 
 extern void continuous_agg_update_options(ContinuousAgg *cagg,
 										  WithClauseResult *with_clause_options);
+extern void continuous_agg_alter_compression(ContinuousAgg *cagg, Hypertable *mat_ht,
+											 List *compress_defelems,
+											 bool segmentby_from_groupcols);
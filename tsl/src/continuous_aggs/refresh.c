@@ -34,6 +34,7 @@
 #include "time_utils.h"
 #include "ts_catalog/catalog.h"
 #include "ts_catalog/continuous_agg.h"
+#include "ts_catalog/invalidation_threshold_cache.h"
 
 #define CAGG_REFRESH_LOG_LEVEL                                                                     \
 	(context.callctx == CAGG_REFRESH_POLICY || context.callctx == CAGG_REFRESH_POLICY_BATCHED ?    \
@@ -60,7 +61,8 @@ static void continuous_agg_refresh_init(ContinuousAggRefreshState *refresh,
 										const InternalTimeRange *refresh_window,
 										bool bucketing_refresh_window);
 static void continuous_agg_refresh_execute(const ContinuousAggRefreshState *refresh,
-										   const InternalTimeRange *bucketed_refresh_window);
+										   const InternalTimeRange *bucketed_refresh_window,
+										   bool wait_for_inflight_ranges);
 static void log_refresh_window(int elevel, const ContinuousAgg *cagg,
 							   const InternalTimeRange *refresh_window,
 							   ContinuousAggRefreshContext context);
@@ -399,7 +401,8 @@ continuous_agg_refresh_init(ContinuousAggRefreshState *refresh, const Continuous
  */
 static void
 continuous_agg_refresh_execute(const ContinuousAggRefreshState *refresh,
-							   const InternalTimeRange *bucketed_refresh_window)
+							   const InternalTimeRange *bucketed_refresh_window,
+							   bool wait_for_inflight_ranges)
 {
 	SchemaAndName cagg_hypertable_name = {
 		.schema = &refresh->cagg_ht->fd.schema_name,
@@ -414,7 +417,8 @@ continuous_agg_refresh_execute(const ContinuousAggRefreshState *refresh,
 										  refresh->partial_view,
 										  cagg_hypertable_name,
 										  &time_dim->fd.column_name,
-										  *bucketed_refresh_window);
+										  *bucketed_refresh_window,
+										  wait_for_inflight_ranges);
 }
 
 static void
@@ -454,7 +458,7 @@ continuous_agg_refresh_execute_wrapper(const InternalTimeRange *bucketed_refresh
 	(void) iteration;
 
 	log_refresh_window(CAGG_REFRESH_LOG_LEVEL, &refresh->cagg, bucketed_refresh_window, context);
-	continuous_agg_refresh_execute(refresh, bucketed_refresh_window);
+	continuous_agg_refresh_execute(refresh, bucketed_refresh_window, false);
 }
 
 static long
@@ -506,6 +510,16 @@ continuous_agg_scan_refresh_window_ranges(const ContinuousAgg *cagg,
 															  &invalidation,
 															  cagg->bucket_function);
 		}
+
+		/* Materialize each range in its own transaction so that locks taken
+		 * while materializing one range are released before starting on the
+		 * next one. Completing a range commits the deletion of its entry in
+		 * the materialization ranges table, so concurrent refreshes over the
+		 * same window (or a re-run after a failure) only pick up the ranges
+		 * that remain. */
+		if (count > 0 && ts_guc_enable_cagg_refresh_range_transactions)
+			SPI_commit_and_chain();
+
 		(*exec_func)(&bucketed_refresh_window, context, count, func_arg1);
 
 		count++;
@@ -525,7 +539,7 @@ continuous_agg_scan_refresh_window_ranges(const ContinuousAgg *cagg,
  *
  * Refresh window:  [-----------------------------------------)
  * Invalid ranges:           [-----] [-]   [--] [-] [---]
- * Merged range:             [---------------------------)
+ * Merged ranges:            [---------]   [--------------]
  *
  * The maximum number of individual (non-mergeable) ranges are
  * #buckets_in_window/2 (i.e., every other bucket is invalid).
@@ -533,14 +547,16 @@ continuous_agg_scan_refresh_window_ranges(const ContinuousAgg *cagg,
  * Since it might not be efficient to materialize a lot buckets separately
  * when there are many invalid (non-adjecent) buckets/ranges, we put a limit
  * on the number of individual materializations we do. This limit is
- * determined by the MATERIALIZATIONS_PER_REFRESH_WINDOW setting.
+ * determined by the materializations_per_refresh_window setting.
  *
  * Thus, if the refresh window covers a large number of buckets, but only a
  * few of them are invalid, it is likely beneficial to materialized these
  * separately to avoid materializing a lot of buckets that are already
  * up-to-date. But if the number of invalid buckets/ranges go above the
- * threshold, we materialize all of them in one go using the "merged range",
- * as illustrated above.
+ * threshold, ranges are merged starting with the ones that are closest
+ * together until the limit is met, as illustrated above. This keeps
+ * scattered invalidations as small targeted refreshes while dense clusters
+ * collapse into larger windows.
  */
 static void
 continuous_agg_refresh_with_window(const ContinuousAgg *cagg,
@@ -803,7 +819,7 @@ continuous_agg_refresh_internal(const ContinuousAgg *cagg,
 	}
 
 	/*
-	 * Perform the refresh across two transactions.
+	 * Perform the refresh across multiple transactions.
 	 *
 	 * The first transaction moves the invalidation threshold (if needed) and
 	 * copies over invalidations from the hypertable log to the cagg
@@ -812,10 +828,15 @@ continuous_agg_refresh_internal(const ContinuousAgg *cagg,
 	 * visible as soon as possible to concurrent refreshes and that we keep
 	 * locks for only a short period.
 	 *
-	 * The second transaction processes the cagg invalidation log and then
-	 * performs the actual refresh (materialization of data). This transaction
-	 * serializes around a lock on the materialized hypertable for the
-	 * continuous aggregate that gets refreshed.
+	 * The second transaction processes the cagg invalidation log and inserts
+	 * the resulting refresh ranges into the materialization ranges table. This
+	 * transaction serializes around a lock on the materialized hypertable for
+	 * the continuous aggregate that gets refreshed.
+	 *
+	 * The actual refresh (materialization of data) then consumes the queued
+	 * ranges, by default one transaction per range so that concurrent
+	 * refreshes can pick up the ranges that remain (see
+	 * continuous_agg_scan_refresh_window_ranges).
 	 */
 
 	/* Set the new invalidation threshold. Note that this only updates the
@@ -880,11 +901,24 @@ continuous_agg_refresh_internal(const ContinuousAgg *cagg,
 		invalidation_process_hypertable_log(cagg->data.raw_hypertable_id, refresh_window.type);
 	}
 
+	int32 raw_hypertable_id = cagg->data.raw_hypertable_id;
+
 	/* Commit and Start a new transaction */
 	SPI_commit_and_chain();
 
+	/* The first transaction has committed, so the invalidation threshold set
+	 * above is durable and can be published to the shared-memory threshold
+	 * cache that writers consult. Publishing only after the commit keeps the
+	 * cache from ever running ahead of the catalog row. */
+	ts_invalidation_threshold_cache_advance(raw_hypertable_id, invalidation_threshold);
+
 	cagg = ts_continuous_agg_find_by_mat_hypertable_id(mat_id, false);
 
+	/* Save the threshold-capped window for the hierarchical catch-up pass
+	 * below, since refresh_window is reset to the original window for the
+	 * pending materializations check. */
+	const InternalTimeRange capped_refresh_window = refresh_window;
+
 	bool refreshed = process_cagg_invalidations_and_refresh(cagg,
 															&refresh_window,
 															context,
@@ -934,7 +968,44 @@ continuous_agg_refresh_internal(const ContinuousAgg *cagg,
 															  cagg->bucket_function);
 		}
 
-		continuous_agg_refresh_execute(&refresh, &bucketed_refresh_window);
+		/* Wait for ranges that a concurrent refresh has in flight instead of
+		 * skipping them, so that the whole requested window is materialized
+		 * when the refresh returns without redoing the overlap. */
+		continuous_agg_refresh_execute(&refresh, &bucketed_refresh_window, true);
+	}
+
+	/* For hierarchical continuous aggregates refreshed by policy, a parent
+	 * refresh may be running concurrently, committing materialized ranges
+	 * into our raw (the parent's materialized) hypertable while we were
+	 * materializing above. Each of those ranges shows up in the hypertable
+	 * invalidation log as the parent commits it, but only the entries
+	 * committed before our first transaction were picked up by the initial
+	 * invalidation processing. Do one catch-up pass over the logs so that
+	 * ranges the parent completed during our run are materialized now rather
+	 * than in the next policy cycle. Limiting this to a single extra pass
+	 * guarantees termination while still pipelining concurrently scheduled
+	 * parent and child refreshes.
+	 */
+	if (ContinuousAggIsHierarchical(cagg) && process_hypertable_invalidations &&
+		(context.callctx == CAGG_REFRESH_POLICY || context.callctx == CAGG_REFRESH_POLICY_BATCHED))
+	{
+		SPI_commit_and_chain();
+
+		invalidation_process_hypertable_log(cagg->data.raw_hypertable_id, refresh_window.type);
+
+		SPI_commit_and_chain();
+
+		cagg = ts_continuous_agg_find_by_mat_hypertable_id(mat_id, false);
+
+		/* Use force=false here even if the caller forced the refresh: the
+		 * whole window was already reprocessed above, so this pass only needs
+		 * to cover newly arrived invalidations. */
+		if (process_cagg_invalidations_and_refresh(cagg,
+												   &capped_refresh_window,
+												   context,
+												   bucketing_refresh_window,
+												   false /* force */))
+			refreshed = true;
 	}
 
 	if (!refreshed && !has_pending_materializations)
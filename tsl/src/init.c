@@ -17,11 +17,13 @@
 #include "bgw_policy/retention_api.h"
 #include "chunk.h"
 #include "chunk_api.h"
+#include "compression/algorithms/alp.h"
 #include "compression/algorithms/array.h"
 #include "compression/algorithms/bool_compress.h"
 #include "compression/algorithms/deltadelta.h"
 #include "compression/algorithms/dictionary.h"
 #include "compression/algorithms/gorilla.h"
+#include "compression/algorithms/rle.h"
 #include "compression/algorithms/uuid_compress.h"
 #include "compression/api.h"
 #include "compression/compression.h"
@@ -162,6 +164,10 @@ CrossModuleFunctions tsl_cm_functions = {
 	.bool_compressor_finish = tsl_bool_compressor_finish,
 	.uuid_compressor_append = tsl_uuid_compressor_append,
 	.uuid_compressor_finish = tsl_uuid_compressor_finish,
+	.alp_compressor_append = tsl_alp_compressor_append,
+	.alp_compressor_finish = tsl_alp_compressor_finish,
+	.rle_compressor_append = tsl_rle_compressor_append,
+	.rle_compressor_finish = tsl_rle_compressor_finish,
 	.bloom1_contains = bloom1_contains,
 	.bloom1_contains_any = bloom1_contains_any,
 	.bloom1_get_hash_function = bloom1_get_hash_function,
@@ -174,6 +180,7 @@ CrossModuleFunctions tsl_cm_functions = {
 	.decompress_batches_for_insert = decompress_batches_for_insert,
 	.init_decompress_state_for_insert = init_decompress_state_for_insert,
 	.decompress_target_segments = decompress_target_segments,
+	.recompress_chunk_for_dml = tsl_recompress_chunk_for_dml,
 	.columnstore_setup = tsl_columnstore_setup,
 	.compressor_init = tsl_compressor_init,
 	.compressor_set_invalidation = tsl_compressor_set_invalidation,
@@ -183,6 +190,7 @@ CrossModuleFunctions tsl_cm_functions = {
 	.compression_chunk_create = tsl_compression_chunk_create,
 	.show_chunk = chunk_show,
 	.create_compressed_chunk = tsl_create_compressed_chunk,
+	.backfill_compressed_chunk = tsl_backfill_compressed_chunk,
 	.create_chunk = chunk_create,
 	.chunk_freeze_chunk = chunk_freeze_chunk,
 	.chunk_unfreeze_chunk = chunk_unfreeze_chunk,
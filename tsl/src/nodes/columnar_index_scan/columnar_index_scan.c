@@ -220,6 +220,14 @@ can_use_columnar_index_scan(PlannerInfo *root, const Chunk *chunk, RelOptInfo *c
 	/*
 	 * Only quals on non-segmentby constraints should be left in chunk_rel.
 	 * Segmentby constraints should be pushed into compressed chunk.
+	 *
+	 * Note that sparse-index exclusion (minmax and bloom1 metadata) does not
+	 * need any handling here: qual pushdown rewrites eligible quals into
+	 * checks on the metadata columns of the compressed relation, so they are
+	 * evaluated by the compressed scan below this node. Since this node reads
+	 * only metadata and segmentby columns and never decompresses batch data,
+	 * batches excluded by the sparse indexes are filtered out before they
+	 * reach us.
 	 */
 	if (chunk_rel->baserestrictinfo != NIL)
 		return false;
@@ -16,6 +16,9 @@ typedef struct ColumnarIndexScanState
 
 	List *output_map;
 
+	/* Highest attribute referenced in output_map, for one-shot deforming */
+	AttrNumber max_attno;
+
 	/* Custom scan tuple slot */
 	TupleTableSlot *custom_scan_slot;
 } ColumnarIndexScanState;
@@ -60,6 +63,10 @@ columnar_index_scan_begin(CustomScanState *node, EState *estate, int eflags)
 
 	/* Use the scan tuple slot set up by PostgreSQL */
 	state->custom_scan_slot = node->ss.ss_ScanTupleSlot;
+
+	ListCell *lc;
+	foreach (lc, state->output_map)
+		state->max_attno = Max(state->max_attno, lfirst_int(lc));
 }
 
 static TupleTableSlot *
@@ -76,14 +83,17 @@ columnar_index_scan_exec(CustomScanState *node)
 	TupleTableSlot *result_slot = state->custom_scan_slot;
 	ExecClearTuple(result_slot);
 
+	/* Deform all referenced attributes in one pass instead of restarting the
+	 * deforming loop for every slot_getattr call */
+	slot_getsomeattrs(compressed_slot, state->max_attno);
+
 	ListCell *lc;
 	int i = 0;
 	foreach (lc, state->output_map)
 	{
-		bool isnull;
-		AttrNumber attno = lfirst_int(lc);
-		Datum value = slot_getattr(compressed_slot, attno, &isnull);
-		result_slot->tts_values[i] = isnull ? UnassignedDatum : value;
+		int off = AttrNumberGetAttrOffset(lfirst_int(lc));
+		bool isnull = compressed_slot->tts_isnull[off];
+		result_slot->tts_values[i] = isnull ? UnassignedDatum : compressed_slot->tts_values[off];
 		result_slot->tts_isnull[i] = isnull;
 		i++;
 	}
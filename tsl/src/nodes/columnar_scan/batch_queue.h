@@ -22,6 +22,9 @@ typedef struct BatchQueueFunctions
 	bool (*needs_next_batch)(struct BatchQueue *);
 	void (*pop)(struct BatchQueue *, DecompressContext *);
 	void (*push_batch)(struct BatchQueue *, DecompressContext *, TupleTableSlot *);
+	/* Called when the input has no more compressed tuples, so that the queue
+	 * can finalize any deferred work before the remaining tuples are drained. */
+	void (*input_ended)(struct BatchQueue *, DecompressContext *);
 	void (*reset)(struct BatchQueue *);
 	TupleTableSlot *(*top_tuple)(struct BatchQueue *);
 } BatchQueueFunctions;
@@ -42,9 +42,16 @@ batch_queue_fifo_push_batch(BatchQueue *bq, DecompressContext *dcontext,
 	DecompressBatchState *batch_state = batch_array_get_at(batch_array, 0);
 	Assert(TupIsNull(compressed_batch_current_tuple(batch_array_get_at(batch_array, 0))));
 	compressed_batch_set_compressed_tuple(dcontext, batch_state, compressed_slot);
+	compressed_batch_account_memory(dcontext, batch_array);
 	compressed_batch_advance(dcontext, batch_state);
 }
 
+static inline void
+batch_queue_fifo_input_ended(BatchQueue *bq, DecompressContext *dcontext)
+{
+	/* The FIFO queue never defers any work. */
+}
+
 static inline void
 batch_queue_fifo_reset(BatchQueue *bq)
 {
@@ -62,6 +69,7 @@ static const struct BatchQueueFunctions BatchQueueFunctionsFifo = {
 	.needs_next_batch = batch_queue_fifo_needs_next_batch,
 	.pop = batch_queue_fifo_pop,
 	.push_batch = batch_queue_fifo_push_batch,
+	.input_ended = batch_queue_fifo_input_ended,
 	.reset = batch_queue_fifo_reset,
 	.top_tuple = batch_queue_fifo_top_tuple,
 };
@@ -4,8 +4,9 @@
  * LICENSE-TIMESCALE for a copy of the license.
  */
 #include <postgres.h>
-#include <lib/binaryheap.h>
 #include <nodes/bitmapset.h>
+#include <nodes/value.h>
+#include <port/pg_bitutils.h>
 
 #include "compression/compression.h"
 #include "nodes/columnar_scan/batch_array.h"
@@ -18,35 +19,76 @@ typedef struct
 	bool null;
 } HeapEntryColumn;
 
-typedef struct BatchQueueHeap
+typedef struct BatchQueueHeap BatchQueueHeap;
+
+struct BatchQueueHeap
 {
 	BatchQueue queue;
-	binaryheap *merge_heap; /* Binary heap of slot indices */
 
 	/*
-	 * Requested sort order of the heap.
+	 * Requested sort order of the merge.
 	 */
 	int nkeys;
 	SortSupport sortkeys;
 
 	/*
-	 * This is the actual entries of the heap we're going to compare. We're using
-	 * these minimal structures for better memory locality instead of addressing
-	 * the entire compressed batches. Would be even better to put them into the
-	 * heap inline, but unfortunately the Postgres binary heap doesn't support
-	 * this.
+	 * This is the actual entries of the merge tree we're going to compare.
+	 * We're using these minimal structures for better memory locality instead
+	 * of addressing the entire compressed batches.
 	 *
 	 * For each batch, we have nkeys of HeapEntryColumn values, which contain
 	 * the latest decompressed values.
 	 */
 	HeapEntryColumn *heap_entries;
 
+	/*
+	 * Loser tree over the open batches, used to find the batch with the
+	 * minimal current tuple. The leaves of the tree correspond to the batch
+	 * array slots, so the leaf number is the batch index, and the sort keys of
+	 * the leaf are the heap entries of the respective batch. The internal
+	 * nodes tree_losers[1 .. tree_capacity - 1] store the batch index of the
+	 * loser of the comparison played at that node, and the overall winner is
+	 * kept separately. Slots that do not hold an open batch are sentinels
+	 * that lose to every open batch, which is how we handle the incremental
+	 * addition and removal of batches.
+	 *
+	 * Compared to a binary heap, replacing the top tuple after it advances
+	 * costs exactly one comparison per tree level, instead of the two per
+	 * level required by the sift-down, which matters for merges of thousands
+	 * of overlapping batches.
+	 */
+	int tree_capacity; /* Number of leaves, a power of two. */
+	int *tree_losers;
+	int tree_winner; /* Batch index of the current top batch, or INVALID_BATCH_ID. */
+
+	/*
+	 * Specialization for faster comparison of the first sort key, chosen at
+	 * queue creation time.
+	 */
+	int32 (*compare_batches)(const BatchQueueHeap *queue, int batchA, int batchB);
+
 	/*
 	 * We use this to check when we have to ask for the next input batch.
 	 */
 	TupleTableSlot *last_batch_first_tuple_slot;
 	HeapEntryColumn *last_batch_first_tuple_entry;
-} BatchQueueHeap;
+
+	/*
+	 * Deferred opening of the last incoming batch. When the first sort column
+	 * is NOT NULL, the sort key of the first tuple of an incoming batch is
+	 * available in its min/max metadata column, at this position of the
+	 * compressed tuple. In that case we hold the compressed tuple back and
+	 * only decompress it once the merge actually advances to its first key.
+	 * A query with a LIMIT may never get there, saving the decompression of
+	 * the deferred batches entirely. Set to InvalidAttrNumber when the
+	 * optimization does not apply, in which case every incoming batch is
+	 * opened immediately.
+	 */
+	AttrNumber first_key_meta_attno;
+	TupleTableSlot *pending_slot;
+	HeapEntryColumn pending_entry;
+	bool have_pending;
+};
 
 /*
  * Compare heap entries for two batches. This function is used for comparing the
@@ -67,7 +109,6 @@ compare_entries(HeapEntryColumn *entryA, HeapEntryColumn *entryB, const SortSupp
 
 		if (compare != 0)
 		{
-			INVERT_COMPARE_RESULT(compare);
 			return compare;
 		}
 	}
@@ -76,19 +117,15 @@ compare_entries(HeapEntryColumn *entryA, HeapEntryColumn *entryB, const SortSupp
 }
 
 /*
- * Compare top tuples of two given batch array slots. We support specializations
- * for comparison of the first tuple, like tuplesort.
+ * Compare current tuples of two given batch array slots. We support
+ * specializations for comparison of the first tuple, like tuplesort.
  */
 static pg_attribute_always_inline int32
-compare_heap_pos_impl(Datum a, Datum b, void *arg,
-					  int32 (*apply_first_datum_comparator)(Datum, bool, Datum, bool, SortSupport))
+compare_batches_impl(const BatchQueueHeap *queue, int batchA, int batchB,
+					 int32 (*apply_first_datum_comparator)(Datum, bool, Datum, bool, SortSupport))
 {
-	BatchQueueHeap *queue = (BatchQueueHeap *) arg;
-	PG_USED_FOR_ASSERTS_ONLY BatchArray *batch_array = &queue->queue.batch_array;
-	int batchA = DatumGetInt32(a);
+	PG_USED_FOR_ASSERTS_ONLY const BatchArray *batch_array = &queue->queue.batch_array;
 	Assert(batchA <= batch_array->n_batch_states);
-
-	int batchB = DatumGetInt32(b);
 	Assert(batchB <= batch_array->n_batch_states);
 
 	const int nkeys = queue->nkeys;
@@ -104,7 +141,6 @@ compare_heap_pos_impl(Datum a, Datum b, void *arg,
 											   &sortkeys[0]);
 	if (compare != 0)
 	{
-		INVERT_COMPARE_RESULT(compare);
 		return compare;
 	}
 
@@ -118,7 +154,6 @@ compare_heap_pos_impl(Datum a, Datum b, void *arg,
 
 		if (compare != 0)
 		{
-			INVERT_COMPARE_RESULT(compare);
 			return compare;
 		}
 	}
@@ -127,44 +162,91 @@ compare_heap_pos_impl(Datum a, Datum b, void *arg,
 }
 
 static int32
-compare_heap_pos_generic(Datum a, Datum b, void *arg)
+compare_batches_generic(const BatchQueueHeap *queue, int batchA, int batchB)
 {
-	return compare_heap_pos_impl(a, b, arg, ApplySortComparator);
+	return compare_batches_impl(queue, batchA, batchB, ApplySortComparator);
 }
 
 static int32
-compare_heap_pos_int32(Datum a, Datum b, void *arg)
+compare_batches_int32(const BatchQueueHeap *queue, int batchA, int batchB)
 {
-	return compare_heap_pos_impl(a, b, arg, ApplyInt32SortComparator);
+	return compare_batches_impl(queue, batchA, batchB, ApplyInt32SortComparator);
 }
 
 #if SIZEOF_DATUM >= 8
 static int32
-compare_heap_pos_signed(Datum a, Datum b, void *arg)
+compare_batches_signed(const BatchQueueHeap *queue, int batchA, int batchB)
 {
-	return compare_heap_pos_impl(a, b, arg, ApplySignedSortComparator);
+	return compare_batches_impl(queue, batchA, batchB, ApplySignedSortComparator);
 }
 #endif
 
-/* Add a new datum to the heap and perform an automatic resizing if needed. In contrast to
- * the binaryheap_add_unordered() function, the capacity of the heap is automatically
- * increased if needed.
+/*
+ * Replay the matches on the path from the given leaf to the root, after the
+ * value at the leaf has changed. The candidate is the new occupant of the
+ * leaf: either the leaf's own batch index, or INVALID_BATCH_ID when the batch
+ * is exhausted. This is the textbook tournament replacement: at every level,
+ * the current candidate plays against the loser stored at the node, the
+ * winner moves up and the loser stays.
+ *
+ * Replaying is correct when the old value of the leaf was the overall winner,
+ * or a sentinel, which covers all the modifications we perform.
  */
-static pg_nodiscard binaryheap *
-binaryheap_add_unordered_autoresize(binaryheap *heap, Datum d)
+static void
+loser_tree_replay(BatchQueueHeap *queue, int leaf, int candidate)
 {
-	/* Resize heap if needed */
-	if (heap->bh_size >= heap->bh_space)
+	int winner = candidate;
+	for (int node = (queue->tree_capacity + leaf) / 2; node >= 1; node /= 2)
 	{
-		heap->bh_space = heap->bh_space * 2;
-		Size new_size = offsetof(binaryheap, bh_nodes) + (sizeof(Datum) * heap->bh_space);
-		heap = (binaryheap *) repalloc(heap, new_size);
+		const int loser = queue->tree_losers[node];
+		if (loser != INVALID_BATCH_ID &&
+			(winner == INVALID_BATCH_ID || queue->compare_batches(queue, loser, winner) < 0))
+		{
+			queue->tree_losers[node] = winner;
+			winner = loser;
+		}
 	}
+	queue->tree_winner = winner;
+}
+
+/*
+ * Grow the loser tree to the given number of leaves, which must be a power of
+ * two, and rebuild it. The open batches are exactly the old winner and the
+ * losers stored at the old internal nodes, so we replay them into the emptied
+ * bigger tree one by one.
+ */
+static void
+loser_tree_grow(BatchQueueHeap *queue, int new_capacity)
+{
+	const int old_capacity = queue->tree_capacity;
+	int *old_losers = queue->tree_losers;
+	const int old_winner = queue->tree_winner;
 
-	/* Insert new element */
-	binaryheap_add(heap, d);
+	Assert(new_capacity > old_capacity);
 
-	return heap;
+	queue->tree_capacity = new_capacity;
+	queue->tree_losers = palloc(sizeof(int) * new_capacity);
+	for (int node = 0; node < new_capacity; node++)
+	{
+		queue->tree_losers[node] = INVALID_BATCH_ID;
+	}
+	queue->tree_winner = INVALID_BATCH_ID;
+
+	if (old_winner != INVALID_BATCH_ID)
+	{
+		loser_tree_replay(queue, old_winner, old_winner);
+	}
+
+	for (int node = 1; node < old_capacity; node++)
+	{
+		const int batch_index = old_losers[node];
+		if (batch_index != INVALID_BATCH_ID)
+		{
+			loser_tree_replay(queue, batch_index, batch_index);
+		}
+	}
+
+	pfree(old_losers);
 }
 
 static void
@@ -173,13 +255,13 @@ batch_queue_heap_pop(BatchQueue *bq, DecompressContext *dcontext)
 	BatchQueueHeap *queue = (BatchQueueHeap *) bq;
 	BatchArray *batch_array = &bq->batch_array;
 
-	if (binaryheap_empty(queue->merge_heap))
+	const int top_batch_index = queue->tree_winner;
+	if (top_batch_index == INVALID_BATCH_ID)
 	{
-		/* Allow this function to be called on the initial empty heap. */
+		/* Allow this function to be called on the initial empty tree. */
 		return;
 	}
 
-	const int top_batch_index = DatumGetInt32(binaryheap_first(queue->merge_heap));
 	DecompressBatchState *top_batch = batch_array_get_at(batch_array, top_batch_index);
 
 	compressed_batch_advance(dcontext, top_batch);
@@ -187,9 +269,9 @@ batch_queue_heap_pop(BatchQueue *bq, DecompressContext *dcontext)
 	TupleTableSlot *top_tuple = compressed_batch_current_tuple(top_batch);
 	if (TupIsNull(top_tuple))
 	{
-		/* Batch is exhausted, recycle batch_state */
-		(void) binaryheap_remove_first(queue->merge_heap);
+		/* Batch is exhausted, recycle batch_state. */
 		batch_array_clear_at(batch_array, top_batch_index);
+		loser_tree_replay(queue, top_batch_index, INVALID_BATCH_ID);
 	}
 	else
 	{
@@ -211,8 +293,8 @@ batch_queue_heap_pop(BatchQueue *bq, DecompressContext *dcontext)
 				top_tuple->tts_isnull[attr];
 		}
 
-		/* Place this batch on the heap according to its new decompressed tuple. */
-		binaryheap_replace_first(queue->merge_heap, Int32GetDatum(top_batch_index));
+		/* Replay the tree path of this batch according to its new tuple. */
+		loser_tree_replay(queue, top_batch_index, top_batch_index);
 	}
 }
 
@@ -221,14 +303,32 @@ batch_queue_heap_needs_next_batch(BatchQueue *_queue)
 {
 	BatchQueueHeap *queue = (BatchQueueHeap *) _queue;
 
-	if (binaryheap_empty(queue->merge_heap))
+	if (queue->tree_winner == INVALID_BATCH_ID)
 	{
 		return true;
 	}
 
-	const int top_batch_index = DatumGetInt32(binaryheap_first(queue->merge_heap));
+	if (queue->have_pending)
+	{
+		/*
+		 * The deferred batch has not been opened, so we only know the first
+		 * sort key of its first tuple, read from the batch metadata. Compare
+		 * on that key alone: as long as the current top tuple sorts strictly
+		 * before it, the top tuple also sorts before the complete first tuple
+		 * of the deferred batch and of all the batches after it, so we don't
+		 * have to open anything. On a tie we conservatively ask for the next
+		 * batch, which opens the deferred one.
+		 */
+		const HeapEntryColumn *top_entry = &queue->heap_entries[queue->nkeys * queue->tree_winner];
+		return ApplySortComparator(top_entry->value,
+								   top_entry->null,
+								   queue->pending_entry.value,
+								   queue->pending_entry.null,
+								   &queue->sortkeys[0]) >= 0;
+	}
+
 	const int comparison_result =
-		compare_entries(&queue->heap_entries[queue->nkeys * top_batch_index],
+		compare_entries(&queue->heap_entries[queue->nkeys * queue->tree_winner],
 						queue->last_batch_first_tuple_entry,
 						queue->sortkeys,
 						queue->nkeys);
@@ -240,18 +340,21 @@ batch_queue_heap_needs_next_batch(BatchQueue *_queue)
 	 * 2) the input has ended.
 	 * Since the incoming batches arrive in the order of their first tuple,
 	 * if this invariant holds, then the current top tuple is found inside the
-	 * heap.
+	 * tree.
 	 * If it doesn't hold, the top tuple might be in the next incoming batches,
 	 * and we have to continue adding them.
 	 */
-	return comparison_result <= 0;
+	return comparison_result >= 0;
 }
 
+/*
+ * Open the given compressed tuple as a new batch: decompress its first tuple
+ * and enter it into the merge tree.
+ */
 static void
-batch_queue_heap_push_batch(BatchQueue *_queue, DecompressContext *dcontext,
+batch_queue_heap_open_batch(BatchQueueHeap *queue, DecompressContext *dcontext,
 							TupleTableSlot *compressed_slot)
 {
-	BatchQueueHeap *queue = (BatchQueueHeap *) _queue;
 	BatchArray *batch_array = &queue->queue.batch_array;
 
 	Assert(!TupIsNull(compressed_slot));
@@ -263,11 +366,13 @@ batch_queue_heap_push_batch(BatchQueue *_queue, DecompressContext *dcontext,
 		queue->heap_entries =
 			repalloc(queue->heap_entries,
 					 sizeof(HeapEntryColumn) * queue->nkeys * batch_array->n_batch_states);
+		loser_tree_grow(queue, pg_nextpower2_32(batch_array->n_batch_states));
 	}
 	DecompressBatchState *batch_state = batch_array_get_at(batch_array, new_batch_index);
 
 	compressed_batch_set_compressed_tuple(dcontext, batch_state, compressed_slot);
 	compressed_batch_save_first_tuple(dcontext, batch_state, queue->last_batch_first_tuple_slot);
+	compressed_batch_account_memory(dcontext, batch_array);
 
 	/*
 	 * Update the heap entries for the first tuple of the last batch.
@@ -313,9 +418,63 @@ batch_queue_heap_push_batch(BatchQueue *_queue, DecompressContext *dcontext,
 	}
 
 	/*
-	 * Put the batch on the heap.
+	 * Enter the batch into the tree.
 	 */
-	queue->merge_heap = binaryheap_add_unordered_autoresize(queue->merge_heap, new_batch_index);
+	loser_tree_replay(queue, new_batch_index, new_batch_index);
+}
+
+static void
+batch_queue_heap_push_batch(BatchQueue *_queue, DecompressContext *dcontext,
+							TupleTableSlot *compressed_slot)
+{
+	BatchQueueHeap *queue = (BatchQueueHeap *) _queue;
+
+	if (queue->first_key_meta_attno == InvalidAttrNumber)
+	{
+		batch_queue_heap_open_batch(queue, dcontext, compressed_slot);
+		return;
+	}
+
+	/*
+	 * Defer opening the incoming batch. The previously deferred batch has to
+	 * be opened now, because the incoming batch takes over the role of the
+	 * merge boundary: once the top tuple reaches the incoming batch's first
+	 * key, all earlier batches, including the previously deferred one, must
+	 * already be in the tree.
+	 */
+	if (queue->have_pending)
+	{
+		queue->have_pending = false;
+		batch_queue_heap_open_batch(queue, dcontext, queue->pending_slot);
+	}
+
+	if (queue->pending_slot == NULL)
+	{
+		queue->pending_slot = MakeSingleTupleTableSlot(compressed_slot->tts_tupleDescriptor,
+													   &TTSOpsMinimalTuple);
+	}
+	ExecCopySlot(queue->pending_slot, compressed_slot);
+	queue->pending_entry.value =
+		slot_getattr(queue->pending_slot, queue->first_key_meta_attno, &queue->pending_entry.null);
+	/* The first sort column is NOT NULL, so its metadata cannot be null. */
+	Assert(!queue->pending_entry.null);
+	queue->have_pending = true;
+}
+
+/*
+ * The input has no more compressed tuples, so the deferred batch, if any, has
+ * to be opened to participate in draining the remaining tuples.
+ */
+static void
+batch_queue_heap_input_ended(BatchQueue *_queue, DecompressContext *dcontext)
+{
+	BatchQueueHeap *queue = (BatchQueueHeap *) _queue;
+
+	if (queue->have_pending)
+	{
+		queue->have_pending = false;
+		batch_queue_heap_open_batch(queue, dcontext, queue->pending_slot);
+	}
 }
 
 static TupleTableSlot *
@@ -324,13 +483,12 @@ batch_queue_heap_top_tuple(BatchQueue *bq)
 	BatchQueueHeap *bqh = (BatchQueueHeap *) bq;
 	BatchArray *batch_array = &bq->batch_array;
 
-	if (binaryheap_empty(bqh->merge_heap))
+	if (bqh->tree_winner == INVALID_BATCH_ID)
 	{
 		return NULL;
 	}
 
-	const int top_batch_index = DatumGetInt32(binaryheap_first(bqh->merge_heap));
-	DecompressBatchState *top_batch = batch_array_get_at(batch_array, top_batch_index);
+	DecompressBatchState *top_batch = batch_array_get_at(batch_array, bqh->tree_winner);
 	TupleTableSlot *top_tuple = compressed_batch_current_tuple(top_batch);
 	Assert(!TupIsNull(top_tuple));
 	return top_tuple;
@@ -340,11 +498,24 @@ static void
 batch_queue_heap_reset(BatchQueue *bq)
 {
 	BatchQueueHeap *bqh = (BatchQueueHeap *) bq;
-	binaryheap_reset(bqh->merge_heap);
+
+	/*
+	 * Recycle the batch states of the batches that are still open, so that the
+	 * rescan can reuse them.
+	 */
+	batch_array_clear_all(&bq->batch_array);
+
+	for (int node = 0; node < bqh->tree_capacity; node++)
+	{
+		bqh->tree_losers[node] = INVALID_BATCH_ID;
+	}
+	bqh->tree_winner = INVALID_BATCH_ID;
+
+	bqh->have_pending = false;
 }
 
 /*
- * Free the binary heap.
+ * Free the merge tree.
  */
 static void
 batch_queue_heap_free(BatchQueue *_queue)
@@ -352,15 +523,18 @@ batch_queue_heap_free(BatchQueue *_queue)
 	BatchQueueHeap *queue = (BatchQueueHeap *) _queue;
 	BatchArray *batch_array = &queue->queue.batch_array;
 
-	elog(DEBUG3, "heap has capacity of %d", queue->merge_heap->bh_space);
+	elog(DEBUG3, "merge tree has capacity of %d", queue->tree_capacity);
 	elog(DEBUG3, "created batch states %d", batch_array->n_batch_states);
 	batch_array_clear_all(batch_array);
 	pfree(queue->heap_entries);
-	binaryheap_free(queue->merge_heap);
-	queue->merge_heap = NULL;
+	pfree(queue->tree_losers);
 	pfree(queue->sortkeys);
 	ExecDropSingleTupleTableSlot(queue->last_batch_first_tuple_slot);
 	pfree(queue->last_batch_first_tuple_entry);
+	if (queue->pending_slot != NULL)
+	{
+		ExecDropSingleTupleTableSlot(queue->pending_slot);
+	}
 	batch_array_destroy(batch_array);
 	pfree(queue);
 }
@@ -370,6 +544,7 @@ const struct BatchQueueFunctions BatchQueueFunctionsHeap = {
 	.needs_next_batch = batch_queue_heap_needs_next_batch,
 	.pop = batch_queue_heap_pop,
 	.push_batch = batch_queue_heap_push_batch,
+	.input_ended = batch_queue_heap_input_ended,
 	.reset = batch_queue_heap_reset,
 	.top_tuple = batch_queue_heap_top_tuple,
 };
@@ -436,21 +611,38 @@ batch_queue_heap_create(int num_compressed_cols, const List *sortinfo,
 	 * batch sorted merge doesn't use, so we use a generic comparator in this
 	 * case.
 	 */
-	binaryheap_comparator comparator = compare_heap_pos_generic;
+	queue->compare_batches = compare_batches_generic;
 	if (queue->sortkeys[0].comparator == ssup_datum_int32_cmp)
 	{
-		comparator = compare_heap_pos_int32;
+		queue->compare_batches = compare_batches_int32;
 	}
 #if SIZEOF_DATUM >= 8
 	else if (queue->sortkeys[0].comparator == ssup_datum_signed_cmp)
 	{
-		comparator = compare_heap_pos_signed;
+		queue->compare_batches = compare_batches_signed;
 	}
 #endif
 
-	queue->merge_heap = binaryheap_allocate(INITIAL_BATCH_CAPACITY, comparator, queue);
+	queue->tree_capacity = INITIAL_BATCH_CAPACITY;
+	queue->tree_losers = palloc(sizeof(int) * queue->tree_capacity);
+	for (int node = 0; node < queue->tree_capacity; node++)
+	{
+		queue->tree_losers[node] = INVALID_BATCH_ID;
+	}
+	queue->tree_winner = INVALID_BATCH_ID;
+
 	queue->last_batch_first_tuple_slot = MakeSingleTupleTableSlot(result_tupdesc, &TTSOpsVirtual);
 	queue->last_batch_first_tuple_entry = palloc(sizeof(HeapEntryColumn) * queue->nkeys);
+
+	/*
+	 * The position of the first sort key in the compressed tuple metadata, if
+	 * the planner determined that deferred opening of the boundary batch is
+	 * applicable.
+	 */
+	queue->first_key_meta_attno = list_length(sortinfo) > 4 ?
+									  intVal(list_nth(sortinfo, 4)) :
+									  InvalidAttrNumber;
+
 	queue->queue.funcs = funcs;
 
 	return &queue->queue;
@@ -41,6 +41,7 @@
 #include "nodes/columnar_scan/planner.h"
 #include "nodes/columnar_scan/qual_pushdown.h"
 #include "ts_catalog/array_utils.h"
+#include "ts_catalog/compression_chunk_size.h"
 #include "utils.h"
 
 static CustomPathMethods columnar_scan_path_methods = {
@@ -644,11 +645,14 @@ build_compressioninfo(PlannerInfo *root, const Hypertable *ht, const Chunk *chun
 /*
  * Estimate the average count of elements in the compressed batch based on the
  * Postgres statistics for _ts_meta_count column.
- * Returns TARGET_COMPRESSED_BATCH_SIZE when no pg_statistic entry exists.
+ * Returns TARGET_COMPRESSED_BATCH_SIZE and sets *have_stats to false when no
+ * usable pg_statistic entry exists.
  */
-double
-ts_columnar_estimate_compressed_batch_size(const Oid relid)
+static double
+columnar_estimate_compressed_batch_size(const Oid relid, bool *have_stats)
 {
+	*have_stats = false;
+
 	AttrNumber attnum = get_attnum(relid, "_ts_meta_count");
 	if (attnum == InvalidAttrNumber)
 		return TARGET_COMPRESSED_BATCH_SIZE;
@@ -721,9 +725,18 @@ ts_columnar_estimate_compressed_batch_size(const Oid relid)
 		return TARGET_COMPRESSED_BATCH_SIZE;
 	}
 
+	*have_stats = true;
 	return final_result;
 }
 
+double
+ts_columnar_estimate_compressed_batch_size(const Oid relid)
+{
+	bool have_stats;
+
+	return columnar_estimate_compressed_batch_size(relid, &have_stats);
+}
+
 /*
  * calculate cost for ColumnarScanPath
  *
@@ -808,7 +821,7 @@ smoothstep(double x, double start, double end)
  *       For example, the batches are sorted on the min value of the 'order by' metadata
  *       column: [0, 3] [0, 5] [3, 7] [6, 10]
  *
- *   (2) The decompress chunk node initializes a binary heap, opens the first batch and
+ *   (2) The decompress chunk node initializes a merge heap, opens the first batch and
  *       decompresses the first tuple from the batch. The tuple is put on the heap. In addition
  *       the opened batch is marked as the most recent batch (MRB).
  *
@@ -828,7 +841,7 @@ smoothstep(double x, double start, double end)
  *       (3d) The former top tuple of the heap is returned.
  *
  * This function calculate the costs for retrieving the decompressed in-order
- * using a binary heap.
+ * using a merge heap.
  */
 static void
 cost_batch_sorted_merge(PlannerInfo *root, const CompressionInfo *compression_info,
@@ -1144,11 +1157,28 @@ ts_columnar_scan_generate_paths(PlannerInfo *root, RelOptInfo *chunk_rel, const
 	set_compressed_baserel_size_estimates(root, compressed_rel, compression_info);
 
 	/*
-	 * Estimate the size of the compressed batch from Postgres
-	 * statistics.
+	 * Estimate the size of the compressed batch from Postgres statistics.
+	 *
+	 * Freshly compressed chunks have no pg_statistic entry until the next
+	 * analyze, and falling back to the target batch size can be off by
+	 * orders of magnitude for sparse segments. In that case use the row
+	 * counts recorded in the compression_chunk_size catalog at compression
+	 * time, which give the actual average batch fill of this chunk.
 	 */
+	bool have_batch_size_stats;
 	compression_info->compressed_batch_size =
-		ts_columnar_estimate_compressed_batch_size(compression_info->compressed_rte->relid);
+		columnar_estimate_compressed_batch_size(compression_info->compressed_rte->relid,
+												&have_batch_size_stats);
+	if (!have_batch_size_stats)
+	{
+		FormData_compression_chunk_size size_stats;
+
+		if (ts_compression_chunk_size_get_stats(chunk->fd.id, &size_stats) &&
+			size_stats.numrows_post_compression > 0 && size_stats.numrows_pre_compression > 0)
+			compression_info->compressed_batch_size =
+				(double) size_stats.numrows_pre_compression /
+				(double) size_stats.numrows_post_compression;
+	}
 
 	/*
 	 * Estimate the size of decompressed chunk based on the compressed chunk.
@@ -1330,7 +1360,7 @@ build_on_single_compressed_path(PlannerInfo *root, const Chunk *chunk, RelOptInf
 
 	/*
 	 * Create a path for the batch sorted merge optimization. This optimization
-	 * performs a sorted merge of the involved batches by using a binary heap
+	 * performs a sorted merge of the involved batches by using a loser tree
 	 * and preserving the compression order. This optimization is only
 	 * considered if we can't push down the sort to the compressed chunk. If we
 	 * can push down the sort, the batches can be directly consumed in this
@@ -1531,10 +1561,37 @@ build_on_single_compressed_path(PlannerInfo *root, const Chunk *chunk, RelOptInf
 	}
 
 	/*
-	 * Create plain Append, potentially parallel. It only makes sense for the
-	 * unsorted input paths.
+	 * For unordered serial scans, the ColumnarScan node itself can stream the
+	 * uncompressed tail after the compressed batches, which avoids planning
+	 * the chunk as two relations glued by an Append. The internal tail scan
+	 * is not parallel-aware, so parallel plans keep the Append below. The
+	 * aggregated queries keep it as well: VectorAgg reads the compressed
+	 * tuples directly from the child of the ColumnarScan and would never see
+	 * the tail tuples, and pushing the partial aggregates down to both halves
+	 * of the Append vectorizes more of the plan than a merged scan would.
 	 */
+	if (ts_guc_enable_columnarscan_tail_scan && !root->parse->hasAggs &&
+		ts_is_columnar_scan_path(chunk_path_no_sort) &&
+		chunk_path_no_sort->parallel_workers == 0 &&
+		unordered_uncompressed_path->parallel_workers == 0)
+	{
+		ColumnarScanPath *merged =
+			copy_columnar_scan_path((ColumnarScanPath *) chunk_path_no_sort);
+		merged->include_uncompressed_tail = true;
+		merged->custom_path.path.rows += unordered_uncompressed_path->rows;
+		merged->custom_path.path.startup_cost += unordered_uncompressed_path->startup_cost;
+		merged->custom_path.path.total_cost += unordered_uncompressed_path->total_cost;
+		merged->custom_path.path.parallel_safe = chunk_path_no_sort->parallel_safe &&
+												 unordered_uncompressed_path->parallel_safe;
+
+		combined_paths = lappend(combined_paths, (Path *) merged);
+	}
+	else
 	{
+		/*
+		 * Create plain Append, potentially parallel. It only makes sense for
+		 * the unsorted input paths.
+		 */
 		const int workers = Max(chunk_path_no_sort->parallel_workers,
 								unordered_uncompressed_path->parallel_workers);
 
@@ -2388,9 +2445,16 @@ columnar_scan_path_create(PlannerInfo *root, const CompressionInfo *compression_
 	path->custom_path.flags = 0;
 	path->custom_path.methods = &columnar_scan_path_methods;
 	path->batch_sorted_merge = false;
+	path->include_uncompressed_tail = false;
 
 	/*
-	 * ColumnarScan doesn't manage any parallelism itself.
+	 * ColumnarScan doesn't manage any parallelism itself, so it is never
+	 * parallel-aware. Parallel scans over compressed chunks still work: the
+	 * partial paths built on partial compressed paths run one ColumnarScan per
+	 * worker, and the parallel-aware underlying scan deals out the compressed
+	 * tuples through its shared scan descriptor. Since one compressed tuple is
+	 * one batch, this distributes the work to the workers at batch
+	 * granularity, and no shared state is needed at this node's level.
 	 */
 	path->custom_path.path.parallel_aware = false;
 
@@ -2907,10 +2971,26 @@ build_sortinfo(PlannerInfo *root, const Chunk *chunk, RelOptInfo *chunk_rel,
 
 	/*
 	 * Cannot push down sort on non-segmentby columns
-	 * if the chunk has batches overlapping on orderby columns
+	 * if the chunk has batches overlapping on orderby columns.
+	 *
+	 * Batch sorted merge still works in that case: the batch min/max
+	 * metadata orders the batches and the heap merges them at execution
+	 * time, relying only on the batches themselves being sorted, which is
+	 * always the case. We can only build the metadata sort when the
+	 * pathkeys start at the compression orderby, i.e. when no segmentby
+	 * columns appear in the pathkey prefix.
 	 */
 	if (ts_chunk_is_unordered(chunk))
+	{
+		if (i == 0)
+			sort_info.use_batch_sorted_merge =
+				match_pathkeys_to_compression_orderby(pathkeys,
+													  chunk_em_exprs,
+													  /* starting_pathkey_offset = */ 0,
+													  compression_info,
+													  &sort_info.reverse);
 		return sort_info;
+	}
 
 	/*
 	 * Pathkeys includes columns past segmentby columns, so we need sequence_num
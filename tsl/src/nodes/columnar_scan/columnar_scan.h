@@ -60,6 +60,10 @@ typedef struct ColumnarScanPath
 	bool needs_sequence_num;
 	bool reverse;
 	bool batch_sorted_merge;
+	/* Stream the uncompressed part of a partially compressed chunk from this
+	 * node after the compressed batches, instead of combining the two
+	 * sub-scans with an Append. */
+	bool include_uncompressed_tail;
 	int32 chunk_status;
 } ColumnarScanPath;
 
@@ -8,11 +8,14 @@
 
 #include <executor/tuptable.h>
 #include <nodes/bitmapset.h>
+#include <port/pg_bitutils.h>
 #include <utils/builtins.h>
 #include <utils/date.h>
+#include <utils/memutils.h>
 #include <utils/timestamp.h>
 #include <utils/uuid.h>
 
+#include "compression/algorithms/dictionary.h"
 #include "compression/arrow_c_data_interface.h"
 #include "compression/compression.h"
 #include "debug_assert.h"
@@ -21,6 +24,7 @@
 #include "nodes/columnar_scan/vector_dict.h"
 #include "nodes/columnar_scan/vector_predicates.h"
 #include "nodes/columnar_scan/vector_quals.h"
+#include "probes.h"
 
 /*
  * Create a single-value ArrowArray of an arithmetic type. This is a specialized
@@ -214,10 +218,26 @@ decompress_column(DecompressContext *dcontext, DecompressBatchState *batch_state
 		return;
 	}
 
-	/* Detoast the compressed datum. */
-	value = PointerGetDatum(detoaster_detoast_attr_copy((struct varlena *) DatumGetPointer(value),
-														&dcontext->detoaster,
-														batch_state->per_batch_context));
+	/*
+	 * Detoast the compressed datum. If it is stored inline and the compressed
+	 * tuple is a buffer tuple, we can read it in place: the buffer pin held by
+	 * the slot outlives the batch, and the decompression iterators return
+	 * varlena datums pointing directly into the compressed data, so this saves
+	 * a copy of every string column in the batch. The batch sorted merge keeps
+	 * several batches open while the compressed slot moves on, so there we
+	 * always have to copy into the per-batch memory context.
+	 */
+	struct varlena *raw = (struct varlena *) DatumGetPointer(value);
+	if (!VARATT_IS_EXTENDED(raw) && !dcontext->batch_sorted_merge &&
+		TTS_IS_BUFFERTUPLE(compressed_slot))
+	{
+		value = PointerGetDatum(raw);
+	}
+	else
+	{
+		value = PointerGetDatum(
+			detoaster_detoast_attr_copy(raw, &dcontext->detoaster, batch_state->per_batch_context));
+	}
 
 	CompressedDataHeader *header = (CompressedDataHeader *) value;
 
@@ -228,6 +248,11 @@ decompress_column(DecompressContext *dcontext, DecompressBatchState *batch_state
 		return;
 	}
 
+	if (header->compression_algorithm < _END_COMPRESSION_ALGORITHMS)
+	{
+		dcontext->instr.bytes_decompressed[header->compression_algorithm] += VARSIZE_ANY(header);
+	}
+
 	/* Decompress the entire batch if it is supported. */
 	ArrowArray *arrow = NULL;
 	if (dcontext->enable_bulk_decompression && column_description->bulk_decompression_supported)
@@ -246,9 +271,43 @@ decompress_column(DecompressContext *dcontext, DecompressBatchState *batch_state
 		MemoryContext context_before_decompression =
 			MemoryContextSwitchTo(dcontext->bulk_decompression_context);
 
-		arrow = decompress_all(PointerGetDatum(header),
-							   column_description->typid,
-							   batch_state->per_batch_context);
+		if (header->compression_algorithm == COMPRESSION_ALGORITHM_DICTIONARY &&
+			column_description->typid == TEXTOID)
+		{
+			/*
+			 * Text dictionary columns share the materialized dictionary
+			 * across the batches of this scan, so that a chunk with the same
+			 * small dictionary repeated in every batch materializes the
+			 * string pool only once.
+			 */
+			MemoryContext scan_mctx = MemoryContextGetParent(batch_state->per_batch_context);
+			if (dcontext->dictionary_caches == NULL)
+			{
+				dcontext->dictionary_caches =
+					MemoryContextAllocZero(scan_mctx,
+										   sizeof(DictionaryDecompressionCache) *
+											   dcontext->num_columns_with_metadata);
+			}
+
+			DictionaryDecompressionCache *cache = &dcontext->dictionary_caches[i];
+			if (cache->mctx == NULL)
+			{
+				cache->mctx = AllocSetContextCreate(scan_mctx,
+													"dictionary decompression cache",
+													ALLOCSET_DEFAULT_SIZES);
+			}
+
+			arrow = tsl_text_dictionary_decompress_all_cached(PointerGetDatum(header),
+															  column_description->typid,
+															  batch_state->per_batch_context,
+															  cache);
+		}
+		else
+		{
+			arrow = decompress_all(PointerGetDatum(header),
+								   column_description->typid,
+								   batch_state->per_batch_context);
+		}
 
 		MemoryContextSwitchTo(context_before_decompression);
 
@@ -618,11 +677,34 @@ compute_plain_qual(VectorQualState *vqstate, TupleTableSlot *slot, Node *qual,
 		 */
 		if (saop)
 		{
-			vector_array_predicate(vector_const_predicate,
-								   saop->useOr,
-								   vector_nodict,
-								   constnode->constvalue,
-								   predicate_result_nodict);
+			/*
+			 * For large IN-lists over types where the equality is bitwise, we
+			 * can evaluate the predicate with a hash set built once per scan,
+			 * instead of comparing every array element to every row.
+			 */
+			bool evaluated = false;
+			if (saop->useOr && vqstate->array_hash_sets != NULL)
+			{
+				const int width = get_vector_const_bitwise_eq_width(vector_const_opcode);
+				if (width > 0)
+				{
+					evaluated = vector_array_predicate_hashed(vqstate->array_hash_sets,
+															  vqstate->array_hash_mctx,
+															  width,
+															  vector_nodict,
+															  constnode->constvalue,
+															  predicate_result_nodict);
+				}
+			}
+
+			if (!evaluated)
+			{
+				vector_array_predicate(vector_const_predicate,
+									   saop->useOr,
+									   vector_nodict,
+									   constnode->constvalue,
+									   predicate_result_nodict);
+			}
 		}
 		else
 		{
@@ -782,6 +864,22 @@ compute_one_qual(VectorQualState *vqstate, TupleTableSlot *compressed_slot, Node
 	compute_qual_disjunction(vqstate, compressed_slot, boolexpr->args, result);
 }
 
+/*
+ * The fraction of evaluations in which the given qual filtered out the entire
+ * batch. Quals that were never evaluated, because the quals before them always
+ * killed the batch, get a zero rate and stay at the end of the order.
+ */
+static inline double
+vector_qual_kill_rate(const VectorQualStats *stats, int qual_index)
+{
+	if (stats->evaluated[qual_index] == 0)
+	{
+		return 0;
+	}
+
+	return (double) stats->killed[qual_index] / (double) stats->evaluated[qual_index];
+}
+
 /*
  * Compute the vectorized filters. Returns true if we have any passing rows. If not,
  * it means the entire batch is filtered out, and we use this for further
@@ -813,10 +911,65 @@ vector_qual_compute(VectorQualState *vqstate)
 	/*
 	 * Compute the quals.
 	 */
-	compute_qual_conjunction(vqstate,
-							 vqstate->slot,
-							 vqstate->vectorized_quals_constified,
-							 vqstate->vector_qual_result);
+	VectorQualStats *stats = vqstate->stats;
+	if (stats == NULL)
+	{
+		compute_qual_conjunction(vqstate,
+								 vqstate->slot,
+								 vqstate->vectorized_quals_constified,
+								 vqstate->vector_qual_result);
+
+		return get_vector_qual_summary(vqstate->vector_qual_result, n_rows);
+	}
+
+	/*
+	 * We have the statistics about the previous batches, so evaluate the
+	 * top-level conjunction adaptively in the order of the observed batch kill
+	 * rates, with the usual early exit when no rows pass. The sparse index
+	 * checks have already been applied as quals of the underlying compressed
+	 * scan by that point, and the columns referenced by the vectorized quals
+	 * are decompressed on first use, so the columns of the later quals are not
+	 * even decompressed when an earlier qual kills the batch.
+	 */
+	Assert(stats->num_quals == list_length(vqstate->vectorized_quals_constified));
+	Assert(stats->num_quals > 1);
+
+	if (stats->batches++ % 64 == 0)
+	{
+		/*
+		 * Periodically reorder the quals by the kill rate, descending. The
+		 * insertion sort is stable, so the quals with equal rates stay in
+		 * their current order.
+		 */
+		for (int i = 1; i < stats->num_quals; i++)
+		{
+			const int qual_index = stats->order[i];
+			const double rate = vector_qual_kill_rate(stats, qual_index);
+			int j = i - 1;
+			while (j >= 0 && vector_qual_kill_rate(stats, stats->order[j]) < rate)
+			{
+				stats->order[j + 1] = stats->order[j];
+				j--;
+			}
+			stats->order[j + 1] = qual_index;
+		}
+	}
+
+	for (int i = 0; i < stats->num_quals; i++)
+	{
+		const int qual_index = stats->order[i];
+		stats->evaluated[qual_index]++;
+		compute_one_qual(vqstate,
+						 vqstate->slot,
+						 list_nth(vqstate->vectorized_quals_constified, qual_index),
+						 vqstate->vector_qual_result);
+
+		if (get_vector_qual_summary(vqstate->vector_qual_result, n_rows) == NoRowsPass)
+		{
+			stats->killed[qual_index]++;
+			return NoRowsPass;
+		}
+	}
 
 	return get_vector_qual_summary(vqstate->vector_qual_result, n_rows);
 }
@@ -849,6 +1002,55 @@ compressed_batch_discard_tuples(DecompressBatchState *batch_state)
 	}
 }
 
+/*
+ * Account for the memory currently held by the batches of the scan. Called by
+ * the batch queue after each batch is decompressed. This updates the
+ * high-water mark reported by EXPLAIN ANALYZE, and when the budget set by
+ * timescaledb.decompression_memory_limit is exceeded, switches the scan to
+ * row-by-row decompression. That mode decompresses through small per-row
+ * iterators instead of materializing entire batches as arrow arrays, so it is
+ * slower but holds far less transient memory. Note that we cannot instead
+ * reduce the number of concurrently open batches: the batch sorted merge has
+ * to keep a batch open for as long as its key range overlaps the merge
+ * frontier, which is dictated by the data.
+ */
+void
+compressed_batch_account_memory(DecompressContext *dcontext, const BatchArray *batch_array)
+{
+	int64 total_bytes = 0;
+
+	for (int i = 0; i < batch_array->n_batch_states; i++)
+	{
+		DecompressBatchState *batch_state = batch_array_get_at(batch_array, i);
+		if (batch_state->per_batch_context != NULL)
+		{
+			total_bytes +=
+				MemoryContextMemAllocated(batch_state->per_batch_context, /* recurse = */ true);
+		}
+	}
+
+	if (dcontext->bulk_decompression_context != NULL)
+	{
+		total_bytes +=
+			MemoryContextMemAllocated(dcontext->bulk_decompression_context, /* recurse = */ true);
+	}
+
+	if (total_bytes > dcontext->instr.decompression_mem_peak)
+	{
+		dcontext->instr.decompression_mem_peak = total_bytes;
+	}
+
+	if (ts_guc_decompression_memory_limit > 0 && dcontext->enable_bulk_decompression &&
+		total_bytes > (int64) ts_guc_decompression_memory_limit * 1024)
+	{
+		dcontext->enable_bulk_decompression = false;
+		elog(DEBUG2,
+			 "columnar scan batches hold " INT64_FORMAT " bytes which exceeds "
+			 "timescaledb.decompression_memory_limit, falling back to row-by-row decompression",
+			 total_bytes);
+	}
+}
+
 /*
  * Initializes the zero-initialized batch state. We do this on demand, because
  * it involves the creation of memory context and tuple slots, which are
@@ -914,6 +1116,8 @@ compressed_batch_set_compressed_tuple(DecompressContext *dcontext,
 {
 	Assert(TupIsNull(compressed_batch_current_tuple(batch_state)));
 
+	TS_PROBE1(batch_decompress_start, dcontext->num_data_columns);
+
 	/*
 	 * The batch states are initialized on demand, because creating the memory
 	 * context and the tuple table slots is expensive.
@@ -1036,6 +1240,10 @@ compressed_batch_set_compressed_tuple(DecompressContext *dcontext,
 			.per_vector_mcxt = batch_state->per_batch_context,
 			.slot = compressed_slot,
 			.get_arrow_array = compressed_batch_get_arrow_array,
+			.stats = dcontext->vector_qual_stats.num_quals > 1 ? &dcontext->vector_qual_stats :
+																 NULL,
+			.array_hash_sets = &dcontext->array_hash_sets,
+			.array_hash_mctx = MemoryContextGetParent(batch_state->per_batch_context),
 		},
 		.batch_state = batch_state,
 		.dcontext = dcontext,
@@ -1063,6 +1271,7 @@ compressed_batch_set_compressed_tuple(DecompressContext *dcontext,
 
 		InstrCountTuples2(dcontext->ps, 1);
 		InstrCountFiltered1(dcontext->ps, batch_state->total_batch_rows);
+		dcontext->instr.rows_removed_vectorized += batch_state->total_batch_rows;
 	}
 	else
 	{
@@ -1071,6 +1280,46 @@ compressed_batch_set_compressed_tuple(DecompressContext *dcontext,
 		 * we have to decompress the rest of the compressed columns.
 		 */
 		const int num_data_columns = dcontext->num_data_columns;
+
+		dcontext->instr.batches_decompressed++;
+
+		/*
+		 * First, issue prefetch requests for the out-of-line toast data of all
+		 * these columns, so that on a cold cache the heap reads for the later
+		 * columns proceed in the background while the earlier ones are being
+		 * detoasted and decompressed. The blocks of all columns are collected
+		 * first and the requests are issued in block order, so that the kernel
+		 * sees a mostly sequential access pattern.
+		 */
+		if (ts_guc_enable_toast_prefetch)
+		{
+			for (int i = 0; i < num_data_columns; i++)
+			{
+				CompressedColumnValues *column_values = &batch_state->compressed_columns[i];
+				if (column_values->decompression_type != DT_Invalid)
+				{
+					continue;
+				}
+
+				CompressionColumnDescription *column_description =
+					&dcontext->compressed_chunk_columns[i];
+				Assert(column_description->type == COMPRESSED_COLUMN);
+
+				bool isnull;
+				Datum value = slot_getattr(compressed_slot,
+										   column_description->compressed_scan_attno,
+										   &isnull);
+				if (!isnull)
+				{
+					detoaster_collect_toast_blocks((struct varlena *) DatumGetPointer(value),
+												   &dcontext->detoaster,
+												   &dcontext->toast_blocks);
+				}
+			}
+
+			detoaster_prefetch_collected_blocks(&dcontext->detoaster, &dcontext->toast_blocks);
+		}
+
 		for (int i = 0; i < num_data_columns; i++)
 		{
 			CompressedColumnValues *column_values = &batch_state->compressed_columns[i];
@@ -1091,6 +1340,8 @@ compressed_batch_set_compressed_tuple(DecompressContext *dcontext,
 			vqstate->vector_qual_result = NULL;
 		}
 	}
+
+	TS_PROBE1(batch_decompress_end, batch_state->total_batch_rows);
 }
 
 /*
@@ -1173,6 +1424,26 @@ compressed_batch_advance(DecompressContext *dcontext, DecompressBatchState *batc
 	const bool reverse = dcontext->reverse;
 	const int num_data_columns = dcontext->num_data_columns;
 
+	/*
+	 * When no columns are decompressed row-by-row, the rows that don't pass
+	 * the vectorized quals can be skipped in bulk by scanning the qual result
+	 * bitmap for the next set bit, instead of re-testing it row by row. With
+	 * row-by-row columns we still have to advance their iterators for every
+	 * skipped row, and for reverse scans the bitmap would have to be scanned
+	 * backwards, so those keep the per-row path.
+	 */
+	bool have_iterator_columns = false;
+	for (int i = 0; i < num_data_columns; i++)
+	{
+		if (batch_state->compressed_columns[i].decompression_type == DT_Iterator)
+		{
+			have_iterator_columns = true;
+			break;
+		}
+	}
+	const bool bulk_skip_filtered =
+		!reverse && !have_iterator_columns && batch_state->vector_qual_result != NULL;
+
 	for (; batch_state->next_batch_row < batch_state->total_batch_rows;
 		 batch_state->next_batch_row++)
 	{
@@ -1182,6 +1453,19 @@ compressed_batch_advance(DecompressContext *dcontext, DecompressBatchState *batc
 
 		if (!vector_qual(batch_state, arrow_row))
 		{
+			if (bulk_skip_filtered)
+			{
+				const size_t next_valid_row =
+					arrow_next_valid_row(batch_state->vector_qual_result,
+										 output_row,
+										 batch_state->total_batch_rows);
+				InstrCountFiltered1(dcontext->ps, next_valid_row - output_row);
+				dcontext->instr.rows_removed_vectorized += next_valid_row - output_row;
+				/* Account for the loop increment. */
+				batch_state->next_batch_row = next_valid_row - 1;
+				continue;
+			}
+
 			/*
 			 * This row doesn't pass the vectorized quals. Advance the iterated
 			 * compressed columns if we have any.
@@ -1198,6 +1482,7 @@ compressed_batch_advance(DecompressContext *dcontext, DecompressBatchState *batc
 			}
 
 			InstrCountFiltered1(dcontext->ps, 1);
+			dcontext->instr.rows_removed_vectorized++;
 			continue;
 		}
 
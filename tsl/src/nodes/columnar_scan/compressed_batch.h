@@ -134,34 +134,54 @@ extern void compressed_batch_save_first_tuple(DecompressContext *dcontext,
 /*
  * Initialize the batch memory context and bulk decompression context.
  *
- * We use Generation context here because the AllocSet has a hardcoded threshold
- * of 8kB per allocation, after which it allocates directly through malloc. We
- * want to make the blocks as big as possible, but below the malloc's mmap
+ * These contexts are pure arenas: decompression only allocates into them and
+ * the memory is reclaimed wholesale by a context reset, nothing is ever
+ * pfree'd or repalloc'd chunk by chunk. On PG17+ we can therefore use the
+ * Bump allocator, which has no per-chunk headers and the cheapest possible
+ * allocation path, and this shows up on profiles of scans over wide rows.
+ * On older versions we use the Generation context which is the closest thing.
+ * Notably, the AllocSet doesn't fit because it has a hardcoded threshold
+ * of 8kB per allocation, after which it allocates directly through malloc.
+ *
+ * We want to make the blocks as big as possible, but below the malloc's mmap
  * threshold. For small queries, these contexts are basically single-shot and
  * the page faults after an mmap slow them down significantly. The threshold
  * should be 128 kiB according to the docs, but I'm seeing 64 kiB in testing.
+ * The freed blocks below this threshold are cached by malloc, so the
+ * high-water allocation is effectively reused across the batches of the scan.
  *
  * If bulk decompression is not used, use the default size for batch context.
  * This reduces memory usage and improves performance with batch sorted merge.
  */
+#if PG17_GE
+#define create_arena_mctx(parent_mctx, name, min_size, init_size, max_size)                        \
+	BumpContextCreate(parent_mctx, name, min_size, init_size, max_size)
+#else
+#define create_arena_mctx(parent_mctx, name, min_size, init_size, max_size)                        \
+	GenerationContextCreate(parent_mctx, name, min_size, init_size, max_size)
+#endif
+
 #define create_bulk_decompression_mctx(parent_mctx)                                                \
-	GenerationContextCreate(parent_mctx,                                                           \
-							"DecompressBatchState bulk decompression",                             \
-							0,                                                                     \
-							64 * 1024,                                                             \
-							64 * 1024);
+	create_arena_mctx(parent_mctx,                                                                 \
+					  "DecompressBatchState bulk decompression",                                   \
+					  0,                                                                           \
+					  64 * 1024,                                                                   \
+					  64 * 1024);
 
 #define create_per_batch_mctx(dcontext)                                                            \
-	GenerationContextCreate(CurrentMemoryContext,                                                  \
-							"DecompressBatchState per-batch",                                      \
-							0,                                                                     \
-							dcontext->enable_bulk_decompression ? 64 * 1024 : 8 * 1024,            \
-							dcontext->enable_bulk_decompression ? 64 * 1024 : 8 * 1024);
+	create_arena_mctx(CurrentMemoryContext,                                                        \
+					  "DecompressBatchState per-batch",                                            \
+					  0,                                                                           \
+					  dcontext->enable_bulk_decompression ? 64 * 1024 : 8 * 1024,                  \
+					  dcontext->enable_bulk_decompression ? 64 * 1024 : 8 * 1024);
 
 extern void compressed_batch_destroy(DecompressBatchState *batch_state);
 
 extern void compressed_batch_discard_tuples(DecompressBatchState *batch_state);
 
+extern void compressed_batch_account_memory(DecompressContext *dcontext,
+											const BatchArray *batch_array);
+
 /*
  * Returns the current decompressed tuple in the compressed batch.
  */
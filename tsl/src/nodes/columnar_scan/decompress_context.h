@@ -13,7 +13,9 @@
 #include <nodes/pg_list.h>
 
 #include "batch_array.h"
+#include "compression/compression.h"
 #include "detoaster.h"
+#include "vector_quals.h"
 
 typedef enum CompressionColumnType
 {
@@ -52,6 +54,26 @@ typedef struct CompressionColumnDescription
 	bool bulk_decompression_supported;
 } CompressionColumnDescription;
 
+/*
+ * Per-scan counters surfaced through EXPLAIN (ANALYZE, VERBOSE), so that plan
+ * regressions can be diagnosed without guesswork. The bytes are the size of
+ * the compressed on-disk representation that was decompressed, attributed to
+ * the compression algorithm of the column.
+ */
+typedef struct ColumnarScanInstrumentation
+{
+	int64 batches_decompressed;
+	int64 rows_removed_vectorized;
+	int64 bytes_decompressed[_END_COMPRESSION_ALGORITHMS];
+
+	/*
+	 * High-water mark of the memory held by the open batches of this scan, in
+	 * bytes. Sampled after each batch is decompressed, see
+	 * compressed_batch_account_memory().
+	 */
+	int64 decompression_mem_peak;
+} ColumnarScanInstrumentation;
+
 typedef struct DecompressContext
 {
 	/*
@@ -72,6 +94,14 @@ typedef struct DecompressContext
 	int num_data_columns;
 
 	List *vectorized_quals_constified;
+
+	/*
+	 * Statistics for adaptive ordering of the vectorized quals by their
+	 * observed batch kill rates. Only initialized when there is more than one
+	 * vectorized qual.
+	 */
+	VectorQualStats vector_qual_stats;
+
 	bool reverse;
 	bool batch_sorted_merge; /* Batch sorted merge optimization enabled. */
 	bool enable_bulk_decompression;
@@ -82,6 +112,21 @@ typedef struct DecompressContext
 	 */
 	MemoryContext bulk_decompression_context;
 
+	/*
+	 * Per-column caches of materialized dictionaries, shared across the
+	 * batches of this scan. Lazily allocated when the first text dictionary
+	 * column is bulk decompressed.
+	 */
+	struct DictionaryDecompressionCache *dictionary_caches;
+
+	/*
+	 * Cache of the hash sets built for large vectorized IN-lists, shared
+	 * across the batches of this scan. Lazily allocated when the first
+	 * suitable array predicate is evaluated, see
+	 * vector_array_predicate_hashed().
+	 */
+	struct VectorArrayHashSet *array_hash_sets;
+
 	TupleTableSlot *custom_scan_slot;
 
 	/*
@@ -96,8 +141,16 @@ typedef struct DecompressContext
 
 	Detoaster detoaster;
 
+	/*
+	 * Scratch space for batching the toast prefetch requests of one
+	 * compressed tuple, see enable_toast_prefetch.
+	 */
+	ToastBlockCollector toast_blocks;
+
 	int32 chunk_status;
 
+	ColumnarScanInstrumentation instr;
+
 } DecompressContext;
 
 #endif /* TIMESCALEDB_DECOMPRESS_CONTEXT_H */
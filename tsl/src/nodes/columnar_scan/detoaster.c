@@ -15,6 +15,7 @@
 #include <access/table.h>
 #include <access/tableam.h>
 #include <access/toast_internals.h>
+#include <storage/bufmgr.h>
 #include <utils/expandeddatum.h>
 #include <utils/fmgroids.h>
 #include <utils/rel.h>
@@ -36,8 +37,12 @@
  * for detoasting in the Detoaster struct, to allow them to be reused over many
  * input tuples.
  */
+/*
+ * Position the shared toast index scan at the first chunk of the given toast
+ * value, opening the toast relation and its index on the first call.
+ */
 static void
-ts_fetch_toast(Detoaster *detoaster, struct varatt_external *toast_pointer, struct varlena *result)
+detoaster_begin_or_rescan(Detoaster *detoaster, struct varatt_external *toast_pointer)
 {
 	const Oid valueid = toast_pointer->va_valueid;
 
@@ -92,6 +97,14 @@ ts_fetch_toast(Detoaster *detoaster, struct varatt_external *toast_pointer, stru
 		detoaster->toastkey.sk_argument = ObjectIdGetDatum(valueid);
 		index_rescan(detoaster->toastscan->iscan, &detoaster->toastkey, 1, NULL, 0);
 	}
+}
+
+static void
+ts_fetch_toast(Detoaster *detoaster, struct varatt_external *toast_pointer, struct varlena *result)
+{
+	const Oid valueid = toast_pointer->va_valueid;
+
+	detoaster_begin_or_rescan(detoaster, toast_pointer);
 
 	TupleDesc toasttupDesc = detoaster->toastrel->rd_att;
 
@@ -401,3 +414,115 @@ detoaster_detoast_attr_copy(struct varlena *attr, Detoaster *detoaster, MemoryCo
 
 	return attr;
 }
+
+/*
+ * Collect the toast heap blocks of the given datum, if it is stored out of
+ * line, into the block collector. Only the toast index is read here. This is
+ * used together with detoaster_prefetch_collected_blocks() to batch the
+ * prefetch requests for all columns of a compressed tuple. The subsequent
+ * detoasting of the same value rescans the index, which is cheap because its
+ * blocks are hot after this pass.
+ */
+void
+detoaster_collect_toast_blocks(struct varlena *attr, Detoaster *detoaster,
+							   ToastBlockCollector *collector)
+{
+#ifdef USE_PREFETCH
+	if (!VARATT_IS_EXTERNAL_ONDISK(attr))
+	{
+		return;
+	}
+
+	/* Must copy to access aligned fields */
+	struct varatt_external toast_pointer;
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+
+	detoaster_begin_or_rescan(detoaster, &toast_pointer);
+
+	/*
+	 * Walk the index entries without fetching the heap tuples. The chunks of
+	 * one value are laid out sequentially in the vast majority of cases, so
+	 * deduplicating against the previous block is enough here, the rest is
+	 * handled after sorting the collected blocks.
+	 */
+	BlockNumber prev_block = InvalidBlockNumber;
+	ItemPointer tid;
+	while ((tid = index_getnext_tid(detoaster->toastscan->iscan, ForwardScanDirection)) != NULL)
+	{
+		const BlockNumber block = ItemPointerGetBlockNumber(tid);
+		if (block == prev_block)
+		{
+			continue;
+		}
+		prev_block = block;
+
+		if (collector->num_blocks >= collector->capacity)
+		{
+			if (collector->blocks == NULL)
+			{
+				collector->capacity = 64;
+				collector->blocks = MemoryContextAlloc(detoaster->mctx,
+													   sizeof(BlockNumber) * collector->capacity);
+			}
+			else
+			{
+				collector->capacity *= 2;
+				collector->blocks =
+					repalloc(collector->blocks, sizeof(BlockNumber) * collector->capacity);
+			}
+		}
+		collector->blocks[collector->num_blocks++] = block;
+	}
+#endif
+}
+
+#ifdef USE_PREFETCH
+static int
+toast_block_compare(const void *a, const void *b)
+{
+	const BlockNumber lhs = *(const BlockNumber *) a;
+	const BlockNumber rhs = *(const BlockNumber *) b;
+	if (lhs < rhs)
+	{
+		return -1;
+	}
+	if (lhs > rhs)
+	{
+		return 1;
+	}
+	return 0;
+}
+#endif
+
+/*
+ * Issue prefetch requests for the collected toast heap blocks in ascending
+ * block order, so that the kernel sees a mostly sequential access pattern and
+ * can merge the reads. The reads then proceed in the background while the
+ * caller detoasts and decompresses the earlier columns. The collector is
+ * reset for the next batch.
+ */
+void
+detoaster_prefetch_collected_blocks(Detoaster *detoaster, ToastBlockCollector *collector)
+{
+#ifdef USE_PREFETCH
+	if (collector->num_blocks == 0)
+	{
+		return;
+	}
+
+	qsort(collector->blocks, collector->num_blocks, sizeof(BlockNumber), toast_block_compare);
+
+	BlockNumber prev_block = InvalidBlockNumber;
+	for (int i = 0; i < collector->num_blocks; i++)
+	{
+		const BlockNumber block = collector->blocks[i];
+		if (block != prev_block)
+		{
+			PrefetchBuffer(detoaster->toastrel, MAIN_FORKNUM, block);
+			prev_block = block;
+		}
+	}
+
+	collector->num_blocks = 0;
+#endif
+}
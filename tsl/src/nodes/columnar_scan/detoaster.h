@@ -11,6 +11,7 @@
 #include <access/genam.h>
 #include <access/relscan.h>
 #include <access/skey.h>
+#include <storage/block.h>
 #include <utils/snapshot.h>
 
 typedef struct RelationData *Relation;
@@ -27,5 +28,20 @@ typedef struct Detoaster
 
 void detoaster_init(Detoaster *detoaster, MemoryContext mctx);
 void detoaster_close(Detoaster *detoaster);
+/*
+ * Accumulates the toast heap blocks of the column values of one compressed
+ * tuple, so that the prefetch requests for all columns can be issued together
+ * in block order. The array grows on demand and is reused across the batches.
+ */
+typedef struct ToastBlockCollector
+{
+	BlockNumber *blocks;
+	int num_blocks;
+	int capacity;
+} ToastBlockCollector;
+
 struct varlena *detoaster_detoast_attr_copy(struct varlena *attr, Detoaster *detoaster,
 											MemoryContext dest_mctx);
+void detoaster_collect_toast_blocks(struct varlena *attr, Detoaster *detoaster,
+									ToastBlockCollector *collector);
+void detoaster_prefetch_collected_blocks(Detoaster *detoaster, ToastBlockCollector *collector);
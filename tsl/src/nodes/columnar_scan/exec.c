@@ -6,6 +6,7 @@
 
 #include <postgres.h>
 #include <access/sysattr.h>
+#include <access/tableam.h>
 #include <executor/executor.h>
 #include <miscadmin.h>
 #include <nodes/bitmapset.h>
@@ -88,6 +89,7 @@ columnar_scan_state_create(CustomScan *cscan)
 	chunk_state->decompress_context.enable_bulk_decompression =
 		list_nth_int(settings, DCS_EnableBulkDecompression);
 	chunk_state->has_row_marks = list_nth_int(settings, DCS_HasRowMarks);
+	chunk_state->scan_uncompressed_tail = list_nth_int(settings, DCS_ScanUncompressedTail);
 
 	Assert(IsA(cscan->custom_exprs, List));
 	Assert(list_length(cscan->custom_exprs) == 1);
@@ -417,7 +419,106 @@ columnar_scan_begin(CustomScanState *node, EState *estate, int eflags)
 			lappend(dcontext->vectorized_quals_constified, constified);
 	}
 
+	/*
+	 * When we have more than one vectorized qual, their evaluation order is
+	 * chosen adaptively based on the observed batch kill rates, so that the
+	 * most selective quals are evaluated first.
+	 */
+	const int num_quals = list_length(dcontext->vectorized_quals_constified);
+	if (num_quals > 1)
+	{
+		VectorQualStats *stats = &dcontext->vector_qual_stats;
+		stats->num_quals = num_quals;
+		stats->order = palloc(sizeof(int) * num_quals);
+		stats->evaluated = palloc0(sizeof(uint64) * num_quals);
+		stats->killed = palloc0(sizeof(uint64) * num_quals);
+		for (int i = 0; i < num_quals; i++)
+		{
+			stats->order[i] = i;
+		}
+	}
+
 	detoaster_init(&dcontext->detoaster, CurrentMemoryContext);
+
+	if (chunk_state->scan_uncompressed_tail)
+	{
+		/*
+		 * Prepare for streaming the uncompressed part of the chunk after the
+		 * compressed batches. The chunk tuples have to be mapped into the
+		 * scan tuple layout, which can be a reordered subset of the chunk
+		 * columns, and the vectorized quals have to be rechecked row by row
+		 * because the tail tuples don't pass through the batch machinery.
+		 */
+		TupleDesc scan_desc = node->ss.ss_ScanTupleSlot->tts_tupleDescriptor;
+		chunk_state->tail_attno_map = palloc(sizeof(AttrNumber) * scan_desc->natts);
+		for (int i = 0; i < scan_desc->natts; i++)
+		{
+			if (chunk_state->custom_scan_tlist == NIL)
+			{
+				chunk_state->tail_attno_map[i] = AttrOffsetGetAttrNumber(i);
+			}
+			else
+			{
+				TargetEntry *tle = castNode(TargetEntry, list_nth(chunk_state->custom_scan_tlist, i));
+				chunk_state->tail_attno_map[i] = castNode(Var, tle->expr)->varattno;
+			}
+		}
+
+		chunk_state->tail_vectorized_quals =
+			ExecInitQual(chunk_state->vectorized_quals_original, &node->ss.ps);
+	}
+}
+
+/*
+ * Stream the next qualifying tuple from the uncompressed part of a partially
+ * compressed chunk. Called after the compressed batches are exhausted.
+ */
+static TupleTableSlot *
+columnar_scan_next_tail_tuple(ColumnarScanState *chunk_state)
+{
+	ScanState *ss = &chunk_state->csstate.ss;
+	TupleTableSlot *scan_slot = ss->ss_ScanTupleSlot;
+	const TupleDesc scan_desc = scan_slot->tts_tupleDescriptor;
+
+	if (chunk_state->tail_scan_desc == NULL)
+	{
+		chunk_state->tail_scan_desc =
+			table_beginscan(ss->ss_currentRelation, ss->ps.state->es_snapshot, 0, NULL);
+		chunk_state->tail_chunk_slot = table_slot_create(ss->ss_currentRelation, NULL);
+	}
+
+	ExprContext *econtext = ss->ps.ps_ExprContext;
+	while (table_scan_getnextslot(chunk_state->tail_scan_desc,
+								  ForwardScanDirection,
+								  chunk_state->tail_chunk_slot))
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		TupleTableSlot *chunk_slot = chunk_state->tail_chunk_slot;
+		slot_getallattrs(chunk_slot);
+		ExecClearTuple(scan_slot);
+		for (int i = 0; i < scan_desc->natts; i++)
+		{
+			const int chunk_offset =
+				AttrNumberGetAttrOffset(chunk_state->tail_attno_map[i]);
+			scan_slot->tts_values[i] = chunk_slot->tts_values[chunk_offset];
+			scan_slot->tts_isnull[i] = chunk_slot->tts_isnull[chunk_offset];
+		}
+		ExecStoreVirtualTuple(scan_slot);
+
+		econtext->ecxt_scantuple = scan_slot;
+		ResetExprContext(econtext);
+		if (!ExecQual(ss->ps.qual, econtext) ||
+			!ExecQual(chunk_state->tail_vectorized_quals, econtext))
+		{
+			InstrCountFiltered1(&ss->ps, 1);
+			continue;
+		}
+
+		return scan_slot;
+	}
+
+	return NULL;
 }
 
 /*
@@ -442,6 +543,7 @@ columnar_scan_exec_impl(ColumnarScanState *chunk_state, const BatchQueueFunction
 		if (TupIsNull(subslot))
 		{
 			/* Won't have more compressed tuples. */
+			bqfuncs->input_ended(bq, dcontext);
 			break;
 		}
 
@@ -451,7 +553,18 @@ columnar_scan_exec_impl(ColumnarScanState *chunk_state, const BatchQueueFunction
 
 	if (TupIsNull(result_slot))
 	{
-		return NULL;
+		if (!chunk_state->scan_uncompressed_tail)
+		{
+			return NULL;
+		}
+
+		/* Compressed batches are exhausted, continue with the uncompressed
+		 * part of the chunk. */
+		result_slot = columnar_scan_next_tail_tuple(chunk_state);
+		if (TupIsNull(result_slot))
+		{
+			return NULL;
+		}
 	}
 
 	if (chunk_state->has_row_marks)
@@ -479,6 +592,11 @@ columnar_scan_rescan(CustomScanState *node)
 
 	bq->funcs->reset(bq);
 
+	if (chunk_state->tail_scan_desc != NULL)
+	{
+		table_rescan(chunk_state->tail_scan_desc, NULL);
+	}
+
 	if (node->ss.ps.chgParam != NULL)
 		UpdateChangedParamSet(linitial(node->custom_ps), node->ss.ps.chgParam);
 
@@ -495,6 +613,14 @@ columnar_scan_end(CustomScanState *node)
 	bq->funcs->free(bq);
 	ExecEndNode(linitial(node->custom_ps));
 
+	if (chunk_state->tail_scan_desc != NULL)
+	{
+		table_endscan(chunk_state->tail_scan_desc);
+		ExecDropSingleTupleTableSlot(chunk_state->tail_chunk_slot);
+		chunk_state->tail_scan_desc = NULL;
+		chunk_state->tail_chunk_slot = NULL;
+	}
+
 	detoaster_close(&chunk_state->decompress_context.detoaster);
 }
 
@@ -553,6 +679,13 @@ columnar_scan_explain(CustomScanState *node, List *ancestors, ExplainState *es)
 			ExplainPropertyBool("Batch Sorted Merge", dcontext->batch_sorted_merge, es);
 		}
 
+		if (chunk_state->scan_uncompressed_tail)
+		{
+			ExplainPropertyBool("Uncompressed Tail Scan",
+								chunk_state->scan_uncompressed_tail,
+								es);
+		}
+
 		if (dcontext->reverse)
 		{
 			ExplainPropertyBool("Reverse", dcontext->reverse, es);
@@ -563,6 +696,48 @@ columnar_scan_explain(CustomScanState *node, List *ancestors, ExplainState *es)
 			ExplainPropertyBool("Bulk Decompression",
 								chunk_state->decompress_context.enable_bulk_decompression,
 								es);
+
+			const ColumnarScanInstrumentation *instr = &dcontext->instr;
+
+			if (instr->batches_decompressed > 0 || es->format != EXPLAIN_FORMAT_TEXT)
+			{
+				ExplainPropertyInteger("Batches Decompressed",
+									   NULL,
+									   instr->batches_decompressed,
+									   es);
+			}
+
+			if (instr->rows_removed_vectorized > 0 || es->format != EXPLAIN_FORMAT_TEXT)
+			{
+				ExplainPropertyInteger("Rows Removed by Vectorized Filter",
+									   NULL,
+									   instr->rows_removed_vectorized,
+									   es);
+			}
+
+			if (instr->decompression_mem_peak > 0 || es->format != EXPLAIN_FORMAT_TEXT)
+			{
+				ExplainPropertyInteger("Peak Decompression Memory",
+									   "kB",
+									   (instr->decompression_mem_peak + 1023) / 1024,
+									   es);
+			}
+
+			/*
+			 * Report the compressed bytes that were decompressed, per
+			 * compression algorithm, so that it is visible which columns
+			 * dominate the decompression work.
+			 */
+			for (int algo = _INVALID_COMPRESSION_ALGORITHM + 1; algo < _END_COMPRESSION_ALGORITHMS;
+				 algo++)
+			{
+				if (instr->bytes_decompressed[algo] > 0)
+				{
+					char *label = psprintf("Bytes Decompressed (%s)",
+										   NameStr(*compression_get_algorithm_name(algo)));
+					ExplainPropertyInteger(label, NULL, instr->bytes_decompressed[algo], es);
+				}
+			}
 		}
 	}
 }
@@ -42,6 +42,20 @@ typedef struct ColumnarScanState
 	 * evaluate to constant false, hence the flag.
 	 */
 	List *vectorized_quals_original;
+
+	/*
+	 * Merge-on-read of partially compressed chunks: when set, the node
+	 * streams the uncompressed part of the chunk after the compressed
+	 * batches are exhausted, instead of relying on an Append over two
+	 * sub-scans. The tail tuples are checked row by row against both the
+	 * normal and the vectorized quals.
+	 */
+	bool scan_uncompressed_tail;
+	struct TableScanDescData *tail_scan_desc;
+	TupleTableSlot *tail_chunk_slot;
+	/* Maps scan tuple attribute offsets to uncompressed chunk attnos. */
+	AttrNumber *tail_attno_map;
+	ExprState *tail_vectorized_quals;
 } ColumnarScanState;
 
 extern Node *columnar_scan_state_create(CustomScan *cscan);
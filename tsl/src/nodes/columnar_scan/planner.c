@@ -6,8 +6,10 @@
 
 #include <postgres.h>
 #include <access/sysattr.h>
+#include <catalog/pg_collation.h>
 #include <catalog/pg_namespace.h>
 #include <catalog/pg_operator.h>
+#include <utils/fmgroids.h>
 #include <nodes/bitmapset.h>
 #include <nodes/extensible.h>
 #include <nodes/makefuncs.h>
@@ -19,9 +21,11 @@
 #include <optimizer/plancat.h>
 #include <optimizer/restrictinfo.h>
 #include <optimizer/tlist.h>
+#include <access/htup_details.h>
 #include <parser/parse_relation.h>
 #include <parser/parsetree.h>
 #include <utils/builtins.h>
+#include <utils/syscache.h>
 #include <utils/typcache.h>
 
 #include "compression/compression.h"
@@ -891,6 +895,28 @@ vector_qual_make(Node *qual, const VectorQualInfo *vqinfo)
 		return NULL;
 	}
 
+	switch (opcode)
+	{
+		case F_TEXTICLIKE:
+		case F_TEXTICNLIKE:
+		case F_TEXTREGEXEQ:
+		case F_TEXTREGEXNE:
+		case F_TEXTICREGEXEQ:
+		case F_TEXTICREGEXNE:
+			/*
+			 * The vectorized implementations of these predicates use the
+			 * default collation for case mapping and character classification,
+			 * so don't vectorize them for columns with some other collation.
+			 */
+			if (var->varcollid != DEFAULT_COLLATION_OID)
+			{
+				return NULL;
+			}
+			break;
+		default:
+			break;
+	}
+
 	if (OidIsValid(var->varcollid) && !get_collation_isdeterministic(var->varcollid))
 	{
 		/*
@@ -1061,6 +1087,21 @@ find_var_subexpression(void *expr, Index varno)
 	return NULL;
 }
 
+/*
+ * Whether the given chunk attribute is declared NOT NULL.
+ */
+static bool
+attr_is_notnull(Oid relid, AttrNumber attno)
+{
+	HeapTuple tp = SearchSysCache2(ATTNUM, ObjectIdGetDatum(relid), Int16GetDatum(attno));
+	if (!HeapTupleIsValid(tp))
+		return false;
+	Form_pg_attribute att_tup = (Form_pg_attribute) GETSTRUCT(tp);
+	bool result = att_tup->attnotnull;
+	ReleaseSysCache(tp);
+	return result;
+}
+
 Plan *
 columnar_scan_plan_create(PlannerInfo *root, RelOptInfo *rel, CustomPath *path,
 						  List *output_targetlist, List *clauses, List *custom_plans)
@@ -1203,6 +1244,7 @@ columnar_scan_plan_create(PlannerInfo *root, RelOptInfo *rel, CustomPath *path,
 		List *sort_ops = NIL;
 		List *sort_collations = NIL;
 		List *sort_nulls = NIL;
+		Var *first_sort_key_var = NULL;
 
 		/*
 		 */
@@ -1289,6 +1331,9 @@ columnar_scan_plan_create(PlannerInfo *root, RelOptInfo *rel, CustomPath *path,
 						 var->vartype,
 						 pk->pk_opfamily);
 
+				if (sort_col_idx == NIL)
+					first_sort_key_var = var;
+
 				sort_col_idx = lappend_oid(sort_col_idx, decompressed_scan_attno);
 				sort_collations = lappend_oid(sort_collations, var->varcollid);
 				sort_nulls = lappend_oid(sort_nulls, pk->pk_nulls_first);
@@ -1360,6 +1405,23 @@ columnar_scan_plan_create(PlannerInfo *root, RelOptInfo *rel, CustomPath *path,
 			nullsFirst[i] = list_nth_oid(sort_nulls, i);
 		}
 
+		/*
+		 * When the first sort column is NOT NULL, the sort key of the first
+		 * tuple of an incoming batch can be read from this min/max metadata
+		 * column of the compressed tuple, which allows the batch queue to
+		 * defer opening the batch until the merge actually advances to its
+		 * first key. A nullable column cannot use this shortcut, because the
+		 * metadata does not reflect the null values, which may sort before
+		 * all the non-null ones.
+		 */
+		AttrNumber first_key_meta_attno = InvalidAttrNumber;
+		if (first_sort_key_var != NULL &&
+			attr_is_notnull(dcpath->info->chunk_rte->relid, first_sort_key_var->varattno))
+		{
+			first_key_meta_attno = sortColIdx[0];
+		}
+		sort_options = lappend(sort_options, makeInteger(first_key_meta_attno));
+
 		/* Now build the compressed batches sort node */
 		Sort *sort = ts_make_sort((Plan *) compressed_scan,
 								  numsortkeys,
@@ -1450,6 +1512,8 @@ columnar_scan_plan_create(PlannerInfo *root, RelOptInfo *rel, CustomPath *path,
 	lfirst_int(list_nth_cell(settings, DCS_EnableBulkDecompression)) = enable_bulk_decompression;
 	lfirst_int(list_nth_cell(settings, DCS_HasRowMarks)) = root->parse->rowMarks != NIL;
 	lfirst_int(list_nth_cell(settings, DCS_ChunkStatus)) = dcpath->chunk_status;
+	lfirst_int(list_nth_cell(settings, DCS_ScanUncompressedTail)) =
+		dcpath->include_uncompressed_tail;
 
 	/*
 	 * Vectorized quals must go into custom_exprs, because Postgres has to see
@@ -8,6 +8,11 @@
 
 #include <miscadmin.h>
 
+#include <catalog/pg_collation.h>
+#include <mb/pg_wchar.h>
+#include <regex/regex.h>
+#include <utils/formatting.h>
+
 #include "compat/compat.h"
 
 #if PG16_GE
@@ -169,3 +174,195 @@ vector_const_textnlike_utf8(const ArrowArray *arrow, const Datum constdatum,
 {
 	vector_const_like_impl(arrow, constdatum, result, UTF8_MatchText, /* should_match = */ false);
 }
+
+/*
+ * ILIKE follows Generic_Text_IC_like from the Postgres like.c: lower-case both
+ * the pattern and the data and then do a case-sensitive match. The pattern is
+ * lowered only once for the entire vector. The planner only chooses this
+ * implementation for columns with the default collation, so the default
+ * collation is used for the case mapping.
+ */
+static void
+vector_const_ilike_impl(const ArrowArray *arrow, const Datum constdatum, uint64 *restrict result,
+						bool should_match)
+{
+	Assert(!arrow->dictionary);
+
+	text *consttext = (text *) DatumGetPointer(constdatum);
+	char *pattern =
+		str_tolower(VARDATA_ANY(consttext), VARSIZE_ANY_EXHDR(consttext), DEFAULT_COLLATION_OID);
+	const int patternlen = strlen(pattern);
+	const uint32 *offsets = (uint32 *) arrow->buffers[1];
+	const char *restrict values = arrow->buffers[2];
+
+	const size_t n = arrow->length;
+	for (size_t outer = 0; outer < n / 64; outer++)
+	{
+		uint64 word = 0;
+		for (size_t inner = 0; inner < 64; inner++)
+		{
+			const size_t row = (outer * 64) + inner;
+			const size_t bit_index = inner;
+#define INNER_LOOP                                                                                 \
+	const uint32 start = offsets[row];                                                             \
+	const uint32 end = offsets[row + 1];                                                           \
+	Assert(end >= start);                                                                          \
+	char *lowered = str_tolower(&values[start], end - start, DEFAULT_COLLATION_OID);               \
+	int match = UTF8_MatchText(lowered, strlen(lowered), pattern, patternlen);                     \
+	pfree(lowered);                                                                                \
+	bool valid = (match == LIKE_TRUE) == should_match;                                             \
+	word |= ((uint64) valid) << bit_index;
+
+			INNER_LOOP
+		}
+		result[outer] &= word;
+	}
+
+	if (n % 64)
+	{
+		uint64 word = 0;
+		for (size_t row = (n / 64) * 64; row < n; row++)
+		{
+			const size_t bit_index = row % 64;
+			INNER_LOOP
+		}
+		result[n / 64] &= word;
+	}
+
+#undef INNER_LOOP
+
+	pfree(pattern);
+}
+
+void
+vector_const_texticlike_utf8(const ArrowArray *arrow, const Datum constdatum,
+							 uint64 *restrict result)
+{
+	vector_const_ilike_impl(arrow, constdatum, result, /* should_match = */ true);
+}
+
+void
+vector_const_texticnlike_utf8(const ArrowArray *arrow, const Datum constdatum,
+							  uint64 *restrict result)
+{
+	vector_const_ilike_impl(arrow, constdatum, result, /* should_match = */ false);
+}
+
+/*
+ * Regex matching. The pattern is compiled only once for the entire vector, so
+ * for dictionary-encoded columns the compilation and per-entry matching cost
+ * is paid once per distinct value. Like the Postgres regexp.c, the data is
+ * converted to pg_wchar for the regex engine, which makes this work for any
+ * server encoding. The planner only chooses this implementation for columns
+ * with the default collation.
+ */
+static void
+vector_const_regex_impl(const ArrowArray *arrow, const Datum constdatum, uint64 *restrict result,
+						int cflags, bool should_match)
+{
+	Assert(!arrow->dictionary);
+
+	text *consttext = (text *) DatumGetPointer(constdatum);
+	const int patternlen = VARSIZE_ANY_EXHDR(consttext);
+	pg_wchar *wpattern = palloc((patternlen + 1) * sizeof(pg_wchar));
+	const int wpatternlen = pg_mb2wchar_with_len(VARDATA_ANY(consttext), wpattern, patternlen);
+
+	regex_t re;
+	int status = pg_regcomp(&re, wpattern, wpatternlen, cflags, DEFAULT_COLLATION_OID);
+	pfree(wpattern);
+	if (status != REG_OKAY)
+	{
+		char errstr[100];
+		pg_regerror(status, &re, errstr, sizeof(errstr));
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_REGULAR_EXPRESSION),
+				 errmsg("invalid regular expression: %s", errstr)));
+	}
+
+	const uint32 *offsets = (uint32 *) arrow->buffers[1];
+	const char *restrict values = arrow->buffers[2];
+
+	/*
+	 * Reuse one conversion buffer sized for the longest element instead of
+	 * allocating per row.
+	 */
+	const size_t n = arrow->length;
+	uint32 max_bytes = 0;
+	for (size_t row = 0; row < n; row++)
+	{
+		Assert(offsets[row + 1] >= offsets[row]);
+		const uint32 veclen = offsets[row + 1] - offsets[row];
+		max_bytes = Max(max_bytes, veclen);
+	}
+	pg_wchar *wdata = palloc((max_bytes + 1) * sizeof(pg_wchar));
+
+	for (size_t outer = 0; outer < (n + 63) / 64; outer++)
+	{
+		uint64 word = 0;
+		const size_t rows_in_word = Min(64, n - outer * 64);
+		for (size_t inner = 0; inner < rows_in_word; inner++)
+		{
+			const size_t row = (outer * 64) + inner;
+			const uint32 start = offsets[row];
+			const uint32 veclen = offsets[row + 1] - start;
+			const int wlen = pg_mb2wchar_with_len(&values[start], wdata, veclen);
+			status = pg_regexec(&re,
+								wdata,
+								wlen,
+								/* search_start = */ 0,
+								/* details = */ NULL,
+								/* nmatch = */ 0,
+								/* pmatch = */ NULL,
+								/* flags = */ 0);
+			if (status != REG_OKAY && status != REG_NOMATCH)
+			{
+				char errstr[100];
+				pg_regerror(status, &re, errstr, sizeof(errstr));
+				pg_regfree(&re);
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_REGULAR_EXPRESSION),
+						 errmsg("regular expression failed: %s", errstr)));
+			}
+			const bool valid = (status == REG_OKAY) == should_match;
+			word |= ((uint64) valid) << inner;
+		}
+		result[outer] &= word;
+	}
+
+	pfree(wdata);
+	pg_regfree(&re);
+}
+
+void
+vector_const_textregexeq(const ArrowArray *arrow, const Datum constdatum, uint64 *restrict result)
+{
+	vector_const_regex_impl(arrow, constdatum, result, REG_ADVANCED, /* should_match = */ true);
+}
+
+void
+vector_const_textregexne(const ArrowArray *arrow, const Datum constdatum, uint64 *restrict result)
+{
+	vector_const_regex_impl(arrow, constdatum, result, REG_ADVANCED, /* should_match = */ false);
+}
+
+void
+vector_const_texticregexeq(const ArrowArray *arrow, const Datum constdatum,
+						   uint64 *restrict result)
+{
+	vector_const_regex_impl(arrow,
+							constdatum,
+							result,
+							REG_ADVANCED | REG_ICASE,
+							/* should_match = */ true);
+}
+
+void
+vector_const_texticregexne(const ArrowArray *arrow, const Datum constdatum,
+						   uint64 *restrict result)
+{
+	vector_const_regex_impl(arrow,
+							constdatum,
+							result,
+							REG_ADVANCED | REG_ICASE,
+							/* should_match = */ false);
+}
@@ -6,6 +6,9 @@
 
 #include <postgres.h>
 
+#include <common/hashfn.h>
+#include <port/pg_bitutils.h>
+
 #include "compression/arrow_c_data_interface.h"
 #include "compression/compression.h"
 #include "src/utils.h"
@@ -136,3 +139,254 @@ vector_array_predicate(VectorPredicate *vector_const_predicate, bool is_or,
 		}
 	}
 }
+
+/*
+ * A hash set over the elements of an IN-list array constant, used to evaluate
+ * large vectorized IN-lists in one pass over the batch instead of one pass per
+ * array element. Only applicable when the equality operator of the scalar
+ * array operation is equivalent to comparing the binary representations of the
+ * operands, see get_vector_const_bitwise_eq_width(). The sets are built on the
+ * first evaluation and cached for the lifetime of the scan, keyed by the array
+ * datum which comes from a constant created at planning time.
+ */
+typedef struct VectorArrayHashSet
+{
+	struct VectorArrayHashSet *next;
+
+	/* The array constant this hash set was built from. */
+	Datum array;
+
+	/*
+	 * The open-addressing hash table with linear probing. The keys are the
+	 * element binary representations zero-extended to 16 bytes. The keys stay
+	 * NULL when we decided that the hashed path doesn't pay off for this
+	 * array, so that we don't have to re-check this for every batch.
+	 */
+	uint64 *keys0;
+	uint64 *keys1;
+	uint64 *used_buckets; /* Arrow-style validity bitmap of the used buckets. */
+	uint32 bucket_mask;	  /* Number of buckets minus one, power of two. */
+} VectorArrayHashSet;
+
+/*
+ * Building the hash set costs a pass over the array, and the generic
+ * implementation is one pass over the batch per array element, so the hash
+ * table only pays off for the arrays that are not small compared to the
+ * typical number of batch rows.
+ */
+#define VECTOR_ARRAY_HASH_MIN_ITEMS 64
+
+static inline uint64
+vector_array_hash_key(uint64 key0, uint64 key1)
+{
+	/*
+	 * murmurhash64(0) == 0, so for the common up-to-8-byte keys this reduces
+	 * to hashing key0 alone.
+	 */
+	return murmurhash64(key0 ^ murmurhash64(key1));
+}
+
+static void
+vector_array_hash_set_insert(VectorArrayHashSet *set, uint64 key0, uint64 key1)
+{
+	uint32 bucket = vector_array_hash_key(key0, key1) & set->bucket_mask;
+	while (arrow_row_is_valid(set->used_buckets, bucket))
+	{
+		if (set->keys0[bucket] == key0 && set->keys1[bucket] == key1)
+		{
+			/* A duplicate array element. */
+			return;
+		}
+		bucket = (bucket + 1) & set->bucket_mask;
+	}
+
+	set->keys0[bucket] = key0;
+	set->keys1[bucket] = key1;
+	arrow_set_row_validity(set->used_buckets, bucket, true);
+}
+
+static inline bool
+vector_array_hash_set_contains(const VectorArrayHashSet *set, uint64 key0, uint64 key1)
+{
+	uint32 bucket = vector_array_hash_key(key0, key1) & set->bucket_mask;
+	while (arrow_row_is_valid(set->used_buckets, bucket))
+	{
+		if (set->keys0[bucket] == key0 && set->keys1[bucket] == key1)
+		{
+			return true;
+		}
+		bucket = (bucket + 1) & set->bucket_mask;
+	}
+	return false;
+}
+
+static void
+vector_array_hash_set_build(VectorArrayHashSet *set, MemoryContext mctx, int value_bytes)
+{
+	ArrayType *arr = DatumGetArrayTypeP(set->array);
+
+	int16 typlen;
+	bool typbyval;
+	char typalign;
+	get_typlenbyvalalign(ARR_ELEMTYPE(arr), &typlen, &typbyval, &typalign);
+	Assert(typlen == value_bytes);
+
+	const char *array_data = (const char *) ARR_DATA_PTR(arr);
+	const size_t nitems = ArrayGetNItems(ARR_NDIM(arr), ARR_DIMS(arr));
+	const uint64 *array_null_bitmap = (uint64 *) ARR_NULLBITMAP(arr);
+
+	if (nitems < VECTOR_ARRAY_HASH_MIN_ITEMS)
+	{
+		/* Leave the keys NULL to remember that we use the generic path. */
+		return;
+	}
+
+	/*
+	 * Size the table for a maximum load factor of 50%.
+	 */
+	const uint32 num_buckets = pg_nextpower2_32(nitems * 2);
+	set->bucket_mask = num_buckets - 1;
+	set->keys0 = MemoryContextAlloc(mctx, sizeof(uint64) * num_buckets);
+	set->keys1 = MemoryContextAlloc(mctx, sizeof(uint64) * num_buckets);
+	set->used_buckets = MemoryContextAllocZero(mctx, sizeof(uint64) * ((num_buckets + 63) / 64));
+
+	for (size_t array_index = 0; array_index < nitems; array_index++)
+	{
+		if (array_null_bitmap != NULL && !arrow_row_is_valid(array_null_bitmap, array_index))
+		{
+			/*
+			 * A null element cannot match any row in the ANY case, same as in
+			 * the generic implementation, so it is simply skipped.
+			 */
+			continue;
+		}
+
+		Datum constvalue = ts_fetch_att(array_data, typbyval, typlen);
+		array_data = att_addlength_pointer(array_data, typlen, array_data);
+		array_data = (const char *) att_align_nominal(array_data, typalign);
+
+		uint64 key0 = 0;
+		uint64 key1 = 0;
+		if (typbyval)
+		{
+			/*
+			 * Zero-extend the value. Note that the Datum itself can be
+			 * sign-extended for the smaller types, so we have to go through a
+			 * cast to the properly sized unsigned type to match the probing
+			 * side which reads the raw values from the arrow buffer.
+			 */
+			switch (value_bytes)
+			{
+				case 2:
+					key0 = DatumGetUInt16(constvalue);
+					break;
+				case 4:
+					key0 = DatumGetUInt32(constvalue);
+					break;
+				default:
+					Assert(value_bytes == 8);
+					key0 = DatumGetUInt64(constvalue);
+					break;
+			}
+		}
+		else
+		{
+			/* An 8-byte type on 32-bit systems, or a 16-byte type like uuid. */
+			const char *data = DatumGetPointer(constvalue);
+			memcpy(&key0, data, Min(value_bytes, 8));
+			if (value_bytes > 8)
+			{
+				memcpy(&key1, data + 8, value_bytes - 8);
+			}
+		}
+
+		vector_array_hash_set_insert(set, key0, key1);
+	}
+}
+
+/*
+ * Hashed implementation of the "scalar = ANY(array)" predicate for fixed-width
+ * types where the equality operator compares the binary representations. The
+ * generic vector_array_predicate() performs one pass over the batch per array
+ * element, which is quadratic for the large IN-lists, so here we instead probe
+ * a cached hash set of the array elements once per row.
+ *
+ * Returns false when the hashed path is not applicable, e.g. the array is too
+ * small for the hash table to pay off, and the caller has to fall back to the
+ * generic implementation.
+ */
+bool
+vector_array_predicate_hashed(VectorArrayHashSet **cache, MemoryContext cache_mctx,
+							  int value_bytes, const ArrowArray *vector, Datum array,
+							  uint64 *restrict final_result)
+{
+	VectorArrayHashSet *set = NULL;
+	for (VectorArrayHashSet *entry = *cache; entry != NULL; entry = entry->next)
+	{
+		if (entry->array == array)
+		{
+			set = entry;
+			break;
+		}
+	}
+
+	if (set == NULL)
+	{
+		set = MemoryContextAllocZero(cache_mctx, sizeof(VectorArrayHashSet));
+		set->array = array;
+		vector_array_hash_set_build(set, cache_mctx, value_bytes);
+		set->next = *cache;
+		*cache = set;
+	}
+
+	if (set->keys0 == NULL)
+	{
+		/* The array is too small for the hash table to pay off. */
+		return false;
+	}
+
+	/*
+	 * Probe the hash set for each row. The values of the null rows are garbage
+	 * but it is harmless to probe with them, because the caller combines the
+	 * result with the validity bitmap afterwards.
+	 */
+	const size_t n_rows = vector->length;
+	const char *values = vector->buffers[1];
+	for (size_t row = 0; row < n_rows; row++)
+	{
+		uint64 key0 = 0;
+		uint64 key1 = 0;
+		switch (value_bytes)
+		{
+			case 2:
+			{
+				uint16 value;
+				memcpy(&value, &values[2 * row], 2);
+				key0 = value;
+				break;
+			}
+			case 4:
+			{
+				uint32 value;
+				memcpy(&value, &values[4 * row], 4);
+				key0 = value;
+				break;
+			}
+			case 8:
+				memcpy(&key0, &values[8 * row], 8);
+				break;
+			default:
+				Assert(value_bytes == 16);
+				memcpy(&key0, &values[16 * row], 8);
+				memcpy(&key1, &values[16 * row + 8], 8);
+				break;
+		}
+
+		if (!vector_array_hash_set_contains(set, key0, key1))
+		{
+			final_result[row / 64] &= ~(1ULL << (row % 64));
+		}
+	}
+
+	return true;
+}
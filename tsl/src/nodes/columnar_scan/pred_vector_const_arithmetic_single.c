@@ -21,7 +21,7 @@ case PG_PREDICATE_HELPER(PREDICATE_NAME):
 	return FUNCTION_NAME(PREDICATE_NAME, VECTOR_CTYPE, CONST_CTYPE);
 #else
 
-static pg_noinline void
+TS_SIMD_TARGET_CLONES static pg_noinline void
 FUNCTION_NAME(PREDICATE_NAME, VECTOR_CTYPE,
 			  CONST_CTYPE)(const ArrowArray *arrow, const Datum constdatum, uint64 *restrict result)
 {
@@ -18,6 +18,7 @@
 #include "compression/sparse_index_bloom1.h"
 #include "custom_type_cache.h"
 #include "guc.h"
+#include "sort_transform.h"
 #include "ts_catalog/array_utils.h"
 
 #include "qual_pushdown.h"
@@ -113,9 +114,28 @@ pushdown_quals(PlannerInfo *root, CompressionSettings *settings, RelOptInfo *chu
 	chunk_rel->baserestrictinfo = decompress_clauses;
 }
 
+typedef struct VarReplaceContext
+{
+	Var *target;
+	Var *replacement;
+} VarReplaceContext;
+
+static Node *
+replace_var_mutator(Node *node, VarReplaceContext *context)
+{
+	if (node == NULL)
+		return NULL;
+
+	if (IsA(node, Var) && equal(node, context->target))
+		return (Node *) copyObject(context->replacement);
+
+	return expression_tree_mutator(node, replace_var_mutator, (void *) context);
+}
+
 static OpExpr *
 make_segment_meta_opexpr(QualPushdownContext *context, Oid opno, AttrNumber meta_column_attno,
-						 Var *uncompressed_var, Expr *compare_to_expr, StrategyNumber strategy)
+						 Expr *orig_leftop, Var *uncompressed_var, Expr *compare_to_expr,
+						 Oid op_collation, StrategyNumber strategy)
 {
 	Var *meta_var = makeVar(context->compressed_rel->relid,
 							meta_column_attno,
@@ -124,24 +144,71 @@ make_segment_meta_opexpr(QualPushdownContext *context, Oid opno, AttrNumber meta
 							InvalidOid,
 							0);
 
+	Expr *meta_expr = (Expr *) meta_var;
+	if (!IsA(orig_leftop, Var))
+	{
+		/*
+		 * A qual on an order-preserving function of the column: apply the
+		 * same function to the metadata column.
+		 */
+		VarReplaceContext replace_context = { .target = uncompressed_var, .replacement = meta_var };
+		meta_expr = (Expr *) replace_var_mutator((Node *) copyObject(orig_leftop), &replace_context);
+	}
+
 	return (OpExpr *) make_opclause(opno,
 									BOOLOID,
 									false,
-									(Expr *) meta_var,
+									meta_expr,
 									copyObject(compare_to_expr),
 									InvalidOid,
-									uncompressed_var->varcollid);
+									op_collation);
 }
 
-static void
+/*
+ * Fetch the min/max metadata columns for a qual operand, if they exist.
+ *
+ * In addition to plain column references, this handles quals on strict
+ * order-preserving functions of a column, like date_trunc() or time_bucket().
+ * Such functions map the [min, max] value range of a batch to [f(min), f(max)],
+ * so the qual can be checked against the function applied to the metadata
+ * columns. The sort transform machinery knows which expressions are order
+ * preserving.
+ *
+ * Returns the underlying column reference, or NULL when the operand cannot use
+ * the min/max sparse index.
+ */
+static Var *
 expr_fetch_minmax_metadata(QualPushdownContext *context, Expr *expr, AttrNumber *min_attno,
 						   AttrNumber *max_attno)
 {
 	*min_attno = InvalidAttrNumber;
 	*max_attno = InvalidAttrNumber;
 
+	if (IsA(expr, FuncExpr))
+	{
+		FuncExpr *func = castNode(FuncExpr, expr);
+
+		/*
+		 * Restrict the rewrite to strict non-volatile functions without
+		 * collation dependencies. Strictness guarantees that rows with a null
+		 * column value, which are not reflected in the min/max metadata,
+		 * cannot pass the original qual either. The expressions recognized by
+		 * the sort transform only consist of strict builtin functions, so
+		 * checking the topmost function is enough.
+		 */
+		if (func->funcretset || OidIsValid(func->funccollid) || OidIsValid(func->inputcollid) ||
+			!func_strict(func->funcid) || contain_volatile_functions((Node *) func))
+			return NULL;
+
+		Expr *transformed = ts_sort_transform_expr(expr);
+		if (!IsA(transformed, Var))
+			return NULL;
+
+		expr = transformed;
+	}
+
 	if (!IsA(expr, Var))
-		return;
+		return NULL;
 
 	Var *var = castNode(Var, expr);
 
@@ -150,11 +217,11 @@ expr_fetch_minmax_metadata(QualPushdownContext *context, Expr *expr, AttrNumber
 	 * push down the join quals, only the baserestrictinfo.
 	 */
 	if ((Index) var->varno != context->chunk_rel->relid)
-		return;
+		return NULL;
 
 	/* ignore system attributes or whole row references */
 	if (var->varattno <= 0)
-		return;
+		return NULL;
 
 	*min_attno = compressed_column_metadata_attno(context->settings,
 												  context->chunk_rte->relid,
@@ -166,6 +233,7 @@ expr_fetch_minmax_metadata(QualPushdownContext *context, Expr *expr, AttrNumber
 												  var->varattno,
 												  context->compressed_rte->relid,
 												  "max");
+	return var;
 }
 
 static void *
@@ -190,7 +258,8 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 	Oid op_oid = orig_opexpr->opno;
 	AttrNumber min_attno;
 	AttrNumber max_attno;
-	expr_fetch_minmax_metadata(context, orig_leftop, &min_attno, &max_attno);
+	Var *var_with_segment_meta =
+		expr_fetch_minmax_metadata(context, orig_leftop, &min_attno, &max_attno);
 	if (min_attno == InvalidAttrNumber || max_attno == InvalidAttrNumber)
 	{
 		/* No metadata for the left operand, try to commute the operator. */
@@ -199,18 +268,18 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 		orig_leftop = orig_rightop;
 		orig_rightop = tmp;
 
-		expr_fetch_minmax_metadata(context, orig_leftop, &min_attno, &max_attno);
+		var_with_segment_meta =
+			expr_fetch_minmax_metadata(context, orig_leftop, &min_attno, &max_attno);
 	}
 
-	if (min_attno == InvalidAttrNumber || max_attno == InvalidAttrNumber)
+	if (var_with_segment_meta == NULL || min_attno == InvalidAttrNumber ||
+		max_attno == InvalidAttrNumber)
 	{
 		/* No metadata for either operand. */
 		context->can_pushdown = false;
 		return orig_opexpr;
 	}
 
-	Var *var_with_segment_meta = castNode(Var, orig_leftop);
-
 	/* May be able to allow non-strict operations as well.
 	 * Next steps: Think through edge cases, either allow and write tests or figure out why we must
 	 * block strict operations
@@ -222,16 +291,19 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 	}
 
 	/* If the collation to be used by the OP doesn't match the column's collation do not push down
-	 * as the materialized min/max value do not match the semantics of what we need here */
+	 * as the materialized min/max value do not match the semantics of what we need here. For a
+	 * function of the column, the function result must be collation-free (already checked when
+	 * fetching the metadata), so the operator must not use a collation either. */
 	Oid op_collation = orig_opexpr->inputcollid;
-	if (var_with_segment_meta->varcollid != op_collation)
+	if (IsA(orig_leftop, Var) ? var_with_segment_meta->varcollid != op_collation
+							  : OidIsValid(op_collation))
 	{
 		context->can_pushdown = false;
 		return orig_opexpr;
 	}
 
 	TypeCacheEntry *tce =
-		lookup_type_cache(var_with_segment_meta->vartype, TYPECACHE_BTREE_OPFAMILY);
+		lookup_type_cache(exprType((Node *) orig_leftop), TYPECACHE_BTREE_OPFAMILY);
 
 	const int strategy = get_op_opfamily_strategy(op_oid, tce->btree_opf);
 	if (strategy == InvalidStrategy)
@@ -283,14 +355,18 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 				list_make2(make_segment_meta_opexpr(context,
 													opno_le,
 													min_attno,
+													orig_leftop,
 													var_with_segment_meta,
 													pushed_down_rightop,
+													op_collation,
 													BTLessEqualStrategyNumber),
 						   make_segment_meta_opexpr(context,
 													opno_ge,
 													max_attno,
+													orig_leftop,
 													var_with_segment_meta,
 													pushed_down_rightop,
+													op_collation,
 													BTGreaterEqualStrategyNumber)));
 		}
 		case BTLessStrategyNumber:
@@ -313,8 +389,10 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 				return (Expr *) make_segment_meta_opexpr(context,
 														 opno,
 														 min_attno,
+														 orig_leftop,
 														 var_with_segment_meta,
 														 pushed_down_rightop,
+														 op_collation,
 														 strategy);
 			}
 
@@ -338,8 +416,10 @@ pushdown_op_to_segment_meta_min_max(QualPushdownContext *context, OpExpr *orig_o
 				return (Expr *) make_segment_meta_opexpr(context,
 														 opno,
 														 max_attno,
+														 orig_leftop,
 														 var_with_segment_meta,
 														 pushed_down_rightop,
+														 op_collation,
 														 strategy);
 			}
 		default:
@@ -59,6 +59,18 @@ get_vector_const_predicate(Oid pg_predicate)
 		case F_UUID_NE:
 			return vector_uuidne;
 
+		case F_TEXTREGEXEQ:
+			return vector_const_textregexeq;
+
+		case F_TEXTREGEXNE:
+			return vector_const_textregexne;
+
+		case F_TEXTICREGEXEQ:
+			return vector_const_texticregexeq;
+
+		case F_TEXTICREGEXNE:
+			return vector_const_texticregexne;
+
 		default:
 			/*
 			 * More checks below, this branch is to placate the static analyzers.
@@ -75,6 +87,10 @@ get_vector_const_predicate(Oid pg_predicate)
 				return vector_const_textlike_utf8;
 			case F_TEXTNLIKE:
 				return vector_const_textnlike_utf8;
+			case F_TEXTICLIKE:
+				return vector_const_texticlike_utf8;
+			case F_TEXTICNLIKE:
+				return vector_const_texticnlike_utf8;
 			default:
 				/*
 				 * This branch is to placate the static analyzers.
@@ -86,6 +102,38 @@ get_vector_const_predicate(Oid pg_predicate)
 	return NULL;
 }
 
+/*
+ * For some equality operators, both sides have the same fixed-width binary
+ * representation, and the operator is equivalent to comparing these
+ * representations for equality. Such operators can be evaluated with a hash
+ * table when the right side is a large IN-list, see
+ * vector_array_predicate_hashed(). Returns the width of the representation in
+ * bytes, or 0 when the operator doesn't have this property. Note that this
+ * excludes the floating point types where the equality is not bitwise, e.g.
+ * -0 == 0 and NaN != NaN.
+ */
+int
+get_vector_const_bitwise_eq_width(Oid pg_predicate)
+{
+	switch (pg_predicate)
+	{
+		case F_INT2EQ:
+			return 2;
+		case F_INT4EQ:
+		case F_DATE_EQ:
+			return 4;
+		case F_INT8EQ:
+		case F_TIME_EQ:
+		case F_TIMESTAMP_EQ:
+		case F_TIMESTAMPTZ_EQ:
+			return 8;
+		case F_UUID_EQ:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
 void
 vector_nulltest(const ArrowArray *arrow, int test_type, uint64 *restrict result)
 {
@@ -9,13 +9,36 @@
  */
 #pragma once
 
+/*
+ * The distribution builds target baseline x86-64, where the compiler can only
+ * auto-vectorize the filter loops with SSE2. Where function multi-versioning is
+ * supported, we ask it to additionally generate AVX2 and AVX-512 clones of
+ * these loops, selected at startup through the ifunc mechanism. The other
+ * architectures don't need this, e.g. the AArch64 baseline already includes
+ * NEON.
+ */
+#if defined(TS_USE_TARGET_CLONES) && defined(__x86_64__)
+#define TS_SIMD_TARGET_CLONES                                                                      \
+	__attribute__((target_clones("avx512f,avx512bw", "avx2", "default")))
+#else
+#define TS_SIMD_TARGET_CLONES
+#endif
+
 typedef void(VectorPredicate)(const ArrowArray *, Datum, uint64 *restrict);
 
 VectorPredicate *get_vector_const_predicate(Oid pg_predicate);
 
+int get_vector_const_bitwise_eq_width(Oid pg_predicate);
+
 void vector_array_predicate(VectorPredicate *vector_const_predicate, bool is_or,
 							const ArrowArray *vector, Datum array, uint64 *restrict final_result);
 
+struct VectorArrayHashSet;
+
+bool vector_array_predicate_hashed(struct VectorArrayHashSet **cache, MemoryContext cache_mctx,
+								   int value_bytes, const ArrowArray *vector, Datum array,
+								   uint64 *restrict final_result);
+
 void vector_nulltest(const ArrowArray *arrow, int test_type, uint64 *restrict result);
 
 /* this implements the vectorized BooleanTest, where NULLs are handled in a special way:
@@ -39,6 +39,29 @@ typedef struct VectorQualInfo
 	AttrNumber maxattno;
 } VectorQualInfo;
 
+/*
+ * Statistics about the top-level vectorized qual conjunction, used to
+ * adaptively evaluate the quals in the order of their observed batch kill
+ * rates. The arrays are indexed by the position of the qual in the
+ * vectorized_quals_constified list.
+ */
+typedef struct VectorQualStats
+{
+	int num_quals;
+
+	/* The current evaluation order of the quals. */
+	int *order;
+
+	/* How many times each qual was evaluated. */
+	uint64 *evaluated;
+
+	/* How many times each qual filtered out the entire batch. */
+	uint64 *killed;
+
+	/* Total batches seen, used to periodically recompute the order. */
+	uint64 batches;
+} VectorQualStats;
+
 /*
  * VectorQualState keeps the necessary state needed for the computation of
  * vectorized filters in scan nodes.
@@ -51,6 +74,25 @@ typedef struct VectorQualState
 	MemoryContext per_vector_mcxt;
 	TupleTableSlot *slot;
 
+	/*
+	 * Optional statistics for adaptive ordering of the top-level qual
+	 * conjunction. This state must live across the batches, e.g. in the scan
+	 * node state, because the VectorQualState itself is reinitialized for
+	 * every batch. NULL when the caller doesn't use adaptive ordering, in
+	 * which case the quals are evaluated in the list order.
+	 */
+	VectorQualStats *stats;
+
+	/*
+	 * Optional cache of the hash sets built for large vectorized IN-lists,
+	 * see vector_array_predicate_hashed(). Like the stats above, it must live
+	 * across the batches, so the cache head is stored in the scan node state
+	 * and the entries are allocated in the given scan-lifetime memory context.
+	 * NULL when the caller doesn't use the hashed IN-list path.
+	 */
+	struct VectorArrayHashSet **array_hash_sets;
+	MemoryContext array_hash_mctx;
+
 	/*
 	 * Interface function to be provided by scan node.
 	 *
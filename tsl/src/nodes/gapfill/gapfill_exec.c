@@ -11,6 +11,7 @@
 #include <catalog/pg_cast.h>
 #include <catalog/pg_collation.h>
 #include <catalog/pg_type.h>
+#include <common/int.h>
 #include <miscadmin.h>
 #include <nodes/extensible.h>
 #include <nodes/makefuncs.h>
@@ -636,6 +637,26 @@ gapfill_advance_timestamp(GapFillState *state)
 {
 	Datum next;
 
+	/*
+	 * Fixed-width buckets (gapfill_begin clears gapfill_interval for interval
+	 * widths without month or day components) advance by a constant number of
+	 * microseconds, so the per-row interval function calls below are only
+	 * needed for variable-sized buckets. The overflow check takes the place
+	 * of the range check in timestamp_pl_interval; values past gapfill_end
+	 * only terminate the scan and are never emitted.
+	 */
+	if (NULL == state->gapfill_interval &&
+		(state->gapfill_typid == TIMESTAMPOID || state->gapfill_typid == TIMESTAMPTZOID))
+	{
+		if (pg_add_s64_overflow(state->next_timestamp,
+								state->gapfill_period,
+								&state->next_timestamp))
+			ereport(ERROR,
+					(errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+					 errmsg("timestamp out of range")));
+		return;
+	}
+
 	switch (state->gapfill_typid)
 	{
 		case DATEOID:
@@ -660,11 +681,17 @@ gapfill_advance_timestamp(GapFillState *state)
 			if (state->have_timezone &&
 				(state->next_offset->day != 0 || state->next_offset->month != 0))
 			{
-				bool isnull;
-				/* TODO: optimize by constifying and caching the datum if possible */
-				Datum tzname =
-					gapfill_exec_expr(state, state->scanslot, get_timezone_arg(state), &isnull);
-				Assert(!isnull);
+				Datum tzname;
+
+				if (state->timezone_cached)
+					tzname = state->timezone_name;
+				else
+				{
+					bool isnull;
+					tzname =
+						gapfill_exec_expr(state, state->scanslot, get_timezone_arg(state), &isnull);
+					Assert(!isnull);
+				}
 
 				/* Convert to local timestamp */
 				next = DirectFunctionCall2(timestamptz_zone,
@@ -694,10 +721,14 @@ gapfill_advance_timestamp(GapFillState *state)
 	/* Advance the interval offset if necessary */
 	if (state->gapfill_interval)
 	{
+		Interval *old_offset = state->next_offset;
 		Datum tspan = DirectFunctionCall2(interval_pl,
 										  IntervalPGetDatum(state->gapfill_interval),
 										  IntervalPGetDatum(state->next_offset));
 		state->next_offset = DatumGetIntervalP(tspan);
+		/* don't accumulate one discarded interval per generated row */
+		if (old_offset != state->gapfill_interval)
+			pfree(old_offset);
 	}
 }
 
@@ -743,6 +774,21 @@ gapfill_begin(CustomScanState *node, EState *estate, int eflags)
 														arg_value,
 														&state->gapfill_interval);
 
+	/*
+	 * An interval bucket width without month or day components advances the
+	 * bucket by a fixed number of microseconds, so the per-row interval
+	 * arithmetic in gapfill_advance_timestamp can be replaced with plain
+	 * int64 additions. DATE buckets keep the interval path since their
+	 * result is truncated back to whole days.
+	 */
+	if (state->gapfill_interval && state->gapfill_interval->month == 0 &&
+		state->gapfill_interval->day == 0 &&
+		(state->gapfill_typid == TIMESTAMPOID || state->gapfill_typid == TIMESTAMPTZOID))
+	{
+		state->gapfill_period = state->gapfill_interval->time;
+		state->gapfill_interval = NULL;
+	}
+
 	/*
 	 * this would error when trying to align start and stop to bucket_width as well below
 	 * but checking this explicitly here will make a nicer error message
@@ -753,6 +799,17 @@ gapfill_begin(CustomScanState *node, EState *estate, int eflags)
 				 errmsg(
 					 "invalid time_bucket_gapfill argument: bucket_width must be greater than 0")));
 
+	/*
+	 * The timezone argument gets evaluated for every generated row when
+	 * bucketing by variable-sized intervals. A simple expression cannot
+	 * change between rows, so evaluate it once up front.
+	 */
+	if (state->have_timezone && is_simple_expr(get_timezone_arg(state)))
+	{
+		state->timezone_name = gapfill_exec_expr(state, NULL, get_timezone_arg(state), &isnull);
+		state->timezone_cached = !isnull;
+	}
+
 	/*
 	 * check if gapfill start was left out so we have to infer from WHERE
 	 * clause
@@ -100,12 +100,17 @@ typedef struct GapFillState
 	int64 gapfill_end;
 	/* bucket width for fixed-size buckets */
 	int64 gapfill_period;
-	/* bucket width when bucketing by month */
+	/* bucket width when bucketing by variable-sized intervals (month or day
+	 * components), NULL for fixed-width buckets */
 	Interval *gapfill_interval;
 
 	int64 next_timestamp;
 	/* interval offset for next_timestamp from gapfill_start */
 	Interval *next_offset;
+	/* timezone argument evaluated once at node start when it is a simple
+	 * expression, to avoid re-evaluating it per generated row */
+	Datum timezone_name;
+	bool timezone_cached;
 	int64 subslot_time; /* time of tuple in subslot */
 
 	int time_index;			 /* position of time column */
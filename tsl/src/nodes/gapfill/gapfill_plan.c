@@ -378,8 +378,12 @@ gapfill_path_create(PlannerInfo *root, Path *subpath, FuncExpr *func)
 	path->cpath.methods = &gapfill_path_methods;
 
 	/*
-	 * parallel_safe must be false because it is not safe to execute this node
-	 * in parallel, but it is safe for child nodes to be parallel
+	 * parallel_safe must be false because gap filling a group requires the
+	 * complete, time-ordered group in one process: parallel scans distribute
+	 * blocks to arbitrary workers, so running this node in a worker could
+	 * miss rows of its groups and fill gaps that aren't there. Child nodes
+	 * can still be parallel (the marker functions are PARALLEL SAFE), which
+	 * covers the aggregation below where the bulk of the work happens.
 	 */
 	Assert(!path->cpath.path.parallel_safe);
 	path->cpath.path.rows = subpath->rows;
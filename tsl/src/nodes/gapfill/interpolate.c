@@ -27,6 +27,7 @@ gapfill_interpolate_initialize(GapFillInterpolateColumnState *interpolate, GapFi
 {
 	interpolate->prev.isnull = true;
 	interpolate->next.isnull = true;
+	interpolate->cache_valid = false;
 	if (list_length(function->args) > 1)
 		interpolate->lookup_before = gapfill_adjust_varnos(state, lsecond(function->args));
 	if (list_length(function->args) > 2)
@@ -149,23 +150,63 @@ gapfill_fetch_sample(GapFillState *state, GapFillInterpolateColumnState *column,
 	ReleaseTupleDesc(tupdesc);
 }
 
+static void
+interpolate_numeric_cache_release(GapFillInterpolateColumnState *column)
+{
+	if (!column->cache_valid)
+		return;
+
+	pfree(DatumGetPointer(column->num_x0));
+	pfree(DatumGetPointer(column->num_x1));
+	pfree(DatumGetPointer(column->num_y0));
+	pfree(DatumGetPointer(column->num_y1));
+	pfree(DatumGetPointer(column->num_denom));
+	column->cache_valid = false;
+}
+
+/*
+ * Convert the endpoints of the current gap segment to numerics and compute
+ * the denominator. These are invariant for all rows generated within one
+ * segment, which for integer columns is the bulk of the per-row numeric
+ * work, so the results are cached until prev/next move to a new segment.
+ */
+static void
+interpolate_numeric_cache(GapFillInterpolateColumnState *column, GapFillState *state, int64 x0,
+						  int64 x1, Datum y0, Datum y1, PGFunction y_to_numeric)
+{
+	if (column->cache_valid && column->cache_x0 == x0 && column->cache_x1 == x1)
+		return;
+
+	interpolate_numeric_cache_release(column);
+
+	/* The cache must survive the per-row contexts this node is called in */
+	MemoryContext old_ctx = MemoryContextSwitchTo(state->csstate.ss.ps.state->es_query_cxt);
+	column->num_x0 = DirectFunctionCall1(int8_numeric, Int64GetDatum(x0));
+	column->num_x1 = DirectFunctionCall1(int8_numeric, Int64GetDatum(x1));
+	column->num_y0 = DirectFunctionCall1(y_to_numeric, y0);
+	column->num_y1 = DirectFunctionCall1(y_to_numeric, y1);
+	column->num_denom = DirectFunctionCall2(numeric_sub, column->num_x1, column->num_x0);
+	MemoryContextSwitchTo(old_ctx);
+
+	column->cache_valid = true;
+	column->cache_x0 = x0;
+	column->cache_x1 = x1;
+}
+
 /* Calculate the interpolation using numerics, returning the result as a numeric datum */
 static Datum
-interpolate_numeric(int64 x_i, int64 x0_i, int64 x1_i, Datum y0, Datum y1)
+interpolate_numeric(GapFillInterpolateColumnState *column, int64 x_i)
 {
-	Datum x0 = DirectFunctionCall1(int8_numeric, Int64GetDatum(x0_i));
-	Datum x1 = DirectFunctionCall1(int8_numeric, Int64GetDatum(x1_i));
 	Datum x = DirectFunctionCall1(int8_numeric, Int64GetDatum(x_i));
 
-	Datum x1_sub_x = DirectFunctionCall2(numeric_sub, x1, x);
-	Datum x_sub_x0 = DirectFunctionCall2(numeric_sub, x, x0);
-	Datum y0_mul_x1_sub_x = DirectFunctionCall2(numeric_mul, y0, x1_sub_x);
-	Datum y1_mul_x_sub_x0 = DirectFunctionCall2(numeric_mul, y1, x_sub_x0);
+	Datum x1_sub_x = DirectFunctionCall2(numeric_sub, column->num_x1, x);
+	Datum x_sub_x0 = DirectFunctionCall2(numeric_sub, x, column->num_x0);
+	Datum y0_mul_x1_sub_x = DirectFunctionCall2(numeric_mul, column->num_y0, x1_sub_x);
+	Datum y1_mul_x_sub_x0 = DirectFunctionCall2(numeric_mul, column->num_y1, x_sub_x0);
 
 	Datum numerator = DirectFunctionCall2(numeric_add, y0_mul_x1_sub_x, y1_mul_x_sub_x0);
-	Datum denominator = DirectFunctionCall2(numeric_sub, x1, x0);
 
-	return DirectFunctionCall2(numeric_div, numerator, denominator);
+	return DirectFunctionCall2(numeric_div, numerator, column->num_denom);
 }
 
 /*
@@ -208,31 +249,16 @@ gapfill_interpolate_calculate(GapFillInterpolateColumnState *column, GapFillStat
 		 doesn't handle really big ints exactly. We can't use the Postgres INT128 implementation
 		 because it doesn't support division. */
 		case INT2OID:
-			*value =
-				DirectFunctionCall1(numeric_int2,
-									interpolate_numeric(x,
-														x0,
-														x1,
-														DirectFunctionCall1(int2_numeric, y0),
-														DirectFunctionCall1(int2_numeric, y1)));
+			interpolate_numeric_cache(column, state, x0, x1, y0, y1, int2_numeric);
+			*value = DirectFunctionCall1(numeric_int2, interpolate_numeric(column, x));
 			break;
 		case INT4OID:
-			*value =
-				DirectFunctionCall1(numeric_int4,
-									interpolate_numeric(x,
-														x0,
-														x1,
-														DirectFunctionCall1(int4_numeric, y0),
-														DirectFunctionCall1(int4_numeric, y1)));
+			interpolate_numeric_cache(column, state, x0, x1, y0, y1, int4_numeric);
+			*value = DirectFunctionCall1(numeric_int4, interpolate_numeric(column, x));
 			break;
 		case INT8OID:
-			*value =
-				DirectFunctionCall1(numeric_int8,
-									interpolate_numeric(x,
-														x0,
-														x1,
-														DirectFunctionCall1(int8_numeric, y0),
-														DirectFunctionCall1(int8_numeric, y1)));
+			interpolate_numeric_cache(column, state, x0, x1, y0, y1, int8_numeric);
+			*value = DirectFunctionCall1(numeric_int8, interpolate_numeric(column, x));
 			break;
 		case FLOAT4OID:
 			/* Shortcircuit calculation when y0 == y1 for float because otherwise
@@ -21,6 +21,21 @@ typedef struct GapFillInterpolateColumnState
 	Expr *lookup_after;
 	GapFillInterpolateSample prev;
 	GapFillInterpolateSample next;
+
+	/*
+	 * Cached numeric operands for integer interpolation. The conversions of
+	 * the segment endpoints and the denominator only depend on prev/next, so
+	 * they are computed once per gap segment instead of for every generated
+	 * row.
+	 */
+	bool cache_valid;
+	int64 cache_x0;
+	int64 cache_x1;
+	Datum num_x0;
+	Datum num_x1;
+	Datum num_y0;
+	Datum num_y1;
+	Datum num_denom;
 } GapFillInterpolateColumnState;
 
 void gapfill_interpolate_initialize(GapFillInterpolateColumnState *, GapFillState *, FuncExpr *);
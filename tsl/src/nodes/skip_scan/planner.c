@@ -1056,7 +1056,7 @@ skip_scan_path_create(PlannerInfo *root, Path *child_path, DistinctPathInfo *dpi
 	 * (numdistinct * 2) shifts. We pick something in the middle to avoid evaluating k_i for each
 	 * key.
 	 */
-	int numkeys_multiplier = 1.0 + (num_skipkeys - 1) * 0.5;
+	double numkeys_multiplier = 1.0 + (num_skipkeys - 1) * 0.5;
 
 	/* We calculate SkipScan cost as ndistinct * startup_cost + (ndistinct/rows) * total_cost
 	 * ndistinct * startup_cost is to account for the rescans we have to do and since startup
@@ -27,6 +27,7 @@
 #include "nodes/columnar_scan/vector_quals.h"
 #include "nodes/vector_agg.h"
 #include "nodes/vector_agg/filter_word_iterator.h"
+#include "nodes/vector_agg/plain_batch.h"
 #include "nodes/vector_agg/plan.h"
 #include "nodes/vector_agg/vector_slot.h"
 
@@ -507,6 +508,21 @@ vector_agg_begin(CustomScanState *node, EState *estate, int eflags)
 	VectorAggState *vector_agg_state = (VectorAggState *) node;
 	vector_agg_state->input_ended = false;
 
+	/*
+	 * Set up the source of the decompression context that describes the input
+	 * columns. The ColumnarScan child has its own, for a plain scan of an
+	 * uncompressed chunk the plain batch reader builds a minimal one.
+	 */
+	if (ts_is_columnar_scan_plan(linitial(cscan->custom_plans)))
+	{
+		ColumnarScanState *decompress_state = (ColumnarScanState *) linitial(node->custom_ps);
+		vector_agg_state->dcontext = &decompress_state->decompress_context;
+	}
+	else
+	{
+		plain_batch_reader_create(vector_agg_state);
+	}
+
 	/*
 	 * Set up the helper structures used to evaluate stable expressions in
 	 * vectorized FILTER clauses.
@@ -582,17 +598,49 @@ vector_agg_begin(CustomScanState *node, EState *estate, int eflags)
 			Aggref *aggref = castNode(Aggref, tlentry->expr);
 
 			VectorAggFunctions *func = get_vector_aggregate(aggref->aggfnoid);
+			if (func == NULL && list_length(aggref->args) == 2)
+			{
+				/* The two-argument bookend aggregates first() and last(). */
+				Expr *cmp_argument = castNode(TargetEntry, lsecond(aggref->args))->expr;
+				func = get_vector_bookend_aggregate(aggref->aggfnoid,
+													exprType((Node *) cmp_argument));
+				def->argument2 = cmp_argument;
+			}
+			if (func == NULL && list_length(aggref->args) == 4)
+			{
+				/*
+				 * The four-argument histogram() aggregate. The planning code
+				 * has verified that the bounds and the number of buckets are
+				 * non-null constants.
+				 */
+				func = get_vector_histogram_aggregate(aggref->aggfnoid);
+				Const *min_const = castNode(Const, castNode(TargetEntry, lsecond(aggref->args))->expr);
+				Const *max_const = castNode(Const, castNode(TargetEntry, lthird(aggref->args))->expr);
+				Const *nbuckets_const =
+					castNode(Const, castNode(TargetEntry, lfourth(aggref->args))->expr);
+				def->histogram_min = DatumGetFloat8(min_const->constvalue);
+				def->histogram_max = DatumGetFloat8(max_const->constvalue);
+				def->histogram_nbuckets = DatumGetInt32(nbuckets_const->constvalue);
+			}
+			if (func == NULL && list_length(aggref->args) == 1)
+			{
+				/* The approximate_count_distinct() aggregate. */
+				Expr *argument = castNode(TargetEntry, linitial(aggref->args))->expr;
+				func = get_vector_hyperloglog_aggregate(aggref->aggfnoid,
+														exprType((Node *) argument));
+			}
 			Assert(func != NULL);
 			def->func = *func;
 
 			if (list_length(aggref->args) > 0)
 			{
-				Assert(list_length(aggref->args) == 1);
+				Assert(list_length(aggref->args) <= 2);
 
 				/* The aggregate should be a partial aggregate */
 				Assert(aggref->aggsplit == AGGSPLIT_INITIAL_SERIAL);
 
 				def->argument = castNode(TargetEntry, linitial(aggref->args))->expr;
+				def->argument_type = exprType((Node *) def->argument);
 			}
 			else
 			{
@@ -788,9 +836,7 @@ vector_agg_exec(CustomScanState *node)
 {
 	VectorAggState *vector_agg_state = (VectorAggState *) node;
 
-	ColumnarScanState *decompress_state =
-		(ColumnarScanState *) linitial(vector_agg_state->custom.custom_ps);
-	DecompressContext *dcontext = &decompress_state->decompress_context;
+	DecompressContext *dcontext = vector_agg_state->dcontext;
 
 	ExprContext *econtext = node->ss.ps.ps_ExprContext;
 	ResetExprContext(econtext);
@@ -887,6 +933,9 @@ vector_agg_exec(CustomScanState *node)
 		 * Finally, pass the compressed batch to the grouping policy.
 		 */
 		grouping->gp_add_batch(grouping, dcontext, slot);
+
+		vector_agg_state->batches_aggregated++;
+		vector_agg_state->rows_aggregated += ((DecompressBatchState *) slot)->total_batch_rows;
 	}
 
 	/*
@@ -927,6 +976,12 @@ vector_agg_explain(CustomScanState *node, List *ancestors, ExplainState *es)
 	if (es->verbose || es->format != EXPLAIN_FORMAT_TEXT)
 	{
 		ExplainPropertyText("Grouping Policy", state->grouping->gp_explain(state->grouping), es);
+
+		if (es->analyze)
+		{
+			ExplainPropertyInteger("Batches Aggregated", NULL, state->batches_aggregated, es);
+			ExplainPropertyInteger("Rows Aggregated", NULL, state->rows_aggregated, es);
+		}
 	}
 }
 
@@ -943,7 +998,6 @@ Node *
 vector_agg_state_create(CustomScan *cscan)
 {
 	VectorAggState *state = (VectorAggState *) newNode(sizeof(VectorAggState), T_CustomScanState);
-	Assert(ts_is_columnar_scan_plan((Plan *) linitial(cscan->custom_plans)));
 
 	state->custom.methods = &exec_methods;
 
@@ -957,11 +1011,21 @@ vector_agg_state_create(CustomScan *cscan)
 	 * handle batch decompression and vectorized qual filtering itself, in its
 	 * own "get next slot" implementation.
 	 *
-	 * The vector qual init functions are needed to implement vectorized
-	 * aggregate function FILTER clauses for arrow tuple table slots and
-	 * compressed batches, respectively.
+	 * When the child is a plain scan of an uncompressed chunk, the heap
+	 * tuples are read from the child node through the normal executor
+	 * interface, and the plain batch reader transposes them into the same
+	 * columnar batch representation.
 	 */
-	state->get_next_slot = compressed_batch_get_next_slot;
+	Plan *childplan = linitial(cscan->custom_plans);
+	if (ts_is_columnar_scan_plan(childplan))
+	{
+		state->get_next_slot = compressed_batch_get_next_slot;
+	}
+	else
+	{
+		Assert(IsA(childplan, SeqScan));
+		state->get_next_slot = plain_batch_get_next_slot;
+	}
 
 	return (Node *) state;
 }
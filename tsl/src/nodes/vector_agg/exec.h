@@ -18,6 +18,24 @@ typedef struct VectorAggDef
 {
 	VectorAggFunctions func;
 	Expr *argument;
+
+	/*
+	 * The second argument (the comparison column) of the two-argument bookend
+	 * aggregates first() and last(), NULL for the normal aggregates.
+	 */
+	Expr *argument2;
+
+	/* The type of the first argument, used by the bookend aggregates. */
+	Oid argument_type;
+
+	/*
+	 * The constant min, max and nbuckets arguments of the four-argument
+	 * histogram() aggregate, not used by the other aggregates.
+	 */
+	double histogram_min;
+	double histogram_max;
+	int histogram_nbuckets;
+
 	int output_offset;
 	List *filter_clauses;
 
@@ -57,11 +75,32 @@ typedef struct VectorAggState
 
 	GroupingPolicy *grouping;
 
+	/*
+	 * The decompression context that describes the input columns. For a
+	 * ColumnarScan child this points into the child node, for a plain scan of
+	 * an uncompressed chunk this is the minimal context built by the plain
+	 * batch reader.
+	 */
+	DecompressContext *dcontext;
+
+	/*
+	 * The reader that batches the heap tuples of a plain uncompressed chunk
+	 * scan into the columnar representation. NULL for a ColumnarScan child.
+	 */
+	struct PlainBatchReader *plain_batch_reader;
+
 	/*
 	 * Function for getting the next slot from the child node depending on
 	 * child node type.
 	 */
 	TupleTableSlot *(*get_next_slot)(struct VectorAggState *vector_agg_state);
+
+	/*
+	 * Counters for EXPLAIN (ANALYZE, VERBOSE). The rows include the rows
+	 * that were later excluded by the batch filter or a FILTER clause.
+	 */
+	int64 batches_aggregated;
+	int64 rows_aggregated;
 } VectorAggState;
 
 extern Node *vector_agg_state_create(CustomScan *cscan);
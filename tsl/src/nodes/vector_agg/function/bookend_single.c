@@ -0,0 +1,116 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+#ifdef GENERATE_DISPATCH_TABLE
+extern VectorAggFunctions FUNCTION_NAME(argdef);
+case PG_TYPE_OID:
+	return &FUNCTION_NAME(argdef);
+#else
+
+/*
+ * Add a compressed batch to a bookend aggregate state. First find the winning
+ * row of the batch by the comparison column, then check if it beats the winner
+ * accumulated so far. Rows are processed in the storage order, and the
+ * comparison is strict, so on ties the first row wins, same as in the
+ * row-by-row implementation.
+ */
+static void
+FUNCTION_NAME(bookend_vector)(void *restrict agg_state, Oid value_type,
+							  const CompressedColumnValues *value,
+							  const CompressedColumnValues *cmp, const uint64 *filter, int n_rows,
+							  MemoryContext agg_extra_mctx)
+{
+	BookendState *state = (BookendState *) agg_state;
+
+	int candidate_row = -1;
+	CTYPE candidate_cmp = 0;
+	if (cmp->decompression_type == DT_Scalar)
+	{
+		if (DatumGetBool(PointerGetDatum(cmp->buffers[0])))
+		{
+			/* A null comparison value can never become the bookend. */
+			return;
+		}
+
+		/*
+		 * All rows have the same comparison value, so the first row that
+		 * passes the filter wins.
+		 */
+		candidate_cmp = DATUM_TO_CTYPE(PointerGetDatum(cmp->buffers[1]));
+		for (int row = 0; row < n_rows; row++)
+		{
+			if (arrow_row_is_valid(filter, row))
+			{
+				candidate_row = row;
+				break;
+			}
+		}
+	}
+	else
+	{
+		const CTYPE *restrict cmp_values = cmp->buffers[1];
+		for (int row = 0; row < n_rows; row++)
+		{
+			if (!arrow_row_is_valid(filter, row))
+			{
+				continue;
+			}
+
+			const CTYPE new_value = cmp_values[row];
+			if (candidate_row < 0 || PREDICATE(candidate_cmp, new_value))
+			{
+				candidate_row = row;
+				candidate_cmp = new_value;
+			}
+		}
+	}
+
+	if (candidate_row < 0)
+	{
+		/* No rows of this batch pass the filter. */
+		return;
+	}
+
+	if (!state->empty && !PREDICATE(DATUM_TO_CTYPE(state->cmp), candidate_cmp))
+	{
+		return;
+	}
+
+	if (state->empty)
+	{
+		state->value_type = value_type;
+		state->cmp_type = PG_TYPE_OID;
+		get_typlenbyval(value_type, &state->value_typlen, &state->value_typbyval);
+	}
+
+	state->value = bookend_fetch_value(value,
+									   state->value_typlen,
+									   state->value_typbyval,
+									   candidate_row,
+									   &state->value_isnull,
+									   agg_extra_mctx);
+
+	/* Note that int64 and float8 Datums are by-reference on 32-bit systems. */
+	MemoryContext old = MemoryContextSwitchTo(agg_extra_mctx);
+	state->cmp = CTYPE_TO_DATUM(candidate_cmp);
+	MemoryContextSwitchTo(old);
+
+	state->empty = false;
+}
+
+VectorAggFunctions FUNCTION_NAME(argdef) = {
+	.state_bytes = sizeof(BookendState),
+	.agg_init = bookend_init,
+	.agg_emit = bookend_emit,
+	.agg_bookend_vector = FUNCTION_NAME(bookend_vector),
+};
+#endif
+
+#undef PG_TYPE
+#undef PG_TYPE_OID
+#undef CTYPE
+#undef DATUM_TO_CTYPE
+#undef CTYPE_TO_DATUM
@@ -0,0 +1,269 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the bookend aggregates first() and last().
+ * The row-by-row implementation lives in src/agg_bookend.c. We are specialized
+ * by the type of the comparison column, which must be a fixed-width by-value
+ * arithmetic type, while the value column is handled generically and can be of
+ * any type that has a columnar representation.
+ */
+
+#include <postgres.h>
+
+#include <access/htup_details.h>
+#include <catalog/pg_type.h>
+#include <libpq/pqformat.h>
+#include <utils/date.h>
+#include <utils/datum.h>
+#include <utils/lsyscache.h>
+#include <utils/syscache.h>
+#include <utils/timestamp.h>
+
+#include "functions.h"
+#include "template_helper.h"
+
+#include "func_cache.h"
+#include "nodes/columnar_scan/compressed_batch.h"
+#include <compression/arrow_c_data_interface.h>
+
+/*
+ * The common state for all bookend aggregates: the winning row seen so far.
+ * The value datum is copied into the extra aggregate data memory context. The
+ * type information is filled in when the first winner is recorded, and is
+ * needed to serialize the partial aggregation result.
+ */
+typedef struct
+{
+	bool empty;
+	bool value_isnull;
+	Datum value;
+	Datum cmp;
+	Oid value_type;
+	Oid cmp_type;
+	int16 value_typlen;
+	bool value_typbyval;
+} BookendState;
+
+static void
+bookend_init(void *restrict agg_states, int n)
+{
+	BookendState *states = (BookendState *) agg_states;
+	for (int i = 0; i < n; i++)
+	{
+		memset(&states[i], 0, sizeof(BookendState));
+		states[i].empty = true;
+		states[i].value_isnull = true;
+	}
+}
+
+/*
+ * Serialize one polymorphic datum in the format used by
+ * ts_bookend_serializefunc(), so that the partial aggregation result we emit
+ * can be finalized by the normal ts_bookend_deserializefunc() +
+ * combine function + ts_bookend_finalfunc() chain in the parent Agg node.
+ */
+static void
+bookend_serialize_polydatum(StringInfo buf, Oid type_oid, Datum datum, bool isnull)
+{
+	/*
+	 * The type is serialized as qualified name and not as Oid, because this
+	 * state may be needed across pg_dumps.
+	 */
+	HeapTuple tup = SearchSysCache1(TYPEOID, ObjectIdGetDatum(type_oid));
+	if (!HeapTupleIsValid(tup))
+		elog(ERROR, "cache lookup failed for type %u", type_oid);
+	Form_pg_type type_tuple = (Form_pg_type) GETSTRUCT(tup);
+	pq_sendstring(buf, get_namespace_name(type_tuple->typnamespace));
+	pq_sendstring(buf, NameStr(type_tuple->typname));
+	ReleaseSysCache(tup);
+
+	if (isnull)
+	{
+		/* Emit -1 data length to signify a NULL. */
+		pq_sendint32(buf, -1);
+		return;
+	}
+
+	Oid send_func;
+	bool is_varlena;
+	getTypeBinaryOutputInfo(type_oid, &send_func, &is_varlena);
+	bytea *outputbytes = OidSendFunctionCall(send_func, datum);
+	pq_sendint32(buf, VARSIZE(outputbytes) - VARHDRSZ);
+	pq_sendbytes(buf, VARDATA(outputbytes), VARSIZE(outputbytes) - VARHDRSZ);
+}
+
+static void
+bookend_emit(void *agg_state, Datum *out_result, bool *out_isnull)
+{
+	BookendState *state = (BookendState *) agg_state;
+	if (state->empty)
+	{
+		/*
+		 * No rows were aggregated, so emit a null partial, same as the normal
+		 * aggregation path where the transition function was never called.
+		 */
+		*out_isnull = true;
+		return;
+	}
+
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	bookend_serialize_polydatum(&buf, state->value_type, state->value, state->value_isnull);
+	bookend_serialize_polydatum(&buf, state->cmp_type, state->cmp, /* isnull = */ false);
+	*out_result = PointerGetDatum(pq_endtypsend(&buf));
+	*out_isnull = false;
+}
+
+/*
+ * Fetch the value column datum at the given row, and copy it into the extra
+ * aggregate data memory context, so that it can be stored in the aggregate
+ * state across the batches.
+ */
+static Datum
+bookend_fetch_value(const CompressedColumnValues *value, int16 value_typlen, bool value_typbyval,
+					int row, bool *isnull, MemoryContext agg_extra_mctx)
+{
+	switch ((int) value->decompression_type)
+	{
+		case DT_Scalar:
+		{
+			*isnull = DatumGetBool(PointerGetDatum(value->buffers[0]));
+			if (*isnull)
+			{
+				return 0;
+			}
+
+			MemoryContext old = MemoryContextSwitchTo(agg_extra_mctx);
+			Datum result =
+				datumCopy(PointerGetDatum(value->buffers[1]), value_typbyval, value_typlen);
+			MemoryContextSwitchTo(old);
+			return result;
+		}
+		case DT_ArrowBits:
+		{
+			*isnull = !arrow_row_is_valid(value->buffers[0], row);
+			return BoolGetDatum(arrow_row_is_valid(value->buffers[1], row));
+		}
+		case DT_ArrowText:
+		case DT_ArrowTextDict:
+		{
+			*isnull = !arrow_row_is_valid(value->buffers[0], row);
+			if (*isnull)
+			{
+				return 0;
+			}
+
+			const int data_row = value->decompression_type == DT_ArrowTextDict ?
+									 ((int16 *) value->buffers[3])[row] :
+									 row;
+			const uint32 start = ((uint32 *) value->buffers[1])[data_row];
+			const int32 value_bytes = ((uint32 *) value->buffers[1])[data_row + 1] - start;
+			Assert(value_bytes >= 0);
+
+			text *result = MemoryContextAlloc(agg_extra_mctx, VARHDRSZ + value_bytes);
+			SET_VARSIZE(result, VARHDRSZ + value_bytes);
+			memcpy(VARDATA(result), &((uint8 *) value->buffers[2])[start], value_bytes);
+			return PointerGetDatum(result);
+		}
+#ifndef USE_FLOAT8_BYVAL
+		case 8:
+#endif
+		case 16:
+		{
+			/* Fixed-width by-reference type that doesn't fit into a Datum. */
+			*isnull = !arrow_row_is_valid(value->buffers[0], row);
+			if (*isnull)
+			{
+				return 0;
+			}
+
+			const char *src = value->buffers[1];
+			MemoryContext old = MemoryContextSwitchTo(agg_extra_mctx);
+			Datum result =
+				datumCopy(PointerGetDatum(&src[(int) value->decompression_type * row]),
+						  /* typByVal = */ false,
+						  value->decompression_type);
+			MemoryContextSwitchTo(old);
+			return result;
+		}
+		default:
+		{
+			/*
+			 * Fixed-width by-value type that fits into a Datum. The conversion
+			 * of Datum to more narrow types will truncate the higher bytes, so
+			 * we don't care if we read some garbage into them, and can always
+			 * read 8 bytes. These are unaligned reads, so technically we have
+			 * to do memcpy.
+			 */
+			Assert(value->decompression_type > 0);
+			Assert(value->decompression_type <= SIZEOF_DATUM);
+			*isnull = !arrow_row_is_valid(value->buffers[0], row);
+			if (*isnull)
+			{
+				return 0;
+			}
+
+			const char *src = value->buffers[1];
+			Datum result = 0;
+			memcpy(&result, &src[(int) value->decompression_type * row], SIZEOF_DATUM);
+			return result;
+		}
+	}
+}
+
+/*
+ * Templated parts for first() and last(). The comparison is strict, same as
+ * the "<" and ">" operators used by the row-by-row transition function, which
+ * also gives the same treatment of the float NaNs.
+ */
+#define AGG_NAME FIRST
+#define PREDICATE(CURRENT, NEW) ((NEW) < (CURRENT))
+#include "bookend_types.c"
+
+#define AGG_NAME LAST
+#define PREDICATE(CURRENT, NEW) ((NEW) > (CURRENT))
+#include "bookend_types.c"
+
+/*
+ * Return the vectorized bookend aggregate definition matching the given
+ * aggregate function Oid and the type of the comparison column, or NULL if we
+ * don't have one. Unlike the normal aggregates, the bookend aggregates belong
+ * to the extension, so they are matched by the cached runtime Oids and not by
+ * the compile-time Oid constants.
+ */
+VectorAggFunctions *
+get_vector_bookend_aggregate(Oid aggfnoid, Oid cmp_type)
+{
+	if (!OidIsValid(ts_first_func_oid) || !OidIsValid(ts_last_func_oid))
+		ts_func_cache_init();
+
+	if (aggfnoid == ts_first_func_oid)
+	{
+		switch (cmp_type)
+		{
+#define GENERATE_DISPATCH_TABLE 1
+#define AGG_NAME FIRST
+#include "bookend_types.c"
+			default:
+				return NULL;
+		}
+	}
+
+	if (aggfnoid == ts_last_func_oid)
+	{
+		switch (cmp_type)
+		{
+#define AGG_NAME LAST
+#include "bookend_types.c"
+#undef GENERATE_DISPATCH_TABLE
+			default:
+				return NULL;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,64 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+#define PG_TYPE INT2
+#define PG_TYPE_OID INT2OID
+#define CTYPE int16
+#define DATUM_TO_CTYPE DatumGetInt16
+#define CTYPE_TO_DATUM Int16GetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE INT4
+#define PG_TYPE_OID INT4OID
+#define CTYPE int32
+#define DATUM_TO_CTYPE DatumGetInt32
+#define CTYPE_TO_DATUM Int32GetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE INT8
+#define PG_TYPE_OID INT8OID
+#define CTYPE int64
+#define DATUM_TO_CTYPE DatumGetInt64
+#define CTYPE_TO_DATUM Int64GetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE FLOAT4
+#define PG_TYPE_OID FLOAT4OID
+#define CTYPE float
+#define DATUM_TO_CTYPE DatumGetFloat4
+#define CTYPE_TO_DATUM Float4GetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE FLOAT8
+#define PG_TYPE_OID FLOAT8OID
+#define CTYPE double
+#define DATUM_TO_CTYPE DatumGetFloat8
+#define CTYPE_TO_DATUM Float8GetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE TIMESTAMP
+#define PG_TYPE_OID TIMESTAMPOID
+#define CTYPE Timestamp
+#define DATUM_TO_CTYPE DatumGetTimestamp
+#define CTYPE_TO_DATUM TimestampGetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE TIMESTAMPTZ
+#define PG_TYPE_OID TIMESTAMPTZOID
+#define CTYPE TimestampTz
+#define DATUM_TO_CTYPE DatumGetTimestampTz
+#define CTYPE_TO_DATUM TimestampTzGetDatum
+#include "bookend_single.c"
+
+#define PG_TYPE DATE
+#define PG_TYPE_OID DATEOID
+#define CTYPE DateADT
+#define DATUM_TO_CTYPE DatumGetDateADT
+#define CTYPE_TO_DATUM DateADTGetDatum
+#include "bookend_single.c"
+
+#undef PREDICATE
+#undef AGG_NAME
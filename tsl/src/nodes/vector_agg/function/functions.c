@@ -206,6 +206,11 @@ get_vector_aggregate(Oid aggfnoid)
 			return &count_star_agg;
 		case F_COUNT_ANY:
 			return &count_any_agg;
+#ifdef HAVE_INT128
+		case F_SUM_NUMERIC:
+		case F_AVG_NUMERIC:
+			return &numeric_accum_agg;
+#endif
 #define GENERATE_DISPATCH_TABLE 1
 #include "float48_accum_templates.c"
 #include "int128_accum_templates.c"
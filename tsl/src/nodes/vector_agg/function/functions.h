@@ -8,6 +8,8 @@
 
 #include <compression/arrow_c_data_interface.h>
 
+struct CompressedColumnValues;
+
 /*
  * Function table for a vectorized implementation of an aggregate function.
  *
@@ -53,8 +55,61 @@ typedef struct
 							int start_row, int end_row, Datum constvalue, bool constisnull,
 							MemoryContext agg_extra_mctx);
 
+	/*
+	 * Aggregate a compressed batch for the two-argument bookend aggregates
+	 * first() and last(). The arguments are given as CompressedColumnValues
+	 * because either of them can turn out to be a scalar at run time, e.g.
+	 * for a batch where the column has a default value. The filter must
+	 * already include the validity of the comparison column, but not of the
+	 * value column, because a row with a null value can still be the bookend.
+	 * Only used by the per-batch grouping policy, NULL for the normal
+	 * one-argument aggregates.
+	 */
+	void (*agg_bookend_vector)(void *restrict agg_state, Oid value_type,
+							   const struct CompressedColumnValues *value,
+							   const struct CompressedColumnValues *cmp, const uint64 *filter,
+							   int n_rows, MemoryContext agg_extra_mctx);
+
+	/*
+	 * Aggregate a compressed batch for the four-argument histogram()
+	 * aggregate. The bucket bounds and the number of buckets are its constant
+	 * arguments. The filter must not include the validity of the value
+	 * column, because the row-by-row transition function is not strict and
+	 * counts the null values as zeros. Only used by the per-batch grouping
+	 * policy, NULL for the normal one-argument aggregates.
+	 */
+	void (*agg_histogram_vector)(void *restrict agg_state,
+								 const struct CompressedColumnValues *value, double min, double max,
+								 int nbuckets, const uint64 *filter, int n_rows,
+								 MemoryContext agg_extra_mctx);
+
 	/* Emit a partial aggregation result. */
 	void (*agg_emit)(void *restrict agg_state, Datum *out_result, bool *out_isnull);
 } VectorAggFunctions;
 
 VectorAggFunctions *get_vector_aggregate(Oid aggfnoid);
+
+#ifdef HAVE_INT128
+/*
+ * The vectorized implementation of the numeric_avg_accum() transition
+ * function shared by sum(numeric) and avg(numeric), see numeric_accum.c.
+ */
+extern VectorAggFunctions numeric_accum_agg;
+#endif
+
+/*
+ * Look up the vectorized implementation for the bookend aggregates first()
+ * and last(), specialized by the type of the comparison column.
+ */
+VectorAggFunctions *get_vector_bookend_aggregate(Oid aggfnoid, Oid cmp_type);
+
+/*
+ * Look up the vectorized implementation for the histogram() aggregate.
+ */
+VectorAggFunctions *get_vector_histogram_aggregate(Oid aggfnoid);
+
+/*
+ * Look up the vectorized implementation for the approximate_count_distinct()
+ * aggregate, specialized by the type of the value column.
+ */
+VectorAggFunctions *get_vector_hyperloglog_aggregate(Oid aggfnoid, Oid value_type);
@@ -0,0 +1,247 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the histogram() aggregate. The row-by-row
+ * implementation lives in src/histogram.c. The bucket bounds and the number
+ * of buckets are constant arguments, so the bucketing formula of
+ * width_bucket_float8() is inlined here and the per-batch work reduces to a
+ * simple counting loop. The partial aggregation result is emitted in the
+ * format of ts_hist_serializefunc(), so that it can be finalized by the
+ * normal deserialize + combine + final function chain in the parent Agg node.
+ */
+
+#include <postgres.h>
+
+#include <libpq/pqformat.h>
+#include <utils/float.h>
+
+#include "functions.h"
+
+#include "debug_assert.h"
+#include "func_cache.h"
+#include "nodes/columnar_scan/compressed_batch.h"
+#include <compression/arrow_c_data_interface.h>
+
+/*
+ * The counts are kept as 64-bit so that the hot loop doesn't have to check
+ * for overflow, the serialized format uses int32 so the check is performed
+ * when the partial result is emitted. The bucket array is allocated in the
+ * extra aggregate data memory context when the first row is aggregated, same
+ * as the row-by-row transition function that allocates its state lazily.
+ */
+typedef struct
+{
+	int32 nbuckets;
+	double min;
+	double max;
+	uint64 *counts;
+} VectorHistogramState;
+
+static void
+vector_histogram_init(void *restrict agg_states, int n)
+{
+	VectorHistogramState *states = (VectorHistogramState *) agg_states;
+	for (int i = 0; i < n; i++)
+	{
+		memset(&states[i], 0, sizeof(VectorHistogramState));
+	}
+}
+
+static void
+vector_histogram_emit(void *agg_state, Datum *out_result, bool *out_isnull)
+{
+	VectorHistogramState *state = (VectorHistogramState *) agg_state;
+	if (state->counts == NULL)
+	{
+		/*
+		 * No rows were aggregated, so emit a null partial, same as the normal
+		 * aggregation path where the transition function was never called.
+		 */
+		*out_isnull = true;
+		return;
+	}
+
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, state->nbuckets);
+	for (int32 i = 0; i < state->nbuckets; i++)
+	{
+		/*
+		 * The serialized format and the final result use int32 counts, so we
+		 * have to fail on overflow, same as the row-by-row transition
+		 * function.
+		 */
+		if (state->counts[i] >= PG_INT32_MAX)
+		{
+			elog(ERROR, "overflow in histogram");
+		}
+		pq_sendint32(&buf, (int32) state->counts[i]);
+	}
+	*out_result = PointerGetDatum(pq_endtypsend(&buf));
+	*out_isnull = false;
+}
+
+/*
+ * Allocate the bucket array when the first row is aggregated, validating the
+ * constant arguments in the same way and with the same errors as the
+ * combination of ts_hist_sfunc() and width_bucket_float8() in the row-by-row
+ * aggregation.
+ */
+static void
+vector_histogram_alloc_buckets(VectorHistogramState *state, double min, double max, int nbuckets,
+							   MemoryContext agg_extra_mctx)
+{
+	if (min > max)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("lower bound cannot exceed upper bound")));
+	}
+
+	if (nbuckets <= 0)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_ARGUMENT_FOR_WIDTH_BUCKET_FUNCTION),
+				 errmsg("count must be greater than zero")));
+	}
+
+	if (isnan(min) || isnan(max))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_ARGUMENT_FOR_WIDTH_BUCKET_FUNCTION),
+				 errmsg("operand, lower bound, and upper bound cannot be NaN")));
+	}
+
+	if (isinf(min) || isinf(max))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_ARGUMENT_FOR_WIDTH_BUCKET_FUNCTION),
+				 errmsg("lower and upper bounds must be finite")));
+	}
+
+	if (min == max)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_ARGUMENT_FOR_WIDTH_BUCKET_FUNCTION),
+				 errmsg("lower bound cannot equal upper bound")));
+	}
+
+	state->min = min;
+	state->max = max;
+	/* Two extra buckets for the values below min and above max. */
+	state->nbuckets = nbuckets + 2;
+	state->counts =
+		MemoryContextAllocZero(agg_extra_mctx, sizeof(*state->counts) * state->nbuckets);
+}
+
+/*
+ * The bucketing formula of width_bucket_float8() for the ascending bounds,
+ * after the argument checks have been performed.
+ */
+static inline int32
+vector_histogram_bucket(double value, double min, double max, int32 nbuckets)
+{
+	if (unlikely(isnan(value)))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_ARGUMENT_FOR_WIDTH_BUCKET_FUNCTION),
+				 errmsg("operand, lower bound, and upper bound cannot be NaN")));
+	}
+
+	if (value < min)
+	{
+		return 0;
+	}
+
+	if (value >= max)
+	{
+		return nbuckets + 1;
+	}
+
+	return (int32) (((double) nbuckets) * (value - min) / (max - min)) + 1;
+}
+
+static void
+vector_histogram_vector(void *restrict agg_state, const CompressedColumnValues *value, double min,
+						double max, int nbuckets, const uint64 *filter, int n_rows,
+						MemoryContext agg_extra_mctx)
+{
+	VectorHistogramState *state = (VectorHistogramState *) agg_state;
+
+	const int n = arrow_num_valid(filter, n_rows);
+	if (n == 0)
+	{
+		return;
+	}
+
+	if (state->counts == NULL)
+	{
+		vector_histogram_alloc_buckets(state, min, max, nbuckets, agg_extra_mctx);
+	}
+	Assert(state->nbuckets == nbuckets + 2);
+
+	if (value->decompression_type == DT_Scalar)
+	{
+		/*
+		 * The value is a scalar, e.g. for a batch where the column has a
+		 * default value, so all the rows that pass the filter go into the
+		 * same bucket.
+		 */
+		const bool isnull = DatumGetBool(PointerGetDatum(value->buffers[0]));
+		const double v = isnull ? 0.0 : DatumGetFloat8(PointerGetDatum(value->buffers[1]));
+		state->counts[vector_histogram_bucket(v, min, max, nbuckets)] += n;
+		return;
+	}
+
+	Ensure(value->decompression_type == sizeof(double), "expected a decompressed float8 column");
+	const uint64 *validity = (const uint64 *) value->buffers[0];
+	const double *values = (const double *) value->buffers[1];
+	for (int row = 0; row < n_rows; row++)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
+			continue;
+		}
+
+		/*
+		 * The row-by-row transition function ts_hist_sfunc() is not strict,
+		 * and reads a null value argument as a zero datum, so we have to
+		 * count the null values as zeros as well to get the same result.
+		 */
+		const double v = arrow_row_is_valid(validity, row) ? values[row] : 0.0;
+		state->counts[vector_histogram_bucket(v, min, max, nbuckets)]++;
+	}
+}
+
+static VectorAggFunctions histogram_agg_functions = {
+	.state_bytes = sizeof(VectorHistogramState),
+	.agg_init = vector_histogram_init,
+	.agg_histogram_vector = vector_histogram_vector,
+	.agg_emit = vector_histogram_emit,
+};
+
+/*
+ * Return the vectorized histogram aggregate definition if the given aggregate
+ * function Oid belongs to histogram(), or NULL otherwise. Same as the bookend
+ * aggregates, histogram() belongs to the extension, so it is matched by the
+ * cached runtime Oid and not by a compile-time Oid constant.
+ */
+VectorAggFunctions *
+get_vector_histogram_aggregate(Oid aggfnoid)
+{
+	if (!OidIsValid(ts_histogram_func_oid))
+	{
+		ts_func_cache_init();
+	}
+
+	if (aggfnoid == ts_histogram_func_oid)
+	{
+		return &histogram_agg_functions;
+	}
+
+	return NULL;
+}
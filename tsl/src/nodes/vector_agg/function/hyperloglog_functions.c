@@ -0,0 +1,212 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the approximate_count_distinct() aggregate.
+ * The row-by-row implementation lives in src/hyperloglog.c. We are
+ * specialized by the width of the value column, and hash the same canonical
+ * binary representation of the values as the row-by-row transition function,
+ * so that the partial aggregation results can be merged. The partial result
+ * is emitted in the format of ts_hyperloglog_serializefunc() and finalized by
+ * the normal deserialize + combine + final function chain in the parent Agg
+ * node.
+ */
+
+#include <postgres.h>
+
+#include <catalog/pg_type.h>
+#include <common/hashfn.h>
+#include <libpq/pqformat.h>
+
+#include "functions.h"
+
+#include "func_cache.h"
+#include "hyperloglog.h"
+#include <compression/arrow_c_data_interface.h>
+
+typedef struct
+{
+	bool empty;
+	uint8 registers[TS_HLL_NREGISTERS];
+} VectorHyperLogLogState;
+
+static void
+vector_hyperloglog_init(void *restrict agg_states, int n)
+{
+	VectorHyperLogLogState *states = (VectorHyperLogLogState *) agg_states;
+	for (int i = 0; i < n; i++)
+	{
+		memset(&states[i], 0, sizeof(VectorHyperLogLogState));
+		states[i].empty = true;
+	}
+}
+
+static void
+vector_hyperloglog_emit(void *agg_state, Datum *out_result, bool *out_isnull)
+{
+	VectorHyperLogLogState *state = (VectorHyperLogLogState *) agg_state;
+	if (state->empty)
+	{
+		/*
+		 * No rows were aggregated, so emit a null partial, same as the normal
+		 * aggregation path where the transition function was never called.
+		 */
+		*out_isnull = true;
+		return;
+	}
+
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	pq_sendint32(&buf, TS_HLL_NREGISTERS);
+	pq_sendbytes(&buf, (const char *) state->registers, TS_HLL_NREGISTERS);
+	*out_result = PointerGetDatum(pq_endtypsend(&buf));
+	*out_isnull = false;
+}
+
+/*
+ * The combined validity bitmap we get from the caller includes the validity
+ * of the value column, so the null values are not counted, same as in the
+ * row-by-row transition function.
+ */
+static pg_attribute_always_inline void
+vector_hyperloglog_vector_impl(void *restrict agg_state, const ArrowArray *vector,
+							   const uint64 *filter, int width)
+{
+	VectorHyperLogLogState *state = (VectorHyperLogLogState *) agg_state;
+	const uint8 *values = vector->buffers[1];
+	const int n = vector->length;
+	for (int row = 0; row < n; row++)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
+			continue;
+		}
+
+		state->empty = false;
+		ts_hyperloglog_insert(state->registers,
+							  hash_bytes_extended(&values[width * row], width, /* seed = */ 0));
+	}
+}
+
+static pg_attribute_always_inline void
+vector_hyperloglog_scalar_impl(void *restrict agg_state, Datum constvalue, bool constisnull,
+							   int width)
+{
+	VectorHyperLogLogState *state = (VectorHyperLogLogState *) agg_state;
+	if (constisnull)
+	{
+		return;
+	}
+
+	/*
+	 * The same scalar value repeated for n rows counts as one distinct value,
+	 * so it is inserted into the sketch only once.
+	 */
+	char tmp[16];
+	switch (width)
+	{
+		case 2:
+		{
+			const int16 value = DatumGetInt16(constvalue);
+			memcpy(tmp, &value, 2);
+			break;
+		}
+		case 4:
+		{
+			const int32 value = DatumGetInt32(constvalue);
+			memcpy(tmp, &value, 4);
+			break;
+		}
+		case 8:
+		{
+			const int64 value = DatumGetInt64(constvalue);
+			memcpy(tmp, &value, 8);
+			break;
+		}
+		case 16:
+			memcpy(tmp, DatumGetPointer(constvalue), 16);
+			break;
+		default:
+			pg_unreachable();
+	}
+
+	state->empty = false;
+	ts_hyperloglog_insert(state->registers,
+						  hash_bytes_extended((const unsigned char *) tmp, width, /* seed = */ 0));
+}
+
+#define GENERATE_WIDTH_FUNCTIONS(WIDTH)                                                            \
+	static void vector_hyperloglog_vector_##WIDTH(void *restrict agg_state,                        \
+												  const ArrowArray *vector, const uint64 *filter, \
+												  MemoryContext agg_extra_mctx)                    \
+	{                                                                                              \
+		vector_hyperloglog_vector_impl(agg_state, vector, filter, WIDTH);                          \
+	}                                                                                              \
+                                                                                                   \
+	static void vector_hyperloglog_scalar_##WIDTH(void *restrict agg_state, Datum constvalue,      \
+												  bool constisnull, int n,                         \
+												  MemoryContext agg_extra_mctx)                    \
+	{                                                                                              \
+		vector_hyperloglog_scalar_impl(agg_state, constvalue, constisnull, WIDTH);                 \
+	}                                                                                              \
+                                                                                                   \
+	static VectorAggFunctions hyperloglog_agg_functions_##WIDTH = {                                \
+		.state_bytes = sizeof(VectorHyperLogLogState),                                             \
+		.agg_init = vector_hyperloglog_init,                                                       \
+		.agg_vector = vector_hyperloglog_vector_##WIDTH,                                           \
+		.agg_scalar = vector_hyperloglog_scalar_##WIDTH,                                           \
+		.agg_emit = vector_hyperloglog_emit,                                                       \
+	};
+
+GENERATE_WIDTH_FUNCTIONS(2)
+GENERATE_WIDTH_FUNCTIONS(4)
+GENERATE_WIDTH_FUNCTIONS(8)
+GENERATE_WIDTH_FUNCTIONS(16)
+
+#undef GENERATE_WIDTH_FUNCTIONS
+
+/*
+ * Return the vectorized approximate_count_distinct() aggregate definition
+ * matching the given aggregate function Oid and value column type, or NULL if
+ * we don't have one. The supported types are the fixed-width ones where the
+ * decompressed columnar representation matches the canonical binary
+ * representation hashed by the row-by-row transition function. Same as the
+ * bookend aggregates, the aggregate belongs to the extension, so it is
+ * matched by the cached runtime Oid and not by a compile-time Oid constant.
+ */
+VectorAggFunctions *
+get_vector_hyperloglog_aggregate(Oid aggfnoid, Oid value_type)
+{
+	if (!OidIsValid(ts_approx_count_distinct_func_oid))
+	{
+		ts_func_cache_init();
+	}
+
+	if (aggfnoid != ts_approx_count_distinct_func_oid)
+	{
+		return NULL;
+	}
+
+	switch (value_type)
+	{
+		case INT2OID:
+			return &hyperloglog_agg_functions_2;
+		case INT4OID:
+		case FLOAT4OID:
+		case DATEOID:
+			return &hyperloglog_agg_functions_4;
+		case INT8OID:
+		case FLOAT8OID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			return &hyperloglog_agg_functions_8;
+		case UUIDOID:
+		case INTERVALOID:
+			return &hyperloglog_agg_functions_16;
+		default:
+			return NULL;
+	}
+}
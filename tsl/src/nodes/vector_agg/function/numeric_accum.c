@@ -0,0 +1,651 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Vectorized implementation of the numeric_avg_accum() transition function
+ * that is shared by sum(numeric) and avg(numeric).
+ *
+ * The numeric columns are bulk-decompressed into the arrow varlena format,
+ * so each row is the on-disk numeric representation without the varlena
+ * header. We parse this representation directly and accumulate the values
+ * that fit as integers scaled by a power of ten into an int128 sum, which
+ * covers the typical short-precision numerics found e.g. in billing tables.
+ * The values that don't fit, and the accumulator itself when it approaches
+ * the int128 range, spill into an exact numeric sum that is maintained with
+ * the normal numeric addition, so the result is always exact.
+ *
+ * The partial is emitted in the format of numeric_avg_serialize() and
+ * finalized by the normal deserialize + combine + final function chain in
+ * the parent Agg node.
+ */
+
+#include <postgres.h>
+
+#include <libpq/pqformat.h>
+#include <utils/datum.h>
+#include <utils/fmgrprotos.h>
+#include <utils/numeric.h>
+
+#include "functions.h"
+
+#include <compression/arrow_c_data_interface.h>
+
+#ifdef HAVE_INT128
+
+/*
+ * The on-disk representation of the numeric data type. Copied from numeric.c
+ * where it is private, same as the aggregation state structs in the other
+ * vectorized aggregate implementations.
+ */
+typedef int16 NumericDigit;
+
+struct NumericShort
+{
+	uint16 n_header;							/* Sign + display scale + weight */
+	NumericDigit n_data[FLEXIBLE_ARRAY_MEMBER]; /* Digits */
+};
+
+struct NumericLong
+{
+	uint16 n_sign_dscale;						/* Sign + display scale */
+	int16 n_weight;								/* Weight of 1st digit */
+	NumericDigit n_data[FLEXIBLE_ARRAY_MEMBER]; /* Digits */
+};
+
+union NumericChoice
+{
+	uint16 n_header;			 /* Header word */
+	struct NumericLong n_long;	 /* Long form (4-byte header) */
+	struct NumericShort n_short; /* Short form (2-byte header) */
+};
+
+struct NumericData
+{
+	int32 vl_len_;				/* varlena header (do not touch directly!) */
+	union NumericChoice choice; /* choice of format */
+};
+
+#define NBASE 10000
+#define DEC_DIGITS 4
+
+#define NUMERIC_SIGN_MASK 0xC000
+#define NUMERIC_POS 0x0000
+#define NUMERIC_NEG 0x4000
+#define NUMERIC_SHORT 0x8000
+#define NUMERIC_SPECIAL 0xC000
+
+#define NUMERIC_NAN 0xC000
+#define NUMERIC_PINF 0xD000
+#define NUMERIC_NINF 0xF000
+
+#define NUMERIC_SHORT_SIGN_MASK 0x2000
+#define NUMERIC_SHORT_DSCALE_MASK 0x1F80
+#define NUMERIC_SHORT_DSCALE_SHIFT 7
+#define NUMERIC_SHORT_WEIGHT_SIGN_MASK 0x0040
+#define NUMERIC_SHORT_WEIGHT_MASK 0x003F
+
+#define NUMERIC_DSCALE_MASK 0x3FFF
+
+#define NUMERIC_HDRSZ (VARHDRSZ + sizeof(uint16) + sizeof(int16))
+
+#define NUMERIC_HEADER_IS_SHORT(n) (((n)->choice.n_header & 0x8000) != 0)
+#define NUMERIC_HEADER_SIZE(n)                                                                     \
+	(VARHDRSZ + sizeof(uint16) + (NUMERIC_HEADER_IS_SHORT(n) ? 0 : sizeof(int16)))
+
+#define NUMERIC_DIGITS(num)                                                                        \
+	(NUMERIC_HEADER_IS_SHORT(num) ? (num)->choice.n_short.n_data : (num)->choice.n_long.n_data)
+#define NUMERIC_NDIGITS(num) ((VARSIZE(num) - NUMERIC_HEADER_SIZE(num)) / sizeof(NumericDigit))
+#define NUMERIC_SIGN(n)                                                                            \
+	(NUMERIC_HEADER_IS_SHORT(n) ?                                                                  \
+		 (((n)->choice.n_short.n_header & NUMERIC_SHORT_SIGN_MASK) ? NUMERIC_NEG : NUMERIC_POS) :  \
+		 ((n)->choice.n_header & NUMERIC_SIGN_MASK))
+#define NUMERIC_DSCALE(n)                                                                          \
+	(NUMERIC_HEADER_IS_SHORT(n) ? ((n)->choice.n_short.n_header & NUMERIC_SHORT_DSCALE_MASK) >>    \
+									  NUMERIC_SHORT_DSCALE_SHIFT :                                 \
+								  ((n)->choice.n_long.n_sign_dscale & NUMERIC_DSCALE_MASK))
+#define NUMERIC_WEIGHT(n)                                                                          \
+	(NUMERIC_HEADER_IS_SHORT(n) ?                                                                  \
+		 ((((n)->choice.n_short.n_header & NUMERIC_SHORT_WEIGHT_SIGN_MASK) ?                       \
+			   ~NUMERIC_SHORT_WEIGHT_MASK :                                                        \
+			   0) |                                                                                \
+		  ((n)->choice.n_short.n_header & NUMERIC_SHORT_WEIGHT_MASK)) :                            \
+		 ((n)->choice.n_long.n_weight))
+
+/*
+ * The numeric representation parsed from the headerless arrow varlena bytes.
+ * The digits pointer is potentially unaligned, so the individual digits must
+ * be read with memcpy.
+ */
+typedef struct
+{
+	uint16 header;
+	int sign; /* NUMERIC_POS or NUMERIC_NEG */
+	int weight;
+	int dscale;
+	int ndigits;
+	const uint8 *digits;
+} NumericBodyParts;
+
+static pg_attribute_always_inline void
+numeric_body_parse(const uint8 *body, int len, NumericBodyParts *parts)
+{
+	memcpy(&parts->header, body, sizeof(uint16));
+
+	if ((parts->header & NUMERIC_SIGN_MASK) == NUMERIC_SPECIAL)
+	{
+		/* NaN or infinity, no digits. */
+		parts->ndigits = 0;
+		return;
+	}
+
+	if (parts->header & NUMERIC_SHORT)
+	{
+		parts->sign = (parts->header & NUMERIC_SHORT_SIGN_MASK) ? NUMERIC_NEG : NUMERIC_POS;
+		parts->dscale =
+			(parts->header & NUMERIC_SHORT_DSCALE_MASK) >> NUMERIC_SHORT_DSCALE_SHIFT;
+		parts->weight = ((parts->header & NUMERIC_SHORT_WEIGHT_SIGN_MASK) ?
+							 ~NUMERIC_SHORT_WEIGHT_MASK :
+							 0) |
+						(parts->header & NUMERIC_SHORT_WEIGHT_MASK);
+		parts->ndigits = (len - sizeof(uint16)) / sizeof(NumericDigit);
+		parts->digits = body + sizeof(uint16);
+	}
+	else
+	{
+		int16 weight;
+		memcpy(&weight, body + sizeof(uint16), sizeof(int16));
+		parts->sign = parts->header & NUMERIC_SIGN_MASK;
+		parts->dscale = parts->header & NUMERIC_DSCALE_MASK;
+		parts->weight = weight;
+		parts->ndigits = (len - sizeof(uint16) - sizeof(int16)) / sizeof(NumericDigit);
+		parts->digits = body + sizeof(uint16) + sizeof(int16);
+	}
+}
+
+/*
+ * The int128 accumulator and the individual scaled values are kept strictly
+ * below this threshold, so that one addition can never overflow. When the
+ * accumulator exceeds it, it spills into the exact numeric sum.
+ */
+#define SCALED_SUM_LIMIT (((int128) 1) << 126)
+
+static pg_attribute_always_inline int128
+int128_power_of_10(int exp)
+{
+	int128 result = 1;
+	while (exp-- > 0)
+	{
+		result *= 10;
+	}
+	return result;
+}
+
+/*
+ * Convert a parsed finite numeric into an integer scaled by 10^dscale.
+ * Returns false if the value is too large for the int128 fast path.
+ */
+static pg_attribute_always_inline bool
+numeric_body_to_scaled_int128(const NumericBodyParts *parts, int128 *out)
+{
+	/*
+	 * Cap the display scale at the number of decimal digits of int128, so
+	 * that the accumulator scale stays small enough for the conversion back
+	 * to numeric to use fixed buffers.
+	 */
+	if (parts->dscale > 38)
+	{
+		return false;
+	}
+
+	int128 value = 0;
+	for (int i = 0; i < parts->ndigits; i++)
+	{
+		uint16 digit;
+		memcpy(&digit, &parts->digits[i * sizeof(NumericDigit)], sizeof(uint16));
+		if (value >= SCALED_SUM_LIMIT / NBASE)
+		{
+			return false;
+		}
+		value = value * NBASE + digit;
+	}
+
+	/*
+	 * The digits are a base-10000 integer equal to the value multiplied by
+	 * NBASE^(ndigits - 1 - weight), so to get the value scaled by 10^dscale
+	 * we have to shift by this many decimal digits:
+	 */
+	const int exponent = parts->dscale - DEC_DIGITS * (parts->ndigits - 1 - parts->weight);
+	if (exponent >= 0)
+	{
+		if (exponent >= 39)
+		{
+			return false;
+		}
+		const int128 multiplier = int128_power_of_10(exponent);
+		if (value >= SCALED_SUM_LIMIT / multiplier)
+		{
+			return false;
+		}
+		value *= multiplier;
+	}
+	else
+	{
+		/*
+		 * The display scale can end in the middle of the last base-10000
+		 * digit, in which case its trailing decimal digits must be zero.
+		 * Don't bet the correctness on this invariant of the storage format
+		 * and use the exact fallback if it doesn't hold.
+		 */
+		const int128 divisor = int128_power_of_10(-exponent);
+		if (value % divisor != 0)
+		{
+			return false;
+		}
+		value /= divisor;
+	}
+
+	*out = parts->sign == NUMERIC_NEG ? -value : value;
+	return true;
+}
+
+/*
+ * Build a palloc'ed numeric from an integer scaled by 10^scale.
+ */
+static Numeric
+scaled_int128_to_numeric(int128 value, int scale)
+{
+	/* Extract the decimal digits, least significant first. */
+	uint8 decimals[45];
+	int ndecimals = 0;
+	uint128 abs_value = value < 0 ? -(uint128) value : (uint128) value;
+	while (abs_value != 0)
+	{
+		decimals[ndecimals++] = abs_value % 10;
+		abs_value /= 10;
+	}
+
+	/*
+	 * Group the decimal digits into base-10000 digits, padding the fractional
+	 * part so that the group boundary falls on the decimal point. The group
+	 * index here counts from the least significant group.
+	 */
+	const int frac_groups = (scale + DEC_DIGITS - 1) / DEC_DIGITS;
+	const int pad = frac_groups * DEC_DIGITS - scale;
+	int ngroups = (ndecimals + pad + DEC_DIGITS - 1) / DEC_DIGITS;
+	NumericDigit groups[16];
+	for (int g = 0; g < ngroups; g++)
+	{
+		NumericDigit group = 0;
+		for (int d = DEC_DIGITS - 1; d >= 0; d--)
+		{
+			const int decimal = g * DEC_DIGITS + d - pad;
+			group = group * 10 +
+					((decimal >= 0 && decimal < ndecimals) ? decimals[decimal] : 0);
+		}
+		groups[g] = group;
+	}
+
+	/* Strip the zero groups at both ends, like the numeric normalization does. */
+	while (ngroups > 0 && groups[ngroups - 1] == 0)
+	{
+		ngroups--;
+	}
+	int least_significant = 0;
+	while (least_significant < ngroups && groups[least_significant] == 0)
+	{
+		least_significant++;
+	}
+	const int ndigits = ngroups - least_significant;
+	const int weight = ndigits > 0 ? ngroups - 1 - frac_groups : 0;
+
+	Numeric result = palloc(NUMERIC_HDRSZ + ndigits * sizeof(NumericDigit));
+	SET_VARSIZE(result, NUMERIC_HDRSZ + ndigits * sizeof(NumericDigit));
+	result->choice.n_long.n_sign_dscale =
+		(value < 0 ? NUMERIC_NEG : NUMERIC_POS) | (scale & NUMERIC_DSCALE_MASK);
+	result->choice.n_long.n_weight = weight;
+	for (int i = 0; i < ndigits; i++)
+	{
+		result->choice.n_long.n_data[i] = groups[ngroups - 1 - i];
+	}
+	return result;
+}
+
+/*
+ * The aggregation state. It mirrors the NumericAggState of numeric.c without
+ * the sum of squares, with the sum split into the int128 fast path and the
+ * exact numeric spill.
+ */
+typedef struct
+{
+	int64 N; /* count of processed finite numbers */
+
+	int128 sum; /* the fast-path sum, an integer scaled by 10^scale */
+	int32 scale;
+
+	int32 maxScale;		/* maximum scale seen so far */
+	int64 maxScaleCount; /* # of values seen with maximum scale */
+
+	int64 NaNcount; /* count of NaN values */
+	int64 pInfcount; /* count of +Inf values */
+	int64 nInfcount; /* count of -Inf values */
+
+	/*
+	 * Exact sum of the values that don't fit into the fast path, allocated in
+	 * the aggregate extra memory context. NULL if nothing has spilled.
+	 */
+	Numeric spilled;
+} NumericAccumState;
+
+static void
+numeric_accum_init(void *restrict agg_states, int n)
+{
+	NumericAccumState *states = (NumericAccumState *) agg_states;
+	memset(states, 0, sizeof(NumericAccumState) * n);
+}
+
+static void
+numeric_accum_add_spilled(NumericAccumState *state, Numeric value, MemoryContext agg_extra_mctx)
+{
+	MemoryContext old_context = MemoryContextSwitchTo(agg_extra_mctx);
+	Numeric old_sum = state->spilled;
+	if (old_sum == NULL)
+	{
+		state->spilled = DatumGetNumeric(datumCopy(NumericGetDatum(value), false, -1));
+	}
+	else
+	{
+		state->spilled = DatumGetNumeric(
+			DirectFunctionCall2(numeric_add, NumericGetDatum(old_sum), NumericGetDatum(value)));
+		pfree(old_sum);
+	}
+	MemoryContextSwitchTo(old_context);
+}
+
+static void
+numeric_accum_spill_sum(NumericAccumState *state, MemoryContext agg_extra_mctx)
+{
+	Numeric sum = scaled_int128_to_numeric(state->sum, state->scale);
+	numeric_accum_add_spilled(state, sum, agg_extra_mctx);
+	pfree(sum);
+	state->sum = 0;
+}
+
+/*
+ * Make a proper numeric datum from the headerless arrow varlena bytes, for
+ * the exact fallback arithmetic.
+ */
+static Numeric
+numeric_from_body(const uint8 *body, int len)
+{
+	Numeric result = palloc(VARHDRSZ + len);
+	SET_VARSIZE(result, VARHDRSZ + len);
+	memcpy(VARDATA(result), body, len);
+	return result;
+}
+
+static pg_attribute_always_inline void
+numeric_accum_track_scale(NumericAccumState *state, int dscale, int n)
+{
+	if (dscale > state->maxScale)
+	{
+		state->maxScale = dscale;
+		state->maxScaleCount = n;
+	}
+	else if (dscale == state->maxScale)
+	{
+		state->maxScaleCount += n;
+	}
+}
+
+/*
+ * Align the fast-path accumulator and a new scaled value to a common scale.
+ * Returns false if the value can't be rescaled within the int128 range.
+ */
+static pg_attribute_always_inline bool
+numeric_accum_align_scale(NumericAccumState *state, int dscale, int128 *value,
+						  MemoryContext agg_extra_mctx)
+{
+	if (dscale > state->scale)
+	{
+		const int128 multiplier = int128_power_of_10(dscale - state->scale);
+		if (state->sum >= SCALED_SUM_LIMIT / multiplier ||
+			state->sum <= -(SCALED_SUM_LIMIT / multiplier))
+		{
+			numeric_accum_spill_sum(state, agg_extra_mctx);
+		}
+		state->sum *= multiplier;
+		state->scale = dscale;
+	}
+	else if (dscale < state->scale)
+	{
+		const int128 multiplier = int128_power_of_10(state->scale - dscale);
+		if (*value >= SCALED_SUM_LIMIT / multiplier || *value <= -(SCALED_SUM_LIMIT / multiplier))
+		{
+			return false;
+		}
+		*value *= multiplier;
+	}
+	return true;
+}
+
+static pg_attribute_always_inline void
+numeric_accum_one(NumericAccumState *state, const uint8 *body, int len,
+				  MemoryContext agg_extra_mctx)
+{
+	NumericBodyParts parts;
+	numeric_body_parse(body, len, &parts);
+
+	if ((parts.header & NUMERIC_SIGN_MASK) == NUMERIC_SPECIAL)
+	{
+		if (parts.header == NUMERIC_PINF)
+		{
+			state->pInfcount++;
+		}
+		else if (parts.header == NUMERIC_NINF)
+		{
+			state->nInfcount++;
+		}
+		else
+		{
+			state->NaNcount++;
+		}
+		return;
+	}
+
+	state->N++;
+	numeric_accum_track_scale(state, parts.dscale, 1);
+
+	int128 value;
+	if (!numeric_body_to_scaled_int128(&parts, &value) ||
+		!numeric_accum_align_scale(state, parts.dscale, &value, agg_extra_mctx))
+	{
+		/* Too large for the fast path, use the exact numeric arithmetic. */
+		Numeric num = numeric_from_body(body, len);
+		numeric_accum_add_spilled(state, num, agg_extra_mctx);
+		pfree(num);
+		return;
+	}
+
+	state->sum += value;
+	if (state->sum >= SCALED_SUM_LIMIT || state->sum <= -SCALED_SUM_LIMIT)
+	{
+		numeric_accum_spill_sum(state, agg_extra_mctx);
+	}
+}
+
+static void
+numeric_accum_vector(void *restrict agg_state, const ArrowArray *vector, const uint64 *filter,
+					 MemoryContext agg_extra_mctx)
+{
+	NumericAccumState *state = (NumericAccumState *) agg_state;
+	const int n = vector->length;
+	if (vector->dictionary != NULL)
+	{
+		const int16 *indices = vector->buffers[1];
+		const uint32 *offsets = vector->dictionary->buffers[1];
+		const uint8 *bodies = vector->dictionary->buffers[2];
+		for (int row = 0; row < n; row++)
+		{
+			if (arrow_row_is_valid(filter, row))
+			{
+				const int16 index = indices[row];
+				numeric_accum_one(state,
+								  &bodies[offsets[index]],
+								  offsets[index + 1] - offsets[index],
+								  agg_extra_mctx);
+			}
+		}
+	}
+	else
+	{
+		const uint32 *offsets = vector->buffers[1];
+		const uint8 *bodies = vector->buffers[2];
+		for (int row = 0; row < n; row++)
+		{
+			if (arrow_row_is_valid(filter, row))
+			{
+				numeric_accum_one(state,
+								  &bodies[offsets[row]],
+								  offsets[row + 1] - offsets[row],
+								  agg_extra_mctx);
+			}
+		}
+	}
+}
+
+static void
+numeric_accum_many_vector(void *restrict agg_states, const uint32 *state_offsets,
+						  const uint64 *filter, int start_row, int end_row,
+						  const ArrowArray *vector, MemoryContext agg_extra_mctx)
+{
+	const bool dict = vector->dictionary != NULL;
+	const int16 *indices = dict ? vector->buffers[1] : NULL;
+	const uint32 *offsets = dict ? vector->dictionary->buffers[1] : vector->buffers[1];
+	const uint8 *bodies = dict ? vector->dictionary->buffers[2] : vector->buffers[2];
+	for (int row = start_row; row < end_row; row++)
+	{
+		NumericAccumState *state = (state_offsets[row] + (NumericAccumState *) agg_states);
+		if (arrow_row_is_valid(filter, row))
+		{
+			const int value_index = dict ? indices[row] : row;
+			numeric_accum_one(state,
+							  &bodies[offsets[value_index]],
+							  offsets[value_index + 1] - offsets[value_index],
+							  agg_extra_mctx);
+		}
+	}
+}
+
+static void
+numeric_accum_scalar(void *restrict agg_state, Datum constvalue, bool constisnull, int n,
+					 MemoryContext agg_extra_mctx)
+{
+	if (constisnull)
+	{
+		return;
+	}
+
+	NumericAccumState *state = (NumericAccumState *) agg_state;
+	Numeric num = DatumGetNumeric(constvalue);
+	const uint8 *body = (const uint8 *) VARDATA_ANY(num);
+	const int len = VARSIZE_ANY_EXHDR(num);
+
+	NumericBodyParts parts;
+	numeric_body_parse(body, len, &parts);
+
+	if ((parts.header & NUMERIC_SIGN_MASK) == NUMERIC_SPECIAL)
+	{
+		if (parts.header == NUMERIC_PINF)
+		{
+			state->pInfcount += n;
+		}
+		else if (parts.header == NUMERIC_NINF)
+		{
+			state->nInfcount += n;
+		}
+		else
+		{
+			state->NaNcount += n;
+		}
+		return;
+	}
+
+	state->N += n;
+	numeric_accum_track_scale(state, parts.dscale, n);
+
+	int128 value;
+	if (numeric_body_to_scaled_int128(&parts, &value) &&
+		numeric_accum_align_scale(state, parts.dscale, &value, agg_extra_mctx) &&
+		value < SCALED_SUM_LIMIT / n && value > -(SCALED_SUM_LIMIT / n))
+	{
+		state->sum += value * n;
+		if (state->sum >= SCALED_SUM_LIMIT || state->sum <= -SCALED_SUM_LIMIT)
+		{
+			numeric_accum_spill_sum(state, agg_extra_mctx);
+		}
+	}
+	else
+	{
+		Numeric total = DatumGetNumeric(DirectFunctionCall2(numeric_mul,
+															NumericGetDatum(num),
+															NumericGetDatum(int64_to_numeric(n))));
+		numeric_accum_add_spilled(state, total, agg_extra_mctx);
+		pfree(total);
+	}
+}
+
+static void
+numeric_accum_emit(void *restrict agg_state, Datum *out_result, bool *out_isnull)
+{
+	NumericAccumState *state = (NumericAccumState *) agg_state;
+
+	Numeric sum = scaled_int128_to_numeric(state->sum, state->scale);
+	if (state->spilled != NULL)
+	{
+		sum = DatumGetNumeric(
+			DirectFunctionCall2(numeric_add, NumericGetDatum(sum), NumericGetDatum(state->spilled)));
+	}
+
+	/*
+	 * Emit the partial in the format of numeric_avg_serialize(). We can't call
+	 * it directly because the in-memory NumericAggState it works with has
+	 * fields private to numeric.c.
+	 */
+	StringInfoData buf;
+	pq_begintypsend(&buf);
+	pq_sendint64(&buf, state->N);
+
+	const int ndigits = NUMERIC_NDIGITS(sum);
+	const NumericDigit *digits = NUMERIC_DIGITS(sum);
+	pq_sendint32(&buf, ndigits);
+	pq_sendint32(&buf, NUMERIC_WEIGHT(sum));
+	pq_sendint32(&buf, NUMERIC_SIGN(sum));
+	pq_sendint32(&buf, NUMERIC_DSCALE(sum));
+	for (int i = 0; i < ndigits; i++)
+	{
+		pq_sendint16(&buf, digits[i]);
+	}
+
+	pq_sendint32(&buf, state->maxScale);
+	pq_sendint64(&buf, state->maxScaleCount);
+	pq_sendint64(&buf, state->NaNcount);
+	pq_sendint64(&buf, state->pInfcount);
+	pq_sendint64(&buf, state->nInfcount);
+
+	*out_result = PointerGetDatum(pq_endtypsend(&buf));
+	*out_isnull = false;
+}
+
+VectorAggFunctions numeric_accum_agg = {
+	.state_bytes = sizeof(NumericAccumState),
+	.agg_init = numeric_accum_init,
+	.agg_emit = numeric_accum_emit,
+	.agg_scalar = numeric_accum_scalar,
+	.agg_vector = numeric_accum_vector,
+	.agg_many_vector = numeric_accum_many_vector,
+};
+
+#endif /* HAVE_INT128 */
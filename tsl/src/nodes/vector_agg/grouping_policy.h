@@ -69,6 +69,7 @@ typedef enum
 	VAGT_HashSingleFixed2,
 	VAGT_HashSingleFixed4,
 	VAGT_HashSingleFixed8,
+	VAGT_HashTwoFixed,
 	VAGT_HashSingleText,
 	VAGT_HashSerialized,
 } VectorAggGroupingType;
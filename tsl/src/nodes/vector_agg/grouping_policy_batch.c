@@ -113,11 +113,96 @@ gp_batch_reset(GroupingPolicy *obj)
 	policy->have_results = false;
 }
 
+/*
+ * Compute the two-argument bookend aggregates first() and last(). They differ
+ * from the normal aggregates in that they take a value column and a comparison
+ * column, and in that a row with a null value can still become the result, so
+ * the value column validity doesn't go into the combined filter.
+ */
+static void
+compute_bookend_aggregate(GroupingPolicyBatch *policy, DecompressContext *dcontext,
+						  TupleTableSlot *vector_slot, VectorAggDef *agg_def, void *agg_state,
+						  MemoryContext agg_extra_mctx)
+{
+	const CompressedColumnValues value = vector_slot_evaluate_expression(dcontext,
+																		vector_slot,
+																		agg_def->effective_batch_filter,
+																		agg_def->argument);
+	const CompressedColumnValues cmp = vector_slot_evaluate_expression(dcontext,
+																	   vector_slot,
+																	   agg_def->effective_batch_filter,
+																	   agg_def->argument2);
+	Ensure(value.decompression_type != DT_Iterator && cmp.decompression_type != DT_Iterator,
+		   "expected arrow array but got iterator");
+
+	DecompressBatchState *batch_state = (DecompressBatchState *) vector_slot;
+	const size_t num_words = (batch_state->total_batch_rows + 63) / 64;
+	const uint64 *combined_validity =
+		arrow_combine_validity(num_words,
+							   policy->tmp_filter,
+							   agg_def->effective_batch_filter,
+							   cmp.arrow != NULL ? cmp.buffers[0] : NULL,
+							   NULL);
+
+	agg_def->func.agg_bookend_vector(agg_state,
+									 agg_def->argument_type,
+									 &value,
+									 &cmp,
+									 combined_validity,
+									 batch_state->total_batch_rows,
+									 agg_extra_mctx);
+}
+
+/*
+ * Compute the histogram() aggregate. The bucket bounds and the number of
+ * buckets are the constant arguments taken from the aggregate definition. The
+ * value column validity doesn't go into the filter, because the row-by-row
+ * transition function is not strict and counts the null values as zeros.
+ */
+static void
+compute_histogram_aggregate(GroupingPolicyBatch *policy, DecompressContext *dcontext,
+							TupleTableSlot *vector_slot, VectorAggDef *agg_def, void *agg_state,
+							MemoryContext agg_extra_mctx)
+{
+	const CompressedColumnValues value = vector_slot_evaluate_expression(dcontext,
+																		 vector_slot,
+																		 agg_def->effective_batch_filter,
+																		 agg_def->argument);
+	Ensure(value.decompression_type != DT_Iterator, "expected arrow array but got iterator");
+
+	DecompressBatchState *batch_state = (DecompressBatchState *) vector_slot;
+	agg_def->func.agg_histogram_vector(agg_state,
+									   &value,
+									   agg_def->histogram_min,
+									   agg_def->histogram_max,
+									   agg_def->histogram_nbuckets,
+									   agg_def->effective_batch_filter,
+									   batch_state->total_batch_rows,
+									   agg_extra_mctx);
+}
+
 static void
 compute_single_aggregate(GroupingPolicyBatch *policy, DecompressContext *dcontext,
 						 TupleTableSlot *vector_slot, VectorAggDef *agg_def, void *agg_state,
 						 MemoryContext agg_extra_mctx)
 {
+	if (agg_def->func.agg_bookend_vector != NULL)
+	{
+		compute_bookend_aggregate(policy, dcontext, vector_slot, agg_def, agg_state, agg_extra_mctx);
+		return;
+	}
+
+	if (agg_def->func.agg_histogram_vector != NULL)
+	{
+		compute_histogram_aggregate(policy,
+									dcontext,
+									vector_slot,
+									agg_def,
+									agg_state,
+									agg_extra_mctx);
+		return;
+	}
+
 	/*
 	 * We have functions with one argument, and one function with no arguments
 	 * (count(*)). Collect the arguments.
@@ -15,9 +15,12 @@
 #include <access/tupdesc.h>
 #include <executor/tuptable.h>
 #include <nodes/pg_list.h>
+#include <utils/memutils.h>
 
 #include "grouping_policy.h"
 
+#include "guc.h"
+
 #include "nodes/vector_agg/exec.h"
 #include "nodes/vector_agg/filter_word_iterator.h"
 #include "nodes/vector_agg/vector_slot.h"
@@ -37,6 +40,7 @@
 extern HashingStrategy single_fixed_2_strategy;
 extern HashingStrategy single_fixed_4_strategy;
 extern HashingStrategy single_fixed_8_strategy;
+extern HashingStrategy two_fixed_strategy;
 #ifdef TS_USE_UMASH
 extern HashingStrategy single_text_strategy;
 extern HashingStrategy serialized_strategy;
@@ -56,6 +60,8 @@ create_grouping_policy_hash(int num_agg_defs, VectorAggDef *agg_defs, int num_gr
 
 	policy->agg_extra_mctx =
 		AllocSetContextCreate(CurrentMemoryContext, "agg extra", ALLOCSET_DEFAULT_SIZES);
+	policy->emit_mctx =
+		AllocSetContextCreate(CurrentMemoryContext, "bulk emission", ALLOCSET_DEFAULT_SIZES);
 	policy->num_allocated_per_key_agg_states = TARGET_COMPRESSED_BATCH_SIZE;
 
 	policy->num_agg_defs = num_agg_defs;
@@ -73,6 +79,11 @@ create_grouping_policy_hash(int num_agg_defs, VectorAggDef *agg_defs, int num_gr
 	policy->current_batch_grouping_column_values =
 		palloc(sizeof(CompressedColumnValues) * num_grouping_columns);
 
+	policy->emit_values =
+		palloc(sizeof(*policy->emit_values) * policy->num_agg_defs * TARGET_COMPRESSED_BATCH_SIZE);
+	policy->emit_isnull =
+		palloc(sizeof(*policy->emit_isnull) * policy->num_agg_defs * TARGET_COMPRESSED_BATCH_SIZE);
+
 	switch (grouping_type)
 	{
 #ifdef TS_USE_UMASH
@@ -92,6 +103,9 @@ create_grouping_policy_hash(int num_agg_defs, VectorAggDef *agg_defs, int num_gr
 		case VAGT_HashSingleFixed2:
 			policy->hashing = single_fixed_2_strategy;
 			break;
+		case VAGT_HashTwoFixed:
+			policy->hashing = two_fixed_strategy;
+			break;
 		default:
 			Ensure(false, "failed to determine the hashing strategy");
 			break;
@@ -110,8 +124,11 @@ gp_hash_reset(GroupingPolicy *obj)
 	GroupingPolicyHash *policy = (GroupingPolicyHash *) obj;
 
 	MemoryContextReset(policy->agg_extra_mctx);
+	MemoryContextReset(policy->emit_mctx);
 
 	policy->returning_results = false;
+	policy->emit_chunk_start = 0;
+	policy->emit_chunk_end = 0;
 
 	policy->hashing.reset(&policy->hashing);
 
@@ -225,6 +242,123 @@ compute_single_aggregate(GroupingPolicyHash *policy, DecompressContext *dcontext
 	}
 }
 
+/*
+ * Fill the key indexes for the rows of the batch by detecting runs of
+ * identical grouping key values. The time-bucketed rollups group by a monotone
+ * function of the orderby column, which produces long runs of identical keys
+ * within a batch, so we can look up the key index once per run instead of once
+ * per row. Used for a single fixed-width grouping column. Falls back to the
+ * generic per-row code of the hashing strategy when the batch turns out to
+ * have no run structure.
+ */
+static pg_attribute_always_inline void
+fill_offsets_detect_runs(GroupingPolicyHash *policy, TupleTableSlot *vector_slot,
+						 const uint64 *filter, int start_row, int end_row, const int key_width)
+{
+	const CompressedColumnValues *column = &policy->current_batch_grouping_column_values[0];
+	const uint64 *key_validity = column->buffers[0];
+	const char *key_values = column->buffers[1];
+	uint32 *restrict indexes = policy->key_index_for_row;
+
+	int num_runs = 0;
+	int row = start_row;
+	while (row < end_row)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
+			/* The row doesn't pass the filter, so it doesn't need a key index. */
+			row++;
+			continue;
+		}
+
+		/*
+		 * Look up the key index for the first row of the run using the generic
+		 * code of the hashing strategy.
+		 */
+		policy->hashing.fill_offsets(policy, vector_slot, row, row + 1);
+		num_runs++;
+
+		if (arrow_row_is_valid(key_validity, row))
+		{
+			/*
+			 * Extend the run while the next rows have the same key value,
+			 * reusing the key index without consulting the hash table. The
+			 * rows with null keys are not treated as parts of runs, they are
+			 * handled by the generic code above that manages the null key.
+			 */
+			const uint32 key_index = indexes[row];
+			const char *run_value = &key_values[key_width * row];
+			int next_row = row + 1;
+			for (; next_row < end_row; next_row++)
+			{
+				if (!arrow_row_is_valid(filter, next_row) ||
+					!arrow_row_is_valid(key_validity, next_row) ||
+					memcmp(&key_values[key_width * next_row], run_value, key_width) != 0)
+				{
+					break;
+				}
+				indexes[next_row] = key_index;
+			}
+#ifndef NDEBUG
+			policy->stat_consecutive_keys += next_row - row - 1;
+#endif
+			row = next_row;
+		}
+		else
+		{
+			row++;
+		}
+
+		/*
+		 * If the key values turn out to have no run structure, e.g. when
+		 * grouping by a high-cardinality column, the per-run bookkeeping
+		 * becomes pure overhead, so process the rest of the rows with the
+		 * generic per-row code.
+		 */
+		if (row - start_row >= 64 && num_runs * 4 > row - start_row)
+		{
+			policy->hashing.fill_offsets(policy, vector_slot, row, end_row);
+			return;
+		}
+	}
+}
+
+/*
+ * Map the rows of the batch to the unique indexes of their grouping keys.
+ */
+static void
+gp_hash_fill_offsets(GroupingPolicyHash *policy, TupleTableSlot *vector_slot, const uint64 *filter,
+					 int start_row, int end_row)
+{
+	if (policy->num_grouping_columns == 1)
+	{
+		/*
+		 * For a single fixed-width grouping column, try to detect runs of
+		 * identical key values, which are typical when grouping by time_bucket
+		 * of the orderby column. The positive decompression types give the
+		 * value width of the arrow array.
+		 */
+		const int width = policy->current_batch_grouping_column_values[0].decompression_type;
+		if (width == 2)
+		{
+			fill_offsets_detect_runs(policy, vector_slot, filter, start_row, end_row, 2);
+			return;
+		}
+		if (width == 4)
+		{
+			fill_offsets_detect_runs(policy, vector_slot, filter, start_row, end_row, 4);
+			return;
+		}
+		if (width == 8)
+		{
+			fill_offsets_detect_runs(policy, vector_slot, filter, start_row, end_row, 8);
+			return;
+		}
+	}
+
+	policy->hashing.fill_offsets(policy, vector_slot, start_row, end_row);
+}
+
 static void
 gp_hash_add_batch(GroupingPolicy *gp, DecompressContext *dcontext, TupleTableSlot *vector_slot)
 {
@@ -296,7 +430,7 @@ gp_hash_add_batch(GroupingPolicy *gp, DecompressContext *dcontext, TupleTableSlo
 	{
 		stats_matched_rows += iter.end_row - iter.start_row;
 		Assert((size_t) iter.end_row <= policy->num_key_index_for_row);
-		policy->hashing.fill_offsets(policy, vector_slot, iter.start_row, iter.end_row);
+		gp_hash_fill_offsets(policy, vector_slot, filter, iter.start_row, iter.end_row);
 	}
 
 	policy->stat_input_total_rows += nrows;
@@ -381,9 +515,64 @@ gp_hash_should_emit(GroupingPolicy *gp)
 	 * by memory reads. In general, when this first stage of grouping doesn't
 	 * significantly reduce the cardinality, it becomes pure overhead and the
 	 * work will be done by the final Postgres aggregation, so we should bail
-	 * out early here.
+	 * out early here. The limit is configurable, because when grouping by a
+	 * high-cardinality column, a larger in-memory table reduces the number of
+	 * duplicate partial results that the final aggregation has to combine.
+	 *
+	 * In addition to the hash table itself, we account for the aggregate
+	 * function states and the extra data they allocate, e.g. the grouping key
+	 * bodies for the text keys, so that the memory usage stays bounded also
+	 * for the wide aggregate states.
+	 */
+	size_t size_bytes = policy->hashing.get_size_bytes(&policy->hashing);
+	for (int i = 0; i < policy->num_agg_defs; i++)
+	{
+		size_bytes += policy->num_allocated_per_key_agg_states * policy->agg_defs[i].func.state_bytes;
+	}
+	size_bytes += MemoryContextMemAllocated(policy->agg_extra_mctx, false);
+
+	return size_bytes > (size_t) ts_guc_vectorized_aggregation_memory_limit * 1024;
+}
+
+/*
+ * Compute the partial aggregation results for the chunk of grouping keys
+ * starting at the given key. This is done for each aggregate function
+ * separately, with the states read sequentially, which improves the memory
+ * locality and keeps the indirect call target constant inside the loop. The
+ * results are stored as column vectors, and the output tuples are then
+ * assembled from them row by row when the parent node pulls them.
+ */
+static void
+gp_hash_prepare_emit_chunk(GroupingPolicyHash *policy, uint32 chunk_start, uint32 keys_end)
+{
+	Assert(chunk_start < keys_end);
+
+	/*
+	 * The results of the previous chunk have been consumed by the parent node,
+	 * so the by-reference results it might have allocated can be freed.
 	 */
-	return policy->hashing.get_size_bytes(&policy->hashing) > 512 * 1024;
+	MemoryContextReset(policy->emit_mctx);
+
+	policy->emit_chunk_start = chunk_start;
+	policy->emit_chunk_end = Min(chunk_start + TARGET_COMPRESSED_BATCH_SIZE, keys_end);
+
+	MemoryContext old_context = MemoryContextSwitchTo(policy->emit_mctx);
+	const int naggs = policy->num_agg_defs;
+	for (int i = 0; i < naggs; i++)
+	{
+		const VectorAggDef *agg_def = &policy->agg_defs[i];
+		const char *agg_states = policy->per_agg_per_key_states[i];
+		Datum *restrict values = &policy->emit_values[i * TARGET_COMPRESSED_BATCH_SIZE];
+		bool *restrict isnull = &policy->emit_isnull[i * TARGET_COMPRESSED_BATCH_SIZE];
+		for (uint32 key = policy->emit_chunk_start; key < policy->emit_chunk_end; key++)
+		{
+			void *agg_state = (void *) (key * agg_def->func.state_bytes + agg_states);
+			agg_def->func.agg_emit(agg_state,
+								   &values[key - policy->emit_chunk_start],
+								   &isnull[key - policy->emit_chunk_start]);
+		}
+	}
+	MemoryContextSwitchTo(old_context);
 }
 
 static bool
@@ -395,6 +584,8 @@ gp_hash_do_emit(GroupingPolicy *gp, TupleTableSlot *aggregated_slot)
 	{
 		policy->returning_results = true;
 		policy->last_returned_key = 1;
+		policy->emit_chunk_start = 0;
+		policy->emit_chunk_end = 0;
 
 		const float keys = policy->hashing.last_used_key_index;
 		if (keys > 0)
@@ -425,15 +616,25 @@ gp_hash_do_emit(GroupingPolicy *gp, TupleTableSlot *aggregated_slot)
 		return false;
 	}
 
+	/*
+	 * Compute the next chunk of partial aggregation results if the current one
+	 * is exhausted.
+	 */
+	if (current_key >= policy->emit_chunk_end)
+	{
+		gp_hash_prepare_emit_chunk(policy, current_key, keys_end);
+	}
+	Assert(current_key >= policy->emit_chunk_start && current_key < policy->emit_chunk_end);
+
+	const uint32 chunk_offset = current_key - policy->emit_chunk_start;
 	const int naggs = policy->num_agg_defs;
 	for (int i = 0; i < naggs; i++)
 	{
 		const VectorAggDef *agg_def = &policy->agg_defs[i];
-		void *agg_states = policy->per_agg_per_key_states[i];
-		void *agg_state = current_key * agg_def->func.state_bytes + (char *) agg_states;
-		agg_def->func.agg_emit(agg_state,
-							   &aggregated_slot->tts_values[agg_def->output_offset],
-							   &aggregated_slot->tts_isnull[agg_def->output_offset]);
+		aggregated_slot->tts_values[agg_def->output_offset] =
+			policy->emit_values[i * TARGET_COMPRESSED_BATCH_SIZE + chunk_offset];
+		aggregated_slot->tts_isnull[agg_def->output_offset] =
+			policy->emit_isnull[i * TARGET_COMPRESSED_BATCH_SIZE + chunk_offset];
 	}
 
 	policy->hashing.emit_key(policy, current_key, aggregated_slot);
@@ -121,6 +121,19 @@ typedef struct GroupingPolicyHash
 	bool returning_results;
 	uint32 last_returned_key;
 
+	/*
+	 * The partial aggregation results are computed in bulk for a chunk of
+	 * grouping keys at a time, for each aggregate function separately, same as
+	 * when updating the states. The output tuples are then assembled from
+	 * these column vectors. The by-reference results are allocated in the
+	 * emission memory context which is reset for each chunk.
+	 */
+	uint32 emit_chunk_start;
+	uint32 emit_chunk_end;
+	Datum *emit_values;
+	bool *emit_isnull;
+	MemoryContext emit_mctx;
+
 	/*
 	 * Some statistics for debugging.
 	 */
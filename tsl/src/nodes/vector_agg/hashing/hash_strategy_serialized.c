@@ -6,6 +6,12 @@
 
 /*
  * Implementation of column hashing for multiple serialized columns.
+ *
+ * The serialized grouping keys for all rows of the batch are built in one
+ * columnar pass into a per-batch arena, column by column, instead of
+ * serializing the columns row by row. This way, the type dispatch for the
+ * grouping columns is done once per column and not once per row, and no
+ * per-row allocations are needed.
  */
 
 #include <postgres.h>
@@ -32,11 +38,6 @@ serialized_key_hashing_init(HashingStrategy *hashing)
 	hashing->umash_params = umash_key_hashing_init();
 }
 
-static void
-serialized_key_hashing_prepare_for_batch(GroupingPolicyHash *policy, TupleTableSlot *vector_slot)
-{
-}
-
 static pg_attribute_always_inline bool
 byte_bitmap_row_is_valid(const uint8 *bitmap, size_t row_number)
 {
@@ -59,307 +60,470 @@ byte_bitmap_set_row_validity(uint8 *bitmap, size_t row_number, bool value)
 	Assert(byte_bitmap_row_is_valid(bitmap, row_number) == value);
 }
 
-static pg_attribute_always_inline void
-serialized_key_hashing_get_key(BatchHashingParams params, int row, void *restrict output_key_ptr,
-							   void *restrict hash_table_key_ptr, bool *restrict valid)
+/*
+ * Get the length in bytes of the variable-length value of the given text
+ * column at the given row.
+ */
+static pg_attribute_always_inline int32
+text_column_value_bytes(const CompressedColumnValues *column_values, int row, uint32 *restrict start)
 {
-	HashingStrategy *hashing = params.hashing;
-
-	text **restrict output_key = (text **) output_key_ptr;
-	HASH_TABLE_KEY_TYPE *restrict hash_table_key = (HASH_TABLE_KEY_TYPE *) hash_table_key_ptr;
-
-	const int num_columns = params.num_grouping_columns;
+	Assert(column_values->decompression_type == DT_ArrowText ||
+		   column_values->decompression_type == DT_ArrowTextDict);
+	Assert((column_values->decompression_type == DT_ArrowTextDict) ==
+		   (column_values->buffers[3] != NULL));
+
+	const uint32 data_row = (column_values->decompression_type == DT_ArrowTextDict) ?
+								((int16 *) column_values->buffers[3])[row] :
+								row;
+	*start = ((uint32 *) column_values->buffers[1])[data_row];
+	return ((uint32 *) column_values->buffers[1])[data_row + 1] - *start;
+}
 
-	const size_t bitmap_bytes = (num_columns + 7) / 8;
+/*
+ * The first columnar pass: add the contribution of the given column to the
+ * serialized key sizes of all rows of the batch.
+ */
+static void
+serialized_add_column_sizes(const BatchHashingParams *params, int column_index, uint16 nrows,
+							uint32 *restrict sizes)
+{
+	const uint64 *filter = params->batch_filter;
+	const CompressedColumnValues *column_values = &params->grouping_column_values[column_index];
 
-	/*
-	 * Loop through the grouping columns to determine the length of the key. We
-	 * need that to allocate memory to store it.
-	 *
-	 * The key has the null bitmap at the beginning.
-	 */
-	size_t num_bytes = bitmap_bytes;
-	for (int column_index = 0; column_index < num_columns; column_index++)
+	if (column_values->decompression_type == DT_Scalar)
 	{
-		const CompressedColumnValues *column_values = &params.grouping_column_values[column_index];
+		/*
+		 * The scalar column has the same value for all rows of the batch, so
+		 * its contribution to the key size can be computed once.
+		 */
+		if (DatumGetBool(PointerGetDatum(column_values->buffers[0])))
+		{
+			/* The scalar value is null and contributes nothing. */
+			return;
+		}
 
-		if (column_values->decompression_type == DT_Scalar)
+		const GroupingColumn *def = &params->policy->grouping_columns[column_index];
+		if (def->value_bytes > 0)
 		{
-			if (!DatumGetBool(PointerGetDatum(column_values->buffers[0])))
+			for (int row = 0; row < nrows; row++)
 			{
-				const GroupingColumn *def = &params.policy->grouping_columns[column_index];
-				if (def->value_bytes > 0)
+				if (arrow_row_is_valid(filter, row))
 				{
-					num_bytes += def->value_bytes;
+					sizes[row] += def->value_bytes;
 				}
-				else
+			}
+			return;
+		}
+
+		/*
+		 * The default value always has a long varlena header, but we are going
+		 * to use short if it fits.
+		 */
+		const int32 value_bytes = VARSIZE_ANY_EXHDR(column_values->buffers[1]);
+		if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
+		{
+			/* Short varlena, unaligned. */
+			for (int row = 0; row < nrows; row++)
+			{
+				if (arrow_row_is_valid(filter, row))
 				{
-					/*
-					 * The default value always has a long varlena header, but
-					 * we are going to use short if it fits.
-					 */
-					const int32 value_bytes = VARSIZE_ANY_EXHDR(column_values->buffers[1]);
-					if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
-					{
-						/* Short varlena, unaligned. */
-						const int total_bytes = value_bytes + VARHDRSZ_SHORT;
-						num_bytes += total_bytes;
-					}
-					else
-					{
-						/* Long varlena, requires alignment. */
-						const int total_bytes = value_bytes + VARHDRSZ;
-						num_bytes = TYPEALIGN(4, num_bytes) + total_bytes;
-					}
+					sizes[row] += value_bytes + VARHDRSZ_SHORT;
+				}
+			}
+		}
+		else
+		{
+			/* Long varlena, requires alignment. */
+			for (int row = 0; row < nrows; row++)
+			{
+				if (arrow_row_is_valid(filter, row))
+				{
+					sizes[row] = TYPEALIGN(4, sizes[row]) + value_bytes + VARHDRSZ;
 				}
 			}
-
-			continue;
 		}
+		return;
+	}
 
-		const bool is_valid = arrow_row_is_valid(column_values->buffers[0], row);
-		if (!is_valid)
+	if (column_values->decompression_type > 0)
+	{
+		const uint32 value_bytes = column_values->decompression_type;
+		for (int row = 0; row < nrows; row++)
 		{
-			continue;
+			if (arrow_row_is_valid(filter, row) &&
+				arrow_row_is_valid(column_values->buffers[0], row))
+			{
+				sizes[row] += value_bytes;
+			}
 		}
+		return;
+	}
 
-		if (column_values->decompression_type > 0)
+	if (column_values->decompression_type == DT_ArrowBits)
+	{
+		for (int row = 0; row < nrows; row++)
 		{
-			num_bytes += column_values->decompression_type;
-			continue;
+			if (arrow_row_is_valid(filter, row) &&
+				arrow_row_is_valid(column_values->buffers[0], row))
+			{
+				sizes[row] += 1;
+			}
 		}
+		return;
+	}
 
-		if (column_values->decompression_type == DT_ArrowBits)
+	for (int row = 0; row < nrows; row++)
+	{
+		if (!arrow_row_is_valid(filter, row) ||
+			!arrow_row_is_valid(column_values->buffers[0], row))
 		{
-			num_bytes += 1;
 			continue;
 		}
 
-		Assert(column_values->decompression_type == DT_ArrowText ||
-			   column_values->decompression_type == DT_ArrowTextDict);
-		Assert((column_values->decompression_type == DT_ArrowTextDict) ==
-			   (column_values->buffers[3] != NULL));
-
-		const uint32 data_row = (column_values->decompression_type == DT_ArrowTextDict) ?
-									((int16 *) column_values->buffers[3])[row] :
-									row;
-		const uint32 start = ((uint32 *) column_values->buffers[1])[data_row];
-		const int32 value_bytes = ((uint32 *) column_values->buffers[1])[data_row + 1] - start;
-
+		uint32 start;
+		const int32 value_bytes = text_column_value_bytes(column_values, row, &start);
 		if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
 		{
 			/* Short varlena, unaligned. */
-			const int total_bytes = value_bytes + VARHDRSZ_SHORT;
-			num_bytes += total_bytes;
+			sizes[row] += value_bytes + VARHDRSZ_SHORT;
 		}
 		else
 		{
 			/* Long varlena, requires alignment. */
-			const int total_bytes = value_bytes + VARHDRSZ;
-			num_bytes = TYPEALIGN(4, num_bytes) + total_bytes;
-		}
-	}
-
-	/*
-	 * The key has short or long varlena header. This is a little tricky, we
-	 * decide the header length after we have counted all the columns, but we
-	 * put it at the beginning. Technically it could change the length because
-	 * of the alignment. In practice, we only use alignment by 4 bytes for long
-	 * varlena strings, and if we have at least one long varlena string column,
-	 * the key is also going to use the long varlena header which is 4 bytes, so
-	 * the alignment is not affected. If we use the short varlena header for the
-	 * key, it necessarily means that there were no long varlena columns and
-	 * therefore no alignment is needed.
-	 */
-	const bool key_uses_short_header = num_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX;
-	num_bytes += key_uses_short_header ? VARHDRSZ_SHORT : VARHDRSZ;
-
-	/*
-	 * Use temporary storage for the new key, reallocate if it's too small.
-	 */
-	if (num_bytes > hashing->num_tmp_key_storage_bytes)
-	{
-		if (hashing->tmp_key_storage != NULL)
-		{
-			pfree(hashing->tmp_key_storage);
+			sizes[row] = TYPEALIGN(4, sizes[row]) + value_bytes + VARHDRSZ;
 		}
-		hashing->tmp_key_storage = MemoryContextAlloc(hashing->key_body_mctx, num_bytes);
-		hashing->num_tmp_key_storage_bytes = num_bytes;
 	}
-	uint8 *restrict serialized_key_storage = hashing->tmp_key_storage;
+}
 
-	/*
-	 * Build the actual grouping key.
-	 */
-	uint32 offset = 0;
-	offset += key_uses_short_header ? VARHDRSZ_SHORT : VARHDRSZ;
+/*
+ * Get the position of the column validity bitmap of the given row's key. The
+ * bitmap goes right after the varlena header of the key, whose length is
+ * determined by the total key length.
+ */
+static pg_attribute_always_inline uint8 *
+serialized_key_validity_bitmap(const HashingStrategy *hashing, int row)
+{
+	const uint32 start = hashing->key_arena_offsets[row];
+	const uint32 total_bytes = hashing->key_arena_offsets[row + 1] - start;
+	const uint32 header_bytes = total_bytes <= VARATT_SHORT_MAX ? VARHDRSZ_SHORT : VARHDRSZ;
+	return &hashing->key_arena[start + header_bytes];
+}
 
-	/*
-	 * We must always save the validity bitmap, even when there are no
-	 * null words, so that the key is uniquely deserializable. Otherwise a key
-	 * with some nulls might collide with a key with no nulls.
-	 */
-	uint8 *restrict serialized_key_validity_bitmap = &serialized_key_storage[offset];
-	offset += bitmap_bytes;
+/*
+ * The second columnar pass: append the values of the given column to the
+ * serialized keys of all rows of the batch, advancing the per-row write
+ * offsets.
+ */
+static void
+serialized_write_column_values(const BatchHashingParams *params, int column_index, uint16 nrows)
+{
+	HashingStrategy *hashing = params->hashing;
+	const uint64 *filter = params->batch_filter;
+	const CompressedColumnValues *column_values = &params->grouping_column_values[column_index];
+	uint8 *restrict arena = hashing->key_arena;
+	uint32 *restrict positions = hashing->key_write_offsets;
 
-	/*
-	 * Loop through the grouping columns again and add their values to the
-	 * grouping key.
-	 */
-	for (int column_index = 0; column_index < num_columns; column_index++)
+	if (column_values->decompression_type == DT_Scalar)
 	{
-		const CompressedColumnValues *column_values = &params.grouping_column_values[column_index];
-
-		if (column_values->decompression_type == DT_Scalar)
+		const bool is_valid = !DatumGetBool(PointerGetDatum(column_values->buffers[0]));
+		const Datum value = PointerGetDatum(column_values->buffers[1]);
+		const GroupingColumn *def = &params->policy->grouping_columns[column_index];
+		for (int row = 0; row < nrows; row++)
 		{
-			const bool is_valid = !DatumGetBool(PointerGetDatum(column_values->buffers[0]));
-			Datum value = PointerGetDatum(column_values->buffers[1]);
-			byte_bitmap_set_row_validity(serialized_key_validity_bitmap, column_index, is_valid);
-			if (is_valid)
+			if (!arrow_row_is_valid(filter, row))
 			{
-				const GroupingColumn *def = &params.policy->grouping_columns[column_index];
-				if (def->by_value)
-				{
-					memcpy(&serialized_key_storage[offset], &value, def->value_bytes);
+				continue;
+			}
 
-					offset += def->value_bytes;
-				}
-				else if (def->value_bytes > 0)
-				{
-					memcpy(&serialized_key_storage[offset],
-						   DatumGetPointer(value),
-						   def->value_bytes);
+			byte_bitmap_set_row_validity(serialized_key_validity_bitmap(hashing, row),
+										 column_index,
+										 is_valid);
+			if (!is_valid)
+			{
+				continue;
+			}
 
-					offset += def->value_bytes;
+			uint32 offset = positions[row];
+			if (def->by_value)
+			{
+				memcpy(&arena[offset], &value, def->value_bytes);
+				offset += def->value_bytes;
+			}
+			else if (def->value_bytes > 0)
+			{
+				memcpy(&arena[offset], DatumGetPointer(value), def->value_bytes);
+				offset += def->value_bytes;
+			}
+			else
+			{
+				/*
+				 * The default value always has a long varlena header, but we
+				 * are going to use short if it fits.
+				 */
+				const int32 value_bytes = VARSIZE_ANY_EXHDR(value);
+				if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
+				{
+					/* Short varlena, no alignment. */
+					SET_VARSIZE_SHORT(&arena[offset], value_bytes + VARHDRSZ_SHORT);
+					offset += VARHDRSZ_SHORT;
 				}
 				else
 				{
 					/*
-					 * The default value always has a long varlena header, but
-					 * we are going to use short if it fits.
+					 * Long varlena, requires alignment relative to the key
+					 * start, to match the sizes computed by the first pass.
+					 * The alignment bytes are already zeroed out.
 					 */
-					const int32 value_bytes = VARSIZE_ANY_EXHDR(value);
-					if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
-					{
-						/* Short varlena, no alignment. */
-						const int32 total_bytes = value_bytes + VARHDRSZ_SHORT;
-						SET_VARSIZE_SHORT(&serialized_key_storage[offset], total_bytes);
-						offset += VARHDRSZ_SHORT;
-					}
-					else
-					{
-						/* Long varlena, requires alignment. Zero out the alignment bytes. */
-						memset(&serialized_key_storage[offset], 0, 4);
-						offset = TYPEALIGN(4, offset);
-						const int32 total_bytes = value_bytes + VARHDRSZ;
-						SET_VARSIZE(&serialized_key_storage[offset], total_bytes);
-						offset += VARHDRSZ;
-					}
-
-					memcpy(&serialized_key_storage[offset], VARDATA_ANY(value), value_bytes);
-
-					offset += value_bytes;
+					const uint32 key_start = hashing->key_arena_offsets[row];
+					offset = key_start + TYPEALIGN(4, offset - key_start);
+					SET_VARSIZE(&arena[offset], value_bytes + VARHDRSZ);
+					offset += VARHDRSZ;
 				}
+				memcpy(&arena[offset], VARDATA_ANY(value), value_bytes);
+				offset += value_bytes;
 			}
-			continue;
+			positions[row] = offset;
 		}
+		return;
+	}
 
-		const bool is_valid = arrow_row_is_valid(column_values->buffers[0], row);
-		byte_bitmap_set_row_validity(serialized_key_validity_bitmap, column_index, is_valid);
-
-		if (!is_valid)
+	if (column_values->decompression_type > 0)
+	{
+		const uint32 value_bytes = column_values->decompression_type;
+		for (int row = 0; row < nrows; row++)
 		{
-			continue;
+			if (!arrow_row_is_valid(filter, row))
+			{
+				continue;
+			}
+
+			const bool is_valid = arrow_row_is_valid(column_values->buffers[0], row);
+			byte_bitmap_set_row_validity(serialized_key_validity_bitmap(hashing, row),
+										 column_index,
+										 is_valid);
+			if (!is_valid)
+			{
+				continue;
+			}
+
+			memcpy(&arena[positions[row]],
+				   value_bytes * row + (const char *) column_values->buffers[1],
+				   value_bytes);
+			positions[row] += value_bytes;
 		}
+		return;
+	}
 
-		if (column_values->decompression_type > 0)
+	if (column_values->decompression_type == DT_ArrowBits)
+	{
+		for (int row = 0; row < nrows; row++)
 		{
-			Assert(offset <= UINT_MAX - column_values->decompression_type);
+			if (!arrow_row_is_valid(filter, row))
+			{
+				continue;
+			}
 
-			switch ((int) column_values->decompression_type)
+			const bool is_valid = arrow_row_is_valid(column_values->buffers[0], row);
+			byte_bitmap_set_row_validity(serialized_key_validity_bitmap(hashing, row),
+										 column_index,
+										 is_valid);
+			if (!is_valid)
 			{
-				case 2:
-					memcpy(&serialized_key_storage[offset],
-						   row + (int16 *) column_values->buffers[1],
-						   2);
-					break;
-				case 4:
-					memcpy(&serialized_key_storage[offset],
-						   row + (int32 *) column_values->buffers[1],
-						   4);
-					break;
-				case 8:
-					memcpy(&serialized_key_storage[offset],
-						   row + (int64 *) column_values->buffers[1],
-						   8);
-					break;
-				case 16:
-					memcpy(&serialized_key_storage[offset],
-						   (row * 2) + (int64 *) column_values->buffers[1],
-						   16);
-					break;
-				default:
-					pg_unreachable();
-					break;
+				continue;
 			}
 
-			offset += column_values->decompression_type;
+			arena[positions[row]] = arrow_row_is_valid(column_values->buffers[1], row);
+			positions[row] += 1;
+		}
+		return;
+	}
 
+	for (int row = 0; row < nrows; row++)
+	{
+		if (!arrow_row_is_valid(filter, row))
+		{
 			continue;
 		}
 
-		if (column_values->decompression_type == DT_ArrowBits)
+		const bool is_valid = arrow_row_is_valid(column_values->buffers[0], row);
+		byte_bitmap_set_row_validity(serialized_key_validity_bitmap(hashing, row),
+									 column_index,
+									 is_valid);
+		if (!is_valid)
 		{
-			serialized_key_storage[offset] = arrow_row_is_valid(column_values->buffers[1], row);
-			offset += 1;
 			continue;
 		}
 
-		Assert(column_values->decompression_type == DT_ArrowText ||
-			   column_values->decompression_type == DT_ArrowTextDict);
-
-		const uint32 data_row = column_values->decompression_type == DT_ArrowTextDict ?
-									((int16 *) column_values->buffers[3])[row] :
-									row;
-		const uint32 start = ((uint32 *) column_values->buffers[1])[data_row];
-		const int32 value_bytes = ((uint32 *) column_values->buffers[1])[data_row + 1] - start;
-
+		uint32 start;
+		const int32 value_bytes = text_column_value_bytes(column_values, row, &start);
+		uint32 offset = positions[row];
 		if (value_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX)
 		{
 			/* Short varlena, unaligned. */
-			const int32 total_bytes = value_bytes + VARHDRSZ_SHORT;
-			SET_VARSIZE_SHORT(&serialized_key_storage[offset], total_bytes);
+			SET_VARSIZE_SHORT(&arena[offset], value_bytes + VARHDRSZ_SHORT);
 			offset += VARHDRSZ_SHORT;
 		}
 		else
 		{
-			/* Long varlena, requires alignment. Zero out the alignment bytes. */
-			memset(&serialized_key_storage[offset], 0, 4);
-			offset = TYPEALIGN(4, offset);
-			const int32 total_bytes = value_bytes + VARHDRSZ;
-			SET_VARSIZE(&serialized_key_storage[offset], total_bytes);
+			/*
+			 * Long varlena, requires alignment relative to the key start, to
+			 * match the sizes computed by the first pass. The alignment bytes
+			 * are already zeroed out.
+			 */
+			const uint32 key_start = hashing->key_arena_offsets[row];
+			offset = key_start + TYPEALIGN(4, offset - key_start);
+			SET_VARSIZE(&arena[offset], value_bytes + VARHDRSZ);
 			offset += VARHDRSZ;
 		}
-		memcpy(&serialized_key_storage[offset],
-			   &((uint8 *) column_values->buffers[2])[start],
-			   value_bytes);
+		memcpy(&arena[offset], &((const uint8 *) column_values->buffers[2])[start], value_bytes);
+		positions[row] = offset + value_bytes;
+	}
+}
+
+/*
+ * Build the serialized grouping keys for all rows of the batch in the
+ * per-batch arena, column by column.
+ */
+static void
+serialized_key_hashing_prepare_for_batch(GroupingPolicyHash *policy, TupleTableSlot *vector_slot)
+{
+	HashingStrategy *hashing = &policy->hashing;
+	const int num_columns = policy->num_grouping_columns;
+	const size_t bitmap_bytes = (num_columns + 7) / 8;
+	uint16 nrows;
+	const uint64 *filter = vector_slot_get_qual_result(vector_slot, &nrows);
+
+	const BatchHashingParams params = build_batch_hashing_params(policy, vector_slot);
 
-		offset += value_bytes;
+	if (hashing->num_key_arena_rows < (uint32) nrows + 1)
+	{
+		if (hashing->key_arena_offsets != NULL)
+		{
+			pfree(hashing->key_arena_offsets);
+			pfree(hashing->key_write_offsets);
+		}
+		hashing->num_key_arena_rows = nrows + 1;
+		hashing->key_arena_offsets =
+			palloc(sizeof(*hashing->key_arena_offsets) * hashing->num_key_arena_rows);
+		hashing->key_write_offsets =
+			palloc(sizeof(*hashing->key_write_offsets) * hashing->num_key_arena_rows);
 	}
+	uint32 *restrict offsets = hashing->key_arena_offsets;
+	uint32 *restrict positions = hashing->key_write_offsets;
 
-	Assert(offset == num_bytes);
+	/*
+	 * The first columnar pass computes the sizes of the key bodies. The key
+	 * body starts with the column validity bitmap.
+	 */
+	for (int row = 0; row < nrows; row++)
+	{
+		positions[row] = bitmap_bytes;
+	}
+	for (int column_index = 0; column_index < num_columns; column_index++)
+	{
+		serialized_add_column_sizes(&params, column_index, nrows, positions);
+	}
+
+	/*
+	 * The key has a short or long varlena header, depending on the total
+	 * length. This is a little tricky, we decide the header length after we
+	 * have counted all the columns, but we put it at the beginning.
+	 * Technically it could change the length because of the alignment. In
+	 * practice, we only use alignment by 4 bytes for long varlena strings, and
+	 * if we have at least one long varlena string column, the key is also
+	 * going to use the long varlena header which is 4 bytes, so the alignment
+	 * is not affected. If we use the short varlena header for the key, it
+	 * necessarily means that there were no long varlena columns and therefore
+	 * no alignment is needed.
+	 *
+	 * Convert the sizes to the arena offsets of the keys, and set the write
+	 * offsets for the second pass to go after the header and the validity
+	 * bitmap.
+	 */
+	uint64 arena_bytes = 0;
+	for (int row = 0; row < nrows; row++)
+	{
+		offsets[row] = arena_bytes;
+		if (!arrow_row_is_valid(filter, row))
+		{
+			/* The row is filtered out and its key occupies no space. */
+			continue;
+		}
+
+		const uint32 body_bytes = positions[row];
+		const uint32 header_bytes =
+			body_bytes + VARHDRSZ_SHORT <= VARATT_SHORT_MAX ? VARHDRSZ_SHORT : VARHDRSZ;
+		positions[row] = arena_bytes + header_bytes + bitmap_bytes;
+		arena_bytes += header_bytes + body_bytes;
+	}
+	offsets[nrows] = arena_bytes;
+
+	if (hashing->num_key_arena_bytes < arena_bytes)
+	{
+		if (hashing->key_arena != NULL)
+		{
+			pfree(hashing->key_arena);
+		}
+		hashing->num_key_arena_bytes = arena_bytes * 2 + 1;
+		hashing->key_arena = palloc(hashing->num_key_arena_bytes);
+	}
+
+	/*
+	 * Zero out the arena, so that the validity bitmaps start empty and the
+	 * varlena alignment padding bytes are zeroed.
+	 */
+	memset(hashing->key_arena, 0, arena_bytes);
 
-	if (key_uses_short_header)
+	/*
+	 * The second columnar pass fills in the actual grouping keys.
+	 */
+	for (int column_index = 0; column_index < num_columns; column_index++)
 	{
-		SET_VARSIZE_SHORT(serialized_key_storage, offset);
+		serialized_write_column_values(&params, column_index, nrows);
 	}
-	else
+
+	/*
+	 * Finally, fill in the varlena headers of the keys.
+	 */
+	for (int row = 0; row < nrows; row++)
 	{
-		SET_VARSIZE(serialized_key_storage, offset);
+		if (!arrow_row_is_valid(filter, row))
+		{
+			continue;
+		}
+
+		const uint32 total_bytes = offsets[row + 1] - offsets[row];
+		Assert(positions[row] == offsets[row + 1]);
+		if (total_bytes <= VARATT_SHORT_MAX)
+		{
+			SET_VARSIZE_SHORT(&hashing->key_arena[offsets[row]], total_bytes);
+		}
+		else
+		{
+			SET_VARSIZE(&hashing->key_arena[offsets[row]], total_bytes);
+		}
 	}
+}
+
+static pg_attribute_always_inline void
+serialized_key_hashing_get_key(BatchHashingParams params, int row, void *restrict output_key_ptr,
+							   void *restrict hash_table_key_ptr, bool *restrict valid)
+{
+	HashingStrategy *hashing = params.hashing;
+
+	text **restrict output_key = (text **) output_key_ptr;
+	HASH_TABLE_KEY_TYPE *restrict hash_table_key = (HASH_TABLE_KEY_TYPE *) hash_table_key_ptr;
+
+	/*
+	 * The key was already built by the columnar passes over the batch, we only
+	 * have to compute its fingerprint here.
+	 */
+	const uint32 start = hashing->key_arena_offsets[row];
+	const uint32 num_bytes = hashing->key_arena_offsets[row + 1] - start;
+	uint8 *restrict serialized_key_storage = &hashing->key_arena[start];
 
-	DEBUG_PRINT("key is %d bytes: ", offset);
-	for (size_t i = 0; i < offset; i++)
+	DEBUG_PRINT("key is %d bytes: ", num_bytes);
+	for (size_t i = 0; i < num_bytes; i++)
 	{
 		DEBUG_PRINT("%.2x.", serialized_key_storage[i]);
 	}
@@ -388,14 +552,13 @@ serialized_key_hashing_store_new(HashingStrategy *restrict hashing, uint32 new_k
 								 text *output_key)
 {
 	/*
-	 * We will store this key so we have to consume the temporary storage that
-	 * was used for it. The subsequent keys will need to allocate new memory.
+	 * The key points into the per-batch arena that is reused for the next
+	 * batch, so we have to copy it to the persistent key storage.
 	 */
-	Assert(hashing->tmp_key_storage == (void *) output_key);
-	hashing->tmp_key_storage = NULL;
-	hashing->num_tmp_key_storage_bytes = 0;
-
-	hashing->output_keys[new_key_index] = PointerGetDatum(output_key);
+	const size_t num_bytes = VARSIZE_ANY(output_key);
+	text *stored = MemoryContextAlloc(hashing->key_body_mctx, num_bytes);
+	memcpy(stored, output_key, num_bytes);
+	hashing->output_keys[new_key_index] = PointerGetDatum(stored);
 }
 
 static void
@@ -0,0 +1,152 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Implementation of column hashing for two fixed-size by-value columns packed
+ * into one hash table key. This covers the typical GROUP BY over two id
+ * columns, which would otherwise have to use the much slower serialized key
+ * strategy that allocates and copies the key for each row.
+ */
+
+#include <postgres.h>
+
+#include "compression/arrow_c_data_interface.h"
+#include "hash64.h"
+#include "nodes/columnar_scan/compressed_batch.h"
+#include "nodes/vector_agg/exec.h"
+#include "nodes/vector_agg/grouping_policy_hash.h"
+#include "template_helper.h"
+
+#include "batch_hashing_params.h"
+
+/*
+ * The values of both columns in their Datum representation, and the validity
+ * bits of the columns in the lowest bits of the last member. The null values
+ * are canonicalized to zero so that the keys can be compared bytewise. The
+ * struct is packed to make the hash table entry smaller after adding the
+ * uint32 key index and the status byte that go before it.
+ */
+typedef struct TwoFixedKey
+{
+	uint64 columns[2];
+	uint8 validity;
+} pg_attribute_packed() TwoFixedKey;
+
+#define EXPLAIN_NAME "two fixed-size"
+#define KEY_VARIANT two_fixed
+#define OUTPUT_KEY_TYPE TwoFixedKey
+#define HASH_TABLE_KEY_TYPE TwoFixedKey
+
+static pg_attribute_always_inline uint64
+two_fixed_key_hash(TwoFixedKey key)
+{
+	return HASH64(key.columns[0] ^ hash64_splitmix(key.columns[1] ^ key.validity));
+}
+
+#define KEY_EQUAL(a, b)                                                                            \
+	(a.columns[0] == b.columns[0] && a.columns[1] == b.columns[1] && a.validity == b.validity)
+#define KEY_HASH(X) two_fixed_key_hash(X)
+
+static void
+two_fixed_key_hashing_init(HashingStrategy *hashing)
+{
+}
+
+static void
+two_fixed_key_hashing_prepare_for_batch(GroupingPolicyHash *policy, TupleTableSlot *vector_slot)
+{
+}
+
+/*
+ * Get the value of the given grouping column in its Datum representation. The
+ * fixed-size by-value types are sign-extended, which matches the Datum
+ * representation used by the scalar values, so the values obtained from the
+ * arrow arrays and from the scalar (segmentby) columns compare equal.
+ */
+static pg_attribute_always_inline uint64
+two_fixed_key_get_column(const CompressedColumnValues *column_values, int row, bool *restrict valid)
+{
+	if (unlikely(column_values->decompression_type == DT_Scalar))
+	{
+		*valid = !DatumGetBool(PointerGetDatum(column_values->buffers[0]));
+		return (uint64) PointerGetDatum(column_values->buffers[1]);
+	}
+
+	*valid = arrow_row_is_valid(column_values->buffers[0], row);
+	switch ((int) column_values->decompression_type)
+	{
+		case 2:
+			return (uint64) (int64) ((const int16 *) column_values->buffers[1])[row];
+		case 4:
+			return (uint64) (int64) ((const int32 *) column_values->buffers[1])[row];
+		case 8:
+			return (uint64) ((const int64 *) column_values->buffers[1])[row];
+		default:
+			pg_unreachable();
+			return 0;
+	}
+}
+
+static pg_attribute_always_inline void
+two_fixed_key_hashing_get_key(BatchHashingParams params, int row, void *restrict output_key_ptr,
+							  void *restrict hash_table_key_ptr, bool *restrict valid)
+{
+	TwoFixedKey *restrict output_key = (TwoFixedKey *) output_key_ptr;
+	TwoFixedKey *restrict hash_table_key = (TwoFixedKey *) hash_table_key_ptr;
+
+	Assert(params.num_grouping_columns == 2);
+
+	bool column_valid[2];
+	for (int i = 0; i < 2; i++)
+	{
+		output_key->columns[i] =
+			two_fixed_key_get_column(&params.grouping_column_values[i], row, &column_valid[i]);
+
+		/*
+		 * Canonicalize the null values to zero, so that the keys with null
+		 * columns can be compared bytewise.
+		 */
+		if (!column_valid[i])
+		{
+			output_key->columns[i] = 0;
+		}
+	}
+	output_key->validity = ((uint8) column_valid[0]) | (((uint8) column_valid[1]) << 1);
+
+	/*
+	 * The multi-column key is always considered non-null, and the null flags
+	 * for the individual columns are stored in the key itself.
+	 */
+	*valid = true;
+
+	*hash_table_key = *output_key;
+}
+
+static pg_attribute_always_inline void
+two_fixed_key_hashing_store_new(HashingStrategy *restrict hashing, uint32 new_key_index,
+								TwoFixedKey output_key)
+{
+	TwoFixedKey *stored = MemoryContextAlloc(hashing->key_body_mctx, sizeof(TwoFixedKey));
+	*stored = output_key;
+	hashing->output_keys[new_key_index] = PointerGetDatum(stored);
+}
+
+static void
+two_fixed_emit_key(GroupingPolicyHash *policy, uint32 current_key, TupleTableSlot *aggregated_slot)
+{
+	const HashingStrategy *hashing = &policy->hashing;
+	Assert(policy->num_grouping_columns == 2);
+
+	const TwoFixedKey *key = (const TwoFixedKey *) DatumGetPointer(hashing->output_keys[current_key]);
+	for (int i = 0; i < 2; i++)
+	{
+		const GroupingColumn *col = &policy->grouping_columns[i];
+		aggregated_slot->tts_values[col->output_offset] = (Datum) key->columns[i];
+		aggregated_slot->tts_isnull[col->output_offset] = (key->validity & (1 << i)) == 0;
+	}
+}
+
+#include "hash_strategy_impl.c"
@@ -67,6 +67,20 @@ typedef struct HashingStrategy
 	 * UMASH fingerprinting parameters.
 	 */
 	struct umash_params *umash_params;
+
+	/*
+	 * The per-batch arena where the serialized strategy builds the grouping
+	 * keys for all rows of the batch column-by-column, and the offsets of the
+	 * per-row keys in the arena. The offsets array has one extra element, so
+	 * that the length of each key is given by the difference of the
+	 * neighboring offsets. The write offsets track the current write position
+	 * of each row's key during the columnar build.
+	 */
+	uint8 *key_arena;
+	uint64 num_key_arena_bytes;
+	uint32 *key_arena_offsets;
+	uint32 *key_write_offsets;
+	uint32 num_key_arena_rows;
 #endif
 
 	/*
@@ -0,0 +1,451 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * The plain batch reader converts the heap tuples of an uncompressed chunk
+ * scan into the same in-memory columnar representation that is produced by
+ * bulk decompression of the compressed chunks. The uncompressed chunks hold
+ * the most recent data of a hypertable, which is exactly what the real-time
+ * queries tend to aggregate, so it is important to use the vectorized
+ * aggregation for them as well, and not fall back to the row-by-row Postgres
+ * aggregation.
+ *
+ * The reader pulls the tuples from the child scan node through the normal
+ * executor interface, deforms each tuple once, and transposes the values into
+ * per-column Arrow arrays of up to TARGET_COMPRESSED_BATCH_SIZE rows. The
+ * resulting batch is presented to the grouping policies as a DecompressBatchState,
+ * same as a decompressed batch of a compressed chunk, with a trivial all-ones
+ * vectorized qual result -- the Postgres quals have already been evaluated by
+ * the child scan node.
+ */
+
+#include <postgres.h>
+
+#include <executor/executor.h>
+#include <executor/tuptable.h>
+#include <fmgr.h>
+#include <nodes/nodeFuncs.h>
+#include <optimizer/optimizer.h>
+#include <utils/lsyscache.h>
+
+#include "nodes/vector_agg/plain_batch.h"
+
+#include "compression/arrow_c_data_interface.h"
+#include "compression/compression.h"
+#include "nodes/columnar_scan/compressed_batch.h"
+
+typedef struct PlainBatchColumn
+{
+	/* Attno of the column in the output tuple of the child scan node. */
+	AttrNumber child_attno;
+
+	/*
+	 * Same as CompressedColumnValues.decompression_type: DT_ArrowBits,
+	 * DT_ArrowText, or a positive fixed width in bytes.
+	 */
+	DecompressionType decompression_type;
+	bool by_value;
+
+	/*
+	 * The column buffers are allocated once at the maximum batch size and
+	 * reused for all batches, only the variable-length text bodies can grow.
+	 */
+	uint64 *restrict validity;
+	uint8 *restrict values;
+	uint32 *restrict offsets;
+	uint8 *restrict bodies;
+	int allocated_body_bytes;
+	uint32 current_offset;
+
+	int num_batch_nulls;
+
+	ArrowArray *arrow;
+} PlainBatchColumn;
+
+typedef struct PlainBatchReader
+{
+	/*
+	 * A minimal decompression context that describes the batch columns. It
+	 * allows the grouping policies and the vectorized expression evaluation
+	 * to resolve the uncompressed chunk variables in the same way as for the
+	 * ColumnarScan child.
+	 */
+	DecompressContext dcontext;
+
+	DecompressBatchState *batch_state;
+
+	int num_columns;
+	PlainBatchColumn *columns;
+
+	/* How many leading attributes of the child output tuple we deform. */
+	int num_child_attrs;
+
+	/* All rows pass, the child scan node evaluates the quals itself. */
+	uint64 *vector_qual_result;
+} PlainBatchReader;
+
+/*
+ * Find the position of the given uncompressed chunk attno in the output
+ * targetlist of the child scan node.
+ */
+static AttrNumber
+plain_batch_child_attno(const Plan *childplan, AttrNumber chunk_attno)
+{
+	ListCell *lc;
+	foreach (lc, childplan->targetlist)
+	{
+		TargetEntry *target_entry = lfirst_node(TargetEntry, lc);
+		if (IsA(target_entry->expr, Var) &&
+			castNode(Var, target_entry->expr)->varattno == chunk_attno)
+		{
+			return target_entry->resno;
+		}
+	}
+
+	/* Verified at planning time, so this cannot happen. */
+	Ensure(false, "aggregated column %d not found in the child scan targetlist", chunk_attno);
+	pg_unreachable();
+	return InvalidAttrNumber;
+}
+
+void
+plain_batch_reader_create(VectorAggState *vector_agg_state)
+{
+	CustomScan *cscan = castNode(CustomScan, vector_agg_state->custom.ss.ps.plan);
+	Plan *childplan = linitial(cscan->custom_plans);
+	PlanState *child_state = linitial(vector_agg_state->custom.custom_ps);
+
+	PlainBatchReader *reader = palloc0(sizeof(PlainBatchReader));
+
+	/*
+	 * Determine which columns we have to convert to the columnar
+	 * representation. These are the columns referenced by the aggregated
+	 * targetlist, including the aggregate FILTER expressions. The child scan
+	 * node can output more columns, e.g. the ones used only by its quals, and
+	 * they might not even have a columnar representation, so we must not
+	 * convert them.
+	 */
+	List *aggregated_vars =
+		pull_var_clause((Node *) cscan->custom_scan_tlist,
+						PVC_RECURSE_AGGREGATES | PVC_RECURSE_PLACEHOLDERS);
+	List *unique_vars = NIL;
+	ListCell *lc;
+	foreach (lc, aggregated_vars)
+	{
+		Var *var = lfirst_node(Var, lc);
+		bool found = false;
+		ListCell *lc2;
+		foreach (lc2, unique_vars)
+		{
+			if (lfirst_node(Var, lc2)->varattno == var->varattno)
+			{
+				found = true;
+				break;
+			}
+		}
+		if (!found)
+		{
+			unique_vars = lappend(unique_vars, var);
+		}
+	}
+
+	const int num_columns = list_length(unique_vars);
+	reader->num_columns = num_columns;
+	reader->columns = palloc0(sizeof(*reader->columns) * num_columns);
+
+	reader->dcontext.num_data_columns = num_columns;
+	reader->dcontext.compressed_chunk_columns =
+		palloc0(sizeof(*reader->dcontext.compressed_chunk_columns) * num_columns);
+	reader->dcontext.ps = &vector_agg_state->custom.ss.ps;
+
+	const int num_batch_words = pad_to_multiple(64, TARGET_COMPRESSED_BATCH_SIZE) / 64;
+	foreach (lc, unique_vars)
+	{
+		const int i = foreach_current_index(lc);
+		const Var *var = lfirst_node(Var, lc);
+		PlainBatchColumn *column = &reader->columns[i];
+
+		column->child_attno = plain_batch_child_attno(childplan, var->varattno);
+		if (column->child_attno > reader->num_child_attrs)
+		{
+			reader->num_child_attrs = column->child_attno;
+		}
+
+		int16 typlen;
+		bool typbyval;
+		get_typlenbyval(var->vartype, &typlen, &typbyval);
+		column->by_value = typbyval;
+		if (var->vartype == BOOLOID)
+		{
+			column->decompression_type = DT_ArrowBits;
+		}
+		else if (typlen == -1)
+		{
+			column->decompression_type = DT_ArrowText;
+		}
+		else
+		{
+			Assert(typlen > 0);
+			column->decompression_type = typlen;
+		}
+
+		column->validity = palloc(sizeof(uint64) * num_batch_words);
+		if (column->decompression_type == DT_ArrowBits)
+		{
+			column->values = palloc0(sizeof(uint64) * num_batch_words);
+		}
+		else if (column->decompression_type == DT_ArrowText)
+		{
+			column->offsets =
+				palloc0(pad_to_multiple(64,
+										sizeof(*column->offsets) *
+											(TARGET_COMPRESSED_BATCH_SIZE + 1)));
+			column->allocated_body_bytes = pad_to_multiple(64, 1024);
+			column->bodies = palloc(column->allocated_body_bytes);
+		}
+		else
+		{
+			/*
+			 * Same as for the vectorized function results, pad the buffer so
+			 * that a full-Datum write at the last row doesn't overflow it.
+			 */
+			column->values =
+				palloc(pad_to_multiple(64,
+									   1 + column->decompression_type *
+											   TARGET_COMPRESSED_BATCH_SIZE));
+		}
+
+		const int num_buffers = column->decompression_type == DT_ArrowText ? 3 : 2;
+		column->arrow = palloc0(sizeof(ArrowArray) + num_buffers * sizeof(void *));
+		column->arrow->buffers = (void *) &column->arrow[1];
+
+		reader->dcontext.compressed_chunk_columns[i] = (CompressionColumnDescription){
+			.type = COMPRESSED_COLUMN,
+			.typid = var->vartype,
+			.value_bytes = typlen,
+			.by_value = typbyval,
+			.uncompressed_chunk_attno = var->varattno,
+			.custom_scan_attno = var->varattno,
+			.bulk_decompression_supported = true,
+		};
+	}
+
+	/*
+	 * All rows of the batch pass the vectorized quals, because the child scan
+	 * node evaluates its quals before the tuples reach the batch reader.
+	 */
+	reader->vector_qual_result = palloc(sizeof(uint64) * num_batch_words);
+	memset(reader->vector_qual_result, -1, sizeof(uint64) * num_batch_words);
+
+	DecompressBatchState *batch_state =
+		palloc0(sizeof(DecompressBatchState) + sizeof(CompressedColumnValues) * num_columns);
+	batch_state->per_batch_context = create_arena_mctx(CurrentMemoryContext,
+													   "PlainBatchReader per-batch",
+													   0,
+													   64 * 1024,
+													   64 * 1024);
+
+	/*
+	 * Initialize the embedded tuple slot, following MakeTupleTableSlot() same
+	 * as the compressed batches do. The batch is passed around as this slot,
+	 * but the individual rows are never materialized into it by the
+	 * vectorized aggregation.
+	 */
+	TupleTableSlot *slot = &batch_state->decompressed_scan_slot_data.base;
+	slot->type = T_TupleTableSlot;
+	slot->tts_flags = TTS_FLAG_EMPTY | TTS_FLAG_FIXED;
+	slot->tts_tupleDescriptor = ExecGetResultType(child_state);
+	slot->tts_mcxt = CurrentMemoryContext;
+	slot->tts_nvalid = 0;
+	slot->tts_values = palloc0(MAXALIGN(slot->tts_tupleDescriptor->natts * sizeof(Datum)) +
+							   MAXALIGN(slot->tts_tupleDescriptor->natts * sizeof(bool)));
+	slot->tts_isnull = (bool *) ((char *) slot->tts_values) +
+					   MAXALIGN(slot->tts_tupleDescriptor->natts * sizeof(Datum));
+	memset(slot->tts_isnull, true, slot->tts_tupleDescriptor->natts * sizeof(bool));
+	*((const TupleTableSlotOps **) &slot->tts_ops) = &TTSOpsVirtual;
+	slot->tts_ops->init(slot);
+
+	reader->batch_state = batch_state;
+
+	vector_agg_state->plain_batch_reader = reader;
+	vector_agg_state->dcontext = &reader->dcontext;
+}
+
+static pg_attribute_always_inline void
+plain_batch_column_append(PlainBatchColumn *column, int row, Datum value, bool isnull)
+{
+	if (isnull)
+	{
+		arrow_set_row_validity(column->validity, row, false);
+		column->num_batch_nulls++;
+		if (column->decompression_type == DT_ArrowText)
+		{
+			/*
+			 * The Arrow format requires the offsets to monotonically increase
+			 * even for the invalid rows.
+			 */
+			column->offsets[row] = column->current_offset;
+		}
+		return;
+	}
+
+	switch ((int) column->decompression_type)
+	{
+		case DT_ArrowBits:
+		{
+			arrow_set_row_validity((uint64 *restrict) column->values,
+								   row,
+								   DatumGetBool(value));
+			break;
+		}
+		case DT_ArrowText:
+		{
+			/*
+			 * Unlike the decompressed data, the heap values can be toasted.
+			 * The detoasted copy goes to the per-batch memory context which is
+			 * the current one here.
+			 */
+			const struct varlena *detoasted = PG_DETOAST_DATUM_PACKED(value);
+			const int value_bytes = VARSIZE_ANY_EXHDR(detoasted);
+			const int required_body_bytes =
+				pad_to_multiple(64, column->current_offset + value_bytes);
+			if (required_body_bytes > column->allocated_body_bytes)
+			{
+				const int new_body_bytes = required_body_bytes * 2;
+				column->bodies = repalloc(column->bodies, new_body_bytes);
+				column->allocated_body_bytes = new_body_bytes;
+			}
+			memcpy(&column->bodies[column->current_offset], VARDATA_ANY(detoasted), value_bytes);
+			column->offsets[row] = column->current_offset;
+			column->current_offset += value_bytes;
+			break;
+		}
+		case 2:
+		case 4:
+#ifdef USE_FLOAT8_BYVAL
+		case 8:
+#endif
+			/*
+			 * Write out the entire datum for a possibly narrower column, the
+			 * buffer is padded to accommodate this. This matches how the
+			 * results of vectorized functions are converted.
+			 */
+			memcpy(row * column->decompression_type + column->values, &value, sizeof(Datum));
+			break;
+#ifndef USE_FLOAT8_BYVAL
+		case 8:
+#endif
+		case 16:
+			memcpy(row * column->decompression_type + column->values,
+				   DatumGetPointer(value),
+				   column->decompression_type);
+			break;
+		default:
+			elog(ERROR, "wrong plain batch column type %d", column->decompression_type);
+	}
+}
+
+/*
+ * Get the next slot to aggregate for a plain scan of an uncompressed chunk.
+ *
+ * Implements "get next slot" on top of a SeqScan child. Pulls the tuples from
+ * the child node through the normal executor interface and transposes them
+ * into a columnar batch.
+ */
+TupleTableSlot *
+plain_batch_get_next_slot(VectorAggState *vector_agg_state)
+{
+	PlainBatchReader *reader = vector_agg_state->plain_batch_reader;
+	DecompressBatchState *batch_state = reader->batch_state;
+	PlanState *child_state = linitial(vector_agg_state->custom.custom_ps);
+
+	MemoryContextReset(batch_state->per_batch_context);
+
+	const int num_batch_words = pad_to_multiple(64, TARGET_COMPRESSED_BATCH_SIZE) / 64;
+	for (int i = 0; i < reader->num_columns; i++)
+	{
+		PlainBatchColumn *column = &reader->columns[i];
+		memset(column->validity, -1, sizeof(uint64) * num_batch_words);
+		column->current_offset = 0;
+		column->num_batch_nulls = 0;
+	}
+
+	uint16 nrows = 0;
+	while (nrows < TARGET_COMPRESSED_BATCH_SIZE)
+	{
+		TupleTableSlot *child_slot = ExecProcNode(child_state);
+		if (TupIsNull(child_slot))
+		{
+			vector_agg_state->input_ended = true;
+			break;
+		}
+
+		/*
+		 * Deform the tuple once, then transpose the values into the column
+		 * buffers. The by-reference values are copied out immediately, so we
+		 * don't depend on the child slot contents after advancing it.
+		 */
+		slot_getsomeattrs(child_slot, reader->num_child_attrs);
+
+		MemoryContext old_context = MemoryContextSwitchTo(batch_state->per_batch_context);
+		for (int i = 0; i < reader->num_columns; i++)
+		{
+			PlainBatchColumn *column = &reader->columns[i];
+			const int attoff = AttrNumberGetAttrOffset(column->child_attno);
+			plain_batch_column_append(column,
+									  nrows,
+									  child_slot->tts_values[attoff],
+									  child_slot->tts_isnull[attoff]);
+		}
+		MemoryContextSwitchTo(old_context);
+
+		nrows++;
+	}
+
+	if (nrows == 0)
+	{
+		Assert(vector_agg_state->input_ended);
+		return NULL;
+	}
+
+	for (int i = 0; i < reader->num_columns; i++)
+	{
+		PlainBatchColumn *column = &reader->columns[i];
+
+		if (column->decompression_type == DT_ArrowText)
+		{
+			column->offsets[nrows] = column->current_offset;
+		}
+
+		ArrowArray *arrow = column->arrow;
+		arrow->length = nrows;
+		arrow->null_count = column->num_batch_nulls;
+		arrow->buffers[0] = column->validity;
+		if (column->decompression_type == DT_ArrowText)
+		{
+			arrow->buffers[1] = column->offsets;
+			arrow->buffers[2] = column->bodies;
+		}
+		else
+		{
+			arrow->buffers[1] = column->values;
+		}
+
+		batch_state->compressed_columns[i] = (CompressedColumnValues){
+			.decompression_type = column->decompression_type,
+			.buffers = { arrow->buffers[0],
+						 arrow->buffers[1],
+						 column->decompression_type == DT_ArrowText ? arrow->buffers[2] : NULL },
+			.arrow = arrow,
+		};
+	}
+
+	batch_state->total_batch_rows = nrows;
+	batch_state->next_batch_row = 0;
+	batch_state->vector_qual_result = reader->vector_qual_result;
+
+	return &batch_state->decompressed_scan_slot_data.base;
+}
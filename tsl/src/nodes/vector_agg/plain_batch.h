@@ -0,0 +1,20 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+#pragma once
+
+#include <postgres.h>
+
+#include "exec.h"
+
+/*
+ * The reader that batches the heap tuples of a plain uncompressed chunk scan
+ * into the in-memory columnar representation, so that the vectorized
+ * aggregation can work uniformly over compressed and uncompressed chunks.
+ */
+typedef struct PlainBatchReader PlainBatchReader;
+
+extern void plain_batch_reader_create(VectorAggState *vector_agg_state);
+extern TupleTableSlot *plain_batch_get_next_slot(VectorAggState *vector_agg_state);
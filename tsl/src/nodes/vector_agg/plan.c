@@ -5,6 +5,7 @@
  */
 #include <postgres.h>
 #include <access/attnum.h>
+#include <catalog/pg_class.h>
 #include <commands/explain.h>
 #include <executor/executor.h>
 #include <funcapi.h>
@@ -15,12 +16,16 @@
 #include <optimizer/planner.h>
 #include <parser/parsetree.h>
 #include <utils/fmgroids.h>
+#include <utils/lsyscache.h>
 
 #include "plan.h"
 
+#include "chunk.h"
 #include "exec.h"
 #include "expression_utils.h"
+#include "extension.h"
 #include "import/list.h"
+#include "nodes/gapfill/gapfill.h"
 #include "nodes/chunk_append/chunk_append.h"
 #include "nodes/columnar_scan/columnar_scan.h"
 #include "nodes/columnar_scan/vector_quals.h"
@@ -233,7 +238,8 @@ is_vector_expr(const VectorQualInfo *vqinfo, Expr *expr)
  * Whether we can vectorize this particular aggregate.
  */
 static bool
-can_vectorize_aggref(const VectorQualInfo *vqi, Aggref *aggref)
+can_vectorize_aggref(const VectorQualInfo *vqi, Aggref *aggref,
+					 VectorAggGroupingType grouping_type)
 {
 	if (aggref->aggdirectargs != NIL)
 	{
@@ -264,6 +270,78 @@ can_vectorize_aggref(const VectorQualInfo *vqi, Aggref *aggref)
 		aggref->aggfilter = (Expr *) aggfilter_vectorized;
 	}
 
+	if (list_length(aggref->args) == 2)
+	{
+		/*
+		 * The two-argument aggregates we support are the bookend aggregates
+		 * first() and last(). Their vectorized implementation keeps a single
+		 * running winner per aggregate state, so it is only wired up for the
+		 * per-batch grouping policy.
+		 */
+		if (grouping_type != VAGT_Batch)
+		{
+			return false;
+		}
+
+		TargetEntry *value_argument = castNode(TargetEntry, linitial(aggref->args));
+		TargetEntry *cmp_argument = castNode(TargetEntry, lsecond(aggref->args));
+		if (get_vector_bookend_aggregate(aggref->aggfnoid,
+										 exprType((Node *) cmp_argument->expr)) == NULL)
+		{
+			return false;
+		}
+
+		return is_vector_expr(vqi, value_argument->expr) &&
+			   is_vector_expr(vqi, cmp_argument->expr);
+	}
+
+	if (list_length(aggref->args) == 4)
+	{
+		/*
+		 * The four-argument aggregate we support is histogram(). Same as the
+		 * bookend aggregates, its vectorized implementation is only wired up
+		 * for the per-batch grouping policy. The bucket bounds and the number
+		 * of buckets must be non-null constants, because they parameterize
+		 * the aggregate state.
+		 */
+		if (grouping_type != VAGT_Batch)
+		{
+			return false;
+		}
+
+		if (get_vector_histogram_aggregate(aggref->aggfnoid) == NULL)
+		{
+			return false;
+		}
+
+		for (int i = 1; i < 4; i++)
+		{
+			Expr *arg = castNode(TargetEntry, list_nth(aggref->args, i))->expr;
+			if (!IsA(arg, Const) || castNode(Const, arg)->constisnull)
+			{
+				return false;
+			}
+		}
+
+		TargetEntry *value_argument = castNode(TargetEntry, linitial(aggref->args));
+		return is_vector_expr(vqi, value_argument->expr);
+	}
+
+	if (list_length(aggref->args) == 1 && grouping_type == VAGT_Batch)
+	{
+		/*
+		 * The approximate_count_distinct() aggregate. It uses the normal
+		 * one-argument kernel interface, but its sketch state is large, so it
+		 * is only wired up for the per-batch grouping policy.
+		 */
+		TargetEntry *value_argument = castNode(TargetEntry, linitial(aggref->args));
+		if (get_vector_hyperloglog_aggregate(aggref->aggfnoid,
+											 exprType((Node *) value_argument->expr)) != NULL)
+		{
+			return is_vector_expr(vqi, value_argument->expr);
+		}
+	}
+
 	if (get_vector_aggregate(aggref->aggfnoid) == NULL)
 	{
 		/*
@@ -283,7 +361,109 @@ can_vectorize_aggref(const VectorQualInfo *vqi, Aggref *aggref)
 	Assert(list_length(aggref->args) == 1);
 	TargetEntry *argument = castNode(TargetEntry, linitial(aggref->args));
 
-	return is_vector_expr(vqi, argument->expr);
+	if (is_vector_expr(vqi, argument->expr))
+	{
+		return true;
+	}
+
+	/*
+	 * Numeric is not a vector type in general, because the same value can have
+	 * many binary representations, so we can't group by it or evaluate the
+	 * vectorized quals. Still, the sum and avg aggregates have a specialized
+	 * vectorized implementation that parses the numerics row by row, so a
+	 * plain reference to a decompressible numeric column is a valid argument.
+	 */
+	if (IsA(argument->expr, Var))
+	{
+		Var *var = castNode(Var, argument->expr);
+		return var->varattno > 0 && var->vartype == NUMERICOID && vqi->vector_attrs &&
+			   vqi->vector_attrs[var->varattno];
+	}
+
+	return false;
+}
+
+/*
+ * Rewrite a time_bucket_gapfill() grouping call to the equivalent
+ * time_bucket() call.
+ *
+ * The gapfill bucketing function is deliberately declared volatile and
+ * non-strict so that the planner does not optimize the call away before the
+ * gapfill node is planned, but this also disqualifies it from the vectorized
+ * expression pipeline. By the time this hook runs, the gapfill planning has
+ * already happened, and at execution the call computes plain time_bucket()
+ * over the first two arguments, ignoring the gap-filling bounds. The
+ * time_bucket() equivalent is immutable and strict with identical per-row
+ * results, so the aggregation below gapfill can run vectorized.
+ */
+static Expr *
+try_rewrite_gapfill_bucket(Expr *expr)
+{
+	if (!IsA(expr, FuncExpr))
+	{
+		return expr;
+	}
+
+	FuncExpr *func = castNode(FuncExpr, expr);
+
+	/*
+	 * The variant with a timezone argument has five arguments and maps to a
+	 * non-strict time_bucket() overload that the vectorized pipeline cannot
+	 * evaluate, so only the four-argument variants (bucket_width, ts, start,
+	 * finish) are handled.
+	 */
+	if (list_length(func->args) != 4)
+	{
+		return expr;
+	}
+
+	const char *func_name = get_func_name(func->funcid);
+	if (func_name == NULL || strncmp(func_name, GAPFILL_FUNCTION, NAMEDATALEN) != 0)
+	{
+		return expr;
+	}
+
+	Expr *width = linitial(func->args);
+	Expr *ts = lsecond(func->args);
+	Oid argtypes[2] = { exprType((Node *) width), exprType((Node *) ts) };
+
+	/*
+	 * Check against the known time_bucket() signatures, so that the function
+	 * lookup below cannot fail.
+	 */
+	switch (argtypes[1])
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			if (argtypes[0] != argtypes[1])
+			{
+				return expr;
+			}
+			break;
+		case DATEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			if (argtypes[0] != INTERVALOID)
+			{
+				return expr;
+			}
+			break;
+		default:
+			return expr;
+	}
+
+	Oid bucket_funcid = ts_get_function_oid("time_bucket",
+											ts_extension_schema_name(),
+											lengthof(argtypes),
+											argtypes);
+
+	return (Expr *) makeFuncExpr(bucket_funcid,
+								 func->funcresulttype,
+								 list_make2(width, ts),
+								 InvalidOid,
+								 InvalidOid,
+								 COERCE_EXPLICIT_CALL);
 }
 
 /*
@@ -306,6 +486,12 @@ get_vectorized_grouping_type(const VectorQualInfo *vqinfo, Agg *agg, List *resol
 	int16 typlen = 0;
 	bool typbyval = false;
 
+	/*
+	 * Whether all grouping columns are fixed-size by-value types that we can
+	 * pack into one hash table key.
+	 */
+	bool all_fixed_byval = true;
+
 	ListCell *lc;
 	foreach (lc, resolved_targetlist)
 	{
@@ -339,24 +525,37 @@ get_vectorized_grouping_type(const VectorQualInfo *vqinfo, Agg *agg, List *resol
 		}
 
 		/*
-		 * If we have a single grouping column, record it for the additional
-		 * checks later.
+		 * Determine the type of the grouping column, to decide which hashing
+		 * strategies are applicable.
 		 */
-		if (num_grouping_columns != 1)
-		{
-			continue;
-		}
-
+		Oid column_type = InvalidOid;
 		TupleDesc tdesc = NULL;
 		TypeFuncClass type_class =
-			get_expr_result_type((Node *) target_entry->expr, &single_grouping_var_type, &tdesc);
+			get_expr_result_type((Node *) target_entry->expr, &column_type, &tdesc);
 		if (type_class != TYPEFUNC_SCALAR)
 		{
+			all_fixed_byval = false;
 			continue;
 		}
 
-		get_typlenbyval(single_grouping_var_type, &typlen, &typbyval);
-		Ensure(typlen != 0, "invalid zero typlen for type %d", single_grouping_var_type);
+		int16 column_typlen = 0;
+		bool column_typbyval = false;
+		get_typlenbyval(column_type, &column_typlen, &column_typbyval);
+		Ensure(column_typlen != 0, "invalid zero typlen for type %d", column_type);
+
+		all_fixed_byval &= column_typbyval &&
+						   (column_typlen == 2 || column_typlen == 4 || column_typlen == 8);
+
+		/*
+		 * If we have a single grouping column, record it for the additional
+		 * checks later.
+		 */
+		if (num_grouping_columns == 1)
+		{
+			single_grouping_var_type = column_type;
+			typlen = column_typlen;
+			typbyval = column_typbyval;
+		}
 	}
 
 	Assert(num_grouping_columns >= agg->numCols);
@@ -421,6 +620,16 @@ get_vectorized_grouping_type(const VectorQualInfo *vqinfo, Agg *agg, List *resol
 #endif
 	}
 
+	/*
+	 * We support hashed grouping by two fixed-size by-value columns, packed
+	 * into one hash table key. This covers the typical GROUP BY over two id
+	 * columns, which would otherwise use the slower serialized key strategy.
+	 */
+	if (num_grouping_columns == 2 && all_fixed_byval)
+	{
+		return VAGT_HashTwoFixed;
+	}
+
 #ifdef TS_USE_UMASH
 	/*
 	 * Use hashing of serialized keys when we have many grouping columns.
@@ -466,31 +675,138 @@ has_vector_agg_node(Plan *plan, bool *has_some_agg)
 }
 
 /*
- * Check if a VectorAgg is possible on top of the given child plan.
+ * Build the vectorized qual info for a plain scan of an uncompressed chunk.
  *
- * If the child plan is compatible, also initialize the VectorQualInfo struct
- * for aggregation FILTER clauses.
- *
- * Returns true if the scan node is a supported child, otherwise false.
+ * The chunks that are not yet converted to columnstore hold the most recent
+ * data of a hypertable, which is exactly what the real-time queries tend to
+ * aggregate. We can still use the vectorized aggregation for them, by
+ * batching the heap tuples into the in-memory columnar representation at
+ * execution time.
  */
 static bool
-vectoragg_plan_possible(Plan *childplan, VectorQualInfo *vqi)
+vectoragg_plan_plain_scan(Plan *childplan, List *rtable, VectorQualInfo *vqi)
 {
-	if (!IsA(childplan, CustomScan))
+	const Index scanrelid = castNode(SeqScan, childplan)->scan.scanrelid;
+
+	if (rtable == NIL)
+	{
+		return false;
+	}
+
+	RangeTblEntry *rte = rt_fetch(scanrelid, rtable);
+	if (rte->rtekind != RTE_RELATION || rte->relkind != RELKIND_RELATION)
+	{
 		return false;
+	}
 
-	if (childplan->qual != NIL)
+	/*
+	 * Only consider the chunks of hypertables, so that we don't alter the
+	 * plans of the unrelated Postgres queries.
+	 */
+	if (ts_chunk_get_hypertable_id_by_reloid(rte->relid) == INVALID_HYPERTABLE_ID)
 	{
-		/* Can't do vectorized aggregation if we have Postgres quals. */
 		return false;
 	}
 
-	if (ts_is_columnar_scan_plan(childplan))
+	/*
+	 * The scan output must consist of plain chunk Vars, for the plain batch
+	 * reader to be able to map them to the chunk columns. A physical
+	 * targetlist can also contain null Consts in place of the dropped
+	 * columns, these are never referenced and can be skipped.
+	 */
+	AttrNumber maxattno = 0;
+	ListCell *lc;
+	foreach (lc, childplan->targetlist)
+	{
+		TargetEntry *target_entry = lfirst_node(TargetEntry, lc);
+		if (IsA(target_entry->expr, Const))
+		{
+			continue;
+		}
+
+		if (!IsA(target_entry->expr, Var))
+		{
+			return false;
+		}
+
+		Var *var = castNode(Var, target_entry->expr);
+		if ((Index) var->varno != scanrelid || var->varattno <= 0)
+		{
+			return false;
+		}
+
+		if (var->varattno > maxattno)
+		{
+			maxattno = var->varattno;
+		}
+	}
+
+	vqi->rti = scanrelid;
+	vqi->reverse = false;
+	vqi->maxattno = maxattno;
+	vqi->vector_attrs = (bool *) palloc0(sizeof(bool) * (maxattno + 1));
+
+	/*
+	 * There is no notion of segmentby columns in an uncompressed chunk, so
+	 * this array stays all-false and the planning falls through to the hash
+	 * grouping strategies.
+	 */
+	vqi->segmentby_attrs = (bool *) palloc0(sizeof(bool) * (maxattno + 1));
+
+	foreach (lc, childplan->targetlist)
+	{
+		TargetEntry *target_entry = lfirst_node(TargetEntry, lc);
+		if (IsA(target_entry->expr, Var))
+		{
+			Var *var = castNode(Var, target_entry->expr);
+			/*
+			 * The plain batch reader treats numeric as a generic varlena, so
+			 * it can feed the specialized numeric aggregates even though it
+			 * is not a vector type.
+			 */
+			vqi->vector_attrs[var->varattno] =
+				is_vector_type(var->vartype) || var->vartype == NUMERICOID;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * Check if a VectorAgg is possible on top of the given child plan.
+ *
+ * If the child plan is compatible, also initialize the VectorQualInfo struct
+ * for aggregation FILTER clauses.
+ *
+ * Returns true if the scan node is a supported child, otherwise false.
+ */
+static bool
+vectoragg_plan_possible(Plan *childplan, List *rtable, VectorQualInfo *vqi)
+{
+	if (IsA(childplan, CustomScan) && ts_is_columnar_scan_plan(childplan))
 	{
+		if (childplan->qual != NIL)
+		{
+			/* Can't do vectorized aggregation if we have Postgres quals. */
+			return false;
+		}
+
 		vectoragg_plan_columnar_scan(childplan, vqi);
 		return true;
 	}
 
+	/*
+	 * A plain scan of an uncompressed chunk can also feed the vectorized
+	 * aggregation, through the reader that batches the heap tuples into the
+	 * columnar representation. Note that unlike for ColumnarScan, the
+	 * Postgres quals are not a problem here, because the scan node evaluates
+	 * them itself before the tuples are batched.
+	 */
+	if (IsA(childplan, SeqScan))
+	{
+		return vectoragg_plan_plain_scan(childplan, rtable, vqi);
+	}
+
 	return false;
 }
 
@@ -562,17 +878,42 @@ make_finalize_agg_mutator(Node *node, void *context)
 	return expression_tree_mutator(node, make_finalize_agg_mutator, context);
 }
 
+typedef struct InsertVectorAggContext
+{
+	List *rtable;
+	/* Optional, collects counters for the fast-path planning log. */
+	VectorAggPlanStats *stats;
+} InsertVectorAggContext;
+
 static Plan *insert_vector_agg(Plan *plan, void *context);
 
 Plan *
-try_insert_vector_agg_node(Plan *plan)
+try_insert_vector_agg_node(Plan *plan, List *rtable, VectorAggPlanStats *stats)
+{
+	InsertVectorAggContext context = { .rtable = rtable, .stats = stats };
+	return ts_plan_tree_walker(plan, insert_vector_agg, &context);
+}
+
+/*
+ * Record the rejection of an aggregation node that was a candidate for
+ * vectorization, so that it can be reported by the fast-path planning log.
+ */
+static Plan *
+vectoragg_reject(Plan *plan, VectorAggPlanStats *stats, const char *reason)
 {
-	return ts_plan_tree_walker(plan, insert_vector_agg, NULL);
+	if (stats != NULL)
+	{
+		stats->rejected_count++;
+		stats->last_reject_reason = reason;
+	}
+	return plan;
 }
 
 static Plan *
 insert_vector_agg(Plan *plan, void *context)
 {
+	InsertVectorAggContext *ctx = (InsertVectorAggContext *) context;
+
 	if (!IsA(plan, Agg))
 	{
 		return plan;
@@ -582,14 +923,18 @@ insert_vector_agg(Plan *plan, void *context)
 
 	if (agg->aggsplit != AGGSPLIT_INITIAL_SERIAL && agg->aggsplit != AGGSPLIT_SIMPLE)
 	{
-		/* Can only vectorize partial or non-partial aggregation node. */
+		/*
+		 * Can only vectorize partial or non-partial aggregation node. This is
+		 * not counted as a rejection, because it covers e.g. the finalize step
+		 * above an already vectorized partial.
+		 */
 		return plan;
 	}
 
 	if (agg->groupingSets != NIL)
 	{
 		/* No GROUPING SETS support. */
-		return plan;
+		return vectoragg_reject(plan, ctx->stats, "GROUPING SETS are not supported");
 	}
 
 	if (agg->plan.qual != NIL)
@@ -599,7 +944,7 @@ insert_vector_agg(Plan *plan, void *context)
 		 * because we only replace the partial aggregation nodes which can't
 		 * check the HAVING clause.
 		 */
-		return plan;
+		return vectoragg_reject(plan, ctx->stats, "HAVING clause is not supported");
 	}
 	if (agg->plan.lefttree == NULL)
 	{
@@ -607,7 +952,7 @@ insert_vector_agg(Plan *plan, void *context)
 		 * Not sure what this would mean, but check for it just to be on the
 		 * safe side because we can effectively see any possible plan here.
 		 */
-		return plan;
+		return vectoragg_reject(plan, ctx->stats, "aggregation node has no child plan");
 	}
 
 	Plan *childplan = agg->plan.lefttree;
@@ -618,10 +963,10 @@ insert_vector_agg(Plan *plan, void *context)
 	 * Build supplementary info to determine whether we can vectorize the
 	 * aggregate FILTER clauses.
 	 */
-	if (!vectoragg_plan_possible(childplan, &vqi))
+	if (!vectoragg_plan_possible(childplan, ctx->rtable, &vqi))
 	{
 		/* Not a compatible vectoragg child node */
-		return plan;
+		return vectoragg_reject(plan, ctx->stats, "child plan cannot supply vectorized data");
 	}
 
 	/*
@@ -631,12 +976,26 @@ insert_vector_agg(Plan *plan, void *context)
 	 */
 	List *resolved_targetlist = ts_resolve_outer_special_vars(agg->plan.targetlist, childplan);
 
+	/*
+	 * A time_bucket_gapfill() grouping call would disqualify the aggregation
+	 * from vectorization because of its volatile marker, so rewrite it to the
+	 * equivalent time_bucket() call. Only the top level of a target entry has
+	 * to be considered, because the gapfill planning requires the call to be
+	 * a top-level GROUP BY expression.
+	 */
+	ListCell *lc;
+	foreach (lc, resolved_targetlist)
+	{
+		TargetEntry *target_entry = lfirst_node(TargetEntry, lc);
+		target_entry->expr = try_rewrite_gapfill_bucket(target_entry->expr);
+	}
+
 	const VectorAggGroupingType grouping_type =
 		get_vectorized_grouping_type(&vqi, agg, resolved_targetlist);
 	if (grouping_type == VAGT_Invalid)
 	{
 		/* The grouping is not vectorizable. */
-		return plan;
+		return vectoragg_reject(plan, ctx->stats, "grouping is not vectorizable");
 	}
 
 	/*
@@ -648,22 +1007,25 @@ insert_vector_agg(Plan *plan, void *context)
 	{
 		if (vqi.reverse)
 		{
-			return plan;
+			return vectoragg_reject(plan,
+									ctx->stats,
+									"hash grouping cannot preserve the reverse ordering");
 		}
 	}
 
 	/* Now check the output targetlist. */
-	ListCell *lc;
 	foreach (lc, resolved_targetlist)
 	{
 		TargetEntry *target_entry = lfirst_node(TargetEntry, lc);
 		if (IsA(target_entry->expr, Aggref))
 		{
 			Aggref *aggref = castNode(Aggref, target_entry->expr);
-			if (!can_vectorize_aggref(&vqi, aggref))
+			if (!can_vectorize_aggref(&vqi, aggref, grouping_type))
 			{
 				/* Aggregate function not vectorizable. */
-				return plan;
+				return vectoragg_reject(plan,
+										ctx->stats,
+										"aggregate function is not vectorizable");
 			}
 		}
 	}
@@ -675,6 +1037,11 @@ insert_vector_agg(Plan *plan, void *context)
 	Plan *vector_agg_plan =
 		vector_agg_plan_create(childplan, agg, resolved_targetlist, grouping_type);
 
+	if (ctx->stats != NULL)
+	{
+		ctx->stats->vectorized_count++;
+	}
+
 	if (agg->aggsplit == AGGSPLIT_SIMPLE)
 	{
 		/*
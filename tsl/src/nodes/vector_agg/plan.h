@@ -18,8 +18,26 @@ typedef enum
 	VASI_Count
 } VectorAggSettingsIndex;
 
+/*
+ * Counters collected while trying to vectorize the aggregation nodes of one
+ * statement, reported by the timescaledb.log_fastpath_decisions facility.
+ */
+typedef struct VectorAggPlanStats
+{
+	/* Number of VectorAgg nodes inserted into the plan. */
+	int vectorized_count;
+	/*
+	 * Number of aggregation nodes that were candidates for vectorization but
+	 * had to be rejected. Aggregation nodes that cannot be considered at all,
+	 * e.g. the finalize step above a vectorized partial, are not counted.
+	 */
+	int rejected_count;
+	/* Human-readable reason for the last rejection, or NULL. */
+	const char *last_reject_reason;
+} VectorAggPlanStats;
+
 extern void _vector_agg_init(void);
 extern void vectoragg_plan_columnar_scan(Plan *childplan, VectorQualInfo *vqi);
-Plan *try_insert_vector_agg_node(Plan *plan);
+Plan *try_insert_vector_agg_node(Plan *plan, List *rtable, VectorAggPlanStats *stats);
 bool has_vector_agg_node(Plan *plan, bool *has_some_agg);
 bool ts_is_vector_agg_plan(Plan *plan);
@@ -18,6 +18,7 @@
 #include "chunk.h"
 #include "chunkwise_agg.h"
 #include "continuous_aggs/planner.h"
+#include "expression_utils.h"
 #include "guc.h"
 #include "hypertable.h"
 #include "nodes/columnar_index_scan/columnar_index_scan.h"
@@ -293,12 +294,87 @@ tsl_sort_transform_replace_pathkeys(void *path, List *transformed_pathkeys, List
 	}
 }
 
+typedef struct FastPathScanCounts
+{
+	List *rtable;
+	/* Number of ColumnarScan nodes in the plan. */
+	int columnar_scans;
+	/* Number of row-by-row scan nodes over hypertable chunks. */
+	int chunk_row_scans;
+} FastPathScanCounts;
+
+static Plan *
+count_fastpath_scans(Plan *plan, void *context)
+{
+	FastPathScanCounts *counts = (FastPathScanCounts *) context;
+
+	if (ts_is_columnar_scan_plan(plan))
+	{
+		counts->columnar_scans++;
+		return plan;
+	}
+
+	if (IsA(plan, SeqScan) || IsA(plan, IndexScan) || IsA(plan, IndexOnlyScan) ||
+		IsA(plan, BitmapHeapScan))
+	{
+		const Index scanrelid = ((Scan *) plan)->scanrelid;
+		const RangeTblEntry *rte = rt_fetch(scanrelid, counts->rtable);
+		if (rte->rtekind == RTE_RELATION &&
+			ts_chunk_get_hypertable_id_by_reloid(rte->relid) != INVALID_HYPERTABLE_ID)
+		{
+			counts->chunk_row_scans++;
+		}
+	}
+
+	return plan;
+}
+
+/*
+ * Log a one-line summary of the fast-path planning decisions for this
+ * statement, keyed by the query identifier, so that the fast-path coverage
+ * can be diffed across releases (e.g. joined against pg_stat_statements by
+ * the query id). Enabled by the timescaledb.log_fastpath_decisions GUC.
+ *
+ * Note that the query identifier is zero unless compute_query_id is enabled
+ * or a module like pg_stat_statements computes it.
+ */
+static void
+fastpath_log_summary(const PlannedStmt *stmt, const VectorAggPlanStats *vastats)
+{
+	FastPathScanCounts counts = { .rtable = stmt->rtable };
+	ts_plan_tree_walker(stmt->planTree, count_fastpath_scans, &counts);
+	ts_plan_tree_walker((Plan *) stmt->subplans, count_fastpath_scans, &counts);
+
+	/* Don't spam the log for the queries that don't touch hypertable chunks. */
+	if (counts.columnar_scans == 0 && counts.chunk_row_scans == 0 &&
+		vastats->vectorized_count == 0 && vastats->rejected_count == 0)
+	{
+		return;
+	}
+
+	ereport(LOG,
+			(errmsg("hypertable query fast-path summary: query_id " INT64_FORMAT
+					", columnar_scans %d, chunk_row_scans %d, vectorized_aggs %d, "
+					"rejected_aggs %d",
+					(int64) stmt->queryId,
+					counts.columnar_scans,
+					counts.chunk_row_scans,
+					vastats->vectorized_count,
+					vastats->rejected_count),
+			 vastats->last_reject_reason != NULL ?
+				 errdetail("Last vectorized aggregation rejection: %s.",
+						   vastats->last_reject_reason) :
+				 0));
+}
+
 /*
  * Run plan postprocessing optimizations.
  */
 void
 tsl_postprocess_plan(PlannedStmt *stmt)
 {
+	VectorAggPlanStats vastats = { 0 };
+
 	if (ts_guc_enable_columnarindexscan)
 	{
 		ts_columnar_index_scan_fix_aggrefs(stmt->planTree);
@@ -306,8 +382,14 @@ tsl_postprocess_plan(PlannedStmt *stmt)
 
 	if (ts_guc_enable_vectorized_aggregation)
 	{
-		stmt->planTree = try_insert_vector_agg_node(stmt->planTree);
-		stmt->subplans = (List *) try_insert_vector_agg_node((Plan *) stmt->subplans);
+		stmt->planTree = try_insert_vector_agg_node(stmt->planTree, stmt->rtable, &vastats);
+		stmt->subplans =
+			(List *) try_insert_vector_agg_node((Plan *) stmt->subplans, stmt->rtable, &vastats);
+	}
+
+	if (ts_guc_log_fastpath_decisions)
+	{
+		fastpath_log_summary(stmt, &vastats);
 	}
 
 #ifdef TS_DEBUG
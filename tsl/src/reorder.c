@@ -40,7 +40,9 @@
 #include <nodes/pg_list.h>
 #include <optimizer/planner.h>
 #include <storage/bufmgr.h>
+#include <storage/latch.h>
 #include <storage/lmgr.h>
+#include <storage/lock.h>
 #include <storage/lockdefs.h>
 #include <storage/predicate.h>
 #include <storage/smgr.h>
@@ -57,6 +59,7 @@
 #include <utils/snapmgr.h>
 #include <utils/syscache.h>
 #include <utils/tuplesort.h>
+#include <utils/wait_event.h>
 
 #include <access/toast_internals.h>
 
@@ -71,6 +74,8 @@ static void reorder_rel(Oid tableOid, Oid indexOid, bool verbose, Oid wait_id,
 						Oid destination_tablespace, Oid index_tablespace);
 
 #define REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT "101000"
+#define REORDER_SWAP_LOCK_WAIT_INTERVAL 50 /* ms */
+#define REORDER_SWAP_LOCK_TIMEOUT 5000	   /* ms */
 
 static void rebuild_relation(Relation OldHeap, Oid indexOid, bool verbose, Oid wait_id,
 							 Oid destination_tablespace, Oid index_tablespace);
@@ -478,7 +483,8 @@ reorder_finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, char relpersistence, L
 	ListCell *old_index_cell;
 	ListCell *new_index_cell;
 	Oid mapped_tables[4];
-	int config_change;
+	LOCKTAG heaplocktag;
+	int lock_retry = 0;
 
 #ifdef DEBUG
 
@@ -496,38 +502,78 @@ reorder_finish_heap_swaps(Oid OIDOldHeap, Oid OIDNewHeap, char relpersistence, L
 #endif
 
 	/*
-	 * There's a risk of deadlock if some other process is also trying to
-	 * upgrade their lock in the same manner as us, at this time. Since our
-	 * transaction has performed a large amount of work, and only needs to be
-	 * run once per chunk, we do not want to abort it due to this deadlock. To
-	 * prevent abort we set our `deadlock_timeout` to a large value in the
-	 * expectation that the other process will timeout and abort first.
-	 * Currently we set `deadlock_timeout` to 1 hour, as this should be longer
-	 * than any other normal process, while still allowing the system to make
-	 * progress in the event of a real deadlock. As this is the last lock we
-	 * grab, and the setting is local to our transaction we do not bother
-	 * changing the guc back.
+	 * Upgrade to an AccessExclusiveLock for the heap swap. A plain blocking
+	 * request would queue behind any long-running query on the chunk, and
+	 * every query arriving after us would in turn queue behind our request,
+	 * so a single straggling reader would stall all traffic on the chunk for
+	 * its remaining runtime. Instead we poll for the lock, which leaves
+	 * queries arriving in the meantime unaffected and keeps the exclusive
+	 * window down to the swap itself.
 	 */
-	config_change = set_config_option("deadlock_timeout",
-									  REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT,
-									  PGC_SUSET,
-									  PGC_S_SESSION,
-									  GUC_ACTION_LOCAL,
-									  true,
-									  0,
-									  false);
-
-	if (config_change == 0)
-		ereport(ERROR,
-				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-				 errmsg("deadlock_timeout guc does not exist.")));
-	else if (config_change < 0)
-		ereport(ERROR,
-				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
-				 errmsg("could not set deadlock_timeout guc.")));
+	SET_LOCKTAG_RELATION(heaplocktag, MyDatabaseId, OIDOldHeap);
 
-	/* Upgrade to an AccessExclusiveLock for the heap swap */
-	LockRelationOid(OIDOldHeap, AccessExclusiveLock);
+	while (!ConditionalLockRelationOid(OIDOldHeap, AccessExclusiveLock))
+	{
+		/*
+		 * Check for interrupts while trying to (re-)acquire the exclusive
+		 * lock.
+		 */
+		CHECK_FOR_INTERRUPTS();
+
+		/*
+		 * Once someone queues behind the ExclusiveLock we already hold,
+		 * polling no longer keeps anyone online: it only hides us from the
+		 * deadlock detector, which must see our lock upgrade to resolve
+		 * upgrade deadlocks in our favor. The same holds if the chunk never
+		 * becomes free within the polling window. In both cases we fall
+		 * through to a blocking request rather than throw away the completed
+		 * rewrite.
+		 */
+		if (LockWaiterCount(&heaplocktag) == 0 &&
+			++lock_retry <= (REORDER_SWAP_LOCK_TIMEOUT / REORDER_SWAP_LOCK_WAIT_INTERVAL))
+		{
+			(void) WaitLatch(MyLatch,
+							 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							 REORDER_SWAP_LOCK_WAIT_INTERVAL,
+							 WAIT_EVENT_VACUUM_TRUNCATE);
+			ResetLatch(MyLatch);
+			continue;
+		}
+
+		/*
+		 * There's a risk of deadlock if some other process is also trying to
+		 * upgrade their lock in the same manner as us, at this time. Since
+		 * our transaction has performed a large amount of work, and only
+		 * needs to be run once per chunk, we do not want to abort it due to
+		 * this deadlock. To prevent abort we set our `deadlock_timeout` to a
+		 * large value in the expectation that the other process will timeout
+		 * and abort first. Currently we set `deadlock_timeout` to 1 hour, as
+		 * this should be longer than any other normal process, while still
+		 * allowing the system to make progress in the event of a real
+		 * deadlock. As this is the last lock we grab, and the setting is
+		 * local to our transaction we do not bother changing the guc back.
+		 */
+		int config_change = set_config_option("deadlock_timeout",
+											  REORDER_ACCESS_EXCLUSIVE_DEADLOCK_TIMEOUT,
+											  PGC_SUSET,
+											  PGC_S_SESSION,
+											  GUC_ACTION_LOCAL,
+											  true,
+											  0,
+											  false);
+
+		if (config_change == 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("deadlock_timeout guc does not exist.")));
+		else if (config_change < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("could not set deadlock_timeout guc.")));
+
+		LockRelationOid(OIDOldHeap, AccessExclusiveLock);
+		break;
+	}
 
 	/* Swap the contents of the indexes */
 	Assert(list_length(old_index_oids) == list_length(new_index_oids));
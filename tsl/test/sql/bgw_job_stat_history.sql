@@ -173,6 +173,27 @@ FROM _timescaledb_internal.bgw_job_stat_history
 WHERE job_id = :job_id_3
 ORDER BY id;
 
+-- Scheduling delay is captured in the history for scheduled runs. The
+-- first run of a job has no planned start to compare against, so the
+-- delay starts showing up from the second run on.
+SELECT job_id, succeeded, data ? 'scheduling_delay' AS has_scheduling_delay,
+       (data->>'scheduling_delay')::interval >= '0'::interval AS delay_not_negative
+FROM _timescaledb_internal.bgw_job_stat_history
+WHERE job_id = :job_id_3
+ORDER BY id;
+
+-- The latency stats view aggregates the history; the exact latencies
+-- depend on timing, so only check the derived invariants
+SELECT job_id, proc_name, total_runs, total_successes, total_failures,
+       consecutive_failures,
+       avg_scheduling_delay >= '0'::interval AS avg_delay_not_negative,
+       max_scheduling_delay >= avg_scheduling_delay AS max_at_least_avg,
+       median_run_duration <= p95_run_duration AS median_le_p95,
+       p95_run_duration <= max_run_duration AS p95_le_max
+FROM timescaledb_information.job_latency_stats
+WHERE job_id >= 1000
+ORDER BY job_id;
+
 SELECT delete_job(:job_id_1);
 SELECT delete_job(:job_id_2);
 SELECT delete_job(:job_id_3);
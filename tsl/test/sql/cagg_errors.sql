@@ -432,10 +432,6 @@ select add_continuous_aggregate_policy('i2980_cagg',NULL,NULL,'4h') AS job_id \g
 \set ON_ERROR_STOP 0
 select alter_job(:job_id,config:='{"end_offset": null, "start_offset": null, "mat_hypertable_id": 1000}');
 
---test creating continuous aggregate with compression enabled --
-CREATE MATERIALIZED VIEW  i2980_cagg2 with (timescaledb.continuous, timescaledb.materialized_only=false, timescaledb.compress)
-AS SELECT time_bucket('1h',time), avg(7) FROM i2980 GROUP BY 1;
-
 --this one succeeds
 CREATE MATERIALIZED VIEW  i2980_cagg2 with (timescaledb.continuous, timescaledb.materialized_only=false)
 AS SELECT time_bucket('1h',time) as bucket, avg(7) FROM i2980 GROUP BY 1;
@@ -504,3 +500,14 @@ CREATE MATERIALIZED VIEW cagg1 WITH (timescaledb.continuous, timescaledb.materia
 
 -- No FROM clause in CAGG definition
 CREATE MATERIALIZED VIEW cagg1 with (timescaledb.continuous, timescaledb.materialized_only=false) AS SELECT 1 GROUP BY 1 WITH NO DATA;
+
+-- creating a continuous aggregate with columnstore enabled should derive
+-- segmentby from the grouping columns and orderby from the bucket column
+CREATE TABLE metrics(time timestamptz NOT NULL, device int, value float);
+SELECT table_name FROM create_hypertable('metrics','time');
+CREATE MATERIALIZED VIEW metrics_cagg WITH (timescaledb.continuous, timescaledb.materialized_only=false, timescaledb.compress)
+AS SELECT time_bucket('1h', time) AS bucket, device, avg(value) FROM metrics GROUP BY 1, 2 WITH NO DATA;
+SELECT segmentby, orderby FROM timescaledb_information.hypertable_columnstore_settings
+WHERE hypertable = (
+  SELECT format('%I.%I', materialization_hypertable_schema, materialization_hypertable_name)::regclass
+  FROM timescaledb_information.continuous_aggregates WHERE view_name = 'metrics_cagg');
@@ -0,0 +1,36 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- For unordered serial scans of a partially compressed chunk, the
+-- ColumnarScan node streams the uncompressed tail itself after the
+-- compressed batches instead of planning the chunk as an Append of two
+-- scans.
+
+create table tailscan(ts int not null, device int, val float8);
+select create_hypertable('tailscan', 'ts', chunk_time_interval => 10000);
+alter table tailscan set (timescaledb.compress, timescaledb.compress_segmentby = 'device',
+    timescaledb.compress_orderby = 'ts');
+insert into tailscan select i, i % 3, i * 0.1 from generate_series(1, 3000) i;
+select count(compress_chunk(x)) from show_chunks('tailscan') x;
+-- Make the chunk partially compressed.
+insert into tailscan select i, i % 3, i * 0.1 from generate_series(3001, 3300) i;
+vacuum analyze tailscan;
+
+-- No Append, the chunk plans as a single ColumnarScan with the tail scan.
+explain (verbose, buffers off, costs off) select ts from tailscan;
+
+-- The tail rows flow through the same node as the compressed batches.
+explain (analyze, buffers off, costs off, summary off, timing off) select ts from tailscan;
+
+-- The vectorized quals are rechecked row by row on the tail tuples.
+explain (buffers off, costs off) select * from tailscan where ts > 2900;
+select count(*), min(ts), max(ts) from tailscan;
+select count(*), min(ts), max(ts) from tailscan where ts > 2900;
+
+-- Disabling the tail scan restores the Append of the two scans.
+set timescaledb.enable_columnarscan_tail_scan to off;
+explain (buffers off, costs off) select ts from tailscan;
+select count(*), min(ts), max(ts) from tailscan;
+select count(*), min(ts), max(ts) from tailscan where ts > 2900;
+reset timescaledb.enable_columnarscan_tail_scan;
@@ -0,0 +1,43 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- Adaptive codec selection trial-compresses the first full batch of each
+-- column with the alternative codec for its type and keeps whichever output
+-- is smaller for the rest of the compression run.
+create table adaptive(ts int not null, val bigint);
+select create_hypertable('adaptive', 'ts');
+alter table adaptive set (timescaledb.compress, timescaledb.compress_segmentby = '', timescaledb.compress_orderby = 'ts');
+
+-- Long runs of unrelated wide values: rle stores one datum per run while
+-- deltadelta pays for a full-width simple8b slot at every run boundary.
+insert into adaptive select i, mod((i / 100)::numeric * 768614336404564651, 4611686018427387904)::bigint from generate_series(1, 3000) i;
+create table adaptive_orig as select * from adaptive;
+
+-- With adaptive compression disabled (the default) the column keeps the
+-- default codec for its type.
+select count(compress_chunk(x)) from show_chunks('adaptive') x;
+select format('%I.%I', schema_name, table_name) as "COMPRESSED_CHUNK" from _timescaledb_catalog.chunk where compressed_chunk_id is null order by id desc limit 1 \gset
+select distinct (_timescaledb_functions.compressed_data_info(val)).algorithm from :COMPRESSED_CHUNK;
+
+select count(decompress_chunk(x)) from show_chunks('adaptive') x;
+
+set timescaledb.enable_adaptive_compression = on;
+set timescaledb.enable_rle_compression = on;
+select count(compress_chunk(x)) from show_chunks('adaptive') x;
+select format('%I.%I', schema_name, table_name) as "COMPRESSED_CHUNK" from _timescaledb_catalog.chunk where compressed_chunk_id is null order by id desc limit 1 \gset
+
+-- The rle candidate wins the trial for the run-length friendly column.
+select distinct (_timescaledb_functions.compressed_data_info(val)).algorithm from :COMPRESSED_CHUNK;
+
+-- The orderby column keeps deltadelta: rle loses the trial on a monotonic
+-- sequence.
+select distinct (_timescaledb_functions.compressed_data_info(ts)).algorithm from :COMPRESSED_CHUNK;
+
+-- The data round-trips through the adaptively chosen codec.
+select count(*) from adaptive;
+select count(*) from (select * from adaptive except select * from adaptive_orig) diff;
+select count(*) from (select * from adaptive_orig except select * from adaptive) diff;
+
+reset timescaledb.enable_adaptive_compression;
+reset timescaledb.enable_rle_compression;
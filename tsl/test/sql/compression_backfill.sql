@@ -0,0 +1,64 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- test backfilling compressed batches directly into a columnstore chunk
+CREATE TABLE backfill_test(time timestamptz NOT NULL, device text, value float) WITH (tsdb.hypertable,tsdb.partition_column='time');
+ALTER TABLE backfill_test SET (timescaledb.compress, timescaledb.compress_segmentby = 'device', timescaledb.compress_orderby = 'time');
+
+CREATE MATERIALIZED VIEW backfill_cagg WITH (timescaledb.continuous) AS
+SELECT time_bucket('1 day', time) AS bucket, device, count(*) AS nrows
+FROM backfill_test GROUP BY 1, 2
+WITH NO DATA;
+
+INSERT INTO backfill_test SELECT '2024-01-01 00:00+00'::timestamptz + format('%s minutes', i)::interval, 'd1', i FROM generate_series(1, 10) i;
+SELECT compress_chunk(ch) FROM show_chunks('backfill_test') ch;
+CALL refresh_continuous_aggregate('backfill_cagg', NULL, NULL);
+
+SELECT ch::text AS chunk FROM show_chunks('backfill_test') ch \gset
+SELECT _timescaledb_functions.chunk_status_text(:'chunk'::regclass);
+
+-- backfill a staging table that is already sorted on the (segmentby, orderby)
+-- keys straight into the compressed chunk
+CREATE TABLE backfill_stage(time timestamptz NOT NULL, device text, value float);
+INSERT INTO backfill_stage SELECT '2024-01-01 00:00+00'::timestamptz + format('%s minutes', i)::interval, 'd2', i FROM generate_series(1, 10) i;
+SELECT _timescaledb_functions.backfill_compressed_chunk(:'chunk', 'backfill_stage');
+
+-- the rows are readable through the chunk
+SELECT device, count(*), min(value), max(value) FROM backfill_test GROUP BY device ORDER BY device;
+
+-- the compression stats are merged with the stats of the initial compression
+SELECT numrows_pre_compression, numrows_post_compression FROM _timescaledb_catalog.compression_chunk_size;
+
+-- the new batches can overlap the preexisting ones, so the chunk is
+-- marked unordered
+SELECT _timescaledb_functions.chunk_status_text(:'chunk'::regclass);
+
+-- unsorted input is sorted before the batches are formed
+CREATE TABLE backfill_stage2(time timestamptz NOT NULL, device text, value float);
+INSERT INTO backfill_stage2 SELECT '2024-01-01 00:00+00'::timestamptz + format('%s minutes', i)::interval, 'd3', i FROM generate_series(10, 1, -1) i;
+SELECT _timescaledb_functions.backfill_compressed_chunk(:'chunk', 'backfill_stage2', sorted => false);
+
+-- the batch is stored in orderby order, so reading it back without
+-- ORDER BY returns ascending values
+SELECT value FROM backfill_test WHERE device = 'd3' LIMIT 3;
+
+-- one batch per backfilled segment
+SELECT format('%I.%I', c2.schema_name, c2.table_name) AS cchunk
+FROM _timescaledb_catalog.chunk c1
+JOIN _timescaledb_catalog.chunk c2 ON c2.id = c1.compressed_chunk_id
+WHERE format('%I.%I', c1.schema_name, c1.table_name)::regclass = :'chunk'::regclass \gset
+SELECT device, _ts_meta_count FROM :cchunk ORDER BY device;
+
+-- both backfills recorded invalidations for the continuous aggregate
+SELECT * FROM _timescaledb_catalog.continuous_aggs_hypertable_invalidation_log ORDER BY 1,2;
+CALL refresh_continuous_aggregate('backfill_cagg', NULL, NULL);
+SELECT device, nrows FROM backfill_cagg ORDER BY device;
+
+-- only columnstore chunks can be backfilled
+INSERT INTO backfill_test VALUES ('2024-02-01 00:00+00', 'd1', 1);
+SELECT ch::text AS chunk2 FROM show_chunks('backfill_test') ch ORDER BY 1 DESC LIMIT 1 \gset
+\set ON_ERROR_STOP 0
+SELECT _timescaledb_functions.backfill_compressed_chunk(:'chunk2', 'backfill_stage');
+SELECT _timescaledb_functions.backfill_compressed_chunk(:'chunk', NULL);
+\set ON_ERROR_STOP 1
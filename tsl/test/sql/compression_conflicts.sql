@@ -536,3 +536,77 @@ ON CONFLICT DO NOTHING;
 
 SELECT * FROM test_i7672 t ORDER BY t;
 
+
+-- test bloom1 sparse index probes on INSERT
+-- a unique key column that is in neither segmentby nor orderby gets an
+-- auto bloom1 sparse index, and a negative probe of it proves the absence
+-- of a conflict without decompressing the batch
+CREATE TABLE comp_conflicts_bloom(time timestamptz NOT NULL, device text, value float, UNIQUE(time, device));
+SELECT table_name FROM create_hypertable('comp_conflicts_bloom','time');
+ALTER TABLE comp_conflicts_bloom SET (timescaledb.compress, timescaledb.compress_segmentby='', timescaledb.compress_orderby='time');
+
+INSERT INTO comp_conflicts_bloom SELECT '2020-01-01'::timestamptz + format('%s seconds', i)::interval, 'd' || i, i FROM generate_series(1, 100) i;
+
+SELECT compress_chunk(c) AS "CHUNK" FROM show_chunks('comp_conflicts_bloom') c
+\gset
+
+set timescaledb.debug_compression_path_info to on;
+
+-- the batch matches the time range but the bloom probe on device proves
+-- there is no conflict, so no data moves into the uncompressed chunk
+BEGIN;
+  INSERT INTO comp_conflicts_bloom VALUES ('2020-01-01 0:00:50','d200',1.0);
+  SELECT count(*) FROM ONLY :CHUNK;
+ROLLBACK;
+
+-- an actual conflict passes the probe and is still detected
+\set ON_ERROR_STOP 0
+INSERT INTO comp_conflicts_bloom VALUES ('2020-01-01 0:00:50','d50',1.0);
+\set ON_ERROR_STOP 1
+
+RESET timescaledb.debug_compression_path_info;
+
+-- test caching of the unique key values of the last conflict probe
+-- runs of tuples with identical key values only probe the compressed
+-- chunk once
+CREATE TABLE comp_conflicts_cache(time timestamptz NOT NULL, device text, value float, UNIQUE(time, device));
+SELECT table_name FROM create_hypertable('comp_conflicts_cache','time');
+ALTER TABLE comp_conflicts_cache SET (timescaledb.compress, timescaledb.compress_segmentby='device');
+
+INSERT INTO comp_conflicts_cache VALUES ('2020-01-01','d1',1.0);
+SELECT count(compress_chunk(c)) FROM show_chunks('comp_conflicts_cache') c;
+
+set timescaledb.debug_compression_path_info to on;
+
+-- only the first tuple of the run probes the compressed chunk, the rest
+-- hit the key cache
+BEGIN;
+  INSERT INTO comp_conflicts_cache VALUES
+  ('2020-01-02','d2',1.0),
+  ('2020-01-02','d2',2.0),
+  ('2020-01-02','d2',3.0)
+  ON CONFLICT DO NOTHING;
+  SELECT count(*) FROM comp_conflicts_cache;
+ROLLBACK;
+
+-- a conflicting tuple that remains compressed with DO NOTHING invalidates
+-- the cache, so the next tuple with the same key has to probe again
+BEGIN;
+  INSERT INTO comp_conflicts_cache VALUES
+  ('2020-01-01','d1',1.0),
+  ('2020-01-01','d1',2.0)
+  ON CONFLICT DO NOTHING;
+  SELECT count(*) FROM comp_conflicts_cache;
+ROLLBACK;
+
+-- with the key cache disabled every tuple probes the compressed chunk
+set timescaledb.enable_dml_decompression_key_caching to off;
+BEGIN;
+  INSERT INTO comp_conflicts_cache VALUES
+  ('2020-01-02','d2',1.0),
+  ('2020-01-02','d2',2.0)
+  ON CONFLICT DO NOTHING;
+ROLLBACK;
+reset timescaledb.enable_dml_decompression_key_caching;
+
+RESET timescaledb.debug_compression_path_info;
@@ -460,3 +460,71 @@ SELECT * FROM test_segby ORDER BY time ASC NULLS FIRST;
 :PREFIX
 SELECT * FROM test_segby ORDER BY segby, time;
 
+
+------
+-- Tests without segmentby and with equality-pinned segmentby
+------
+
+-- An unordered chunk without segmentby columns can also use batch sorted
+-- merge: the batches are ordered by the orderby metadata alone.
+CREATE TABLE test_noseg (
+	time timestamptz NOT NULL,
+	val int);
+
+SELECT FROM create_hypertable('test_noseg', 'time');
+
+ALTER TABLE test_noseg SET (timescaledb.compress, timescaledb.compress_segmentby='', timescaledb.compress_orderby = 'time DESC');
+
+-- Two direct compress inserts create two batches overlapping on time.
+INSERT INTO test_noseg (time, val) values
+('2000-01-01 00:00:00-00', 1),
+('2000-01-01 01:00:00-00', 2),
+('2000-01-01 02:00:00-00', 3),
+('2000-01-01 03:00:00-00', 4),
+('2000-01-01 00:00:00-00', 1),
+('2000-01-01 01:00:00-00', 2),
+('2000-01-01 02:00:00-00', 3),
+('2000-01-01 03:00:00-00', 4),
+('2000-01-01 00:00:00-00', 1),
+('2000-01-01 01:00:00-00', 2),
+('2000-01-01 02:00:00-00', 3),
+('2000-01-01 03:00:00-00', 4);
+
+INSERT INTO test_noseg (time, val) values
+('2000-01-01 00:30:00-00', 5),
+('2000-01-01 01:30:00-00', 6),
+('2000-01-01 02:30:00-00', 7),
+('2000-01-01 03:30:00-00', 8),
+('2000-01-01 00:30:00-00', 5),
+('2000-01-01 01:30:00-00', 6),
+('2000-01-01 02:30:00-00', 7),
+('2000-01-01 03:30:00-00', 8),
+('2000-01-01 00:30:00-00', 5),
+('2000-01-01 01:30:00-00', 6),
+('2000-01-01 02:30:00-00', 7),
+('2000-01-01 03:30:00-00', 8);
+
+-- Show chunk is compressed unordered.
+SELECT _timescaledb_functions.chunk_status_text(chunk) FROM show_chunks('test_noseg') chunk;
+
+set timescaledb.debug_require_batch_sorted_merge to 'force';
+
+-- Should be optimized (no segmentby columns)
+:PREFIX
+SELECT * FROM test_noseg ORDER BY time DESC;
+
+-- Should be optimized (backward scan)
+:PREFIX
+SELECT * FROM test_noseg ORDER BY time ASC NULLS LAST;
+
+-- The overlapping batches are merged on the orderby metadata
+SELECT * FROM test_noseg ORDER BY time DESC;
+
+-- Should be optimized (equality constraint pins the segmentby column and
+-- drops it from the pathkeys)
+:PREFIX
+SELECT * FROM test_segby WHERE segby = 1 ORDER BY time DESC;
+
+SELECT * FROM test_segby WHERE segby = 1 ORDER BY time DESC;
+
+set timescaledb.debug_require_batch_sorted_merge to 'forbid';
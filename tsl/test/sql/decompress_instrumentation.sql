@@ -0,0 +1,43 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- Check that ColumnarScan and VectorAgg report their decompression and
+-- aggregation counters under EXPLAIN (ANALYZE, VERBOSE). The raw counter
+-- values are filtered out of regression output by the test runner, so this
+-- test scrapes the plan and normalizes the values to 'N'.
+create table insttest(ts int not null, device int, val float8);
+select create_hypertable('insttest', 'ts');
+alter table insttest set (timescaledb.compress, timescaledb.compress_segmentby = 'device', timescaledb.compress_orderby = 'ts');
+insert into insttest select i, i % 10, i * 0.5 from generate_series(1, 10000) i;
+select count(compress_chunk(x)) from show_chunks('insttest') x;
+vacuum analyze insttest;
+
+create function explain_counters(query text, pattern text) returns setof text
+language plpgsql as
+$$
+declare
+    ln text;
+begin
+    for ln in execute format('explain (analyze, verbose, costs off, buffers off, timing off, summary off) %s', query)
+    loop
+        if ln ~ pattern then
+            return next ltrim(regexp_replace(ln, ': [0-9]+$', ': N'));
+        end if;
+    end loop;
+end;
+$$;
+
+-- A plain decompression reports the decompressed batches and the compressed
+-- bytes it decompressed, broken down by compression algorithm.
+select explain_counters($$ select * from insttest where device = 3 $$,
+       'Decompressed');
+
+-- A vectorized filter reports the rows it removed separately from the
+-- row-by-row quals.
+select explain_counters($$ select * from insttest where val > 4999.0 $$,
+       'Decompressed|Vectorized Filter');
+
+-- A vectorized aggregation reports the batches and rows it aggregated.
+select explain_counters($$ select sum(val) from insttest $$,
+       'Aggregated');
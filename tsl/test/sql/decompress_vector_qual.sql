@@ -513,6 +513,24 @@ select count(*), min(ts), max(ts), min(d), max(d) from text_table where a like '
 select count(*), min(ts), max(ts), min(d), max(d) from text_table where a like 'different%\';
 \set ON_ERROR_STOP 1
 
+-- Case-insensitive LIKE.
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ilike '%SAME%';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ilike 'DIFFERENT1%';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ilike 'SAME_';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a not ilike '%SAME%';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ilike '%ОДИНАКОВЫЙ%';
+
+-- Regex matching.
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ~ 'same';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ~ '^different[0-9]+$';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ~* 'SAME';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a !~ 'same';
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ~ 'одинаковый';
+
+\set ON_ERROR_STOP 0
+select count(*), min(ts), max(ts), min(d), max(d) from text_table where a ~ 'different(';
+\set ON_ERROR_STOP 1
+
 
 -- We don't vectorize comparison operators with text because they are probably
 -- not very useful.
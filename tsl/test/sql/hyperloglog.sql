@@ -0,0 +1,39 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- Exercise approximate_count_distinct() on a compressed hypertable: compare
+-- it with the exact count(distinct ...) and check that fixed-width columns
+-- go through the vectorized hyperloglog kernels.
+create table approx(ts int not null, device int, sensor text);
+select create_hypertable('approx', 'ts', chunk_time_interval => 5000);
+alter table approx set (timescaledb.compress, timescaledb.compress_orderby = 'ts');
+insert into approx select i, i % 500, 'sensor_' || (i % 50) from generate_series(1, 9999) i;
+
+-- The aggregate is created by the extension scripts.
+select count(*) from pg_proc where proname = 'approximate_count_distinct' and prokind = 'a';
+
+-- The approximation is well within the expected error on uncompressed data.
+select count(distinct device) from approx;
+select approximate_count_distinct(device) between 475 and 525 from approx;
+select count(distinct sensor) from approx;
+select approximate_count_distinct(sensor) between 45 and 55 from approx;
+
+select compress_chunk(show_chunks('approx'));
+vacuum analyze approx;
+
+-- Fixed-width columns aggregate through the vectorized kernels.
+explain (buffers off, costs off) select approximate_count_distinct(device) from approx;
+set timescaledb.debug_require_vector_agg = 'require';
+select approximate_count_distinct(device) between 475 and 525 from approx;
+reset timescaledb.debug_require_vector_agg;
+
+-- Text has no vectorized kernel and falls back to row-by-row aggregation,
+-- which must produce the same sketch.
+select approximate_count_distinct(sensor) between 45 and 55 from approx;
+
+-- The sketch combines vectorized and row-by-row partials after an update
+-- moves some rows back to the uncompressed part of the chunk.
+update approx set device = device + 1000 where ts <= 100;
+select count(distinct device) from approx;
+select approximate_count_distinct(device) between 570 and 630 from approx;
@@ -0,0 +1,50 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+CREATE TABLE prewarm_test(time timestamptz NOT NULL, device_id int, value float) WITH (tsdb.hypertable,tsdb.partition_column='time');
+
+INSERT INTO prewarm_test
+SELECT t, 1, 0.5
+FROM generate_series('2024-01-01'::timestamptz, '2024-01-20'::timestamptz, '1 minute') t;
+
+SELECT ch::text AS warm_chunk FROM show_chunks('prewarm_test') ch ORDER BY 1 LIMIT 1 \gset
+
+-- the number of blocks read is capped by max_blocks
+SELECT _timescaledb_functions.relation_prewarm(:'warm_chunk', 2);
+
+-- with a cap above the relation size the whole relation is read
+SELECT _timescaledb_functions.relation_prewarm(:'warm_chunk', 1000000) =
+       pg_relation_size(:'warm_chunk') / current_setting('block_size')::bigint AS whole_relation;
+
+-- indexes are read from the head and capped the same way
+SELECT _timescaledb_functions.relation_prewarm(i.indexrelid, 1)
+FROM pg_index i
+WHERE i.indrelid = :'warm_chunk'::regclass;
+
+-- NULL relation and non-positive caps read nothing
+SELECT _timescaledb_functions.relation_prewarm(NULL, 10);
+SELECT _timescaledb_functions.relation_prewarm(:'warm_chunk', 0);
+
+-- config validation
+\set ON_ERROR_STOP 0
+SELECT _timescaledb_functions.policy_prewarm_check(NULL);
+SELECT _timescaledb_functions.policy_prewarm_check('{}');
+SELECT _timescaledb_functions.policy_prewarm_check('{"hypertables": "prewarm_test"}');
+\set ON_ERROR_STOP 1
+SELECT _timescaledb_functions.policy_prewarm_check('{"hypertables": ["prewarm_test"]}');
+
+-- run the prewarm job through the scheduler entry point
+SELECT add_job('_timescaledb_functions.policy_prewarm', '1h',
+       config => '{"hypertables": ["prewarm_test"], "recent_chunks": 2, "max_blocks_per_relation": 4}',
+       check_config => '_timescaledb_functions.policy_prewarm_check') AS job_id \gset
+CALL run_job(:job_id);
+
+-- tables that are not hypertables are skipped with a warning
+CREATE TABLE prewarm_plain(time timestamptz);
+SELECT add_job('_timescaledb_functions.policy_prewarm', '1h',
+       config => '{"hypertables": ["prewarm_plain"]}') AS job_id_plain \gset
+CALL run_job(:job_id_plain);
+
+SELECT delete_job(:job_id);
+SELECT delete_job(:job_id_plain);
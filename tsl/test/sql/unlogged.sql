@@ -38,3 +38,40 @@ ALTER TABLE t2 SET LOGGED;
 -- everything should be logged now
 SELECT oid::regclass,relpersistence from pg_class where relpersistence = 'u' AND relnamespace <> 'pg_toast'::regnamespace ORDER BY oid::regclass;
 
+-- timescaledb.unlogged_staging: chunks are created unlogged so ingest
+-- skips WAL, while the hypertable itself stays permanent
+CREATE TABLE t3(time timestamptz, device text, value float) WITH (tsdb.hypertable, tsdb.unlogged_staging);
+ALTER TABLE t3 SET (timescaledb.compress, timescaledb.compress_segmentby = 'device');
+SELECT oid::regclass,relpersistence from pg_class where oid = 't3'::regclass;
+
+INSERT INTO t3 SELECT '2025-01-01', 'd1', 1;
+SELECT show_chunks('t3') AS "STAGING_CHUNK" \gset
+
+-- chunks are created unlogged
+SELECT oid::regclass,relpersistence from pg_class where oid = :'STAGING_CHUNK'::regclass;
+
+SELECT count(compress_chunk(chunk)) FROM show_chunks('t3') chunk;
+
+-- the compressed chunk is created permanent even though the source
+-- chunk is unlogged, so compression seals the data into WAL-logged
+-- storage
+SELECT format('%I.%I', c2.schema_name, c2.table_name)::regclass AS cchunk, cl.relpersistence
+FROM _timescaledb_catalog.chunk c1
+JOIN _timescaledb_catalog.chunk c2 ON c2.id = c1.compressed_chunk_id
+JOIN pg_class cl ON cl.oid = format('%I.%I', c2.schema_name, c2.table_name)::regclass
+WHERE c1.table_name = '_hyper_4_4_chunk';
+
+-- only the chunk and its index are unlogged
+SELECT oid::regclass,relpersistence from pg_class where relpersistence = 'u' AND relnamespace <> 'pg_toast'::regnamespace ORDER BY oid::regclass;
+
+-- explicitly disabling the option round-trips to the default logged
+-- behavior
+CREATE TABLE t4(time timestamptz) WITH (tsdb.hypertable, tsdb.unlogged_staging=false);
+INSERT INTO t4 SELECT '2025-01-01';
+SELECT oid::regclass,relpersistence from pg_class where oid in (SELECT show_chunks('t4'));
+
+-- the option is recorded in the hypertable status flag
+SELECT table_name, status FROM _timescaledb_catalog.hypertable WHERE table_name IN ('t3', 't4') ORDER BY table_name;
+
+DROP TABLE t3;
+DROP TABLE t4;
@@ -0,0 +1,42 @@
+-- This file and its contents are licensed under the Timescale License.
+-- Please see the included NOTICE for copyright information and
+-- LICENSE-TIMESCALE for a copy of the license.
+
+-- Vectorized aggregation over uncompressed chunks goes through the plain
+-- batch reader that transposes the heap tuples into in-memory columnar
+-- batches. Check the batching against nulls, batch boundaries and dropped
+-- columns.
+
+create table plainagg(ts int not null, dropme int, device int, val int);
+select create_hypertable('plainagg', 'ts', chunk_time_interval => 2500);
+
+-- Two chunks of 2499 and 2500 rows, so the reader sees both full batches of
+-- 1000 rows and short final batches. The rows divisible by 10 have null
+-- values and the rows divisible by 5 have null grouping keys.
+insert into plainagg
+select i, i, case when i % 5 = 0 then null else i % 4 end,
+    case when i % 10 = 0 then null else i end
+from generate_series(1, 4999) i;
+vacuum analyze plainagg;
+
+explain (verbose, buffers off, costs off)
+select count(*), count(val), sum(val) from plainagg;
+
+set timescaledb.debug_require_vector_agg = 'require';
+select count(*), count(val), sum(val) from plainagg;
+select min(val), max(val) from plainagg;
+-- Hash grouping with a nullable key.
+select device, count(*), count(val), sum(val) from plainagg group by device order by device;
+reset timescaledb.debug_require_vector_agg;
+
+explain (verbose, buffers off, costs off)
+select device, sum(val) from plainagg group by device;
+
+-- A dropped column stays in the chunk tuples as a null attribute, so the
+-- batch reader must keep mapping the remaining columns correctly.
+alter table plainagg drop column dropme;
+
+set timescaledb.debug_require_vector_agg = 'require';
+select count(*), sum(val) from plainagg;
+select device, sum(val) from plainagg group by device order by device;
+reset timescaledb.debug_require_vector_agg;
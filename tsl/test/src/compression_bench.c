@@ -0,0 +1,461 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Microbenchmark driver for the compression algorithms. Unlike
+ * compression_unit_test.c, which checks correctness, this measures
+ * compress/decompress throughput (both the row-by-row iterators and the
+ * decompress_all Arrow paths) and the achieved compression ratios, so that
+ * codecs can be compared on representative data and decode-speed regressions
+ * can be caught across releases.
+ *
+ * The entry points are SQL-callable and return one JSON array of result
+ * objects as text:
+ *
+ *   CREATE FUNCTION ts_compression_bench(profile TEXT, num_elements INT,
+ *       iterations INT) RETURNS TEXT
+ *       AS :MODULE_PATHNAME, 'ts_compression_bench' LANGUAGE C;
+ *
+ *   CREATE FUNCTION ts_compression_bench_array(anyarray, iterations INT)
+ *       RETURNS TEXT
+ *       AS :MODULE_PATHNAME, 'ts_compression_bench_array' LANGUAGE C;
+ *
+ * The first function generates synthetic data for a named profile
+ * ('sequential_int', 'random_int', 'smooth_double', 'random_double',
+ * 'repeated_text', 'random_text', 'bool', 'uuid', or 'all'), the second runs
+ * the codecs applicable to the element type over user-supplied values.
+ */
+
+#include <postgres.h>
+
+#include <catalog/pg_type.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+#include <portability/instr_time.h>
+#include <utils/array.h>
+#include <utils/builtins.h>
+#include <utils/json.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/uuid.h>
+
+#include "test_utils.h"
+#include <export.h>
+
+#include "compression/algorithms/array.h"
+#include "compression/algorithms/bool_compress.h"
+#include "compression/algorithms/deltadelta.h"
+#include "compression/algorithms/dictionary.h"
+#include "compression/algorithms/gorilla.h"
+#include "compression/algorithms/uuid_compress.h"
+#include "compression/arrow_c_data_interface.h"
+#include "compression/compression.h"
+
+TS_FUNCTION_INFO_V1(ts_compression_bench);
+TS_FUNCTION_INFO_V1(ts_compression_bench_array);
+
+typedef struct BenchAlgorithm
+{
+	CompressionAlgorithm algo;
+	Compressor *(*create)(Oid element_type);
+} BenchAlgorithm;
+
+typedef struct BenchData
+{
+	Oid typid;
+	int n;
+	Datum *values;
+	bool *nulls;
+	int64 input_bytes;
+} BenchData;
+
+/*
+ * The codecs that make sense for a given input type. The generic array and
+ * dictionary codecs apply everywhere, the specialized ones only to their
+ * native types.
+ */
+static int
+bench_algorithms_for_type(Oid typid, BenchAlgorithm *algos)
+{
+	int n = 0;
+
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case DATEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			algos[n++] = (BenchAlgorithm){ COMPRESSION_ALGORITHM_DELTADELTA,
+										   delta_delta_compressor_for_type };
+			algos[n++] =
+				(BenchAlgorithm){ COMPRESSION_ALGORITHM_GORILLA, gorilla_compressor_for_type };
+			break;
+		case FLOAT4OID:
+		case FLOAT8OID:
+			algos[n++] =
+				(BenchAlgorithm){ COMPRESSION_ALGORITHM_GORILLA, gorilla_compressor_for_type };
+			break;
+		case BOOLOID:
+			algos[n++] = (BenchAlgorithm){ COMPRESSION_ALGORITHM_BOOL, bool_compressor_for_type };
+			break;
+		case UUIDOID:
+			algos[n++] = (BenchAlgorithm){ COMPRESSION_ALGORITHM_UUID, uuid_compressor_for_type };
+			break;
+		default:
+			break;
+	}
+
+	algos[n++] = (BenchAlgorithm){ COMPRESSION_ALGORITHM_ARRAY, array_compressor_for_type };
+	algos[n++] =
+		(BenchAlgorithm){ COMPRESSION_ALGORITHM_DICTIONARY, dictionary_compressor_for_type };
+
+	return n;
+}
+
+/*
+ * Deterministic pseudo-random numbers, so that repeated runs and runs on
+ * different machines compress the same data.
+ */
+static uint64 bench_prng_state;
+
+static uint64
+bench_prng_next(void)
+{
+	bench_prng_state = bench_prng_state * UINT64CONST(6364136223846793005) +
+					   UINT64CONST(1442695040888963407);
+	return bench_prng_state;
+}
+
+static void *
+bench_compress(const BenchAlgorithm *ba, const BenchData *data)
+{
+	Compressor *compressor = ba->create(data->typid);
+
+	for (int i = 0; i < data->n; i++)
+	{
+		if (data->nulls != NULL && data->nulls[i])
+			compressor->append_null(compressor);
+		else
+			compressor->append_val(compressor, data->values[i]);
+	}
+
+	return compressor->finish(compressor);
+}
+
+/*
+ * Run one codec over the data and append a JSON result object. Throughput is
+ * computed over the uncompressed input bytes.
+ */
+static void
+bench_one_algorithm(StringInfo json, const char *profile, const BenchAlgorithm *ba,
+					const BenchData *data, int iterations, bool *first)
+{
+	MemoryContext bench_cxt =
+		AllocSetContextCreate(CurrentMemoryContext, "compression bench", ALLOCSET_DEFAULT_SIZES);
+	instr_time start;
+	instr_time duration;
+	int it;
+
+	/* Compress once up front to get the compressed representation. */
+	void *compressed = bench_compress(ba, data);
+	TestAssertTrue(compressed != NULL);
+	const int64 compressed_bytes = VARSIZE_ANY(compressed);
+
+	/* Compression throughput. */
+	INSTR_TIME_SET_CURRENT(start);
+	for (it = 0; it < iterations; it++)
+	{
+		MemoryContext old = MemoryContextSwitchTo(bench_cxt);
+		void *result = bench_compress(ba, data);
+		TestAssertTrue(result != NULL);
+		MemoryContextSwitchTo(old);
+		MemoryContextReset(bench_cxt);
+	}
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	const double compress_seconds = INSTR_TIME_GET_DOUBLE(duration);
+
+	/* Row-by-row decompression throughput. */
+	DecompressionInitializer iterator_init =
+		tsl_get_decompression_iterator_init(ba->algo, /* reverse = */ false);
+	INSTR_TIME_SET_CURRENT(start);
+	for (it = 0; it < iterations; it++)
+	{
+		MemoryContext old = MemoryContextSwitchTo(bench_cxt);
+		DecompressionIterator *iter = iterator_init(PointerGetDatum(compressed), data->typid);
+		int rows = 0;
+		for (DecompressResult r = iter->try_next(iter); !r.is_done; r = iter->try_next(iter))
+			rows++;
+		TestAssertInt64Eq(rows, data->n);
+		MemoryContextSwitchTo(old);
+		MemoryContextReset(bench_cxt);
+	}
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	const double iterator_seconds = INSTR_TIME_GET_DOUBLE(duration);
+
+	/* Bulk decompression throughput, when the codec supports it. */
+	double bulk_seconds = -1;
+	DecompressAllFunction decompress_all = tsl_get_decompress_all_function(ba->algo, data->typid);
+	if (decompress_all != NULL)
+	{
+		INSTR_TIME_SET_CURRENT(start);
+		for (it = 0; it < iterations; it++)
+		{
+			MemoryContext old = MemoryContextSwitchTo(bench_cxt);
+			ArrowArray *arrow = decompress_all(PointerGetDatum(compressed), data->typid, bench_cxt);
+			TestAssertInt64Eq(arrow->length, data->n);
+			MemoryContextSwitchTo(old);
+			MemoryContextReset(bench_cxt);
+		}
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, start);
+		bulk_seconds = INSTR_TIME_GET_DOUBLE(duration);
+	}
+
+	MemoryContextDelete(bench_cxt);
+
+	const double total_input_mb = (double) data->input_bytes * iterations / (1024. * 1024.);
+
+	if (!*first)
+		appendStringInfoString(json, ",");
+	*first = false;
+
+	appendStringInfoString(json, "{\"profile\":");
+	escape_json(json, profile);
+	appendStringInfoString(json, ",\"algorithm\":");
+	escape_json(json, NameStr(*compression_get_algorithm_name(ba->algo)));
+	appendStringInfo(json,
+					 ",\"num_elements\":%d,\"input_bytes\":" INT64_FORMAT
+					 ",\"compressed_bytes\":" INT64_FORMAT ",\"compression_ratio\":%.2f",
+					 data->n,
+					 data->input_bytes,
+					 compressed_bytes,
+					 (double) data->input_bytes / compressed_bytes);
+	appendStringInfo(json,
+					 ",\"compress_mb_per_second\":%.1f,\"decompress_iterator_mb_per_second\":%.1f",
+					 total_input_mb / compress_seconds,
+					 total_input_mb / iterator_seconds);
+	if (bulk_seconds >= 0)
+		appendStringInfo(json,
+						 ",\"decompress_all_mb_per_second\":%.1f}",
+						 total_input_mb / bulk_seconds);
+	else
+		appendStringInfoString(json, ",\"decompress_all_mb_per_second\":null}");
+}
+
+static void
+bench_all_algorithms(StringInfo json, const char *profile, const BenchData *data, int iterations,
+					 bool *first)
+{
+	BenchAlgorithm algos[4];
+	const int num_algos = bench_algorithms_for_type(data->typid, algos);
+
+	for (int i = 0; i < num_algos; i++)
+		bench_one_algorithm(json, profile, &algos[i], data, iterations, first);
+}
+
+static BenchData *
+bench_data_alloc(Oid typid, int n)
+{
+	BenchData *data = palloc0(sizeof(BenchData));
+	data->typid = typid;
+	data->n = n;
+	data->values = palloc(sizeof(Datum) * n);
+	return data;
+}
+
+static BenchData *
+bench_generate_data(const char *profile, int n)
+{
+	BenchData *data;
+
+	if (strcmp(profile, "sequential_int") == 0)
+	{
+		data = bench_data_alloc(INT8OID, n);
+		for (int i = 0; i < n; i++)
+			data->values[i] = Int64GetDatum((int64) i * 1000);
+		data->input_bytes = (int64) n * 8;
+	}
+	else if (strcmp(profile, "random_int") == 0)
+	{
+		data = bench_data_alloc(INT8OID, n);
+		for (int i = 0; i < n; i++)
+			data->values[i] = Int64GetDatum((int64) bench_prng_next());
+		data->input_bytes = (int64) n * 8;
+	}
+	else if (strcmp(profile, "smooth_double") == 0)
+	{
+		/* A slowly changing measurement with limited precision, the best case
+		 * for gorilla's xor scheme. */
+		data = bench_data_alloc(FLOAT8OID, n);
+		for (int i = 0; i < n; i++)
+			data->values[i] = Float8GetDatum(20.0 + (i % 100) * 0.25);
+		data->input_bytes = (int64) n * 8;
+	}
+	else if (strcmp(profile, "random_double") == 0)
+	{
+		data = bench_data_alloc(FLOAT8OID, n);
+		for (int i = 0; i < n; i++)
+			data->values[i] =
+				Float8GetDatum((double) (bench_prng_next() >> 11) / (double) (UINT64CONST(1) << 53));
+		data->input_bytes = (int64) n * 8;
+	}
+	else if (strcmp(profile, "repeated_text") == 0)
+	{
+		const char *strings[5] = { "ok", "error", "warning", "debug", "critical" };
+		text *texts[5];
+		data = bench_data_alloc(TEXTOID, n);
+		for (int i = 0; i < 5; i++)
+			texts[i] = cstring_to_text(strings[i]);
+		for (int i = 0; i < n; i++)
+		{
+			data->values[i] = PointerGetDatum(texts[i % 5]);
+			data->input_bytes += VARSIZE_ANY(texts[i % 5]);
+		}
+	}
+	else if (strcmp(profile, "random_text") == 0)
+	{
+		data = bench_data_alloc(TEXTOID, n);
+		for (int i = 0; i < n; i++)
+		{
+			text *t = cstring_to_text(psprintf("value-" UINT64_FORMAT, bench_prng_next() % 100000));
+			data->values[i] = PointerGetDatum(t);
+			data->input_bytes += VARSIZE_ANY(t);
+		}
+	}
+	else if (strcmp(profile, "bool") == 0)
+	{
+		data = bench_data_alloc(BOOLOID, n);
+		for (int i = 0; i < n; i++)
+			data->values[i] = BoolGetDatum(i % 17 != 0);
+		data->input_bytes = n;
+	}
+	else if (strcmp(profile, "uuid") == 0)
+	{
+		data = bench_data_alloc(UUIDOID, n);
+		for (int i = 0; i < n; i++)
+		{
+			/* Time-ordered like uuidv7, which is the layout the uuid codec
+			 * targets. */
+			pg_uuid_t *uuid = palloc0(sizeof(pg_uuid_t));
+			uint64 millis = UINT64CONST(1700000000000) + i;
+			for (int byte = 0; byte < 6; byte++)
+				uuid->data[byte] = (millis >> (8 * (5 - byte))) & 0xFF;
+			uuid->data[6] = 0x70;
+			uuid->data[15] = bench_prng_next() & 0xFF;
+			data->values[i] = UUIDPGetDatum(uuid);
+		}
+		data->input_bytes = (int64) n * 16;
+	}
+	else
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("unknown benchmark profile \"%s\"", profile)));
+		pg_unreachable();
+	}
+
+	return data;
+}
+
+static const char *bench_all_profiles[] = { "sequential_int", "random_int",	   "smooth_double",
+											"random_double",  "repeated_text", "random_text",
+											"bool",			  "uuid" };
+
+Datum
+ts_compression_bench(PG_FUNCTION_ARGS)
+{
+	const char *profile = text_to_cstring(PG_GETARG_TEXT_PP(0));
+	const int num_elements = PG_GETARG_INT32(1);
+	const int iterations = PG_GETARG_INT32(2);
+	StringInfoData json;
+	bool first = true;
+
+	if (num_elements <= 0 || iterations <= 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the number of elements and iterations must be positive")));
+
+	bench_prng_state = 0xC0FFEE;
+
+	initStringInfo(&json);
+	appendStringInfoString(&json, "[");
+
+	if (strcmp(profile, "all") == 0)
+	{
+		for (size_t i = 0; i < sizeof(bench_all_profiles) / sizeof(*bench_all_profiles); i++)
+		{
+			BenchData *data = bench_generate_data(bench_all_profiles[i], num_elements);
+			bench_all_algorithms(&json, bench_all_profiles[i], data, iterations, &first);
+		}
+	}
+	else
+	{
+		BenchData *data = bench_generate_data(profile, num_elements);
+		bench_all_algorithms(&json, profile, data, iterations, &first);
+	}
+
+	appendStringInfoString(&json, "]");
+
+	PG_RETURN_TEXT_P(cstring_to_text(json.data));
+}
+
+/*
+ * Benchmark the codecs applicable to the element type over user-supplied
+ * values, e.g. sampled from a production column:
+ *
+ *   SELECT ts_compression_bench_array((SELECT array_agg(value) FROM metrics), 100);
+ */
+Datum
+ts_compression_bench_array(PG_FUNCTION_ARGS)
+{
+	ArrayType *arr = PG_GETARG_ARRAYTYPE_P(0);
+	const int iterations = PG_GETARG_INT32(1);
+	const Oid typid = ARR_ELEMTYPE(arr);
+	StringInfoData json;
+	bool first = true;
+	int16 typlen;
+	bool typbyval;
+	char typalign;
+	int n;
+
+	if (iterations <= 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the number of iterations must be positive")));
+
+	BenchData *data = palloc0(sizeof(BenchData));
+	data->typid = typid;
+
+	get_typlenbyvalalign(typid, &typlen, &typbyval, &typalign);
+	deconstruct_array(arr, typid, typlen, typbyval, typalign, &data->values, &data->nulls, &n);
+
+	if (n == 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the benchmark input array must not be empty")));
+
+	data->n = n;
+	for (int i = 0; i < n; i++)
+	{
+		if (data->nulls[i])
+			continue;
+		if (typlen > 0)
+			data->input_bytes += typlen;
+		else
+			data->input_bytes += VARSIZE_ANY(DatumGetPointer(data->values[i]));
+	}
+
+	initStringInfo(&json);
+	appendStringInfoString(&json, "[");
+	bench_all_algorithms(&json, "user", data, iterations, &first);
+	appendStringInfoString(&json, "]");
+
+	PG_RETURN_TEXT_P(cstring_to_text(json.data));
+}
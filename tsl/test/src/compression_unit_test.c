@@ -24,13 +24,16 @@
 #include "ts_catalog/catalog.h"
 #include <export.h>
 
+#include "compression/algorithms/alp.h"
 #include "compression/algorithms/array.h"
+#include "compression/algorithms/array_zstd.h"
 #include "compression/algorithms/bool_compress.h"
 #include "compression/algorithms/deltadelta.h"
 #include "compression/algorithms/dictionary.h"
 #include "compression/algorithms/float_utils.h"
 #include "compression/algorithms/gorilla.h"
 #include "compression/algorithms/null.h"
+#include "compression/algorithms/rle.h"
 #include "compression/algorithms/simple8b_rle.h"
 #include "compression/algorithms/uuid_compress.h"
 #include "compression/arrow_c_data_interface.h"
@@ -631,6 +634,51 @@ test_delta4(const int32 *values, int n)
 	TestAssertTrue(i == n);
 }
 
+/*
+ * Check that the bulk Arrow-vector appends produce exactly the same compressed
+ * data as the per-value Datum appends.
+ */
+static void
+test_append_vector()
+{
+	uint64 validity[(TEST_ELEMENTS + 63) / 64] = { 0 };
+	int32 values[TEST_ELEMENTS];
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		values[i] = i * 17 + (i % 31);
+		arrow_set_row_validity(validity, i, i % 29 != 0);
+	}
+
+	const void *buffers[] = { validity, values };
+	const ArrowArray vector = {
+		.length = TEST_ELEMENTS,
+		.n_buffers = 2,
+		.buffers = buffers,
+	};
+
+	Compressor *vector_compressor = delta_delta_compressor_for_type(INT4OID);
+	TestAssertTrue(vector_compressor->append_vector != NULL);
+	vector_compressor->append_vector(vector_compressor, &vector);
+	Datum vector_compressed = (Datum) vector_compressor->finish(vector_compressor);
+	TestAssertTrue(DatumGetPointer(vector_compressed) != NULL);
+
+	Compressor *row_compressor = delta_delta_compressor_for_type(INT4OID);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		if (arrow_row_is_valid(validity, i))
+			row_compressor->append_val(row_compressor, Int32GetDatum(values[i]));
+		else
+			row_compressor->append_null(row_compressor);
+	}
+	Datum row_compressed = (Datum) row_compressor->finish(row_compressor);
+
+	TestAssertInt64Eq(VARSIZE(DatumGetPointer(vector_compressed)),
+					  VARSIZE(DatumGetPointer(row_compressed)));
+	TestAssertTrue(memcmp(DatumGetPointer(vector_compressed),
+						  DatumGetPointer(row_compressed),
+						  VARSIZE(DatumGetPointer(row_compressed))) == 0);
+}
+
 static void
 test_bool_rle(bool nulls, int run_length, int expected_size)
 {
@@ -908,6 +956,63 @@ test_bool_compressor_extended()
 	TestAssertTrue(finished != NULL);
 }
 
+static void
+test_bool_bitmap_append(bool have_nulls)
+{
+	/* Compare the bulk bitmap append against the per-element append. */
+	uint64 values_bitmap[(TEST_ELEMENTS + 63) / 64] = { 0 };
+	uint64 validity_bitmap[(TEST_ELEMENTS + 63) / 64] = { 0 };
+
+	BoolCompressor *bulk_compressor = bool_compressor_alloc();
+	BoolCompressor *row_compressor = bool_compressor_alloc();
+
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		const bool value = (i / 17) % 2 == 0;
+		const bool valid = !have_nulls || i % 29 != 0;
+		if (value)
+			values_bitmap[i / 64] |= 1ULL << (i % 64);
+		if (valid)
+			validity_bitmap[i / 64] |= 1ULL << (i % 64);
+
+		if (valid)
+			bool_compressor_append_value(row_compressor, value);
+		else
+			bool_compressor_append_null(row_compressor);
+	}
+
+	bool_compressor_append_bitmap(bulk_compressor,
+								  have_nulls ? validity_bitmap : NULL,
+								  values_bitmap,
+								  TEST_ELEMENTS);
+
+	void *bulk_compressed = bool_compressor_finish(bulk_compressor);
+	void *row_compressed = bool_compressor_finish(row_compressor);
+	TestAssertTrue(bulk_compressed != NULL);
+	TestAssertTrue(row_compressed != NULL);
+
+	/* The bulk append must produce the exact same compressed batch. */
+	TestAssertTrue(VARSIZE(bulk_compressed) == VARSIZE(row_compressed));
+	TestAssertTrue(memcmp(bulk_compressed, row_compressed, VARSIZE(bulk_compressed)) == 0);
+
+	DecompressionIterator *iter =
+		bool_decompression_iterator_from_datum_forward(PointerGetDatum(bulk_compressed), BOOLOID);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = bool_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		if (have_nulls && i % 29 == 0)
+			TestAssertTrue(r.is_null);
+		else
+		{
+			TestAssertTrue(!r.is_null);
+			TestAssertTrue(DatumGetBool(r.val) == ((i / 17) % 2 == 0));
+		}
+	}
+	DecompressResult r = bool_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+}
+
 static uint32
 bool_compressed_size(int num_values, int flip_nth)
 {
@@ -931,6 +1036,8 @@ test_bool()
 	/* code covareage and simple tests */
 	test_empty_bool_compressor();
 	test_bool_compressor_extended();
+	test_bool_bitmap_append(/* have_nulls = */ false);
+	test_bool_bitmap_append(/* have_nulls = */ true);
 
 	/* testing a few RLE configurations with or without nulls: */
 	test_bool_rle(/* nulls = */ false, /* run_length = */ 1, /* expected_size = */ 152);
@@ -1634,6 +1741,417 @@ pointless_tests_to_satisfy_codecov()
 		tsl_dictionary_decompress_all(UnassignedDatum, InvalidOid, CurrentMemoryContext));
 }
 
+static void
+test_alp_double(bool have_nulls, bool have_exceptions)
+{
+	AlpCompressor *compressor = alp_compressor_alloc(FLOAT8OID);
+	AlpCompressed *compressed;
+
+	double values[TEST_ELEMENTS];
+	bool nulls[TEST_ELEMENTS];
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		/* Two decimal places, the typical sensor-feed shape alp targets. */
+		values[i] = (i % 1000) / 100.;
+
+		if (have_exceptions && i % 31 == 0)
+		{
+			/* Not a decimal number, has to be stored verbatim. */
+			values[i] = test_hash64(i) / (double) PG_UINT64_MAX;
+		}
+
+		nulls[i] = have_nulls && i % 29 == 0;
+
+		if (nulls[i])
+		{
+			alp_compressor_append_null(compressor);
+		}
+		else
+		{
+			alp_compressor_append_value(compressor, values[i]);
+		}
+	}
+
+	compressed = alp_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+
+	/* Forward decompression. */
+	DecompressionIterator *iter =
+		alp_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), FLOAT8OID);
+	ArrowArray *bulk_result =
+		alp_decompress_all(PointerGetDatum(compressed), FLOAT8OID, CurrentMemoryContext);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = alp_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		if (r.is_null)
+		{
+			TestAssertTrue(nulls[i]);
+			TestAssertTrue(!arrow_row_is_valid(bulk_result->buffers[0], i));
+		}
+		else
+		{
+			TestAssertTrue(!nulls[i]);
+			TestAssertTrue(arrow_row_is_valid(bulk_result->buffers[0], i));
+			TestAssertTrue(values[i] == DatumGetFloat8(r.val));
+			TestAssertTrue(values[i] == ((double *) bulk_result->buffers[1])[i]);
+		}
+	}
+	DecompressResult r = alp_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+
+	/* Reverse decompression. */
+	iter = alp_decompression_iterator_from_datum_reverse(PointerGetDatum(compressed), FLOAT8OID);
+	for (int i = TEST_ELEMENTS - 1; i >= 0; i--)
+	{
+		DecompressResult r = alp_decompression_iterator_try_next_reverse(iter);
+		TestAssertTrue(!r.is_done);
+		if (r.is_null)
+		{
+			TestAssertTrue(nulls[i]);
+		}
+		else
+		{
+			TestAssertTrue(!nulls[i]);
+			TestAssertTrue(values[i] == DatumGetFloat8(r.val));
+		}
+	}
+	r = alp_decompression_iterator_try_next_reverse(iter);
+	TestAssertTrue(r.is_done);
+}
+
+static void
+test_alp_float()
+{
+	AlpCompressor *compressor = alp_compressor_alloc(FLOAT4OID);
+	AlpCompressed *compressed;
+
+	float values[TEST_ELEMENTS];
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		values[i] = (i % 100) / 10.f;
+		alp_compressor_append_value(compressor, values[i]);
+	}
+
+	compressed = alp_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+
+	DecompressionIterator *iter =
+		alp_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), FLOAT4OID);
+	ArrowArray *bulk_result =
+		alp_decompress_all(PointerGetDatum(compressed), FLOAT4OID, CurrentMemoryContext);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = alp_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		TestAssertTrue(!r.is_null);
+		TestAssertTrue(values[i] == DatumGetFloat4(r.val));
+		TestAssertTrue(values[i] == ((float *) bulk_result->buffers[1])[i]);
+	}
+	DecompressResult r = alp_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+}
+
+#ifdef TS_USE_ZSTD
+static void
+test_array_zstd()
+{
+	Compressor *compressor = array_zstd_compressor_for_type(TEXTOID);
+	char *strings[5] = { "a", "foo", "bar", "gobble gobble gobble", "baz" };
+	text *texts[5];
+	int i;
+	for (i = 0; i < 5; i++)
+		texts[i] = cstring_to_text(strings[i]);
+
+	for (i = 0; i < TEST_ELEMENTS; i++)
+	{
+		if (i % 29 == 0)
+			compressor->append_null(compressor);
+		else
+			compressor->append_val(compressor, PointerGetDatum(texts[i % 5]));
+	}
+
+	void *compressed = compressor->finish(compressor);
+	TestAssertTrue(compressed != NULL);
+
+	/* The repetitive strings must compress well enough to take the zstd path. */
+	TestAssertTrue(((CompressedDataHeader *) compressed)->compression_algorithm ==
+				   COMPRESSION_ALGORITHM_ARRAY_ZSTD);
+
+	DecompressionIterator *iter =
+		array_zstd_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), TEXTOID);
+	for (i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = array_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		if (i % 29 == 0)
+			TestAssertTrue(r.is_null);
+		else
+		{
+			TestAssertTrue(!r.is_null);
+			TestAssertTrue(strcmp(TextDatumGetCString(r.val), strings[i % 5]) == 0);
+		}
+	}
+	DecompressResult r = array_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+
+	iter =
+		array_zstd_decompression_iterator_from_datum_reverse(PointerGetDatum(compressed), TEXTOID);
+	for (i = TEST_ELEMENTS - 1; i >= 0; i--)
+	{
+		r = array_decompression_iterator_try_next_reverse(iter);
+		TestAssertTrue(!r.is_done);
+		if (i % 29 == 0)
+			TestAssertTrue(r.is_null);
+		else
+		{
+			TestAssertTrue(!r.is_null);
+			TestAssertTrue(strcmp(TextDatumGetCString(r.val), strings[i % 5]) == 0);
+		}
+	}
+	r = array_decompression_iterator_try_next_reverse(iter);
+	TestAssertTrue(r.is_done);
+
+	ArrowArray *bulk_result =
+		array_zstd_decompress_all(PointerGetDatum(compressed), TEXTOID, CurrentMemoryContext);
+	TestAssertTrue(bulk_result->length == TEST_ELEMENTS);
+	for (i = 0; i < TEST_ELEMENTS; i++)
+	{
+		TestAssertTrue(arrow_row_is_valid(bulk_result->buffers[0], i) == (i % 29 != 0));
+	}
+}
+#endif
+
+static void
+test_rle_int(bool have_nulls, int run_length)
+{
+	RleCompressor *compressor = rle_compressor_alloc(INT4OID);
+
+	int32 values[TEST_ELEMENTS];
+	bool nulls[TEST_ELEMENTS];
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		values[i] = i / run_length;
+
+		/* Nulls don't break runs, so scatter them within the runs. */
+		nulls[i] = have_nulls && i % 29 == 0;
+
+		if (nulls[i])
+			rle_compressor_append_null(compressor);
+		else
+			rle_compressor_append(compressor, Int32GetDatum(values[i]));
+	}
+
+	void *compressed = rle_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+	TestAssertTrue(((CompressedDataHeader *) compressed)->compression_algorithm ==
+				   COMPRESSION_ALGORITHM_RLE);
+	TestAssertTrue(rle_compressed_has_nulls(compressed) == have_nulls);
+
+	/* Forward decompression, row-by-row and bulk. */
+	DecompressionIterator *iter =
+		rle_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), INT4OID);
+	TestAssertTrue(rle_decompress_all_possible(INT4OID));
+	ArrowArray *bulk_result =
+		rle_decompress_all(PointerGetDatum(compressed), INT4OID, CurrentMemoryContext);
+	TestAssertTrue(bulk_result->length == TEST_ELEMENTS);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		if (r.is_null)
+		{
+			TestAssertTrue(nulls[i]);
+			TestAssertTrue(!arrow_row_is_valid(bulk_result->buffers[0], i));
+		}
+		else
+		{
+			TestAssertTrue(!nulls[i]);
+			TestAssertTrue(arrow_row_is_valid(bulk_result->buffers[0], i));
+			TestAssertTrue(values[i] == DatumGetInt32(r.val));
+			TestAssertTrue(values[i] == ((int32 *) bulk_result->buffers[1])[i]);
+		}
+	}
+	DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+
+	/* Reverse decompression. */
+	iter = rle_decompression_iterator_from_datum_reverse(PointerGetDatum(compressed), INT4OID);
+	for (int i = TEST_ELEMENTS - 1; i >= 0; i--)
+	{
+		DecompressResult r = rle_decompression_iterator_try_next_reverse(iter);
+		TestAssertTrue(!r.is_done);
+		if (r.is_null)
+			TestAssertTrue(nulls[i]);
+		else
+		{
+			TestAssertTrue(!nulls[i]);
+			TestAssertTrue(values[i] == DatumGetInt32(r.val));
+		}
+	}
+	r = rle_decompression_iterator_try_next_reverse(iter);
+	TestAssertTrue(r.is_done);
+
+	/* Feeding the blob to an iterator for another type must be caught. */
+	TestEnsureError(
+		rle_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), INT8OID));
+}
+
+static void
+test_rle_single_run()
+{
+	RleCompressor *compressor = rle_compressor_alloc(INT4OID);
+
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+		rle_compressor_append(compressor, Int32GetDatum(42));
+
+	void *compressed = rle_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+	TestAssertTrue(((CompressedDataHeader *) compressed)->compression_algorithm ==
+				   COMPRESSION_ALGORITHM_RLE);
+
+	/* A constant column must collapse into a single tiny run. */
+	TestAssertTrue(VARSIZE(compressed) < 100);
+
+	DecompressionIterator *iter =
+		rle_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), INT4OID);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		TestAssertTrue(!r.is_null);
+		TestAssertTrue(DatumGetInt32(r.val) == 42);
+	}
+	DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+}
+
+static void
+test_rle_text()
+{
+	Compressor *compressor = rle_compressor_for_type(TEXTOID);
+	char *strings[3] = { "idle", "busy", "a longer region label, gobble gobble" };
+	text *texts[3];
+	for (int i = 0; i < 3; i++)
+		texts[i] = cstring_to_text(strings[i]);
+
+	/* Runs of 37 values each, cycling through the three strings. */
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+		compressor->append_val(compressor, PointerGetDatum(texts[(i / 37) % 3]));
+
+	void *compressed = compressor->finish(compressor);
+	TestAssertTrue(compressed != NULL);
+	TestAssertTrue(((CompressedDataHeader *) compressed)->compression_algorithm ==
+				   COMPRESSION_ALGORITHM_RLE);
+
+	/* Bulk decompression is only supported for fixed-width by-value types. */
+	TestAssertTrue(!rle_decompress_all_possible(TEXTOID));
+
+	DecompressionIterator *iter =
+		rle_decompression_iterator_from_datum_forward(PointerGetDatum(compressed), TEXTOID);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+		TestAssertTrue(!r.is_done);
+		TestAssertTrue(!r.is_null);
+		TestAssertTrue(strcmp(TextDatumGetCString(r.val), strings[(i / 37) % 3]) == 0);
+	}
+	DecompressResult r = rle_decompression_iterator_try_next_forward(iter);
+	TestAssertTrue(r.is_done);
+
+	iter = rle_decompression_iterator_from_datum_reverse(PointerGetDatum(compressed), TEXTOID);
+	for (int i = TEST_ELEMENTS - 1; i >= 0; i--)
+	{
+		r = rle_decompression_iterator_try_next_reverse(iter);
+		TestAssertTrue(!r.is_done);
+		TestAssertTrue(!r.is_null);
+		TestAssertTrue(strcmp(TextDatumGetCString(r.val), strings[(i / 37) % 3]) == 0);
+	}
+	r = rle_decompression_iterator_try_next_reverse(iter);
+	TestAssertTrue(r.is_done);
+}
+
+static void
+test_rle_fallback()
+{
+	RleCompressor *compressor = rle_compressor_alloc(INT4OID);
+
+	/* Every value starts its own run, so the finish function must recompress
+	 * with the algorithm the default path would have chosen (dictionary for
+	 * the hashable int4). */
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+		rle_compressor_append(compressor, Int32GetDatum(i % 2 == 0 ? 17 : 4711));
+
+	void *compressed = rle_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+	TestAssertTrue(((CompressedDataHeader *) compressed)->compression_algorithm ==
+				   COMPRESSION_ALGORITHM_DICTIONARY);
+
+	DecompressionIterator *iter =
+		tsl_get_decompression_iterator_init(COMPRESSION_ALGORITHM_DICTIONARY,
+											false)(PointerGetDatum(compressed), INT4OID);
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+	{
+		DecompressResult r = iter->try_next(iter);
+		TestAssertTrue(!r.is_done);
+		TestAssertTrue(!r.is_null);
+		TestAssertTrue(DatumGetInt32(r.val) == (i % 2 == 0 ? 17 : 4711));
+	}
+	DecompressResult r = iter->try_next(iter);
+	TestAssertTrue(r.is_done);
+}
+
+static void
+test_rle_corrupt()
+{
+	RleCompressor *compressor = rle_compressor_alloc(INT4OID);
+
+	for (int i = 0; i < TEST_ELEMENTS; i++)
+		rle_compressor_append(compressor, Int32GetDatum(i / 100));
+
+	void *compressed = rle_compressor_finish(compressor);
+	TestAssertTrue(compressed != NULL);
+
+	TestEnsureError(
+		rle_decompression_iterator_from_datum_forward(UnassignedDatum, INT4OID));
+	TestEnsureError(
+		rle_decompression_iterator_from_datum_reverse(UnassignedDatum, INT4OID));
+	TestEnsureError(rle_decompress_all(UnassignedDatum, INT4OID, CurrentMemoryContext));
+
+	/* A blob truncated below its own header must be rejected, not read past
+	 * the end. */
+	Size truncated_size = sizeof(CompressedDataHeader) + 2;
+	void *truncated = palloc(truncated_size);
+	memcpy(truncated, compressed, truncated_size);
+	SET_VARSIZE(truncated, truncated_size);
+	TestEnsureError(
+		rle_decompression_iterator_from_datum_forward(PointerGetDatum(truncated), INT4OID));
+}
+
+static void
+test_rle()
+{
+	test_rle_int(/* have_nulls = */ false, /* run_length = */ 50);
+	test_rle_int(/* have_nulls = */ true, /* run_length = */ 50);
+	/* Run length of one element below the point where the churn fallback
+	 * kicks in is the hardest still-rle-encoded case. */
+	test_rle_int(/* have_nulls = */ false, /* run_length = */ 2);
+	test_rle_single_run();
+	test_rle_text();
+	test_rle_fallback();
+	test_rle_corrupt();
+}
+
+static void
+test_alp()
+{
+	test_alp_double(/* have_nulls = */ false, /* have_exceptions = */ false);
+	test_alp_double(/* have_nulls = */ false, /* have_exceptions = */ true);
+	test_alp_double(/* have_nulls = */ true, /* have_exceptions = */ false);
+	test_alp_double(/* have_nulls = */ true, /* have_exceptions = */ true);
+	test_alp_float();
+}
+
 Datum
 ts_test_compression(PG_FUNCTION_ARGS)
 {
@@ -1642,6 +2160,9 @@ ts_test_compression(PG_FUNCTION_ARGS)
 
 	test_int_array();
 	test_string_array();
+#ifdef TS_USE_ZSTD
+	test_array_zstd();
+#endif
 	test_int_dictionary();
 	test_string_dictionary();
 	test_gorilla_int();
@@ -1657,14 +2178,18 @@ ts_test_compression(PG_FUNCTION_ARGS)
 	test_delta3(/* have_nulls = */ true, /* have_random = */ false);
 	test_delta3(/* have_nulls = */ true, /* have_random = */ true);
 	test_bool();
+	test_alp();
 	test_null();
 	test_simple8b_rle();
+	test_rle();
 	test_uuid();
 
 	/* Some tests for zig-zag encoding overflowing the original element width. */
 	test_delta4(test_delta4_case1, sizeof(test_delta4_case1) / sizeof(*test_delta4_case1));
 	test_delta4(test_delta4_case2, sizeof(test_delta4_case2) / sizeof(*test_delta4_case2));
 
+	test_append_vector();
+
 	pointless_tests_to_satisfy_codecov();
 	PG_RETURN_VOID();
 }
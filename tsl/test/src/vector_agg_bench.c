@@ -0,0 +1,460 @@
+/*
+ * This file and its contents are licensed under the Timescale License.
+ * Please see the included NOTICE for copyright information and
+ * LICENSE-TIMESCALE for a copy of the license.
+ */
+
+/*
+ * Microbenchmark driver for the VectorAgg grouping policies and hashing
+ * strategies. The strategies (single fixed-size keys of various widths, two
+ * fixed-size keys, single text key, serialized multi-column key, and the
+ * per-batch segmentby policy) have very different constant factors, and this
+ * lets us measure them in isolation: synthetic compressed batches with
+ * controlled grouping key cardinality, skew and width are fed directly into
+ * the grouping policy, bypassing planning and decompression.
+ *
+ * The entry point is SQL-callable and returns one JSON array of result
+ * objects as text:
+ *
+ *   CREATE FUNCTION ts_vector_agg_bench(strategy TEXT, num_batches INT,
+ *       batch_rows INT, cardinality INT, hot_fraction DOUBLE PRECISION,
+ *       key_bytes INT) RETURNS TEXT
+ *       AS :MODULE_PATHNAME, 'ts_vector_agg_bench' LANGUAGE C;
+ *
+ * The strategy is one of 'batch', 'single_fixed_2', 'single_fixed_4',
+ * 'single_fixed_8', 'two_fixed', 'single_text', 'serialized', or 'all'. Each
+ * row's grouping key is drawn from [0, cardinality), with hot_fraction of
+ * the rows collapsed onto key 0 to model skew, and key_bytes controls the
+ * rendered width of the text keys. The aggregate is count(*), so the numbers
+ * reflect the grouping cost and not the aggregate transition functions.
+ */
+
+#include <postgres.h>
+
+#include <catalog/pg_type.h>
+#include <executor/tuptable.h>
+#include <fmgr.h>
+#include <lib/stringinfo.h>
+#include <nodes/makefuncs.h>
+#include <portability/instr_time.h>
+#include <utils/builtins.h>
+#include <utils/fmgroids.h>
+#include <utils/json.h>
+#include <utils/memutils.h>
+
+#include <export.h>
+
+#include "nodes/columnar_scan/compressed_batch.h"
+#include "nodes/columnar_scan/decompress_context.h"
+#include "nodes/vector_agg/exec.h"
+#include "nodes/vector_agg/grouping_policy.h"
+
+TS_FUNCTION_INFO_V1(ts_vector_agg_bench);
+
+/*
+ * One grouping column of the synthetic input.
+ */
+typedef struct VABenchColumn
+{
+	Oid typid;
+	int16 value_bytes; /* -1 for text */
+	bool by_value;
+} VABenchColumn;
+
+typedef struct VABenchStrategy
+{
+	const char *name;
+	/* VAGT_Invalid means the per-batch (segmentby) grouping policy. */
+	VectorAggGroupingType grouping_type;
+	int num_columns;
+	VABenchColumn columns[2];
+	bool requires_umash;
+} VABenchStrategy;
+
+static const VABenchStrategy va_bench_strategies[] = {
+	{ .name = "batch",
+	  .grouping_type = VAGT_Invalid,
+	  .num_columns = 1,
+	  .columns = { { INT8OID, 8, true } } },
+	{ .name = "single_fixed_2",
+	  .grouping_type = VAGT_HashSingleFixed2,
+	  .num_columns = 1,
+	  .columns = { { INT2OID, 2, true } } },
+	{ .name = "single_fixed_4",
+	  .grouping_type = VAGT_HashSingleFixed4,
+	  .num_columns = 1,
+	  .columns = { { INT4OID, 4, true } } },
+	{ .name = "single_fixed_8",
+	  .grouping_type = VAGT_HashSingleFixed8,
+	  .num_columns = 1,
+	  .columns = { { INT8OID, 8, true } } },
+	{ .name = "two_fixed",
+	  .grouping_type = VAGT_HashTwoFixed,
+	  .num_columns = 2,
+	  .columns = { { INT4OID, 4, true }, { INT8OID, 8, true } } },
+	{ .name = "single_text",
+	  .grouping_type = VAGT_HashSingleText,
+	  .num_columns = 1,
+	  .columns = { { TEXTOID, -1, false } },
+	  .requires_umash = true },
+	{ .name = "serialized",
+	  .grouping_type = VAGT_HashSerialized,
+	  .num_columns = 2,
+	  .columns = { { INT4OID, 4, true }, { TEXTOID, -1, false } },
+	  .requires_umash = true },
+};
+
+/*
+ * A small deterministic PRNG (splitmix64), so that the runs are reproducible.
+ */
+static uint64 va_bench_prng_state;
+
+static uint64
+va_bench_prng_next(void)
+{
+	uint64 z = (va_bench_prng_state += UINT64CONST(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * UINT64CONST(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64CONST(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+/*
+ * Draw one grouping key from [0, cardinality), collapsing hot_fraction of the
+ * draws onto key 0 to model skewed distributions.
+ */
+static int64
+va_bench_next_key(int cardinality, double hot_fraction)
+{
+	const uint64 r = va_bench_prng_next();
+	if (hot_fraction > 0 &&
+		(double) (r >> 40) / (double) (UINT64CONST(1) << 24) < hot_fraction)
+		return 0;
+	return (int64) (va_bench_prng_next() % (uint64) cardinality);
+}
+
+/*
+ * Fill one column of a synthetic batch with the values derived from the
+ * per-row grouping keys.
+ */
+static void
+va_bench_fill_column(CompressedColumnValues *column, const VABenchColumn *def, int column_index,
+					 bool split_key, const int64 *keys, int nrows, int key_bytes, bool scalar)
+{
+	if (scalar)
+	{
+		/* The per-batch policy sees segmentby columns as scalar values. */
+		Assert(def->value_bytes == 8);
+		column->decompression_type = DT_Scalar;
+		column->buffers[0] = DatumGetPointer(BoolGetDatum(false));
+		column->buffers[1] = DatumGetPointer(Int64GetDatum(keys[0]));
+		return;
+	}
+
+	if (def->value_bytes > 0)
+	{
+		char *values = palloc(def->value_bytes * nrows);
+		for (int i = 0; i < nrows; i++)
+		{
+			/*
+			 * The two-column strategies split the key injectively across the
+			 * columns: the first column gets the low part and the second one
+			 * the rest, so the combined cardinality stays as requested.
+			 */
+			int64 key = keys[i];
+			if (split_key)
+				key = column_index == 0 ? keys[i] % 97 : keys[i] / 97;
+			switch (def->value_bytes)
+			{
+				case 2:
+					((int16 *) values)[i] = (int16) key;
+					break;
+				case 4:
+					((int32 *) values)[i] = (int32) key;
+					break;
+				case 8:
+					((int64 *) values)[i] = key;
+					break;
+				default:
+					pg_unreachable();
+			}
+		}
+		column->decompression_type = def->value_bytes;
+		column->buffers[0] = NULL; /* no nulls */
+		column->buffers[1] = values;
+		return;
+	}
+
+	/* Text column in the Arrow format: offsets and bodies, no nulls. */
+	uint32 *offsets = palloc(sizeof(uint32) * (nrows + 1));
+	uint8 *bodies = palloc((key_bytes + 32) * nrows);
+	uint32 position = 0;
+	for (int i = 0; i < nrows; i++)
+	{
+		offsets[i] = position;
+		position += snprintf((char *) &bodies[position],
+							 key_bytes + 32,
+							 "%0*lld",
+							 key_bytes,
+							 (long long) keys[i]);
+	}
+	offsets[nrows] = position;
+	column->decompression_type = DT_ArrowText;
+	column->buffers[0] = NULL;
+	column->buffers[1] = offsets;
+	column->buffers[2] = bodies;
+}
+
+static void
+va_bench_one_strategy(StringInfo json, const VABenchStrategy *strategy, int num_batches,
+					  int batch_rows, int cardinality, double hot_fraction, int key_bytes,
+					  bool *first)
+{
+	if (!*first)
+		appendStringInfoString(json, ", ");
+	*first = false;
+
+	appendStringInfoString(json, "{\"strategy\": ");
+	escape_json(json, strategy->name);
+
+#ifndef TS_USE_UMASH
+	if (strategy->requires_umash)
+	{
+		appendStringInfoString(json, ", \"error\": \"not supported in this build\"}");
+		return;
+	}
+#endif
+
+	/* The single-column fixed strategies read the key at its native width. */
+	if (strategy->columns[0].value_bytes == 2 && cardinality > PG_INT16_MAX)
+		cardinality = PG_INT16_MAX;
+
+	const int ncols = strategy->num_columns;
+	const bool scalar_keys = strategy->grouping_type == VAGT_Invalid;
+
+	/*
+	 * The input batches and the grouping policy live in separate memory
+	 * contexts, so that the policy allocations (hash table, key storage,
+	 * aggregate states) can be measured separately from the input data.
+	 */
+	MemoryContext data_mctx =
+		AllocSetContextCreate(CurrentMemoryContext, "vector agg bench data", ALLOCSET_DEFAULT_SIZES);
+	MemoryContext policy_mctx = AllocSetContextCreate(CurrentMemoryContext,
+													  "vector agg bench policy",
+													  ALLOCSET_DEFAULT_SIZES);
+	MemoryContext old_context = MemoryContextSwitchTo(data_mctx);
+
+	/*
+	 * A minimal decompression context: the grouping policies only use it to
+	 * resolve the grouping Vars to compressed column indexes.
+	 */
+	DecompressContext *dcontext = palloc0(sizeof(DecompressContext));
+	dcontext->num_data_columns = ncols;
+	dcontext->compressed_chunk_columns = palloc0(sizeof(CompressionColumnDescription) * ncols);
+	for (int i = 0; i < ncols; i++)
+	{
+		CompressionColumnDescription *desc = &dcontext->compressed_chunk_columns[i];
+		desc->type = scalar_keys ? SEGMENTBY_COLUMN : COMPRESSED_COLUMN;
+		desc->typid = strategy->columns[i].typid;
+		desc->value_bytes = strategy->columns[i].value_bytes;
+		desc->by_value = strategy->columns[i].by_value;
+		desc->uncompressed_chunk_attno = AttrOffsetGetAttrNumber(i);
+	}
+
+	GroupingColumn *grouping_columns = palloc0(sizeof(GroupingColumn) * ncols);
+	for (int i = 0; i < ncols; i++)
+	{
+		grouping_columns[i].expr = (Expr *) makeVar(1,
+													AttrOffsetGetAttrNumber(i),
+													strategy->columns[i].typid,
+													-1,
+													InvalidOid,
+													0);
+		grouping_columns[i].output_offset = i;
+		grouping_columns[i].value_bytes = strategy->columns[i].value_bytes;
+		grouping_columns[i].by_value = strategy->columns[i].by_value;
+	}
+
+	/* Aggregate with count(*), so that the grouping cost dominates. */
+	VectorAggDef *agg_def = palloc0(sizeof(VectorAggDef));
+	agg_def->func = *get_vector_aggregate(F_COUNT_);
+	agg_def->output_offset = ncols;
+
+	/* The output slot for the emitted partial aggregation results. */
+	TupleDesc out_desc = CreateTemplateTupleDesc(ncols + 1);
+	for (int i = 0; i < ncols; i++)
+		TupleDescInitEntry(out_desc,
+						   AttrOffsetGetAttrNumber(i),
+						   "key",
+						   strategy->columns[i].typid,
+						   -1,
+						   0);
+	TupleDescInitEntry(out_desc, AttrOffsetGetAttrNumber(ncols), "count", INT8OID, -1, 0);
+	TupleTableSlot *aggregated_slot = MakeSingleTupleTableSlot(out_desc, &TTSOpsVirtual);
+
+	/*
+	 * Pre-generate the synthetic batches so that only the grouping work is
+	 * timed. The per-batch policy groups by values that are constant within a
+	 * batch, so there the key is drawn once per batch.
+	 */
+	va_bench_prng_state = 0xC0FFEE;
+	DecompressBatchState **batches = palloc(sizeof(*batches) * num_batches);
+	int64 *keys = palloc(sizeof(int64) * batch_rows);
+	for (int batch = 0; batch < num_batches; batch++)
+	{
+		DecompressBatchState *batch_state =
+			palloc0(sizeof(DecompressBatchState) + sizeof(CompressedColumnValues) * ncols);
+		batch_state->total_batch_rows = batch_rows;
+
+		if (scalar_keys)
+			keys[0] = va_bench_next_key(cardinality, hot_fraction);
+		else
+			for (int i = 0; i < batch_rows; i++)
+				keys[i] = va_bench_next_key(cardinality, hot_fraction);
+
+		for (int i = 0; i < ncols; i++)
+			va_bench_fill_column(&batch_state->compressed_columns[i],
+								 &strategy->columns[i],
+								 i,
+								 /* split_key = */ ncols > 1 && strategy->columns[i].value_bytes > 0,
+								 keys,
+								 batch_rows,
+								 key_bytes,
+								 scalar_keys);
+		batches[batch] = batch_state;
+	}
+
+	MemoryContextSwitchTo(policy_mctx);
+	GroupingPolicy *policy;
+	if (scalar_keys)
+		policy = create_grouping_policy_batch(1, agg_def, ncols, grouping_columns);
+	else
+		policy =
+			create_grouping_policy_hash(1, agg_def, ncols, grouping_columns, strategy->grouping_type);
+
+	/*
+	 * Feed the batches to the policy, draining the partial results whenever
+	 * the policy decides to spill, like the executor does.
+	 */
+	instr_time add_start;
+	instr_time add_duration;
+	int64 emitted_groups = 0;
+	int64 spills = 0;
+	INSTR_TIME_SET_CURRENT(add_start);
+	for (int batch = 0; batch < num_batches; batch++)
+	{
+		policy->gp_add_batch(policy, dcontext, (TupleTableSlot *) batches[batch]);
+		if (batch < num_batches - 1 && policy->gp_should_emit(policy))
+		{
+			spills++;
+			while (policy->gp_do_emit(policy, aggregated_slot))
+				emitted_groups++;
+			/* The per-batch policy carries no state across batches. */
+			if (!scalar_keys)
+				policy->gp_reset(policy);
+		}
+	}
+	INSTR_TIME_SET_CURRENT(add_duration);
+	INSTR_TIME_SUBTRACT(add_duration, add_start);
+
+	const size_t policy_bytes = MemoryContextMemAllocated(policy_mctx, true);
+
+	instr_time emit_start;
+	instr_time emit_duration;
+	INSTR_TIME_SET_CURRENT(emit_start);
+	while (policy->gp_do_emit(policy, aggregated_slot))
+		emitted_groups++;
+	INSTR_TIME_SET_CURRENT(emit_duration);
+	INSTR_TIME_SUBTRACT(emit_duration, emit_start);
+
+	const double add_seconds = INSTR_TIME_GET_DOUBLE(add_duration);
+	const double emit_seconds = INSTR_TIME_GET_DOUBLE(emit_duration);
+	const int64 input_rows = (int64) num_batches * batch_rows;
+
+	appendStringInfo(json, ", \"policy\": ");
+	escape_json(json, policy->gp_explain(policy));
+	appendStringInfo(json,
+					 ", \"num_batches\": %d, \"batch_rows\": %d, \"input_rows\": " INT64_FORMAT
+					 ", \"cardinality\": %d, \"hot_fraction\": %g",
+					 num_batches,
+					 batch_rows,
+					 input_rows,
+					 cardinality,
+					 hot_fraction);
+	if (strategy->columns[0].value_bytes == -1 || strategy->num_columns > 1)
+		appendStringInfo(json, ", \"key_bytes\": %d", key_bytes);
+	appendStringInfo(json,
+					 ", \"emitted_groups\": " INT64_FORMAT ", \"spills\": " INT64_FORMAT
+					 ", \"add_seconds\": %g, \"emit_seconds\": %g, \"rows_per_second\": %g",
+					 emitted_groups,
+					 spills,
+					 add_seconds,
+					 emit_seconds,
+					 add_seconds > 0 ? input_rows / add_seconds : 0);
+	appendStringInfo(json,
+					 ", \"policy_bytes\": %zu, \"bytes_per_group\": %g}",
+					 policy_bytes,
+					 emitted_groups > 0 ? (double) policy_bytes / emitted_groups : 0);
+
+	MemoryContextSwitchTo(old_context);
+	MemoryContextDelete(data_mctx);
+	MemoryContextDelete(policy_mctx);
+}
+
+Datum
+ts_vector_agg_bench(PG_FUNCTION_ARGS)
+{
+	const char *strategy_name = text_to_cstring(PG_GETARG_TEXT_PP(0));
+	const int num_batches = PG_GETARG_INT32(1);
+	const int batch_rows = PG_GETARG_INT32(2);
+	const int cardinality = PG_GETARG_INT32(3);
+	const double hot_fraction = PG_GETARG_FLOAT8(4);
+	const int key_bytes = PG_GETARG_INT32(5);
+	StringInfoData json;
+	bool first = true;
+	bool found = false;
+
+	if (num_batches <= 0 || cardinality <= 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the number of batches and the cardinality must be positive")));
+	if (batch_rows <= 0 || batch_rows > TARGET_COMPRESSED_BATCH_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the batch rows must be between 1 and %d", TARGET_COMPRESSED_BATCH_SIZE)));
+	if (hot_fraction < 0 || hot_fraction >= 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the hot fraction must be in [0, 1)")));
+	if (key_bytes <= 0 || key_bytes > 64)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("the key bytes must be between 1 and 64")));
+
+	initStringInfo(&json);
+	appendStringInfoString(&json, "[");
+
+	for (size_t i = 0; i < sizeof(va_bench_strategies) / sizeof(*va_bench_strategies); i++)
+	{
+		const VABenchStrategy *strategy = &va_bench_strategies[i];
+		if (strcmp(strategy_name, "all") != 0 && strcmp(strategy_name, strategy->name) != 0)
+			continue;
+		found = true;
+		va_bench_one_strategy(&json,
+							  strategy,
+							  num_batches,
+							  batch_rows,
+							  cardinality,
+							  hot_fraction,
+							  key_bytes,
+							  &first);
+	}
+
+	if (!found)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("unknown grouping strategy \"%s\"", strategy_name)));
+
+	appendStringInfoString(&json, "]");
+
+	PG_RETURN_TEXT_P(cstring_to_text(json.data));
+}